@@ -247,7 +247,11 @@ int dc_audio_decoder_read(AudioInputFile *audio_input_file, AudioInputData *audi
 			avcodec_decode_audio4(codec_ctx, audio_input_data->aframe, &got_frame, &packet);
 
 			if (got_frame) {
-				dc_producer_lock(&audio_input_data->producer, &audio_input_data->circular_buf);
+				/* Live: the node is still used by consumers, drop the flushed frame */
+				if (dc_producer_lock(&audio_input_data->producer, &audio_input_data->circular_buf) < 0) {
+					GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[dashcast] Live system dropped an audio frame\n"));
+					return 0;
+				}
 				dc_producer_unlock_previous(&audio_input_data->producer, &audio_input_data->circular_buf);
 				audio_data_node = (AudioDataNode*)dc_producer_produce(&audio_input_data->producer, &audio_input_data->circular_buf);
 
@@ -360,21 +364,25 @@ int dc_audio_decoder_read(AudioInputFile *audio_input_file, AudioInputData *audi
 				av_fifo_generic_write(audio_input_file->fifo, data[0], data_size, NULL);
 
 				if (/*audio_input_file->circular_buf.mode == OFFLINE*/audio_input_file->mode == ON_DEMAND || audio_input_file->mode == LIVE_MEDIA) {
-					dc_producer_lock(&audio_input_data->producer, &audio_input_data->circular_buf);
-
-					/* Unlock the previous node in the circular buffer. */
-					dc_producer_unlock_previous(&audio_input_data->producer, &audio_input_data->circular_buf);
+					/* Live media: the node is still used by consumers, drop the frame without advancing */
+					if (dc_producer_lock(&audio_input_data->producer, &audio_input_data->circular_buf) < 0) {
+						GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[dashcast] Live system dropped an audio frame\n"));
+						av_fifo_drain(audio_input_file->fifo, data_size);
+					} else {
+						/* Unlock the previous node in the circular buffer. */
+						dc_producer_unlock_previous(&audio_input_data->producer, &audio_input_data->circular_buf);
 
-					/* Get the pointer of the current node in circular buffer. */
-					audio_data_node = (AudioDataNode *) dc_producer_produce(&audio_input_data->producer, &audio_input_data->circular_buf);
-					audio_data_node->channels = DC_AUDIO_NUM_CHANNELS;
-					audio_data_node->channel_layout = DC_AUDIO_CHANNEL_LAYOUT;
-					audio_data_node->sample_rate = DC_AUDIO_SAMPLE_RATE;
-					audio_data_node->format = DC_AUDIO_SAMPLE_FORMAT;
-					audio_data_node->abuf_size = data_size;
-					av_fifo_generic_read(audio_input_file->fifo, audio_data_node->abuf, audio_data_node->abuf_size, NULL);
+						/* Get the pointer of the current node in circular buffer. */
+						audio_data_node = (AudioDataNode *) dc_producer_produce(&audio_input_data->producer, &audio_input_data->circular_buf);
+						audio_data_node->channels = DC_AUDIO_NUM_CHANNELS;
+						audio_data_node->channel_layout = DC_AUDIO_CHANNEL_LAYOUT;
+						audio_data_node->sample_rate = DC_AUDIO_SAMPLE_RATE;
+						audio_data_node->format = DC_AUDIO_SAMPLE_FORMAT;
+						audio_data_node->abuf_size = data_size;
+						av_fifo_generic_read(audio_input_file->fifo, audio_data_node->abuf, audio_data_node->abuf_size, NULL);
 
-					dc_producer_advance(&audio_input_data->producer, &audio_input_data->circular_buf);
+						dc_producer_advance(&audio_input_data->producer, &audio_input_data->circular_buf);
+					}
 				} else {
 					while (av_fifo_size(audio_input_file->fifo) >= LIVE_FRAME_SIZE) {
 						/* Lock the current node in the circular buffer. */
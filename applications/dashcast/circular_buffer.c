@@ -28,6 +28,55 @@
 
 //#define DEBUG
 
+/* Node state: producer writing the node */
+#define DC_NODE_PRODUCER	0x1
+/* Node state: the data on this node is valid */
+#define DC_NODE_MARKED		0x2
+/* Node state: this node is the last node */
+#define DC_NODE_END			0x4
+/* Node state: number of consumers which did not release the data, on 12 bits */
+#define DC_NODE_PENDING_SHIFT	4
+#define DC_NODE_PENDING_MASK	(0xFFF << DC_NODE_PENDING_SHIFT)
+/* Node state: lap of the producer when it locked the node, on 16 bits */
+#define DC_NODE_LAP_SHIFT	16
+
+#define DC_NODE_LAP(_lap)	(((u32) (_lap)) << DC_NODE_LAP_SHIFT)
+#define DC_NODE_LAP_MASK	DC_NODE_LAP(0xFFFF)
+
+
+/* Sleeps until the state of a node changes, unless it already changed since state was read */
+static void dc_wait_state_change(volatile u32 *num_waiting, u32 waiter, GF_Semaphore *sem, volatile u32 *node_state, u32 state)
+{
+	DC_ATOMIC_ADD(num_waiting, waiter);
+	if (DC_ATOMIC_GET(node_state) == state)
+		gf_sema_wait(sem);
+	DC_ATOMIC_ADD(num_waiting, -(s32)waiter);
+}
+
+/* Wakes up the consumers waiting for a node, to be called after a state change.
+ * Only the consumers waiting for the lap of the node are woken up, unless all is set */
+static void dc_notify_consumers(Node *node, u32 state, Bool all)
+{
+	u32 i, num_waiting;
+	for (i=0; i<2; i++) {
+		if (!all && (i != ((state >> DC_NODE_LAP_SHIFT) & 1)))
+			continue;
+		num_waiting = DC_ATOMIC_GET(&node->num_consumers_waiting[i]);
+		if (num_waiting)
+			gf_sema_notify(node->consumers_semaphore[i], num_waiting);
+	}
+}
+
+/* Atomically sets and clears flags of the node state, returns the new state */
+static u32 dc_node_update(Node *node, u32 set, u32 clear)
+{
+	u32 state, new_state;
+	do {
+		state = DC_ATOMIC_GET(&node->state);
+		new_state = (state & ~clear) | set;
+	} while (!DC_ATOMIC_CAS(&node->state, state, new_state));
+	return new_state;
+}
 
 void dc_circular_buffer_create(CircularBuffer *circular_buf, u32 size, LockMode mode, int max_num_consumers)
 {
@@ -36,16 +85,14 @@ void dc_circular_buffer_create(CircularBuffer *circular_buf, u32 size, LockMode
 	circular_buf->list = (Node*)gf_malloc(size * sizeof(Node));
 	circular_buf->mode = mode;
 	circular_buf->max_num_consumers = max_num_consumers;
+	circular_buf->num_producers_waiting = 0;
+	circular_buf->producers_semaphore = gf_sema_new(1000, 0);
 
 	for (i=0; i<size; i++) {
-		circular_buf->list[i].num_producers = 0;
-		circular_buf->list[i].num_consumers = 0;
-		circular_buf->list[i].num_consumers_accessed = 0;
-		circular_buf->list[i].marked = 0;
-		circular_buf->list[i].num_consumers_waiting = 0;
-		circular_buf->list[i].consumers_semaphore = gf_sema_new(1000, 0);
-		circular_buf->list[i].producers_semaphore = gf_sema_new(1000, 0);
-		circular_buf->list[i].mutex = gf_mx_new("Circular Buffer Mutex");
+		circular_buf->list[i].state = 0;
+		circular_buf->list[i].num_consumers_waiting[0] = circular_buf->list[i].num_consumers_waiting[1] = 0;
+		circular_buf->list[i].consumers_semaphore[0] = gf_sema_new(1000, 0);
+		circular_buf->list[i].consumers_semaphore[1] = gf_sema_new(1000, 0);
 	}
 }
 
@@ -53,10 +100,10 @@ void dc_circular_buffer_destroy(CircularBuffer *circular_buf)
 {
 	u32 i;
 	for (i = 0; i < circular_buf->size; i++) {
-		gf_sema_del(circular_buf->list[i].consumers_semaphore);
-		gf_sema_del(circular_buf->list[i].producers_semaphore);
-		gf_mx_del(circular_buf->list[i].mutex);
+		gf_sema_del(circular_buf->list[i].consumers_semaphore[0]);
+		gf_sema_del(circular_buf->list[i].consumers_semaphore[1]);
 	}
+	gf_sema_del(circular_buf->producers_semaphore);
 
 	gf_free(circular_buf->list);
 }
@@ -65,6 +112,11 @@ void dc_consumer_init(Consumer *consumer, int max_idx, char *name)
 {
 	consumer->idx = 0;
 	consumer->max_idx = max_idx;
+	consumer->lap = 1;
+	consumer->num_locked = 0;
+	consumer->release_idx = 0;
+	consumer->locked_idx = -1;
+	consumer->locked_lap = 0;
 	strcpy(consumer->name, name);
 }
 
@@ -75,94 +127,86 @@ void * dc_consumer_consume(Consumer *consumer, CircularBuffer *circular_buf)
 
 int dc_consumer_lock(Consumer *consumer, CircularBuffer *circular_buf)
 {
+	u32 state;
 	Node *node = &circular_buf->list[consumer->idx];
+	u32 lap = DC_NODE_LAP(consumer->lap) & DC_NODE_LAP_MASK;
 
-	gf_mx_p(node->mutex);
-	if (node->marked == 2) {
-		gf_mx_v(node->mutex);
-		return -1;
-	}
-
-	node->num_consumers_waiting++;
-	while (node->num_producers || !node->marked) {
-		gf_mx_v(node->mutex);
-		gf_sema_wait(node->consumers_semaphore);
-		gf_mx_p(node->mutex);
+	/* Already locked */
+	if (consumer->num_locked && (consumer->locked_idx == consumer->idx) && (consumer->locked_lap == consumer->lap))
+		return 0;
 
-		if (node->marked == 2) {
-			gf_mx_v(node->mutex);
+	while (1) {
+		state = DC_ATOMIC_GET(&node->state);
+		if (state & DC_NODE_END)
 			return -1;
-		}
-	}
-	node->num_consumers_waiting--;
-
-	if (node->marked == 2) {
-		gf_mx_v(node->mutex);
-		return -1;
+		/* The data of our lap is written */
+		if ((state & DC_NODE_MARKED) && !(state & DC_NODE_PRODUCER) && ((state & DC_NODE_LAP_MASK) == lap))
+			break;
+		dc_wait_state_change(&node->num_consumers_waiting[consumer->lap & 1], 1, node->consumers_semaphore[consumer->lap & 1], &node->state, state);
 	}
-	node->num_consumers++;
-	node->num_consumers_accessed++;
-	gf_mx_v(node->mutex);
 
+	if (!consumer->num_locked)
+		consumer->release_idx = consumer->idx;
+	consumer->num_locked++;
+	consumer->locked_idx = consumer->idx;
+	consumer->locked_lap = consumer->lap;
 	return 0;
 }
 
-int dc_consumer_unlock(Consumer *consumer, CircularBuffer *circular_buf)
+/* Releases a node locked by the consumer, the last consumer releasing it makes it available to the producer */
+static int dc_consumer_release(Consumer *consumer, CircularBuffer *circular_buf, int node_idx)
 {
-	int last_consumer = 0;
-	Node *node = &circular_buf->list[consumer->idx];
-
-	gf_mx_p(node->mutex);
-	node->num_consumers--;
-
-	if (node->num_consumers_accessed == circular_buf->max_num_consumers) {
-		node->marked = 0;
-		node->num_consumers_accessed = 0;
-		last_consumer = 1;
-	}
-
-	gf_sema_notify(node->producers_semaphore, 1);
-
-	gf_mx_v(node->mutex);
+	u32 state, new_state;
+	Node *node;
+
+	/* Nodes are released in the order they were locked, ignore nodes we do not hold */
+	if (!consumer->num_locked || (consumer->release_idx != node_idx))
+		return 0;
+	consumer->num_locked--;
+	consumer->release_idx = (consumer->release_idx + 1) % consumer->max_idx;
+
+	node = &circular_buf->list[node_idx];
+	do {
+		state = DC_ATOMIC_GET(&node->state);
+		if (!(state & DC_NODE_PENDING_MASK))
+			return 0;
+		new_state = state - (1 << DC_NODE_PENDING_SHIFT);
+		if (!(new_state & DC_NODE_PENDING_MASK))
+			new_state &= ~DC_NODE_MARKED;
+	} while (!DC_ATOMIC_CAS(&node->state, state, new_state));
+
+	if (new_state & DC_NODE_MARKED)
+		return 0;
+
+	/* Last consumer: wake up the producer only if it waits for this node */
+	if (DC_ATOMIC_GET(&circular_buf->num_producers_waiting) == (u32) node_idx + 1)
+		gf_sema_notify(circular_buf->producers_semaphore, 1);
+	return 1;
+}
 
-	return last_consumer;
+int dc_consumer_unlock(Consumer *consumer, CircularBuffer *circular_buf)
+{
+	return dc_consumer_release(consumer, circular_buf, consumer->idx);
 }
 
 int dc_consumer_unlock_previous(Consumer *consumer, CircularBuffer *circular_buf)
 {
 	int node_idx = (consumer->idx - 1 + consumer->max_idx) % consumer->max_idx;
-	int last_consumer = 0;
-	Node *node = &circular_buf->list[node_idx];
-
-	gf_mx_p(node->mutex);
-
-	node->num_consumers--;
-	if (node->num_consumers < 0)
-		node->num_consumers = 0;
-
-	if (node->num_consumers_accessed == circular_buf->max_num_consumers) {
-		if (node->marked != 2)
-			node->marked = 0;
-		node->num_consumers_accessed = 0;
-		last_consumer = 1;
-	}
-
-	gf_sema_notify(node->producers_semaphore, 1);
-
-	gf_mx_v(node->mutex);
-
-	return last_consumer;
+	return dc_consumer_release(consumer, circular_buf, node_idx);
 }
 
 void dc_consumer_advance(Consumer *consumer)
 {
 	consumer->idx = (consumer->idx + 1) % consumer->max_idx;
+	if (!consumer->idx)
+		consumer->lap++;
 }
 
 void dc_producer_init(Producer *producer, int max_idx, char *name)
 {
 	producer->idx = 0;
 	producer->max_idx = max_idx;
+	producer->lap = 1;
 	strcpy(producer->name, name);
 }
 
@@ -171,41 +215,50 @@ void * dc_producer_produce(Producer *producer, CircularBuffer *circular_buf)
 	return circular_buf->list[producer->idx].data;
 }
 
+/* Marks the data of a node valid, it will be released by all the consumers */
+static u32 dc_producer_publish_state(CircularBuffer *circular_buf)
+{
+	if (!circular_buf->max_num_consumers)
+		return 0;
+	return DC_NODE_MARKED | (circular_buf->max_num_consumers << DC_NODE_PENDING_SHIFT);
+}
+
 int dc_producer_lock(Producer *producer, CircularBuffer *circular_buf)
 {
+	u32 state, new_state;
 	Node *node = &circular_buf->list[producer->idx];
+	u32 lap = DC_NODE_LAP(producer->lap) & DC_NODE_LAP_MASK;
+
+	while (1) {
+		state = DC_ATOMIC_GET(&node->state);
+		/* Already locked */
+		if ((state & DC_NODE_PRODUCER) && ((state & DC_NODE_LAP_MASK) == lap))
+			return 0;
+
+		/* Released by all consumers */
+		if (!(state & (DC_NODE_MARKED | DC_NODE_END | DC_NODE_PRODUCER))) {
+			new_state = lap | DC_NODE_PRODUCER;
+			if (circular_buf->size > 1)
+				new_state |= dc_producer_publish_state(circular_buf);
+			if (DC_ATOMIC_CAS(&node->state, state, new_state))
+				return 0;
+			continue;
+		}
 
-	gf_mx_p(node->mutex);
-
-	if ( (circular_buf->mode == LIVE_CAMERA || circular_buf->mode == LIVE_MEDIA) && (node->num_consumers || node->marked)) {
-		gf_mx_v(node->mutex);
-		return -1;
-	}
-
-	while (node->num_consumers || node->marked) {
-		gf_mx_v(node->mutex);
-		gf_sema_wait(node->producers_semaphore);
-		gf_mx_p(node->mutex);
-	}
+		if (circular_buf->mode == LIVE_CAMERA || circular_buf->mode == LIVE_MEDIA)
+			return -1;
 
-	node->num_producers++;
-	if (circular_buf->size>1) {
-		node->marked = 1;
+		dc_wait_state_change(&circular_buf->num_producers_waiting, producer->idx + 1, circular_buf->producers_semaphore, &node->state, state);
 	}
-
-	gf_mx_v(node->mutex);
-
-	return 0;
 }
 
 void dc_producer_unlock(Producer *producer, CircularBuffer *circular_buf)
 {
 	Node *node = &circular_buf->list[producer->idx];
 
-	gf_mx_p(node->mutex);
-	node->num_producers--;
-	gf_sema_notify(node->consumers_semaphore, node->num_consumers_waiting);
-	gf_mx_v(node->mutex);
+	if (!(DC_ATOMIC_GET(&node->state) & DC_NODE_PRODUCER))
+		return;
+	dc_notify_consumers(node, dc_node_update(node, 0, DC_NODE_PRODUCER), GF_FALSE);
 }
 
 void dc_producer_unlock_previous(Producer *producer, CircularBuffer *circular_buf)
@@ -213,33 +266,28 @@ void dc_producer_unlock_previous(Producer *producer, CircularBuffer *circular_bu
 	int node_idx = (producer->idx - 1 + producer->max_idx) % producer->max_idx;
 	Node *node = &circular_buf->list[node_idx];
 
-	gf_mx_p(node->mutex);
-	node->num_producers = 0;
-	gf_sema_notify(node->consumers_semaphore, node->num_consumers_waiting);
-	gf_mx_v(node->mutex);
+	if (!(DC_ATOMIC_GET(&node->state) & DC_NODE_PRODUCER))
+		return;
+	dc_notify_consumers(node, dc_node_update(node, 0, DC_NODE_PRODUCER), GF_FALSE);
 }
 
 void dc_producer_advance(Producer *producer, CircularBuffer *circular_buf)
 {
 	if (circular_buf->size == 1) {
 		Node *node = &circular_buf->list[producer->idx];
-		gf_mx_p(node->mutex);
-		node->marked = 1;
-		gf_sema_notify(node->consumers_semaphore, node->num_consumers_waiting);
-		gf_mx_v(node->mutex);
+		dc_notify_consumers(node, dc_node_update(node, dc_producer_publish_state(circular_buf), 0), GF_FALSE);
 	}
 	producer->idx = (producer->idx + 1) % producer->max_idx;
+	if (!producer->idx)
+		producer->lap++;
 }
 
 void dc_producer_end_signal(Producer *producer, CircularBuffer *circular_buf)
 {
 	Node *node = &circular_buf->list[producer->idx];
 
-	gf_mx_p(node->mutex);
-	node->marked = 2;
-	gf_sema_notify(node->consumers_semaphore, node->num_consumers_waiting);
+	dc_notify_consumers(node, dc_node_update(node, DC_NODE_END, 0), GF_TRUE);
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("producer %s sends end signal %d \n", producer->name, producer->idx));
-	gf_mx_v(node->mutex);
 }
 
 void dc_producer_end_signal_previous(Producer *producer, CircularBuffer *circular_buf)
@@ -247,9 +295,6 @@ void dc_producer_end_signal_previous(Producer *producer, CircularBuffer *circula
 	int i_node = (producer->max_idx + producer->idx - 1) % producer->max_idx;
 	Node *node = &circular_buf->list[i_node];
 
-	gf_mx_p(node->mutex);
-	node->marked = 2;
-	gf_sema_notify(node->consumers_semaphore, node->num_consumers_waiting);
-	GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("producer %s sends end signal %d \n", producer->name, node));
-	gf_mx_v(node->mutex);
+	dc_notify_consumers(node, dc_node_update(node, DC_NODE_END, 0), GF_TRUE);
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("producer %s sends end signal %d \n", producer->name, i_node));
 }
@@ -45,38 +45,60 @@ typedef enum {
 	ON_DEMAND
 } LockMode;
 
+/*
+ * Atomic operations used for the lock-free state of the nodes and of the message queues.
+ * They are full memory barriers.
+ */
+#if defined(WIN32)
+#include <windows.h>
+#define DC_ATOMIC_CAS(_ptr, _old, _new)	(InterlockedCompareExchange((volatile LONG *) (_ptr), (LONG) (_new), (LONG) (_old)) == (LONG) (_old))
+#define DC_ATOMIC_CAS_PTR(_ptr, _old, _new)	(InterlockedCompareExchangePointer((PVOID volatile *) (_ptr), (_new), (_old)) == (PVOID) (_old))
+#define DC_ATOMIC_ADD(_ptr, _val)	InterlockedExchangeAdd((volatile LONG *) (_ptr), (LONG) (_val))
+#define DC_ATOMIC_GET(_ptr)	InterlockedExchangeAdd((volatile LONG *) (_ptr), 0)
+#define DC_ATOMIC_GET_PTR(_ptr)	InterlockedCompareExchangePointer((PVOID volatile *) (_ptr), NULL, NULL)
+#define DC_ATOMIC_SET_PTR(_ptr, _val)	InterlockedExchangePointer((PVOID volatile *) (_ptr), (_val))
+#else
+#define DC_ATOMIC_CAS(_ptr, _old, _new)	__sync_bool_compare_and_swap((_ptr), (_old), (_new))
+#define DC_ATOMIC_CAS_PTR(_ptr, _old, _new)	__sync_bool_compare_and_swap((_ptr), (_old), (_new))
+#define DC_ATOMIC_ADD(_ptr, _val)	__sync_fetch_and_add((_ptr), (_val))
+#if defined(__ATOMIC_SEQ_CST)
+#define DC_ATOMIC_GET(_ptr)	__atomic_load_n((_ptr), __ATOMIC_SEQ_CST)
+#define DC_ATOMIC_GET_PTR(_ptr)	__atomic_load_n((_ptr), __ATOMIC_SEQ_CST)
+#define DC_ATOMIC_SET_PTR(_ptr, _val)	__atomic_store_n((_ptr), (_val), __ATOMIC_SEQ_CST)
+#else
+#define DC_ATOMIC_GET(_ptr)	__sync_fetch_and_add((_ptr), 0)
+#define DC_ATOMIC_GET_PTR(_ptr)	__sync_val_compare_and_swap((_ptr), NULL, NULL)
+#define DC_ATOMIC_SET_PTR(_ptr, _val)	do { __sync_synchronize(); *(_ptr) = (_val); __sync_synchronize(); } while (0)
+#endif
+#endif
+
 /*
  * Every node of the circular buffer has a data, plus
  * all the variables needed for multithread management.
+ *
+ * The node state is a single word only modified with atomic operations, no lock is taken.
+ * It holds whether the producer is writing the node, whether the data is valid (marked), whether
+ * this node is the last node, the number of consumers which did not release the data yet, and
+ * the lap of the producer when it wrote the node, so that a consumer never gets the same data twice.
+ * Threads only sleep when they cannot go on, and are only woken up if they are waiting.
  */
 typedef struct {
 	/* Pointer to the data on the node */
 	void *data;
-	/* The number of the producer currently using this node */
-	int num_producers;
-	/* The number of consumer currently using this node */
-	int num_consumers;
-	/* The number of consumer currently waiting for this node */
-	int num_consumers_waiting;
-	/* Mutex used for synchronizing the users of this node. */
-	GF_Mutex *mutex;
-	/* Semaphore for producer */
-	GF_Semaphore *producers_semaphore;
-	/* Semaphore for consumers */
-	GF_Semaphore *consumers_semaphore;
-	/* If marked is 0 it means the data on this node is not valid.
-	 * If marked is 1 it means that the data on this node is valid.
-	 * If marked is 2 it means this node is the last node. */
-	int marked;
-	/* Indicates the number of consumers which already accessed this node.
-	 * It is used for the case where the last consumer has to do something. */
-	int num_consumers_accessed;
+	/* State of the node */
+	volatile u32 state;
+	/* The number of consumer currently waiting for this node, for even and odd laps.
+	 * Consumers waiting for the next lap never take the wakeups of the current one */
+	volatile u32 num_consumers_waiting[2];
+	/* Semaphores for consumers, for even and odd laps */
+	GF_Semaphore *consumers_semaphore[2];
 } Node;
 
 /*
  * The circular buffer has a size, a list of nodes and it
  * has the number of consumers using it. Also it needs to know which
  * locking mechanism it needs to use. (LIVE or OFFLINE)
+ * A circular buffer has a single producer.
  */
 typedef struct {
 	/* The size of circular buffer */
@@ -87,6 +109,10 @@ typedef struct {
 	LockMode mode;
 	/* The maximum number of the consumers using the circular buffer */
 	u32 max_num_consumers;
+	/* Set to the index of the node plus one when the producer is waiting for this node to be released */
+	volatile u32 num_producers_waiting;
+	/* Semaphore for producer */
+	GF_Semaphore *producers_semaphore;
 } CircularBuffer;
 
 /*
@@ -97,6 +123,8 @@ typedef struct {
 	int idx;
 	/* The maximum of the index. (Which means the size of circular buffer) */
 	int max_idx;
+	/* The number of times the producer went through the circular buffer */
+	u32 lap;
 
 	char name[GF_MAX_PATH];
 } Producer;
@@ -109,6 +137,14 @@ typedef struct {
 	int idx;
 	/* The maximum of the index. (Which means the size of circular buffer) */
 	int max_idx;
+	/* The number of times the consumer went through the circular buffer */
+	u32 lap;
+	/* The number of nodes locked and not released yet, and the index of the first one */
+	u32 num_locked;
+	int release_idx;
+	/* The index and lap of the last locked node */
+	int locked_idx;
+	u32 locked_lap;
 
 	char name[GF_MAX_PATH];
 } Consumer;
@@ -471,6 +471,7 @@ int dc_parse_command(int argc, char **argv, CmdData *cmd_data)
 	    "    -gdr                    use Gradual Decoder Refresh feature for video encoding (h264 codec only)\n"
 	    "    -gop                    specify GOP size in frames - default is framerate (1 sec gop)\n"
 	    "    -low-delay               specify that low delay settings should be used (no B-frames, fast encoding)\n"
+	    "    -no-cascade              scale each resolution from the input video instead of the nearest larger resolution\n"
 	    "* Audio encoding options:\n"
 	    "    -acodec string          set the output audio codec (default: aac)\n"
 #if 0 //TODO: bind to option and params - test first how it binds to current input parameters
@@ -778,6 +779,9 @@ int dc_parse_command(int argc, char **argv, CmdData *cmd_data)
 		} else if (strcmp(argv[i], "-low-delay") == 0) {
 			cmd_data->video_data_conf.low_delay = 1;
 			i++;
+		} else if (strcmp(argv[i], "-no-cascade") == 0) {
+			cmd_data->no_scale_cascade = 1;
+			i++;
 		} else if (strcmp(argv[i], "-live") == 0) {
 			cmd_data->mode = LIVE_CAMERA;
 			i++;
@@ -92,6 +92,8 @@ typedef struct {
 	int gdr;
 	/* GOP size in frames - 0 means framerate (1 sec)*/
 	int gop_size;
+	/* Scale each resolution from the input video rather than from the nearest larger resolution */
+	int no_scale_cascade;
 	/* MPD min buffer time */
 	float min_buffer_time;
 	/* MPD BaseURL*/
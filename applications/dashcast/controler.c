@@ -1140,13 +1140,6 @@ int dc_run_controler(CmdData *in_data)
 			goto exit;
 		}
 
-		if (dc_video_input_data_init(&video_input_data, /*video_input_file[0]->width, video_input_file[0]->height,
-		  video_input_file[0]->pix_fmt,*/video_scaled_data_list.size, in_data->mode, MAX_SOURCE_NUMBER, video_cb_size) < 0) {
-			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("Cannot initialize audio data.\n"));
-			ret = -1;
-			goto exit;
-		}
-
 		/* open other input videos for source switching */
 		for (i = 0; i < gf_list_count(in_data->vsrc); i++) {
 			VideoDataConf *video_data_conf = (VideoDataConf*)gf_list_get(in_data->vsrc, i);
@@ -1157,6 +1150,26 @@ int dc_run_controler(CmdData *in_data)
 			}
 		}
 
+		/* Scale lower resolutions from the nearest larger one: only the roots of the scaling graph read the decoded frames */
+		if (!in_data->no_scale_cascade) {
+			int max_width = video_input_file[0]->width - in_data->video_data_conf.crop_x;
+			int max_height = video_input_file[0]->height - in_data->video_data_conf.crop_y;
+			for (i=1; i<gf_list_count(in_data->vsrc) + 1; i++) {
+				max_width = MIN(max_width, video_input_file[i]->width - in_data->video_data_conf.crop_x);
+				max_height = MIN(max_height, video_input_file[i]->height - in_data->video_data_conf.crop_y);
+			}
+			dc_video_scaler_list_build_graph(&video_scaled_data_list, max_width, max_height);
+			for (i=0; i<gf_list_count(in_data->vsrc) + 1; i++)
+				video_input_file[i]->nb_consumers = video_scaled_data_list.num_root_scalers;
+		}
+
+		if (dc_video_input_data_init(&video_input_data, /*video_input_file[0]->width, video_input_file[0]->height,
+		  video_input_file[0]->pix_fmt,*/video_scaled_data_list.num_root_scalers, in_data->mode, MAX_SOURCE_NUMBER, video_cb_size) < 0) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("Cannot initialize audio data.\n"));
+			ret = -1;
+			goto exit;
+		}
+
 		for (i=0; i<gf_list_count(in_data->vsrc) + 1; i++) {
 			dc_video_input_data_set_prop(&video_input_data, i, video_input_file[i]->width, video_input_file[i]->height, in_data->video_data_conf.crop_x, in_data->video_data_conf.crop_y, video_input_file[i]->pix_fmt, video_input_file[i]->sar);
 		}
@@ -26,95 +26,130 @@
 #include "message_queue.h"
 
 
+/* Maximum time the reader waits for a message, in ms */
+#define MQ_GET_TIMEOUT	10000
+
 void dc_message_queue_init(MessageQueue *mq)
 {
 	memset(mq, 0, sizeof(MessageQueue));
-	mq->first_node = NULL;
-	mq->last_node = NULL;
+	mq->first_node = &mq->stub;
+	mq->last_node = &mq->stub;
 	mq->nb_nodes = 0;
-	mq->mutex = gf_mx_new("MessageQueue Mutex");
 	mq->sem = gf_sema_new(1000, 0); //TODO: why 1000 (at other places too)
 }
 
+static void dc_message_queue_link(MessageQueue *mq, MessageQueueNode *mqn)
+{
+	MessageQueueNode *prev;
+
+	mqn->next = NULL;
+	do {
+		prev = DC_ATOMIC_GET_PTR(&mq->last_node);
+	} while (!DC_ATOMIC_CAS_PTR(&mq->last_node, prev, mqn));
+	/* The reader waits for this link if it reaches prev in between */
+	DC_ATOMIC_SET_PTR(&prev->next, mqn);
+}
+
 void dc_message_queue_put(MessageQueue *mq, void *data, u32 size)
 {
-	MessageQueueNode *mqn = (MessageQueueNode*)gf_malloc(sizeof(MessageQueueNode));
-	mqn->data = gf_malloc(size);
+	MessageQueueNode *mqn = (MessageQueueNode*)gf_malloc(sizeof(MessageQueueNode) + size);
+	mqn->data = (u8 *) mqn + sizeof(MessageQueueNode);
 	memcpy(mqn->data, data, size);
 	mqn->size = size;
-	mqn->next = NULL;
 
-	gf_mx_p(mq->mutex);
+	dc_message_queue_link(mq, mqn);
+	DC_ATOMIC_ADD(&mq->nb_nodes, 1);
 
-	if (!mq->last_node)
-		mq->first_node = mqn;
-	else
-		mq->last_node->next = mqn;
-
-	mq->last_node = mqn;
-	mq->nb_nodes++;
+	if (DC_ATOMIC_GET(&mq->nb_waiting))
+		gf_sema_notify(mq->sem, 1);
+}
 
-	gf_sema_notify(mq->sem, 1);
-	gf_mx_v(mq->mutex);
+/* Removes the first message, NULL if none or if the message is still being linked */
+static MessageQueueNode *dc_message_queue_pop(MessageQueue *mq)
+{
+	MessageQueueNode *mqn = mq->first_node;
+	MessageQueueNode *next = DC_ATOMIC_GET_PTR(&mqn->next);
+
+	if (mqn == &mq->stub) {
+		if (!next)
+			return NULL;
+		mq->first_node = next;
+		mqn = next;
+		next = DC_ATOMIC_GET_PTR(&next->next);
+	}
+	if (next) {
+		mq->first_node = next;
+		return mqn;
+	}
+	if (mqn != DC_ATOMIC_GET_PTR(&mq->last_node))
+		return NULL;
+
+	/* Last message: put back the placeholder behind it */
+	dc_message_queue_link(mq, &mq->stub);
+	next = DC_ATOMIC_GET_PTR(&mqn->next);
+	if (next) {
+		mq->first_node = next;
+		return mqn;
+	}
+	return NULL;
 }
 
 int dc_message_queue_get(MessageQueue *mq, void * data)
 {
-	int ret = 0;
+	int ret;
 	MessageQueueNode *mqn;
+	u32 start = gf_sys_clock();
+
+	while (1) {
+		u32 elapsed;
+		mqn = dc_message_queue_pop(mq);
+		if (mqn)
+			break;
+
+		/* A writer is linking its message */
+		if (DC_ATOMIC_GET(&mq->nb_nodes)) {
+			gf_sleep(0);
+			continue;
+		}
 
-	gf_mx_p(mq->mutex);
-
-	mqn = mq->first_node;
-	if (!mqn) {
-		gf_mx_v(mq->mutex);
-		ret = gf_sema_wait_for(mq->sem, 10000);
-		gf_mx_p(mq->mutex);
-
-		mqn = mq->first_node;
-
-		if (!ret || !mqn) {
-			gf_mx_v(mq->mutex);
+		elapsed = gf_sys_clock() - start;
+		if (elapsed >= MQ_GET_TIMEOUT)
 			return -1;
-		}
-	}
-	if (mqn) {
-		mq->first_node = mqn->next;
-		if (!mq->first_node)
-			mq->last_node = NULL;
-		mq->nb_nodes--;
-		memcpy(data, mqn->data, mqn->size);
-		ret = (int)mqn->size;
-		gf_free(mqn->data);
-		gf_free(mqn);
+
+		DC_ATOMIC_ADD(&mq->nb_waiting, 1);
+		if (!DC_ATOMIC_GET(&mq->nb_nodes))
+			gf_sema_wait_for(mq->sem, MQ_GET_TIMEOUT - elapsed);
+		DC_ATOMIC_ADD(&mq->nb_waiting, -1);
 	}
 
-	gf_mx_v(mq->mutex);
+	DC_ATOMIC_ADD(&mq->nb_nodes, -1);
+	memcpy(data, mqn->data, mqn->size);
+	ret = (int)mqn->size;
+	gf_free(mqn);
 
 	return ret;
 }
 
 void dc_message_queue_flush(MessageQueue *mq)
 {
-	MessageQueueNode *mqn, *mqn1;
-
-	gf_mx_p(mq->mutex);
+	MessageQueueNode *mqn;
 
-	for (mqn = mq->first_node; mqn != NULL; mqn = mqn1) {
-		mqn1 = mqn->next;
+	while (DC_ATOMIC_GET(&mq->nb_nodes)) {
+		mqn = dc_message_queue_pop(mq);
+		if (!mqn) {
+			gf_sleep(0);
+			continue;
+		}
+		DC_ATOMIC_ADD(&mq->nb_nodes, -1);
 		gf_free(mqn);
 	}
-	mq->last_node = NULL;
-	mq->first_node = NULL;
-	mq->nb_nodes = 0;
 
-	gf_sema_notify(mq->sem, 1);
-	gf_mx_v(mq->mutex);
+	if (DC_ATOMIC_GET(&mq->nb_waiting))
+		gf_sema_notify(mq->sem, 1);
 }
 
 void dc_message_queue_free(MessageQueue *mq)
 {
 	dc_message_queue_flush(mq);
-	gf_mx_del(mq->mutex);
 	gf_sema_del(mq->sem);
 }
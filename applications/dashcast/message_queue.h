@@ -29,20 +29,29 @@
 #include <string.h>
 #include <stdlib.h>
 #include <gpac/thread.h>
+#include "circular_buffer.h"
 
 
 typedef struct MessageQueueNode {
 	void *data;
 	u32 size;
-	struct MessageQueueNode *next;
+	struct MessageQueueNode * volatile next;
 } MessageQueueNode;
 
+/*
+ * Messages can be put by any thread without locking, they must be read by a single thread.
+ * The reader only sleeps when the queue is empty, and is only woken up if it sleeps.
+ */
 typedef struct MessageQueue {
-	MessageQueueNode *last_node;
+	/* Last message put, updated by the writers */
+	MessageQueueNode * volatile last_node;
+	/* Next message to read, only used by the reader */
 	MessageQueueNode *first_node;
-	int nb_nodes;
+	/* Placeholder keeping the list linked when all messages are read */
+	MessageQueueNode stub;
+	volatile int nb_nodes;
+	volatile u32 nb_waiting;
 	GF_Semaphore *sem;
-	GF_Mutex *mutex;
 } MessageQueue;
 
 void dc_message_queue_init(MessageQueue *mq);
@@ -258,7 +258,11 @@ int dc_video_decoder_read(VideoInputFile *video_input_file, VideoInputData *vide
 				continue;
 			}
 
-			dc_producer_lock(&video_input_data->producer, &video_input_data->circular_buf);
+			/* Live: the node may still be used by late consumers, wait for it rather than writing or ending the stream under them */
+			while (dc_producer_lock(&video_input_data->producer, &video_input_data->circular_buf) < 0) {
+				if (*exit_signal_addr) return 0;
+				gf_sleep(10);
+			}
 			dc_producer_unlock_previous(&video_input_data->producer, &video_input_data->circular_buf);
 			video_data_node = (VideoDataNode *) dc_producer_produce(&video_input_data->producer, &video_input_data->circular_buf);
 			video_data_node->source_number = source_number;
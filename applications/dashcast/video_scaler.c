@@ -79,7 +79,8 @@ void dc_video_scaler_list_init(VideoScaledDataList *video_scaled_data_list, GF_L
 		found = 0;
 		for (j=0; j<video_scaled_data_list->size; j++) {
 			if (   video_scaled_data_list->video_scaled_data[j]->out_height == video_data_conf->height
-			        && video_scaled_data_list->video_scaled_data[j]->out_width  == video_data_conf->width) {
+			        && video_scaled_data_list->video_scaled_data[j]->out_width  == video_data_conf->width
+			        && video_scaled_data_list->video_scaled_data[j]->out_pix_fmt == PIX_FMT_YUV420P) {
 				found = 1;
 				video_scaled_data_list->video_scaled_data[j]->num_consumers++;
 				break;
@@ -94,6 +95,7 @@ void dc_video_scaler_list_init(VideoScaledDataList *video_scaled_data_list, GF_L
 			}
 			video_scaled_data->out_width  = video_data_conf->width;
 			video_scaled_data->out_height = video_data_conf->height;
+			video_scaled_data->out_pix_fmt = PIX_FMT_YUV420P;
 			video_scaled_data->num_consumers = 1;
 
 			video_scaled_data_list->video_scaled_data = (VideoScaledData**)gf_realloc(video_scaled_data_list->video_scaled_data, (video_scaled_data_list->size+1)*sizeof(VideoScaledData*));
@@ -102,6 +104,39 @@ void dc_video_scaler_list_init(VideoScaledDataList *video_scaled_data_list, GF_L
 			video_scaled_data_list->size++;
 		}
 	}
+	video_scaled_data_list->num_root_scalers = video_scaled_data_list->size;
+}
+
+void dc_video_scaler_list_build_graph(VideoScaledDataList *video_scaled_data_list, int max_width, int max_height)
+{
+	u32 i, j;
+
+	video_scaled_data_list->num_root_scalers = 0;
+	for (i=0; i<video_scaled_data_list->size; i++) {
+		VideoScaledData *video_scaled_data = video_scaled_data_list->video_scaled_data[i];
+		VideoScaledData *parent = NULL;
+
+		for (j=0; j<video_scaled_data_list->size; j++) {
+			VideoScaledData *source = video_scaled_data_list->video_scaled_data[j];
+			if ((source == video_scaled_data) || (source->out_pix_fmt != video_scaled_data->out_pix_fmt))
+				continue;
+			/*only downscale, and never from an upscaled resolution*/
+			if ((source->out_width < video_scaled_data->out_width) || (source->out_height < video_scaled_data->out_height))
+				continue;
+			if ((source->out_width > max_width) || (source->out_height > max_height))
+				continue;
+			if (!parent || ((u64) source->out_width * source->out_height < (u64) parent->out_width * parent->out_height))
+				parent = source;
+		}
+
+		video_scaled_data->parent = parent;
+		if (parent) {
+			parent->num_consumers++;
+			GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("Video scaler %dx%d scales from %dx%d\n", video_scaled_data->out_width, video_scaled_data->out_height, parent->out_width, parent->out_height));
+		} else {
+			video_scaled_data_list->num_root_scalers++;
+		}
+	}
 }
 
 void dc_video_scaler_list_destroy(VideoScaledDataList *video_scaled_data_list)
@@ -129,13 +164,15 @@ int dc_video_scaler_data_init(VideoInputData *video_input_data, VideoScaledData
 	dc_consumer_init(&video_scaled_data->consumer, video_cb_size, name);
 
 	video_scaled_data->num_producers = max_source;
-	video_scaled_data->out_pix_fmt = PIX_FMT_YUV420P;
 	GF_SAFE_ALLOC_N(video_scaled_data->vsprop, max_source, VideoScaledProp);
 	memset(video_scaled_data->vsprop, 0, max_source * sizeof(VideoScaledProp));
 
 	dc_circular_buffer_create(&video_scaled_data->circular_buf, video_cb_size, video_input_data->circular_buf.mode, video_scaled_data->num_consumers);
 	for (i=0; i<video_cb_size; i++) {
-		video_scaled_data->circular_buf.list[i].data = dc_video_scaler_node_create(video_scaled_data->out_width, video_scaled_data->out_height, video_input_data->vprop[i].crop_x, video_input_data->vprop[i].crop_y, video_scaled_data->out_pix_fmt);
+		/*frames of the parent are already cropped*/
+		int crop_x = video_scaled_data->parent ? 0 : video_input_data->vprop[i].crop_x;
+		int crop_y = video_scaled_data->parent ? 0 : video_input_data->vprop[i].crop_y;
+		video_scaled_data->circular_buf.list[i].data = dc_video_scaler_node_create(video_scaled_data->out_width, video_scaled_data->out_height, crop_x, crop_y, video_scaled_data->out_pix_fmt);
 	}
 
 	video_scaled_data->vsprop->video_input_data = video_input_data;
@@ -144,11 +181,22 @@ int dc_video_scaler_data_init(VideoInputData *video_input_data, VideoScaledData
 
 int dc_video_scaler_data_set_prop(VideoInputData *video_input_data, VideoScaledData *video_scaled_data, int index)
 {
-	video_scaled_data->vsprop[index].in_width   = video_input_data->vprop[index].width - video_input_data->vprop[index].crop_x;
-	video_scaled_data->vsprop[index].in_height  = video_input_data->vprop[index].height - video_input_data->vprop[index].crop_y;
-	video_scaled_data->vsprop[index].in_pix_fmt = video_input_data->vprop[index].pix_fmt;
+	if (video_scaled_data->parent) {
+		/*frames of the parent have the same properties whatever the source*/
+		video_scaled_data->sar = video_input_data->vprop[index].sar;
+		if (video_scaled_data->vsprop[0].sws_ctx)
+			return 0;
+		video_scaled_data->vsprop[0].in_width   = video_scaled_data->parent->out_width;
+		video_scaled_data->vsprop[0].in_height  = video_scaled_data->parent->out_height;
+		video_scaled_data->vsprop[0].in_pix_fmt = video_scaled_data->parent->out_pix_fmt;
+		index = 0;
+	} else {
+		video_scaled_data->vsprop[index].in_width   = video_input_data->vprop[index].width - video_input_data->vprop[index].crop_x;
+		video_scaled_data->vsprop[index].in_height  = video_input_data->vprop[index].height - video_input_data->vprop[index].crop_y;
+		video_scaled_data->vsprop[index].in_pix_fmt = video_input_data->vprop[index].pix_fmt;
 
-	video_scaled_data->sar  = video_input_data->vprop[index].sar;
+		video_scaled_data->sar  = video_input_data->vprop[index].sar;
+	}
 
 	video_scaled_data->vsprop[index].sws_ctx = sws_getContext(
 	            video_scaled_data->vsprop[index].in_width,
@@ -167,13 +215,17 @@ int dc_video_scaler_data_set_prop(VideoInputData *video_input_data, VideoScaledD
 int dc_video_scaler_scale(VideoInputData *video_input_data, VideoScaledData *video_scaled_data)
 {
 	int ret, index, src_height;
-	VideoDataNode *video_data_node;
+	VideoDataNode *video_data_node = NULL;
 	VideoScaledDataNode *video_scaled_data_node;
 	AVFrame *src_vframe;
+	int64_t pts;
+	u64 frame_ntp, frame_utc;
+	/*either the decoded frames or the frames of the parent resolution*/
+	CircularBuffer *src_buf = video_scaled_data->parent ? &video_scaled_data->parent->circular_buf : &video_input_data->circular_buf;
 
 	//step 1: try to lock output slot. If none available, return ....
-	if (video_input_data->circular_buf.size > 1)
-		dc_consumer_unlock_previous(&video_scaled_data->consumer, &video_input_data->circular_buf);
+	if (src_buf->size > 1)
+		dc_consumer_unlock_previous(&video_scaled_data->consumer, src_buf);
 
 	ret = dc_producer_lock(&video_scaled_data->producer, &video_scaled_data->circular_buf);
 	//not ready
@@ -183,34 +235,49 @@ int dc_video_scaler_scale(VideoInputData *video_input_data, VideoScaledData *vid
 	dc_producer_unlock_previous(&video_scaled_data->producer, &video_scaled_data->circular_buf);
 
 	//step 2: lock input
-	ret = dc_consumer_lock(&video_scaled_data->consumer, &video_input_data->circular_buf);
+	ret = dc_consumer_lock(&video_scaled_data->consumer, src_buf);
 	if (ret < 0) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("Video scaler got an end of input tbuffer!\n"));
 		return -2;
 	}
 
 	//step 3 - grab source and dest images
-	video_data_node = (VideoDataNode*)dc_consumer_consume(&video_scaled_data->consumer, &video_input_data->circular_buf);
 	video_scaled_data_node = (VideoScaledDataNode*)dc_producer_produce(&video_scaled_data->producer, &video_scaled_data->circular_buf);
-	index = video_data_node->source_number;
 
-	//crop if necessary
-	if (video_input_data->vprop[index].crop_x || video_input_data->vprop[index].crop_y) {
+	if (video_scaled_data->parent) {
+		//the parent frame is already cropped and has the same properties whatever the source
+		VideoScaledDataNode *parent_node = (VideoScaledDataNode*)dc_consumer_consume(&video_scaled_data->consumer, src_buf);
+		index = 0;
+		src_vframe = parent_node->vframe;
+		src_height = video_scaled_data->parent->out_height;
+		pts = parent_node->vframe->pts;
+		frame_ntp = parent_node->frame_ntp;
+		frame_utc = parent_node->frame_utc;
+	} else {
+		video_data_node = (VideoDataNode*)dc_consumer_consume(&video_scaled_data->consumer, src_buf);
+		index = video_data_node->source_number;
+		pts = video_data_node->vframe->pts;
+		frame_ntp = video_data_node->frame_ntp;
+		frame_utc = video_data_node->frame_utc;
+
+		//crop if necessary
+		if (video_input_data->vprop[index].crop_x || video_input_data->vprop[index].crop_y) {
 #if 0
-		av_frame_copy_props(video_scaled_data_node->cropped_frame, video_data_node->vframe);
-		video_scaled_data_node->cropped_frame->width  = video_input_data->vprop[index].width  - video_input_data->vprop[index].crop_x;
-		video_scaled_data_node->cropped_frame->height = video_input_data->vprop[index].height - video_input_data->vprop[index].crop_y;
+			av_frame_copy_props(video_scaled_data_node->cropped_frame, video_data_node->vframe);
+			video_scaled_data_node->cropped_frame->width  = video_input_data->vprop[index].width  - video_input_data->vprop[index].crop_x;
+			video_scaled_data_node->cropped_frame->height = video_input_data->vprop[index].height - video_input_data->vprop[index].crop_y;
 #endif
-		if (av_picture_crop((AVPicture*)video_scaled_data_node->cropped_frame, (AVPicture*)video_data_node->vframe, PIX_FMT_YUV420P, video_input_data->vprop[index].crop_y, video_input_data->vprop[index].crop_x) < 0) {
-			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("Video scaler: error while cropping picture.\n"));
-			return -1;
+			if (av_picture_crop((AVPicture*)video_scaled_data_node->cropped_frame, (AVPicture*)video_data_node->vframe, PIX_FMT_YUV420P, video_input_data->vprop[index].crop_y, video_input_data->vprop[index].crop_x) < 0) {
+				GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("Video scaler: error while cropping picture.\n"));
+				return -1;
+			}
+			src_vframe = video_scaled_data_node->cropped_frame;
+			src_height = video_input_data->vprop[index].height - video_input_data->vprop[index].crop_y;
+		} else {
+			assert(!video_scaled_data_node->cropped_frame);
+			src_vframe = video_data_node->vframe;
+			src_height = video_input_data->vprop[index].height;
 		}
-		src_vframe = video_scaled_data_node->cropped_frame;
-		src_height = video_input_data->vprop[index].height - video_input_data->vprop[index].crop_y;
-	} else {
-		assert(!video_scaled_data_node->cropped_frame);
-		src_vframe = video_data_node->vframe;
-		src_height = video_input_data->vprop[index].height;
 	}
 
 
@@ -223,12 +290,12 @@ int dc_video_scaler_scale(VideoInputData *video_input_data, VideoScaledData *vid
 		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("Video scaler: error while resizing picture.\n"));
 		return -1;
 	}
-	video_scaled_data_node->vframe->pts = video_data_node->vframe->pts;
-	video_scaled_data_node->frame_ntp = video_data_node->frame_ntp;
-	video_scaled_data_node->frame_utc = video_data_node->frame_utc;
+	video_scaled_data_node->vframe->pts = pts;
+	video_scaled_data_node->frame_ntp = frame_ntp;
+	video_scaled_data_node->frame_utc = frame_utc;
 
 
-	if (video_data_node->nb_raw_frames_ref) {
+	if (video_data_node && video_data_node->nb_raw_frames_ref) {
 		if (video_data_node->nb_raw_frames_ref==1) {
 #ifndef GPAC_USE_LIBAV
 			av_frame_unref(video_data_node->vframe);
@@ -241,8 +308,8 @@ int dc_video_scaler_scale(VideoInputData *video_input_data, VideoScaledData *vid
 	dc_consumer_advance(&video_scaled_data->consumer);
 	dc_producer_advance(&video_scaled_data->producer, &video_scaled_data->circular_buf);
 
-	if (video_input_data->circular_buf.size == 1)
-		dc_consumer_unlock_previous(&video_scaled_data->consumer, &video_input_data->circular_buf);
+	if (src_buf->size == 1)
+		dc_consumer_unlock_previous(&video_scaled_data->consumer, src_buf);
 	return 0;
 }
 
@@ -46,10 +46,17 @@ typedef struct {
 /*
  * VideoScaledData keeps a circular buffer
  * of video frame with a defined resolution.
+ *
+ * The scaled data form a scaling graph: a resolution scales from the frames
+ * of its parent, the smallest larger resolution with the same pixel format,
+ * or from the decoded frames when it has no parent.
  */
-typedef struct {
+typedef struct VideoScaledData {
 	VideoScaledProp *vsprop;
 
+	/* scaled data this one scales from, NULL when scaling from the input video */
+	struct VideoScaledData *parent;
+
 	int out_width;
 	int out_height;
 	int out_pix_fmt;
@@ -72,7 +79,7 @@ typedef struct {
 	Consumer consumer;
 
 	/* The number of consumers of this circular buffer.
-	 * (Which are the encoders who are using this resolution) */
+	 * (Which are the encoders who are using this resolution, and the scalers of the children resolutions) */
 	int num_consumers;
 	int num_producers;
 } VideoScaledData;
@@ -93,17 +100,33 @@ typedef struct {
 typedef struct {
 	VideoScaledData **video_scaled_data;
 	u32 size;
+	/* number of scalers consuming the input video frames (the roots of the scaling graph) */
+	u32 num_root_scalers;
 } VideoScaledDataList;
 
 /*
  * Read the configuration file info and fill the video scaled data list with all the resolution available.
- * Each resolution is associated to a circular buffer in a video scaled data.
+ * Each resolution is associated to a circular buffer in a video scaled data, shared by all the encoders
+ * of this resolution. All resolutions scale from the input video until dc_video_scaler_list_build_graph is called.
  *
  * @param cmd_data [in] Command data which contains the configuration file info
  * @param video_scaled_data_list [out] the list to be filled
  */
 void dc_video_scaler_list_init(VideoScaledDataList *video_scaled_data_list, GF_List *video_lst);
 
+/*
+ * Build the scaling graph: each resolution scales from the smallest larger resolution
+ * with the same pixel format instead of the input video.
+ * Resolutions larger than the input video are upscaled and never used as a source.
+ *
+ * @param video_scaled_data_list [in/out] the list of resolutions
+ * @param max_width [in] smallest width of the (cropped) input videos
+ * @param max_height [in] smallest height of the (cropped) input videos
+ *
+ * @note Must be called before dc_video_scaler_data_init.
+ */
+void dc_video_scaler_list_build_graph(VideoScaledDataList *video_scaled_data_list, int max_width, int max_height);
+
 /*
  * Destroy a video scaled data list.
  *
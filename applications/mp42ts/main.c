@@ -56,10 +56,8 @@ u32 temi_url_insertion_delay = 1000;
 u32 temi_offset = 0;
 Bool temi_disable_loop = GF_FALSE;
 Double temi_period=0;
-Bool request_temi_toggle = GF_FALSE;
-Bool temi_on = GF_TRUE;
+Bool temi_start_on = GF_TRUE;
 Bool temi_single_toggle = GF_FALSE;
-u64 temi_period_last_dts = 0;
 FILE *logfile = NULL;
 
 static void on_gpac_log(void *cbk, GF_LOG_Level ll, GF_LOG_Tool lm, const char *fmt, va_list list)
@@ -192,6 +190,10 @@ typedef struct
 	u32 pmt_version;
 
 	Double last_ntp;
+
+	/*TEMI state of the program*/
+	Bool temi_on, request_temi_toggle;
+	u64 temi_period_last_dts;
 } M2TSSource;
 
 #ifndef GPAC_DISABLE_ISOM
@@ -389,32 +391,32 @@ static GF_Err mp4_input_ctrl(GF_ESInterface *ifce, u32 act_type, void *param)
 			}
 			if (!temi_period) {
 				//toggle temi at RAP POINTS ONLY
-				if (request_temi_toggle && priv->sample->IsRAP) {
-					temi_on = !temi_on;
-					if (!temi_on) {
+				if (priv->source->request_temi_toggle && priv->sample->IsRAP) {
+					priv->source->temi_on = !priv->source->temi_on;
+					if (!priv->source->temi_on) {
 						deactivate_temi = GF_TRUE;
 					}
-					fprintf(stderr, "Turning TEMI %st at DTS "LLU" (%g sec)\n", temi_on ? "on" : "off" , priv->sample->DTS, ((Double)priv->sample->DTS)/ifce->timescale);
-					request_temi_toggle = GF_FALSE;
+					fprintf(stderr, "Turning TEMI %st at DTS "LLU" (%g sec)\n", priv->source->temi_on ? "on" : "off" , priv->sample->DTS, ((Double)priv->sample->DTS)/ifce->timescale);
+					priv->source->request_temi_toggle = GF_FALSE;
 				}
-				insert_temi = temi_on;
+				insert_temi = priv->source->temi_on;
 			} else {
 
-				if (!temi_on) {
-					if (priv->sample->IsRAP && ((priv->sample->DTS - temi_period_last_dts) >= temi_period * ifce->timescale)) {
-						temi_on = GF_TRUE;
-						temi_period_last_dts = priv->sample->DTS;
+				if (!priv->source->temi_on) {
+					if (priv->sample->IsRAP && ((priv->sample->DTS - priv->source->temi_period_last_dts) >= temi_period * ifce->timescale)) {
+						priv->source->temi_on = GF_TRUE;
+						priv->source->temi_period_last_dts = priv->sample->DTS;
 						fprintf(stderr, "Turning TEMI on at DTS "LLU" (%g sec)\n", priv->sample->DTS, ((Double)priv->sample->DTS)/ifce->timescale);
 					}
 				} else {
-					if (!temi_single_toggle && priv->sample->IsRAP && ((priv->sample->DTS - temi_period_last_dts) >= temi_period * ifce->timescale)) {
-						temi_on = GF_FALSE;
-						temi_period_last_dts = priv->sample->DTS;
+					if (!temi_single_toggle && priv->sample->IsRAP && ((priv->sample->DTS - priv->source->temi_period_last_dts) >= temi_period * ifce->timescale)) {
+						priv->source->temi_on = GF_FALSE;
+						priv->source->temi_period_last_dts = priv->sample->DTS;
 						fprintf(stderr, "Turning TEMI off at DTS "LLU" (%g sec)\n", priv->sample->DTS, ((Double)priv->sample->DTS)/ifce->timescale);
 						deactivate_temi = GF_TRUE;
 					}
 				}
-				insert_temi = temi_on;
+				insert_temi = priv->source->temi_on;
 			}
 
 			if (insert_temi) {
@@ -2195,7 +2197,7 @@ static GFINLINE GF_Err parse_args(int argc, char **argv, u32 *mux_rate, u32 *car
 		} else if (!stricmp(arg, "-temi-noloop")) {
 			temi_disable_loop = 1;
 		} else if (!stricmp(arg, "-temi-off")) {
-			temi_on = GF_FALSE;
+			temi_start_on = GF_FALSE;
 		} else if (CHECK_PARAM("-temi-period")) {
 			temi_period = atof(next_arg);
 			if (temi_period<0) {
@@ -2618,6 +2620,7 @@ int main(int argc, char **argv)
 	}
 
 	for (i=0; i<nb_sources; i++) {
+		sources[i].temi_on = temi_start_on;
 		if (!sources[i].ID) {
 			for (j=i+1; j<nb_sources; j++) {
 				if (sources[i].ID < sources[j].ID) sources[i].ID = sources[i].ID+1;
@@ -2841,7 +2844,11 @@ call_flush:
 				if (gf_prompt_has_input()) {
 					char c = gf_prompt_get_char();
 					if (c=='q') break;
-					else if (c=='t') request_temi_toggle = GF_TRUE;
+					else if (c=='t') {
+						for (i=0; i<nb_sources; i++) {
+							sources[i].request_temi_toggle = GF_TRUE;
+						}
+					}
 				}
 			}
 			if (status == GF_M2TS_STATE_IDLE) {
@@ -68,6 +68,8 @@ void PrintStreamerUsage()
 	        "-ifce=IFCE   IP address of the physical interface to use. Default: NULL (ANY)\n"
 	        "-ttl=TTL     time to live for multicast packets. Default: 1\n"
 	        "-sdp=Name    file name of the generated SDP. Default: \"session.sdp\"\n"
+	        "-batch=N     queues up to N RTP packets per stream and sends them in one system call. Default: 0 (off)\n"
+	        "-pacing=T    with -batch, paces packets of each stream in bursts of at most T microseconds. Default: 0 (off)\n"
 	        "\n"
 	       );
 }
@@ -95,6 +97,8 @@ int stream_file_rtp(int argc, char **argv)
 	Bool force_mpeg4 = GF_FALSE;
     u32 path_mtu = 1450;
     Double run_for = -1.0;
+	u32 batch_size = 0;
+	u32 pacing_us = 0;
 	u32 i;
 
 	for (i = 1; i < (u32) argc ; i++) {
@@ -120,6 +124,8 @@ int stream_file_rtp(int argc, char **argv)
 		else if (!strnicmp(arg, "-logs=", 6)) logs = arg+6;
 		else if (!strnicmp(arg, "-lf=", 4)) logfile = gf_fopen(arg+4, "wt");
         else if (!strnicmp(arg, "-run-for=", 9)) run_for = atof(arg+9);
+		else if (!strnicmp(arg, "-batch=", 7)) batch_size = atoi(arg+7);
+		else if (!strnicmp(arg, "-pacing=", 8)) pacing_us = atoi(arg+8);
 	}
 
 	gf_sys_init(mem_track);
@@ -146,6 +152,7 @@ int stream_file_rtp(int argc, char **argv)
 		u32 check = 50;
 		fprintf(stderr, "Starting streaming %s to %s:%d\n", inName, ip_dest, port);
 		gf_isom_streamer_write_sdp(file_streamer, sdp_file);
+		if (batch_size) gf_isom_streamer_set_send_batch(file_streamer, batch_size, pacing_us);
 
         if (run_for==0) run=GF_FALSE;
 
@@ -927,14 +934,12 @@ u32 grab_live_m2ts(const char *grab_m2ts, const char *grab_ifce, const char *out
 		/*process chunk*/
 		if (is_rtp) {
 #ifndef GPAC_DISABLE_STREAMING
-			char *pck;
 			seq_num = ((data[2] << 8) & 0xFF00) | (data[3] & 0xFF);
 			gf_rtp_reorderer_add(ch, (void *) data, size, seq_num);
 
-			pck = (char *) gf_rtp_reorderer_get(ch, &size);
-			if (pck) {
-				fwrite(pck+12, size-12, 1, output);
-				gf_free(pck);
+			size = gf_rtp_reorderer_get_into(ch, data, 0x40000);
+			if (size > 12) {
+				fwrite(data+12, size-12, 1, output);
 			}
 #else
 			fwrite(data+12, size-12, 1, output);
@@ -217,6 +217,8 @@ void PrintGeneralUsage()
             " -mem-track:  enables memory tracker\n"
             " -mem-track-stack:  enables memory tracker with stack dumping\n"
 #endif
+            " -mem-acc:  enables per-subsystem memory accounting, printed at exit\n"
+            " -mem-acc-dump ms:  prints memory accounting every ms milliseconds\n"
 	        " -strict-error        exits after the first error is reported\n"
 	        " -inter time_in_ms    interleaves file data (track chunks of time_in_ms), on by default with 0.5s window\n"
 	        "                       * Note: a value of 0 disables interleaving\n"
@@ -461,6 +463,7 @@ void PrintDASHUsage()
 	        "                        !! Do not use with multiple periods, nor when DASH duration is not a multiple of GOP size !!\n"
 	        " -cues                ignores dash duration and segment according to cue times in given XML file. See tests/media/dash_cues for examples.\n"
 	        " -strict-cues         throw error if something is wrong while parsing cues or applying cue-based segmentation.\n"
+	        " -hls NAME            also generates HLS master playlist NAME and one media playlist per representation next to the MPD (static mode only).\n"
 	        "\n");
 }
 
@@ -989,6 +992,7 @@ void PrintUsage()
 	         " -log-file FILE       sets output log file. Also works with -lf FILE\n"
 	         " -log-clock or -lc    logs time in micro sec since start time of GPAC before each log line.\n"
 	         " -log-utc or -lu      logs UTC time in ms before each log line.\n"
+	         " -trace FILE          records trace events and writes them to FILE in Chrome trace format at exit\n"
 	         " -version             gets build version\n"
 	         " -- INPUT             escape option if INPUT starts with - character\n"
 	         "\n"
@@ -2310,6 +2314,7 @@ GF_DashProfile dash_profile = GF_DASH_PROFILE_UNKNOWN;
 const char *dash_profile_extension = NULL;
 const char *dash_cues = NULL;
 Bool strict_cues = GF_FALSE;
+const char *hls_master = NULL;
 Bool use_url_template = GF_FALSE;
 Bool seg_at_rap = GF_FALSE;
 Bool frag_at_rap = GF_FALSE;
@@ -3323,6 +3328,16 @@ Bool mp4box_parse_args(int argc, char **argv)
 		else if (!stricmp(arg, "-quiet")) quiet = 2;
         else if (!strcmp(argv[i], "-mem-track")) continue;
         else if (!strcmp(argv[i], "-mem-track-stack")) continue;
+		else if (!strcmp(argv[i], "-mem-acc")) continue;
+		else if (!strcmp(argv[i], "-mem-acc-dump")) {
+			CHECK_NEXT_ARG
+			if (gf_memory_set_tags_dump_period(atoi(argv[i + 1])) != GF_OK) {
+				fprintf(stderr, "WARNING - memory accounting not enabled - ignoring \"-mem-acc-dump\"\n");
+			} else {
+				gf_log_set_tool_level(GF_LOG_MEMORY, GF_LOG_INFO);
+			}
+			i++;
+		}
 
 		else if (!stricmp(arg, "-logs")) {
 			CHECK_NEXT_ARG
@@ -3342,6 +3357,13 @@ Bool mp4box_parse_args(int argc, char **argv)
 		else if (!strcmp(arg, "-lu") || !strcmp(arg, "-log-utc")) {
 			log_utc_time = GF_TRUE;
 		}
+		else if (!strcmp(arg, "-trace")) {
+			CHECK_NEXT_ARG
+			if (gf_trace_start(argv[i + 1], 0) != GF_OK) {
+				fprintf(stderr, "WARNING - GPAC not compiled with trace support - ignoring \"-trace\"\n");
+			}
+			i++;
+		}
 		else if (!stricmp(arg, "-noprog")) quiet = 1;
 		else if (!stricmp(arg, "-tracks")) get_nb_tracks = 1;
 		else if (!stricmp(arg, "-info") || !stricmp(arg, "-infon")) {
@@ -4029,6 +4051,11 @@ Bool mp4box_parse_args(int argc, char **argv)
 		else if (!stricmp(arg, "-strict-cues")) {
 			strict_cues = GF_TRUE;
 		}
+		else if (!stricmp(arg, "-hls")) {
+			CHECK_NEXT_ARG
+			hls_master = argv[i + 1];
+			i++;
+		}
 		else if (!stricmp(arg, "-insert-utc")) {
 			insert_utc = GF_TRUE;
 		}
@@ -4099,6 +4126,10 @@ int mp4boxMain(int argc, char **argv)
 	tmpdir = NULL;
 
 	for (i = 1; i < (u32) argc ; i++) {
+		if (!strcmp(argv[i], "-mem-acc")) {
+			mem_track = GF_MemTrackerAccounting;
+			break;
+		}
 		if (!strcmp(argv[i], "-mem-track") || !strcmp(argv[i], "-mem-track-stack")) {
 #ifdef GPAC_MEMORY_TRACKING
             mem_track = !strcmp(argv[i], "-mem-track-stack") ? GF_MemTrackerBackTrace : GF_MemTrackerSimple;
@@ -4694,6 +4725,7 @@ int mp4boxMain(int argc, char **argv)
 		if (!e) e = gf_dasher_set_split_on_closest(dasher, split_on_closest);
 		if (!e && dash_cues) e = gf_dasher_set_cues(dasher, dash_cues, strict_cues);
 		if (!e) e = gf_dasher_set_isobmff_options(dasher, mvex_after_traks, sdtp_in_traf);
+		if (!e && hls_master) e = gf_dasher_set_hls_output(dasher, hls_master);
 
 		for (i=0; i < nb_dash_inputs; i++) {
 			if (!e) e = gf_dasher_add_input(dasher, &dash_inputs[i]);
@@ -5934,8 +5966,12 @@ err_exit:
 exit:
 	mp4box_cleanup(0);
 
+	if (mem_track == GF_MemTrackerAccounting) {
+		gf_log_set_tool_level(GF_LOG_MEMORY, GF_LOG_INFO);
+		gf_memory_print_tags();
+	}
 #ifdef GPAC_MEMORY_TRACKING
-	if (mem_track && (gf_memory_size() || gf_file_handles_count() )) {
+	else if (mem_track && (gf_memory_size() || gf_file_handles_count() )) {
 		gf_log_set_tool_level(GF_LOG_MEMORY, GF_LOG_INFO);
 		gf_memory_print();
 		return 2;
@@ -0,0 +1,137 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / CRC32 benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*checks gf_crc_32 against a bitwise-table reference (one byte per iteration) and compares their throughput over
+sections of mixed sizes, as found in MPEG-2 TS PSI/SI and MPE: PAT, PMT, SDT, EIT and MPE datagram sections.*/
+
+#include <gpac/tools.h>
+
+#define NB_SECTIONS	4096
+
+static u32 ref_table[256];
+
+static void ref_init()
+{
+	u32 i, j;
+	for (i=0; i<256; i++) {
+		u32 c = i << 24;
+		for (j=0; j<8; j++)
+			c = (c & 0x80000000) ? ((c << 1) ^ 0x04C11DB7) : (c << 1);
+		ref_table[i] = c;
+	}
+}
+
+static u32 ref_crc_32(const char *data, u32 len)
+{
+	u32 i, crc = 0xffffffff;
+	for (i=0; i<len; i++)
+		crc = (crc << 8) ^ ref_table[((crc >> 24) ^ *data++) & 0xff];
+	return crc;
+}
+
+/*section size distribution: mostly short PSI sections, with some long EIT and MPE sections*/
+static u32 get_section_size()
+{
+	u32 r = gf_rand() % 100;
+	if (r < 30) return 12 + gf_rand() % 8;
+	if (r < 60) return 20 + gf_rand() % 180;
+	if (r < 80) return 50 + gf_rand() % 950;
+	if (r < 90) return 100 + gf_rand() % 3993;
+	return 184 + gf_rand() % 3912;
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, j, nb_runs = 200, total_size = 0, nb_errors = 0;
+	u32 *sizes, *offsets, check = 0;
+	u64 start, ref_time, crc_time;
+	char *buffer;
+
+	if (argc > 1) nb_runs = atoi(argv[1]);
+	if (!nb_runs) {
+		fprintf(stderr, "usage: crcbench [nb_runs]\n");
+		return 1;
+	}
+	gf_sys_init(GF_FALSE);
+	gf_rand_init(GF_TRUE);
+	ref_init();
+
+	sizes = (u32 *)gf_malloc(sizeof(u32) * NB_SECTIONS);
+	offsets = (u32 *)gf_malloc(sizeof(u32) * NB_SECTIONS);
+	for (i=0; i<NB_SECTIONS; i++) {
+		sizes[i] = get_section_size();
+		/*sections are not aligned in TS packets*/
+		offsets[i] = total_size + (gf_rand() % 4);
+		total_size = offsets[i] + sizes[i];
+	}
+	buffer = (char *)gf_malloc(total_size);
+	for (i=0; i<total_size; i++) buffer[i] = (char) gf_rand();
+
+	/*bit-exactness on all sizes and alignments, and on sections carrying their own CRC*/
+	for (i=0; i<5000; i++) {
+		u32 len = i % 4100;
+		u32 off = i % 7;
+		if (gf_crc_32(buffer + off, len) != ref_crc_32(buffer + off, len)) nb_errors++;
+	}
+	for (i=0; i<NB_SECTIONS; i++) {
+		char *sec = buffer + offsets[i];
+		u32 crc = gf_crc_32(sec, sizes[i] - 4);
+		if (crc != ref_crc_32(sec, sizes[i] - 4)) nb_errors++;
+		sec[sizes[i]-4] = (crc >> 24) & 0xFF;
+		sec[sizes[i]-3] = (crc >> 16) & 0xFF;
+		sec[sizes[i]-2] = (crc >> 8) & 0xFF;
+		sec[sizes[i]-1] = crc & 0xFF;
+		if (gf_crc_32(sec, sizes[i])) nb_errors++;
+	}
+	if (nb_errors) {
+		fprintf(stderr, "%d CRC mismatches with reference implementation\n", nb_errors);
+		goto exit;
+	}
+
+	start = gf_sys_clock_high_res();
+	for (j=0; j<nb_runs; j++) {
+		for (i=0; i<NB_SECTIONS; i++) check ^= ref_crc_32(buffer + offsets[i], sizes[i]);
+	}
+	ref_time = gf_sys_clock_high_res() - start;
+
+	start = gf_sys_clock_high_res();
+	for (j=0; j<nb_runs; j++) {
+		for (i=0; i<NB_SECTIONS; i++) check ^= gf_crc_32(buffer + offsets[i], sizes[i]);
+	}
+	crc_time = gf_sys_clock_high_res() - start;
+
+	fprintf(stdout, "%d sections - %d bytes - average section size %d bytes - %d runs (check %08X)\n", NB_SECTIONS, total_size, total_size / NB_SECTIONS, nb_runs, check);
+	fprintf(stdout, "bytewise table: %.2f ms - %.1f MB/s - %.2f M sections/s\n", (Double) ref_time / 1000,
+	        (Double) total_size * nb_runs / ref_time, (Double) NB_SECTIONS * nb_runs / ref_time);
+	fprintf(stdout, "gf_crc_32:      %.2f ms - %.1f MB/s - %.2f M sections/s (x%.2f)\n", (Double) crc_time / 1000,
+	        (Double) total_size * nb_runs / crc_time, (Double) NB_SECTIONS * nb_runs / crc_time, (Double) ref_time / crc_time);
+
+exit:
+	gf_free(buffer);
+	gf_free(sizes);
+	gf_free(offsets);
+	gf_sys_close();
+	return nb_errors ? 1 : 0;
+}
@@ -0,0 +1,751 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / DASH rate adaptation benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*plays a DASH session through the DASH client for each adaptation algorithm, fetching segments from a loopback
+HTTP server shaping throughput and latency according to a bandwidth trace. Segments are not decoded, a simple
+player model consumes them in real time. Reports startup delay, rebuffering, number of switches and average bitrate.
+
+Trace files have one entry per line: "duration_ms rate_kbps [latency_ms]", lines starting with # are ignored. The trace
+loops when exhausted.
+
+Without -mpd, a synthetic static session with SegmentTemplate addressing is served, with representations at the
+rates given by -rates.*/
+
+#include <gpac/dash.h>
+#include <gpac/download.h>
+#include <gpac/list.h>
+#include <gpac/network.h>
+#include <gpac/thread.h>
+
+#define SERVER_PORT		8765
+#define MAX_TRACE		4096
+#define MAX_RATES		16
+/*max burst allowed by the shaper, in bytes*/
+#define SHAPER_BURST	16384
+#define SEND_CHUNK		4096
+
+typedef struct
+{
+	u32 dur_ms, kbps, latency_ms;
+} TraceEntry;
+
+typedef struct
+{
+	GF_Socket *listen;
+	GF_Thread *th;
+	GF_List *connections;
+	volatile Bool done;
+
+	/*served content: directory of the MPD or synthetic session*/
+	char *root_dir;
+	u32 rates[MAX_RATES];
+	u32 nb_rates, seg_dur_ms, nb_segs;
+
+	/*shaper*/
+	GF_Mutex *mx;
+	TraceEntry trace[MAX_TRACE];
+	u32 nb_trace, trace_dur;
+	u32 clock_start, last_refill;
+	s32 credit;
+	u64 bytes_sent;
+} HTTPServer;
+
+typedef struct
+{
+	HTTPServer *server;
+	GF_Socket *sock;
+	GF_Thread *th;
+	volatile Bool done;
+} Connection;
+
+static TraceEntry *shaper_get_entry(HTTPServer *srv, u32 now)
+{
+	u32 i, t = (now - srv->clock_start) % srv->trace_dur;
+	for (i=0; i<srv->nb_trace; i++) {
+		if (t < srv->trace[i].dur_ms) return &srv->trace[i];
+		t -= srv->trace[i].dur_ms;
+	}
+	return &srv->trace[srv->nb_trace-1];
+}
+
+/*returns the number of bytes the caller is allowed to send now, at most max_bytes. The link is shared by all connections*/
+static u32 shaper_take(HTTPServer *srv, u32 max_bytes)
+{
+	u32 now, res;
+	gf_mx_p(srv->mx);
+	now = gf_sys_clock();
+	if (now != srv->last_refill) {
+		TraceEntry *ent = shaper_get_entry(srv, now);
+		srv->credit += ent->kbps * (now - srv->last_refill) / 8;
+		if (srv->credit > SHAPER_BURST) srv->credit = SHAPER_BURST;
+		srv->last_refill = now;
+	}
+	res = 0;
+	if (srv->credit>0) {
+		res = MIN((u32) srv->credit, max_bytes);
+		srv->credit -= res;
+		srv->bytes_sent += res;
+	}
+	gf_mx_v(srv->mx);
+	return res;
+}
+
+static void shaper_reset(HTTPServer *srv)
+{
+	gf_mx_p(srv->mx);
+	srv->clock_start = srv->last_refill = gf_sys_clock();
+	srv->credit = 0;
+	srv->bytes_sent = 0;
+	gf_mx_v(srv->mx);
+}
+
+static u32 synthetic_segment_size(HTTPServer *srv, u32 rate_idx, u32 number)
+{
+	u64 size = (u64) srv->rates[rate_idx] * 1000 * srv->seg_dur_ms / 8000;
+	/*+/- 20% variation around the nominal rate, repeatable across runs*/
+	s32 var = (s32) ((number * 2654435761U) >> 16) % 41 - 20;
+	return (u32) (size * (100 + var) / 100);
+}
+
+static char *synthetic_mpd(HTTPServer *srv)
+{
+	u32 i, size;
+	char *mpd = gf_malloc(2048 + 256*srv->nb_rates);
+	size = sprintf(mpd, "<?xml version=\"1.0\"?>\n<MPD xmlns=\"urn:mpeg:dash:schema:mpd:2011\" type=\"static\" mediaPresentationDuration=\"PT%dS\" minBufferTime=\"PT%dS\" profiles=\"urn:mpeg:dash:profile:isoff-live:2011\">\n"
+	               "<Period id=\"1\">\n<AdaptationSet segmentAlignment=\"true\" startWithSAP=\"1\" mimeType=\"video/mp4\">\n"
+	               "<SegmentTemplate timescale=\"1000\" duration=\"%d\" startNumber=\"1\" initialization=\"r$Bandwidth$/init.mp4\" media=\"r$Bandwidth$/$Number$.m4s\"/>\n",
+	               srv->seg_dur_ms * srv->nb_segs / 1000, (srv->seg_dur_ms+999) / 1000, srv->seg_dur_ms);
+	for (i=0; i<srv->nb_rates; i++) {
+		size += sprintf(mpd+size, "<Representation id=\"%d\" bandwidth=\"%d\" width=\"%d\" height=\"%d\" codecs=\"avc1.42c01e\"/>\n", i+1, srv->rates[i]*1000, 320*(i+1), 180*(i+1));
+	}
+	sprintf(mpd+size, "</AdaptationSet>\n</Period>\n</MPD>\n");
+	return mpd;
+}
+
+/*gets the body of the resource, either synthetic or loaded from disk. Synthetic segments are not allocated, only their size is returned*/
+static GF_Err server_get_resource(HTTPServer *srv, char *path, char **data, u32 *size, const char **mime)
+{
+	u32 i, bw, number;
+	*data = NULL;
+	*size = 0;
+	*mime = strstr(path, ".mpd") ? "application/dash+xml" : "video/mp4";
+
+	if (srv->root_dir) {
+		char szPath[GF_MAX_PATH];
+		FILE *f;
+		if (strstr(path, "..")) return GF_URL_ERROR;
+		sprintf(szPath, "%s%s", srv->root_dir, path);
+		f = gf_fopen(szPath, "rb");
+		if (!f) return GF_URL_ERROR;
+		gf_fseek(f, 0, SEEK_END);
+		*size = (u32) gf_ftell(f);
+		gf_fseek(f, 0, SEEK_SET);
+		*data = gf_malloc(*size + 1);
+		if (*data && (fread(*data, 1, *size, f) != *size)) {
+			gf_free(*data);
+			*data = NULL;
+		}
+		gf_fclose(f);
+		return *data ? GF_OK : GF_IO_ERR;
+	}
+	if (!strcmp(path, "/manifest.mpd")) {
+		*data = synthetic_mpd(srv);
+		*size = (u32) strlen(*data);
+		return GF_OK;
+	}
+	if (sscanf(path, "/r%u/", &bw) != 1) return GF_URL_ERROR;
+	for (i=0; i<srv->nb_rates; i++) {
+		if (srv->rates[i]*1000 != bw) continue;
+		if (strstr(path, "init.mp4")) {
+			*size = 1000;
+			return GF_OK;
+		}
+		if ((sscanf(strrchr(path, '/'), "/%u.m4s", &number) != 1) || !number || (number > srv->nb_segs)) return GF_URL_ERROR;
+		*size = synthetic_segment_size(srv, i, number);
+		return GF_OK;
+	}
+	return GF_URL_ERROR;
+}
+
+static GF_Err server_send_body(Connection *conn, char *data, u32 size)
+{
+	char zeros[SEND_CHUNK];
+	u32 done = 0;
+	if (!data) memset(zeros, 0, SEND_CHUNK);
+	while (done < size) {
+		GF_Err e;
+		u32 nb_bytes = shaper_take(conn->server, MIN(size - done, SEND_CHUNK));
+		if (conn->server->done) return GF_IP_CONNECTION_CLOSED;
+		if (!nb_bytes) {
+			gf_sleep(1);
+			continue;
+		}
+		e = gf_sk_send(conn->sock, data ? data + done : zeros, nb_bytes);
+		if (e) return e;
+		done += nb_bytes;
+	}
+	return GF_OK;
+}
+
+static GF_Err server_process_request(Connection *conn, char *req)
+{
+	GF_Err e;
+	char szHdr[1024], *path, *sep, *range, *data;
+	const char *mime;
+	u32 size, first, last;
+	Bool is_head = !strncmp(req, "HEAD ", 5) ? GF_TRUE : GF_FALSE;
+	TraceEntry *ent;
+
+	if (strncmp(req, "GET ", 4) && !is_head) return GF_NOT_SUPPORTED;
+	path = strchr(req, ' ') + 1;
+	sep = strchr(path, ' ');
+	if (!sep) return GF_NON_COMPLIANT_BITSTREAM;
+	sep[0] = 0;
+	range = strstr(sep+1, "Range: bytes=");
+	sep = strchr(path, '?');
+	if (sep) sep[0] = 0;
+
+	/*request latency of the current trace entry*/
+	ent = shaper_get_entry(conn->server, gf_sys_clock());
+	if (ent->latency_ms) gf_sleep(ent->latency_ms);
+
+	e = server_get_resource(conn->server, path, &data, &size, &mime);
+	if (e) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[DASHABR] Resource %s not found\n", path));
+		sprintf(szHdr, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: keep-alive\r\n\r\n");
+		return gf_sk_send(conn->sock, szHdr, (u32) strlen(szHdr));
+	}
+	first = 0;
+	last = size ? size-1 : 0;
+	if (range && size) {
+		if (sscanf(range, "Range: bytes=%u-%u", &first, &last) < 1) first = 0;
+		if (last >= size) last = size-1;
+		if (first > last) first = last;
+		sprintf(szHdr, "HTTP/1.1 206 Partial Content\r\nContent-Type: %s\r\nContent-Range: bytes %u-%u/%u\r\nContent-Length: %u\r\nConnection: keep-alive\r\n\r\n", mime, first, last, size, last-first+1);
+	} else {
+		sprintf(szHdr, "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Length: %u\r\nConnection: keep-alive\r\n\r\n", mime, size);
+	}
+	e = gf_sk_send(conn->sock, szHdr, (u32) strlen(szHdr));
+	if (!e && !is_head && size) e = server_send_body(conn, data ? data + first : NULL, last-first+1);
+	if (data) gf_free(data);
+	return e;
+}
+
+static u32 connection_run(void *par)
+{
+	Connection *conn = (Connection *)par;
+	char req[4096];
+	u32 size = 0;
+
+	while (!conn->server->done) {
+		char *hdr_end;
+		u32 read;
+		GF_Err e = gf_sk_receive(conn->sock, req, sizeof(req)-1, size, &read);
+		if ((e==GF_IP_NETWORK_EMPTY) || (e==GF_IP_SOCK_WOULD_BLOCK)) continue;
+		if (e) break;
+		size += read;
+		req[size] = 0;
+		hdr_end = strstr(req, "\r\n\r\n");
+		if (!hdr_end) {
+			if (size+1 >= sizeof(req)) break;
+			continue;
+		}
+		hdr_end += 4;
+		read = (u32) (hdr_end - req);
+		if (server_process_request(conn, req)) break;
+		/*keep pipelined data*/
+		memmove(req, req+read, size-read);
+		size -= read;
+	}
+	conn->done = GF_TRUE;
+	return 0;
+}
+
+static u32 server_run(void *par)
+{
+	HTTPServer *srv = (HTTPServer *)par;
+	while (!srv->done) {
+		u32 i;
+		GF_Socket *sock;
+		GF_Err e = gf_sk_accept(srv->listen, &sock);
+
+		/*cleanup closed connections*/
+		for (i=0; i<gf_list_count(srv->connections); i++) {
+			Connection *conn = gf_list_get(srv->connections, i);
+			if (!conn->done) continue;
+			gf_th_del(conn->th);
+			gf_sk_del(conn->sock);
+			gf_free(conn);
+			gf_list_rem(srv->connections, i);
+			i--;
+		}
+		if (e || !sock) continue;
+
+		{
+			Connection *conn;
+			GF_SAFEALLOC(conn, Connection);
+			if (!conn) {
+				gf_sk_del(sock);
+				continue;
+			}
+			conn->server = srv;
+			conn->sock = sock;
+			gf_sk_set_usec_wait(sock, 10000);
+			conn->th = gf_th_new("DASHABRConnection");
+			gf_list_add(srv->connections, conn);
+			gf_th_run(conn->th, connection_run, conn);
+		}
+	}
+	return 0;
+}
+
+static GF_Err server_start(HTTPServer *srv)
+{
+	GF_Err e;
+	srv->listen = gf_sk_new(GF_SOCK_TYPE_TCP);
+	if (!srv->listen) return GF_IO_ERR;
+	e = gf_sk_bind(srv->listen, "127.0.0.1", SERVER_PORT, NULL, 0, GF_SOCK_REUSE_PORT);
+	if (!e) e = gf_sk_listen(srv->listen, 16);
+	if (e) return e;
+	gf_sk_set_usec_wait(srv->listen, 10000);
+	srv->mx = gf_mx_new("DASHABRShaper");
+	srv->connections = gf_list_new();
+	srv->th = gf_th_new("DASHABRServer");
+	return gf_th_run(srv->th, server_run, srv);
+}
+
+static void server_stop(HTTPServer *srv)
+{
+	srv->done = GF_TRUE;
+	gf_th_del(srv->th);
+	while (gf_list_count(srv->connections)) {
+		Connection *conn = gf_list_pop_back(srv->connections);
+		gf_th_del(conn->th);
+		gf_sk_del(conn->sock);
+		gf_free(conn);
+	}
+	gf_list_del(srv->connections);
+	gf_sk_del(srv->listen);
+	gf_mx_del(srv->mx);
+}
+
+static GF_Err load_trace(HTTPServer *srv, const char *file)
+{
+	char szLine[1024];
+	FILE *f = gf_fopen(file, "rt");
+	if (!f) return GF_URL_ERROR;
+	while (fgets(szLine, 1024, f) && (srv->nb_trace < MAX_TRACE)) {
+		TraceEntry *ent = &srv->trace[srv->nb_trace];
+		if (szLine[0]=='#') continue;
+		ent->latency_ms = 0;
+		if (sscanf(szLine, "%u %u %u", &ent->dur_ms, &ent->kbps, &ent->latency_ms) < 2) continue;
+		if (!ent->dur_ms) continue;
+		srv->trace_dur += ent->dur_ms;
+		srv->nb_trace++;
+	}
+	gf_fclose(f);
+	return srv->nb_trace ? GF_OK : GF_NON_COMPLIANT_BITSTREAM;
+}
+
+
+/*player model: consumes queued segments in real time, without decoding*/
+typedef struct
+{
+	GF_DASHFileIO dash_io;
+	GF_DashClient *dash;
+	GF_DownloadManager *dm;
+	s32 group_idx;
+	u32 buffer_ms;
+	/*first resource of the group, not played if this is an init segment*/
+	char *init_url;
+	/*remaining playback time of the segment being played, reported to the DASH client*/
+	volatile u32 play_remain_ms;
+} Player;
+
+typedef struct
+{
+	u32 startup_ms, nb_stalls, stall_ms, nb_switches, nb_segments, played_ms;
+	u64 rate_sum;
+} Stats;
+
+static GF_DASHFileIOSession abr_io_create(GF_DASHFileIO *dashio, Bool persistent, const char *url, s32 group_idx)
+{
+	GF_Err e;
+	Player *player = (Player *)dashio->udta;
+	u32 flags = GF_NETIO_SESSION_NOT_THREADED | GF_NETIO_SESSION_MEMORY_CACHE;
+	if (persistent) flags |= GF_NETIO_SESSION_PERSISTENT;
+	return (GF_DASHFileIOSession) gf_dm_sess_new(player->dm, url, flags, NULL, NULL, &e);
+}
+static void abr_io_del(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	gf_dm_sess_del((GF_DownloadSession *)session);
+}
+static void abr_io_delete_cache_file(GF_DASHFileIO *dashio, GF_DASHFileIOSession session, const char *cache_url)
+{
+	gf_dm_delete_cached_file_entry_session((GF_DownloadSession *)session, cache_url);
+}
+static void abr_io_abort(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	gf_dm_sess_abort((GF_DownloadSession *)session);
+}
+static GF_Err abr_io_setup_from_url(GF_DASHFileIO *dashio, GF_DASHFileIOSession session, const char *url, s32 group_idx)
+{
+	return gf_dm_sess_setup_from_url((GF_DownloadSession *)session, url);
+}
+static GF_Err abr_io_set_range(GF_DASHFileIO *dashio, GF_DASHFileIOSession session, u64 start_range, u64 end_range, Bool discontinue_cache)
+{
+	return gf_dm_sess_set_range((GF_DownloadSession *)session, start_range, end_range, discontinue_cache);
+}
+static GF_Err abr_io_init(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	return gf_dm_sess_process_headers((GF_DownloadSession *)session);
+}
+static GF_Err abr_io_run(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	return gf_dm_sess_process((GF_DownloadSession *)session);
+}
+static const char *abr_io_get_url(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	return gf_dm_sess_get_resource_name((GF_DownloadSession *)session);
+}
+static const char *abr_io_get_cache_name(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	return gf_dm_sess_get_cache_name((GF_DownloadSession *)session);
+}
+static const char *abr_io_get_mime(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	return gf_dm_sess_mime_type((GF_DownloadSession *)session);
+}
+static const char *abr_io_get_header_value(GF_DASHFileIO *dashio, GF_DASHFileIOSession session, const char *header_name)
+{
+	return gf_dm_sess_get_header((GF_DownloadSession *)session, header_name);
+}
+static u64 abr_io_get_utc_start_time(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	return gf_dm_sess_get_utc_start((GF_DownloadSession *)session);
+}
+static u32 abr_io_get_bytes_per_sec(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	u32 bps = 0;
+	if (session) gf_dm_sess_get_stats((GF_DownloadSession *)session, NULL, NULL, NULL, NULL, &bps, NULL);
+	return bps;
+}
+static u32 abr_io_get_total_size(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	u32 size = 0;
+	gf_dm_sess_get_stats((GF_DownloadSession *)session, NULL, NULL, &size, NULL, NULL, NULL);
+	return size;
+}
+static u32 abr_io_get_bytes_done(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	u32 size = 0;
+	gf_dm_sess_get_stats((GF_DownloadSession *)session, NULL, NULL, NULL, &size, NULL, NULL);
+	return size;
+}
+
+static GF_Err abr_io_on_dash_event(GF_DASHFileIO *dashio, GF_DASHEventType evt, s32 group_idx, GF_Err error_code)
+{
+	u32 i;
+	Player *player = (Player *)dashio->udta;
+
+	switch (evt) {
+	case GF_DASH_EVENT_CREATE_PLAYBACK:
+		/*play the first selectable group only*/
+		for (i=0; i<gf_dash_get_group_count(player->dash); i++) {
+			if ((player->group_idx<0) && gf_dash_is_group_selectable(player->dash, i)) {
+				const char *init_url = gf_dash_group_get_segment_init_url(player->dash, i, NULL, NULL);
+				player->group_idx = i;
+				if (init_url) player->init_url = gf_strdup(init_url);
+				gf_dash_group_select(player->dash, i, GF_TRUE);
+			} else {
+				gf_dash_group_select(player->dash, i, GF_FALSE);
+			}
+		}
+		break;
+	case GF_DASH_EVENT_CODEC_STAT_QUERY:
+		/*the DASH client adds the duration of queued segments*/
+		gf_dash_group_set_buffer_levels(player->dash, group_idx, 0, player->buffer_ms, player->play_remain_ms);
+		break;
+	case GF_DASH_EVENT_MANIFEST_INIT_ERROR:
+	case GF_DASH_EVENT_PERIOD_SETUP_ERROR:
+		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASHABR] Session setup error %s\n", gf_error_to_string(error_code)));
+		break;
+	default:
+		break;
+	}
+	return GF_OK;
+}
+
+static GF_Err run_session(const char *url, GF_DASHAdaptationAlgorithm algo, u32 buffer_ms, u32 max_dur_ms, Stats *stats)
+{
+	GF_Err e;
+	Player player;
+	u32 start, play_end, stall_start, prev_rep = (u32) -1;
+	Bool was_running = GF_FALSE;
+
+	memset(stats, 0, sizeof(Stats));
+	memset(&player, 0, sizeof(Player));
+	player.group_idx = -1;
+	player.buffer_ms = buffer_ms;
+	player.dash_io.udta = &player;
+	player.dash_io.delete_cache_file = abr_io_delete_cache_file;
+	player.dash_io.create = abr_io_create;
+	player.dash_io.del = abr_io_del;
+	player.dash_io.abort = abr_io_abort;
+	player.dash_io.setup_from_url = abr_io_setup_from_url;
+	player.dash_io.set_range = abr_io_set_range;
+	player.dash_io.init = abr_io_init;
+	player.dash_io.run = abr_io_run;
+	player.dash_io.get_url = abr_io_get_url;
+	player.dash_io.get_cache_name = abr_io_get_cache_name;
+	player.dash_io.get_mime = abr_io_get_mime;
+	player.dash_io.get_header_value = abr_io_get_header_value;
+	player.dash_io.get_utc_start_time = abr_io_get_utc_start_time;
+	player.dash_io.get_bytes_per_sec = abr_io_get_bytes_per_sec;
+	player.dash_io.get_total_size = abr_io_get_total_size;
+	player.dash_io.get_bytes_done = abr_io_get_bytes_done;
+	player.dash_io.on_dash_event = abr_io_on_dash_event;
+
+	player.dm = gf_dm_new(NULL);
+	player.dash = gf_dash_new(&player.dash_io, buffer_ms, 0, GF_FALSE, GF_FALSE, GF_DASH_SELECT_BANDWIDTH_LOWEST, GF_FALSE, 0);
+	if (!player.dm || !player.dash) return GF_OUT_OF_MEM;
+	gf_dash_set_algo(player.dash, algo);
+	gf_dash_disable_speed_adaptation(player.dash, GF_TRUE);
+
+	start = gf_sys_clock();
+	e = gf_dash_open(player.dash, url);
+	if (e) goto exit;
+
+	play_end = stall_start = 0;
+	while (1) {
+		u32 now = gf_sys_clock();
+		Bool group_done = GF_FALSE;
+		u32 nb_ready = 0;
+
+		if (max_dur_ms && (now - start > max_dur_ms)) break;
+		/*still playing the current segment*/
+		if (play_end > now) {
+			player.play_remain_ms = play_end - now;
+			gf_sleep(5);
+			continue;
+		}
+		player.play_remain_ms = 0;
+
+		if (player.group_idx>=0)
+			nb_ready = gf_dash_group_get_num_segments_ready(player.dash, player.group_idx, &group_done);
+
+		if (nb_ready) {
+			u32 dur, rep_idx, bandwidth;
+			const char *seg_url;
+			gf_dash_group_get_next_segment_info(player.dash, player.group_idx, &dur, &rep_idx);
+			gf_dash_group_get_next_segment_location(player.dash, player.group_idx, 0, &seg_url, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+			gf_dash_group_get_representation_info(player.dash, player.group_idx, rep_idx, NULL, NULL, NULL, &bandwidth, NULL);
+			/*init segment, nothing to play*/
+			if (player.init_url) {
+				Bool is_init = (seg_url && !strcmp(seg_url, player.init_url)) ? GF_TRUE : GF_FALSE;
+				gf_free(player.init_url);
+				player.init_url = NULL;
+				if (is_init) {
+					gf_dash_group_discard_segment(player.dash, player.group_idx);
+					continue;
+				}
+			}
+			gf_dash_group_discard_segment(player.dash, player.group_idx);
+
+			if (!stats->nb_segments) {
+				stats->startup_ms = now - start;
+			} else if (stall_start) {
+				stats->nb_stalls++;
+				stats->stall_ms += now - stall_start;
+				stall_start = 0;
+			}
+			if ((prev_rep != (u32) -1) && (prev_rep != rep_idx)) stats->nb_switches++;
+			prev_rep = rep_idx;
+			stats->nb_segments++;
+			stats->played_ms += dur;
+			stats->rate_sum += (u64) bandwidth * dur;
+
+			/*playback is continuous: the segment starts when the previous one ends, or now after a stall*/
+			play_end = (play_end ? play_end : now) + dur;
+			player.play_remain_ms = dur;
+			continue;
+		}
+		/*the DASH thread is started asynchronously*/
+		if (gf_dash_is_running(player.dash)) was_running = GF_TRUE;
+		else if (was_running) break;
+		if (group_done) break;
+		/*no segment to play: stall (the startup phase is not counted as a stall)*/
+		if (stats->nb_segments && !stall_start) stall_start = play_end;
+		play_end = 0;
+		gf_sleep(5);
+	}
+
+exit:
+	gf_dash_close(player.dash);
+	gf_dash_del(player.dash);
+	gf_dm_del(player.dm);
+	if (player.init_url) gf_free(player.init_url);
+	return e;
+}
+
+static struct {
+	const char *name;
+	GF_DASHAdaptationAlgorithm algo;
+} algos[] = {
+	{"bandwidth", GF_DASH_ALGO_GPAC_LEGACY_RATE},
+	{"buffer", GF_DASH_ALGO_GPAC_LEGACY_BUFFER},
+	{"BBA-0", GF_DASH_ALGO_BBA0},
+	{"BOLA_FINITE", GF_DASH_ALGO_BOLA_FINITE},
+	{"BOLA_BASIC", GF_DASH_ALGO_BOLA_BASIC},
+	{"BOLA_U", GF_DASH_ALGO_BOLA_U},
+	{"BOLA_O", GF_DASH_ALGO_BOLA_O},
+};
+
+static void usage()
+{
+	fprintf(stderr, "usage: dashabr [options]\n"
+	        "\t-trace FILE: bandwidth trace, lines of \"duration_ms rate_kbps [latency_ms]\". Default is a built-in step trace\n"
+	        "\t-mpd FILE: serves the directory of the given MPD. Default is a synthetic session\n"
+	        "\t-rates R1,R2,..: rates in kbps of the synthetic session representations. Default 300,700,1500,3000\n"
+	        "\t-segdur MS: segment duration of the synthetic session. Default 2000\n"
+	        "\t-dur S: duration of the synthetic session in seconds. Default 60\n"
+	        "\t-buffer MS: player buffer. Default 10000\n"
+	        "\t-algo A1,A2,..: algorithms to test (bandwidth, buffer, BBA-0, BOLA_FINITE, BOLA_BASIC, BOLA_U, BOLA_O). Default bandwidth,buffer,BBA-0,BOLA_BASIC\n"
+	        "\t-max S: max duration of each run in seconds. Default none\n"
+	       );
+}
+
+int main(int argc, char **argv)
+{
+	GF_Err e;
+	u32 i, buffer_ms = 10000, max_dur_ms = 0;
+	char url[GF_MAX_PATH], *algo_list = "bandwidth,buffer,BBA-0,BOLA_BASIC", *rates = "300,700,1500,3000", *mpd = NULL, *trace = NULL, *tok;
+	HTTPServer *srv;
+
+	GF_SAFEALLOC(srv, HTTPServer);
+	if (!srv) return 1;
+	srv->seg_dur_ms = 2000;
+	srv->nb_segs = 30;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (i+1 == (u32) argc) {
+			usage();
+			return 1;
+		}
+		if (!strcmp(arg, "-trace")) trace = argv[++i];
+		else if (!strcmp(arg, "-mpd")) mpd = argv[++i];
+		else if (!strcmp(arg, "-rates")) rates = argv[++i];
+		else if (!strcmp(arg, "-segdur")) srv->seg_dur_ms = atoi(argv[++i]);
+		else if (!strcmp(arg, "-dur")) srv->nb_segs = atoi(argv[++i]) * 1000 / srv->seg_dur_ms;
+		else if (!strcmp(arg, "-buffer")) buffer_ms = atoi(argv[++i]);
+		else if (!strcmp(arg, "-algo")) algo_list = argv[++i];
+		else if (!strcmp(arg, "-max")) max_dur_ms = 1000 * atoi(argv[++i]);
+		else {
+			usage();
+			return 1;
+		}
+	}
+
+	gf_sys_init(GF_FALSE);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+
+	if (trace) {
+		e = load_trace(srv, trace);
+		if (e) {
+			fprintf(stderr, "Failed to load trace %s: %s\n", trace, gf_error_to_string(e));
+			goto exit;
+		}
+	} else {
+		/*steps between 4 Mbps and 500 kbps*/
+		TraceEntry def_trace[] = { {10000, 4000, 20}, {10000, 1000, 40}, {10000, 2500, 20}, {10000, 500, 80}, {10000, 6000, 10} };
+		srv->nb_trace = sizeof(def_trace) / sizeof(TraceEntry);
+		for (i=0; i<srv->nb_trace; i++) {
+			srv->trace[i] = def_trace[i];
+			srv->trace_dur += def_trace[i].dur_ms;
+		}
+	}
+
+	if (mpd) {
+		char *sep;
+		srv->root_dir = gf_strdup(mpd);
+		sep = strrchr(srv->root_dir, '/');
+		if (sep) {
+			sep[0] = 0;
+			sprintf(url, "http://127.0.0.1:%d/%s", SERVER_PORT, sep+1);
+		} else {
+			gf_free(srv->root_dir);
+			srv->root_dir = gf_strdup(".");
+			sprintf(url, "http://127.0.0.1:%d/%s", SERVER_PORT, mpd);
+		}
+	} else {
+		tok = rates;
+		while (tok && (srv->nb_rates < MAX_RATES)) {
+			srv->rates[srv->nb_rates++] = atoi(tok);
+			tok = strchr(tok, ',');
+			if (tok) tok++;
+		}
+		sprintf(url, "http://127.0.0.1:%d/manifest.mpd", SERVER_PORT);
+	}
+
+	e = server_start(srv);
+	if (e) {
+		fprintf(stderr, "Failed to start HTTP server on port %d: %s\n", SERVER_PORT, gf_error_to_string(e));
+		goto exit;
+	}
+
+	fprintf(stdout, "%-12s %10s %8s %10s %9s %10s %10s\n", "algorithm", "startup ms", "stalls", "stall ms", "switches", "avg kbps", "played s");
+	algo_list = gf_strdup(algo_list);
+	tok = algo_list;
+	while (tok) {
+		Stats stats;
+		char *next = strchr(tok, ',');
+		if (next) next[0] = 0;
+		for (i=0; i<sizeof(algos)/sizeof(algos[0]); i++) {
+			if (!strcmp(algos[i].name, tok)) break;
+		}
+		if (i==sizeof(algos)/sizeof(algos[0])) {
+			fprintf(stderr, "Unknown algorithm %s\n", tok);
+		} else {
+			shaper_reset(srv);
+			e = run_session(url, algos[i].algo, buffer_ms, max_dur_ms, &stats);
+			if (e) {
+				fprintf(stderr, "Failed to play %s: %s\n", url, gf_error_to_string(e));
+			} else {
+				fprintf(stdout, "%-12s %10d %8d %10d %9d %10d %10.1f\n", tok, stats.startup_ms, stats.nb_stalls, stats.stall_ms, stats.nb_switches,
+				        stats.played_ms ? (u32) (stats.rate_sum / stats.played_ms / 1000) : 0, stats.played_ms / 1000.0);
+			}
+		}
+		tok = next ? next+1 : NULL;
+	}
+	gf_free(algo_list);
+	server_stop(srv);
+
+exit:
+	if (srv->root_dir) gf_free(srv->root_dir);
+	gf_free(srv);
+	gf_sys_close();
+	return 0;
+}
@@ -0,0 +1,214 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / live DASH context benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*simulates one dashing cycle of the live DASH context of MP4Box -dash-ctx with an increasing number of accumulated
+segments over several representations, and compares the cost of a cycle when segments are kept in the context (as
+done before the segment log) and when they are appended to the segment log next to the context:
+- context: the context is parsed, new segments are added to its SegmentsStartTimes section and it is saved
+- log: the context only holds the log offsets, it is parsed, new segments are appended to the log, read back from the
+offset of the previous cycle as done for the SegmentTimeline, and the context is saved*/
+
+#include <gpac/config_file.h>
+
+#define NB_REPS			4
+#define SEGS_PER_CYCLE	10
+#define NB_CYCLES		5
+
+static u32 nb_segments = 0;
+
+static void format_segment(u32 rep, char *szName, char *szVal)
+{
+	u32 seg = nb_segments / NB_REPS;
+	sprintf(szName, "live_rep%d_%d.m4s", rep, seg);
+	/*same format as gf_dasher_store_segment_info*/
+	sprintf(szVal, ""LLU"-"LLU"-"LLU"@rep%d", (u64) seg*2000, (u64) ((seg%100) ? 2000 : 1920), (u64) 1000, rep);
+	nb_segments++;
+}
+
+static void store_segment_ctx(GF_Config *ctx, u32 rep)
+{
+	char szName[100], szVal[200];
+	format_segment(rep, szName, szVal);
+	gf_cfg_set_key(ctx, "SegmentsStartTimes", szName, szVal);
+}
+
+static void store_segment_log(FILE *log, u32 rep)
+{
+	char szName[100], szVal[200];
+	format_segment(rep, szName, szVal);
+	fprintf(log, "%s\t%s\n", szVal, szName);
+}
+
+/*reads the segments of rep from offset as gf_dash_load_segment_timeline, returns the offset of the end of the log*/
+static u64 scan_log(FILE *log, u32 rep, u64 offset, u32 *nb_segs)
+{
+	char szLine[1024], szRep[100], szRepID[100];
+	u64 start, dur, scale;
+	sprintf(szRep, "rep%d", rep);
+	gf_fseek(log, offset, SEEK_SET);
+	while (fgets(szLine, sizeof(szLine), log)) {
+		offset += strlen(szLine);
+		if (sscanf(szLine, ""LLU"-"LLU"-"LLU"@%99s", &start, &dur, &scale, szRepID) != 4) break;
+		if (!strcmp(szRep, szRepID)) (*nb_segs)++;
+	}
+	return offset;
+}
+
+static u64 file_size(const char *file)
+{
+	u64 size;
+	FILE *f = gf_fopen(file, "rb");
+	if (!f) return 0;
+	gf_fseek(f, 0, SEEK_END);
+	size = gf_ftell(f);
+	gf_fclose(f);
+	return size;
+}
+
+static void run_cycles(const char *ctx_file, const char *log_file, Bool use_log)
+{
+	u32 i, j, k, nb_segs = 0;
+	u64 t0, t_parse=0, t_store=0, t_save=0;
+	GF_Config *ctx;
+
+	for (k=0; k<NB_CYCLES; k++) {
+		t0 = gf_sys_clock_high_res();
+		ctx = gf_cfg_new(NULL, ctx_file);
+		t_parse += gf_sys_clock_high_res() - t0;
+		if (!ctx) return;
+
+		t0 = gf_sys_clock_high_res();
+		if (use_log) {
+			FILE *log = gf_fopen(log_file, "a+b");
+			if (!log) return;
+			gf_fseek(log, 0, SEEK_END);
+			for (i=0; i<SEGS_PER_CYCLE; i++) {
+				for (j=0; j<NB_REPS; j++) store_segment_log(log, j);
+			}
+			for (j=0; j<NB_REPS; j++) {
+				char szKey[50], szVal[50];
+				u64 offset = 0;
+				const char *opt;
+				sprintf(szKey, "Representation_rep%d", j);
+				opt = gf_cfg_get_key(ctx, szKey, "TimelineOffset");
+				if (opt) sscanf(opt, LLU, &offset);
+				offset = scan_log(log, j, offset, &nb_segs);
+				sprintf(szVal, LLU, offset);
+				gf_cfg_set_key(ctx, szKey, "TimelineOffset", szVal);
+			}
+			gf_fclose(log);
+		} else {
+			for (i=0; i<SEGS_PER_CYCLE; i++) {
+				for (j=0; j<NB_REPS; j++) store_segment_ctx(ctx, j);
+			}
+		}
+		t_store += gf_sys_clock_high_res() - t0;
+
+		t0 = gf_sys_clock_high_res();
+		gf_cfg_del(ctx);
+		t_save += gf_sys_clock_high_res() - t0;
+	}
+
+	fprintf(stdout, "%8d segments %s: parse %8.3f ms - store %6.3f ms - save %8.3f ms - context %8u bytes\n",
+	        nb_segments, use_log ? "log    " : "context", t_parse/1000.0/NB_CYCLES, t_store/1000.0/NB_CYCLES, t_save/1000.0/NB_CYCLES,
+	        (u32) file_size(ctx_file));
+}
+
+static void fill(const char *ctx_file, const char *log_file, u32 nb_segs, Bool use_log)
+{
+	u32 j;
+	GF_Config *ctx;
+	if (use_log) {
+		FILE *log = gf_fopen(log_file, "ab");
+		if (!log) return;
+		while (nb_segments < nb_segs) {
+			for (j=0; j<NB_REPS; j++) store_segment_log(log, j);
+		}
+		gf_fclose(log);
+		/*timelines are up to date with the log at the end of each cycle*/
+		ctx = gf_cfg_new(NULL, ctx_file);
+		if (!ctx) return;
+		for (j=0; j<NB_REPS; j++) {
+			char szKey[50], szVal[50];
+			sprintf(szKey, "Representation_rep%d", j);
+			sprintf(szVal, LLU, file_size(log_file));
+			gf_cfg_set_key(ctx, szKey, "TimelineOffset", szVal);
+		}
+		gf_cfg_del(ctx);
+	} else {
+		if (gf_file_exists(ctx_file)) {
+			ctx = gf_cfg_new(NULL, ctx_file);
+		} else {
+			ctx = gf_cfg_new(NULL, NULL);
+			gf_cfg_set_filename(ctx, ctx_file);
+		}
+		if (!ctx) return;
+		while (nb_segments < nb_segs) {
+			for (j=0; j<NB_REPS; j++) store_segment_ctx(ctx, j);
+		}
+		gf_cfg_del(ctx);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, mode;
+	u32 steps[] = {1000, 10000, 50000, 100000};
+	char log_file[GF_MAX_PATH];
+	const char *ctx_file = "dashctx_bench.ctx";
+
+	if (argc>1) ctx_file = argv[1];
+	sprintf(log_file, "%s.segs", ctx_file);
+
+	gf_sys_init(GF_FALSE);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+
+	for (mode=0; mode<2; mode++) {
+		GF_Config *ctx;
+		nb_segments = 0;
+		gf_delete_file(ctx_file);
+		gf_delete_file(log_file);
+		/*context with the usual sections and keys*/
+		ctx = gf_cfg_new(NULL, NULL);
+		gf_cfg_set_filename(ctx, ctx_file);
+		gf_cfg_set_key(ctx, "DASH", "SessionType", "dynamic");
+		gf_cfg_set_key(ctx, "DASH", "SegmentLogStart", "0");
+		for (i=0; i<NB_REPS; i++) {
+			char szSec[50];
+			sprintf(szSec, "Representation_rep%d", i);
+			gf_cfg_set_key(ctx, szSec, "Setup", "yes");
+		}
+		gf_cfg_del(ctx);
+
+		for (i=0; i<4; i++) {
+			fill(ctx_file, log_file, steps[i], mode ? GF_TRUE : GF_FALSE);
+			run_cycles(ctx_file, log_file, mode ? GF_TRUE : GF_FALSE);
+		}
+	}
+	gf_delete_file(ctx_file);
+	gf_delete_file(log_file);
+	gf_sys_close();
+	return 0;
+}
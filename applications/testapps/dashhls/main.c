@@ -0,0 +1,161 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / DASH and HLS packaging benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*packages the given inputs with the DASH segmenter, without and with HLS playlist generation, and reports
+the average packaging time of each mode. Dual-format packaging in a single pass should cost about the same as
+DASH alone, while producing the output with separate passes costs one more segmentation of all inputs.*/
+
+#include <gpac/media_tools.h>
+
+#define MAX_INPUTS	16
+
+static void usage()
+{
+	fprintf(stderr, "usage: dashhls [options] input1 [input2 ...]\n"
+	        "options:\n"
+	        " -out DIR      output directory (default: current directory)\n"
+	        " -dur SEC      segment duration in seconds (default: 2)\n"
+	        " -n COUNT      number of runs per mode (default: 5)\n"
+	        " -profile P    DASH profile: live, main or onDemand (default: live)\n"
+	        " -ts           inputs are MPEG-2 TS files\n");
+}
+
+static void on_progress(const void *cbck, const char *title, u64 done, u64 total)
+{
+}
+
+static GF_Err run_dasher(const char *out_dir, u32 nb_inputs, char **inputs, GF_DashProfile profile, Double seg_dur, Bool hls, u64 *time_us)
+{
+	u32 i;
+	u64 start;
+	GF_Err e;
+	char szMPD[GF_MAX_PATH];
+	GF_DASHSegmenter *dasher;
+
+	sprintf(szMPD, "%s/bench.mpd", out_dir);
+	dasher = gf_dasher_new(szMPD, profile, NULL, 1000, NULL);
+	if (!dasher) return GF_OUT_OF_MEM;
+
+	start = gf_sys_clock_high_res();
+	e = gf_dasher_set_durations(dasher, seg_dur, seg_dur);
+	if (!e) e = gf_dasher_enable_rap_splitting(dasher, GF_TRUE, GF_TRUE);
+	if (!e) e = gf_dasher_enable_url_template(dasher, (profile == GF_DASH_PROFILE_ONDEMAND) ? GF_FALSE : GF_TRUE, "$RepresentationID$_$Number$", NULL, NULL);
+	if (!e) e = gf_dasher_set_test_mode(dasher, GF_TRUE);
+	if (!e && hls) e = gf_dasher_set_hls_output(dasher, "bench.m3u8");
+
+	for (i=0; i<nb_inputs && !e; i++) {
+		char szID[20];
+		GF_DashSegmenterInput di;
+		memset(&di, 0, sizeof(GF_DashSegmenterInput));
+		di.file_name = inputs[i];
+		sprintf(szID, "%d", i+1);
+		di.representationID = szID;
+		e = gf_dasher_add_input(dasher, &di);
+	}
+	if (!e) e = gf_dasher_process(dasher, 0);
+	*time_us = gf_sys_clock_high_res() - start;
+
+	gf_dasher_del(dasher);
+	return e;
+}
+
+int main(int argc, char **argv)
+{
+	GF_Err e;
+	u32 i, nb_runs = 5, nb_inputs = 0;
+	u64 total_dash = 0, total_hls = 0;
+	Double seg_dur = 2.0;
+	const char *out_dir = ".";
+	char *inputs[MAX_INPUTS];
+	GF_DashProfile profile = GF_DASH_PROFILE_LIVE;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-ts")) {
+			profile = GF_DASH_PROFILE_MAIN;
+			continue;
+		}
+		if (arg[0] != '-') {
+			if (nb_inputs == MAX_INPUTS) {
+				fprintf(stderr, "Too many inputs, max %d\n", MAX_INPUTS);
+				return 1;
+			}
+			inputs[nb_inputs++] = arg;
+			continue;
+		}
+		if (i+1 == (u32) argc) {
+			usage();
+			return 1;
+		}
+		if (!strcmp(arg, "-out")) out_dir = argv[++i];
+		else if (!strcmp(arg, "-dur")) seg_dur = atof(argv[++i]);
+		else if (!strcmp(arg, "-n")) nb_runs = atoi(argv[++i]);
+		else if (!strcmp(arg, "-profile")) {
+			arg = argv[++i];
+			if (!strcmp(arg, "live")) profile = GF_DASH_PROFILE_LIVE;
+			else if (!strcmp(arg, "main")) profile = GF_DASH_PROFILE_MAIN;
+			else if (!strcmp(arg, "onDemand")) profile = GF_DASH_PROFILE_ONDEMAND;
+			else {
+				usage();
+				return 1;
+			}
+		}
+		else {
+			usage();
+			return 1;
+		}
+	}
+	if (!nb_inputs || !nb_runs || (seg_dur<=0)) {
+		usage();
+		return 1;
+	}
+
+	gf_sys_init(GF_FALSE);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_QUIET);
+	gf_set_progress_callback(NULL, on_progress);
+
+	fprintf(stdout, "%-6s %12s %12s\n", "run", "DASH ms", "DASH+HLS ms");
+	for (i=0; i<nb_runs; i++) {
+		u64 dash_us, hls_us;
+		/*alternate the modes so that file system caching benefits both*/
+		e = run_dasher(out_dir, nb_inputs, inputs, profile, seg_dur, GF_FALSE, &dash_us);
+		if (!e) e = run_dasher(out_dir, nb_inputs, inputs, profile, seg_dur, GF_TRUE, &hls_us);
+		if (e) {
+			fprintf(stderr, "Packaging failed: %s\n", gf_error_to_string(e));
+			goto exit;
+		}
+		fprintf(stdout, "%-6d %12.2f %12.2f\n", i+1, (Double) dash_us / 1000, (Double) hls_us / 1000);
+		total_dash += dash_us;
+		total_hls += hls_us;
+	}
+	fprintf(stdout, "\naverage: DASH %.2f ms - DASH+HLS single pass %.2f ms (%+.1f%%) - DASH and separate HLS pass %.2f ms\n",
+	        (Double) total_dash / nb_runs / 1000, (Double) total_hls / nb_runs / 1000,
+	        total_dash ? 100.0 * ((Double) total_hls - (Double) total_dash) / (Double) total_dash : 0,
+	        2.0 * total_dash / nb_runs / 1000);
+
+exit:
+	gf_sys_close();
+	return 0;
+}
@@ -0,0 +1,149 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / MPEG-2 TS DASH segmentation benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*segments MPEG-2 TS inputs with the DASH segmenter and reports the average packaging time. Each input can be
+repeated in several periods (as done when looping a capture) to measure the cost of indexing the same file
+several times.*/
+
+#include <gpac/media_tools.h>
+
+#define MAX_INPUTS	16
+
+static void usage()
+{
+	fprintf(stderr, "usage: dashts [options] input1.ts [input2.ts ...]\n"
+	        "options:\n"
+	        " -out DIR      output directory (default: current directory)\n"
+	        " -dur SEC      segment duration in seconds (default: 2)\n"
+	        " -n COUNT      number of runs (default: 5)\n"
+	        " -periods N    number of periods each input is used in (default: 1)\n"
+	        " -single-file  use byte ranges in the input instead of segment files\n");
+}
+
+static void on_progress(const void *cbck, const char *title, u64 done, u64 total)
+{
+}
+
+static GF_Err run_dasher(const char *out_dir, u32 nb_inputs, char **inputs, u32 nb_periods, Double seg_dur, Bool single_file, u64 *time_us)
+{
+	u32 i, j;
+	u64 start;
+	GF_Err e;
+	char szMPD[GF_MAX_PATH];
+	GF_DASHSegmenter *dasher;
+
+	sprintf(szMPD, "%s/bench.mpd", out_dir);
+	dasher = gf_dasher_new(szMPD, GF_DASH_PROFILE_MAIN, NULL, 1000, NULL);
+	if (!dasher) return GF_OUT_OF_MEM;
+
+	start = gf_sys_clock_high_res();
+	e = gf_dasher_set_durations(dasher, seg_dur, seg_dur);
+	if (!e) e = gf_dasher_enable_rap_splitting(dasher, GF_TRUE, GF_TRUE);
+	if (!e) e = gf_dasher_enable_single_file(dasher, single_file);
+	if (!e) e = gf_dasher_set_test_mode(dasher, GF_TRUE);
+
+	for (j=0; j<nb_periods && !e; j++) {
+		for (i=0; i<nb_inputs && !e; i++) {
+			char szID[20], szPID[20];
+			GF_DashSegmenterInput di;
+			memset(&di, 0, sizeof(GF_DashSegmenterInput));
+			di.file_name = inputs[i];
+			sprintf(szID, "%d", i+1);
+			sprintf(szPID, "P%d", j+1);
+			di.representationID = szID;
+			di.periodID = szPID;
+			e = gf_dasher_add_input(dasher, &di);
+		}
+	}
+	if (!e) e = gf_dasher_process(dasher, 0);
+	*time_us = gf_sys_clock_high_res() - start;
+
+	gf_dasher_del(dasher);
+	return e;
+}
+
+int main(int argc, char **argv)
+{
+	GF_Err e;
+	u32 i, nb_runs = 5, nb_inputs = 0, nb_periods = 1;
+	u64 total = 0, min_time = 0;
+	Double seg_dur = 2.0;
+	Bool single_file = GF_FALSE;
+	const char *out_dir = ".";
+	char *inputs[MAX_INPUTS];
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-single-file")) {
+			single_file = GF_TRUE;
+			continue;
+		}
+		if (arg[0] != '-') {
+			if (nb_inputs == MAX_INPUTS) {
+				fprintf(stderr, "Too many inputs, max %d\n", MAX_INPUTS);
+				return 1;
+			}
+			inputs[nb_inputs++] = arg;
+			continue;
+		}
+		if (i+1 == (u32) argc) {
+			usage();
+			return 1;
+		}
+		if (!strcmp(arg, "-out")) out_dir = argv[++i];
+		else if (!strcmp(arg, "-dur")) seg_dur = atof(argv[++i]);
+		else if (!strcmp(arg, "-n")) nb_runs = atoi(argv[++i]);
+		else if (!strcmp(arg, "-periods")) nb_periods = atoi(argv[++i]);
+		else {
+			usage();
+			return 1;
+		}
+	}
+	if (!nb_inputs || !nb_runs || !nb_periods || (seg_dur<=0)) {
+		usage();
+		return 1;
+	}
+
+	gf_sys_init(GF_FALSE);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_QUIET);
+	gf_set_progress_callback(NULL, on_progress);
+
+	for (i=0; i<nb_runs; i++) {
+		u64 time_us;
+		e = run_dasher(out_dir, nb_inputs, inputs, nb_periods, seg_dur, single_file, &time_us);
+		if (e) {
+			fprintf(stderr, "Packaging failed: %s\n", gf_error_to_string(e));
+			goto exit;
+		}
+		fprintf(stdout, "run %d: %.2f ms\n", i+1, (Double) time_us / 1000);
+		total += time_us;
+		if (!min_time || (min_time > time_us)) min_time = time_us;
+	}
+	fprintf(stdout, "\naverage %.2f ms - best %.2f ms\n", (Double) total / nb_runs / 1000, (Double) min_time / 1000);
+
+exit:
+	gf_sys_close();
+	return 0;
+}
@@ -0,0 +1,483 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / dashcast scaling ladder benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*measures the CPU cost of scaling a rendition ladder in dashcast, without FFmpeg:
+- a decoder thread produces synthetic YUV 4:2:0 frames in the input circular buffer
+- the renditions are scaled as the dashcast scaling graph does:
+	- "independent": one scaler per rendition, all scaling from the decoded frames
+	- "shared": renditions of identical resolution share one scaler and its circular buffer (dc_video_scaler_list_init)
+	- "graph": shared scalers, each scaling from the nearest larger resolution (dc_video_scaler_list_build_graph)
+- one encoder thread per rendition checksums its frames and checks that it gets all frames in order
+All threads use the circular buffer calls in the same order as dashcast does, in on-demand mode. The full ladder
+is then scaled as a graph in live media mode, where the decoder drops frames whose node is still used by the scalers
+and encoders check that they get all the frames which were not dropped, in order.
+The scaler has the cost structure of swscale: every source line is scaled horizontally, then filtered vertically,
+so that the cost of a scaler depends on the size of its source. Independent and shared scaling give the same frames.*/
+
+#include <gpac/thread.h>
+#include "circular_buffer.h"
+
+#ifndef WIN32
+#include <sys/resource.h>
+#endif
+
+#define INPUT_WIDTH		1920
+#define INPUT_HEIGHT	1080
+/*allows reading one sample past the end of lines without checks*/
+#define LINE_PADDING	32
+
+typedef struct
+{
+	u32 width, height;
+} Resolution;
+
+/*a usual ladder, with some resolutions encoded at several bitrates*/
+static Resolution ladder[] = {
+	{1920, 1080}, {1280, 720}, {1280, 720}, {960, 540}, {640, 360}, {640, 360}, {480, 270}, {320, 180}
+};
+#define MAX_LADDER	(sizeof(ladder)/sizeof(Resolution))
+
+typedef enum
+{
+	SCALE_INDEPENDENT = 0,
+	SCALE_SHARED,
+	SCALE_GRAPH
+} ScaleMode;
+
+static const char *mode_names[] = {"independent", "shared", "graph"};
+
+typedef struct
+{
+	u8 *planes[3];
+	u32 width[3], height[3], stride[3];
+	u64 frame_num;
+} Picture;
+
+typedef struct _scaled ScaledData;
+typedef struct _ladder_ctx LadderCtx;
+
+/*same role as VideoScaledData*/
+struct _scaled
+{
+	LadderCtx *ctx;
+	u32 width, height;
+	ScaledData *parent;
+	u32 num_consumers;
+	CircularBuffer circular_buf;
+	Producer producer;
+	Consumer consumer;
+	GF_Thread *thread;
+	/*horizontal scaling and vertical accumulation buffers*/
+	u32 *acc;
+	u16 *hline;
+};
+
+typedef struct
+{
+	LadderCtx *ctx;
+	ScaledData *scaled;
+	Consumer consumer;
+	GF_Thread *thread;
+	u64 nb_frames, next_frame_num;
+	u32 nb_errors;
+	u32 checksum;
+} Rendition;
+
+struct _ladder_ctx
+{
+	u32 cb_size;
+	LockMode lock_mode;
+	u64 nb_frames, nb_dropped;
+	CircularBuffer input_buf;
+	Producer decoder_producer;
+	u8 *pattern;
+	ScaledData *scaled[MAX_LADDER];
+	u32 nb_scaled, nb_root_scalers;
+	Rendition renditions[MAX_LADDER];
+	u32 nb_renditions;
+};
+
+static Picture *picture_new(u32 width, u32 height)
+{
+	u32 i;
+	Picture *pic;
+	GF_SAFEALLOC(pic, Picture);
+	for (i=0; i<3; i++) {
+		pic->width[i] = i ? (width+1)/2 : width;
+		pic->height[i] = i ? (height+1)/2 : height;
+		pic->stride[i] = pic->width[i] + LINE_PADDING;
+		pic->planes[i] = (u8 *)gf_malloc(pic->stride[i] * pic->height[i]);
+		memset(pic->planes[i], 0, pic->stride[i] * pic->height[i]);
+	}
+	return pic;
+}
+
+static void picture_del(Picture *pic)
+{
+	u32 i;
+	for (i=0; i<3; i++) gf_free(pic->planes[i]);
+	gf_free(pic);
+}
+
+static void alloc_nodes(CircularBuffer *cb, u32 width, u32 height)
+{
+	u32 i;
+	for (i=0; i<cb->size; i++) cb->list[i].data = picture_new(width, height);
+}
+
+static void free_nodes(CircularBuffer *cb)
+{
+	u32 i;
+	for (i=0; i<cb->size; i++) picture_del((Picture *) cb->list[i].data);
+}
+
+/*2-tap horizontal scaling of every source line, box filtering of the scaled lines vertically*/
+static void scale_plane(ScaledData *sd, const u8 *src, u32 src_stride, u32 src_w, u32 src_h, u8 *dst, u32 dst_stride, u32 dst_w, u32 dst_h)
+{
+	u32 x, y, sy;
+	u32 xinc = (src_w << 16) / dst_w;
+	for (y=0; y<dst_h; y++) {
+		u32 start = (u32) (((u64) y * src_h) / dst_h);
+		u32 end = (u32) (((u64) (y+1) * src_h) / dst_h);
+		u32 norm;
+		if (end <= start) end = start + 1;
+		norm = 65536 / (end - start);
+		memset(sd->acc, 0, sizeof(u32) * dst_w);
+		for (sy=start; sy<end; sy++) {
+			const u8 *line = src + sy * src_stride;
+			u32 pos = 0;
+			for (x=0; x<dst_w; x++) {
+				u32 i = pos >> 16, frac = (pos >> 8) & 0xFF;
+				sd->hline[x] = (u16) (line[i] * (256 - frac) + line[i+1] * frac);
+				pos += xinc;
+			}
+			for (x=0; x<dst_w; x++) sd->acc[x] += sd->hline[x];
+		}
+		for (x=0; x<dst_w; x++) dst[x] = (u8) (((u64) sd->acc[x] * norm) >> 24);
+		dst += dst_stride;
+	}
+}
+
+/*same calls as dc_video_decoder_read, the frame content moves at each frame*/
+static u32 decoder_thread(void *par)
+{
+	u64 i;
+	u32 p, y;
+	LadderCtx *ctx = (LadderCtx *)par;
+
+	for (i=0; i<ctx->nb_frames; i++) {
+		Picture *pic;
+		/*live: the node is still used by the scalers, drop the frame without advancing*/
+		if (dc_producer_lock(&ctx->decoder_producer, &ctx->input_buf) < 0) {
+			ctx->nb_dropped++;
+			/*a live source does not deliver the next frame right away*/
+			gf_sleep(1);
+			continue;
+		}
+		dc_producer_unlock_previous(&ctx->decoder_producer, &ctx->input_buf);
+		pic = (Picture *) dc_producer_produce(&ctx->decoder_producer, &ctx->input_buf);
+		for (p=0; p<3; p++) {
+			for (y=0; y<pic->height[p]; y++)
+				memcpy(pic->planes[p] + y*pic->stride[p], ctx->pattern + ((y*7 + i*3 + p*50) & 0xFF), pic->width[p]);
+		}
+		pic->frame_num = i;
+		dc_producer_advance(&ctx->decoder_producer, &ctx->input_buf);
+	}
+	/*end of input, waits for the node in live mode*/
+	while (dc_producer_lock(&ctx->decoder_producer, &ctx->input_buf) < 0)
+		gf_sleep(1);
+	dc_producer_unlock_previous(&ctx->decoder_producer, &ctx->input_buf);
+	dc_producer_end_signal(&ctx->decoder_producer, &ctx->input_buf);
+	dc_producer_unlock(&ctx->decoder_producer, &ctx->input_buf);
+	return 0;
+}
+
+/*same calls as dc_video_scaler_scale and dc_video_scaler_end_signal*/
+static u32 scaler_thread(void *par)
+{
+	u32 p;
+	ScaledData *sd = (ScaledData *)par;
+	CircularBuffer *src_buf = sd->parent ? &sd->parent->circular_buf : &sd->ctx->input_buf;
+	Picture *in, *out;
+
+	while (1) {
+		if (src_buf->size > 1)
+			dc_consumer_unlock_previous(&sd->consumer, src_buf);
+		if (dc_producer_lock(&sd->producer, &sd->circular_buf) < 0)
+			continue;
+		dc_producer_unlock_previous(&sd->producer, &sd->circular_buf);
+
+		if (dc_consumer_lock(&sd->consumer, src_buf) < 0)
+			break;
+		in = (Picture *) dc_consumer_consume(&sd->consumer, src_buf);
+		out = (Picture *) dc_producer_produce(&sd->producer, &sd->circular_buf);
+		for (p=0; p<3; p++)
+			scale_plane(sd, in->planes[p], in->stride[p], in->width[p], in->height[p], out->planes[p], out->stride[p], out->width[p], out->height[p]);
+		out->frame_num = in->frame_num;
+		dc_consumer_advance(&sd->consumer);
+		dc_producer_advance(&sd->producer, &sd->circular_buf);
+
+		if (src_buf->size == 1)
+			dc_consumer_unlock_previous(&sd->consumer, src_buf);
+	}
+	dc_producer_end_signal(&sd->producer, &sd->circular_buf);
+	dc_producer_unlock_previous(&sd->producer, &sd->circular_buf);
+	return 0;
+}
+
+/*same calls as dc_video_encoder_encode*/
+static u32 encoder_thread(void *par)
+{
+	u32 p, y, x;
+	Rendition *rend = (Rendition *)par;
+	CircularBuffer *cb = &rend->scaled->circular_buf;
+	Picture *pic;
+
+	while (1) {
+		if (dc_consumer_lock(&rend->consumer, cb) < 0)
+			break;
+		if (cb->size > 1)
+			dc_consumer_unlock_previous(&rend->consumer, cb);
+
+		pic = (Picture *) dc_consumer_consume(&rend->consumer, cb);
+		/*frames dropped in live mode are missing*/
+		if ((pic->frame_num < rend->next_frame_num) || ((rend->ctx->lock_mode == ON_DEMAND) && (pic->frame_num != rend->next_frame_num)))
+			rend->nb_errors++;
+		rend->next_frame_num = pic->frame_num + 1;
+		for (p=0; p<3; p++) {
+			for (y=0; y<pic->height[p]; y++) {
+				const u8 *line = pic->planes[p] + y*pic->stride[p];
+				for (x=0; x<pic->width[p]; x++) rend->checksum = rend->checksum*31 + line[x];
+			}
+		}
+		rend->nb_frames++;
+
+		dc_consumer_advance(&rend->consumer);
+		if (cb->size == 1)
+			dc_consumer_unlock_previous(&rend->consumer, cb);
+	}
+	return 0;
+}
+
+/*same as dc_video_scaler_list_init and dc_video_scaler_list_build_graph*/
+static void build_scalers(LadderCtx *ctx, u32 nb_renditions, ScaleMode mode)
+{
+	u32 i, j;
+	for (i=0; i<nb_renditions; i++) {
+		ScaledData *sd = NULL;
+		if (mode != SCALE_INDEPENDENT) {
+			for (j=0; j<ctx->nb_scaled; j++) {
+				if ((ctx->scaled[j]->width == ladder[i].width) && (ctx->scaled[j]->height == ladder[i].height)) {
+					sd = ctx->scaled[j];
+					sd->num_consumers++;
+					break;
+				}
+			}
+		}
+		if (!sd) {
+			GF_SAFEALLOC(sd, ScaledData);
+			sd->ctx = ctx;
+			sd->width = ladder[i].width;
+			sd->height = ladder[i].height;
+			sd->num_consumers = 1;
+			ctx->scaled[ctx->nb_scaled++] = sd;
+		}
+		ctx->renditions[i].scaled = sd;
+	}
+
+	ctx->nb_root_scalers = 0;
+	for (i=0; i<ctx->nb_scaled; i++) {
+		ScaledData *sd = ctx->scaled[i];
+		ScaledData *parent = NULL;
+		if (mode == SCALE_GRAPH) {
+			for (j=0; j<ctx->nb_scaled; j++) {
+				ScaledData *source = ctx->scaled[j];
+				if ((source == sd) || (source->width < sd->width) || (source->height < sd->height))
+					continue;
+				if ((source->width > INPUT_WIDTH) || (source->height > INPUT_HEIGHT))
+					continue;
+				if (!parent || ((u64) source->width * source->height < (u64) parent->width * parent->height))
+					parent = source;
+			}
+		}
+		sd->parent = parent;
+		if (parent) parent->num_consumers++;
+		else ctx->nb_root_scalers++;
+	}
+}
+
+static void get_cpu_usage(u64 *cpu_us)
+{
+#ifndef WIN32
+	struct rusage ru;
+	getrusage(RUSAGE_SELF, &ru);
+	*cpu_us = (u64) (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000 + ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+#else
+	*cpu_us = 0;
+#endif
+}
+
+/*runs the ladder, returns the CPU time per frame in us, the checksums of the renditions and the number of dropped frames*/
+static Bool run_ladder(u32 nb_renditions, ScaleMode mode, LockMode lock_mode, u32 cb_size, u64 nb_frames, u8 *pattern, Double *cpu_per_frame, u32 *checksums, u64 *nb_dropped)
+{
+	u32 i;
+	u64 cpu_start, cpu_end;
+	Bool ok = GF_TRUE;
+	GF_Thread *decoder_th;
+	LadderCtx ctx;
+
+	memset(&ctx, 0, sizeof(LadderCtx));
+	ctx.cb_size = cb_size;
+	ctx.lock_mode = lock_mode;
+	ctx.nb_frames = nb_frames;
+	ctx.pattern = pattern;
+	ctx.nb_renditions = nb_renditions;
+	build_scalers(&ctx, nb_renditions, mode);
+
+	dc_producer_init(&ctx.decoder_producer, cb_size, "video decoder");
+	dc_circular_buffer_create(&ctx.input_buf, cb_size, lock_mode, ctx.nb_root_scalers);
+	alloc_nodes(&ctx.input_buf, INPUT_WIDTH, INPUT_HEIGHT);
+	for (i=0; i<ctx.nb_scaled; i++) {
+		ScaledData *sd = ctx.scaled[i];
+		dc_producer_init(&sd->producer, cb_size, "video scaler");
+		dc_consumer_init(&sd->consumer, cb_size, "video scaler");
+		dc_circular_buffer_create(&sd->circular_buf, cb_size, lock_mode, sd->num_consumers);
+		alloc_nodes(&sd->circular_buf, sd->width, sd->height);
+		sd->acc = (u32 *)gf_malloc(sizeof(u32) * sd->width);
+		sd->hline = (u16 *)gf_malloc(sizeof(u16) * sd->width);
+		sd->thread = gf_th_new("video_scaler_thread");
+	}
+	for (i=0; i<nb_renditions; i++) {
+		Rendition *rend = &ctx.renditions[i];
+		rend->ctx = &ctx;
+		dc_consumer_init(&rend->consumer, cb_size, "video encoder");
+		rend->thread = gf_th_new("video_encoder_thread");
+	}
+	decoder_th = gf_th_new("video_decoder_thread");
+
+	get_cpu_usage(&cpu_start);
+	for (i=0; i<nb_renditions; i++)
+		gf_th_run(ctx.renditions[i].thread, encoder_thread, &ctx.renditions[i]);
+	for (i=0; i<ctx.nb_scaled; i++)
+		gf_th_run(ctx.scaled[i]->thread, scaler_thread, ctx.scaled[i]);
+	gf_th_run(decoder_th, decoder_thread, &ctx);
+
+	gf_th_stop(decoder_th);
+	for (i=0; i<ctx.nb_scaled; i++)
+		gf_th_stop(ctx.scaled[i]->thread);
+	for (i=0; i<nb_renditions; i++)
+		gf_th_stop(ctx.renditions[i].thread);
+	get_cpu_usage(&cpu_end);
+	*cpu_per_frame = (Double) (cpu_end - cpu_start) / nb_frames;
+	*nb_dropped = ctx.nb_dropped;
+
+	for (i=0; i<nb_renditions; i++) {
+		Rendition *rend = &ctx.renditions[i];
+		/*frames which were not dropped are seen by all renditions*/
+		if (rend->nb_errors || (rend->nb_frames != nb_frames - ctx.nb_dropped)) {
+			fprintf(stderr, "%s ladder of %d: rendition %d got "LLU" frames out of "LLU", %d out of order\n", mode_names[mode], nb_renditions, i, rend->nb_frames, nb_frames - ctx.nb_dropped, rend->nb_errors);
+			ok = GF_FALSE;
+		}
+		checksums[i] = rend->checksum;
+		gf_th_del(rend->thread);
+	}
+	for (i=0; i<ctx.nb_scaled; i++) {
+		ScaledData *sd = ctx.scaled[i];
+		gf_th_del(sd->thread);
+		free_nodes(&sd->circular_buf);
+		dc_circular_buffer_destroy(&sd->circular_buf);
+		gf_free(sd->acc);
+		gf_free(sd->hline);
+		gf_free(sd);
+	}
+	gf_th_del(decoder_th);
+	free_nodes(&ctx.input_buf);
+	dc_circular_buffer_destroy(&ctx.input_buf);
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, n, cb_size = 1;
+	u64 nb_frames = 200;
+	u8 *pattern;
+	Bool ok = GF_TRUE;
+
+	if (argc > 1) nb_frames = atoi(argv[1]);
+	if (argc > 2) cb_size = atoi(argv[2]);
+	if (!nb_frames || !cb_size) {
+		fprintf(stderr, "usage: dcladder [nb_frames [cb_size]]\n");
+		return 1;
+	}
+
+	gf_sys_init(GF_FALSE);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_QUIET);
+
+	/*input lines are read from a random pattern at a position depending on the line and frame*/
+	pattern = (u8 *)gf_malloc(INPUT_WIDTH + 256);
+	for (i=0; i<INPUT_WIDTH + 256; i++) pattern[i] = (u8) (gf_rand() >> 8);
+
+	fprintf(stdout, "Input %dx%d, "LLU" frames, CPU ms per frame\n", INPUT_WIDTH, INPUT_HEIGHT, nb_frames);
+	fprintf(stdout, "%-6s %-42s %12s %12s %12s %10s\n", "ladder", "resolutions", mode_names[SCALE_INDEPENDENT], mode_names[SCALE_SHARED], mode_names[SCALE_GRAPH], "gain");
+	for (n=1; n<=MAX_LADDER; n++) {
+		Double cpu[3];
+		u32 checksums[3][MAX_LADDER];
+		u64 nb_dropped;
+		char res_list[100];
+		u32 m;
+		Bool same = GF_TRUE;
+
+		res_list[0] = 0;
+		for (i=0; i<n; i++) {
+			char res[20];
+			sprintf(res, "%s%d", i ? " " : "", ladder[i].height);
+			strcat(res_list, res);
+		}
+		for (m=SCALE_INDEPENDENT; m<=SCALE_GRAPH; m++) {
+			if (!run_ladder(n, (ScaleMode) m, ON_DEMAND, cb_size, nb_frames, pattern, &cpu[m], checksums[m], &nb_dropped)) ok = GF_FALSE;
+		}
+		/*sharing a scaler shall not change the frames*/
+		for (i=0; i<n; i++) {
+			if (checksums[SCALE_SHARED][i] != checksums[SCALE_INDEPENDENT][i]) same = GF_FALSE;
+		}
+		if (!same) ok = GF_FALSE;
+		fprintf(stdout, "%-6d %-42s %12.2f %12.2f %12.2f %9.2fx%s\n", n, res_list, cpu[0]/1000, cpu[1]/1000, cpu[2]/1000,
+		        cpu[2] ? cpu[0] / cpu[2] : 0, same ? "" : " - shared frames differ");
+	}
+	/*live media, the decoder does not wait for the scalers*/
+	{
+		Double cpu;
+		u32 checksums[MAX_LADDER];
+		u64 nb_dropped = 0;
+		Bool live_ok = run_ladder(MAX_LADDER, SCALE_GRAPH, LIVE_MEDIA, cb_size, nb_frames, pattern, &cpu, checksums, &nb_dropped);
+		if (!live_ok) ok = GF_FALSE;
+		fprintf(stdout, "live media %s ladder of %d: %.2f CPU ms per frame, "LLU" frames dropped%s\n", mode_names[SCALE_GRAPH], (u32) MAX_LADDER, cpu/1000,
+		        nb_dropped, live_ok ? "" : " - FAILED");
+	}
+	gf_free(pattern);
+
+	gf_sys_close();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,387 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / dashcast pipeline benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*measures the frame handoff cost of the dashcast pipeline, without FFmpeg:
+- a decoder thread produces synthetic frames in the input circular buffer
+- one scaler thread per rendition consumes the input buffer and produces in its own scaled buffer
+- one encoder thread per rendition consumes its scaled buffer and posts a message per segment in a message queue,
+read by a controller thread as the MPD thread of dashcast does
+All threads use the circular buffer calls in the same order as dashcast does. Each configuration runs in on-demand
+mode, where no frame is dropped and encoders check that they get all frames in order, then in live media mode, where
+the decoder drops frames whose node is still used by the scalers and encoders check that they get all the frames
+which were not dropped, in order. The stages do no work unless a work amount is given, so
+the time measured is the handoff cost.*/
+
+#include <gpac/thread.h>
+#include "circular_buffer.h"
+#include "message_queue.h"
+
+#ifndef WIN32
+#include <sys/resource.h>
+#endif
+
+#define SEG_FRAMES	25
+
+typedef struct
+{
+	u64 frame_num;
+	u32 check;
+} SyntheticFrame;
+
+typedef struct
+{
+	u64 segnum;
+	u32 rendition;
+} SegmentMessage;
+
+typedef struct _pipe PipeCtx;
+
+typedef struct
+{
+	PipeCtx *pipe;
+	u32 idx;
+	GF_Thread *scaler_th, *encoder_th;
+	CircularBuffer scaled_buf;
+	Producer scaler_producer;
+	Consumer scaler_consumer;
+	Consumer encoder_consumer;
+	u64 nb_frames, next_frame_num;
+	u32 nb_errors;
+	/*keeps the emulated encoding from being optimized out*/
+	volatile u32 sink;
+} Rendition;
+
+struct _pipe
+{
+	u32 nb_renditions, cb_size, work;
+	LockMode mode;
+	u64 nb_frames, nb_dropped;
+	CircularBuffer input_buf;
+	Producer decoder_producer;
+	Rendition *renditions;
+	MessageQueue mq;
+	u64 nb_messages;
+	u32 nb_msg_errors;
+};
+
+/*emulates some processing in a stage*/
+static u32 do_work(u32 work, u32 seed)
+{
+	u32 i;
+	for (i=0; i<work; i++) seed = seed*1103515245 + 12345;
+	return seed;
+}
+
+static void alloc_nodes(CircularBuffer *cb)
+{
+	u32 i;
+	for (i=0; i<cb->size; i++) {
+		SyntheticFrame *frame;
+		GF_SAFEALLOC(frame, SyntheticFrame);
+		cb->list[i].data = frame;
+	}
+}
+
+static void free_nodes(CircularBuffer *cb)
+{
+	u32 i;
+	for (i=0; i<cb->size; i++) gf_free(cb->list[i].data);
+}
+
+/*same calls as dc_video_decoder_read*/
+static u32 decoder_thread(void *par)
+{
+	u64 i;
+	SyntheticFrame *frame;
+	PipeCtx *pipe = (PipeCtx *)par;
+
+	for (i=0; i<pipe->nb_frames; i++) {
+		/*live: the node is still used by the scalers, drop the frame without advancing*/
+		if (dc_producer_lock(&pipe->decoder_producer, &pipe->input_buf) < 0) {
+			pipe->nb_dropped++;
+			/*a live source does not deliver the next frame right away*/
+			gf_sleep(1);
+			continue;
+		}
+		dc_producer_unlock_previous(&pipe->decoder_producer, &pipe->input_buf);
+		frame = (SyntheticFrame *) dc_producer_produce(&pipe->decoder_producer, &pipe->input_buf);
+		frame->frame_num = i;
+		frame->check = do_work(pipe->work, (u32) i);
+		dc_producer_advance(&pipe->decoder_producer, &pipe->input_buf);
+	}
+	/*end of input, waits for the node in live mode*/
+	while (dc_producer_lock(&pipe->decoder_producer, &pipe->input_buf) < 0)
+		gf_sleep(1);
+	dc_producer_unlock_previous(&pipe->decoder_producer, &pipe->input_buf);
+	dc_producer_end_signal(&pipe->decoder_producer, &pipe->input_buf);
+	dc_producer_unlock(&pipe->decoder_producer, &pipe->input_buf);
+	return 0;
+}
+
+/*same calls as dc_video_scaler_scale and dc_video_scaler_end_signal*/
+static u32 scaler_thread(void *par)
+{
+	Rendition *rend = (Rendition *)par;
+	PipeCtx *pipe = rend->pipe;
+	SyntheticFrame *in, *out;
+
+	while (1) {
+		if (pipe->input_buf.size > 1)
+			dc_consumer_unlock_previous(&rend->scaler_consumer, &pipe->input_buf);
+
+		if (dc_producer_lock(&rend->scaler_producer, &rend->scaled_buf) < 0)
+			continue;
+		dc_producer_unlock_previous(&rend->scaler_producer, &rend->scaled_buf);
+
+		if (dc_consumer_lock(&rend->scaler_consumer, &pipe->input_buf) < 0)
+			break;
+
+		in = (SyntheticFrame *) dc_consumer_consume(&rend->scaler_consumer, &pipe->input_buf);
+		out = (SyntheticFrame *) dc_producer_produce(&rend->scaler_producer, &rend->scaled_buf);
+		out->frame_num = in->frame_num;
+		out->check = do_work(pipe->work, in->check);
+
+		dc_consumer_advance(&rend->scaler_consumer);
+		dc_producer_advance(&rend->scaler_producer, &rend->scaled_buf);
+
+		if (pipe->input_buf.size == 1)
+			dc_consumer_unlock_previous(&rend->scaler_consumer, &pipe->input_buf);
+	}
+	dc_producer_end_signal(&rend->scaler_producer, &rend->scaled_buf);
+	dc_producer_unlock_previous(&rend->scaler_producer, &rend->scaled_buf);
+	return 0;
+}
+
+/*same calls as dc_video_encoder_encode, segment notifications as in video_encoder_thread*/
+static u32 encoder_thread(void *par)
+{
+	Rendition *rend = (Rendition *)par;
+	PipeCtx *pipe = rend->pipe;
+	SyntheticFrame *frame;
+
+	while (1) {
+		if (dc_consumer_lock(&rend->encoder_consumer, &rend->scaled_buf) < 0)
+			break;
+		if (rend->scaled_buf.size > 1)
+			dc_consumer_unlock_previous(&rend->encoder_consumer, &rend->scaled_buf);
+
+		frame = (SyntheticFrame *) dc_consumer_consume(&rend->encoder_consumer, &rend->scaled_buf);
+		/*frames dropped in live mode are missing*/
+		if ((frame->frame_num < rend->next_frame_num) || ((pipe->mode == ON_DEMAND) && (frame->frame_num != rend->next_frame_num)))
+			rend->nb_errors++;
+		rend->next_frame_num = frame->frame_num + 1;
+		rend->sink += do_work(pipe->work, frame->check);
+		rend->nb_frames++;
+
+		dc_consumer_advance(&rend->encoder_consumer);
+		if (rend->scaled_buf.size == 1)
+			dc_consumer_unlock_previous(&rend->encoder_consumer, &rend->scaled_buf);
+
+		if (!(rend->nb_frames % SEG_FRAMES)) {
+			SegmentMessage msg;
+			msg.segnum = rend->nb_frames / SEG_FRAMES;
+			msg.rendition = rend->idx;
+			dc_message_queue_put(&pipe->mq, &msg, sizeof(msg));
+		}
+	}
+	/*end of the rendition*/
+	{
+		SegmentMessage msg;
+		msg.segnum = 0;
+		msg.rendition = rend->idx;
+		dc_message_queue_put(&pipe->mq, &msg, sizeof(msg));
+	}
+	return 0;
+}
+
+/*reads segment notifications as the MPD thread of dashcast does*/
+static u32 controller_thread(void *par)
+{
+	PipeCtx *pipe = (PipeCtx *)par;
+	u64 *last_seg = (u64 *)gf_malloc(sizeof(u64) * pipe->nb_renditions);
+	u32 nb_done = 0;
+	u32 last_msg_time = gf_sys_clock();
+	memset(last_seg, 0, sizeof(u64) * pipe->nb_renditions);
+
+	/*the number of segments is not known in live mode, each encoder posts a last message with segment number 0*/
+	while (nb_done < pipe->nb_renditions) {
+		SegmentMessage msg;
+		if (dc_message_queue_get(&pipe->mq, &msg) != sizeof(msg)) {
+			/*retry as the MPD thread does, unless the pipeline is stuck*/
+			if (gf_sys_clock() - last_msg_time < 20000) continue;
+			pipe->nb_msg_errors++;
+			break;
+		}
+		last_msg_time = gf_sys_clock();
+		if (!msg.segnum) {
+			nb_done++;
+			continue;
+		}
+		if ((msg.rendition >= pipe->nb_renditions) || (msg.segnum != last_seg[msg.rendition] + 1)) pipe->nb_msg_errors++;
+		else last_seg[msg.rendition] = msg.segnum;
+		pipe->nb_messages++;
+	}
+	gf_free(last_seg);
+	return 0;
+}
+
+static void get_usage(u64 *cpu_us, u64 *nb_switches)
+{
+#ifndef WIN32
+	struct rusage ru;
+	getrusage(RUSAGE_SELF, &ru);
+	*cpu_us = (u64) (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000 + ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+	*nb_switches = ru.ru_nvcsw + ru.ru_nivcsw;
+#else
+	*cpu_us = *nb_switches = 0;
+#endif
+}
+
+static Bool run_pipe(LockMode mode, u32 nb_renditions, u32 cb_size, u64 nb_frames, u32 work)
+{
+	u32 i;
+	u64 nb_seg_expected = 0;
+	u64 start, end, cpu_start, cpu_end, sw_start, sw_end;
+	Bool ok = GF_TRUE;
+	GF_Thread *decoder_th, *controller_th;
+	PipeCtx pipe;
+
+	memset(&pipe, 0, sizeof(PipeCtx));
+	pipe.nb_renditions = nb_renditions;
+	pipe.cb_size = cb_size;
+	pipe.nb_frames = nb_frames;
+	pipe.work = work;
+	pipe.mode = mode;
+
+	dc_producer_init(&pipe.decoder_producer, cb_size, "video decoder");
+	dc_circular_buffer_create(&pipe.input_buf, cb_size, mode, nb_renditions);
+	alloc_nodes(&pipe.input_buf);
+	dc_message_queue_init(&pipe.mq);
+
+	pipe.renditions = (Rendition *)gf_malloc(sizeof(Rendition) * nb_renditions);
+	memset(pipe.renditions, 0, sizeof(Rendition) * nb_renditions);
+	for (i=0; i<nb_renditions; i++) {
+		Rendition *rend = &pipe.renditions[i];
+		rend->pipe = &pipe;
+		rend->idx = i;
+		dc_producer_init(&rend->scaler_producer, cb_size, "video scaler");
+		dc_consumer_init(&rend->scaler_consumer, cb_size, "video scaler");
+		dc_consumer_init(&rend->encoder_consumer, cb_size, "video encoder");
+		dc_circular_buffer_create(&rend->scaled_buf, cb_size, mode, 1);
+		alloc_nodes(&rend->scaled_buf);
+		rend->scaler_th = gf_th_new("video_scaler_thread");
+		rend->encoder_th = gf_th_new("video_encoder_thread");
+	}
+	decoder_th = gf_th_new("video_decoder_thread");
+	controller_th = gf_th_new("mpd_thread");
+
+	get_usage(&cpu_start, &sw_start);
+	start = gf_sys_clock_high_res();
+	gf_th_run(controller_th, controller_thread, &pipe);
+	for (i=0; i<nb_renditions; i++) {
+		gf_th_run(pipe.renditions[i].encoder_th, encoder_thread, &pipe.renditions[i]);
+		gf_th_run(pipe.renditions[i].scaler_th, scaler_thread, &pipe.renditions[i]);
+	}
+	gf_th_run(decoder_th, decoder_thread, &pipe);
+
+	gf_th_stop(decoder_th);
+	for (i=0; i<nb_renditions; i++) {
+		gf_th_stop(pipe.renditions[i].scaler_th);
+		gf_th_stop(pipe.renditions[i].encoder_th);
+	}
+	gf_th_stop(controller_th);
+	end = gf_sys_clock_high_res();
+	get_usage(&cpu_end, &sw_end);
+
+	for (i=0; i<nb_renditions; i++) {
+		Rendition *rend = &pipe.renditions[i];
+		/*frames which were not dropped are seen by all renditions*/
+		if (rend->nb_errors || (rend->nb_frames != nb_frames - pipe.nb_dropped)) {
+			fprintf(stderr, "Rendition %d got "LLU" frames out of "LLU", %d out of order\n", i, rend->nb_frames, nb_frames - pipe.nb_dropped, rend->nb_errors);
+			ok = GF_FALSE;
+		}
+		nb_seg_expected += rend->nb_frames / SEG_FRAMES;
+		gf_th_del(rend->scaler_th);
+		gf_th_del(rend->encoder_th);
+		free_nodes(&rend->scaled_buf);
+		dc_circular_buffer_destroy(&rend->scaled_buf);
+	}
+	if (pipe.nb_msg_errors || (pipe.nb_messages != nb_seg_expected)) {
+		fprintf(stderr, "Segment messages: "LLU" received, %d errors\n", pipe.nb_messages, pipe.nb_msg_errors);
+		ok = GF_FALSE;
+	}
+	gf_th_del(decoder_th);
+	gf_th_del(controller_th);
+	gf_free(pipe.renditions);
+	free_nodes(&pipe.input_buf);
+	dc_circular_buffer_destroy(&pipe.input_buf);
+	dc_message_queue_free(&pipe.mq);
+
+	end -= start;
+	fprintf(stdout, "%-10s %-11d %8d %12.0f %14.2f %14.2f %16.2f %8.1f%s\n", (mode == ON_DEMAND) ? "on-demand" : "live", nb_renditions, cb_size,
+	        end ? (Double) nb_frames * 1000000 / end : 0, (Double) end / nb_frames,
+	        (Double) (cpu_end - cpu_start) / nb_frames, (Double) (sw_end - sw_start) / nb_frames,
+	        (Double) pipe.nb_dropped * 100 / nb_frames, ok ? "" : " - FAILED");
+	return ok;
+}
+
+static u32 nb_renditions_tests[] = {1, 2, 4, 6, 8};
+static u32 cb_size_tests[] = {1, 3, 8};
+
+int main(int argc, char **argv)
+{
+	u32 i, j, m, work = 0, nb_renditions = 0, cb_size = 0;
+	u64 nb_frames = 20000;
+	Bool ok = GF_TRUE;
+
+	if (argc > 1) nb_frames = atoi(argv[1]);
+	if (argc > 2) work = atoi(argv[2]);
+	if (argc > 4) {
+		nb_renditions = atoi(argv[3]);
+		cb_size = atoi(argv[4]);
+	}
+	if (!nb_frames || ((argc > 4) && (!nb_renditions || !cb_size))) {
+		fprintf(stderr, "usage: dcpipe [nb_frames [work_per_stage [nb_renditions cb_size]]]\n");
+		return 1;
+	}
+
+	gf_sys_init(GF_FALSE);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_QUIET);
+
+	fprintf(stdout, "%-10s %-11s %8s %12s %14s %14s %16s %8s\n", "mode", "renditions", "cb size", "frames/s", "wall us/frame", "CPU us/frame", "switches/frame", "dropped%");
+	for (m=0; m<2; m++) {
+		LockMode mode = m ? LIVE_MEDIA : ON_DEMAND;
+		if (nb_renditions) {
+			if (!run_pipe(mode, nb_renditions, cb_size, nb_frames, work)) ok = GF_FALSE;
+		} else for (j=0; j<sizeof(cb_size_tests)/sizeof(u32); j++) {
+			for (i=0; i<sizeof(nb_renditions_tests)/sizeof(u32); i++) {
+				if (!run_pipe(mode, nb_renditions_tests[i], cb_size_tests[j], nb_frames, work)) ok = GF_FALSE;
+			}
+		}
+	}
+
+	gf_sys_close();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,364 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / parallel byte-range download benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*downloads a synthetic resource from a loopback HTTP server limiting the rate of each connection, with a growing
+number of parallel connections ([Downloader]ParallelConnections). The received data is checked in order.
+Reports download time, throughput and the rate estimated by the downloader.*/
+
+#include <gpac/download.h>
+#include <gpac/config_file.h>
+#include <gpac/list.h>
+#include <gpac/network.h>
+#include <gpac/thread.h>
+
+#define SERVER_PORT		8766
+/*max burst allowed by the per-connection shaper, in bytes*/
+#define SHAPER_BURST	16384
+#define SEND_CHUNK		4096
+
+typedef struct
+{
+	GF_Socket *listen;
+	GF_Thread *th;
+	GF_List *connections;
+	volatile Bool done;
+
+	u32 size, conn_kbps, latency_ms;
+	Bool no_ranges;
+	u32 nb_requests;
+} HTTPServer;
+
+typedef struct
+{
+	HTTPServer *server;
+	GF_Socket *sock;
+	GF_Thread *th;
+	volatile Bool done;
+	u32 last_refill;
+	s32 credit;
+} Connection;
+
+/*content of the resource, repeatable and position dependent*/
+static GFINLINE u8 resource_byte(u32 offset)
+{
+	return (u8) ((offset * 2654435761U) >> 24);
+}
+
+static GF_Err server_send_body(Connection *conn, u32 offset, u32 size)
+{
+	u8 buf[SEND_CHUNK];
+	u32 done = 0;
+	conn->last_refill = gf_sys_clock();
+	conn->credit = 0;
+	while (done < size) {
+		GF_Err e;
+		u32 i, nb_bytes, now = gf_sys_clock();
+		if (conn->server->done) return GF_IP_CONNECTION_CLOSED;
+		if (now != conn->last_refill) {
+			conn->credit += conn->server->conn_kbps * (now - conn->last_refill) / 8;
+			if (conn->credit > SHAPER_BURST) conn->credit = SHAPER_BURST;
+			conn->last_refill = now;
+		}
+		if (conn->credit <= 0) {
+			gf_sleep(1);
+			continue;
+		}
+		nb_bytes = MIN(MIN(size - done, SEND_CHUNK), (u32) conn->credit);
+		for (i=0; i<nb_bytes; i++) buf[i] = resource_byte(offset + done + i);
+		e = gf_sk_send(conn->sock, (char *) buf, nb_bytes);
+		if (e) return e;
+		conn->credit -= nb_bytes;
+		done += nb_bytes;
+	}
+	return GF_OK;
+}
+
+static GF_Err server_process_request(Connection *conn, char *req)
+{
+	GF_Err e;
+	char szHdr[1024], *path, *sep, *range;
+	u32 first, last, size = conn->server->size;
+	Bool is_head = !strncmp(req, "HEAD ", 5) ? GF_TRUE : GF_FALSE;
+
+	if (strncmp(req, "GET ", 4) && !is_head) return GF_NOT_SUPPORTED;
+	path = strchr(req, ' ') + 1;
+	sep = strchr(path, ' ');
+	if (!sep) return GF_NON_COMPLIANT_BITSTREAM;
+	sep[0] = 0;
+	range = strstr(sep+1, "Range: bytes=");
+	conn->server->nb_requests++;
+
+	if (conn->server->latency_ms) gf_sleep(conn->server->latency_ms);
+
+	if (strcmp(path, "/file.bin")) {
+		sprintf(szHdr, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: keep-alive\r\n\r\n");
+		return gf_sk_send(conn->sock, szHdr, (u32) strlen(szHdr));
+	}
+	first = 0;
+	last = size-1;
+	if (range && !conn->server->no_ranges) {
+		if (sscanf(range, "Range: bytes=%u-%u", &first, &last) < 1) first = 0;
+		if (last >= size) last = size-1;
+		if (first > last) first = last;
+		sprintf(szHdr, "HTTP/1.1 206 Partial Content\r\nContent-Type: application/octet-stream\r\nAccept-Ranges: bytes\r\nContent-Range: bytes %u-%u/%u\r\nContent-Length: %u\r\nConnection: keep-alive\r\n\r\n", first, last, size, last-first+1);
+	} else {
+		sprintf(szHdr, "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nAccept-Ranges: %s\r\nContent-Length: %u\r\nConnection: keep-alive\r\n\r\n", conn->server->no_ranges ? "none" : "bytes", size);
+	}
+	e = gf_sk_send(conn->sock, szHdr, (u32) strlen(szHdr));
+	if (!e && !is_head) e = server_send_body(conn, first, last-first+1);
+	return e;
+}
+
+static u32 connection_run(void *par)
+{
+	Connection *conn = (Connection *)par;
+	char req[4096];
+	u32 size = 0;
+
+	while (!conn->server->done) {
+		char *hdr_end;
+		u32 read;
+		GF_Err e = gf_sk_receive(conn->sock, req, sizeof(req)-1, size, &read);
+		if ((e==GF_IP_NETWORK_EMPTY) || (e==GF_IP_SOCK_WOULD_BLOCK)) continue;
+		if (e) break;
+		size += read;
+		req[size] = 0;
+		hdr_end = strstr(req, "\r\n\r\n");
+		if (!hdr_end) {
+			if (size+1 >= sizeof(req)) break;
+			continue;
+		}
+		hdr_end += 4;
+		read = (u32) (hdr_end - req);
+		if (server_process_request(conn, req)) break;
+		/*keep pipelined data*/
+		memmove(req, req+read, size-read);
+		size -= read;
+	}
+	conn->done = GF_TRUE;
+	return 0;
+}
+
+static u32 server_run(void *par)
+{
+	HTTPServer *srv = (HTTPServer *)par;
+	while (!srv->done) {
+		u32 i;
+		GF_Socket *sock;
+		GF_Err e = gf_sk_accept(srv->listen, &sock);
+
+		/*cleanup closed connections*/
+		for (i=0; i<gf_list_count(srv->connections); i++) {
+			Connection *conn = gf_list_get(srv->connections, i);
+			if (!conn->done) continue;
+			gf_th_del(conn->th);
+			gf_sk_del(conn->sock);
+			gf_free(conn);
+			gf_list_rem(srv->connections, i);
+			i--;
+		}
+		if (e || !sock) continue;
+
+		{
+			Connection *conn;
+			GF_SAFEALLOC(conn, Connection);
+			if (!conn) {
+				gf_sk_del(sock);
+				continue;
+			}
+			conn->server = srv;
+			conn->sock = sock;
+			gf_sk_set_usec_wait(sock, 10000);
+			conn->th = gf_th_new("DLRangesConnection");
+			gf_list_add(srv->connections, conn);
+			gf_th_run(conn->th, connection_run, conn);
+		}
+	}
+	return 0;
+}
+
+static GF_Err server_start(HTTPServer *srv)
+{
+	GF_Err e;
+	srv->listen = gf_sk_new(GF_SOCK_TYPE_TCP);
+	if (!srv->listen) return GF_IO_ERR;
+	e = gf_sk_bind(srv->listen, "127.0.0.1", SERVER_PORT, NULL, 0, GF_SOCK_REUSE_PORT);
+	if (!e) e = gf_sk_listen(srv->listen, 16);
+	if (e) return e;
+	gf_sk_set_usec_wait(srv->listen, 10000);
+	srv->connections = gf_list_new();
+	srv->th = gf_th_new("DLRangesServer");
+	return gf_th_run(srv->th, server_run, srv);
+}
+
+static void server_stop(HTTPServer *srv)
+{
+	srv->done = GF_TRUE;
+	gf_th_del(srv->th);
+	while (gf_list_count(srv->connections)) {
+		Connection *conn = gf_list_pop_back(srv->connections);
+		gf_th_del(conn->th);
+		gf_sk_del(conn->sock);
+		gf_free(conn);
+	}
+	gf_list_del(srv->connections);
+	gf_sk_del(srv->listen);
+}
+
+
+typedef struct
+{
+	u32 received, nb_calls;
+	/*offset of the first corrupted byte + 1*/
+	u32 corrupted;
+} Receiver;
+
+static void receiver_io(void *cbk, GF_NETIO_Parameter *param)
+{
+	u32 i;
+	Receiver *rcv = (Receiver *)cbk;
+	if (param->msg_type != GF_NETIO_DATA_EXCHANGE) return;
+	rcv->nb_calls++;
+	for (i=0; i<param->size; i++) {
+		if (!rcv->corrupted && ((u8) param->data[i] != resource_byte(rcv->received + i)))
+			rcv->corrupted = rcv->received + i + 1;
+	}
+	rcv->received += param->size;
+}
+
+static GF_Err run_download(const char *url, u32 nb_connections, u32 range_kb, u32 *time_ms, u32 *est_kbps, Receiver *rcv)
+{
+	GF_Err e;
+	char szVal[20];
+	GF_DownloadSession *sess;
+	GF_DownloadManager *dm;
+	GF_Config *cfg = gf_cfg_new(NULL, NULL);
+	u32 bytes_per_sec, start;
+
+	sprintf(szVal, "%d", nb_connections);
+	gf_cfg_set_key(cfg, "Downloader", "ParallelConnections", szVal);
+	sprintf(szVal, "%d", range_kb);
+	gf_cfg_set_key(cfg, "Downloader", "ParallelRangeSize", szVal);
+	dm = gf_dm_new(cfg);
+
+	memset(rcv, 0, sizeof(Receiver));
+	start = gf_sys_clock();
+	sess = gf_dm_sess_new(dm, url, GF_NETIO_SESSION_NOT_THREADED | GF_NETIO_SESSION_NOT_CACHED, receiver_io, rcv, &e);
+	if (sess) {
+		e = gf_dm_sess_process(sess);
+		*time_ms = gf_sys_clock() - start;
+		gf_dm_sess_get_stats(sess, NULL, NULL, NULL, NULL, &bytes_per_sec, NULL);
+		*est_kbps = 8 * bytes_per_sec / 1000;
+		gf_dm_sess_del(sess);
+	}
+	gf_dm_del(dm);
+	gf_cfg_del(cfg);
+	return e;
+}
+
+static void usage()
+{
+	fprintf(stderr, "usage: dlranges [options]\n"
+	        "\t-size MB: size of the resource. Default 16\n"
+	        "\t-rate KBPS: max rate of each server connection. Default 20000\n"
+	        "\t-latency MS: server response latency for each request. Default 20\n"
+	        "\t-conn N1,N2,..: number of parallel connections to test. Default 1,2,4,8\n"
+	        "\t-range KB: size of the byte ranges. Default 1024\n"
+	        "\t-noranges: server does not support byte ranges\n"
+	       );
+}
+
+int main(int argc, char **argv)
+{
+	GF_Err e;
+	u32 i, range_kb = 1024;
+	char url[GF_MAX_PATH], *conn_list = "1,2,4,8", *tok;
+	HTTPServer *srv;
+
+	GF_SAFEALLOC(srv, HTTPServer);
+	if (!srv) return 1;
+	srv->size = 16*1024*1024;
+	srv->conn_kbps = 20000;
+	srv->latency_ms = 20;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-noranges")) {
+			srv->no_ranges = GF_TRUE;
+			continue;
+		}
+		if (i+1 == (u32) argc) {
+			usage();
+			return 1;
+		}
+		if (!strcmp(arg, "-size")) srv->size = atoi(argv[++i]) * 1024 * 1024;
+		else if (!strcmp(arg, "-rate")) srv->conn_kbps = atoi(argv[++i]);
+		else if (!strcmp(arg, "-latency")) srv->latency_ms = atoi(argv[++i]);
+		else if (!strcmp(arg, "-conn")) conn_list = argv[++i];
+		else if (!strcmp(arg, "-range")) range_kb = atoi(argv[++i]);
+		else {
+			usage();
+			return 1;
+		}
+	}
+	if (!srv->size || !srv->conn_kbps || !range_kb) {
+		usage();
+		return 1;
+	}
+
+	gf_sys_init(GF_FALSE);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+
+	e = server_start(srv);
+	if (e) {
+		fprintf(stderr, "Failed to start HTTP server on port %d: %s\n", SERVER_PORT, gf_error_to_string(e));
+		goto exit;
+	}
+	sprintf(url, "http://127.0.0.1:%d/file.bin", SERVER_PORT);
+
+	fprintf(stdout, "%-12s %10s %10s %10s %10s %10s %8s\n", "connections", "time ms", "kbps", "est. kbps", "requests", "callbacks", "check");
+	tok = conn_list;
+	while (tok) {
+		Receiver rcv;
+		u32 nb_conn = atoi(tok), time_ms = 0, est_kbps = 0;
+		srv->nb_requests = 0;
+		e = run_download(url, nb_conn, range_kb, &time_ms, &est_kbps, &rcv);
+		if (e) {
+			fprintf(stderr, "Failed to download %s with %d connections: %s\n", url, nb_conn, gf_error_to_string(e));
+		} else {
+			fprintf(stdout, "%-12d %10d %10d %10d %10d %10d %8s\n", nb_conn, time_ms, time_ms ? (u32) (8 * (u64) rcv.received / time_ms) : 0, est_kbps, srv->nb_requests, rcv.nb_calls,
+			        (rcv.received != srv->size) ? "SIZE" : (rcv.corrupted ? "DATA" : "OK"));
+			if (rcv.corrupted) fprintf(stderr, "Data mismatch at offset %d\n", rcv.corrupted-1);
+		}
+		tok = strchr(tok, ',');
+		if (tok) tok++;
+	}
+	server_stop(srv);
+
+exit:
+	gf_free(srv);
+	gf_sys_close();
+	return 0;
+}
@@ -0,0 +1,119 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / FIFO benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*compares queues made of a list (add at the end, remove item 0) and of a FIFO for several queue depths. For each depth,
+the queue is filled then drained, and a steady state is measured in which one item is added and one item removed with
+the queue kept at the given depth. The content of both queues is checked to be the same.*/
+
+#include <gpac/list.h>
+
+static u32 depths[] = {10, 100, 1000, 10000, 100000};
+
+static Bool bench_list(u32 depth, u32 nb_ops, u64 *fill_us, u64 *steady_us)
+{
+	u32 i;
+	u64 start;
+	Bool ok = GF_TRUE;
+	GF_List *l = gf_list_new();
+
+	start = gf_sys_clock_high_res();
+	for (i=0; i<depth; i++) gf_list_add(l, (void *) (ptrdiff_t) (i+1));
+	for (i=0; i<depth; i++) {
+		void *item = gf_list_get(l, 0);
+		gf_list_rem(l, 0);
+		if (item != (void *) (ptrdiff_t) (i+1)) ok = GF_FALSE;
+	}
+	*fill_us = gf_sys_clock_high_res() - start;
+
+	for (i=0; i<depth; i++) gf_list_add(l, (void *) (ptrdiff_t) (i+1));
+	start = gf_sys_clock_high_res();
+	for (i=0; i<nb_ops; i++) {
+		void *item = gf_list_get(l, 0);
+		gf_list_rem(l, 0);
+		if (item != (void *) (ptrdiff_t) (i+1)) ok = GF_FALSE;
+		gf_list_add(l, (void *) (ptrdiff_t) (depth+i+1));
+	}
+	*steady_us = gf_sys_clock_high_res() - start;
+	gf_list_del(l);
+	return ok;
+}
+
+static Bool bench_fifo(u32 depth, u32 nb_ops, u64 *fill_us, u64 *steady_us)
+{
+	u32 i;
+	u64 start;
+	Bool ok = GF_TRUE;
+	GF_Fifo *f = gf_fifo_new();
+
+	start = gf_sys_clock_high_res();
+	for (i=0; i<depth; i++) gf_fifo_add(f, (void *) (ptrdiff_t) (i+1));
+	for (i=0; i<depth; i++) {
+		if (gf_fifo_pop(f) != (void *) (ptrdiff_t) (i+1)) ok = GF_FALSE;
+	}
+	*fill_us = gf_sys_clock_high_res() - start;
+
+	for (i=0; i<depth; i++) gf_fifo_add(f, (void *) (ptrdiff_t) (i+1));
+	start = gf_sys_clock_high_res();
+	for (i=0; i<nb_ops; i++) {
+		if (gf_fifo_pop(f) != (void *) (ptrdiff_t) (i+1)) ok = GF_FALSE;
+		gf_fifo_add(f, (void *) (ptrdiff_t) (depth+i+1));
+	}
+	*steady_us = gf_sys_clock_high_res() - start;
+	/*iteration check*/
+	for (i=0; i<depth; i++) {
+		if (gf_fifo_get(f, i) != (void *) (ptrdiff_t) (nb_ops+i+1)) ok = GF_FALSE;
+	}
+	gf_fifo_del(f);
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, nb_ops = 100000;
+
+	if (argc > 1) nb_ops = atoi(argv[1]);
+	if (!nb_ops) {
+		fprintf(stderr, "usage: fifobench [nb_steady_ops]\n");
+		return 1;
+	}
+
+	gf_sys_init(GF_FALSE);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_QUIET);
+
+	fprintf(stdout, "fill/drain: ns per item, steady: ns per add+remove (%d operations)\n\n", nb_ops);
+	fprintf(stdout, "%-8s %12s %12s %12s %12s %9s\n", "depth", "list fill", "fifo fill", "list steady", "fifo steady", "speedup");
+	for (i=0; i<sizeof(depths)/sizeof(u32); i++) {
+		u64 fill[2], steady[2];
+		Bool ok = bench_list(depths[i], nb_ops, &fill[0], &steady[0]);
+		if (!bench_fifo(depths[i], nb_ops, &fill[1], &steady[1])) ok = GF_FALSE;
+		fprintf(stdout, "%-8d %12.1f %12.1f %12.1f %12.1f %8.1fx%s\n", depths[i],
+		        1000.0 * fill[0] / depths[i], 1000.0 * fill[1] / depths[i],
+		        1000.0 * steady[0] / nb_ops, 1000.0 * steady[1] / nb_ops,
+		        steady[1] ? (Double) steady[0] / steady[1] : 0, ok ? "" : " - CONTENT MISMATCH");
+	}
+
+	gf_sys_close();
+	return 0;
+}
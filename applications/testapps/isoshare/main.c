@@ -0,0 +1,344 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / ISO reader shared movie test application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*checks the movie cache of the ISO reader module:
+- two reader instances connected to the same local file share one parsed movie
+- each instance reads all samples of the file with its own sample cursor, reads of both instances being interleaved,
+and the channels keep their own position in the sample tables
+- the movie stays valid for the remaining instance when the first one is closed, and is released when the last one is closed
+- with ISOReader:ShareMovies=no, each instance parses its own movie
+- sharing is disabled when ISOReader:ShareMovies is not set
+the reader instances are driven directly through their input service interface, with a stub client service.
+returns 1 if any check fails*/
+
+#include <gpac/isomedia.h>
+#include <gpac/internal/terminal_dev.h>
+#include "../../../modules/isom_in/isom_in.h"
+
+#define TEST_FILE_NAME	"isoshare.mp4"
+#define NB_SAMPLES		200
+
+typedef struct
+{
+	/*first member, the reader only sees this*/
+	GF_ClientService serv;
+	GF_Err connect_error, channel_error;
+	u32 nb_connect_ack;
+} TestService;
+
+typedef struct
+{
+	GF_InputService *ifce;
+	TestService *service;
+	/*channel handle given to the reader*/
+	u32 channel;
+	u32 nb_read;
+} TestReader;
+
+static u32 nb_close_logs = 0;
+
+static u32 sample_size(u32 i)
+{
+	return 50 + (i*17) % 300;
+}
+
+static void on_connect_ack(GF_ClientService *service, LPNETCHANNEL ns, GF_Err response)
+{
+	TestService *ts = (TestService *)service;
+	if (ns) {
+		ts->channel_error = response;
+	} else {
+		ts->connect_error = response;
+		ts->nb_connect_ack++;
+	}
+}
+
+static void on_disconnect_ack(GF_ClientService *service, LPNETCHANNEL ns, GF_Err response)
+{
+}
+
+static void on_command(GF_ClientService *service, GF_NetworkCommand *com, GF_Err response)
+{
+}
+
+static void on_add_media(GF_ClientService *service, GF_Descriptor *media_desc, Bool no_scene_check)
+{
+	if (media_desc) gf_odf_desc_del(media_desc);
+}
+
+static void on_log(void *cbk, GF_LOG_Level level, GF_LOG_Tool tool, const char *fmt, va_list vlist)
+{
+	char szMsg[1024];
+	vsnprintf(szMsg, 1024, fmt, vlist);
+	if (strstr(szMsg, "Closing shared movie")) nb_close_logs++;
+	if (level <= GF_LOG_WARNING) fprintf(stderr, "%s", szMsg);
+}
+
+static Bool create_file(const char *name)
+{
+	u32 i, track, di;
+	GF_ESD *esd;
+	GF_ISOSample *samp;
+	GF_Err e = GF_OK;
+	GF_ISOFile *file = gf_isom_open(name, GF_ISOM_OPEN_WRITE, NULL);
+	if (!file) return GF_FALSE;
+
+	track = gf_isom_new_track(file, 0, GF_ISOM_MEDIA_VISUAL, 1000);
+	esd = gf_odf_desc_esd_new(2);
+	esd->decoderConfig->streamType = 4;
+	gf_isom_new_mpeg4_description(file, track, esd, NULL, NULL, &di);
+	gf_odf_desc_del((GF_Descriptor *) esd);
+
+	samp = gf_isom_sample_new();
+	for (i=0; i<NB_SAMPLES; i++) {
+		/*the sample index is the content of the sample*/
+		samp->dataLength = sample_size(i);
+		samp->data = gf_malloc(samp->dataLength);
+		memset(samp->data, i, samp->dataLength);
+		samp->DTS = i*40;
+		samp->IsRAP = (i % 25) ? 0 : 1;
+		e = gf_isom_add_sample(file, track, di, samp);
+		gf_free(samp->data);
+		samp->data = NULL;
+		if (e) break;
+	}
+	gf_isom_sample_del(&samp);
+	if (e) {
+		gf_isom_delete(file);
+		return GF_FALSE;
+	}
+	return (gf_isom_close(file) == GF_OK) ? GF_TRUE : GF_FALSE;
+}
+
+static ISOMReader *get_reader(TestReader *tr)
+{
+	return (ISOMReader *) tr->ifce->priv;
+}
+
+static Bool open_reader(GF_ModuleManager *mods, TestReader *tr, const char *name)
+{
+	GF_NetworkCommand com;
+	memset(tr, 0, sizeof(TestReader));
+	tr->ifce = (GF_InputService *) gf_modules_load_interface_by_name(mods, "GPAC IsoMedia Reader", GF_NET_CLIENT_INTERFACE);
+	if (!tr->ifce) {
+		fprintf(stderr, "Cannot load the ISO reader module\n");
+		return GF_FALSE;
+	}
+	GF_SAFEALLOC(tr->service, TestService);
+	if (!tr->service) return GF_FALSE;
+	tr->service->serv.fn_connect_ack = on_connect_ack;
+	tr->service->serv.fn_disconnect_ack = on_disconnect_ack;
+	tr->service->serv.fn_command = on_command;
+	tr->service->serv.fn_add_media = on_add_media;
+	tr->service->serv.url = (char *) name;
+
+	tr->ifce->ConnectService(tr->ifce, &tr->service->serv, name);
+	if ((tr->service->nb_connect_ack != 1) || tr->service->connect_error) {
+		fprintf(stderr, "Cannot connect to %s: %s\n", name, gf_error_to_string(tr->service->connect_error));
+		return GF_FALSE;
+	}
+	tr->ifce->ConnectChannel(tr->ifce, &tr->channel, "ES_ID=1", GF_FALSE);
+	if (tr->service->channel_error) {
+		fprintf(stderr, "Cannot connect channel: %s\n", gf_error_to_string(tr->service->channel_error));
+		return GF_FALSE;
+	}
+	memset(&com, 0, sizeof(GF_NetworkCommand));
+	com.command_type = GF_NET_CHAN_PLAY;
+	com.base.on_channel = &tr->channel;
+	com.play.speed = 1.0;
+	com.play.start_range = 0;
+	com.play.end_range = -1;
+	return (tr->ifce->ServiceCommand(tr->ifce, &com) == GF_OK) ? GF_TRUE : GF_FALSE;
+}
+
+static void close_reader(TestReader *tr)
+{
+	if (tr->ifce) {
+		tr->ifce->CloseService(tr->ifce);
+		gf_modules_close_interface((GF_BaseInterface *) tr->ifce);
+	}
+	if (tr->service) gf_free(tr->service);
+	memset(tr, 0, sizeof(TestReader));
+}
+
+/*reads the next nb_samples samples of the reader and checks their content*/
+static Bool read_samples(TestReader *tr, u32 nb_samples, const char *label)
+{
+	u32 i;
+	for (i=0; i<nb_samples; i++) {
+		char *data;
+		u32 size;
+		GF_SLHeader slh;
+		Bool comp, is_new;
+		GF_Err status;
+		GF_Err e = tr->ifce->ChannelGetSLP(tr->ifce, &tr->channel, &data, &size, &slh, &comp, &status, &is_new);
+		if (e || !data) {
+			fprintf(stderr, "%s: no sample %d (error %s - status %s)\n", label, tr->nb_read+1, gf_error_to_string(e), gf_error_to_string(status));
+			return GF_FALSE;
+		}
+		if ((size != sample_size(tr->nb_read)) || ((u8) data[0] != (u8) tr->nb_read) || ((u8) data[size-1] != (u8) tr->nb_read)) {
+			fprintf(stderr, "%s: sample %d has size %d and content %d, expecting size %d and content %d\n", label, tr->nb_read+1, size, (u8) data[0], sample_size(tr->nb_read), (u8) tr->nb_read);
+			return GF_FALSE;
+		}
+		tr->ifce->ChannelReleaseSLP(tr->ifce, &tr->channel);
+		tr->nb_read++;
+	}
+	return GF_TRUE;
+}
+
+static Bool check_shared(GF_ModuleManager *mods)
+{
+	TestReader r1, r2;
+	ISOMReader *read1, *read2;
+	Bool ok = GF_FALSE;
+
+	memset(&r2, 0, sizeof(TestReader));
+	nb_close_logs = 0;
+	if (!open_reader(mods, &r1, TEST_FILE_NAME)) goto exit;
+	if (!open_reader(mods, &r2, TEST_FILE_NAME)) goto exit;
+	read1 = get_reader(&r1);
+	read2 = get_reader(&r2);
+	if (!read1->shared || (read1->shared != read2->shared) || (read1->mov != read2->mov) || (read1->shared->nb_refs != 2)) {
+		fprintf(stderr, "shared: readers use movies %p and %p, expecting one shared movie with 2 users\n", read1->mov, read2->mov);
+		goto exit;
+	}
+
+	/*interleave reads, each reader has its own position*/
+	while (r1.nb_read < NB_SAMPLES/2) {
+		if (!read_samples(&r1, 1, "shared reader 1")) goto exit;
+		if (!read_samples(&r2, 1, "shared reader 2")) goto exit;
+		if (!read_samples(&r2, 1, "shared reader 2")) goto exit;
+	}
+	if (!read_samples(&r1, NB_SAMPLES - r1.nb_read, "shared reader 1")) goto exit;
+	if (!((ISOMChannel *)gf_list_get(read1->channels, 0))->cursor || !((ISOMChannel *)gf_list_get(read2->channels, 0))->cursor) {
+		fprintf(stderr, "shared: channels have no sample table cursor\n");
+		goto exit;
+	}
+
+	/*the second reader keeps the movie after the first one is gone*/
+	close_reader(&r1);
+	if (nb_close_logs || (read2->shared->nb_refs != 1)) {
+		fprintf(stderr, "shared: movie released (%d) or used by %d readers after closing the first reader\n", nb_close_logs, read2->shared->nb_refs);
+		goto exit;
+	}
+	if (!read_samples(&r2, NB_SAMPLES - r2.nb_read, "shared reader 2")) goto exit;
+	close_reader(&r2);
+	if (nb_close_logs != 1) {
+		fprintf(stderr, "shared: movie released %d times after closing the last reader, expecting 1\n", nb_close_logs);
+		goto exit;
+	}
+	ok = GF_TRUE;
+
+exit:
+	close_reader(&r1);
+	close_reader(&r2);
+	return ok;
+}
+
+static Bool check_private(GF_ModuleManager *mods)
+{
+	TestReader r1, r2;
+	Bool ok = GF_FALSE;
+
+	memset(&r2, 0, sizeof(TestReader));
+	if (!open_reader(mods, &r1, TEST_FILE_NAME)) goto exit;
+	if (!open_reader(mods, &r2, TEST_FILE_NAME)) goto exit;
+	if (get_reader(&r1)->shared || get_reader(&r2)->shared || (get_reader(&r1)->mov == get_reader(&r2)->mov)) {
+		fprintf(stderr, "private: readers share a movie with sharing disabled\n");
+		goto exit;
+	}
+	if (!read_samples(&r1, NB_SAMPLES, "private reader 1")) goto exit;
+	if (!read_samples(&r2, NB_SAMPLES, "private reader 2")) goto exit;
+	ok = GF_TRUE;
+
+exit:
+	close_reader(&r1);
+	close_reader(&r2);
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	Bool ok = GF_TRUE;
+	char *prev_opt;
+	const char *opt;
+	GF_Config *cfg;
+	GF_ModuleManager *mods;
+
+	gf_sys_init(GF_MemTrackerNone);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+	gf_log_set_tool_level(GF_LOG_NETWORK, GF_LOG_DEBUG);
+	gf_log_set_callback(NULL, on_log);
+
+	if (!create_file(TEST_FILE_NAME)) {
+		fprintf(stderr, "Error creating test file %s\n", TEST_FILE_NAME);
+		gf_sys_close();
+		return 1;
+	}
+	cfg = gf_cfg_init(NULL, NULL);
+	mods = cfg ? gf_modules_new(NULL, cfg) : NULL;
+	if (!mods) {
+		fprintf(stderr, "Cannot load GPAC modules\n");
+		if (cfg) gf_cfg_del(cfg);
+		gf_delete_file(TEST_FILE_NAME);
+		gf_sys_close();
+		return 1;
+	}
+	/*the user setting is restored at exit*/
+	opt = gf_cfg_get_key(cfg, "ISOReader", "ShareMovies");
+	prev_opt = opt ? gf_strdup(opt) : NULL;
+
+	gf_cfg_set_key(cfg, "ISOReader", "ShareMovies", NULL);
+	if (!check_private(mods) || !gf_cfg_get_key(cfg, "ISOReader", "ShareMovies") || strcmp(gf_cfg_get_key(cfg, "ISOReader", "ShareMovies"), "no")) {
+		fprintf(stdout, "default setting: FAILED\n");
+		ok = GF_FALSE;
+	} else {
+		fprintf(stdout, "default setting: OK\n");
+	}
+
+	gf_cfg_set_key(cfg, "ISOReader", "ShareMovies", "yes");
+	if (!check_shared(mods)) {
+		fprintf(stdout, "shared movie: FAILED\n");
+		ok = GF_FALSE;
+	} else {
+		fprintf(stdout, "shared movie: OK\n");
+	}
+
+	gf_cfg_set_key(cfg, "ISOReader", "ShareMovies", "no");
+	if (!check_private(mods)) {
+		fprintf(stdout, "private movies: FAILED\n");
+		ok = GF_FALSE;
+	} else {
+		fprintf(stdout, "private movies: OK\n");
+	}
+
+	gf_cfg_set_key(cfg, "ISOReader", "ShareMovies", prev_opt);
+	if (prev_opt) gf_free(prev_opt);
+	gf_modules_del(mods);
+	gf_cfg_del(cfg);
+	gf_delete_file(TEST_FILE_NAME);
+	gf_sys_close();
+	return ok ? 0 : 1;
+}
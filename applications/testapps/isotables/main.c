@@ -0,0 +1,239 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / ISO sample tables test application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*checks sample table handling in the ISO reader:
+- lazy: a file opened with GF_ISOM_OPEN_LAZY_TABLES reports the same movie duration as a fully loaded one,
+without error and before and after its tables are loaded
+- reset: media segments opened one after the other with sample counts reset in between (as done by the DASH reader),
+each segment holding enough samples for their sizes to be packed, report the sizes of their own samples only
+returns 1 if any check fails*/
+
+#include <gpac/isomedia.h>
+
+#define TEST_FILE_NAME	"isotables.mp4"
+#define NB_SAMPLES		500
+#define SEG_INIT_NAME	"isotables_init.mp4"
+#define SEG_NAME		"isotables_%d.m4s"
+#define NB_SEGS			3
+#define NB_SEG_SAMPLES	600
+
+static u32 seg_sample_size(u32 seg, u32 i)
+{
+	return 100 + (seg*7 + i*13) % 200;
+}
+
+static Bool create_file(const char *name)
+{
+	u32 i, tk, di;
+	GF_ESD *esd;
+	GF_ISOSample *samp;
+	GF_Err e = GF_OK;
+	GF_ISOFile *file = gf_isom_open(name, GF_ISOM_OPEN_WRITE, NULL);
+	if (!file) return GF_FALSE;
+
+	/*two tracks of different durations, the movie duration is the longest one*/
+	samp = gf_isom_sample_new();
+	for (tk=0; tk<2; tk++) {
+		u32 track = gf_isom_new_track(file, 0, GF_ISOM_MEDIA_VISUAL, tk ? 25 : 1000);
+		esd = gf_odf_desc_esd_new(2);
+		esd->decoderConfig->streamType = 4;
+		gf_isom_new_mpeg4_description(file, track, esd, NULL, NULL, &di);
+		gf_odf_desc_del((GF_Descriptor *) esd);
+		samp->DTS = 0;
+		for (i=0; i<NB_SAMPLES; i++) {
+			/*varying sizes and durations*/
+			samp->dataLength = 100 + (i % 37) * 10;
+			samp->data = gf_malloc(samp->dataLength);
+			memset(samp->data, i, samp->dataLength);
+			samp->IsRAP = (i % 25) ? 0 : 1;
+			e = gf_isom_add_sample(file, track, di, samp);
+			gf_free(samp->data);
+			samp->data = NULL;
+			if (e) break;
+			samp->DTS += tk ? 1 : 40 + (i % 3);
+		}
+		if (e) break;
+	}
+	gf_isom_sample_del(&samp);
+	if (e) {
+		gf_isom_delete(file);
+		return GF_FALSE;
+	}
+	return (gf_isom_close(file) == GF_OK) ? GF_TRUE : GF_FALSE;
+}
+
+static Bool check_lazy_duration(const char *name)
+{
+	u64 ref_dur, dur;
+	Bool ok = GF_TRUE;
+	GF_ISOFile *file = gf_isom_open(name, GF_ISOM_OPEN_READ, NULL);
+	if (!file) return GF_FALSE;
+	ref_dur = gf_isom_get_duration(file);
+	gf_isom_close(file);
+
+	file = gf_isom_open(name, GF_ISOM_OPEN_READ | GF_ISOM_OPEN_LAZY_TABLES, NULL);
+	if (!file) return GF_FALSE;
+	dur = gf_isom_get_duration(file);
+	if ((dur != ref_dur) || gf_isom_last_error(file)) {
+		fprintf(stderr, "lazy: duration "LLU" (error %s) before loading tables, expecting "LLU"\n", dur, gf_error_to_string(gf_isom_last_error(file)), ref_dur);
+		ok = GF_FALSE;
+	}
+	if (gf_isom_get_sample_count(file, 1) != NB_SAMPLES) {
+		fprintf(stderr, "lazy: %d samples announced, expecting %d\n", gf_isom_get_sample_count(file, 1), NB_SAMPLES);
+		ok = GF_FALSE;
+	}
+	gf_isom_load_sample_tables(file, 0);
+	dur = gf_isom_get_duration(file);
+	if ((dur != ref_dur) || gf_isom_last_error(file)) {
+		fprintf(stderr, "lazy: duration "LLU" (error %s) after loading tables, expecting "LLU"\n", dur, gf_error_to_string(gf_isom_last_error(file)), ref_dur);
+		ok = GF_FALSE;
+	}
+	gf_isom_close(file);
+	return ok;
+}
+
+static Bool create_segments()
+{
+	u32 i, seg, track, di, trackID;
+	char szName[100];
+	GF_ESD *esd;
+	GF_ISOSample *samp;
+	GF_Err e;
+	GF_ISOFile *file = gf_isom_open(SEG_INIT_NAME, GF_ISOM_OPEN_WRITE, NULL);
+	if (!file) return GF_FALSE;
+
+	track = gf_isom_new_track(file, 0, GF_ISOM_MEDIA_VISUAL, 25);
+	trackID = gf_isom_get_track_id(file, track);
+	esd = gf_odf_desc_esd_new(2);
+	esd->decoderConfig->streamType = 4;
+	e = gf_isom_new_mpeg4_description(file, track, esd, NULL, NULL, &di);
+	gf_odf_desc_del((GF_Descriptor *) esd);
+	if (!e) e = gf_isom_setup_track_fragment(file, trackID, di, 1, 0, 0, 0, 0, 0);
+	if (!e) e = gf_isom_finalize_for_fragment(file, 1);
+
+	samp = gf_isom_sample_new();
+	samp->data = gf_malloc(300);
+	memset(samp->data, 0, 300);
+	for (seg=0; !e && (seg<NB_SEGS); seg++) {
+		sprintf(szName, SEG_NAME, seg);
+		e = gf_isom_start_segment(file, szName, GF_FALSE);
+		if (!e) e = gf_isom_start_fragment(file, GF_TRUE);
+		if (!e) e = gf_isom_set_traf_base_media_decode_time(file, trackID, seg*NB_SEG_SAMPLES);
+		for (i=0; !e && (i<NB_SEG_SAMPLES); i++) {
+			samp->dataLength = seg_sample_size(seg, i);
+			samp->DTS = seg*NB_SEG_SAMPLES + i;
+			samp->IsRAP = i ? 0 : 1;
+			e = gf_isom_fragment_add_sample(file, trackID, samp, di, 1, 0, 0, 0);
+		}
+		if (!e) e = gf_isom_close_segment(file, 0, 0, 0, 0, 0, GF_FALSE, GF_FALSE, (seg+1==NB_SEGS) ? GF_TRUE : GF_FALSE, GF_TRUE, 0, NULL, NULL, NULL);
+	}
+	gf_isom_sample_del(&samp);
+	if (e) {
+		gf_isom_delete(file);
+		return GF_FALSE;
+	}
+	return (gf_isom_close(file) == GF_OK) ? GF_TRUE : GF_FALSE;
+}
+
+static void delete_segments()
+{
+	u32 i;
+	char szName[100];
+	gf_delete_file(SEG_INIT_NAME);
+	for (i=0; i<NB_SEGS; i++) {
+		sprintf(szName, SEG_NAME, i);
+		gf_delete_file(szName);
+	}
+}
+
+static Bool check_reset()
+{
+	u32 i, seg;
+	u64 missing;
+	char szName[100];
+	Bool ok = GF_TRUE;
+	GF_ISOFile *file = NULL;
+	GF_Err e = gf_isom_open_progressive(SEG_INIT_NAME, 0, 0, &file, &missing);
+	if (e || !file) return GF_FALSE;
+
+	for (seg=0; seg<NB_SEGS; seg++) {
+		/*the previous segment is released by opening the next one, with its tables*/
+		if (seg==1) gf_isom_reset_fragment_info(file, GF_FALSE);
+		else gf_isom_reset_sample_count(file);
+
+		sprintf(szName, SEG_NAME, seg);
+		e = gf_isom_open_segment(file, szName, 0, 0, 0);
+		if (e) {
+			fprintf(stderr, "reset: cannot open segment %s: %s\n", szName, gf_error_to_string(e));
+			ok = GF_FALSE;
+			break;
+		}
+		if (gf_isom_get_sample_count(file, 1) != NB_SEG_SAMPLES) {
+			fprintf(stderr, "reset: segment %d has %d samples, expecting %d\n", seg, gf_isom_get_sample_count(file, 1), NB_SEG_SAMPLES);
+			ok = GF_FALSE;
+			break;
+		}
+		for (i=0; i<NB_SEG_SAMPLES; i++) {
+			if (gf_isom_get_sample_size(file, 1, i+1) != seg_sample_size(seg, i)) {
+				fprintf(stderr, "reset: segment %d sample %d has size %d, expecting %d\n", seg, i+1, gf_isom_get_sample_size(file, 1, i+1), seg_sample_size(seg, i));
+				ok = GF_FALSE;
+				break;
+			}
+		}
+		if (!ok) break;
+	}
+	gf_isom_release_segment(file, GF_TRUE);
+	gf_isom_close(file);
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	Bool ok = GF_TRUE;
+
+	gf_sys_init(GF_FALSE);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+
+	if (!create_file(TEST_FILE_NAME)) {
+		fprintf(stderr, "Error creating test file %s\n", TEST_FILE_NAME);
+		gf_sys_close();
+		return 1;
+	}
+	if (!check_lazy_duration(TEST_FILE_NAME)) ok = GF_FALSE;
+	fprintf(stdout, "lazy tables duration: %s\n", ok ? "OK" : "FAILED");
+	gf_delete_file(TEST_FILE_NAME);
+
+	if (!create_segments()) {
+		fprintf(stderr, "Error creating test segments\n");
+		ok = GF_FALSE;
+	} else {
+		Bool seg_ok = check_reset();
+		fprintf(stdout, "segments after sample count reset: %s\n", seg_ok ? "OK" : "FAILED");
+		if (!seg_ok) ok = GF_FALSE;
+	}
+	delete_segments();
+	gf_sys_close();
+	return ok ? 0 : 1;
+}
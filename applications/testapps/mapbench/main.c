@@ -0,0 +1,228 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / hash map benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*measures insertion, successful and failed lookups and removal in maps with string and integer keys, from 1k entries
+up to the given number of entries. Maps are created with the default capacity and grow while inserting. Half of the
+entries are removed and inserted again before the final removal to exercise the reuse of removed slots, and the
+content of the map is checked at each step.*/
+
+#include <gpac/map.h>
+
+typedef struct
+{
+	u64 insert, find, miss, rem;
+} MapTimes;
+
+/*entry i uses key number key_num[i], a random permutation of 0..max_entries-1, so that the map is accessed at random
+as with real keys. String keys are stored in a single buffer, "k<n>" for entries and "m<n>" for missing keys*/
+static u32 *key_num = NULL;
+static char *keys_buf = NULL;
+static u32 *keys_offset = NULL;
+
+static Bool make_keys(u32 nb_keys)
+{
+	u32 i, pos = 0;
+	key_num = (u32 *)gf_malloc(sizeof(u32) * nb_keys);
+	keys_buf = (char *)gf_malloc(sizeof(char) * 12 * nb_keys);
+	keys_offset = (u32 *)gf_malloc(sizeof(u32) * nb_keys);
+	if (!key_num || !keys_buf || !keys_offset) return GF_FALSE;
+
+	gf_rand_init(GF_TRUE);
+	for (i=0; i<nb_keys; i++) key_num[i] = i;
+	for (i=nb_keys-1; i>0; i--) {
+		u32 j = ((gf_rand() << 16) ^ gf_rand()) % (i+1);
+		u32 tmp = key_num[i];
+		key_num[i] = key_num[j];
+		key_num[j] = tmp;
+	}
+	for (i=0; i<nb_keys; i++) {
+		keys_offset[i] = pos;
+		pos += sprintf(keys_buf + pos, "k%u", key_num[i]) + 1;
+	}
+	return GF_TRUE;
+}
+
+#define KEY(_i)	(keys_buf + keys_offset[_i])
+#define INT_KEY(_i)	((u64) key_num[_i])
+#define VAL(_i)	((void *) (ptrdiff_t) ((_i)+1))
+
+static Bool bench_string(u32 nb, MapTimes *t)
+{
+	u32 i;
+	u64 start;
+	Bool ok = GF_TRUE;
+	void *val;
+	GF_It_Map it;
+	GF_Map *map = gf_map_new(0);
+
+	start = gf_sys_clock_high_res();
+	for (i=0; i<nb; i++) {
+		if (gf_map_insert(map, KEY(i), VAL(i)) != GF_OK) ok = GF_FALSE;
+	}
+	t->insert = gf_sys_clock_high_res() - start;
+	if (gf_map_count(map) != nb) ok = GF_FALSE;
+
+	start = gf_sys_clock_high_res();
+	for (i=0; i<nb; i++) {
+		if (gf_map_find(map, KEY(i)) != VAL(i)) ok = GF_FALSE;
+	}
+	t->find = gf_sys_clock_high_res() - start;
+
+	/*missing keys: same length as the keys in the map, first character changed*/
+	start = gf_sys_clock_high_res();
+	for (i=0; i<nb; i++) {
+		char *key = KEY(i);
+		key[0] = 'm';
+		if (gf_map_find(map, key)) ok = GF_FALSE;
+		key[0] = 'k';
+	}
+	t->miss = gf_sys_clock_high_res() - start;
+
+	/*remove and insert back one entry out of two, then check the content by iterating*/
+	for (i=0; i<nb; i+=2) {
+		if (!gf_map_rem(map, KEY(i))) ok = GF_FALSE;
+	}
+	if (gf_map_has_key(map, KEY(0))) ok = GF_FALSE;
+	for (i=0; i<nb; i+=2) {
+		if (gf_map_insert(map, KEY(i), VAL(i)) != GF_OK) ok = GF_FALSE;
+	}
+	gf_map_iter_set(map, &it);
+	i = 0;
+	while ((val = gf_map_iter_has_next(&it))) {
+		u32 idx = (u32) ((ptrdiff_t) val - 1);
+		if ((idx >= nb) || (gf_map_find(map, KEY(idx)) != val)) ok = GF_FALSE;
+		i++;
+	}
+	if (i != nb) ok = GF_FALSE;
+
+	start = gf_sys_clock_high_res();
+	for (i=0; i<nb; i++) {
+		if (!gf_map_rem(map, KEY(i))) ok = GF_FALSE;
+	}
+	t->rem = gf_sys_clock_high_res() - start;
+	if (gf_map_count(map)) ok = GF_FALSE;
+
+	gf_map_del(map);
+	return ok;
+}
+
+static Bool bench_int(u32 nb, MapTimes *t)
+{
+	u32 i;
+	u64 start;
+	Bool ok = GF_TRUE;
+	void *val;
+	GF_It_Map it;
+	GF_Map *map = gf_map_new_ex(0, GF_TRUE, NULL);
+
+	start = gf_sys_clock_high_res();
+	for (i=0; i<nb; i++) {
+		if (gf_map_insert_int(map, INT_KEY(i), VAL(i)) != GF_OK) ok = GF_FALSE;
+	}
+	t->insert = gf_sys_clock_high_res() - start;
+	if (gf_map_count(map) != nb) ok = GF_FALSE;
+
+	start = gf_sys_clock_high_res();
+	for (i=0; i<nb; i++) {
+		if (gf_map_find_int(map, INT_KEY(i)) != VAL(i)) ok = GF_FALSE;
+	}
+	t->find = gf_sys_clock_high_res() - start;
+
+	start = gf_sys_clock_high_res();
+	for (i=0; i<nb; i++) {
+		if (gf_map_find_int(map, INT_KEY(i) + 0x100000000ULL)) ok = GF_FALSE;
+	}
+	t->miss = gf_sys_clock_high_res() - start;
+
+	for (i=0; i<nb; i+=2) {
+		if (!gf_map_rem_int(map, INT_KEY(i))) ok = GF_FALSE;
+	}
+	if (gf_map_has_key_int(map, INT_KEY(0))) ok = GF_FALSE;
+	for (i=0; i<nb; i+=2) {
+		if (gf_map_insert_int(map, INT_KEY(i), VAL(i)) != GF_OK) ok = GF_FALSE;
+	}
+	gf_map_iter_set(map, &it);
+	i = 0;
+	while ((val = gf_map_iter_has_next(&it))) {
+		u32 idx = (u32) ((ptrdiff_t) val - 1);
+		if ((idx >= nb) || (gf_map_find_int(map, INT_KEY(idx)) != val)) ok = GF_FALSE;
+		i++;
+	}
+	if (i != nb) ok = GF_FALSE;
+
+	start = gf_sys_clock_high_res();
+	for (i=0; i<nb; i++) {
+		if (!gf_map_rem_int(map, INT_KEY(i))) ok = GF_FALSE;
+	}
+	t->rem = gf_sys_clock_high_res() - start;
+	if (gf_map_count(map)) ok = GF_FALSE;
+
+	gf_map_del(map);
+	return ok;
+}
+
+static void print_times(const char *name, u32 nb, MapTimes *t, Bool ok)
+{
+	fprintf(stdout, "%-7s %-10d %10.1f %10.1f %10.1f %10.1f%s\n", name, nb,
+	        1000.0 * t->insert / nb, 1000.0 * t->find / nb, 1000.0 * t->miss / nb, 1000.0 * t->rem / nb,
+	        ok ? "" : " - CONTENT MISMATCH");
+}
+
+int main(int argc, char **argv)
+{
+	u32 nb, max_entries = 10000000;
+
+	if (argc > 1) max_entries = atoi(argv[1]);
+	if (max_entries < 1000) {
+		fprintf(stderr, "usage: mapbench [max_entries]\nmax_entries shall be at least 1000\n");
+		return 1;
+	}
+
+	gf_sys_init(GF_FALSE);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_QUIET);
+
+	if (!make_keys(max_entries)) {
+		fprintf(stderr, "Not enough memory for %d keys\n", max_entries);
+		goto exit;
+	}
+
+	fprintf(stdout, "ns per operation\n\n");
+	fprintf(stdout, "%-7s %-10s %10s %10s %10s %10s\n", "keys", "entries", "insert", "find", "miss", "remove");
+	for (nb = 1000; nb <= max_entries; nb *= 10) {
+		MapTimes t;
+		Bool ok = bench_string(nb, &t);
+		print_times("string", nb, &t, ok);
+		ok = bench_int(nb, &t);
+		print_times("integer", nb, &t, ok);
+		if (nb > max_entries / 10) break;
+	}
+
+exit:
+	if (key_num) gf_free(key_num);
+	if (keys_buf) gf_free(keys_buf);
+	if (keys_offset) gf_free(keys_offset);
+	gf_sys_close();
+	return 0;
+}
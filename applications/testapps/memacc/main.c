@@ -0,0 +1,223 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / memory accounting test application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*checks per-subsystem memory accounting:
+- blocks not allocated by the accounting allocator (here by the system allocator) are reallocated and freed without
+being accounted
+- allocations, reallocations and frees update the counters of their tag
+- library allocations are tagged with the subsystem of the code doing them, and application allocations as other
+- after threads allocate, reallocate and free blocks concurrently, the counters are back to their initial values
+returns 1 if any check fails. Run it with a sanitizer to check that foreign blocks are not read*/
+
+#include <gpac/thread.h>
+#include <gpac/mpegts.h>
+#include <gpac/internal/mpd.h>
+
+#define NB_THREADS	4
+#define NB_OPS		200000
+#define NB_SLOTS	256
+
+typedef struct
+{
+	u64 current, nb_alloc, nb_free;
+} Totals;
+
+static void get_totals(Totals *t)
+{
+	u32 i;
+	memset(t, 0, sizeof(Totals));
+	for (i=0; i<GF_MEM_TAG_MAX; i++) {
+		GF_MemTagStats stats;
+		gf_memory_tag_stats((GF_MemTag) i, &stats);
+		t->current += stats.current;
+		t->nb_alloc += stats.nb_alloc;
+		t->nb_free += stats.nb_free;
+	}
+}
+
+static Bool check_totals(const char *step, Totals *ref, s64 current, s64 nb_alloc, s64 nb_free)
+{
+	Totals t;
+	get_totals(&t);
+	if ((t.current != ref->current + current) || (t.nb_alloc != ref->nb_alloc + nb_alloc) || (t.nb_free != ref->nb_free + nb_free)) {
+		fprintf(stderr, "%s: "LLD" bytes "LLD" allocs "LLD" frees, expecting "LLD" bytes "LLD" allocs "LLD" frees\n", step,
+		        (s64) (t.current - ref->current), (s64) (t.nb_alloc - ref->nb_alloc), (s64) (t.nb_free - ref->nb_free), current, nb_alloc, nb_free);
+		return GF_FALSE;
+	}
+	return GF_TRUE;
+}
+
+static u64 tag_allocs(GF_MemTag tag)
+{
+	GF_MemTagStats stats;
+	gf_memory_tag_stats(tag, &stats);
+	return stats.nb_alloc;
+}
+
+/*checks that the allocations of an object constructor go to the expected tag, and to core for the lists and bitstreams it creates*/
+static Bool check_tag(const char *name, GF_MemTag expected, u64 *before)
+{
+	u32 i;
+	Bool ok = GF_TRUE;
+	for (i=0; i<GF_MEM_TAG_MAX; i++) {
+		u64 nb = tag_allocs((GF_MemTag) i) - before[i];
+		if ((i==expected) ? !nb : (nb && (i != GF_MEM_TAG_CORE))) {
+			fprintf(stderr, "%s: "LLU" allocations tagged %s, expecting %s\n", name, nb, gf_memory_tag_name((GF_MemTag) i), gf_memory_tag_name(expected));
+			ok = GF_FALSE;
+		}
+	}
+	return ok;
+}
+
+static void get_tag_allocs(u64 *before)
+{
+	u32 i;
+	for (i=0; i<GF_MEM_TAG_MAX; i++) before[i] = tag_allocs((GF_MemTag) i);
+}
+
+static u32 stress_thread(void *par)
+{
+	u32 i, seed = (u32) (size_t) par;
+	void *blocks[NB_SLOTS];
+	memset(blocks, 0, sizeof(blocks));
+	for (i=0; i<NB_OPS; i++) {
+		u32 slot, size;
+		seed = seed*1103515245 + 12345;
+		slot = (seed >> 8) % NB_SLOTS;
+		size = 1 + ((seed >> 16) % 2000);
+		switch (seed >> 30) {
+		case 0:
+			gf_free(blocks[slot]);
+			blocks[slot] = NULL;
+			break;
+		case 1:
+			blocks[slot] = gf_realloc(blocks[slot], size);
+			break;
+		default:
+			gf_free(blocks[slot]);
+			blocks[slot] = (seed & 1) ? gf_malloc(size) : gf_calloc(1, size);
+			break;
+		}
+	}
+	for (i=0; i<NB_SLOTS; i++) gf_free(blocks[i]);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	u32 i;
+	char *ptr;
+	Totals ref;
+	GF_MemTagStats stats;
+	Bool ok = GF_TRUE;
+	GF_Thread *th[NB_THREADS];
+
+	gf_sys_init(GF_MemTrackerAccounting);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+	if (!gf_memory_tag_stats(GF_MEM_TAG_CORE, &stats)) {
+		fprintf(stderr, "memory accounting not enabled\n");
+		gf_sys_close();
+		return 1;
+	}
+
+	/*blocks from another allocator*/
+	get_totals(&ref);
+	ptr = (char *) malloc(100);
+	ptr = (char *) gf_realloc(ptr, 1000);
+	gf_free(ptr);
+	if (!check_totals("foreign block", &ref, 0, 0, 0)) ok = GF_FALSE;
+
+	get_totals(&ref);
+	ptr = (char *) gf_malloc(100);
+	if (!check_totals("malloc", &ref, 100, 1, 0)) ok = GF_FALSE;
+	ptr = (char *) gf_realloc(ptr, 1000);
+	if (!check_totals("realloc", &ref, 1000, 1, 0)) ok = GF_FALSE;
+	ptr = (char *) gf_realloc(ptr, 10);
+	if (!check_totals("realloc", &ref, 10, 1, 0)) ok = GF_FALSE;
+	gf_free(ptr);
+	ptr = gf_strdup("memacc");
+	if (!check_totals("strdup", &ref, 7, 2, 1)) ok = GF_FALSE;
+	gf_free(ptr);
+	if (!check_totals("free", &ref, 0, 2, 2)) ok = GF_FALSE;
+	fprintf(stdout, "single thread: %s\n", ok ? "OK" : "FAILED");
+
+	{
+		Bool tags_ok = GF_TRUE;
+		u64 before[GF_MEM_TAG_MAX];
+		GF_List *list;
+#ifndef GPAC_DISABLE_CORE_TOOLS
+		GF_MPD *mpd;
+#endif
+#ifndef GPAC_DISABLE_MPEG2TS
+		GF_M2TS_Demuxer *ts;
+#endif
+		get_tag_allocs(before);
+		ptr = (char *) gf_malloc(10);
+		if (!check_tag("application", GF_MEM_TAG_OTHER, before)) tags_ok = GF_FALSE;
+		gf_free(ptr);
+		get_tag_allocs(before);
+		list = gf_list_new();
+		if (!check_tag("gf_list_new", GF_MEM_TAG_CORE, before)) tags_ok = GF_FALSE;
+		gf_list_del(list);
+#ifndef GPAC_DISABLE_CORE_TOOLS
+		get_tag_allocs(before);
+		mpd = gf_mpd_new();
+		if (!check_tag("gf_mpd_new", GF_MEM_TAG_DASH, before)) tags_ok = GF_FALSE;
+		gf_mpd_del(mpd);
+#endif
+#ifndef GPAC_DISABLE_MPEG2TS
+		get_tag_allocs(before);
+		ts = gf_m2ts_demux_new();
+		if (!check_tag("gf_m2ts_demux_new", GF_MEM_TAG_MPEG2TS, before)) tags_ok = GF_FALSE;
+		gf_m2ts_demux_del(ts);
+#endif
+		fprintf(stdout, "tags: %s\n", tags_ok ? "OK" : "FAILED");
+		if (!tags_ok) ok = GF_FALSE;
+	}
+
+	get_totals(&ref);
+	for (i=0; i<NB_THREADS; i++) {
+		th[i] = gf_th_new("memacc");
+		gf_th_run(th[i], stress_thread, (void *) (size_t) (i+1));
+	}
+	for (i=0; i<NB_THREADS; i++) {
+		gf_th_stop(th[i]);
+		gf_th_del(th[i]);
+	}
+	{
+		Totals t;
+		get_totals(&t);
+		/*thread objects are allocated and freed as well, only the balance is checked*/
+		if ((t.current != ref.current) || (t.nb_alloc - ref.nb_alloc != t.nb_free - ref.nb_free)) {
+			fprintf(stderr, "threads: "LLD" bytes and "LLD" blocks left\n", (s64) (t.current - ref.current), (s64) ((t.nb_alloc - ref.nb_alloc) - (t.nb_free - ref.nb_free)));
+			ok = GF_FALSE;
+		} else {
+			fprintf(stdout, "threads: OK ("LLU" allocations)\n", t.nb_alloc - ref.nb_alloc);
+		}
+	}
+
+	gf_sys_close();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / SegmentTimeline lookup benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*builds synthetic MPDs with a SegmentTimeline of many entries with large repeat counts, checks the indexed
+time <-> segment index lookups against a linear walk of the timeline and reports the cost of both*/
+
+#include <gpac/internal/mpd.h>
+#include <gpac/xml.h>
+
+#define NB_LOOKUPS	1000
+
+/*linear walk, as done before the timeline index*/
+static u64 walk_segment_start(GF_MPD_SegmentTimeline *timeline, u32 segment_index)
+{
+	u64 start_time = 0;
+	u32 i, k, idx = 0;
+	for (i = 0; i<gf_list_count(timeline->entries); i++) {
+		GF_MPD_SegmentTimelineEntry *ent = gf_list_get(timeline->entries, i);
+		if (ent->start_time) start_time = ent->start_time;
+		for (k = 0; k<ent->repeat_count + 1; k++) {
+			if (idx == segment_index) return start_time;
+			idx++;
+			start_time += ent->duration;
+		}
+	}
+	return start_time;
+}
+
+static u32 walk_find_time(GF_MPD_SegmentTimeline *timeline, u64 time)
+{
+	u64 start_time = 0;
+	u32 i, k, idx = 0;
+	for (i = 0; i<gf_list_count(timeline->entries); i++) {
+		GF_MPD_SegmentTimelineEntry *ent = gf_list_get(timeline->entries, i);
+		if (ent->start_time) start_time = ent->start_time;
+		for (k = 0; k<ent->repeat_count + 1; k++) {
+			if (start_time >= time) return idx;
+			idx++;
+			start_time += ent->duration;
+		}
+	}
+	return idx;
+}
+
+static char *build_mpd(u32 nb_entries, u32 repeat)
+{
+	u32 i, size, alloc;
+	u64 time = 0;
+	char *mpd, szLine[200];
+	const char *header = "<?xml version=\"1.0\"?>\n<MPD xmlns=\"urn:mpeg:dash:schema:mpd:2011\" type=\"dynamic\" availabilityStartTime=\"2017-01-01T00:00:00Z\" minimumUpdatePeriod=\"PT2S\" profiles=\"urn:mpeg:dash:profile:isoff-live:2011\">\n"
+	                     "<Period id=\"1\" start=\"PT0S\">\n<AdaptationSet segmentAlignment=\"true\">\n<SegmentTemplate timescale=\"90000\" media=\"seg_$Time$.m4s\" initialization=\"init.mp4\">\n<SegmentTimeline>\n";
+	const char *footer = "</SegmentTimeline>\n</SegmentTemplate>\n<Representation id=\"1\" mimeType=\"video/mp4\" codecs=\"avc1.42c01e\" bandwidth=\"500000\"/>\n</AdaptationSet>\n</Period>\n</MPD>\n";
+
+	alloc = (u32) (strlen(header) + strlen(footer) + 100*nb_entries + 1);
+	mpd = gf_malloc(alloc);
+	strcpy(mpd, header);
+	size = (u32) strlen(mpd);
+	for (i=0; i<nb_entries; i++) {
+		u32 dur = (i%2) ? 180000 : 179820;
+		/*alternate durations so that entries cannot be merged, with an explicit start time every 100 entries*/
+		if (i%100) sprintf(szLine, "<S d=\"%d\" r=\"%d\"/>\n", dur, repeat);
+		else sprintf(szLine, "<S t=\""LLU"\" d=\"%d\" r=\"%d\"/>\n", time, dur, repeat);
+		time += (u64) dur * (repeat+1);
+		strcpy(mpd+size, szLine);
+		size += (u32) strlen(szLine);
+	}
+	strcpy(mpd+size, footer);
+	return mpd;
+}
+
+static void run_test(u32 nb_entries, u32 repeat)
+{
+	u32 i, nb_segs, nb_errors = 0;
+	u64 t0, t_index, t_walk, t_seek, end_time;
+	u64 starts[NB_LOOKUPS];
+	u32 found[NB_LOOKUPS];
+	char *xml = build_mpd(nb_entries, repeat);
+	GF_DOMParser *dom = gf_xml_dom_new();
+	GF_MPD *mpd = gf_mpd_new();
+	GF_MPD_Period *period;
+	GF_MPD_AdaptationSet *set;
+	GF_MPD_Representation *rep;
+	GF_MPD_SegmentTimeline *timeline;
+
+	if (gf_xml_dom_parse_string(dom, xml) || gf_mpd_init_from_dom(gf_xml_dom_get_root(dom), mpd, "bench.mpd")) {
+		fprintf(stderr, "Failed to load synthetic MPD\n");
+		return;
+	}
+	period = gf_list_get(mpd->periods, 0);
+	set = gf_list_get(period->adaptation_sets, 0);
+	rep = gf_list_get(set->representations, 0);
+	timeline = set->segment_template->segment_timeline;
+	nb_segs = gf_mpd_segment_timeline_get_count(timeline, &end_time);
+
+	/*index -> time*/
+	t0 = gf_sys_clock_high_res();
+	for (i=0; i<NB_LOOKUPS; i++) {
+		gf_mpd_segment_timeline_get_segment(timeline, (u32) (((u64) i * nb_segs) / NB_LOOKUPS), &starts[i], NULL);
+	}
+	/*time -> index*/
+	for (i=0; i<NB_LOOKUPS; i++) {
+		found[i] = gf_mpd_segment_timeline_find_time(timeline, (end_time * i) / NB_LOOKUPS, NULL);
+	}
+	t_index = gf_sys_clock_high_res() - t0;
+
+	t0 = gf_sys_clock_high_res();
+	for (i=0; i<NB_LOOKUPS; i++) {
+		if (walk_segment_start(timeline, (u32) (((u64) i * nb_segs) / NB_LOOKUPS)) != starts[i]) nb_errors++;
+		if (walk_find_time(timeline, (end_time * i) / NB_LOOKUPS) != found[i]) nb_errors++;
+	}
+	t_walk = gf_sys_clock_high_res() - t0;
+
+	t0 = gf_sys_clock_high_res();
+	for (i=0; i<NB_LOOKUPS; i++) {
+		u32 seg_idx;
+		gf_mpd_seek_in_period((Double) i * (end_time - starts[0]) / 90000 / NB_LOOKUPS, MPD_SEEK_PREV, period, set, rep, &seg_idx, NULL);
+	}
+	t_seek = gf_sys_clock_high_res() - t0;
+
+	fprintf(stdout, "%6d entries r=%6d (%10d segments): indexed %8.3f us/lookup - linear walk %10.1f us/lookup - seek %8.3f us - %s\n",
+	        nb_entries, repeat, nb_segs, t_index / (2.0*NB_LOOKUPS), t_walk / (2.0*NB_LOOKUPS), (Double) t_seek / NB_LOOKUPS,
+	        nb_errors ? "MISMATCH" : "OK");
+
+	gf_mpd_del(mpd);
+	gf_xml_dom_del(dom);
+	gf_free(xml);
+}
+
+int main(int argc, char **argv)
+{
+	gf_sys_init(GF_FALSE);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+
+	run_test(100, 10);
+	run_test(1000, 100);
+	run_test(5000, 100);
+	run_test(5000, 1000);
+	run_test(20000, 1000);
+
+	gf_sys_close();
+	return 0;
+}
@@ -0,0 +1,298 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / Reed-Solomon benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*checks and measures the RS(255,191) codec used by DVB MPE-FEC (GPAC must be configured with --enable-dvbx):
+- random codewords are corrupted with random errors and erasures and decoded. Within the code capacity
+(2*errors + erasures <= 64) the original codeword must be restored, beyond it the decoder must either report
+the codeword as uncorrectable or return another valid codeword
+- the previous GPAC codec (rs_legacy.c) encodes and decodes the same codewords: parity bytes must be identical and,
+within the code capacity, both decoders must produce the same codeword
+- decode throughput is measured for full MPE-FEC frames (1024 rows) with increasing error counts, for both codecs
+- several streams are then decoded at once, one codec per stream, on a thread pool*/
+
+#include <gpac/thread.h>
+#include <gpac/internal/reedsolomon.h>
+#include "rs_legacy.h"
+
+#ifdef GPAC_ENABLE_MPE
+
+#define ADT_COLS	191
+#define CW_SIZE		(ADT_COLS + NPAR)
+#define FRAME_ROWS	1024
+
+static u32 rand_state = 0x12345678;
+
+static u32 rand_u32()
+{
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+	return rand_state;
+}
+
+/*corrupts nb_err bytes at unknown positions and nb_eras bytes at positions stored in erasures*/
+static void corrupt(u8 *cw, u32 nb_err, u32 nb_eras, u32 *erasures)
+{
+	u32 i, j;
+	u32 pos[CW_SIZE];
+	for (i=0; i<CW_SIZE; i++) pos[i] = i;
+	/*partial shuffle to pick distinct positions*/
+	for (i=0; i<nb_err+nb_eras; i++) {
+		u32 tmp;
+		j = i + rand_u32() % (CW_SIZE - i);
+		tmp = pos[i];
+		pos[i] = pos[j];
+		pos[j] = tmp;
+		cw[pos[i]] ^= 1 + rand_u32() % 255;
+	}
+	for (i=0; i<nb_eras; i++) erasures[i] = pos[nb_err+i];
+}
+
+static Bool check_random_codewords(GF_RSCodec *rs, u32 nb_tests)
+{
+	u32 i, j, nb_ok=0, nb_detected=0, nb_miscorrected=0, nb_failed=0;
+	u32 nb_same=0, nb_legacy_detected=0, nb_legacy_invalid=0, nb_legacy_other=0;
+	u8 ref[CW_SIZE], cw[CW_SIZE], legacy_cw[CW_SIZE], legacy_parity[NPAR];
+	u32 erasures[CW_SIZE];
+
+	for (i=0; i<nb_tests; i++) {
+		GF_Err e;
+		u32 nb_err, nb_eras, nb_fixed;
+		s32 legacy_res;
+		for (j=0; j<ADT_COLS; j++) ref[j] = rand_u32();
+		gf_rs_encode(rs, ref, ADT_COLS, ref + ADT_COLS);
+		legacy_rs_encode(ref, ADT_COLS, legacy_parity);
+		if (memcmp(legacy_parity, ref + ADT_COLS, NPAR)) {
+			nb_failed++;
+			fprintf(stderr, "Codeword %d parity differs from the previous encoder\n", i);
+		}
+		memcpy(cw, ref, CW_SIZE);
+
+		/*cover up to twice the capacity*/
+		nb_eras = (rand_u32() % 3) ? 0 : rand_u32() % (NPAR + 1);
+		nb_err = rand_u32() % (NPAR - MIN(nb_eras, NPAR/2) + 1);
+		corrupt(cw, nb_err, nb_eras, erasures);
+		memcpy(legacy_cw, cw, CW_SIZE);
+
+		e = gf_rs_decode(rs, cw, CW_SIZE, erasures, nb_eras, &nb_fixed);
+		legacy_res = legacy_rs_decode(legacy_cw, CW_SIZE, erasures, nb_eras);
+
+		if (!memcmp(cw, legacy_cw, CW_SIZE) && ((e==GF_OK) == (legacy_res>=0))) {
+			nb_same++;
+		} else if (2*nb_err + nb_eras <= NPAR) {
+			nb_failed++;
+			fprintf(stderr, "Codeword %d with %d errors and %d erasures decoded differently by the previous decoder\n", i, nb_err, nb_eras);
+		} else if (legacy_res<0) {
+			nb_legacy_detected++;
+		} else {
+			/*the previous decoder did not check its result and may return a codeword with non-zero syndromes*/
+			u8 check[NPAR];
+			legacy_rs_encode(legacy_cw, ADT_COLS, check);
+			if (memcmp(check, legacy_cw + ADT_COLS, NPAR)) nb_legacy_invalid++;
+			else nb_legacy_other++;
+		}
+
+		if (2*nb_err + nb_eras <= NPAR) {
+			if ((e==GF_OK) && !memcmp(cw, ref, CW_SIZE)) nb_ok++;
+			else {
+				nb_failed++;
+				fprintf(stderr, "Codeword %d with %d errors and %d erasures not corrected: %s\n", i, nb_err, nb_eras, gf_error_to_string(e));
+			}
+		} else if (e==GF_OK) {
+			/*beyond capacity, the only acceptable success is landing on another codeword*/
+			u8 check[NPAR];
+			gf_rs_encode(rs, cw, ADT_COLS, check);
+			if (memcmp(check, cw + ADT_COLS, NPAR)) {
+				nb_failed++;
+				fprintf(stderr, "Codeword %d with %d errors and %d erasures decoded to an invalid codeword\n", i, nb_err, nb_eras);
+			} else {
+				nb_miscorrected++;
+			}
+		} else {
+			if (memcmp(cw, ref, CW_SIZE) == 0) nb_failed++;
+			nb_detected++;
+		}
+	}
+	fprintf(stdout, "%d random codewords: %d corrected, %d beyond capacity detected, %d beyond capacity decoded to another codeword, %d failures\n",
+	        nb_tests, nb_ok, nb_detected, nb_miscorrected, nb_failed);
+	fprintf(stdout, "previous decoder: %d identical results - beyond capacity, %d only detected by it, %d decoded by it to an invalid codeword, %d to another codeword\n",
+	        nb_same, nb_legacy_detected, nb_legacy_invalid, nb_legacy_other);
+	return nb_failed ? GF_FALSE : GF_TRUE;
+}
+
+typedef struct
+{
+	GF_RSCodec *rs;
+	u8 *frame;
+	u8 *ref;
+	u32 nb_err;
+	Bool ok;
+} StreamCtx;
+
+static void build_frame(StreamCtx *st)
+{
+	u32 i, j;
+	for (i=0; i<FRAME_ROWS; i++) {
+		u8 *row = st->ref + i*CW_SIZE;
+		for (j=0; j<ADT_COLS; j++) row[j] = rand_u32();
+		gf_rs_encode(st->rs, row, ADT_COLS, row + ADT_COLS);
+	}
+}
+
+static void corrupt_frame(StreamCtx *st)
+{
+	u32 i, erasures[CW_SIZE];
+	memcpy(st->frame, st->ref, FRAME_ROWS*CW_SIZE);
+	for (i=0; i<FRAME_ROWS; i++) corrupt(st->frame + i*CW_SIZE, st->nb_err, 0, erasures);
+}
+
+static GF_Err decode_frame(void *udta)
+{
+	u32 i;
+	StreamCtx *st = (StreamCtx *)udta;
+	st->ok = GF_TRUE;
+	for (i=0; i<FRAME_ROWS; i++) {
+		if (gf_rs_decode(st->rs, st->frame + i*CW_SIZE, CW_SIZE, NULL, 0, NULL) != GF_OK) st->ok = GF_FALSE;
+	}
+	if (memcmp(st->frame, st->ref, FRAME_ROWS*CW_SIZE)) st->ok = GF_FALSE;
+	return GF_OK;
+}
+
+/*decodes the same corrupted frame with the previous codec, which must produce the same rows*/
+static Bool decode_frame_legacy(StreamCtx *st, u8 *frame)
+{
+	u32 i;
+	for (i=0; i<FRAME_ROWS; i++) {
+		legacy_rs_decode(frame + i*CW_SIZE, CW_SIZE, NULL, 0);
+	}
+	return memcmp(frame, st->frame, FRAME_ROWS*CW_SIZE) ? GF_FALSE : GF_TRUE;
+}
+
+static void alloc_stream(StreamCtx *st, u32 nb_err)
+{
+	memset(st, 0, sizeof(StreamCtx));
+	st->rs = gf_rs_new(NPAR);
+	st->frame = (u8 *)gf_malloc(FRAME_ROWS*CW_SIZE);
+	st->ref = (u8 *)gf_malloc(FRAME_ROWS*CW_SIZE);
+	st->nb_err = nb_err;
+	build_frame(st);
+}
+
+static void free_stream(StreamCtx *st)
+{
+	gf_rs_del(st->rs);
+	gf_free(st->frame);
+	gf_free(st->ref);
+}
+
+static u32 nb_err_tests[] = {0, 1, 4, 16, 32};
+
+int main(int argc, char **argv)
+{
+	u32 i, j, nb_tests = 20000, nb_streams = 4;
+	Bool ok;
+	GF_RSCodec *rs;
+	GF_ThreadPool *pool;
+	StreamCtx *streams;
+	StreamCtx st;
+	u8 *legacy_frame;
+
+	if (argc > 1) nb_tests = atoi(argv[1]);
+	if (argc > 2) nb_streams = atoi(argv[2]);
+	if (!nb_streams) {
+		fprintf(stderr, "usage: rsbench [nb_random_codewords [nb_streams]]\n");
+		return 1;
+	}
+
+	gf_sys_init(GF_FALSE);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_QUIET);
+	legacy_rs_init();
+
+	rs = gf_rs_new(NPAR);
+	ok = check_random_codewords(rs, nb_tests);
+	gf_rs_del(rs);
+
+	fprintf(stdout, "\nMPE-FEC frame of %d rows, RS(%d,%d)\n", FRAME_ROWS, CW_SIZE, ADT_COLS);
+	fprintf(stdout, "%-16s %12s %12s %16s\n", "errors per row", "frame ms", "MB/s", "previous ms");
+	legacy_frame = (u8 *)gf_malloc(FRAME_ROWS*CW_SIZE);
+	for (i=0; i<sizeof(nb_err_tests)/sizeof(u32); i++) {
+		u64 start, legacy_time;
+		Bool legacy_ok;
+		alloc_stream(&st, nb_err_tests[i]);
+		corrupt_frame(&st);
+		memcpy(legacy_frame, st.frame, FRAME_ROWS*CW_SIZE);
+		start = gf_sys_clock_high_res();
+		decode_frame(&st);
+		start = gf_sys_clock_high_res() - start;
+		legacy_time = gf_sys_clock_high_res();
+		legacy_ok = decode_frame_legacy(&st, legacy_frame);
+		legacy_time = gf_sys_clock_high_res() - legacy_time;
+		fprintf(stdout, "%-16d %12.2f %12.2f %16.2f%s%s\n", st.nb_err, (Double) start / 1000, start ? (Double) FRAME_ROWS*CW_SIZE / start : 0,
+		        (Double) legacy_time / 1000, st.ok ? "" : " - DECODING FAILED", legacy_ok ? "" : " - DIFFERS FROM PREVIOUS DECODER");
+		if (!st.ok || !legacy_ok) ok = GF_FALSE;
+		free_stream(&st);
+	}
+	gf_free(legacy_frame);
+
+	/*one codec per stream, all streams decoded at once*/
+	pool = gf_th_pool_new("RSDecode", nb_streams);
+	streams = (StreamCtx *)gf_malloc(sizeof(StreamCtx) * nb_streams);
+	if (pool && streams) {
+		u64 start;
+		Bool streams_ok = GF_TRUE;
+		GF_ThreadTask **tasks = (GF_ThreadTask **)gf_malloc(sizeof(GF_ThreadTask *) * nb_streams);
+		for (i=0; i<nb_streams; i++) {
+			alloc_stream(&streams[i], 16);
+			corrupt_frame(&streams[i]);
+		}
+		start = gf_sys_clock_high_res();
+		for (i=0; i<nb_streams; i++) tasks[i] = gf_th_pool_submit(pool, decode_frame, &streams[i]);
+		for (i=0; i<nb_streams; i++) gf_th_pool_wait(pool, tasks[i]);
+		start = gf_sys_clock_high_res() - start;
+		for (j=0; j<nb_streams; j++) {
+			if (!streams[j].ok) streams_ok = GF_FALSE;
+			free_stream(&streams[j]);
+		}
+		fprintf(stdout, "\n%d streams with 16 errors per row decoded in parallel: %.2f ms - %.2f MB/s%s\n", nb_streams, (Double) start / 1000,
+		        start ? (Double) nb_streams*FRAME_ROWS*CW_SIZE / start : 0, streams_ok ? "" : " - DECODING FAILED");
+		if (!streams_ok) ok = GF_FALSE;
+		gf_free(tasks);
+	}
+	if (streams) gf_free(streams);
+	if (pool) gf_th_pool_del(pool);
+
+	gf_sys_close();
+	return ok ? 0 : 1;
+}
+
+#else
+
+int main(int argc, char **argv)
+{
+	fprintf(stderr, "GPAC was compiled without DVB MPE support (use --enable-dvbx)\n");
+	return 1;
+}
+
+#endif
@@ -0,0 +1,42 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / Reed-Solomon benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#ifndef _RS_LEGACY_H_
+#define _RS_LEGACY_H_
+
+#include <gpac/tools.h>
+
+/*previous global Reed-Solomon codec of GPAC (Henry Minsky's), kept as the reference for GF_RSCodec.
+It is not reentrant: only call it from one thread*/
+
+/*initializes the tables, must be called once before any other function*/
+void legacy_rs_init();
+/*computes the NPAR parity bytes of msg*/
+void legacy_rs_encode(u8 *msg, u32 msg_size, u8 *parity);
+/*decodes the codeword in place, erasures being given as byte positions in the codeword. Returns 0 if
+no error was found, 1 if the codeword was corrected and -1 if it was reported as uncorrectable*/
+s32 legacy_rs_decode(u8 *codeword, u32 csize, u32 *erasures, u32 nb_erasures);
+
+#endif //_RS_LEGACY_H_
@@ -0,0 +1,137 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / RTP batched reception test application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*sends RTP packets on loopback with some out-of-order bursts, and checks they are received
+in order through gf_rtp_read_rtp, with and without batched reception*/
+
+#include <gpac/ietf.h>
+
+#define RTP_PCK_SIZE	1328
+#define RECV_PORT	7500
+#define SEND_PORT	7510
+
+static void write_rtp_header(char *pck, u16 seq_num)
+{
+	memset(pck, 0, RTP_PCK_SIZE);
+	pck[0] = (char) 0x80;
+	pck[1] = 33;
+	pck[2] = (seq_num>>8) & 0xFF;
+	pck[3] = seq_num & 0xFF;
+}
+
+static u32 run_test(u32 nb_pck, u32 batch_size, u32 reorder_size)
+{
+	GF_RTSPTransport trans;
+	GF_RTPChannel *ch;
+	GF_Socket *sender;
+	char pck[RTP_PCK_SIZE];
+	char buffer[RTP_PCK_SIZE];
+	u32 i, sent, received, errors, nb_batches, nb_batch_pck, nb_reordered, nb_dropped;
+	u16 expected;
+	u64 start, end;
+	GF_Err e;
+
+	memset(&trans, 0, sizeof(GF_RTSPTransport));
+	trans.Profile = GF_RTSP_PROFILE_RTP_AVP;
+	trans.IsUnicast = GF_TRUE;
+	trans.source = "127.0.0.1";
+	trans.port_first = SEND_PORT;
+	trans.port_last = SEND_PORT+1;
+	trans.client_port_first = RECV_PORT;
+	trans.client_port_last = RECV_PORT+1;
+
+	ch = gf_rtp_new();
+	gf_rtp_setup_transport(ch, &trans, NULL);
+	e = gf_rtp_initialize(ch, 0x100000, GF_FALSE, 0, reorder_size, 200, NULL);
+	if (e) {
+		fprintf(stderr, "Cannot setup RTP channel: %s\n", gf_error_to_string(e));
+		gf_rtp_del(ch);
+		return 1;
+	}
+	gf_rtp_set_receive_batch(ch, batch_size, 0);
+
+	sender = gf_sk_new(GF_SOCK_TYPE_UDP);
+	e = gf_sk_bind(sender, "127.0.0.1", SEND_PORT, "127.0.0.1", RECV_PORT, GF_SOCK_REUSE_PORT);
+	if (e) {
+		fprintf(stderr, "Cannot setup sender socket: %s\n", gf_error_to_string(e));
+		gf_sk_del(sender);
+		gf_rtp_del(ch);
+		return 1;
+	}
+
+	sent = received = errors = 0;
+	expected = 1;
+	start = gf_sys_clock_high_res();
+	while (received < nb_pck) {
+		/*send by bursts of 32 packets, swapping packets 4k+1 and 4k+2 in each burst*/
+		for (i=0; (i<32) && (sent<nb_pck); i++) {
+			u16 sn = sent + 1;
+			if ((sent%4==1) && (sent+1<nb_pck)) sn++;
+			else if ((sent%4==2)) sn--;
+			write_rtp_header(pck, sn);
+			if (gf_sk_send(sender, pck, RTP_PCK_SIZE) == GF_OK) sent++;
+		}
+		while (1) {
+			u32 size = gf_rtp_read_rtp(ch, buffer, RTP_PCK_SIZE);
+			u16 sn;
+			if (!size) break;
+			sn = ((buffer[2] << 8) & 0xFF00) | (buffer[3] & 0xFF);
+			if (sn != expected) errors++;
+			expected = sn+1;
+			received++;
+		}
+		/*all sent, flush reorderer*/
+		if ((sent==nb_pck) && (received<nb_pck)) {
+			gf_sleep(1);
+			if (gf_sys_clock_high_res() - start > 10000000) break;
+		}
+	}
+	end = gf_sys_clock_high_res();
+
+	gf_rtp_get_receive_stats(ch, &nb_batches, &nb_batch_pck, &nb_reordered, &nb_dropped);
+	fprintf(stderr, "batch %d reorder %d: %d/%d packets received in "LLU" us - %d sequence breaks - %d batches (%d packets) - %d reordered - %d dropped\n",
+	        batch_size, reorder_size, received, nb_pck, end-start, errors, nb_batches, nb_batch_pck, nb_reordered, nb_dropped);
+
+	gf_sk_del(sender);
+	gf_rtp_del(ch);
+	return (received==nb_pck) && (!reorder_size || !errors) ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+	u32 ret = 0;
+	u32 nb_pck = 100000;
+	if (argc>1) nb_pck = atoi(argv[1]);
+
+	gf_sys_init(GF_FALSE);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+
+	ret |= run_test(nb_pck, 0, 10);
+	ret |= run_test(nb_pck, 32, 10);
+	ret |= run_test(nb_pck, 64, 0);
+
+	gf_sys_close();
+	return ret;
+}
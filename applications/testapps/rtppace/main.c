@@ -0,0 +1,177 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / RTP batched and paced emission test application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*sends several RTP sessions on loopback by bursts of packets (one burst per frame), with regular,
+batched and batched+paced emission, and reports throughput, number of send calls and inter-packet jitter
+measured by a receiver thread*/
+
+#include <gpac/ietf.h>
+#include <gpac/thread.h>
+#include <gpac/internal/ietf_dev.h>
+#include <math.h>
+
+#define PAYLOAD_SIZE	1400
+#define BASE_PORT	7600
+#define MAX_SESSIONS	64
+
+typedef struct
+{
+	GF_Socket *sock;
+	u32 nb_received, nb_expected;
+	u64 last_time, sum_gap, sum_gap_sq, max_gap;
+	volatile Bool done;
+} Receiver;
+
+static u32 receiver_run(void *par)
+{
+	Receiver *rcv = (Receiver *)par;
+	char buffer[2048];
+	while (!rcv->done && (rcv->nb_received < rcv->nb_expected)) {
+		u32 size;
+		u64 now, gap;
+		GF_Err e = gf_sk_receive(rcv->sock, buffer, 2048, 0, &size);
+		if (e || !size) continue;
+		now = gf_sys_clock_high_res();
+		if (rcv->nb_received) {
+			gap = now - rcv->last_time;
+			rcv->sum_gap += gap;
+			rcv->sum_gap_sq += gap*gap;
+			if (gap > rcv->max_gap) rcv->max_gap = gap;
+		}
+		rcv->last_time = now;
+		rcv->nb_received++;
+	}
+	return 0;
+}
+
+static void run_test(const char *name, u32 nb_sessions, u32 nb_frames, u32 pck_per_frame, u32 fps, u32 batch, u32 pacing_us)
+{
+	GF_RTPChannel *chans[MAX_SESSIONS];
+	Receiver rcv;
+	GF_Thread *th;
+	GF_RTPHeader hdr;
+	char payload[PAYLOAD_SIZE];
+	u32 i, j, k, nb_calls, nb_batches, nb_pck;
+	u32 rate = PAYLOAD_SIZE * pck_per_frame * fps;
+	u64 start, end, frame_dur = 1000000 / fps;
+	Double mean, var;
+
+	memset(&rcv, 0, sizeof(Receiver));
+	memset(payload, 0, PAYLOAD_SIZE);
+	rcv.nb_expected = nb_sessions * nb_frames * pck_per_frame;
+	rcv.sock = gf_sk_new(GF_SOCK_TYPE_UDP);
+	gf_sk_bind(rcv.sock, "127.0.0.1", BASE_PORT, NULL, 0, GF_SOCK_REUSE_PORT);
+	gf_sk_set_buffer_size(rcv.sock, GF_FALSE, 0x1000000);
+
+	for (i=0; i<nb_sessions; i++) {
+		GF_RTSPTransport tr;
+		memset(&tr, 0, sizeof(GF_RTSPTransport));
+		tr.Profile = GF_RTSP_PROFILE_RTP_AVP;
+		tr.IsUnicast = GF_TRUE;
+		tr.destination = "127.0.0.1";
+		tr.source = "127.0.0.1";
+		tr.port_first = BASE_PORT + 2 + 2*i;
+		tr.port_last = tr.port_first + 1;
+		tr.client_port_first = BASE_PORT;
+		tr.client_port_last = BASE_PORT + 1;
+		chans[i] = gf_rtp_new();
+		gf_rtp_setup_transport(chans[i], &tr, NULL);
+		gf_rtp_initialize(chans[i], 0, GF_TRUE, PAYLOAD_SIZE + 12, 0, 0, NULL);
+		chans[i]->no_auto_rtcp = GF_TRUE;
+		/*pace at twice the stream rate*/
+		if (batch) gf_rtp_set_send_batch(chans[i], batch, pacing_us ? 2*rate : 0, (u32) ((u64) 2*rate * pacing_us / 1000000));
+	}
+
+	th = gf_th_new("receiver");
+	gf_th_run(th, receiver_run, &rcv);
+
+	memset(&hdr, 0, sizeof(GF_RTPHeader));
+	hdr.Version = 2;
+	hdr.PayloadType = 96;
+	nb_calls = 0;
+	start = gf_sys_clock_high_res();
+	for (k=0; k<nb_frames; k++) {
+		/*wait for frame time, sending paced packets meanwhile*/
+		while (gf_sys_clock_high_res() - start < k*frame_dur) {
+			if (batch && pacing_us) {
+				for (i=0; i<nb_sessions; i++) gf_rtp_flush_packets(chans[i], GF_FALSE);
+			}
+			gf_sleep(0);
+		}
+		for (i=0; i<nb_sessions; i++) {
+			for (j=0; j<pck_per_frame; j++) {
+				hdr.SequenceNumber++;
+				hdr.Marker = (j+1==pck_per_frame) ? 1 : 0;
+				gf_rtp_send_packet(chans[i], &hdr, payload, PAYLOAD_SIZE, GF_FALSE);
+				if (!batch) nb_calls++;
+			}
+			if (batch) gf_rtp_flush_packets(chans[i], GF_FALSE);
+		}
+	}
+	for (i=0; i<nb_sessions; i++) {
+		gf_rtp_flush_packets(chans[i], GF_TRUE);
+		gf_rtp_get_send_stats(chans[i], &nb_batches, &nb_pck, NULL);
+		nb_calls += nb_batches;
+	}
+	end = gf_sys_clock_high_res();
+
+	/*let the receiver drain*/
+	for (i=0; (i<1000) && (rcv.nb_received < rcv.nb_expected); i++) gf_sleep(1);
+	rcv.done = GF_TRUE;
+	gf_th_del(th);
+
+	mean = var = 0;
+	if (rcv.nb_received > 1) {
+		mean = (Double) rcv.sum_gap / (rcv.nb_received-1);
+		var = (Double) rcv.sum_gap_sq / (rcv.nb_received-1) - mean*mean;
+	}
+	fprintf(stdout, "%-16s %4d sessions: %8d/%8d packets in %6d ms - %8.2f Mbps - %8d send calls - gap mean %6.1f us stddev %8.1f us max "LLU" us\n",
+	        name, nb_sessions, rcv.nb_received, rcv.nb_expected, (u32) ((end-start)/1000),
+	        8.0 * rcv.nb_received * (PAYLOAD_SIZE+12) / (end-start),
+	        nb_calls, mean, sqrt(var > 0 ? var : 0), rcv.max_gap);
+
+	for (i=0; i<nb_sessions; i++) gf_rtp_del(chans[i]);
+	gf_sk_del(rcv.sock);
+}
+
+int main(int argc, char **argv)
+{
+	u32 i;
+	u32 sessions[] = {1, 8, 32};
+	u32 nb_frames = 250;
+
+	if (argc>1) nb_frames = atoi(argv[1]);
+
+	gf_sys_init(GF_FALSE);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+
+	for (i=0; i<3; i++) {
+		run_test("regular", sessions[i], nb_frames, 8, 50, 0, 0);
+		run_test("batch", sessions[i], nb_frames, 8, 50, 32, 0);
+		run_test("batch+pacing", sessions[i], nb_frames, 8, 50, 32, 2000);
+	}
+	gf_sys_close();
+	return 0;
+}
@@ -0,0 +1,261 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / SHA-1 benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*checks and measures the SHA-1 implementations available on this CPU:
+- known digests and random buffers hashed with random update sizes must give the same digest with all implementations,
+in single stream and multi-buffer mode
+- single stream throughput is measured by hashing a buffer repeatedly up to the requested size (2 GB by default)
+- multi-buffer throughput is measured on segments of 4 MB, as done when hashing segments while packaging
+- if a file is given, it is hashed with gf_sha1_file*/
+
+#include <gpac/tools.h>
+
+static const char *impl_names[] = {"auto", "C", "SHA-NI", "AVX2"};
+
+static u32 rand_state = 0x9E3779B9;
+
+static u32 rand_u32()
+{
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+	return rand_state;
+}
+
+static void to_hexa(u8 digest[GF_SHA1_DIGEST_SIZE], char *str)
+{
+	u32 i;
+	for (i=0; i<GF_SHA1_DIGEST_SIZE; i++) sprintf(str + 2*i, "%02x", digest[i]);
+}
+
+static Bool check_vectors()
+{
+	u32 i;
+	Bool ok = GF_TRUE;
+	char hexa[2*GF_SHA1_DIGEST_SIZE+1];
+	u8 digest[GF_SHA1_DIGEST_SIZE];
+	u8 *mil_a = (u8 *)gf_malloc(1000000);
+	GF_SHA1Context *ctx;
+
+	gf_sha1_csum((u8 *) "", 0, digest);
+	to_hexa(digest, hexa);
+	if (strcmp(hexa, "da39a3ee5e6b4b0d3255bfef95601890afd80709")) ok = GF_FALSE;
+
+	gf_sha1_csum((u8 *) "abc", 3, digest);
+	to_hexa(digest, hexa);
+	if (strcmp(hexa, "a9993e364706816aba3e25717850c26c9cd0d89d")) ok = GF_FALSE;
+
+	gf_sha1_csum((u8 *) "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 56, digest);
+	to_hexa(digest, hexa);
+	if (strcmp(hexa, "84983e441c3bd26ebaae4aa1f95129e5e54670f1")) ok = GF_FALSE;
+
+	memset(mil_a, 'a', 1000000);
+	ctx = gf_sha1_starts();
+	for (i=0; i<1000; i++) gf_sha1_update(ctx, mil_a + i*1000, 1000);
+	gf_sha1_finish(ctx, digest);
+	to_hexa(digest, hexa);
+	if (strcmp(hexa, "34aa973cd4c4daa4f61eeb2bdbad27316534016f")) ok = GF_FALSE;
+
+	gf_free(mil_a);
+	return ok;
+}
+
+#define NB_STREAMS	13
+
+/*hashes the random buffers in single stream mode and in multi-buffer mode, with random update sizes*/
+static Bool check_random_buffers(u8 *data, u32 max_size, u8 (*ref)[GF_SHA1_DIGEST_SIZE], Bool set_ref)
+{
+	u32 i, nb_done;
+	u8 *bufs[NB_STREAMS];
+	u32 sizes[NB_STREAMS], pos[NB_STREAMS];
+	u8 digests[NB_STREAMS][GF_SHA1_DIGEST_SIZE];
+	GF_SHA1MultiContext *mctx;
+	Bool ok = GF_TRUE;
+
+	rand_state = 0x9E3779B9;
+	for (i=0; i<NB_STREAMS; i++) {
+		u32 offset = rand_u32() % max_size;
+		sizes[i] = rand_u32() % (max_size - offset);
+		/*some streams of identical sizes, some empty*/
+		if (i%4==1) sizes[i] = sizes[i-1];
+		if (i==5) sizes[i] = 0;
+		bufs[i] = data + offset;
+		pos[i] = 0;
+	}
+
+	for (i=0; i<NB_STREAMS; i++) {
+		u32 done = 0;
+		GF_SHA1Context *ctx = gf_sha1_starts();
+		while (done < sizes[i]) {
+			u32 len = rand_u32() % 3000;
+			len = MIN(len, sizes[i] - done);
+			gf_sha1_update(ctx, bufs[i] + done, len);
+			done += len;
+		}
+		gf_sha1_finish(ctx, digests[i]);
+	}
+	for (i=0; i<NB_STREAMS; i++) {
+		u8 digest[GF_SHA1_DIGEST_SIZE];
+		gf_sha1_csum(bufs[i], sizes[i], digest);
+		if (memcmp(digest, digests[i], GF_SHA1_DIGEST_SIZE)) ok = GF_FALSE;
+	}
+	if (set_ref) memcpy(ref, digests, sizeof(digests));
+	else if (memcmp(ref, digests, sizeof(digests))) ok = GF_FALSE;
+
+	mctx = gf_sha1_multi_starts(NB_STREAMS);
+	nb_done = 0;
+	while (nb_done < NB_STREAMS) {
+		u8 *in[NB_STREAMS];
+		u32 lens[NB_STREAMS];
+		for (i=0; i<NB_STREAMS; i++) {
+			/*mostly large chunks so that streams have common blocks*/
+			u32 len = (rand_u32() % 4) ? 64*(rand_u32() % 300) : rand_u32() % 100;
+			len = MIN(len, sizes[i] - pos[i]);
+			in[i] = len ? bufs[i] + pos[i] : NULL;
+			lens[i] = len;
+			pos[i] += len;
+		}
+		gf_sha1_multi_update(mctx, in, lens);
+		nb_done = 0;
+		for (i=0; i<NB_STREAMS; i++) {
+			if (pos[i] == sizes[i]) nb_done++;
+		}
+	}
+	gf_sha1_multi_finish(mctx, digests);
+	if (memcmp(ref, digests, sizeof(digests))) ok = GF_FALSE;
+
+	gf_sha1_csum_multi(bufs, sizes, NB_STREAMS, digests);
+	if (memcmp(ref, digests, sizeof(digests))) ok = GF_FALSE;
+	return ok;
+}
+
+/*auto uses the best single stream and multi-buffer implementations, which may differ*/
+static GF_SHA1Impl bench_impls[] = {GF_SHA1_IMPL_C, GF_SHA1_IMPL_SHA_NI, GF_SHA1_IMPL_AVX2, GF_SHA1_IMPL_AUTO};
+
+#define BENCH_BUFFER_SIZE	(64*1024*1024)
+#define SEGMENT_SIZE		(4*1024*1024)
+
+int main(int argc, char **argv)
+{
+	u32 i, j, k, impl, nb_segments = 16;
+	u64 total_size = 2048;
+	u8 *data;
+	Bool ok = GF_TRUE;
+	u8 ref[NB_STREAMS][GF_SHA1_DIGEST_SIZE];
+	u8 ref_digest[GF_SHA1_DIGEST_SIZE];
+	const char *file = NULL;
+
+	if (argc > 1) total_size = atoi(argv[1]);
+	if (argc > 2) file = argv[2];
+	if (!total_size) {
+		fprintf(stderr, "usage: sha1bench [size_MB [file]]\n");
+		return 1;
+	}
+	total_size *= 1024*1024;
+
+	gf_sys_init(GF_FALSE);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_QUIET);
+
+	data = (u8 *)gf_malloc(BENCH_BUFFER_SIZE);
+	if (!data) {
+		fprintf(stderr, "Not enough memory\n");
+		gf_sys_close();
+		return 1;
+	}
+	for (i=0; i<BENCH_BUFFER_SIZE/4; i++) ((u32 *)data)[i] = rand_u32();
+
+	fprintf(stdout, "Default implementation: %s\n", impl_names[gf_sha1_get_implementation()]);
+	fprintf(stdout, "%-8s %8s %20s %20s\n", "impl", "checks", "single stream MB/s", "multi-buffer MB/s");
+	for (k=0; k<sizeof(bench_impls)/sizeof(GF_SHA1Impl); k++) {
+		Bool impl_ok;
+		u64 start, single_time, multi_time, done = 0;
+		GF_SHA1Context *ctx;
+		u8 digest[GF_SHA1_DIGEST_SIZE];
+		u8 *bufs[64];
+		u32 sizes[64];
+		u8 (*digests)[GF_SHA1_DIGEST_SIZE];
+
+		impl = bench_impls[k];
+		if (gf_sha1_set_implementation(impl) != GF_OK) {
+			fprintf(stdout, "%-8s not supported on this CPU\n", impl_names[impl]);
+			continue;
+		}
+		impl_ok = check_vectors();
+		if (!check_random_buffers(data, 100000, ref, (impl==GF_SHA1_IMPL_C) ? GF_TRUE : GF_FALSE)) impl_ok = GF_FALSE;
+
+		start = gf_sys_clock_high_res();
+		ctx = gf_sha1_starts();
+		while (done < total_size) {
+			u32 len = (u32) MIN(total_size - done, BENCH_BUFFER_SIZE);
+			gf_sha1_update(ctx, data, len);
+			done += len;
+		}
+		gf_sha1_finish(ctx, digest);
+		single_time = gf_sys_clock_high_res() - start;
+		if (impl==GF_SHA1_IMPL_C) memcpy(ref_digest, digest, GF_SHA1_DIGEST_SIZE);
+		else if (memcmp(ref_digest, digest, GF_SHA1_DIGEST_SIZE)) impl_ok = GF_FALSE;
+
+		/*segments of the benchmark buffer, hashed as many times as needed to reach the total size*/
+		digests = (u8 (*)[GF_SHA1_DIGEST_SIZE]) gf_malloc(GF_SHA1_DIGEST_SIZE * nb_segments);
+		for (j=0; j<nb_segments; j++) {
+			bufs[j] = data + j*SEGMENT_SIZE;
+			sizes[j] = SEGMENT_SIZE;
+		}
+		done = 0;
+		start = gf_sys_clock_high_res();
+		while (done < total_size) {
+			gf_sha1_csum_multi(bufs, sizes, nb_segments, digests);
+			done += nb_segments * SEGMENT_SIZE;
+		}
+		multi_time = gf_sys_clock_high_res() - start;
+		for (j=0; j<nb_segments; j++) {
+			gf_sha1_csum(bufs[j], sizes[j], digest);
+			if (memcmp(digest, digests[j], GF_SHA1_DIGEST_SIZE)) impl_ok = GF_FALSE;
+		}
+		gf_free(digests);
+
+		fprintf(stdout, "%-8s %8s %20.1f %20.1f\n", impl_names[impl], impl_ok ? "OK" : "FAILED",
+		        single_time ? (Double) total_size / single_time : 0, multi_time ? (Double) done / multi_time : 0);
+		if (!impl_ok) ok = GF_FALSE;
+	}
+	gf_sha1_set_implementation(GF_SHA1_IMPL_AUTO);
+	gf_free(data);
+
+	if (file) {
+		u64 start = gf_sys_clock_high_res();
+		u8 digest[GF_SHA1_DIGEST_SIZE];
+		char hexa[2*GF_SHA1_DIGEST_SIZE+1];
+		if (gf_sha1_file(file, digest)) {
+			fprintf(stderr, "Cannot hash %s\n", file);
+			ok = GF_FALSE;
+		} else {
+			to_hexa(digest, hexa);
+			fprintf(stdout, "\n%s  %s - %.2f s\n", hexa, file, (Double) (gf_sys_clock_high_res() - start) / 1000000);
+		}
+	}
+
+	gf_sys_close();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,375 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / socket group benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*watches 10, 100 and 1000 UDP sockets on the loopback interface, using a socket group and using a select() call
+rebuilding its descriptor set at each wait as done by socket groups without epoll. For each mode, three measures are
+made:
+- wakeup: a thread sends datagrams to random sockets while the receiver is blocked waiting on all sockets, the latency
+is the time between sending and reading the datagram.
+- idle: one datagram is sent to a random socket then the receiver waits and locates the ready socket, most sockets
+are idle. This is the receiver cost of each wakeup.
+- active: one datagram is sent to each socket, then the receiver waits and reads ready sockets until all datagrams
+are received.*/
+
+#include <gpac/network.h>
+#include <gpac/thread.h>
+
+#ifdef WIN32
+#include <winsock2.h>
+#else
+#include <sys/select.h>
+#endif
+
+#define BASE_PORT	12000
+#define NB_WAKEUPS	2000
+
+static u32 nb_socks_tests[] = {10, 100, 1000};
+
+/*exported by libgpac but not declared in network.h*/
+GF_Err gf_sk_send_to(GF_Socket *sock, const char *buffer, u32 length, char *remoteHost, u16 remotePort);
+
+typedef struct
+{
+	u32 nb_socks;
+	GF_Socket **rcv, **snd;
+	GF_SockGroup *group;
+	Bool use_group;
+
+	/*wakeup test*/
+	volatile u32 nb_sent;
+	volatile Bool sender_done;
+} BenchCtx;
+
+/*waits for ready sockets, returns their number and stores the index of the first max_ready ones*/
+static u32 wait_ready(BenchCtx *ctx, u32 usec_wait, u32 *ready_idx, u32 max_ready)
+{
+	u32 i, nb_ready = 0;
+
+	if (ctx->use_group) {
+		if (gf_sk_group_select(ctx->group, usec_wait) != GF_OK) return 0;
+		for (i=0; i<ctx->nb_socks; i++) {
+			if (gf_sk_group_sock_is_set(ctx->group, ctx->rcv[i])) {
+				if (nb_ready < max_ready) ready_idx[nb_ready++] = i;
+			}
+		}
+	} else {
+		fd_set group;
+		struct timeval timeout;
+		s32 max_fd = 0;
+		FD_ZERO(&group);
+		for (i=0; i<ctx->nb_socks; i++) {
+			s32 fd = gf_sk_get_handle(ctx->rcv[i]);
+			FD_SET(fd, &group);
+			if (max_fd < fd) max_fd = fd;
+		}
+		timeout.tv_sec = usec_wait / 1000000;
+		timeout.tv_usec = usec_wait % 1000000;
+		if (select(max_fd+1, &group, NULL, NULL, &timeout) <= 0) return 0;
+		for (i=0; i<ctx->nb_socks; i++) {
+			if (FD_ISSET(gf_sk_get_handle(ctx->rcv[i]), &group)) {
+				if (nb_ready < max_ready) ready_idx[nb_ready++] = i;
+			}
+		}
+	}
+	return nb_ready;
+}
+
+static u32 sender_proc(void *par)
+{
+	u32 i;
+	BenchCtx *ctx = (BenchCtx *)par;
+	for (i=0; i<NB_WAKEUPS; i++) {
+		u64 now;
+		/*let the receiver go back to wait*/
+		gf_sleep(1);
+		now = gf_sys_clock_high_res();
+		gf_sk_send(ctx->snd[gf_rand() % ctx->nb_socks], (char *) &now, sizeof(u64));
+		ctx->nb_sent++;
+	}
+	ctx->sender_done = GF_TRUE;
+	return 0;
+}
+
+static Bool open_sockets(BenchCtx *ctx, u32 nb_socks)
+{
+	u32 i;
+	memset(ctx, 0, sizeof(BenchCtx));
+	ctx->nb_socks = nb_socks;
+	ctx->rcv = (GF_Socket **)gf_malloc(sizeof(GF_Socket *) * nb_socks);
+	ctx->snd = (GF_Socket **)gf_malloc(sizeof(GF_Socket *) * nb_socks);
+	memset(ctx->rcv, 0, sizeof(GF_Socket *) * nb_socks);
+	memset(ctx->snd, 0, sizeof(GF_Socket *) * nb_socks);
+	ctx->group = gf_sk_group_new();
+	/*receivers are created first so that their descriptors are below FD_SETSIZE*/
+	for (i=0; i<nb_socks; i++) {
+		ctx->rcv[i] = gf_sk_new(GF_SOCK_TYPE_UDP);
+		if (!ctx->rcv[i] || gf_sk_bind(ctx->rcv[i], "127.0.0.1", BASE_PORT+i, NULL, 0, 0)) return GF_FALSE;
+		gf_sk_set_block_mode(ctx->rcv[i], GF_TRUE);
+		gf_sk_group_register(ctx->group, ctx->rcv[i]);
+	}
+	for (i=0; i<nb_socks; i++) {
+		ctx->snd[i] = gf_sk_new(GF_SOCK_TYPE_UDP);
+		if (!ctx->snd[i] || gf_sk_connect(ctx->snd[i], "127.0.0.1", BASE_PORT+i, NULL)) return GF_FALSE;
+	}
+	return GF_TRUE;
+}
+
+static void close_sockets(BenchCtx *ctx)
+{
+	u32 i;
+	for (i=0; i<ctx->nb_socks; i++) {
+		if (ctx->rcv[i]) {
+			gf_sk_group_unregister(ctx->group, ctx->rcv[i]);
+			gf_sk_del(ctx->rcv[i]);
+		}
+		if (ctx->snd[i]) gf_sk_del(ctx->snd[i]);
+	}
+	gf_sk_group_del(ctx->group);
+	gf_free(ctx->rcv);
+	gf_free(ctx->snd);
+}
+
+static Bool read_socket(BenchCtx *ctx, u32 idx, u64 *data)
+{
+	u32 read;
+	if (gf_sk_receive_no_select(ctx->rcv[idx], (char *) data, sizeof(u64), 0, &read) != GF_OK) return GF_FALSE;
+	return (read == sizeof(u64)) ? GF_TRUE : GF_FALSE;
+}
+
+static Double bench_wakeup(BenchCtx *ctx)
+{
+	u32 nb_recv = 0;
+	u64 total = 0;
+	GF_Thread *th = gf_th_new("sender");
+
+	ctx->nb_sent = 0;
+	ctx->sender_done = GF_FALSE;
+	gf_th_run(th, sender_proc, ctx);
+	while (!ctx->sender_done || (nb_recv < ctx->nb_sent)) {
+		u32 idx;
+		u64 sent;
+		if (!wait_ready(ctx, 100000, &idx, 1)) continue;
+		if (!read_socket(ctx, idx, &sent)) continue;
+		total += gf_sys_clock_high_res() - sent;
+		nb_recv++;
+	}
+	gf_th_del(th);
+	return nb_recv ? (Double) total / nb_recv : 0;
+}
+
+static Double bench_idle(BenchCtx *ctx, u32 nb_iter)
+{
+	u32 i, idx;
+	u64 data = 0, start, total = 0;
+	for (i=0; i<nb_iter; i++) {
+		u32 target = gf_rand() % ctx->nb_socks;
+		gf_sk_send(ctx->snd[target], (char *) &data, sizeof(u64));
+		start = gf_sys_clock_high_res();
+		if ((wait_ready(ctx, 100000, &idx, 1) != 1) || (idx != target)) return -1;
+		total += gf_sys_clock_high_res() - start;
+		read_socket(ctx, idx, &data);
+	}
+	return (Double) total / nb_iter;
+}
+
+static Double bench_active(BenchCtx *ctx, u32 nb_iter)
+{
+	u32 i, j, nb_recv;
+	u64 data = 0, start, total = 0;
+	u32 *ready = (u32 *)gf_malloc(sizeof(u32) * ctx->nb_socks);
+	for (i=0; i<nb_iter; i++) {
+		for (j=0; j<ctx->nb_socks; j++) gf_sk_send(ctx->snd[j], (char *) &data, sizeof(u64));
+		nb_recv = 0;
+		start = gf_sys_clock_high_res();
+		while (nb_recv < ctx->nb_socks) {
+			u32 nb_ready = wait_ready(ctx, 100000, ready, ctx->nb_socks);
+			if (!nb_ready) {
+				gf_free(ready);
+				return -1;
+			}
+			for (j=0; j<nb_ready; j++) {
+				if (read_socket(ctx, ready[j], &data)) nb_recv++;
+			}
+		}
+		total += gf_sys_clock_high_res() - start;
+	}
+	gf_free(ready);
+	return (Double) total / nb_iter / ctx->nb_socks;
+}
+
+/*a socket watched by two groups shall be seen by both after its descriptor is reopened, and shall be removed
+from both when deleted while still registered, as done when tearing down ATSC sessions*/
+static Bool check_lifecycle()
+{
+	u16 port;
+	u32 family;
+	u64 data = 0;
+	Bool ok = GF_TRUE;
+	GF_SockGroup *g1 = gf_sk_group_new();
+	GF_SockGroup *g2 = gf_sk_group_new();
+	GF_Socket *peer = gf_sk_new(GF_SOCK_TYPE_UDP);
+	GF_Socket *sk = gf_sk_new(GF_SOCK_TYPE_UDP);
+
+	if (gf_sk_bind(peer, "127.0.0.1", BASE_PORT, NULL, 0, 0)) ok = GF_FALSE;
+	/*registered before having a descriptor*/
+	gf_sk_group_register(g1, sk);
+	gf_sk_group_register(g2, sk);
+	if (gf_sk_bind(sk, "127.0.0.1", BASE_PORT+1, NULL, 0, 0)) ok = GF_FALSE;
+	/*both groups now watch the descriptor*/
+	gf_sk_group_select(g1, 1000);
+	gf_sk_group_select(g2, 1000);
+	/*connecting closes the descriptor and opens a new one*/
+	if (gf_sk_connect(sk, "127.0.0.1", BASE_PORT, NULL)) ok = GF_FALSE;
+	if (gf_sk_get_local_info(sk, &port, &family)) ok = GF_FALSE;
+	if (ok) gf_sk_send_to(peer, (char *) &data, sizeof(u64), "127.0.0.1", port);
+
+	if ((gf_sk_group_select(g1, 100000) != GF_OK) || !gf_sk_group_sock_is_set(g1, sk)) {
+		fprintf(stderr, "Reopened socket not seen by its first group\n");
+		ok = GF_FALSE;
+	}
+	if ((gf_sk_group_select(g2, 100000) != GF_OK) || !gf_sk_group_sock_is_set(g2, sk)) {
+		fprintf(stderr, "Reopened socket not seen by its second group\n");
+		ok = GF_FALSE;
+	}
+
+	/*deleted while registered and ready, groups are used and destroyed afterwards*/
+	gf_sk_del(sk);
+	gf_sk_send_to(peer, (char *) &data, sizeof(u64), "127.0.0.1", BASE_PORT+1);
+	if (gf_sk_group_select(g1, 1000) != GF_IP_NETWORK_EMPTY) {
+		fprintf(stderr, "Deleted socket still watched by its first group\n");
+		ok = GF_FALSE;
+	}
+	gf_sk_group_del(g1);
+	gf_sk_group_select(g2, 1000);
+	gf_sk_group_del(g2);
+
+	/*group destroyed before its sockets*/
+	g1 = gf_sk_group_new();
+	sk = gf_sk_new(GF_SOCK_TYPE_UDP);
+	gf_sk_group_register(g1, sk);
+	gf_sk_group_del(g1);
+	gf_sk_bind(sk, "127.0.0.1", BASE_PORT+1, NULL, 0, 0);
+	gf_sk_del(sk);
+
+	gf_sk_del(peer);
+	return ok;
+}
+
+static u32 deleter_proc(void *par)
+{
+	u32 i;
+	BenchCtx *ctx = (BenchCtx *)par;
+	for (i=0; i<ctx->nb_socks; i++) {
+		GF_Socket *sk = ctx->rcv[i];
+		ctx->rcv[i] = NULL;
+		gf_sk_del(sk);
+		if (!(i%16)) gf_sleep(1);
+	}
+	ctx->sender_done = GF_TRUE;
+	return 0;
+}
+
+/*sockets deleted by another thread while the group is selected, as done by ATSC sessions torn down from the
+service thread: all sockets are kept ready, so that most selects report sockets being deleted*/
+static Bool check_concurrent_delete()
+{
+	u32 i, run, nb_selects = 0;
+	u64 data = 0;
+	Bool ok = GF_TRUE;
+	BenchCtx ctx;
+
+	for (run=0; run<20 && ok; run++) {
+		GF_Thread *th;
+		if (!open_sockets(&ctx, 256)) {
+			close_sockets(&ctx);
+			return GF_FALSE;
+		}
+		ctx.use_group = GF_TRUE;
+		for (i=0; i<ctx.nb_socks; i++) gf_sk_send(ctx.snd[i], (char *) &data, sizeof(u64));
+		/*wait for all datagrams*/
+		while (!ctx.sender_done) {
+			u32 idx;
+			if (wait_ready(&ctx, 100000, &idx, 1) && gf_sk_group_sock_is_set(ctx.group, ctx.rcv[ctx.nb_socks-1])) break;
+		}
+		th = gf_th_new("deleter");
+		gf_th_run(th, deleter_proc, &ctx);
+		while (!ctx.sender_done) {
+			gf_sk_group_select(ctx.group, 1000);
+			nb_selects++;
+		}
+		gf_th_del(th);
+		if (gf_sk_group_select(ctx.group, 1000) != GF_IP_NETWORK_EMPTY) {
+			fprintf(stderr, "Sockets deleted during select still watched by the group\n");
+			ok = GF_FALSE;
+		}
+		close_sockets(&ctx);
+	}
+	fprintf(stdout, "concurrent deletion: %d selects while deleting sockets\n\n", nb_selects);
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, nb_iter = 2000;
+
+	if (argc > 1) nb_iter = atoi(argv[1]);
+	if (!nb_iter) {
+		fprintf(stderr, "usage: sockgroup [nb_iterations]\n");
+		return 1;
+	}
+
+	gf_sys_init(GF_FALSE);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_QUIET);
+	gf_rand_init(GF_TRUE);
+
+	if (!check_lifecycle() || !check_concurrent_delete()) {
+		gf_sys_close();
+		return 1;
+	}
+
+	fprintf(stdout, "wakeup: us between sending and reading a datagram - idle: us per wakeup with one ready socket - active: us per datagram with all sockets ready\n\n");
+	fprintf(stdout, "%-8s %-8s %10s %10s %10s\n", "sockets", "mode", "wakeup", "idle", "active");
+	for (i=0; i<sizeof(nb_socks_tests)/sizeof(u32); i++) {
+		u32 mode;
+		BenchCtx ctx;
+		if (!open_sockets(&ctx, nb_socks_tests[i])) {
+			fprintf(stderr, "Failed to open %d sockets\n", nb_socks_tests[i]);
+			close_sockets(&ctx);
+			break;
+		}
+		for (mode=0; mode<2; mode++) {
+			Double wakeup, idle, active;
+			ctx.use_group = mode ? GF_TRUE : GF_FALSE;
+			wakeup = bench_wakeup(&ctx);
+			idle = bench_idle(&ctx, nb_iter);
+			active = bench_active(&ctx, MAX(1, nb_iter / ctx.nb_socks));
+			fprintf(stdout, "%-8d %-8s %10.2f %10.2f %10.2f\n", ctx.nb_socks, mode ? "group" : "select", wakeup, idle, active);
+		}
+		close_sockets(&ctx);
+	}
+
+	gf_sys_close();
+	return 0;
+}
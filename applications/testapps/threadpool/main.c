@@ -0,0 +1,190 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / thread pool benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*measures the thread pool for 1 to 64 threads:
+- dispatch: cost per task of posting empty tasks until all are done
+- round trip: latency of submitting an empty task and waiting for it
+- parallel loop: time of a compute loop split with gf_th_pool_parallel_for, compared to the same loop in the caller
+thread. The efficiency is the speedup divided by the number of threads usable in parallel, at most the number of
+CPU cores. The loop result is checked against the serial one.*/
+
+#include <gpac/thread.h>
+
+static u32 nb_threads_tests[] = {1, 2, 4, 8, 16, 32, 64};
+
+typedef struct
+{
+	GF_Mutex *mx;
+	GF_Semaphore *all_done;
+	u32 nb_tasks, nb_done;
+} DispatchCtx;
+
+static GF_Err empty_task(void *udta)
+{
+	return GF_OK;
+}
+
+static void on_task_done(void *cbk, GF_Err e)
+{
+	DispatchCtx *ctx = (DispatchCtx *)cbk;
+	Bool last;
+	gf_mx_p(ctx->mx);
+	ctx->nb_done++;
+	last = (ctx->nb_done == ctx->nb_tasks) ? GF_TRUE : GF_FALSE;
+	gf_mx_v(ctx->mx);
+	if (last) gf_sema_notify(ctx->all_done, 1);
+}
+
+/*ns per task*/
+static Double bench_dispatch(GF_ThreadPool *pool, u32 nb_tasks)
+{
+	u32 i;
+	u64 start;
+	DispatchCtx ctx;
+	memset(&ctx, 0, sizeof(DispatchCtx));
+	ctx.mx = gf_mx_new("dispatch");
+	ctx.all_done = gf_sema_new(1, 0);
+	ctx.nb_tasks = nb_tasks;
+
+	start = gf_sys_clock_high_res();
+	for (i=0; i<nb_tasks; i++) {
+		gf_th_pool_post(pool, empty_task, NULL, on_task_done, &ctx);
+	}
+	gf_sema_wait(ctx.all_done);
+	start = gf_sys_clock_high_res() - start;
+
+	gf_sema_del(ctx.all_done);
+	gf_mx_del(ctx.mx);
+	return 1000.0 * start / nb_tasks;
+}
+
+/*us per task*/
+static Double bench_round_trip(GF_ThreadPool *pool, u32 nb_tasks)
+{
+	u32 i;
+	u64 start = gf_sys_clock_high_res();
+	for (i=0; i<nb_tasks; i++) {
+		GF_ThreadTask *task = gf_th_pool_submit(pool, empty_task, NULL);
+		gf_th_pool_wait(pool, task);
+	}
+	return (Double) (gf_sys_clock_high_res() - start) / nb_tasks;
+}
+
+/*parallel loop: each item runs a few rounds of a xorshift generator seeded with its index*/
+#define ITEM_ROUNDS	64
+
+typedef struct
+{
+	u32 *results;
+} LoopCtx;
+
+static u32 compute_item(u32 i)
+{
+	u32 j, x = i + 1;
+	for (j=0; j<ITEM_ROUNDS; j++) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+	}
+	return x;
+}
+
+static GF_Err loop_range(void *udta, u32 start, u32 end)
+{
+	u32 i;
+	LoopCtx *ctx = (LoopCtx *)udta;
+	for (i=start; i<end; i++) ctx->results[i] = compute_item(i);
+	return GF_OK;
+}
+
+static u64 checksum(u32 *results, u32 nb_items)
+{
+	u32 i;
+	u64 sum = 0;
+	for (i=0; i<nb_items; i++) sum += results[i];
+	return sum;
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, nb_tasks = 100000, nb_items = 4000000;
+	u64 start, serial_time, serial_sum;
+	GF_SystemRTInfo rti;
+	LoopCtx loop;
+
+	if (argc > 1) nb_tasks = atoi(argv[1]);
+	if (argc > 2) nb_items = atoi(argv[2]);
+	if (!nb_tasks || !nb_items) {
+		fprintf(stderr, "usage: threadpool [nb_tasks [nb_loop_items]]\n");
+		return 1;
+	}
+
+	gf_sys_init(GF_FALSE);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_QUIET);
+	memset(&rti, 0, sizeof(GF_SystemRTInfo));
+	gf_sys_get_rti(0, &rti, 0);
+	if (!rti.nb_cores) rti.nb_cores = 1;
+
+	loop.results = (u32 *)gf_malloc(sizeof(u32) * nb_items);
+	if (!loop.results) {
+		fprintf(stderr, "Not enough memory for %d items\n", nb_items);
+		gf_sys_close();
+		return 1;
+	}
+	start = gf_sys_clock_high_res();
+	loop_range(&loop, 0, nb_items);
+	serial_time = gf_sys_clock_high_res() - start;
+	serial_sum = checksum(loop.results, nb_items);
+
+	fprintf(stdout, "%d CPU cores - %d tasks - loop of %d items: %.2f ms in the caller thread\n\n", rti.nb_cores, nb_tasks, nb_items, (Double) serial_time / 1000);
+	fprintf(stdout, "%-8s %14s %14s %10s %9s %11s\n", "threads", "dispatch ns", "round trip us", "loop ms", "speedup", "efficiency");
+	for (i=0; i<sizeof(nb_threads_tests)/sizeof(u32); i++) {
+		Double dispatch, round_trip, speedup;
+		u64 loop_time;
+		u32 nb_threads = nb_threads_tests[i];
+		GF_ThreadPool *pool = gf_th_pool_new("bench", nb_threads);
+		if (!pool) {
+			fprintf(stderr, "Failed to create pool of %d threads\n", nb_threads);
+			break;
+		}
+		dispatch = bench_dispatch(pool, nb_tasks);
+		round_trip = bench_round_trip(pool, nb_tasks / 10 + 1);
+
+		memset(loop.results, 0, sizeof(u32) * nb_items);
+		start = gf_sys_clock_high_res();
+		gf_th_pool_parallel_for(pool, 0, nb_items, 0, loop_range, &loop);
+		loop_time = gf_sys_clock_high_res() - start;
+		speedup = loop_time ? (Double) serial_time / loop_time : 0;
+
+		/*the caller thread takes part in the loop*/
+		fprintf(stdout, "%-8d %14.1f %14.2f %10.2f %8.2fx %10.1f%%%s\n", nb_threads, dispatch, round_trip, (Double) loop_time / 1000, speedup,
+		        100.0 * speedup / MIN(nb_threads + 1, rti.nb_cores), (checksum(loop.results, nb_items) == serial_sum) ? "" : " - RESULT MISMATCH");
+		gf_th_pool_del(pool);
+	}
+
+	gf_free(loop.results);
+	gf_sys_close();
+	return 0;
+}
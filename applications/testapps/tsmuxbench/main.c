@@ -0,0 +1,234 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / MPEG-2 TS multiplexing benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*multiplexes an increasing number of programs, each made of the AVC and AAC tracks of the given MP4 file, and reports
+the aggregate multiplexing rate, i.e. how the multiplexing cost grows with the number of programs. The multiplex is discarded.*/
+
+#include <gpac/mpegts.h>
+#include <gpac/media_tools.h>
+#include <gpac/constants.h>
+
+#define MAX_PROGRAMS	64
+#define MAX_TRACKS	4
+
+typedef struct
+{
+	GF_ISOFile *mp4;
+	u32 track, sample_number, sample_count;
+	Bool has_cts_offset;
+} BenchInput;
+
+typedef struct
+{
+	GF_ISOFile *mp4;
+	u32 nb_streams, pcr_idx;
+	GF_ESInterface streams[MAX_TRACKS];
+	BenchInput inputs[MAX_TRACKS];
+} BenchProgram;
+
+static GF_Err bench_input_ctrl(GF_ESInterface *ifce, u32 act_type, void *param)
+{
+	GF_ESIPacket pck;
+	GF_ISOSample *samp;
+	BenchInput *in = (BenchInput *)ifce->input_udta;
+
+	if (act_type != GF_ESI_INPUT_DATA_FLUSH) return GF_OK;
+	if (in->sample_number == in->sample_count) return GF_OK;
+
+	samp = gf_isom_get_sample(in->mp4, in->track, in->sample_number+1, NULL);
+	if (!samp) return GF_IO_ERR;
+
+	memset(&pck, 0, sizeof(GF_ESIPacket));
+	pck.flags = GF_ESI_DATA_AU_START | GF_ESI_DATA_AU_END | GF_ESI_DATA_HAS_CTS;
+	if (samp->IsRAP) pck.flags |= GF_ESI_DATA_AU_RAP;
+	pck.dts = pck.cts = samp->DTS;
+	if (in->has_cts_offset) {
+		pck.cts += samp->CTS_Offset;
+		pck.flags |= GF_ESI_DATA_HAS_DTS;
+	}
+	pck.data = samp->data;
+	pck.data_len = samp->dataLength;
+	pck.duration = gf_isom_get_sample_duration(in->mp4, in->track, in->sample_number+1);
+	ifce->output_ctrl(ifce, GF_ESI_OUTPUT_DATA_DISPATCH, &pck);
+	gf_isom_sample_del(&samp);
+
+	in->sample_number++;
+	if (in->sample_number == in->sample_count) ifce->caps |= GF_ESI_STREAM_IS_OVER;
+	return GF_OK;
+}
+
+static Bool open_program(BenchProgram *prog, const char *file)
+{
+	u32 i, count;
+	memset(prog, 0, sizeof(BenchProgram));
+	prog->mp4 = gf_isom_open(file, GF_ISOM_OPEN_READ, NULL);
+	if (!prog->mp4) return GF_FALSE;
+
+	count = gf_isom_get_track_count(prog->mp4);
+	for (i=0; i<count && prog->nb_streams<MAX_TRACKS; i++) {
+		GF_ESD *esd;
+		GF_ESInterface *ifce = &prog->streams[prog->nb_streams];
+		BenchInput *in = &prog->inputs[prog->nb_streams];
+		u64 rate, dur;
+
+		esd = gf_media_map_esd(prog->mp4, i+1);
+		if (!esd) continue;
+		switch (esd->decoderConfig->objectTypeIndication) {
+		case GPAC_OTI_VIDEO_AVC:
+			gf_isom_set_nalu_extract_mode(prog->mp4, i+1, GF_ISOM_NALU_EXTRACT_INBAND_PS_FLAG | GF_ISOM_NALU_EXTRACT_ANNEXB_FLAG);
+			prog->pcr_idx = prog->nb_streams;
+			break;
+		case GPAC_OTI_AUDIO_AAC_MPEG4:
+			if (!esd->decoderConfig->decoderSpecificInfo) {
+				gf_odf_desc_del((GF_Descriptor *)esd);
+				continue;
+			}
+			ifce->decoder_config_size = esd->decoderConfig->decoderSpecificInfo->dataLength;
+			ifce->decoder_config = (char *)gf_malloc(ifce->decoder_config_size);
+			memcpy(ifce->decoder_config, esd->decoderConfig->decoderSpecificInfo->data, ifce->decoder_config_size);
+			break;
+		default:
+			gf_odf_desc_del((GF_Descriptor *)esd);
+			continue;
+		}
+		ifce->stream_type = esd->decoderConfig->streamType;
+		ifce->object_type_indication = esd->decoderConfig->objectTypeIndication;
+		gf_odf_desc_del((GF_Descriptor *)esd);
+
+		ifce->stream_id = gf_isom_get_track_id(prog->mp4, i+1);
+		ifce->timescale = gf_isom_get_media_timescale(prog->mp4, i+1);
+		dur = gf_isom_get_media_duration(prog->mp4, i+1);
+		rate = gf_isom_get_media_data_size(prog->mp4, i+1) * 8 * ifce->timescale;
+		if (dur) rate /= dur;
+		ifce->bit_rate = (u32) rate;
+		ifce->duration = (Double) (s64) dur / ifce->timescale;
+		in->has_cts_offset = gf_isom_has_time_offset(prog->mp4, i+1) ? GF_TRUE : GF_FALSE;
+		if (in->has_cts_offset) ifce->caps |= GF_ESI_SIGNAL_DTS;
+
+		in->mp4 = prog->mp4;
+		in->track = i+1;
+		in->sample_count = gf_isom_get_sample_count(prog->mp4, i+1);
+		ifce->input_udta = in;
+		ifce->input_ctrl = bench_input_ctrl;
+		prog->nb_streams++;
+	}
+	return prog->nb_streams ? GF_TRUE : GF_FALSE;
+}
+
+static void close_program(BenchProgram *prog)
+{
+	u32 i;
+	for (i=0; i<prog->nb_streams; i++) {
+		if (prog->streams[i].decoder_config) gf_free(prog->streams[i].decoder_config);
+		if (prog->streams[i].sl_config) gf_odf_desc_del((GF_Descriptor *)prog->streams[i].sl_config);
+	}
+	if (prog->mp4) gf_isom_close(prog->mp4);
+}
+
+static GF_Err run_mux(const char *file, u32 nb_progs, u64 *time_us, u64 *size)
+{
+	u32 i, j, status;
+	u64 start;
+	GF_Err e = GF_OK;
+	GF_M2TS_Mux *muxer;
+	BenchProgram *progs;
+
+	progs = (BenchProgram *)gf_malloc(sizeof(BenchProgram) * nb_progs);
+	if (!progs) return GF_OUT_OF_MEM;
+	for (i=0; i<nb_progs; i++) {
+		if (!open_program(&progs[i], file)) {
+			nb_progs = i+1;
+			e = GF_NOT_SUPPORTED;
+			goto exit;
+		}
+	}
+
+	start = gf_sys_clock_high_res();
+	muxer = gf_m2ts_mux_new(0, GF_M2TS_PSI_DEFAULT_REFRESH_RATE, GF_FALSE);
+	gf_m2ts_mux_set_initial_pcr(muxer, 1234);
+	for (i=0; i<nb_progs; i++) {
+		GF_M2TS_Mux_Program *program = gf_m2ts_mux_program_add(muxer, i+1, 100*(i+1), GF_M2TS_PSI_DEFAULT_REFRESH_RATE, 0, GF_FALSE, 0, GF_FALSE);
+		for (j=0; j<progs[i].nb_streams; j++) {
+			gf_m2ts_program_stream_add(program, &progs[i].streams[j], 100*(i+1)+j+1, (progs[i].pcr_idx==j) ? GF_TRUE : GF_FALSE, GF_FALSE);
+		}
+	}
+	gf_m2ts_mux_update_config(muxer, GF_TRUE);
+
+	*size = 0;
+	while (1) {
+		const char *ts_pck = gf_m2ts_mux_process(muxer, &status, NULL);
+		if (status == GF_M2TS_STATE_EOS) break;
+		if (!ts_pck) continue;
+		*size += 188;
+	}
+	gf_m2ts_mux_del(muxer);
+	*time_us = gf_sys_clock_high_res() - start;
+
+exit:
+	for (i=0; i<nb_progs; i++) close_program(&progs[i]);
+	gf_free(progs);
+	return e;
+}
+
+int main(int argc, char **argv)
+{
+	GF_Err e;
+	u32 nb_progs, max_progs = 16, nb_runs = 3;
+
+	if (argc < 2) {
+		fprintf(stderr, "usage: tsmuxbench file.mp4 [max_programs [nb_runs]]\n");
+		return 1;
+	}
+	if (argc > 2) max_progs = atoi(argv[2]);
+	if (argc > 3) nb_runs = atoi(argv[3]);
+	if (!max_progs || (max_progs > MAX_PROGRAMS) || !nb_runs) {
+		fprintf(stderr, "programs shall be between 1 and %d, runs shall not be 0\n", MAX_PROGRAMS);
+		return 1;
+	}
+
+	gf_sys_init(GF_FALSE);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_QUIET);
+
+	fprintf(stdout, "%-9s %10s %10s %10s %18s\n", "programs", "MBytes", "time ms", "MB/s", "ms per program");
+	for (nb_progs = 1; nb_progs <= max_progs; nb_progs *= 2) {
+		u32 i;
+		u64 size, best = 0;
+		for (i=0; i<nb_runs; i++) {
+			u64 time_us;
+			e = run_mux(argv[1], nb_progs, &time_us, &size);
+			if (e) {
+				fprintf(stderr, "Multiplexing failed: %s\n", gf_error_to_string(e));
+				goto exit;
+			}
+			if (!best || (time_us < best)) best = time_us;
+		}
+		fprintf(stdout, "%-9d %10.2f %10.1f %10.2f %18.2f\n", nb_progs, (Double) size / 1000000,
+		        (Double) best / 1000, (Double) size / best, (Double) best / 1000 / nb_progs);
+	}
+
+exit:
+	gf_sys_close();
+	return 0;
+}
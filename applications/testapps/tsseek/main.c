@@ -0,0 +1,234 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / MPEG-2 TS seek index benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*measures random seek latency in a TS file, using bitrate estimation as done by the TS demuxer without index, and
+using the seek index of the file. A seek is complete when the first random access point of the video stream is
+demuxed. The reported error is the difference between the requested time and the time of this random access point:
+without index the time of the random access point is unknown to the player, with the index it is exact and the
+player can decode up to the requested time.*/
+
+#include <gpac/mpegts.h>
+
+typedef struct
+{
+	GF_M2TS_Demuxer *ts;
+	FILE *src;
+	u32 video_pid;
+	Bool rap_found;
+	u64 rap_PTS;
+	u64 bytes_read;
+} SeekCtx;
+
+static void on_ts_event(GF_M2TS_Demuxer *ts, u32 evt_type, void *par)
+{
+	u32 i, count;
+	SeekCtx *ctx = (SeekCtx *)ts->user;
+
+	if (evt_type == GF_M2TS_EVT_PMT_FOUND) {
+		GF_M2TS_Program *prog = (GF_M2TS_Program *)par;
+		count = gf_list_count(prog->streams);
+		for (i=0; i<count; i++) {
+			GF_M2TS_ES *es = (GF_M2TS_ES *)gf_list_get(prog->streams, i);
+			if (!(es->flags & GF_M2TS_ES_IS_PES)) continue;
+			switch (es->stream_type) {
+			case GF_M2TS_VIDEO_MPEG1:
+			case GF_M2TS_VIDEO_MPEG2:
+			case GF_M2TS_VIDEO_MPEG4:
+			case GF_M2TS_VIDEO_H264:
+			case GF_M2TS_VIDEO_HEVC:
+				if (!ctx->video_pid) {
+					ctx->video_pid = es->pid;
+					gf_m2ts_set_pes_framing((GF_M2TS_PES *)es, GF_M2TS_PES_FRAMING_DEFAULT);
+					break;
+				}
+			default:
+				gf_m2ts_set_pes_framing((GF_M2TS_PES *)es, GF_M2TS_PES_FRAMING_SKIP);
+				break;
+			}
+		}
+	}
+	else if (evt_type == GF_M2TS_EVT_PES_PCK) {
+		GF_M2TS_PES_PCK *pck = (GF_M2TS_PES_PCK *)par;
+		if (ctx->rap_found || (pck->stream->pid != ctx->video_pid)) return;
+		if (pck->flags & GF_M2TS_PES_PCK_RAP) {
+			ctx->rap_found = GF_TRUE;
+			ctx->rap_PTS = pck->PTS;
+		}
+	}
+}
+
+static u64 get_file_size(const char *name)
+{
+	u64 size;
+	FILE *f = gf_fopen(name, "rb");
+	if (!f) return 0;
+	gf_fseek(f, 0, SEEK_END);
+	size = gf_ftell(f);
+	gf_fclose(f);
+	return size;
+}
+
+/*reads from the given position until the first video random access point*/
+static Bool seek_to_rap(SeekCtx *ctx, u64 pos)
+{
+	char data[1880];
+	gf_m2ts_reset_parsers(ctx->ts);
+	gf_fseek(ctx->src, pos, SEEK_SET);
+	ctx->rap_found = GF_FALSE;
+	while (!ctx->rap_found) {
+		u32 size = (u32) fread(data, 1, 1880, ctx->src);
+		if (!size) return GF_FALSE;
+		ctx->bytes_read += size;
+		gf_m2ts_process_data(ctx->ts, data, size);
+	}
+	return GF_TRUE;
+}
+
+int main(int argc, char **argv)
+{
+	GF_Err e;
+	u32 i, nb_seeks = 200, interval = 500, nb_found[2];
+	u64 file_size, start, now, build_time, load_time, time_seek[2];
+	Double err_seek[2], max_err[2], duration, est_duration;
+	char szIndex[GF_MAX_PATH];
+	GF_M2TS_SeekIndex *index;
+	SeekCtx ctx;
+
+	if (argc < 2) {
+		fprintf(stderr, "usage: tsseek file.ts [nb_seeks [min_interval_ms]]\n");
+		return 1;
+	}
+	if (argc > 2) nb_seeks = atoi(argv[2]);
+	if (argc > 3) interval = atoi(argv[3]);
+
+	gf_sys_init(GF_FALSE);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_QUIET);
+
+	memset(&ctx, 0, sizeof(SeekCtx));
+	ctx.src = gf_fopen(argv[1], "rb");
+	if (!ctx.src) {
+		fprintf(stderr, "Cannot open %s\n", argv[1]);
+		gf_sys_close();
+		return 1;
+	}
+	file_size = get_file_size(argv[1]);
+
+	/*one time indexing cost, then index loading cost as done by players*/
+	start = gf_sys_clock_high_res();
+	e = gf_m2ts_seek_index_build(argv[1], interval, &index);
+	build_time = gf_sys_clock_high_res() - start;
+	if (e) {
+		fprintf(stderr, "Failed to index %s: %s\n", argv[1], gf_error_to_string(e));
+		goto exit;
+	}
+	sprintf(szIndex, "%s.tsidx", argv[1]);
+	e = gf_m2ts_seek_index_save(index, szIndex);
+	gf_m2ts_seek_index_del(index);
+	if (e) {
+		fprintf(stderr, "Failed to save index %s: %s\n", szIndex, gf_error_to_string(e));
+		goto exit;
+	}
+	start = gf_sys_clock_high_res();
+	e = gf_m2ts_seek_index_load(szIndex, argv[1], &index);
+	load_time = gf_sys_clock_high_res() - start;
+	if (e) {
+		fprintf(stderr, "Failed to load index %s: %s\n", szIndex, gf_error_to_string(e));
+		goto exit;
+	}
+	duration = gf_m2ts_seek_index_get_duration(index);
+
+	/*get the PAT/PMT and the bitrate-based duration estimate as done by the demuxer when playing the file*/
+	ctx.ts = gf_m2ts_demux_new();
+	ctx.ts->on_event = on_ts_event;
+	ctx.ts->user = &ctx;
+	ctx.ts->file_size = file_size;
+	gf_fseek(ctx.src, 0, SEEK_SET);
+	while (!ctx.ts->duration) {
+		char data[188];
+		u32 size = (u32) fread(data, 1, 188, ctx.src);
+		if (!size) break;
+		gf_m2ts_process_data(ctx.ts, data, size);
+		ctx.ts->nb_pck++;
+	}
+	est_duration = ctx.ts->duration;
+	if (!ctx.video_pid || !est_duration) {
+		fprintf(stderr, "No video stream or PCR found in %s\n", argv[1]);
+		gf_m2ts_seek_index_del(index);
+		goto exit;
+	}
+
+	fprintf(stdout, "file %s: "LLU" bytes - duration %.3f s (estimated from bitrate %.3f s)\n", argv[1], file_size, duration, est_duration);
+	fprintf(stdout, "index: built in %.2f ms - "LLU" bytes - loaded in %.3f ms\n", (Double) build_time / 1000, get_file_size(szIndex), (Double) load_time / 1000);
+
+	memset(time_seek, 0, sizeof(time_seek));
+	memset(nb_found, 0, sizeof(nb_found));
+	err_seek[0] = err_seek[1] = max_err[0] = max_err[1] = 0;
+	gf_rand_init(GF_TRUE);
+	for (i=0; i<nb_seeks; i++) {
+		Double target = duration * (gf_rand() % 10000) / 10000.0;
+		Double rap_time, err;
+		u64 pos;
+
+		/*bitrate estimation*/
+		ctx.bytes_read = 0;
+		start = gf_sys_clock_high_res();
+		pos = (u64) (target / est_duration * file_size);
+		pos -= pos % 188;
+		if (pos >= file_size) pos = 0;
+		if (seek_to_rap(&ctx, pos)) {
+			now = gf_sys_clock_high_res();
+			time_seek[0] += now - start;
+			err = ABS(gf_m2ts_seek_index_get_time(index, ctx.rap_PTS) - target);
+			err_seek[0] += err;
+			if (err > max_err[0]) max_err[0] = err;
+			nb_found[0]++;
+		}
+
+		/*seek index*/
+		start = gf_sys_clock_high_res();
+		if ((gf_m2ts_seek_index_find(index, ctx.video_pid, target, &pos, &rap_time) == GF_OK) && seek_to_rap(&ctx, pos)) {
+			now = gf_sys_clock_high_res();
+			time_seek[1] += now - start;
+			/*the time of the random access point is known, the player decodes up to the target: only check the index is exact*/
+			err = ABS(gf_m2ts_seek_index_get_time(index, ctx.rap_PTS) - rap_time);
+			err_seek[1] += err;
+			if (err > max_err[1]) max_err[1] = err;
+			nb_found[1]++;
+		}
+	}
+	fprintf(stdout, "\n%d random seeks\n", nb_seeks);
+	fprintf(stdout, "bitrate estimate: %d seeks - average %.3f ms - time error average %.3f s max %.3f s\n", nb_found[0],
+	        nb_found[0] ? (Double) time_seek[0] / nb_found[0] / 1000 : 0, nb_found[0] ? err_seek[0] / nb_found[0] : 0, max_err[0]);
+	fprintf(stdout, "seek index:       %d seeks - average %.3f ms - time error average %.3f s max %.3f s\n", nb_found[1],
+	        nb_found[1] ? (Double) time_seek[1] / nb_found[1] / 1000 : 0, nb_found[1] ? err_seek[1] / nb_found[1] : 0, max_err[1]);
+
+	gf_m2ts_seek_index_del(index);
+
+exit:
+	if (ctx.ts) gf_m2ts_demux_del(ctx.ts);
+	gf_fclose(ctx.src);
+	gf_sys_close();
+	return 0;
+}
@@ -6,6 +6,6 @@ LOCAL_MODULE		:= gm_isom_in
 
 include $(LOCAL_PATH)/base.mk
 
-LOCAL_SRC_FILES := ../../../../modules/isom_in/isom_cache.c ../../../../modules/isom_in/load.c ../../../../modules/isom_in/read.c ../../../../modules/isom_in/read_ch.c
+LOCAL_SRC_FILES := ../../../../modules/isom_in/isom_cache.c ../../../../modules/isom_in/load.c ../../../../modules/isom_in/read.c ../../../../modules/isom_in/read_ch.c ../../../../modules/isom_in/isom_share.c
 
 include $(BUILD_SHARED_LIBRARY)
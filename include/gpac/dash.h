@@ -306,6 +306,10 @@ GF_Err gf_dash_group_get_next_segment_location(GF_DashClient *dash, u32 idx, u32
         s32 *switching_index, const char **switching_url, u64 *switching_start_range, u64 *switching_end_range,
         const char **original_url, Bool *has_next_segment, const char **key_url, bin128 *key_IV);
 
+/*returns the duration in milliseconds and the representation index of the next media resource to play in this group.
+Returns GF_BUFFER_TOO_SMALL if no resource is available. duration_ms and representation_index are optional*/
+GF_Err gf_dash_group_get_next_segment_info(GF_DashClient *dash, u32 idx, u32 *duration_ms, u32 *representation_index);
+
 /*same as gf_dash_group_get_next_segment_location but query the current downloaded segment*/
 GF_EXPORT
 GF_Err gf_dash_group_probe_current_download_segment_location(GF_DashClient *dash, u32 idx, const char **url, s32 *switching_index, const char **switching_url, const char **original_url, Bool *switched);
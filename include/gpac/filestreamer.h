@@ -119,6 +119,16 @@ void gf_isom_streamer_reset(GF_ISOMRTPStreamer *streamer, Bool is_loop);
  *	\return media time (DTS) in seconds
  */
 Double gf_isom_streamer_get_current_time(GF_ISOMRTPStreamer *streamer);
+
+/*!
+ *	\brief enables batched RTP emission
+ *
+ *	Queues RTP packets of each stream and sends them using a single system call per access unit when possible.
+ *	\param streamer RTP streamer object
+ *	\param nb_packets max number of queued packets per stream. 0 disables batching
+ *	\param pacing_us if not 0, packets of each stream are paced at twice the stream average bitrate, in bursts of at most pacing_us microseconds worth of data
+ */
+GF_Err gf_isom_streamer_set_send_batch(GF_ISOMRTPStreamer *streamer, u32 nb_packets, u32 pacing_us);
     
 /*! @} */
 
@@ -618,6 +618,12 @@ void gf_rtp_reset_buffers(GF_RTPChannel *ch);
 /*read any data on UDP only (not valid for TCP). Performs re-ordering if configured for it
 returns amount of data read (raw UDP packet size)*/
 u32 gf_rtp_read_rtp(GF_RTPChannel *ch, char *buffer, u32 buffer_size);
+
+/*enables batched reception on the RTP socket (UDP only): up to nb_packets datagrams are fetched per system call
+and handed one by one by gf_rtp_read_rtp.
+max_packet_size: size of each reception slot, if 0 defaults to 2048 bytes. Bigger datagrams are truncated
+nb_packets: 0 or 1 disables batch reception*/
+GF_Err gf_rtp_set_receive_batch(GF_RTPChannel *ch, u32 nb_packets, u32 max_packet_size);
 u32 gf_rtp_read_rtcp(GF_RTPChannel *ch, char *buffer, u32 buffer_size);
 
 /*decodes an RTP packet and gets the beginning of the RTP payload*/
@@ -644,6 +650,16 @@ GF_Err gf_rtp_send_bye(GF_RTPChannel *ch,
 write the header in place*/
 GF_Err gf_rtp_send_packet(GF_RTPChannel *ch, GF_RTPHeader *rtp_hdr, char *pck, u32 pck_size, Bool fast_send);
 
+/*enables batched emission: packets are queued and sent by groups of nb_packets using a single system call when possible.
+rate: if not 0, queued packets are paced with a token bucket filled at rate bytes per second
+burst_size: depth of the token bucket in bytes, ie the max amount of data sent at once. It defines the pacing
+granularity (burst_size/rate seconds) and is at least one MTU.
+nb_packets: 0 disables batch emission (pending packets are sent)*/
+GF_Err gf_rtp_set_send_batch(GF_RTPChannel *ch, u32 nb_packets, u32 rate, u32 burst_size);
+/*sends queued packets. If force is not set, only sends what the token bucket allows and returns,
+otherwise waits until all packets are sent*/
+GF_Err gf_rtp_flush_packets(GF_RTPChannel *ch, Bool force);
+
 enum
 {
 	GF_RTCP_INFO_NAME = 0,
@@ -669,6 +685,11 @@ u32 gf_rtp_get_local_ssrc(GF_RTPChannel *ch);
 
 Float gf_rtp_get_loss(GF_RTPChannel *ch);
 u32 gf_rtp_get_tcp_bytes_sent(GF_RTPChannel *ch);
+/*gets reception stats: number of batched receptions and datagrams fetched through them, number of packets
+received out of order and dropped by the reordering queue. Any pointer may be NULL*/
+void gf_rtp_get_receive_stats(GF_RTPChannel *ch, u32 *nb_batches, u32 *nb_batch_pck, u32 *nb_reordered, u32 *nb_dropped);
+/*gets emission stats: number of batched sends and datagrams sent through them, number of packets still queued. Any pointer may be NULL*/
+void gf_rtp_get_send_stats(GF_RTPChannel *ch, u32 *nb_batches, u32 *nb_batch_pck, u32 *nb_queued);
 void gf_rtp_get_ports(GF_RTPChannel *ch, u16 *rtp_port, u16 *rtcp_port);
 
 
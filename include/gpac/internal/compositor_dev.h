@@ -223,7 +223,7 @@ struct __tag_compositor
 	GF_List *textures_gc;
 
 	/*event queue*/
-	GF_List *event_queue, *event_queue_back;
+	GF_Fifo *event_queue, *event_queue_back;
 	GF_Mutex *evq_mx;
 
 	Bool video_setup_failed;
@@ -175,6 +175,8 @@ typedef struct mpe_fec_frame
 	u32 PID;
 	GF_List *mpe_holes;
 	//u32 erasures [] p_erasures; /*pointer to the error indicators*/
+	/*RS(255,191) codec of this frame, created on first use*/
+	GF_RSCodec *rs;
 } MPE_FEC_FRAME;
 
 
@@ -236,6 +238,7 @@ u32 init_frame(MPE_FEC_FRAME * mff, u32 rows);
 void getRowFromADT(MPE_FEC_FRAME * mff,u32 index, u8 * adt_row);
 void getRowFromRS(MPE_FEC_FRAME * mff,u32 index, u8 * rs_row);
 void setRowRS(MPE_FEC_FRAME * mff,u32 index, u8 * p_rs);
+void setRowADT(MPE_FEC_FRAME * mff,u32 index, u8 * adt_row);
 
 /*return the number of errors and the position of the error in the row*/
 void getErrorPositions(MPE_FEC_FRAME * mff, u32 row, u32 * errPositions);
@@ -248,6 +251,8 @@ void setErrorIndicator(u32 * data , u32 offset1, u32 length  );
 void resetMFF(MPE_FEC_FRAME * mff) ;
 u32  getErrasurePositions( MPE_FEC_FRAME *mff , u32 row, u32 *errasures);
 
+void encode_fec(MPE_FEC_FRAME * mff);
+/*corrects the ADT of the frame in place, using the error indicators of the frame as erasures*/
 void decode_fec(MPE_FEC_FRAME * mff);
 
 
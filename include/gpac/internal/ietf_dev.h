@@ -59,8 +59,13 @@ typedef struct __PRO_item
 	u32 pck_seq_num;
 	void *pck;
 	u32 size;
+	/*set if the item and its packet buffer belong to the reorderer slab*/
+	Bool pooled;
 } GF_POItem;
 
+/*size of a packet slot in the reorderer slab - bigger packets are allocated on the fly*/
+#define GF_RTP_REORDER_SLOT_SIZE	2048
+
 typedef struct __PO
 {
 	struct __PRO_item *in;
@@ -69,6 +74,15 @@ typedef struct __PO
 	u32 MaxCount;
 	u32 IsInit;
 	u32 MaxDelay, LastTime;
+
+	/*preallocated items and packet slots, MaxCount+1 entries*/
+	GF_POItem *slab;
+	char *slab_data;
+	/*free items in slab*/
+	GF_POItem *free_items;
+
+	/*stats: packets received out of order, packets dropped (duplicated or out of window)*/
+	u32 nb_reordered, nb_dropped;
 } GF_RTPReorder;
 
 /* creates new RTP reorderer
@@ -84,6 +98,9 @@ void gf_rtp_reorderer_reset(GF_RTPReorder *po);
 GF_Err gf_rtp_reorderer_add(GF_RTPReorder *po, const void * pck, u32 pck_size, u32 pck_seqnum);
 /*gets the output of the queue. Packet Data IS YOURS to delete*/
 void *gf_rtp_reorderer_get(GF_RTPReorder *po, u32 *pck_size);
+/*gets the output of the queue and copies it in the given buffer. Returns the packet size, 0 if no packet is available
+or if buffer is too small (the packet is then dropped)*/
+u32 gf_rtp_reorderer_get_into(GF_RTPReorder *po, char *buffer, u32 buffer_size);
 
 
 /*the RTP channel with both RTP and RTCP sockets and buffers
@@ -163,6 +180,25 @@ struct __tag_rtp_channel
 	u32 last_SR_rtp_time;
 	/*payload info*/
 	u32 total_pck, total_bytes;
+
+	/*batched reception: rcv_batch_count slots of rcv_batch_slot_size bytes, rcv_batch_nb filled, next one at rcv_batch_pos*/
+	char *rcv_batch;
+	char **rcv_batch_pcks;
+	u32 *rcv_batch_sizes;
+	u32 rcv_batch_count, rcv_batch_slot_size, rcv_batch_nb, rcv_batch_pos;
+	/*number of batched receive calls and datagrams received through them*/
+	u32 nb_rcv_batches, nb_rcv_batch_pck;
+
+	/*batched emission: snd_batch_count slots of send_buffer_size bytes, snd_batch_nb queued*/
+	char *snd_batch;
+	char **snd_batch_pcks;
+	u32 *snd_batch_sizes;
+	u32 snd_batch_count, snd_batch_nb;
+	/*token bucket pacing: rate in bytes per second, bucket depth and current level in bytes, last refill time in us*/
+	u32 snd_rate, snd_burst, snd_tokens;
+	u64 snd_last_refill;
+	/*number of batched send calls and datagrams sent through them*/
+	u32 nb_snd_batches, nb_snd_batch_pck;
 };
 
 /*gets UTC in the channel RTP timescale*/
@@ -601,6 +601,12 @@ GF_Err gf_isom_box_array_read_ex(GF_Box *parent, GF_BitStream *bs, GF_Err (*add_
 GF_Err gf_isom_box_add_default(GF_Box *a, GF_Box *subbox);
 GF_Err gf_isom_box_parse_ex(GF_Box **outBox, GF_BitStream *bs, u32 parent_type, Bool is_root_box);
 
+/*bitstream cookie flags used while parsing boxes*/
+/*no error logs, and QT-style sample entries are converted*/
+#define GF_ISOM_BS_COOKIE_NO_LOGS	1
+/*large sample table boxes are skipped, see stbl_defer_box*/
+#define GF_ISOM_BS_COOKIE_LAZY_STBL	(1<<1)
+
 //writes box header - shall be called at the beginning of each xxxx_Write function
 //this function is not factorized in order to let box serializer modify box type before writing
 GF_Err gf_isom_box_write_header(GF_Box *ptr, GF_BitStream *bs);
@@ -839,6 +845,8 @@ typedef struct
 	Bool first_traf_merged;
 	Bool present_in_scalable_segment;
 #endif
+	/*set if some sample table boxes are not loaded yet*/
+	Bool lazy_stbl;
 } GF_TrackBox;
 
 typedef struct
@@ -1575,6 +1583,19 @@ typedef struct
 } GF_SampleDescriptionBox;
 
 
+/*number of sample sizes in a packed block of the sample size table*/
+#define GF_ISOM_STSZ_BLOCK_SIZE	256
+
+typedef struct
+{
+	/*byte offset of the block in the packed buffer*/
+	u32 offset;
+	/*smallest size in the block, stored sizes are relative to it*/
+	u32 min_size;
+	/*number of bits per stored size, 0 if all sizes are equal*/
+	u32 nb_bits;
+} GF_StszBlock;
+
 typedef struct
 {
 	GF_ISOM_FULL_BOX
@@ -1583,6 +1604,13 @@ typedef struct
 	u32 sampleCount;
 	u32 alloc_size;
 	u32 *sizes;
+
+	/*when samples are appended, sizes are packed by blocks of GF_ISOM_STSZ_BLOCK_SIZE: the first nb_blocks*GF_ISOM_STSZ_BLOCK_SIZE
+	sizes are stored in packed, the remaining ones in sizes. Always use stsz_get_size to read sizes, and stsz_unpack before modifying them*/
+	GF_StszBlock *blocks;
+	u32 nb_blocks, alloc_blocks;
+	u8 *packed;
+	u32 packed_size, packed_alloc;
 } GF_SampleSizeBox;
 
 typedef struct
@@ -1782,6 +1810,10 @@ typedef struct
 	u32 currentEntryIndex;
 
 	Bool no_sync_found;
+
+	/*lazy loading: file offsets of the sample table boxes not yet parsed, and sample count announced in stsz/stz2*/
+	u64 *lazy_box_offsets;
+	u32 nb_lazy_boxes, lazy_sample_count;
 } GF_SampleTableBox;
 
 void stbl_AppendTrafMap(GF_SampleTableBox *stbl);
@@ -3531,6 +3563,8 @@ struct __tag_isom {
 	GF_MetaBox *meta;
 
 	Bool dump_mode_alloc;
+	/*large sample table boxes are only parsed on first access to the track*/
+	Bool lazy_sample_tables;
 
 #ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
 	u32 FragmentsFlags, NextMoofNumber;
@@ -3583,6 +3617,10 @@ GF_Err gf_isom_parse_movie_boxes(GF_ISOFile *mov, u64 *bytesMissing, Bool progre
 GF_ISOFile *gf_isom_new_movie();
 /*Movie and Track access functions*/
 GF_TrackBox *gf_isom_get_track_from_file(GF_ISOFile *the_file, u32 trackNumber);
+/*same as above but does not load lazy sample tables - only use when accessing track headers and sample descriptions*/
+GF_TrackBox *gf_isom_get_track_header_from_file(GF_ISOFile *the_file, u32 trackNumber);
+/*parses the sample table boxes skipped when opening the file in lazy mode*/
+GF_Err gf_isom_track_load_sample_tables(GF_TrackBox *trak);
 GF_TrackBox *gf_isom_get_track(GF_MovieBox *moov, u32 trackNumber);
 GF_TrackBox *gf_isom_get_track_from_id(GF_MovieBox *moov, u32 trackID);
 GF_TrackBox *gf_isom_get_track_from_original_id(GF_MovieBox *moov, u32 originalID, u32 originalFile);
@@ -3632,6 +3670,16 @@ useCTS specifies that we're looking for a composition time
 GF_Err stbl_findEntryForTime(GF_SampleTableBox *stbl, u64 DTS, u8 useCTS, u32 *sampleNumber, u32 *prevSampleNumber);
 /*Reading of the sample tables*/
 GF_Err stbl_GetSampleSize(GF_SampleSizeBox *stsz, u32 SampleNumber, u32 *Size);
+/*gets the size of the sample at the given 0-based index of a sample size table having a size table*/
+u32 stsz_get_size(GF_SampleSizeBox *stsz, u32 sampleIdx);
+/*appends a size to a sample size table having a size table, packing full blocks of sizes*/
+GF_Err stsz_append_size(GF_SampleSizeBox *stsz, u32 size);
+/*converts back a packed sample size table to a plain size table*/
+GF_Err stsz_unpack(GF_SampleSizeBox *stsz);
+/*discards packed sizes*/
+void stsz_reset_packed(GF_SampleSizeBox *stsz);
+/*discards all sizes, the table is empty*/
+void stsz_reset(GF_SampleSizeBox *stsz);
 GF_Err stbl_GetSampleCTS(GF_CompositionOffsetBox *ctts, u32 SampleNumber, s32 *CTSoffset);
 GF_Err stbl_GetSampleDTS(GF_TimeToSampleBox *stts, u32 SampleNumber, u64 *DTS);
 GF_Err stbl_GetSampleDTS_and_Duration(GF_TimeToSampleBox *stts, u32 SampleNumber, u64 *DTS, u32 *duration);
@@ -3755,6 +3803,8 @@ GF_Err udta_AddBox(GF_Box *ptr, GF_Box *a);
 GF_Err edts_AddBox(GF_Box *s, GF_Box *a);
 GF_Err stdp_Read(GF_Box *s, GF_BitStream *bs);
 GF_Err stbl_AddBox(GF_Box *ptr, GF_Box *a);
+/*records the position of the next box if it is a large sample table box and skips it - returns GF_TRUE if skipped*/
+Bool stbl_defer_box(GF_SampleTableBox *ptr, GF_BitStream *bs);
 GF_Err sdtp_Read(GF_Box *s, GF_BitStream *bs);
 GF_Err dinf_AddBox(GF_Box *s, GF_Box *a);
 GF_Err minf_AddBox(GF_Box *s, GF_Box *a);
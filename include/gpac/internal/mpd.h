@@ -79,9 +79,23 @@ typedef struct
 	u32 repeat_count;
 } GF_MPD_SegmentTimelineEntry;
 
+typedef struct
+{
+	/*resolved start time of the entry*/
+	u64 start_time;
+	/*index of the first segment of the entry in the timeline*/
+	u64 first_segment;
+} GF_MPD_SegmentTimelineIndex;
+
 typedef struct
 {
 	GF_List *entries;
+
+	/*cumulative index of the entries, built on demand by the gf_mpd_segment_timeline_* functions*/
+	GF_MPD_SegmentTimelineIndex *index;
+	u32 nb_indexed, index_alloc;
+	Bool index_valid;
+	u64 index_end_time, index_nb_segments;
 } GF_MPD_SegmentTimeline;
 
 typedef struct
@@ -95,6 +109,8 @@ typedef struct
 	char *URL;
 	char *service_location;
 	GF_MPD_ByteRange *byte_range;
+	/*availabilityTimeOffset, cumulative with the one of the segment description*/
+	Double availability_time_offset;
 
 	//GPAC internal: redirection for that URL
 	char *redirection;
@@ -461,6 +477,21 @@ GF_Err gf_mpd_get_segment_start_time_with_timescale(s32 in_segment_index,
 	GF_MPD_Period const * const in_period, GF_MPD_AdaptationSet const * const in_set, GF_MPD_Representation const * const in_rep,
 	u64 *out_segment_start_time, u64 *out_opt_segment_duration, u32 *out_opt_scale);
 
+/*gets the timeline entry of the given segment index, the segment start time and optionally the 0-based index of the entry, in O(log(nb_entries)).
+Returns NULL if the index is after the last segment, in which case out_start_time is set to the end time of the timeline*/
+GF_MPD_SegmentTimelineEntry *gf_mpd_segment_timeline_get_segment(GF_MPD_SegmentTimeline *timeline, u32 segment_index, u64 *out_start_time, u32 *out_entry_index);
+
+/*gets the index of the first segment starting at or after the given time (in timeline timescale), in O(log(nb_entries)).
+Returns the number of segments in the timeline if no such segment. If out_start_time is set, it is filled with the segment start time
+or the end time of the timeline*/
+u32 gf_mpd_segment_timeline_find_time(GF_MPD_SegmentTimeline *timeline, u64 time, u64 *out_start_time);
+
+/*gets the number of segments in the timeline and optionnaly its end time*/
+u32 gf_mpd_segment_timeline_get_count(GF_MPD_SegmentTimeline *timeline, u64 *out_end_time);
+
+/*must be called whenever entries of the timeline are modified*/
+void gf_mpd_segment_timeline_reset_index(GF_MPD_SegmentTimeline *timeline);
+
 typedef enum {
 	MPD_SEEK_PREV,    /*will return the segment containing the requested time*/
 	MPD_SEEK_NEAREST, /*the nearest segment start time, may be the previous or the next one*/
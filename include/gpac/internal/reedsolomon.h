@@ -7,72 +7,44 @@
 
 /****************************************************************
 
-  Below is NPAR, the only compile-time parameter you should have to
-  modify.
+  The codec works on GF(256) codewords of at most 255 bytes: a message
+  followed by nb_parity parity bytes, nb_parity being given when creating
+  the codec (64 for DVB MPE-FEC, see NPAR).
 
-  It is the number of parity bytes which will be appended to
-  your data to create a codeword.
-
-  Note that the maximum codeword size is 255, so the
-  sum of your message length plus parity should be less than
-  or equal to this maximum limit.
-
-  In practice, you will get slooow error correction and decoding
-  if you use more than a reasonably small number of parity bytes.
-  (say, 10 or 20)
+  All state (galois tables, syndromes, error locator and evaluator
+  polynomials) lives in the codec object, so several codecs can be used
+  at the same time from different threads. A codec object itself must
+  not be used by two threads at once.
 
   ****************************************************************/
 #ifndef _ECC_H_
 #define _ECC_H_
-#define NPAR 64
-
-/****************************************************************/
-
-#define TRUE 1
-#define FALSE 0
-
-typedef unsigned long BIT32;
-typedef unsigned short BIT16;
 
-/* **************************************************************** */
-
-/* Maximum degree of various polynomials. */
-#define MAXDEG (NPAR*2)
-
-/*************************************/
-/* Encoder parity bytes */
-extern int pBytes[MAXDEG];
-
-/* Decoder syndrome bytes */
-extern int synBytes[MAXDEG];
-
-/* print debugging info */
-extern int RS_DEBUG;
-
-/* Reed Solomon encode/decode routines */
-void initialize_ecc (void);
-int check_syndrome (void);
-void decode_data (unsigned char data[], int nbytes);
-void encode_data (unsigned char msg[], int nbytes, unsigned char dst[]);
+#include <gpac/tools.h>
 
+/*number of parity bytes of DVB MPE-FEC RS(255,191) codewords*/
+#define NPAR 64
 
-/* galois arithmetic tables */
-extern int gexp[];
-extern int glog[];
+/*maximum codeword size*/
+#define GF_RS_MAX_CODEWORD	255
 
-void init_galois_tables (void);
-int ginv(int elt);
-int gmult(int a, int b);
+typedef struct __gf_rs_codec GF_RSCodec;
 
+/*creates a new codec for the given number of parity bytes (1 to 254)*/
+GF_RSCodec *gf_rs_new(u32 nb_parity);
+/*destroys codec*/
+void gf_rs_del(GF_RSCodec *rs);
+/*returns the number of parity bytes of the codec*/
+u32 gf_rs_get_parity_size(GF_RSCodec *rs);
 
-/* Error location routines */
-int correct_errors_erasures (unsigned char codeword[], int csize,int nerasures, int erasures[]);
+/*computes the nb_parity parity bytes of the msg_size bytes of msg, msg_size + nb_parity being at most 255*/
+GF_Err gf_rs_encode(GF_RSCodec *rs, const u8 *msg, u32 msg_size, u8 *parity);
 
-/* polynomial arithmetic */
-void add_polys(int dst[], int src[]) ;
-void scale_poly(int k, int poly[]);
-void mult_polys(int dst[], int p1[], int p2[]);
+/*checks and corrects a codeword in place (message followed by parity bytes, shortened codewords are allowed)
+	@erasures, @nb_erasures: positions in codeword of bytes known to be wrong, if any
+	@nb_corrected: set to the number of modified bytes, may be NULL
+returns GF_CORRUPTED_DATA if the codeword cannot be corrected, in which case it is left untouched. At most
+nb_parity erasures, or (nb_parity - nb_erasures)/2 errors at unknown positions can be corrected*/
+GF_Err gf_rs_decode(GF_RSCodec *rs, u8 *codeword, u32 size, const u32 *erasures, u32 nb_erasures, u32 *nb_corrected);
 
-void copy_poly(int dst[], int src[]);
-void zero_poly(int poly[]);
 #endif //_ECC_H_
@@ -83,6 +83,11 @@ enum
 	GF_ISOM_OPEN_CAT_FRAGMENTS,
 };
 
+/*flag for GF_ISOM_OPEN_READ: sample table boxes (stts, ctts, stss, stsc, stsz, stz2, stco, co64) are not parsed when opening the file
+but on first access to their track. Functions only querying track headers and sample descriptions don't load them.
+Fragmented files are always fully loaded*/
+#define GF_ISOM_OPEN_LAZY_TABLES	0x100
+
 /*Movie Options for file writing*/
 enum
 {
@@ -589,6 +594,10 @@ void gf_isom_delete(GF_ISOFile *the_file);
 /*Get the mode of an open file*/
 u8 gf_isom_get_mode(GF_ISOFile *the_file);
 
+/*loads sample tables of a file opened with GF_ISOM_OPEN_LAZY_TABLES
+trackNumber: track to load, or 0 to load all tracks*/
+GF_Err gf_isom_load_sample_tables(GF_ISOFile *the_file, u32 trackNumber);
+
 Bool gf_isom_is_JPEG2000(GF_ISOFile *mov);
 
 u64 gf_isom_get_file_size(GF_ISOFile *the_file);
@@ -761,11 +770,29 @@ Bool gf_isom_enable_raw_pack(GF_ISOFile *the_file, u32 trackNumber, u32 pack_num
 /*returns total amount of media bytes in track*/
 u64 gf_isom_get_media_data_size(GF_ISOFile *the_file, u32 trackNumber);
 
+/*returns the amount of memory in bytes used by the sample tables of the track (time to sample, composition offsets, sync samples,
+sample to chunk, sample sizes and chunk offsets). Tables not yet loaded (see GF_ISOM_OPEN_LAZY_TABLES) are not accounted*/
+u64 gf_isom_get_sample_table_memory(GF_ISOFile *the_file, u32 trackNumber);
+
 /*It may be desired to fetch samples with a bigger allocated buffer than their real size, in case the decoder
 reads more data than available. This sets the amount of extra bytes to allocate when reading samples from this track
 NOTE: the dataLength of the sample does NOT include padding*/
 GF_Err gf_isom_set_sample_padding(GF_ISOFile *the_file, u32 trackNumber, u32 padding_bytes);
 
+/*read position in the sample tables of a track. The sample tables keep the position of the last lookup
+so that reading samples in order is fast; when several readers use the same movie, each reader keeps its own
+position in a cursor, loaded before reading samples of the track and saved afterwards.
+Accesses to the movie must still be serialized by the caller*/
+typedef struct __isom_track_cursor GF_ISOTrackCursor;
+
+GF_ISOTrackCursor *gf_isom_track_cursor_new();
+void gf_isom_track_cursor_del(GF_ISOTrackCursor *cursor);
+/*restores the position of the cursor in the sample tables of the track. A cursor not yet saved, or saved
+for another track, resets the position to the first sample*/
+GF_Err gf_isom_track_cursor_load(GF_ISOFile *the_file, u32 trackNumber, GF_ISOTrackCursor *cursor);
+/*stores the current position in the sample tables of the track in the cursor*/
+GF_Err gf_isom_track_cursor_save(GF_ISOFile *the_file, u32 trackNumber, GF_ISOTrackCursor *cursor);
+
 /*return a sample given its number, and set the StreamDescIndex of this sample
 this index allows to retrieve the stream description if needed (2 media in 1 track)
 return NULL if error*/
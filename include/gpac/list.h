@@ -236,6 +236,113 @@ void* gf_list_pop_back(GF_List *ptr);
 
 /*! @} */
 
+/*!
+ *	\addtogroup fifo_grp FIFO
+ *	\ingroup utils_grp
+ *	\brief FIFO object
+ *
+ *	This section documents the FIFO object of the GPAC framework. The FIFO is a ring buffer of objects: adding an item
+ *	at the end of the FIFO, removing the first item and getting an item by index are done in constant time, whereas
+ *	removing the first item of a list is linear in the number of items in the list.
+ *	@{
+ */
+
+typedef struct _tag_fifo GF_Fifo;
+
+/*!
+ *	\brief FIFO constructor
+ *
+ *	Constructs a new FIFO object
+ *	\return new FIFO object
+ */
+GF_Fifo *gf_fifo_new();
+
+/*!
+ *	\brief FIFO destructor
+ *
+ *	Destructs a FIFO object
+ *	\param fifo FIFO object to destruct
+ *	\note It is the caller responsability to destroy the content of the FIFO if needed
+ */
+void gf_fifo_del(GF_Fifo *fifo);
+
+/*!
+ *	\brief reset FIFO
+ *
+ *	Resets the content of the FIFO
+ *	\param fifo target FIFO object
+ *	\note It is the caller responsability to destroy the content of the FIFO if needed
+ */
+void gf_fifo_reset(GF_Fifo *fifo);
+
+/*!
+ *	\brief get count
+ *
+ *	Returns number of items in the FIFO
+ *	\param fifo target FIFO object
+ *	\return number of items in the FIFO
+ */
+u32 gf_fifo_count(const GF_Fifo *fifo);
+
+/*!
+ *	\brief add item
+ *
+ *	Adds an item at the end of the FIFO
+ *	\param fifo target FIFO object
+ *	\param item item to add
+ */
+GF_Err gf_fifo_add(GF_Fifo *fifo, void *item);
+
+/*!
+ *	\brief pop first item
+ *
+ *	Removes the first item of the FIFO
+ *	\param fifo target FIFO object
+ *	\return the removed item, or NULL if the FIFO is empty
+ */
+void *gf_fifo_pop(GF_Fifo *fifo);
+
+/*!
+ *	\brief get first item
+ *
+ *	Gets the first item of the FIFO without removing it
+ *	\param fifo target FIFO object
+ *	\return the first item, or NULL if the FIFO is empty
+ */
+void *gf_fifo_head(GF_Fifo *fifo);
+
+/*!
+ *	\brief get item
+ *
+ *	Gets the item at the given position in the FIFO, 0 being the first item
+ *	\param fifo target FIFO object
+ *	\param itemNumber position of the item
+ *	\return the item, or NULL if not found
+ */
+void *gf_fifo_get(GF_Fifo *fifo, u32 itemNumber);
+
+/*!
+ *	\brief remove item
+ *
+ *	Removes the item at the given position in the FIFO. Removing the first item is done in constant time, removing
+ *	other items is linear in the number of items
+ *	\param fifo target FIFO object
+ *	\param itemNumber position of the item to remove
+ */
+GF_Err gf_fifo_rem(GF_Fifo *fifo, u32 itemNumber);
+
+/*!
+ *	\brief FIFO enumerator
+ *
+ *	Retrieves given FIFO item and increments current position
+ *	\param fifo target FIFO object
+ *	\param pos target item position. The position is automatically incremented regardless of the return value
+ *	\note A typical enumeration will start with a value of 0 until NULL is returned.
+ */
+void *gf_fifo_enum(GF_Fifo *fifo, u32 *pos);
+
+/*! @} */
+
 #ifdef __cplusplus
 }
 #endif
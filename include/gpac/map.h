@@ -40,7 +40,8 @@ extern "C" {
  *	\brief Hash Map
  *
  *	This section documents the map object of the GPAC framework
- *	\note The map use a random function for hashing. Collisions are resolved by using a GF_List on each slot.
+ *	\note The map is an open addressing hash table with linear probing, growing as entries are added. Keys are either
+ *	strings, copied in storage owned by the map, or 64 bit integers. The hash function can be provided by the user.
  *	@{
  */
 
@@ -56,6 +57,17 @@ extern "C" {
 typedef struct _tag_map GF_Map;
 
 
+/*!
+ *	\brief hash function
+ *
+ *	Computes the hash code of a key
+ *
+ *	\param key the key data: the string for string keys, the u64 in native byte order for integer keys
+ *	\param key_size the size of the key data in bytes
+ *	\return the hash code of the key
+ */
+typedef u32 (*gf_map_hash_function)(const u8 *key, u32 key_size);
+
 /* Pair structure */
 
 /**
@@ -83,10 +95,10 @@ typedef struct _it_map {
 	/* The current pair */
 	GF_Pair* pair;
 
-	/* The current list */
+	/* Unused */
 	u32 ilist;
 
-	/* The current index in the hasmap*/
+	/* The current slot in the hasmap*/
 	u32 hash;
 
 } GF_It_Map;
@@ -94,15 +106,25 @@ typedef struct _it_map {
 /*!
  *	\brief map constructor
  *
- *	Constructs a new map object
+ *	Constructs a new map object with string keys
  *
- *	\param hash_capacity the number of slot in the hash table
- *	\note a zero hash_capacity is not allowed, a hash_capacity of 1 is
- *	equivalent to a gf_list_find from GF_List with a complexity search in o(n)
+ *	\param hash_capacity the expected number of entries, the map grows if more entries are added. May be 0
  *	\return new map object
  */
 GF_Map *gf_map_new(u32 hash_capacity);
 
+/*!
+ *	\brief map constructor
+ *
+ *	Constructs a new map object
+ *
+ *	\param capacity the expected number of entries, the map grows if more entries are added. May be 0
+ *	\param int_keys if set, the map uses integer keys (gf_map_*_int functions), otherwise string keys
+ *	\param hash_fct the hash function to use, or NULL for the default one
+ *	\return new map object
+ */
+GF_Map *gf_map_new_ex(u32 capacity, Bool int_keys, gf_map_hash_function hash_fct);
+
 /*!
  *	\brief map destructor
  *
@@ -129,6 +151,7 @@ GF_Err gf_map_iter_set(GF_Map* map, GF_It_Map* it);
  *	Return the next value of a GF_Pair in the map
  *	\param it  the map iterator object
  *  \return the next value of the map if exists, otherwise NULL
+ *	\note entries may be removed while iterating. Inserting entries may grow the map and change the iteration order
  */
 void* gf_map_iter_has_next(GF_It_Map* it);
 
@@ -163,6 +186,49 @@ u32 gf_map_count(const GF_Map *ptr);
  */
 GF_Err gf_map_insert(GF_Map *ptr, const char* key, void* item);
 
+/*!
+ *	\brief add item with integer key
+ *
+ *	Adds an item in a map created with integer keys
+ *
+ *	\param ptr target map object
+ *	\param key the identified key
+ *	\param item item to add
+ *	\return GF_OK if insertion occurs properly, GF_NOT_SUPPORTED if the key already exists, a GF_Err in other cases
+ */
+GF_Err gf_map_insert_int(GF_Map *ptr, u64 key, void* item);
+
+/*!
+ *	\brief removes the couple key/item from the map
+ *
+ *	Removes an item from a map created with integer keys given to its key if exists
+ *
+ *	\param ptr target map object
+ *	\param key the key of the item.
+ *	\return GF_TRUE if the key has been delete, otherwise GF_FALSE
+ */
+Bool gf_map_rem_int(GF_Map *ptr, u64 key);
+
+/*!
+ *	\brief finds item with integer key
+ *
+ *	Finds a key in a map created with integer keys
+ *
+ *	\param ptr target map object.
+ *	\param key the key to find.
+ *	\return a pointer to the corresponding value if found, otherwise NULL.
+ */
+void* gf_map_find_int(GF_Map *ptr, u64 key);
+
+/*!
+ *	\brief Check if map contains integer key
+ *
+ *	\param ptr target map object.
+ *	\param key the key to check.
+ *	\return GF_TRUE if map contains keys, otherwise GF_FALSE
+ */
+Bool gf_map_has_key_int(GF_Map *ptr, u64 key);
+
 /*!
  *	\brief removes the couple key/item from the map
  *
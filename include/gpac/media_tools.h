@@ -965,6 +965,14 @@ GF_Err gf_dasher_set_cues(GF_DASHSegmenter *dasher, const char *cues_file, Bool
  */
 GF_Err gf_dasher_set_isobmff_options(GF_DASHSegmenter *dasher, Bool mvex_after_traks, Bool sdtp_in_traf);
 
+/*!
+ Enables HLS output. A master playlist and one media playlist per representation are written next to the MPD, using the segment timing and byte ranges of the DASH segmentation. Only available for static sessions.
+ *	\param dasher the DASH segmenter object
+ *	\param master_playlist name of the master playlist (only the file name is used), or NULL to disable HLS output
+ *	\return error code if any
+ */
+GF_Err gf_dasher_set_hls_output(GF_DASHSegmenter *dasher, const char *master_playlist);
+
 /*!
  Adds a media input to the DASHer
  *	\param dasher the DASH segmenter object
@@ -1200,8 +1200,9 @@ GF_Err gf_odf_codec_set_au(GF_ODCodec *codec, const char *au, u32 au_length);
  \return error if any
  */
 GF_Err gf_odf_codec_decode(GF_ODCodec *codec);
-/*! get the first OD command in the list. Once called, the command is removed
-from the command list. Return NULL when commandList is empty
+/*! get the first OD command in the list. Once called, the command is owned by the caller and no longer
+returned by the codec. It is removed from the command list once all commands have been retrieved or the codec
+is used again. Return NULL when commandList is empty
  \param codec target codec
  \return deocded command or NULL
  */
@@ -898,6 +898,9 @@ typedef struct
 	GF_M2TS_ES *stream;
 } GF_M2TS_SL_PCK;
 
+/*seek index of a TS file, giving the PTS and position of random access points of each PID and the PCRs of each program*/
+typedef struct __m2ts_seek_index GF_M2TS_SeekIndex;
+
 /*MPEG-2 TS demuxer*/
 struct tag_m2ts_demux
 {
@@ -1003,6 +1006,9 @@ struct tag_m2ts_demux
 	u64 nb_pck_at_pcr;
 
 	Bool paused;
+
+	/*seek index of the local file - created and destroyed by user*/
+	GF_M2TS_SeekIndex *seek_index;
 };
 
 GF_M2TS_Demuxer *gf_m2ts_demux_new();
@@ -1080,6 +1086,21 @@ void gf_m2ts_print_info(GF_M2TS_Demuxer *ts);
 */
 GF_Err gf_m2ts_demux_file(GF_M2TS_Demuxer *ts, const char *fileName, u64 start_byterange, u64 end_byterange, u32 refresh_type, Bool signal_end_of_stream);
 
+/*builds the seek index of the TS file in one pass. Random access points (and PCRs) of a PID closer than min_interval_ms to the previous indexed one are not indexed, 0 indexes all of them*/
+GF_Err gf_m2ts_seek_index_build(const char *fileName, u32 min_interval_ms, GF_M2TS_SeekIndex **out_index);
+/*saves the seek index in the given sidecar file*/
+GF_Err gf_m2ts_seek_index_save(GF_M2TS_SeekIndex *index, const char *indexName);
+/*loads the seek index of fileName from the given sidecar file - returns GF_BAD_PARAM if the index does not match the file*/
+GF_Err gf_m2ts_seek_index_load(const char *indexName, const char *fileName, GF_M2TS_SeekIndex **out_index);
+void gf_m2ts_seek_index_del(GF_M2TS_SeekIndex *index);
+/*gets the duration in seconds of the indexed file. The timeline of the index starts at the first PCR of the file*/
+Double gf_m2ts_seek_index_get_duration(GF_M2TS_SeekIndex *index);
+/*gets the time in seconds of the given 90kHz timestamp (PTS or PCR base)*/
+Double gf_m2ts_seek_index_get_time(GF_M2TS_SeekIndex *index, u64 timestamp);
+/*gets the position of the TS packet starting the last random access point of the PID at or before the given time in seconds, and the time of this random access point.
+If pid is 0, the seek PID of the index (video if any) is used*/
+GF_Err gf_m2ts_seek_index_find(GF_M2TS_SeekIndex *index, u32 pid, Double time, u64 *byte_offset, Double *rap_time);
+
 #endif /*GPAC_DISABLE_MPEG2TS*/
 
 
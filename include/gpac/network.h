@@ -302,6 +302,18 @@ GF_Err gf_sk_connect(GF_Socket *sock, const char *peer_name, u16 port, const cha
  *\param length the data length to send
  */
 GF_Err gf_sk_send(GF_Socket *sock, const char *buffer, u32 length);
+/*!
+ *\brief batched datagram emission
+ *
+ *Sends several datagrams on a UDP socket, using sendmmsg when available. The socket must be in a bound or connected mode
+ *\param sock the socket object
+ *\param buffers the data buffers to send, one per datagram
+ *\param sizes the size of each data buffer
+ *\param nb_buffers the number of data buffers
+ *\param nb_sent set to the number of datagrams sent
+ *\return error if any, GF_IP_SOCK_WOULD_BLOCK if not all datagrams could be sent
+ */
+GF_Err gf_sk_send_batch(GF_Socket *sock, const char **buffers, const u32 *sizes, u32 nb_buffers, u32 *nb_sent);
 /*!
  *\brief data reception
  *
@@ -315,6 +327,20 @@ GF_Err gf_sk_send(GF_Socket *sock, const char *buffer, u32 length);
  */
 GF_Err gf_sk_receive(GF_Socket *sock, char *buffer, u32 length, u32 start_from, u32 *read);
 
+/*!
+ *\brief batched datagram reception
+ *
+ *Fetches several datagrams on a UDP socket in one call. The call waits for the first datagram as \ref gf_sk_receive does, then grabs all datagrams already queued on the socket without waiting, using recvmmsg when available.
+ *\param sock the socket object
+ *\param buffers the reception buffers, one per datagram
+ *\param sizes set to the size of each received datagram
+ *\param buffer_size the allocated size of each reception buffer
+ *\param nb_buffers the number of reception buffers
+ *\param nb_read set to the number of datagrams received
+ *\return error if any, GF_IP_NETWORK_EMPTY if nothing to read
+ */
+GF_Err gf_sk_receive_batch(GF_Socket *sock, char **buffers, u32 *sizes, u32 buffer_size, u32 nb_buffers, u32 *nb_read);
+
 /*!
  *\brief socket listening
  *
@@ -451,7 +477,7 @@ s32 gf_sk_get_handle(GF_Socket *sock);
 void gf_sk_set_usec_wait(GF_Socket *sock, u32 usec_wait);
 
 /*!
- *Creates a new socket group
+ *Creates a new socket group. On Linux, the group is watched with epoll and is not limited to FD_SETSIZE sockets
  *\return socket group object
  */
 GF_SockGroup *gf_sk_group_new();
@@ -474,7 +500,7 @@ void gf_sk_group_register(GF_SockGroup *sg, GF_Socket *sk);
 void gf_sk_group_unregister(GF_SockGroup *sg, GF_Socket *sk);
 
 /*!
- *Performs a select (wait) on the socket group
+ *Performs a select (wait) on the socket group. Sockets of the group may be closed, deleted or unregistered by other threads during the select, but sockets shall only be registered by the thread performing the select.
  *\param sg socket group object
  *\param wait_usec microseconds to wait (can be larger than one second)
  *\return error if any
@@ -150,6 +150,26 @@ GF_Err gf_rtp_streamer_send_rtcp(GF_RTPStreamer *streamer, Bool force_ts, u32 rt
 
 u8 gf_rtp_streamer_get_payload_type(GF_RTPStreamer *streamer);
 
+/*!
+ *	\brief enables batched and paced emission
+ *
+ *	Queues RTP packets of the streamer and sends them by groups using a single system call when possible.
+ *	\param streamer RTP streamer object
+ *	\param nb_packets max number of queued packets. 0 disables batching
+ *	\param rate_kbps pacing rate in kilobits per second
+ *	\param pacing_us pacing granularity in microseconds: at most rate_kbps*pacing_us bits are sent at once. 0 disables pacing, queued packets are sent at each \ref gf_rtp_streamer_flush
+ */
+GF_Err gf_rtp_streamer_set_send_batch(GF_RTPStreamer *streamer, u32 nb_packets, u32 rate_kbps, u32 pacing_us);
+
+/*!
+ *	\brief sends queued packets
+ *
+ *	Sends packets queued when batching is enabled
+ *	\param streamer RTP streamer object
+ *	\param force if GF_FALSE, only sends packets allowed by pacing and returns, otherwise waits until all packets are sent
+ */
+GF_Err gf_rtp_streamer_flush(GF_RTPStreamer *streamer, Bool force);
+
 /*! @} */
 
 #ifdef __cplusplus
@@ -348,6 +348,40 @@ typedef struct {
 	u64 den;
 } GF_Fraction;
 
+/*!
+ * Memory accounting tags
+ *	\hideinitializer
+ *
+ * Subsystems of the allocations. Each compilation unit of libgpac and of the modules is built with GF_MEM_TAG set to
+ * its tag by the build system, and gf_malloc and co. then pass that tag to the allocator, in builds with and without
+ * memory tracking. Allocations from units built without GF_MEM_TAG, such as applications, are tagged GF_MEM_TAG_OTHER
+ */
+typedef enum
+{
+	/*! allocations not belonging to any other tag*/
+	GF_MEM_TAG_OTHER = 0,
+	/*! core tools*/
+	GF_MEM_TAG_CORE,
+	/*! ISO base media file format*/
+	GF_MEM_TAG_ISOMEDIA,
+	/*! media tools not belonging to any other tag (importers, exporters, parsers)*/
+	GF_MEM_TAG_MEDIA_TOOLS,
+	/*! DASH and HLS segmenter and client*/
+	GF_MEM_TAG_DASH,
+	/*! MPEG-2 TS demuxer and muxer*/
+	GF_MEM_TAG_MPEG2TS,
+	/*! HTTP downloader and cache*/
+	GF_MEM_TAG_DOWNLOADER,
+	/*! terminal*/
+	GF_MEM_TAG_TERMINAL,
+	/*! compositor*/
+	GF_MEM_TAG_COMPOSITOR,
+	/*! modules*/
+	GF_MEM_TAG_MODULES,
+	/*! number of tags*/
+	GF_MEM_TAG_MAX
+} GF_MemTag;
+
 /*GPAC memory tracking*/
 #if defined(GPAC_MEMORY_TRACKING)
 
@@ -359,11 +393,24 @@ char *gf_mem_strdup(const char *str, const char *filename, int line);
 void gf_memory_print(void); /*prints the state of current allocations*/
 u64 gf_memory_size(); /*gets memory allocated in bytes*/
 
+/*same as above with the accounting tag of the caller*/
+void *gf_mem_malloc_tag(size_t size, u32 tag, const char *filename, int line);
+void *gf_mem_calloc_tag(size_t num, size_t size_of, u32 tag, const char *filename, int line);
+void *gf_mem_realloc_tag(void *ptr, size_t size, u32 tag, const char *filename, int line);
+char *gf_mem_strdup_tag(const char *str, u32 tag, const char *filename, int line);
+
 #define gf_free(ptr) gf_mem_free(ptr, __FILE__, __LINE__)
+#ifdef GF_MEM_TAG
+#define gf_malloc(size) gf_mem_malloc_tag(size, GF_MEM_TAG, __FILE__, __LINE__)
+#define gf_calloc(num, size_of) gf_mem_calloc_tag(num, size_of, GF_MEM_TAG, __FILE__, __LINE__)
+#define gf_strdup(s) gf_mem_strdup_tag(s, GF_MEM_TAG, __FILE__, __LINE__)
+#define gf_realloc(ptr1, size) gf_mem_realloc_tag(ptr1, size, GF_MEM_TAG, __FILE__, __LINE__)
+#else
 #define gf_malloc(size) gf_mem_malloc(size, __FILE__, __LINE__)
 #define gf_calloc(num, size_of) gf_mem_calloc(num, size_of, __FILE__, __LINE__)
 #define gf_strdup(s) gf_mem_strdup(s, __FILE__, __LINE__)
 #define gf_realloc(ptr1, size) gf_mem_realloc(ptr1, size, __FILE__, __LINE__)
+#endif
 
 #else
 
@@ -373,6 +420,19 @@ void* gf_realloc(void *ptr, size_t size);
 void gf_free(void *ptr);
 char* gf_strdup(const char *str);
 
+/*same as above with the accounting tag of the caller*/
+void* gf_malloc_tag(size_t size, u32 tag);
+void* gf_calloc_tag(size_t num, size_t size_of, u32 tag);
+void* gf_realloc_tag(void *ptr, size_t size, u32 tag);
+char* gf_strdup_tag(const char *str, u32 tag);
+
+#ifdef GF_MEM_TAG
+#define gf_malloc(size) gf_malloc_tag(size, GF_MEM_TAG)
+#define gf_calloc(num, size_of) gf_calloc_tag(num, size_of, GF_MEM_TAG)
+#define gf_realloc(ptr1, size) gf_realloc_tag(ptr1, size, GF_MEM_TAG)
+#define gf_strdup(s) gf_strdup_tag(s, GF_MEM_TAG)
+#endif
+
 #endif
 
 
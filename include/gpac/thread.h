@@ -280,6 +280,130 @@ void gf_sema_wait(GF_Semaphore *sm);
 Bool gf_sema_wait_for(GF_Semaphore *sm, u32 time_out);
 
 
+/*********************************************************************
+					Thread Pool Object
+**********************************************************************/
+/*!
+ *\brief thread pool object
+ *
+ *The thread pool object runs tasks on a fixed set of threads. Tasks are run in submission order, pending tasks are run
+ *before the pool is destroyed.
+*/
+typedef struct __tag_thread_pool GF_ThreadPool;
+/*!
+ *\brief thread pool task object
+ *
+ *Handle on a task submitted to a thread pool, used to wait for its result.
+*/
+typedef struct __tag_thread_task GF_ThreadTask;
+
+/*!
+ *\brief task callback
+ *
+ *Runs a task in a thread of the pool
+ *\param udta opaque user data of the task
+ *\return error code of the task
+ */
+typedef GF_Err (*gf_th_task_run)(void *udta);
+/*!
+ *\brief task completion callback
+ *
+ *Called in the thread of the pool which ran the task, after the task is done
+ *\param cbk opaque user data of the completion callback
+ *\param e error code returned by the task
+ */
+typedef void (*gf_th_task_done)(void *cbk, GF_Err e);
+/*!
+ *\brief range callback
+ *
+ *Processes the items of a range in a parallel loop
+ *\param udta opaque user data of the loop
+ *\param start index of the first item of the range
+ *\param end index of the item after the last item of the range
+ *\return error code, any error stops the loop
+ */
+typedef GF_Err (*gf_th_range_run)(void *udta, u32 start, u32 end);
+
+/*
+ *\brief thread pool constructor
+ *
+ *Constructs a new thread pool and starts its threads
+ *\param name log name of the pool threads if any
+ *\param nb_threads number of threads of the pool. If 0, one thread per CPU core is used
+ *\return the thread pool object
+ */
+GF_ThreadPool *gf_th_pool_new(const char *name, u32 nb_threads);
+/*
+ *\brief thread pool destructor
+ *
+ *Runs all pending tasks, then stops the threads and destroys the pool. Tasks shall not be posted from other threads while
+ *destroying the pool.
+ *\param pool the thread pool object
+ */
+void gf_th_pool_del(GF_ThreadPool *pool);
+/*
+ *\brief thread pool size
+ *
+ *Gets the number of threads of the pool
+ *\param pool the thread pool object
+ *\return the number of threads
+ */
+u32 gf_th_pool_get_thread_count(GF_ThreadPool *pool);
+/*
+ *\brief task posting
+ *
+ *Queues a task in the pool without waiting for its result
+ *\param pool the thread pool object
+ *\param run the task callback
+ *\param udta opaque user data passed to the task
+ *\param on_done completion callback, may be NULL
+ *\param done_cbk opaque user data passed to the completion callback
+ *\return error if any
+ */
+GF_Err gf_th_pool_post(GF_ThreadPool *pool, gf_th_task_run run, void *udta, gf_th_task_done on_done, void *done_cbk);
+/*
+ *\brief task submission
+ *
+ *Queues a task in the pool. The task result shall be retrieved using \ref gf_th_pool_wait
+ *\param pool the thread pool object
+ *\param run the task callback
+ *\param udta opaque user data passed to the task
+ *\return the task object, or NULL if error
+ */
+GF_ThreadTask *gf_th_pool_submit(GF_ThreadPool *pool, gf_th_task_run run, void *udta);
+/*
+ *\brief task status
+ *
+ *Checks if a submitted task is done
+ *\param task the task object
+ *\return GF_TRUE if the task is done
+ */
+Bool gf_th_pool_task_done(GF_ThreadTask *task);
+/*
+ *\brief task wait
+ *
+ *Waits for a submitted task to be done and destroys the task object. Pending tasks of the pool may be run by the caller while waiting.
+ *\param pool the thread pool object
+ *\param task the task object
+ *\return the error code returned by the task
+ */
+GF_Err gf_th_pool_wait(GF_ThreadPool *pool, GF_ThreadTask *task);
+/*
+ *\brief parallel loop
+ *
+ *Splits the items from start to end (excluded) in ranges and processes them in the pool threads and in the caller thread.
+ *Returns when all ranges are processed. May be called from a task of the pool.
+ *\param pool the thread pool object
+ *\param start index of the first item
+ *\param end index of the item after the last item
+ *\param grain number of items per range. If 0, the items are split in 4 ranges per thread
+ *\param run the range callback
+ *\param udta opaque user data passed to the range callback
+ *\return the first error returned by a range callback if any
+ */
+GF_Err gf_th_pool_parallel_for(GF_ThreadPool *pool, u32 start, u32 end, u32 grain, gf_th_range_run run, void *udta);
+
+
 /*! @} */
 
 #ifdef __cplusplus
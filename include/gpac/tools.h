@@ -524,6 +524,83 @@ void gf_log_set_tool_level(GF_LOG_Tool tool, GF_LOG_Level level);
 #endif
 
 
+/*!
+ *	\brief Trace event types
+ *
+ *	Types of the events recorded by \ref GF_TRACE
+*/
+typedef enum
+{
+	/*! begin of a span*/
+	GF_TRACE_BEGIN = 0,
+	/*! end of a span, the name and tool shall be the ones of the begin event*/
+	GF_TRACE_END,
+	/*! instant event*/
+	GF_TRACE_INSTANT,
+	/*! counter value*/
+	GF_TRACE_COUNTER,
+} GF_TraceEventType;
+
+/*!
+ *	\brief Trace start
+ *
+ *	Starts recording trace events. Each thread records its events in its own ring of events, the oldest events of a thread are overwritten when its ring is full.
+ *	\param file name of the Chrome trace JSON file written by \ref gf_trace_stop and at \ref gf_sys_close, may be NULL
+ *	\param nb_events number of events kept per thread, rounded up to a power of 2. If 0, the default of 65536 events is used
+ *	\return GF_OK, or GF_NOT_SUPPORTED if tracing is not available in this build
+*/
+GF_Err gf_trace_start(const char *file, u32 nb_events);
+
+/*!
+ *	\brief Trace stop
+ *
+ *	Stops recording trace events and writes the file given at \ref gf_trace_start if any. Recorded events are kept until the next start.
+ *	\return error if any
+*/
+GF_Err gf_trace_stop();
+
+/*!
+ *	\brief Trace dump
+ *
+ *	Writes the recorded events in the Chrome trace JSON format, which can be loaded in chrome://tracing or Perfetto. The dump may be done while tracing,
+ *	in which case events recorded by running threads during the dump are not written.
+ *	\param file name of the trace file
+ *	\return error if any
+*/
+GF_Err gf_trace_dump(const char *file);
+
+/*!
+ *	\brief Trace state
+ *
+ *	Checks if trace events are recorded
+ *	\return GF_TRUE if tracing
+*/
+Bool gf_trace_on();
+
+/*!
+ *	\brief Trace event
+ *
+ *	Records a trace event in the ring of the calling thread. Use \ref GF_TRACE rather than calling this function.
+ *	\param type type of the event
+ *	\param tool tool emitting the event, used as event category
+ *	\param name name of the event. The string is not copied and shall be a static string
+ *	\param value counter value, ignored for other events
+*/
+void gf_trace_event(GF_TraceEventType type, GF_LOG_Tool tool, const char *name, s64 value);
+
+#ifdef GPAC_DISABLE_LOG
+#define GF_TRACE(_type, _tool, _name, _value)
+#else
+/*!
+ *	\brief Event tracing
+ *	\hideinitializer
+ *
+ *	Macro for recording trace events. Usage is GF_TRACE(event_type, log_tool, "name", value); The event is only recorded when tracing, otherwise only the trace state is checked.
+*/
+#define GF_TRACE(_type, _tool, _name, _value) (gf_trace_on() ? gf_trace_event(_type, _tool, _name, _value) : (void) 0)
+#endif
+
+
 /*!
  *	\brief PseudoRandom Integer Generation Initialization
  *
@@ -720,6 +797,8 @@ typedef enum
     GF_MemTrackerSimple,
     /*! Memory tracking with backtrace*/
     GF_MemTrackerBackTrace,
+    /*! Per-subsystem accounting of allocations, see \ref gf_memory_tag_stats*/
+    GF_MemTrackerAccounting,
 } GF_MemTrackerType;
 
 /*!
@@ -730,6 +809,53 @@ typedef enum
  *	\note This can be called several times but only the first call will result in system setup.
  */
 void gf_sys_init(GF_MemTrackerType mem_tracker_type);
+
+/*!
+ * Memory accounting counters of a tag
+ */
+typedef struct
+{
+	/*! bytes currently allocated*/
+	u64 current;
+	/*! maximum number of bytes allocated at once*/
+	u64 peak;
+	/*! number of allocations*/
+	u64 nb_alloc;
+	/*! number of deallocations*/
+	u64 nb_free;
+} GF_MemTagStats;
+
+/*!
+ *	\brief Memory accounting query
+ *
+ *	Gets the allocation counters of a tag. Memory accounting is enabled when \ref gf_sys_init is called with GF_MemTrackerAccounting. Allocations are tagged with the GF_MEM_TAG of their compilation unit, see \ref GF_MemTag.
+ *	\param tag the tag to query
+ *	\param stats filled with the counters of the tag
+ *	\return GF_TRUE if memory accounting is enabled, GF_FALSE otherwise
+ */
+Bool gf_memory_tag_stats(GF_MemTag tag, GF_MemTagStats *stats);
+/*!
+ *	\brief Memory accounting tag name
+ *
+ *	Gets the name of a tag
+ *	\param tag the tag
+ *	\return the name of the tag, or NULL if the tag is not valid
+ */
+const char *gf_memory_tag_name(GF_MemTag tag);
+/*!
+ *	\brief Memory accounting print
+ *
+ *	Logs the allocation counters of all tags, using the memory log tool at info level
+ */
+void gf_memory_print_tags();
+/*!
+ *	\brief Memory accounting periodic print
+ *
+ *	Logs the allocation counters of all tags at regular interval from a dedicated thread, until \ref gf_sys_close is called
+ *	\param period_ms interval between two prints in milliseconds, 0 stops printing
+ *	\return error if any
+ */
+GF_Err gf_memory_set_tags_dump_period(u32 period_ms);
 /*!
  *	\brief System closing
  *
@@ -1074,6 +1200,44 @@ void gf_sha1_csum(u8 *buf, u32 buflen, u8 digest[GF_SHA1_DIGEST_SIZE]);
  */
 void gf_sha1_csum_hexa(u8 *buf, u32 buflen, u8 digest[GF_SHA1_DIGEST_SIZE_HEXA]);
 
+/*SHA-1 implementations*/
+typedef enum
+{
+	/*best implementation for the CPU, selected at first use. Multi-buffer hashing uses AVX2 when available and enough
+	streams have data, even if another implementation is used for single streams*/
+	GF_SHA1_IMPL_AUTO = 0,
+	/*portable C*/
+	GF_SHA1_IMPL_C,
+	/*x86 SHA extensions, in single stream and multi-buffer mode*/
+	GF_SHA1_IMPL_SHA_NI,
+	/*x86 AVX2, hashing 8 streams at once in multi-buffer mode, portable C otherwise*/
+	GF_SHA1_IMPL_AVX2,
+} GF_SHA1Impl;
+
+/*
+ * Forces the SHA-1 implementation, returns GF_NOT_SUPPORTED if not available on this CPU. This is a global setting,
+ * it should not be changed while hashing.
+ */
+GF_Err gf_sha1_set_implementation(GF_SHA1Impl impl);
+/*
+ * Gets the SHA-1 implementation in use
+ */
+GF_SHA1Impl gf_sha1_get_implementation();
+
+/*Multi-buffer SHA-1: computes the digests of several independent streams at once*/
+typedef struct __sha1_multi_context GF_SHA1MultiContext;
+/*  Create multi-buffer SHA-1 context for nb_streams streams */
+GF_SHA1MultiContext *gf_sha1_multi_starts(u32 nb_streams);
+/*  Adds data to each stream: inputs[i] and lengths[i] give the next bytes of stream i. Streams may be given no data
+(NULL or 0 length) and different amounts of data, the gain being the highest for streams of similar sizes */
+void gf_sha1_multi_update(GF_SHA1MultiContext *ctx, u8 **inputs, u32 *lengths);
+/*  Generates SHA-1 of all bytes ingested by each stream and destroys the context */
+void gf_sha1_multi_finish(GF_SHA1MultiContext *ctx, u8 (*digests)[GF_SHA1_DIGEST_SIZE]);
+/*
+ * Gets SHA-1 of each input buffer
+ */
+void gf_sha1_csum_multi(u8 **buffers, u32 *lengths, u32 nb_buffers, u8 (*digests)[GF_SHA1_DIGEST_SIZE]);
+
 /*! @} */
 
 
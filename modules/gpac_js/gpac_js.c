@@ -91,7 +91,7 @@ typedef struct
 	//list of config files for storage
 	GF_List *storages;
 
-	GF_List *event_queue;
+	GF_Fifo *event_queue;
 	GF_Mutex *event_mx;
 
 } GF_GPACJSExt;
@@ -1936,7 +1936,7 @@ static Bool gjs_event_filter(void *udta, GF_Event *evt, Bool consumed_by_composi
 		gf_mx_p(gjs->event_mx);
 		evt_clone = gf_malloc(sizeof(GF_Event));
 		memcpy(evt_clone, evt, sizeof(GF_Event));
-		gf_list_add(gjs->event_queue, evt_clone);
+		gf_fifo_add(gjs->event_queue, evt_clone);
 		GF_LOG(GF_LOG_INFO, GF_LOG_COMPOSE, ("[GPACJS] Couldn't lock % mutex, queing event\n", (lock_fail==2) ? "JavaScript" : "Compositor"));
 		gf_mx_v(gjs->event_mx);
 
@@ -1947,8 +1947,8 @@ static Bool gjs_event_filter(void *udta, GF_Event *evt, Bool consumed_by_composi
 	}
 	
 	gf_mx_p(gjs->event_mx);
-	while (gf_list_count(gjs->event_queue)) {
-		GF_Event *an_evt = (GF_Event *) gf_list_pop_front(gjs->event_queue);
+	while (gf_fifo_count(gjs->event_queue)) {
+		GF_Event *an_evt = (GF_Event *) gf_fifo_pop(gjs->event_queue);
 		gjs_event_filter_process(gjs, an_evt);
 		gf_free(an_evt);
 	}
@@ -2454,7 +2454,7 @@ GF_JSUserExtension *gjs_new()
 	gjs->rti_refresh_rate = GPAC_JS_RTI_REFRESH_RATE;
 	gjs->evt_fun = JSVAL_NULL;
 	gjs->storages = gf_list_new();
-	gjs->event_queue = gf_list_new();
+	gjs->event_queue = gf_fifo_new();
 	gjs->event_mx = gf_mx_new("GPACJSEvt");
 	dr->load = gjs_load;
 	dr->udta = gjs;
@@ -2474,11 +2474,11 @@ void gjs_delete(GF_BaseInterface *ifce)
 	}
 	gf_list_del(gjs->storages);
 
-	while (gf_list_count(gjs->event_queue)) {
-		GF_Event *evt = (GF_Event *) gf_list_pop_back(gjs->event_queue);
+	while (gf_fifo_count(gjs->event_queue)) {
+		GF_Event *evt = (GF_Event *) gf_fifo_pop(gjs->event_queue);
 		gf_free(evt);
 	}
-	gf_list_del(gjs->event_queue);
+	gf_fifo_del(gjs->event_queue);
 	gf_mx_del(gjs->event_mx);
 
 	gf_free(gjs);
@@ -41,6 +41,20 @@
 
 //#define DASH_USE_PULL
 
+/*parsed movie shared by all services playing the same local file*/
+typedef struct
+{
+	/*file path and modification time at open*/
+	char *path;
+	u64 mtime;
+	/*parsed movie, NULL if open failed*/
+	GF_ISOFile *mov;
+	GF_Err open_error;
+	/*serializes all accesses to the movie, held during open*/
+	GF_Mutex *mx;
+	u32 nb_refs;
+} ISOMSharedMovie;
+
 typedef struct
 {
 	GF_InputService *input;
@@ -52,6 +66,8 @@ typedef struct
 
 	/*input file*/
 	GF_ISOFile *mov;
+	/*set if mov is shared with other services, NULL otherwise*/
+	ISOMSharedMovie *shared;
 	u32 time_scale;
 	u32 nb_playing;
 
@@ -131,8 +147,12 @@ typedef struct
 
 	Bool disable_seek;
 	u32 nalu_extract_mode;
+	u32 padding_bytes;
 
 	u32 last_sample_desc_index;
+
+	/*position in the sample tables of the track, kept per channel when the movie is shared*/
+	GF_ISOTrackCursor *cursor;
 } ISOMChannel;
 
 void isor_reset_reader(ISOMChannel *ch);
@@ -158,6 +178,19 @@ void isor_send_cenc_config(ISOMChannel *ch);
 
 void isor_flush_data(ISOMReader *read, Bool check_buffer_level, Bool is_chunk_flush);
 
+/*shared movie cache*/
+void isor_share_init();
+void isor_share_uninit();
+/*opens the file through the shared cache. On success, read->mov and read->shared are set.
+If the file cannot be shared (fragmented or incomplete), returns GF_NOT_SUPPORTED and read->mov may be set to a private movie*/
+GF_Err isor_share_open(ISOMReader *read, const char *path);
+void isor_share_close(ISOMReader *read);
+/*lock/unlock the movie of the reader, no-op if not shared.
+Lock order is the segment mutex of the reader, then the mutex of the shared movie: the lock takes both, so that
+code holding the segment mutex (sample fetch) and code holding the movie lock (service commands) cannot deadlock*/
+void isor_share_lock(ISOMReader *read);
+void isor_share_unlock(ISOMReader *read);
+
 #ifndef GPAC_DISABLE_ISOM_WRITE
 GF_BaseInterface *isow_load_cache();
 void isow_delete_cache(GF_BaseInterface *bi);
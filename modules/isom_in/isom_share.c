@@ -0,0 +1,185 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2000-2012
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / MP4 reader module
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+
+#include "isom_in.h"
+
+#ifndef GPAC_DISABLE_ISOM
+
+/*movies currently opened, shared by all reader instances of the module*/
+static GF_List *shared_movies = NULL;
+static GF_Mutex *shared_mx = NULL;
+static u32 nb_share_users = 0;
+
+/*called upon interface load, serialized by the module manager*/
+void isor_share_init()
+{
+	if (!shared_mx) {
+		shared_mx = gf_mx_new("ISOSharedMovies");
+		shared_movies = gf_list_new();
+	}
+	gf_mx_p(shared_mx);
+	nb_share_users++;
+	gf_mx_v(shared_mx);
+}
+
+void isor_share_uninit()
+{
+	GF_Mutex *mx;
+	if (!shared_mx) return;
+	gf_mx_p(shared_mx);
+	assert(nb_share_users);
+	nb_share_users--;
+	if (nb_share_users) {
+		gf_mx_v(shared_mx);
+		return;
+	}
+	/*all services are closed at this point*/
+	assert(!gf_list_count(shared_movies));
+	gf_list_del(shared_movies);
+	shared_movies = NULL;
+	mx = shared_mx;
+	shared_mx = NULL;
+	gf_mx_v(mx);
+	gf_mx_del(mx);
+}
+
+static void isor_share_release(ISOMSharedMovie *sm)
+{
+	gf_mx_p(shared_mx);
+	assert(sm->nb_refs);
+	sm->nb_refs--;
+	if (sm->nb_refs) {
+		gf_mx_v(shared_mx);
+		return;
+	}
+	gf_list_del_item(shared_movies, sm);
+	gf_mx_v(shared_mx);
+
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[IsoMedia] Closing shared movie %s\n", sm->path));
+	if (sm->mov) gf_isom_close(sm->mov);
+	gf_mx_del(sm->mx);
+	gf_free(sm->path);
+	gf_free(sm);
+}
+
+GF_Err isor_share_open(ISOMReader *read, const char *path)
+{
+	u32 i, count;
+	u64 mtime, missing_bytes;
+	GF_ISOFile *mov;
+	GF_Err e;
+	ISOMSharedMovie *sm;
+
+	if (!shared_mx) return GF_NOT_SUPPORTED;
+	mtime = gf_file_modification_time(path);
+
+	gf_mx_p(shared_mx);
+	count = gf_list_count(shared_movies);
+	for (i=0; i<count; i++) {
+		sm = (ISOMSharedMovie *)gf_list_get(shared_movies, i);
+		/*a file modified since opened is a new entry, the old one stays alive until all its users are gone*/
+		if ((sm->mtime != mtime) || strcmp(sm->path, path)) continue;
+
+		sm->nb_refs++;
+		gf_mx_v(shared_mx);
+		/*wait for the open to complete if another service is parsing the file*/
+		gf_mx_p(sm->mx);
+		e = sm->open_error;
+		gf_mx_v(sm->mx);
+		if (e) {
+			isor_share_release(sm);
+			return e;
+		}
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[IsoMedia] Reusing shared movie %s (%d users)\n", path, sm->nb_refs));
+		read->shared = sm;
+		read->mov = sm->mov;
+		read->missing_bytes = 0;
+		return GF_OK;
+	}
+
+	GF_SAFEALLOC(sm, ISOMSharedMovie);
+	if (!sm) {
+		gf_mx_v(shared_mx);
+		return GF_OUT_OF_MEM;
+	}
+	sm->path = gf_strdup(path);
+	sm->mtime = mtime;
+	sm->nb_refs = 1;
+	sm->mx = gf_mx_new("ISOSharedMovie");
+	/*lock before publishing the entry so that other services wait for the parsing*/
+	gf_mx_p(sm->mx);
+	gf_list_add(shared_movies, sm);
+	gf_mx_v(shared_mx);
+
+	mov = NULL;
+	missing_bytes = 0;
+	e = gf_isom_open_progressive(path, 0, 0, &mov, &missing_bytes);
+	if (!e && (missing_bytes || gf_isom_is_fragmented(mov))) {
+		/*file may be refreshed, keep it private to this service*/
+		read->mov = mov;
+		read->missing_bytes = missing_bytes;
+		mov = NULL;
+		e = GF_NOT_SUPPORTED;
+	}
+	sm->mov = mov;
+	sm->open_error = e;
+	gf_mx_v(sm->mx);
+
+	if (e) {
+		isor_share_release(sm);
+		return e;
+	}
+	read->shared = sm;
+	read->mov = sm->mov;
+	read->missing_bytes = 0;
+	return GF_OK;
+}
+
+void isor_share_close(ISOMReader *read)
+{
+	ISOMSharedMovie *sm = read->shared;
+	if (!sm) return;
+	read->shared = NULL;
+	read->mov = NULL;
+	isor_share_release(sm);
+}
+
+/*the segment mutex is always taken before the movie mutex (both are recursive)*/
+void isor_share_lock(ISOMReader *read)
+{
+	if (!read->shared) return;
+	gf_mx_p(read->segment_mutex);
+	gf_mx_p(read->shared->mx);
+}
+
+void isor_share_unlock(ISOMReader *read)
+{
+	if (!read->shared) return;
+	gf_mx_v(read->shared->mx);
+	gf_mx_v(read->segment_mutex);
+}
+
+#endif /*GPAC_DISABLE_ISOM*/
@@ -46,6 +46,7 @@ static void isor_delete_channel(ISOMReader *reader, ISOMChannel *ch)
 	while ((ch2 = (ISOMChannel *)gf_list_enum(reader->channels, &i))) {
 		if (ch2 == ch) {
 			isor_reset_reader(ch);
+			if (ch->cursor) gf_isom_track_cursor_del(ch->cursor);
 			gf_free(ch);
 			gf_list_rem(reader->channels, i-1);
 			return;
@@ -409,7 +410,20 @@ GF_Err ISOR_ConnectService(GF_InputService *plug, GF_ClientService *serv, const
 				end_range = param.url_query.end_range;
 			}
 		}
-		e = gf_isom_open_progressive(szURL, start_range, end_range, &read->mov, &read->missing_bytes);
+		e = GF_NOT_SUPPORTED;
+		/*if enabled, fully local files are parsed once and shared between all services playing them*/
+		if (!plug->query_proxy && !start_range && !end_range) {
+			const char *opt = gf_modules_get_option((GF_BaseInterface *)plug, "ISOReader", "ShareMovies");
+			if (!opt) gf_modules_set_option((GF_BaseInterface *)plug, "ISOReader", "ShareMovies", "no");
+			if (opt && !strcmp(opt, "yes")) {
+				e = isor_share_open(read, szURL);
+			}
+		}
+		if (!read->mov) {
+			e = gf_isom_open_progressive(szURL, start_range, end_range, &read->mov, &read->missing_bytes);
+		} else if (e==GF_NOT_SUPPORTED) {
+			e = GF_OK;
+		}
 		if (e != GF_OK) {
 			GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[IsoMedia] error while opening %s, error=%s\n", szURL, gf_error_to_string(e)));
 			if (read->input->query_proxy && read->input->proxy_udta && read->input->proxy_type) {
@@ -430,7 +444,11 @@ GF_Err ISOR_ConnectService(GF_InputService *plug, GF_ClientService *serv, const
 			gf_service_connect_ack(read->service, NULL, GF_OK);
 		}
 
-		if (read->no_service_desc)	isor_declare_objects(read);
+		if (read->no_service_desc) {
+			isor_share_lock(read);
+			isor_declare_objects(read);
+			isor_share_unlock(read);
+		}
 
 	} else {
 		/*setup downloader*/
@@ -458,7 +476,8 @@ GF_Err ISOR_CloseService(GF_InputService *plug)
 	if (read->dnload) gf_service_download_del(read->dnload);
 	read->dnload = NULL;
 
-	if (read->mov) gf_isom_close(read->mov);
+	if (read->shared) isor_share_close(read);
+	else if (read->mov) gf_isom_close(read->mov);
 	read->mov = NULL;
 
 	if (read->input->query_proxy && read->input->proxy_udta && read->input->proxy_type) {
@@ -547,7 +566,7 @@ static u32 get_track_id(GF_ISOFile *mov, u32 media_type, u32 idx)
 }
 
 /*fixme, this doesn't work properly with respect to @expect_type*/
-static GF_Descriptor *ISOR_GetServiceDesc(GF_InputService *plug, u32 expect_type, const char *sub_url)
+static GF_Descriptor *isor_get_service_desc(GF_InputService *plug, u32 expect_type, const char *sub_url)
 {
 	u32 count, nb_st, i, trackID;
 	GF_ESD *esd;
@@ -725,7 +744,7 @@ void isor_send_cenc_config(ISOMChannel *ch)
 
 
 
-GF_Err ISOR_ConnectChannel(GF_InputService *plug, LPNETCHANNEL channel, const char *url, Bool upstream)
+static GF_Err isor_connect_channel(GF_InputService *plug, LPNETCHANNEL channel, const char *url, Bool upstream)
 {
 	u32 ESID;
 	ISOMChannel *ch;
@@ -898,6 +917,31 @@ exit:
 	return e;
 }
 
+/*all calls accessing the movie are serialized when the movie is shared with other services*/
+static GF_Descriptor *ISOR_GetServiceDesc(GF_InputService *plug, u32 expect_type, const char *sub_url)
+{
+	GF_Descriptor *desc;
+	ISOMReader *read;
+	if (!plug || !plug->priv) return NULL;
+	read = (ISOMReader *) plug->priv;
+	isor_share_lock(read);
+	desc = isor_get_service_desc(plug, expect_type, sub_url);
+	isor_share_unlock(read);
+	return desc;
+}
+
+GF_Err ISOR_ConnectChannel(GF_InputService *plug, LPNETCHANNEL channel, const char *url, Bool upstream)
+{
+	GF_Err e;
+	ISOMReader *read;
+	if (!plug || !plug->priv) return GF_SERVICE_ERROR;
+	read = (ISOMReader *) plug->priv;
+	isor_share_lock(read);
+	e = isor_connect_channel(plug, channel, url, upstream);
+	isor_share_unlock(read);
+	return e;
+}
+
 GF_Err ISOR_DisconnectChannel(GF_InputService *plug, LPNETCHANNEL channel)
 {
 	ISOMChannel *ch;
@@ -1043,7 +1087,7 @@ u32 gf_channel_switch_quality(ISOMChannel *ch, GF_ISOFile *the_file, Bool switch
 }
 
 
-GF_Err ISOR_ServiceCommand(GF_InputService *plug, GF_NetworkCommand *com)
+static GF_Err isor_service_command(GF_InputService *plug, GF_NetworkCommand *com)
 {
 	Double track_dur, media_dur;
 	ISOMChannel *ch;
@@ -1111,6 +1155,7 @@ GF_Err ISOR_ServiceCommand(GF_InputService *plug, GF_NetworkCommand *com)
 	switch (com->command_type) {
 	case GF_NET_CHAN_SET_PADDING:
 		if (!ch->track) return GF_OK;
+		ch->padding_bytes = com->pad.padding_bytes;
 		gf_isom_set_sample_padding(read->mov, ch->track, com->pad.padding_bytes);
 		return GF_OK;
 	case GF_NET_CHAN_SET_PULL:
@@ -1244,6 +1289,18 @@ GF_Err ISOR_ServiceCommand(GF_InputService *plug, GF_NetworkCommand *com)
 	return GF_NOT_SUPPORTED;
 }
 
+GF_Err ISOR_ServiceCommand(GF_InputService *plug, GF_NetworkCommand *com)
+{
+	GF_Err e;
+	ISOMReader *read;
+	if (!plug || !plug->priv || !com) return GF_SERVICE_ERROR;
+	read = (ISOMReader *) plug->priv;
+	isor_share_lock(read);
+	e = isor_service_command(plug, com);
+	isor_share_unlock(read);
+	return e;
+}
+
 static Bool ISOR_CanHandleURLInService(GF_InputService *plug, const char *url)
 {
 	char szURL[2048], *sep;
@@ -1278,6 +1335,7 @@ GF_InputService *isor_client_load()
 	}
 	reader->channels = gf_list_new();
 	reader->segment_mutex = gf_mx_new("ISO Segment");
+	isor_share_init();
 
 	plug->priv = reader;
 	
@@ -1302,6 +1360,7 @@ void isor_client_del(GF_BaseInterface *bi)
 	ISOMReader *read = (ISOMReader *)plug->priv;
 
 	if (read->segment_mutex) gf_mx_del(read->segment_mutex);
+	isor_share_uninit();
 	gf_list_del(read->channels);
 	gf_free(read);
 	gf_free(bi);
@@ -487,7 +487,7 @@ static void init_reader(ISOMChannel *ch)
 	ch->owner->no_order_check = ch->speed < 0 ? GF_TRUE : GF_FALSE;
 }
 
-void isor_reader_get_sample_from_item(ISOMChannel *ch)
+static void isor_reader_fetch_sample_from_item(ISOMChannel *ch)
 {
 	if (ch->current_slh.AU_sequenceNumber) {
 		ch->last_state = GF_EOS;
@@ -506,7 +506,14 @@ void isor_reader_get_sample_from_item(ISOMChannel *ch)
 	ch->current_slh.accessUnitLength = ch->sample->dataLength;
 }
 
-void isor_reader_get_sample(ISOMChannel *ch)
+void isor_reader_get_sample_from_item(ISOMChannel *ch)
+{
+	isor_share_lock(ch->owner);
+	isor_reader_fetch_sample_from_item(ch);
+	isor_share_unlock(ch->owner);
+}
+
+static void isor_reader_fetch_sample(ISOMChannel *ch)
 {
 	GF_Err e;
 	u32 sample_desc_index;
@@ -845,6 +852,25 @@ void isor_reader_get_sample(ISOMChannel *ch)
 	}
 }
 
+void isor_reader_get_sample(ISOMChannel *ch)
+{
+	if (ch->sample) return;
+	if (ch->owner->shared) {
+		/*extraction settings and sample table positions are stored per track in the movie, restore ours*/
+		u32 track = ch->next_track ? ch->next_track : ch->track;
+		if (!ch->cursor) ch->cursor = gf_isom_track_cursor_new();
+		isor_share_lock(ch->owner);
+		gf_isom_set_nalu_extract_mode(ch->owner->mov, track, ch->nalu_extract_mode);
+		gf_isom_set_sample_padding(ch->owner->mov, track, ch->padding_bytes);
+		if (ch->cursor) gf_isom_track_cursor_load(ch->owner->mov, track, ch->cursor);
+		isor_reader_fetch_sample(ch);
+		if (ch->cursor) gf_isom_track_cursor_save(ch->owner->mov, ch->track, ch->cursor);
+		isor_share_unlock(ch->owner);
+		return;
+	}
+	isor_reader_fetch_sample(ch);
+}
+
 void isor_reader_release_sample(ISOMChannel *ch)
 {
 	if (ch->current_slh.sai) {
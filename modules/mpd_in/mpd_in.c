@@ -97,6 +97,12 @@ typedef struct
 	u32 nb_comp;
 	char *mime;
 	u64 last_dts;
+
+	/*low latency chunk mode: top-level boxes of the segment being downloaded, to detect complete moof/mdat chunks*/
+	u64 box_bytes_left;
+	u32 box_type, box_hdr_size, box_hdr_needed;
+	u8 box_hdr[16];
+	Bool box_parse_failed;
 } GF_MPDGroup;
 
 const char * MPD_MPD_DESC = "MPEG-DASH Streaming";
@@ -641,6 +647,60 @@ GF_Err MPD_DisconnectChannel(GF_InputService *plug, LPNETCHANNEL channel)
 }
 
 
+static void mpdin_reset_chunk_parser(GF_MPDGroup *group)
+{
+	group->box_bytes_left = 0;
+	group->box_hdr_size = 0;
+	group->box_hdr_needed = 8;
+	group->box_parse_failed = GF_FALSE;
+}
+
+/*parses top-level box headers of the received data, returns GF_TRUE if at least one mdat box has been completed*/
+static Bool mpdin_chunk_completed(GF_MPDGroup *group, const u8 *data, u32 size)
+{
+	Bool mdat_done = GF_FALSE;
+	while (size && !group->box_parse_failed) {
+		u32 i;
+		u64 box_size;
+		if (group->box_bytes_left) {
+			u32 nb_bytes = (u32) MIN(group->box_bytes_left, size);
+			group->box_bytes_left -= nb_bytes;
+			data += nb_bytes;
+			size -= nb_bytes;
+			if (!group->box_bytes_left && (group->box_type==GF_4CC('m','d','a','t'))) mdat_done = GF_TRUE;
+			continue;
+		}
+		while (size && (group->box_hdr_size < group->box_hdr_needed)) {
+			group->box_hdr[group->box_hdr_size++] = *data++;
+			size--;
+			/*64-bit size*/
+			if ((group->box_hdr_size==8) && !group->box_hdr[0] && !group->box_hdr[1] && !group->box_hdr[2] && (group->box_hdr[3]==1))
+				group->box_hdr_needed = 16;
+		}
+		if (group->box_hdr_size < group->box_hdr_needed) break;
+
+		box_size = GF_4CC(group->box_hdr[0], group->box_hdr[1], group->box_hdr[2], group->box_hdr[3]);
+		if (group->box_hdr_needed==16) {
+			box_size = GF_4CC(group->box_hdr[8], group->box_hdr[9], group->box_hdr[10], group->box_hdr[11]);
+			box_size <<= 32;
+			box_size |= GF_4CC(group->box_hdr[12], group->box_hdr[13], group->box_hdr[14], group->box_hdr[15]);
+		}
+		/*not an ISOBMFF segment (or box extending to the end of the file), use HTTP chunk boundaries*/
+		for (i=4; i<8; i++) {
+			if (!isalnum(group->box_hdr[i]) && (group->box_hdr[i] != ' ')) group->box_parse_failed = GF_TRUE;
+		}
+		if (box_size < group->box_hdr_needed) group->box_parse_failed = GF_TRUE;
+		if (group->box_parse_failed) break;
+
+		group->box_type = GF_4CC(group->box_hdr[4], group->box_hdr[5], group->box_hdr[6], group->box_hdr[7]);
+		group->box_bytes_left = box_size - group->box_hdr_needed;
+		group->box_hdr_size = 0;
+		group->box_hdr_needed = 8;
+		if (!group->box_bytes_left && (group->box_type==GF_4CC('m','d','a','t'))) mdat_done = GF_TRUE;
+	}
+	return mdat_done;
+}
+
 static void mpdin_dash_segment_netio(void *cbk, GF_NETIO_Parameter *param)
 {
 	GF_MPDGroup *group = (GF_MPDGroup *)cbk;
@@ -652,6 +712,11 @@ static void mpdin_dash_segment_netio(void *cbk, GF_NETIO_Parameter *param)
 		}
 	}
 
+	/*new response, the segment starts with a box header*/
+	if (param->msg_type == GF_NETIO_PARSE_REPLY) {
+		mpdin_reset_chunk_parser(group);
+	}
+
 	if (param->msg_type == GF_NETIO_DATA_EXCHANGE) {
 		group->has_new_data = 1;
 
@@ -661,11 +726,21 @@ static void mpdin_dash_segment_netio(void *cbk, GF_NETIO_Parameter *param)
 			gf_dm_sess_get_stats(group->sess, NULL, &url, NULL, NULL, &bytes_per_sec, NULL);
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[MPD_IN] End of chunk received for %s at UTC "LLU" ms - estimated bandwidth %d kbps - chunk start at UTC "LLU"\n", url, gf_net_get_utc(), 8*bytes_per_sec/1000, gf_dm_sess_get_utc_start(group->sess)));
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("DEBUG. 2. redowload at max  %d \n", 8*bytes_per_sec/1000));
+		}
 
-			if (group->mpdin->low_latency_mode)
-				MPD_NotifyData(group, 1);
-		} else if (group->mpdin->low_latency_mode==MPDIN_LOW_LATENCY_ALWAYS) {
+		if (group->mpdin->low_latency_mode==MPDIN_LOW_LATENCY_ALWAYS) {
 			MPD_NotifyData(group, 1);
+		} else if (group->mpdin->low_latency_mode) {
+			/*CMAF chunks are handed to the demuxer once their moof and mdat are complete, whatever the HTTP chunking.
+			Other formats are parsed at each HTTP chunk end*/
+			if (!group->box_parse_failed && param->data && param->size) {
+				if (mpdin_chunk_completed(group, (const u8 *) param->data, param->size)) {
+					GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[MPD_IN] CMAF chunk received at UTC "LLU" ms\n", gf_net_get_utc()));
+					MPD_NotifyData(group, 1);
+				}
+			} else if (param->reply) {
+				MPD_NotifyData(group, 1);
+			}
 		}
 
 		if (group->mpdin->allow_http_abort)
@@ -1155,7 +1230,7 @@ GF_Err MPD_ConnectService(GF_InputService *plug, GF_ClientService *serv, const c
 	if (!opt) gf_modules_set_option((GF_BaseInterface *)plug, "DASH", "LowLatency", "no");
 
 	if (opt && !strcmp(opt, "chunk")) mpdin->low_latency_mode = MPDIN_LOW_LATENCY_CHUNK;
-	else if (opt && !strcmp(opt, "always")) mpdin->low_latency_mode = MPDIN_LOW_LATENCY_CHUNK;
+	else if (opt && !strcmp(opt, "always")) mpdin->low_latency_mode = MPDIN_LOW_LATENCY_ALWAYS;
 	else mpdin->low_latency_mode = MPDIN_LOW_LATENCY_NONE;
 
 	
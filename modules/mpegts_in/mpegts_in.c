@@ -705,6 +705,8 @@ static void M2TS_OnEvent(GF_M2TS_Demuxer *ts, u32 evt_type, void *param)
 				com.command_type = GF_NET_CHAN_SET_MEDIA_TIME;
 				com.map_time.media_time = m2ts->media_start_range;
 				com.map_time.timestamp = slh.objectClockReference / 300;
+				/*seeking is done on a random access point before the requested time, get the exact time of the PCR*/
+				if (ts->seek_index) com.map_time.media_time = gf_m2ts_seek_index_get_time(ts->seek_index, com.map_time.timestamp);
 				com.base.on_channel = ((GF_M2TS_PES_PCK *) param)->stream->user;
 				gf_service_command(m2ts->service, &com, GF_OK);
 				m2ts->map_media_time_on_prog_id = 0;
@@ -1116,6 +1118,47 @@ void m2ts_flush_data(M2TSIn *m2ts, u32 flush_type)
 	gf_mx_v(m2ts->mx);
 }
 
+/*RAPs of a PID closer than this to the previous one are not indexed*/
+#define M2TS_SEEK_INDEX_INTERVAL	500
+
+static void M2TS_SetupSeekIndex(M2TSIn *m2ts, const char *url)
+{
+	GF_Err e;
+	char szURL[GF_MAX_PATH], szIndex[GF_MAX_PATH+10];
+	char *frag;
+	const char *opt = gf_modules_get_option((GF_BaseInterface *)m2ts->owner, "M2TS", "SeekIndex");
+
+	if (opt && !strcmp(opt, "no")) return;
+	if (!strnicmp(url, "gmem://", 7) || !strnicmp(url, "udp://", 6) || !strnicmp(url, "mpegts-", 7) || !strnicmp(url, "dvb://", 6)) return;
+	if (!strnicmp(url, "file://", 7)) url += 7;
+	if (strlen(url) >= GF_MAX_PATH) return;
+
+	strcpy(szURL, url);
+	frag = strrchr(szURL, '#');
+	if (frag) frag[0] = 0;
+	sprintf(szIndex, "%s.tsidx", szURL);
+
+	e = gf_m2ts_seek_index_load(szIndex, szURL, &m2ts->ts->seek_index);
+	if (!e) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_CONTAINER, ("[M2TSIn] Using seek index %s\n", szIndex));
+		return;
+	}
+	/*by default only use existing indexes*/
+	if (!opt || strcmp(opt, "create")) return;
+
+	e = gf_m2ts_seek_index_build(szURL, M2TS_SEEK_INDEX_INTERVAL, &m2ts->ts->seek_index);
+	if (e) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[M2TSIn] Failed to index %s: %s\n", szURL, gf_error_to_string(e)));
+		return;
+	}
+	e = gf_m2ts_seek_index_save(m2ts->ts->seek_index, szIndex);
+	if (e) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[M2TSIn] Failed to write seek index %s: %s\n", szIndex, gf_error_to_string(e)));
+	} else {
+		GF_LOG(GF_LOG_INFO, GF_LOG_CONTAINER, ("[M2TSIn] Seek index %s created\n", szIndex));
+	}
+}
+
 static GF_Err M2TS_ConnectService(GF_InputService *plug, GF_ClientService *serv, const char *url)
 {
 	GF_Err e;
@@ -1172,6 +1215,7 @@ static GF_Err M2TS_ConnectService(GF_InputService *plug, GF_ClientService *serv,
 			}
 			m2ts->ts->run_state = 1;
 		} else {
+			if (url) M2TS_SetupSeekIndex(m2ts, url);
 			e = gf_m2ts_demuxer_setup(m2ts->ts,url,0);
 		}
 	}
@@ -1195,6 +1239,9 @@ static GF_Err M2TS_CloseService(GF_InputService *plug)
 	if (ts->dnload) gf_service_download_del(ts->dnload);
 	ts->dnload = NULL;
 
+	if (ts->seek_index) gf_m2ts_seek_index_del(ts->seek_index);
+	ts->seek_index = NULL;
+
 	gf_service_disconnect_ack(m2ts->service, NULL, GF_OK);
 	return GF_OK;
 }
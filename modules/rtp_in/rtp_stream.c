@@ -70,11 +70,16 @@ GF_Err RP_InitStream(RTPStream *ch, Bool ResetOnly)
 	if (!ResetOnly) {
 		const char *ip_ifce = NULL;
 		u32 reorder_size = 0;
+		u32 batch_size = 0;
 		if (!ch->owner->transport_mode) {
 			const char *sOpt = gf_modules_get_option((GF_BaseInterface *) gf_service_get_interface(ch->owner->service), "Streaming", "ReorderSize");
 			if (sOpt) reorder_size = atoi(sOpt);
 			else reorder_size = 10;
 
+			sOpt = gf_modules_get_option((GF_BaseInterface *) gf_service_get_interface(ch->owner->service), "Streaming", "RTPBatchSize");
+			if (sOpt) batch_size = atoi(sOpt);
+			gf_rtp_set_receive_batch(ch->rtp_ch, batch_size, 0);
+
 			ip_ifce = gf_modules_get_option((GF_BaseInterface *) gf_service_get_interface(ch->owner->service), "Network", "DefaultMCastInterface");
 			if (!ip_ifce) {
 				const char *mob_on = gf_modules_get_option((GF_BaseInterface *) gf_service_get_interface(ch->owner->service), "Network", "MobileIPEnabled");
@@ -94,6 +99,13 @@ GF_Err RP_InitStream(RTPStream *ch, Bool ResetOnly)
 
 void RP_DeleteStream(RTPStream *ch)
 {
+#ifndef GPAC_DISABLE_LOG
+	if (ch->rtp_ch && gf_log_tool_level_on(GF_LOG_RTP, GF_LOG_DEBUG)) {
+		u32 nb_batches, nb_batch_pck, nb_reordered, nb_dropped;
+		gf_rtp_get_receive_stats(ch->rtp_ch, &nb_batches, &nb_batch_pck, &nb_reordered, &nb_dropped);
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("[RTP] Stream %s: %d batched receptions (%d packets) - %d packets reordered - %d packets dropped\n", ch->control ? ch->control : "", nb_batches, nb_batch_pck, nb_reordered, nb_dropped));
+	}
+#endif
 	if (ch->rtsp) {
 		if (ch->status == RTP_Running) {
 			RP_Teardown(ch->rtsp, ch);
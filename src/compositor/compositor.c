@@ -497,8 +497,8 @@ static GF_Err gf_sc_create(GF_Compositor *compositor)
 	compositor->frame_rate = 30.0;
 	compositor->frame_duration = 33;
 	compositor->time_nodes = gf_list_new();
-	compositor->event_queue = gf_list_new();
-	compositor->event_queue_back = gf_list_new();
+	compositor->event_queue = gf_fifo_new();
+	compositor->event_queue_back = gf_fifo_new();
 	compositor->evq_mx = gf_mx_new("EventQueue");
 
 #ifdef GF_SR_USE_VIDEO_CACHE
@@ -733,20 +733,18 @@ void gf_sc_del(GF_Compositor *compositor)
 		gf_list_del(compositor->proto_modules);
 	}
 	if (compositor->evq_mx) gf_mx_p(compositor->evq_mx);
-	while (gf_list_count(compositor->event_queue)) {
-		GF_QueuedEvent *qev = (GF_QueuedEvent *)gf_list_get(compositor->event_queue, 0);
-		gf_list_rem(compositor->event_queue, 0);
+	while (gf_fifo_count(compositor->event_queue)) {
+		GF_QueuedEvent *qev = (GF_QueuedEvent *)gf_fifo_pop(compositor->event_queue);
 		gf_free(qev);
 	}
-	while (gf_list_count(compositor->event_queue_back)) {
-		GF_QueuedEvent *qev = (GF_QueuedEvent *)gf_list_get(compositor->event_queue_back, 0);
-		gf_list_rem(compositor->event_queue, 0);
+	while (gf_fifo_count(compositor->event_queue_back)) {
+		GF_QueuedEvent *qev = (GF_QueuedEvent *)gf_fifo_pop(compositor->event_queue_back);
 		gf_free(qev);
 	}
 	if (compositor->evq_mx) gf_mx_v(compositor->evq_mx);
 	if (compositor->evq_mx) gf_mx_del(compositor->evq_mx);
-	gf_list_del(compositor->event_queue);
-	gf_list_del(compositor->event_queue_back);
+	gf_fifo_del(compositor->event_queue);
+	gf_fifo_del(compositor->event_queue_back);
 
 	if (compositor->font_manager) gf_font_manager_del(compositor->font_manager);
 
@@ -995,9 +993,8 @@ GF_Err gf_sc_set_scene(GF_Compositor *compositor, GF_SceneGraph *scene_graph)
 
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_COMPOSE, ("[Compositor] Reseting event queue\n"));
 	gf_mx_p(compositor->evq_mx);
-	while (gf_list_count(compositor->event_queue)) {
-		GF_QueuedEvent *qev = (GF_QueuedEvent*)gf_list_get(compositor->event_queue, 0);
-		gf_list_rem(compositor->event_queue, 0);
+	while (gf_fifo_count(compositor->event_queue)) {
+		GF_QueuedEvent *qev = (GF_QueuedEvent*)gf_fifo_pop(compositor->event_queue);
 		gf_free(qev);
 	}
 	gf_mx_v(compositor->evq_mx);
@@ -2330,6 +2327,7 @@ static void gf_sc_draw_scene(GF_Compositor *compositor)
 #endif
 
 	flags = compositor->traverse_state->immediate_draw;
+	GF_TRACE(GF_TRACE_BEGIN, GF_LOG_COMPOSE, "compose", 0);
 	if (compositor->video_setup_failed) {
 		compositor->skip_flush = 1;
 	}
@@ -2345,6 +2343,7 @@ static void gf_sc_draw_scene(GF_Compositor *compositor)
 		}
 #endif
 	}
+	GF_TRACE(GF_TRACE_END, GF_LOG_COMPOSE, "compose", 0);
 
 
 	compositor->traverse_state->immediate_draw = flags;
@@ -2400,7 +2399,7 @@ void gf_sc_render_frame(GF_Compositor *compositor)
 #ifndef GPAC_DISABLE_SCENEGRAPH
 	GF_SceneGraph *sg;
 #endif
-	GF_List *temp_queue;
+	GF_Fifo *temp_queue;
 	u32 in_time, end_time, i, count, frame_duration;
 	Bool frame_drawn, has_timed_nodes=GF_FALSE, all_tx_done=GF_TRUE;
 #ifndef GPAC_DISABLE_LOG
@@ -2460,9 +2459,8 @@ void gf_sc_render_frame(GF_Compositor *compositor)
 	compositor->event_queue = compositor->event_queue_back;
 	compositor->event_queue_back = temp_queue;
 	gf_mx_v(compositor->evq_mx);
-	while (gf_list_count(compositor->event_queue_back)) {
-		GF_QueuedEvent *qev = (GF_QueuedEvent*)gf_list_get(compositor->event_queue_back, 0);
-		gf_list_rem(compositor->event_queue_back, 0);
+	while (gf_fifo_count(compositor->event_queue_back)) {
+		GF_QueuedEvent *qev = (GF_QueuedEvent*)gf_fifo_pop(compositor->event_queue_back);
 
 		if (qev->target) {
 #ifndef GPAC_DISABLE_SVG
@@ -3600,9 +3598,9 @@ void gf_sc_queue_event(GF_Compositor *compositor, GF_Event *evt)
 	GF_QueuedEvent *qev;
 	gf_mx_p(compositor->evq_mx);
 
-	count = gf_list_count(compositor->event_queue);
+	count = gf_fifo_count(compositor->event_queue);
 	for (i=0; i<count; i++) {
-		qev = gf_list_get(compositor->event_queue, i);
+		qev = gf_fifo_get(compositor->event_queue, i);
 		if (!qev->node && (qev->evt.type==evt->type)) {
 			qev->evt = *evt;
 			gf_mx_v(compositor->evq_mx);
@@ -3614,7 +3612,7 @@ void gf_sc_queue_event(GF_Compositor *compositor, GF_Event *evt)
 		GF_LOG(GF_LOG_ERROR, GF_LOG_COMPOSE, ("[Compositor] Failed to allocate event for queuing\n"));
 	} else {
 		qev->evt = *evt;
-		gf_list_add(compositor->event_queue, qev);
+		gf_fifo_add(compositor->event_queue, qev);
 	}
 	gf_mx_v(compositor->evq_mx);
 }
@@ -3625,9 +3623,9 @@ void gf_sc_queue_dom_event(GF_Compositor *compositor, GF_Node *node, GF_DOM_Even
 	GF_QueuedEvent *qev;
 	gf_mx_p(compositor->evq_mx);
 
-	count = gf_list_count(compositor->event_queue);
+	count = gf_fifo_count(compositor->event_queue);
 	for (i=0; i<count; i++) {
-		qev = gf_list_get(compositor->event_queue, i);
+		qev = gf_fifo_get(compositor->event_queue, i);
 		if ((qev->node==node) && (qev->dom_evt.type==evt->type)) {
 			qev->dom_evt = *evt;
 			gf_mx_v(compositor->evq_mx);
@@ -3640,7 +3638,7 @@ void gf_sc_queue_dom_event(GF_Compositor *compositor, GF_Node *node, GF_DOM_Even
 	} else {
 		qev->node = node;
 		qev->dom_evt = *evt;
-		gf_list_add(compositor->event_queue, qev);
+		gf_fifo_add(compositor->event_queue, qev);
 	}
 	gf_mx_v(compositor->evq_mx);
 }
@@ -3651,9 +3649,9 @@ void gf_sc_queue_dom_event_on_target(GF_Compositor *compositor, GF_DOM_Event *ev
 	GF_QueuedEvent *qev;
 	gf_mx_p(compositor->evq_mx);
 
-	count = gf_list_count(compositor->event_queue);
+	count = gf_fifo_count(compositor->event_queue);
 	for (i=0; i<count; i++) {
-		qev = gf_list_get(compositor->event_queue, i);
+		qev = gf_fifo_get(compositor->event_queue, i);
 		if ((qev->target==target) && (qev->dom_evt.type==evt->type) && (qev->sg==sg) ) {
 			qev->dom_evt = *evt;
 			gf_mx_v(compositor->evq_mx);
@@ -3668,17 +3666,17 @@ void gf_sc_queue_dom_event_on_target(GF_Compositor *compositor, GF_DOM_Event *ev
 		qev->sg = sg;
 		qev->target = target;
 		qev->dom_evt = *evt;
-		gf_list_add(compositor->event_queue, qev);
+		gf_fifo_add(compositor->event_queue, qev);
 	}
 	gf_mx_v(compositor->evq_mx);
 }
 
-static void sc_cleanup_event_queue(GF_List *evq, GF_Node *node, GF_SceneGraph *sg)
+static void sc_cleanup_event_queue(GF_Fifo *evq, GF_Node *node, GF_SceneGraph *sg)
 {
-	u32 i, count = gf_list_count(evq);
+	u32 i, count = gf_fifo_count(evq);
 	for (i=0; i<count; i++) {
 		Bool del = 0;
-		GF_QueuedEvent *qev = gf_list_get(evq, i);
+		GF_QueuedEvent *qev = gf_fifo_get(evq, i);
 		if (qev->node) {
 			if (node == qev->node)
 				del = 1;
@@ -3695,7 +3693,7 @@ static void sc_cleanup_event_queue(GF_List *evq, GF_Node *node, GF_SceneGraph *s
 		}
 
 		if (del) {
-			gf_list_rem(evq, i);
+			gf_fifo_rem(evq, i);
 			i--;
 			count--;
 			gf_free(qev);
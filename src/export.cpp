@@ -74,6 +74,11 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_log_va_list) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_log_lt) )
 #endif
+#pragma comment (linker, EXPORT_SYMBOL(gf_trace_start) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_trace_stop) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_trace_dump) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_trace_on) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_trace_event) )
 
 #pragma comment (linker, EXPORT_SYMBOL(gf_set_progress) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_set_progress_callback) )
@@ -101,12 +106,21 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_file_handles_count) )
 
 /* Memory */
+#pragma comment (linker, EXPORT_SYMBOL(gf_memory_tag_stats) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_memory_tag_name) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_memory_print_tags) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_memory_set_tags_dump_period) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mem_enable_accounting) )
 #ifdef GPAC_MEMORY_TRACKING
 #pragma comment (linker, EXPORT_SYMBOL(gf_mem_malloc) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mem_calloc) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mem_realloc) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mem_free) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mem_strdup) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mem_malloc_tag) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mem_calloc_tag) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mem_realloc_tag) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mem_strdup_tag) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_memory_print) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_memory_size) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mem_enable_tracker) )
@@ -116,6 +130,10 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_realloc) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_free) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_strdup) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_malloc_tag) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_calloc_tag) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_realloc_tag) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_strdup_tag) )
 #endif /*GPAC_MEMORY_TRACKING*/
 
 /* Print */
@@ -168,11 +186,22 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_list_rev_enum) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_list_pop_front) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_list_pop_back) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_fifo_new) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_fifo_del) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_fifo_reset) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_fifo_count) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_fifo_add) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_fifo_pop) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_fifo_head) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_fifo_get) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_fifo_rem) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_fifo_enum) )
 
 
 /* Map */
 #ifndef GPAC_DISABLE_PLAYER
 #pragma comment (linker, EXPORT_SYMBOL(gf_map_new) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_map_new_ex) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_map_del) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_map_reset) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_map_find) )
@@ -180,6 +209,10 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_map_rem) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_map_count) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_map_has_key) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_map_insert_int) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_map_rem_int) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_map_find_int) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_map_has_key_int) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_map_iter_set) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_map_iter_has_next) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_map_iter_reset) )
@@ -258,6 +291,14 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_sema_notify) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sema_wait) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sema_wait_for) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_th_pool_new) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_th_pool_del) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_th_pool_get_thread_count) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_th_pool_post) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_th_pool_submit) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_th_pool_task_done) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_th_pool_wait) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_th_pool_parallel_for) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_global_resource_lock) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_global_resource_unlock) )
 
@@ -280,11 +321,19 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_get_local_info) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_get_remote_address) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_send_to) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_send_batch) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_setup_multicast) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_is_multicast_address) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_send_wait) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_receive_wait) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_receive_no_select) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_receive_batch) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_group_new) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_group_del) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_group_register) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_group_unregister) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_group_select) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_group_sock_is_set) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_url_is_local) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_url_get_absolute_path) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_url_concatenate) )
@@ -774,7 +823,13 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_check_data_reference) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_data_reference) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample_count) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_load_sample_tables) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample_table_memory) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_set_sample_padding) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_track_cursor_new) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_track_cursor_del) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_track_cursor_load) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_track_cursor_save) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample_info) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample_flags) )
@@ -1166,6 +1221,8 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_disable_auto_rtcp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_send_rtcp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_get_payload_type) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_set_send_batch) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_flush) )
 
 
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_streamer_new) )
@@ -1174,6 +1231,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_streamer_get_sdp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_streamer_send_next_packet) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_streamer_reset) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_streamer_set_send_batch) )
 #endif
 
 #pragma comment (linker, EXPORT_SYMBOL(gf_media_map_esd) )
@@ -1347,6 +1405,11 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_get_loss) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_get_tcp_bytes_sent) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_get_ports) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_set_receive_batch) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_get_receive_stats) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_set_send_batch) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_flush_packets) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_get_send_stats) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sdp_info_new) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sdp_info_del) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sdp_info_reset) )
@@ -1375,6 +1438,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_reorderer_reset) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_reorderer_add) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_reorderer_get) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_reorderer_get_into) )
 
 #endif /*GPAC_DISABLE_STREAMING*/
 
@@ -1481,6 +1545,15 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_sha1_csum) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sha1_csum_hexa) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sha1_file) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sha1_starts) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sha1_update) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sha1_finish) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sha1_set_implementation) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sha1_get_implementation) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sha1_multi_starts) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sha1_multi_update) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sha1_multi_finish) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sha1_csum_multi) )
 
 #ifndef GPAC_DISABLE_AV_PARSERS
 #pragma comment (linker, EXPORT_SYMBOL(gf_m4v_parser_new) )
@@ -2065,6 +2138,13 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_crc32_check) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_restamp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_demux_file) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_seek_index_build) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_seek_index_save) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_seek_index_load) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_seek_index_del) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_seek_index_get_duration) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_seek_index_get_time) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_seek_index_find) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_pes_get_framing_mode) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_get_sdt_info) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_abort_parsing) )
@@ -2122,6 +2202,10 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_get_segment_start_time_with_timescale) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_seek_in_period) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_seek_to_time) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mpd_segment_timeline_reset_index) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mpd_segment_timeline_get_count) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mpd_segment_timeline_get_segment) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mpd_segment_timeline_find_time) )
 
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_demuxer_setup))
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_demuxer_play) )
@@ -2200,6 +2284,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_dasher_set_split_on_closest) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dasher_set_cues) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dasher_set_isobmff_options) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_dasher_set_hls_output) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dasher_set_test_mode) )
 
 
@@ -2216,6 +2301,13 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_dvb_get_freq_from_url) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_print_mpe_info) )
 #endif
+#ifdef GPAC_ENABLE_MPE
+#pragma comment (linker, EXPORT_SYMBOL(gf_rs_new) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rs_del) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rs_get_parity_size) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rs_encode) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rs_decode) )
+#endif
 
 #ifndef GPAC_DISABLE_DASH_CLIENT
 #pragma comment (linker, EXPORT_SYMBOL(gf_dash_new) )
@@ -2248,6 +2340,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_dash_group_get_num_segments_ready) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dash_group_discard_segment) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dash_group_get_next_segment_location) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_dash_group_get_next_segment_info) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dash_group_probe_current_download_segment_location) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dash_group_get_max_segments_in_cache) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dash_set_group_done) )
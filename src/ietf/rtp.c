@@ -46,6 +46,7 @@ GF_EXPORT
 void gf_rtp_del(GF_RTPChannel *ch)
 {
 	if (!ch) return;
+	if (ch->rtp && ch->snd_batch_nb) gf_rtp_flush_packets(ch, GF_TRUE);
 	if (ch->rtp) gf_sk_del(ch->rtp);
 	if (ch->rtcp) gf_sk_del(ch->rtcp);
 	if (ch->net_info.source) gf_free(ch->net_info.source);
@@ -53,6 +54,12 @@ void gf_rtp_del(GF_RTPChannel *ch)
 	if (ch->net_info.Profile) gf_free(ch->net_info.Profile);
 	if (ch->po) gf_rtp_reorderer_del(ch->po);
 	if (ch->send_buffer) gf_free(ch->send_buffer);
+	if (ch->rcv_batch) gf_free(ch->rcv_batch);
+	if (ch->rcv_batch_pcks) gf_free(ch->rcv_batch_pcks);
+	if (ch->rcv_batch_sizes) gf_free(ch->rcv_batch_sizes);
+	if (ch->snd_batch) gf_free(ch->snd_batch);
+	if (ch->snd_batch_pcks) gf_free(ch->snd_batch_pcks);
+	if (ch->snd_batch_sizes) gf_free(ch->snd_batch_sizes);
 
 	if (ch->CName) gf_free(ch->CName);
 	if (ch->s_name) gf_free(ch->s_name);
@@ -114,6 +121,7 @@ void gf_rtp_reset_buffers(GF_RTPChannel *ch)
 	if (ch->rtp) gf_sk_reset(ch->rtp);
 	if (ch->rtcp) gf_sk_reset(ch->rtcp);
 	if (ch->po) gf_rtp_reorderer_reset(ch->po);
+	ch->rcv_batch_nb = ch->rcv_batch_pos = 0;
 	/*also reset ssrc*/
 	//ch->SenderSSRC = 0;
 	ch->first_SR = 1;
@@ -131,6 +139,39 @@ void gf_rtp_enable_nat_keepalive(GF_RTPChannel *ch, u32 nat_timeout)
 
 
 
+GF_EXPORT
+GF_Err gf_rtp_set_receive_batch(GF_RTPChannel *ch, u32 nb_packets, u32 max_packet_size)
+{
+	u32 i;
+	if (!ch) return GF_BAD_PARAM;
+
+	if (ch->rcv_batch) gf_free(ch->rcv_batch);
+	if (ch->rcv_batch_pcks) gf_free(ch->rcv_batch_pcks);
+	if (ch->rcv_batch_sizes) gf_free(ch->rcv_batch_sizes);
+	ch->rcv_batch = NULL;
+	ch->rcv_batch_pcks = NULL;
+	ch->rcv_batch_sizes = NULL;
+	ch->rcv_batch_count = ch->rcv_batch_nb = ch->rcv_batch_pos = 0;
+
+	//a batch of 1 is regular reception
+	if (nb_packets <= 1) return GF_OK;
+	if (!max_packet_size) max_packet_size = GF_RTP_REORDER_SLOT_SIZE;
+
+	ch->rcv_batch = (char *) gf_malloc(sizeof(char) * nb_packets * max_packet_size);
+	ch->rcv_batch_pcks = (char **) gf_malloc(sizeof(char *) * nb_packets);
+	ch->rcv_batch_sizes = (u32 *) gf_malloc(sizeof(u32) * nb_packets);
+	if (!ch->rcv_batch || !ch->rcv_batch_pcks || !ch->rcv_batch_sizes) {
+		gf_rtp_set_receive_batch(ch, 0, 0);
+		return GF_OUT_OF_MEM;
+	}
+	for (i=0; i<nb_packets; i++) {
+		ch->rcv_batch_pcks[i] = ch->rcv_batch + i*max_packet_size;
+	}
+	ch->rcv_batch_count = nb_packets;
+	ch->rcv_batch_slot_size = max_packet_size;
+	return GF_OK;
+}
+
 GF_EXPORT
 GF_Err gf_rtp_set_info_rtp(GF_RTPChannel *ch, u32 seq_num, u32 rtp_time, u32 ssrc)
 {
@@ -151,6 +192,7 @@ GF_EXPORT
 GF_Err gf_rtp_stop(GF_RTPChannel *ch)
 {
 	if (!ch) return GF_BAD_PARAM;
+	if (ch->rtp && ch->snd_batch_nb) gf_rtp_flush_packets(ch, GF_TRUE);
 	if (ch->rtp) gf_sk_del(ch->rtp);
 	ch->rtp = NULL;
 	if (ch->rtcp) gf_sk_del(ch->rtcp);
@@ -340,8 +382,28 @@ u32 gf_rtp_read_rtp(GF_RTPChannel *ch, char *buffer, u32 buffer_size)
 	//only if the socket exist (otherwise RTSP interleaved channel)
 	if (!ch || !ch->rtp) return 0;
 
-	e = gf_sk_receive(ch->rtp, buffer, buffer_size, 0, &res);
-	if (!res || e || (res < 12)) res = 0;
+	res = 0;
+	pck = buffer;
+	if (ch->rcv_batch_count) {
+		//all packets from previous batch consumed, fetch a new batch
+		if (ch->rcv_batch_pos == ch->rcv_batch_nb) {
+			ch->rcv_batch_pos = ch->rcv_batch_nb = 0;
+			e = gf_sk_receive_batch(ch->rtp, ch->rcv_batch_pcks, ch->rcv_batch_sizes, ch->rcv_batch_slot_size, ch->rcv_batch_count, &ch->rcv_batch_nb);
+			if (!e && ch->rcv_batch_nb) {
+				ch->nb_rcv_batches++;
+				ch->nb_rcv_batch_pck += ch->rcv_batch_nb;
+			}
+		}
+		if (ch->rcv_batch_pos < ch->rcv_batch_nb) {
+			pck = ch->rcv_batch_pcks[ch->rcv_batch_pos];
+			res = ch->rcv_batch_sizes[ch->rcv_batch_pos];
+			ch->rcv_batch_pos++;
+		}
+	} else {
+		e = gf_sk_receive(ch->rtp, buffer, buffer_size, 0, &res);
+		if (e) res = 0;
+	}
+	if (res < 12) res = 0;
 	if (res) {
 		ch->total_bytes+=res;
 		ch->total_pck++;
@@ -349,15 +411,18 @@ u32 gf_rtp_read_rtp(GF_RTPChannel *ch, char *buffer, u32 buffer_size)
 	//add the packet to our Queue if any
 	if (ch->po) {
 		if (res) {
-			seq_num = ((buffer[2] << 8) & 0xFF00) | (buffer[3] & 0xFF);
-			gf_rtp_reorderer_add(ch->po, (void *) buffer, res, seq_num);
+			seq_num = ((pck[2] << 8) & 0xFF00) | (pck[3] & 0xFF);
+			gf_rtp_reorderer_add(ch->po, (void *) pck, res, seq_num);
 		}
 
 		//pck queue may need to be flushed
-		pck = (char *) gf_rtp_reorderer_get(ch->po, &res);
-		if (pck) {
+		res = gf_rtp_reorderer_get_into(ch->po, buffer, buffer_size);
+	} else if (res && (pck != buffer)) {
+		if (res > buffer_size) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_RTP, ("[RTP] Buffer too small (%d vs %d bytes), dropping packet\n", buffer_size, res));
+			res = 0;
+		} else {
 			memcpy(buffer, pck, res);
-			gf_free(pck);
 		}
 	}
 	/*monitor keep-alive period*/
@@ -566,12 +631,121 @@ Double gf_rtp_get_current_time(GF_RTPChannel *ch)
 
 
 
+static void gf_rtp_refill_tokens(GF_RTPChannel *ch)
+{
+	u64 now, tokens;
+	now = gf_sys_clock_high_res();
+	if (!ch->snd_last_refill) {
+		ch->snd_last_refill = now;
+		ch->snd_tokens = ch->snd_burst;
+		return;
+	}
+	tokens = (now - ch->snd_last_refill) * ch->snd_rate / 1000000;
+	if (!tokens) return;
+	ch->snd_last_refill = now;
+	tokens += ch->snd_tokens;
+	ch->snd_tokens = (tokens > ch->snd_burst) ? ch->snd_burst : (u32) tokens;
+}
+
+GF_EXPORT
+GF_Err gf_rtp_flush_packets(GF_RTPChannel *ch, Bool force)
+{
+	GF_Err e;
+	u32 nb_pck, nb_sent, size, i;
+
+	if (!ch) return GF_BAD_PARAM;
+
+	while (ch->snd_batch_nb) {
+		nb_pck = ch->snd_batch_nb;
+		/*only send what the bucket allows*/
+		if (ch->snd_rate) {
+			gf_rtp_refill_tokens(ch);
+			size = 0;
+			for (i=0; i<ch->snd_batch_nb; i++) {
+				if (size + ch->snd_batch_sizes[i] > ch->snd_tokens) break;
+				size += ch->snd_batch_sizes[i];
+			}
+			nb_pck = i;
+			if (!nb_pck) {
+				if (!force) return GF_OK;
+				/*sleep until enough tokens for the first packet*/
+				size = ch->snd_batch_sizes[0] - ch->snd_tokens;
+				gf_sleep(MAX(1, (u32) ((u64) size * 1000 / ch->snd_rate)));
+				continue;
+			}
+		}
+		e = gf_sk_send_batch(ch->rtp, (const char **) ch->snd_batch_pcks, ch->snd_batch_sizes, nb_pck, &nb_sent);
+		if (nb_sent) {
+			ch->nb_snd_batches++;
+			ch->nb_snd_batch_pck += nb_sent;
+			if (ch->snd_rate) {
+				for (i=0; i<nb_sent; i++) ch->snd_tokens -= ch->snd_batch_sizes[i];
+			}
+			/*shift remaining packets - slots are swapped so that buffers are reused*/
+			for (i=nb_sent; i<ch->snd_batch_nb; i++) {
+				char *pck = ch->snd_batch_pcks[i-nb_sent];
+				ch->snd_batch_pcks[i-nb_sent] = ch->snd_batch_pcks[i];
+				ch->snd_batch_sizes[i-nb_sent] = ch->snd_batch_sizes[i];
+				ch->snd_batch_pcks[i] = pck;
+			}
+			ch->snd_batch_nb -= nb_sent;
+		}
+		if (e == GF_IP_SOCK_WOULD_BLOCK) {
+			if (!force) return GF_OK;
+			gf_sleep(1);
+		} else if (e) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_RTP, ("[RTP] Error sending %d queued packets: %s - discarding them\n", ch->snd_batch_nb, gf_error_to_string(e) ));
+			ch->snd_batch_nb = 0;
+			return e;
+		}
+	}
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_rtp_set_send_batch(GF_RTPChannel *ch, u32 nb_packets, u32 rate, u32 burst_size)
+{
+	u32 i;
+	if (!ch || !ch->send_buffer_size) return GF_BAD_PARAM;
+
+	gf_rtp_flush_packets(ch, GF_TRUE);
+	if (ch->snd_batch) gf_free(ch->snd_batch);
+	if (ch->snd_batch_pcks) gf_free(ch->snd_batch_pcks);
+	if (ch->snd_batch_sizes) gf_free(ch->snd_batch_sizes);
+	ch->snd_batch = NULL;
+	ch->snd_batch_pcks = NULL;
+	ch->snd_batch_sizes = NULL;
+	ch->snd_batch_count = ch->snd_batch_nb = 0;
+
+	/*bucket must at least hold one packet*/
+	ch->snd_rate = rate;
+	ch->snd_burst = MAX(burst_size, ch->send_buffer_size);
+	ch->snd_tokens = 0;
+	ch->snd_last_refill = 0;
+
+	if (!nb_packets) return GF_OK;
+
+	ch->snd_batch = (char *) gf_malloc(sizeof(char) * nb_packets * ch->send_buffer_size);
+	ch->snd_batch_pcks = (char **) gf_malloc(sizeof(char *) * nb_packets);
+	ch->snd_batch_sizes = (u32 *) gf_malloc(sizeof(u32) * nb_packets);
+	if (!ch->snd_batch || !ch->snd_batch_pcks || !ch->snd_batch_sizes) {
+		gf_rtp_set_send_batch(ch, 0, 0, 0);
+		return GF_OUT_OF_MEM;
+	}
+	for (i=0; i<nb_packets; i++) {
+		ch->snd_batch_pcks[i] = ch->snd_batch + i*ch->send_buffer_size;
+	}
+	ch->snd_batch_count = nb_packets;
+	return GF_OK;
+}
+
 GF_EXPORT
 GF_Err gf_rtp_send_packet(GF_RTPChannel *ch, GF_RTPHeader *rtp_hdr, char *pck, u32 pck_size, Bool fast_send)
 {
 	GF_Err e;
 	u32 i, Start;
 	char *hdr = NULL;
+	char *dst;
 
 	GF_BitStream *bs;
 
@@ -584,11 +758,22 @@ GF_Err gf_rtp_send_packet(GF_RTPChannel *ch, GF_RTPHeader *rtp_hdr, char *pck, u
 
 	if (12 + pck_size + 4*rtp_hdr->CSRCCount > ch->send_buffer_size) return GF_IO_ERR;
 
+	/*queued packets are written in their own slot*/
+	dst = ch->send_buffer;
+	if (ch->snd_batch_count) {
+		if (ch->snd_batch_nb == ch->snd_batch_count) {
+			e = gf_rtp_flush_packets(ch, GF_TRUE);
+			if (e) return e;
+		}
+		dst = ch->snd_batch_pcks[ch->snd_batch_nb];
+		fast_send = GF_FALSE;
+	}
+
 	if (fast_send) {
 		hdr = pck - 12;
 		bs = gf_bs_new(hdr, 12, GF_BITSTREAM_WRITE);
 	} else {
-		bs = gf_bs_new(ch->send_buffer, ch->send_buffer_size, GF_BITSTREAM_WRITE);
+		bs = gf_bs_new(dst, ch->send_buffer_size, GF_BITSTREAM_WRITE);
 	}
 	//write header
 	gf_bs_write_int(bs, rtp_hdr->Version, 2);
@@ -611,6 +796,13 @@ GF_Err gf_rtp_send_packet(GF_RTPChannel *ch, GF_RTPHeader *rtp_hdr, char *pck, u
 	//copy payload
 	if (fast_send) {
 		e = gf_sk_send(ch->rtp, hdr, pck_size+12);
+	} else if (ch->snd_batch_count) {
+		memcpy(dst + Start, pck, pck_size);
+		ch->snd_batch_sizes[ch->snd_batch_nb] = Start + pck_size;
+		ch->snd_batch_nb++;
+		e = GF_OK;
+		/*send what the bucket allows*/
+		if (ch->snd_rate) e = gf_rtp_flush_packets(ch, GF_FALSE);
 	} else {
 		memcpy(ch->send_buffer + Start, pck, pck_size);
 		e = gf_sk_send(ch->rtp, ch->send_buffer, Start + pck_size);
@@ -760,6 +952,23 @@ Float gf_rtp_get_loss(GF_RTPChannel *ch)
 	return 100.0f - (100.0f * ch->tot_num_pck_rcv) / ch->tot_num_pck_expected;
 }
 
+GF_EXPORT
+void gf_rtp_get_receive_stats(GF_RTPChannel *ch, u32 *nb_batches, u32 *nb_batch_pck, u32 *nb_reordered, u32 *nb_dropped)
+{
+	if (nb_batches) *nb_batches = ch->nb_rcv_batches;
+	if (nb_batch_pck) *nb_batch_pck = ch->nb_rcv_batch_pck;
+	if (nb_reordered) *nb_reordered = ch->po ? ch->po->nb_reordered : 0;
+	if (nb_dropped) *nb_dropped = ch->po ? ch->po->nb_dropped : 0;
+}
+
+GF_EXPORT
+void gf_rtp_get_send_stats(GF_RTPChannel *ch, u32 *nb_batches, u32 *nb_batch_pck, u32 *nb_queued)
+{
+	if (nb_batches) *nb_batches = ch->nb_snd_batches;
+	if (nb_batch_pck) *nb_batch_pck = ch->nb_snd_batch_pck;
+	if (nb_queued) *nb_queued = ch->snd_batch_nb;
+}
+
 GF_EXPORT
 u32 gf_rtp_get_tcp_bytes_sent(GF_RTPChannel *ch)
 {
@@ -784,10 +993,13 @@ void gf_rtp_get_ports(GF_RTPChannel *ch, u16 *rtp_port, u16 *rtcp_port)
 */
 
 #define SN_CHECK_OFFSET		0x0A
+/*max number of preallocated packet slots*/
+#define SLAB_MAX_ITEMS		1024
 
 GF_EXPORT
 GF_RTPReorder *gf_rtp_reorderer_new(u32 MaxCount, u32 MaxDelay)
 {
+	u32 i, nb_items;
 	GF_RTPReorder *tmp;
 
 	if (MaxCount <= 1 || !MaxDelay) return NULL;
@@ -796,23 +1008,74 @@ GF_RTPReorder *gf_rtp_reorderer_new(u32 MaxCount, u32 MaxDelay)
 	if (!tmp) return NULL;
 	tmp->MaxCount = MaxCount;
 	tmp->MaxDelay = MaxDelay;
+
+	/*one packet is always added before the queue is flushed, hence the extra slot*/
+	nb_items = MIN(MaxCount+1, SLAB_MAX_ITEMS);
+	tmp->slab = (GF_POItem *) gf_malloc(sizeof(GF_POItem) * nb_items);
+	tmp->slab_data = (char *) gf_malloc(sizeof(char) * GF_RTP_REORDER_SLOT_SIZE * nb_items);
+	if (!tmp->slab || !tmp->slab_data) {
+		if (tmp->slab) gf_free(tmp->slab);
+		if (tmp->slab_data) gf_free(tmp->slab_data);
+		gf_free(tmp);
+		return NULL;
+	}
+	for (i=0; i<nb_items; i++) {
+		tmp->slab[i].pck = tmp->slab_data + i*GF_RTP_REORDER_SLOT_SIZE;
+		tmp->slab[i].pooled = GF_TRUE;
+		tmp->slab[i].next = (i+1<nb_items) ? &tmp->slab[i+1] : NULL;
+	}
+	tmp->free_items = tmp->slab;
 	return tmp;
 }
 
-static void DelItem(GF_POItem *it)
+static GF_POItem *NewItem(GF_RTPReorder *po, const void *pck, u32 pck_size)
+{
+	GF_POItem *it = po->free_items;
+	if (it && (pck_size <= GF_RTP_REORDER_SLOT_SIZE)) {
+		po->free_items = it->next;
+	} else {
+		it = (GF_POItem *) gf_malloc(sizeof(GF_POItem));
+		if (!it) return NULL;
+		it->pooled = GF_FALSE;
+		it->pck = gf_malloc(pck_size);
+		if (!it->pck) {
+			gf_free(it);
+			return NULL;
+		}
+	}
+	it->next = NULL;
+	it->size = pck_size;
+	memcpy(it->pck, pck, pck_size);
+	return it;
+}
+
+static void DelItem(GF_RTPReorder *po, GF_POItem *it)
 {
-	if (it) {
-		if (it->next) DelItem(it->next);
+	if (it->pooled) {
+		it->next = po->free_items;
+		po->free_items = it;
+	} else {
 		gf_free(it->pck);
 		gf_free(it);
 	}
 }
 
+static void DelItems(GF_RTPReorder *po)
+{
+	while (po->in) {
+		GF_POItem *it = po->in;
+		po->in = it->next;
+		DelItem(po, it);
+	}
+}
+
 
 GF_EXPORT
 void gf_rtp_reorderer_del(GF_RTPReorder *po)
 {
-	if (po->in) DelItem(po->in);
+	DelItems(po);
+	gf_free(po->slab);
+	gf_free(po->slab_data);
 	gf_free(po);
 }
 
@@ -821,7 +1084,7 @@ void gf_rtp_reorderer_reset(GF_RTPReorder *po)
 {
 	if (!po) return;
 
-	if (po->in) DelItem(po->in);
+	DelItems(po);
 	po->head_seqnum = 0;
 	po->Count = 0;
 	po->IsInit = 0;
@@ -836,12 +1099,9 @@ GF_Err gf_rtp_reorderer_add(GF_RTPReorder *po, const void * pck, u32 pck_size, u
 
 	if (!po) return GF_BAD_PARAM;
 
-	it = (GF_POItem *) gf_malloc(sizeof(GF_POItem));
+	it = NewItem(po, pck, pck_size);
+	if (!it) return GF_OUT_OF_MEM;
 	it->pck_seq_num = pck_seqnum;
-	it->next = NULL;
-	it->size = pck_size;
-	it->pck = gf_malloc(pck_size);
-	memcpy(it->pck, pck, pck_size);
 	/*reset timeout*/
 	po->LastTime = 0;
 
@@ -874,6 +1134,7 @@ GF_Err gf_rtp_reorderer_add(GF_RTPReorder *po, const void * pck, u32 pck_size, u
 		it->next = po->in;
 		po->in = it;
 		po->Count += 1;
+		po->nb_reordered += 1;
 
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("[rtp] Packet Reorderer: inserting packet %d at head\n", pck_seqnum));
 		return GF_OK;
@@ -902,6 +1163,7 @@ GF_Err gf_rtp_reorderer_add(GF_RTPReorder *po, const void * pck, u32 pck_size, u
 			it->next = cur->next;
 			cur->next = it;
 			po->Count += 1;
+			po->nb_reordered += 1;
 
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("[rtp] Packet Reorderer: Inserting packet %d\n", pck_seqnum));
 			//done
@@ -912,25 +1174,18 @@ GF_Err gf_rtp_reorderer_add(GF_RTPReorder *po, const void * pck, u32 pck_size, u
 
 
 discard:
-	gf_free(it->pck);
-	gf_free(it);
+	DelItem(po, it);
+	po->nb_dropped += 1;
 	GF_LOG(GF_LOG_ERROR, GF_LOG_RTP, ("[rtp] Packet Reorderer: Dropping packet %d\n", pck_seqnum));
 	return GF_OK;
 }
 
-//retrieve the first available packet. Note that the behavior will be undefined if the first
+//retrieve the first available packet item. Note that the behavior will be undefined if the first
 //ever received packet if its SeqNum was unknown
-//the BUFFER is yours, you must delete it
-GF_EXPORT
-void *gf_rtp_reorderer_get(GF_RTPReorder *po, u32 *pck_size)
+static GF_POItem *gf_rtp_reorderer_pop(GF_RTPReorder *po)
 {
 	GF_POItem *t;
 	u32 bounds;
-	void *ret;
-
-	if (!po || !pck_size) return NULL;
-
-	*pck_size = 0;
 
 	//empty queue
 	if (!po->in) return NULL;
@@ -976,17 +1231,63 @@ check_timeout:
 
 send_it:
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("[rtp] Packet Reorderer: Fetching %d\n", po->in->pck_seq_num));
-	*pck_size = po->in->size;
 	t = po->in;
 	po->in = po->in->next;
 	//no other output. reset the head seqnum
 	po->head_seqnum = po->in ? po->in->pck_seq_num : 0;
 	po->Count -= 1;
-	//release the item
-	ret = t->pck;
-	gf_free(t);
+	return t;
+}
+
+//the BUFFER is yours, you must delete it
+GF_EXPORT
+void *gf_rtp_reorderer_get(GF_RTPReorder *po, u32 *pck_size)
+{
+	GF_POItem *t;
+	void *ret;
+
+	if (!po || !pck_size) return NULL;
+
+	*pck_size = 0;
+	t = gf_rtp_reorderer_pop(po);
+	if (!t) return NULL;
+
+	*pck_size = t->size;
+	if (t->pooled) {
+		ret = gf_malloc(t->size);
+		if (ret) memcpy(ret, t->pck, t->size);
+		else *pck_size = 0;
+		DelItem(po, t);
+	} else {
+		//release the item
+		ret = t->pck;
+		gf_free(t);
+	}
 	return ret;
 }
 
+GF_EXPORT
+u32 gf_rtp_reorderer_get_into(GF_RTPReorder *po, char *buffer, u32 buffer_size)
+{
+	u32 size;
+	GF_POItem *t;
+
+	if (!po || !buffer) return 0;
+
+	t = gf_rtp_reorderer_pop(po);
+	if (!t) return 0;
+
+	size = t->size;
+	if (size > buffer_size) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_RTP, ("[rtp] Packet Reorderer: output buffer too small (%d vs %d bytes), dropping packet %d\n", buffer_size, size, t->pck_seq_num));
+		po->nb_dropped += 1;
+		size = 0;
+	} else {
+		memcpy(buffer, t->pck, size);
+	}
+	DelItem(po, t);
+	return size;
+}
+
 #endif /*GPAC_DISABLE_STREAMING*/
 
@@ -855,6 +855,24 @@ GF_Err gf_rtp_streamer_send_rtcp(GF_RTPStreamer *streamer, Bool force_ts, u32 rt
 	return gf_rtp_send_rtcp_report(streamer->channel, NULL, NULL);
 }
 
+GF_EXPORT
+GF_Err gf_rtp_streamer_set_send_batch(GF_RTPStreamer *streamer, u32 nb_packets, u32 rate_kbps, u32 pacing_us)
+{
+	u32 rate, burst;
+	if (!streamer) return GF_BAD_PARAM;
+	/*token bucket in bytes per second, depth is what is sent per pacing period*/
+	rate = rate_kbps * 1000 / 8;
+	burst = (u32) ((u64) rate * pacing_us / 1000000);
+	return gf_rtp_set_send_batch(streamer->channel, nb_packets, pacing_us ? rate : 0, burst);
+}
+
+GF_EXPORT
+GF_Err gf_rtp_streamer_flush(GF_RTPStreamer *streamer, Bool force)
+{
+	if (!streamer) return GF_BAD_PARAM;
+	return gf_rtp_flush_packets(streamer->channel, force);
+}
+
 GF_EXPORT
 u8 gf_rtp_streamer_get_payload_type(GF_RTPStreamer *streamer)
 {
@@ -4055,7 +4055,7 @@ GF_Err audio_sample_entry_Read(GF_Box *s, GF_BitStream *bs)
 
 	//when cookie is set on bs, always convert qtff-style mp4a to isobmff-style
 	//since the conversion is done in addBox and we don't have the bitstream there (arg...), flag the box
- 	if (gf_bs_get_cookie(bs)) {
+ 	if (gf_bs_get_cookie(bs) & GF_ISOM_BS_COOKIE_NO_LOGS) {
  		ptr->is_qtff |= 1<<16;
  	}
 
@@ -5313,6 +5313,7 @@ void stbl_del(GF_Box *s)
 		if (ptr->traf_map->sample_num) gf_free(ptr->traf_map->sample_num);
 		gf_free(ptr->traf_map);
 	}
+	if (ptr->lazy_box_offsets) gf_free(ptr->lazy_box_offsets);
 
 	gf_free(ptr);
 }
@@ -5432,6 +5433,7 @@ GF_Err stbl_Read(GF_Box *s, GF_BitStream *bs)
 	e = gf_isom_box_array_read(s, bs, stbl_AddBox);
 	if (e) return e;
 
+	//a deferred stss resets this flag once loaded
 	if (!ptr->SyncSample)
 		ptr->no_sync_found = 1;
 
@@ -5441,6 +5443,42 @@ GF_Err stbl_Read(GF_Box *s, GF_BitStream *bs)
 	return GF_OK;
 }
 
+Bool stbl_defer_box(GF_SampleTableBox *ptr, GF_BitStream *bs)
+{
+	u32 size, type;
+	if (gf_bs_available(bs) < 20) return GF_FALSE;
+	size = gf_bs_peek_bits(bs, 32, 0);
+	type = gf_bs_peek_bits(bs, 32, 4);
+	switch (type) {
+	case GF_ISOM_BOX_TYPE_STTS:
+	case GF_ISOM_BOX_TYPE_CTTS:
+	case GF_ISOM_BOX_TYPE_STSS:
+	case GF_ISOM_BOX_TYPE_STSC:
+	case GF_ISOM_BOX_TYPE_STSZ:
+	case GF_ISOM_BOX_TYPE_STZ2:
+	case GF_ISOM_BOX_TYPE_STCO:
+	case GF_ISOM_BOX_TYPE_CO64:
+		break;
+	default:
+		return GF_FALSE;
+	}
+	//large size, size 0 or broken boxes are parsed right away
+	if ((size < 20) || (size > ptr->size) || (size > gf_bs_available(bs))) return GF_FALSE;
+
+	//sample count is at the same offset in stsz and stz2
+	if ((type == GF_ISOM_BOX_TYPE_STSZ) || (type == GF_ISOM_BOX_TYPE_STZ2))
+		ptr->lazy_sample_count = gf_bs_peek_bits(bs, 32, 16);
+
+	ptr->lazy_box_offsets = (u64*)gf_realloc(ptr->lazy_box_offsets, sizeof(u64) * (ptr->nb_lazy_boxes+1));
+	if (!ptr->lazy_box_offsets) return GF_FALSE;
+	ptr->lazy_box_offsets[ptr->nb_lazy_boxes] = gf_bs_get_position(bs);
+	ptr->nb_lazy_boxes++;
+
+	gf_bs_skip_bytes(bs, size);
+	ptr->size -= size;
+	return GF_TRUE;
+}
+
 GF_Box *stbl_New()
 {
 	ISOM_DECL_BOX_ALLOC(GF_SampleTableBox, GF_ISOM_BOX_TYPE_STBL);
@@ -6069,6 +6107,7 @@ void stsz_del(GF_Box *s)
 	GF_SampleSizeBox *ptr = (GF_SampleSizeBox *)s;
 	if (ptr == NULL) return;
 	if (ptr->sizes) gf_free(ptr->sizes);
+	stsz_reset_packed(ptr);
 	gf_free(ptr);
 }
 
@@ -6200,16 +6239,16 @@ GF_Err stsz_Write(GF_Box *s, GF_BitStream *bs)
 	if (ptr->type == GF_ISOM_BOX_TYPE_STSZ) {
 		if (! ptr->sampleSize) {
 			for (i = 0; i < ptr->sampleCount; i++) {
-				gf_bs_write_u32(bs, ptr->sizes ? ptr->sizes[i] : 0);
+				gf_bs_write_u32(bs, ptr->sizes ? stsz_get_size(ptr, i) : 0);
 			}
 		}
 	} else {
 		for (i = 0; i < ptr->sampleCount; ) {
 			switch (ptr->sampleSize) {
 			case 4:
-				gf_bs_write_int(bs, ptr->sizes[i], 4);
+				gf_bs_write_int(bs, stsz_get_size(ptr, i), 4);
 				if (i+1 < ptr->sampleCount) {
-					gf_bs_write_int(bs, ptr->sizes[i+1], 4);
+					gf_bs_write_int(bs, stsz_get_size(ptr, i+1), 4);
 				} else {
 					//0 padding in odd sample count
 					gf_bs_write_int(bs, 0, 4);
@@ -6217,7 +6256,7 @@ GF_Err stsz_Write(GF_Box *s, GF_BitStream *bs)
 				i += 2;
 				break;
 			default:
-				gf_bs_write_int(bs, ptr->sizes[i], ptr->sampleSize);
+				gf_bs_write_int(bs, stsz_get_size(ptr, i), ptr->sampleSize);
 				i += 1;
 				break;
 			}
@@ -6228,7 +6267,7 @@ GF_Err stsz_Write(GF_Box *s, GF_BitStream *bs)
 
 GF_Err stsz_Size(GF_Box *s)
 {
-	u32 i, fieldSize, size;
+	u32 i, fieldSize, size, sample_size;
 	GF_SampleSizeBox *ptr = (GF_SampleSizeBox *)s;
 
 	ptr->size += 8;
@@ -6242,16 +6281,17 @@ GF_Err stsz_Size(GF_Box *s)
 	}
 
 	fieldSize = 4;
-	size = ptr->sizes[0];
+	size = stsz_get_size(ptr, 0);
 
 	for (i=0; i < ptr->sampleCount; i++) {
-		if (ptr->sizes[i] <= 0xF) continue;
+		sample_size = stsz_get_size(ptr, i);
+		if (sample_size <= 0xF) continue;
 		//switch to 8-bit table
-		else if (ptr->sizes[i] <= 0xFF) {
+		else if (sample_size <= 0xFF) {
 			fieldSize = 8;
 		}
 		//switch to 16-bit table
-		else if (ptr->sizes[i] <= 0xFFFF) {
+		else if (sample_size <= 0xFFFF) {
 			fieldSize = 16;
 		}
 		//switch to 32-bit table
@@ -6260,7 +6300,7 @@ GF_Err stsz_Size(GF_Box *s)
 		}
 
 		//check the size
-		if (size != ptr->sizes[i]) size = 0;
+		if (size != sample_size) size = 0;
 	}
 	//if all samples are of the same size, switch to regular (more compact)
 	if (size) {
@@ -6268,6 +6308,7 @@ GF_Err stsz_Size(GF_Box *s)
 		ptr->sampleSize = size;
 		gf_free(ptr->sizes);
 		ptr->sizes = NULL;
+		stsz_reset_packed(ptr);
 	}
 
 	if (fieldSize == 32) {
@@ -7054,7 +7095,7 @@ static void gf_isom_check_sample_desc(GF_TrackBox *trak)
 			u64 pos = gf_bs_get_position(bs); \
 			u32 count_subb = 0; \
 			GF_Err e;\
-			gf_bs_set_cookie(bs, 1);\
+			gf_bs_set_cookie(bs, GF_ISOM_BS_COOKIE_NO_LOGS);\
 			e = gf_isom_box_array_read((GF_Box *) _box, bs, gf_isom_box_add_default); \
 			count_subb = _box->other_boxes ? gf_list_count(_box->other_boxes) : 0; \
 			if (!count_subb || e) { \
@@ -7190,6 +7231,9 @@ GF_Err trak_Read(GF_Box *s, GF_BitStream *bs)
 	if (e) return e;
 	gf_isom_check_sample_desc(ptr);
 
+	if (ptr->Media && ptr->Media->information && ptr->Media->information->sampleTable && ptr->Media->information->sampleTable->nb_lazy_boxes)
+		ptr->lazy_stbl = GF_TRUE;
+
 	if (!ptr->Header) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[iso file] Missing TrackHeaderBox\n"));
 		return GF_ISOM_INVALID_FILE;
@@ -119,6 +119,8 @@ GF_Err gf_isom_dump(GF_ISOFile *mov, FILE * trace)
 	GF_Box *box;
 	if (!mov || !trace) return GF_BAD_PARAM;
 
+	if (mov->lazy_sample_tables) gf_isom_load_sample_tables(mov, 0);
+
 	use_dump_mode = mov->dump_mode_alloc;
 	fprintf(trace, "<!--MP4Box dump trace-->\n");
 
@@ -1124,7 +1126,7 @@ GF_Err stsz_dump(GF_Box *a, FILE * trace)
 			fprintf(trace, "<!--WARNING: No Sample Size indications-->\n");
 		} else {
 			for (i=0; i<p->sampleCount; i++) {
-				fprintf(trace, "<SampleSizeEntry Size=\"%d\"/>\n", p->sizes[i]);
+				fprintf(trace, "<SampleSizeEntry Size=\"%d\"/>\n", stsz_get_size(p, i));
 			}
 		}
 	}
@@ -243,6 +243,15 @@ GF_Err gf_isom_parse_movie_boxes(GF_ISOFile *mov, u64 *bytesMissing, Bool progre
 			e = gf_list_add(mov->TopBoxes, a);
 			if (e) return e;
 
+			/*fragments are merged in the sample tables, load them now*/
+			if (mov->lazy_sample_tables && mov->moov->mvex) {
+				u32 k;
+				for (k=0; k<gf_list_count(mov->moov->trackList); k++) {
+					e = gf_isom_track_load_sample_tables((GF_TrackBox *)gf_list_get(mov->moov->trackList, k));
+					if (e) return e;
+				}
+			}
+
 			totSize += a->size;
 
 			//dump senc info in dump mode
@@ -544,9 +553,13 @@ GF_ISOFile *gf_isom_open_file(const char *fileName, u32 OpenMode, const char *tm
 {
 	GF_Err e;
 	u64 bytes;
+	u32 open_flags;
 	GF_ISOFile *mov = gf_isom_new_movie();
 	if (!mov || !fileName) return NULL;
 
+	open_flags = OpenMode & ~0xFF;
+	OpenMode &= 0xFF;
+
 	mov->fileName = gf_strdup(fileName);
 	mov->openMode = OpenMode;
 
@@ -572,6 +585,9 @@ GF_ISOFile *gf_isom_open_file(const char *fileName, u32 OpenMode, const char *tm
 #ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
 			mov->FragmentsFlags |= GF_ISOM_FRAG_READ_DEBUG;
 #endif
+		} else if (open_flags & GF_ISOM_OPEN_LAZY_TABLES) {
+			mov->lazy_sample_tables = GF_TRUE;
+			gf_bs_set_cookie(mov->movieFileMap->bs, GF_ISOM_BS_COOKIE_LAZY_STBL);
 		}
 	} else {
 
@@ -618,6 +634,8 @@ GF_ISOFile *gf_isom_open_file(const char *fileName, u32 OpenMode, const char *tm
 
 	//OK, let's parse the movie...
 	mov->LastError = gf_isom_parse_movie_boxes(mov, &bytes, 0);
+	if (mov->lazy_sample_tables)
+		gf_bs_set_cookie(mov->movieFileMap->bs, 0);
 
 	if (!mov->LastError && (OpenMode == GF_ISOM_OPEN_CAT_FRAGMENTS)) {
 		gf_isom_datamap_del(mov->movieFileMap);
@@ -685,7 +703,10 @@ GF_TrackBox *gf_isom_get_track_from_id(GF_MovieBox *moov, u32 trackID)
 	count = gf_list_count(moov->trackList);
 	for (i = 0; i<count; i++) {
 		trak = (GF_TrackBox*)gf_list_get(moov->trackList, i);
-		if (trak->Header->trackID == trackID) return trak;
+		if (trak->Header->trackID == trackID) {
+			if (trak->lazy_stbl) gf_isom_track_load_sample_tables(trak);
+			return trak;
+		}
 	}
 	return NULL;
 }
@@ -713,6 +734,56 @@ GF_TrackBox *gf_isom_get_track_from_file(GF_ISOFile *movie, u32 trackNumber)
 	return trak;
 }
 
+GF_TrackBox *gf_isom_get_track_header_from_file(GF_ISOFile *movie, u32 trackNumber)
+{
+	GF_TrackBox *trak;
+	if (!movie || !movie->moov || !trackNumber || (trackNumber > gf_list_count(movie->moov->trackList))) {
+		if (movie) movie->LastError = GF_BAD_PARAM;
+		return NULL;
+	}
+	trak = (GF_TrackBox*)gf_list_get(movie->moov->trackList, trackNumber - 1);
+	return trak;
+}
+
+GF_Err gf_isom_track_load_sample_tables(GF_TrackBox *trak)
+{
+	u32 i;
+	u64 pos;
+	GF_Err e = GF_OK;
+	GF_BitStream *bs;
+	GF_SampleTableBox *stbl;
+	if (!trak || !trak->lazy_stbl) return GF_OK;
+	trak->lazy_stbl = GF_FALSE;
+
+	stbl = trak->Media->information->sampleTable;
+	bs = trak->moov->mov->movieFileMap->bs;
+	pos = gf_bs_get_position(bs);
+	for (i=0; i<stbl->nb_lazy_boxes; i++) {
+		GF_Box *a = NULL;
+		gf_bs_seek(bs, stbl->lazy_box_offsets[i]);
+		e = gf_isom_box_parse_ex(&a, bs, GF_ISOM_BOX_TYPE_STBL, GF_FALSE);
+		if (!e) e = stbl_AddBox((GF_Box *)stbl, a);
+		if (e) {
+			if (a) gf_isom_box_del(a);
+			break;
+		}
+	}
+	gf_bs_seek(bs, pos);
+
+	gf_free(stbl->lazy_box_offsets);
+	stbl->lazy_box_offsets = NULL;
+	stbl->nb_lazy_boxes = 0;
+	if (stbl->SyncSample) stbl->no_sync_found = 0;
+
+	if (e) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[iso file] Failed to load sample tables of track %d: %s\n", trak->Header->trackID, gf_error_to_string(e) ));
+		trak->moov->mov->LastError = e;
+	} else {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[iso file] Loaded sample tables of track %d\n", trak->Header->trackID));
+	}
+	return e;
+}
+
 
 //WARNING: MOVIETIME IS EXPRESSED IN MEDIA TS
 GF_Err GetMediaTime(GF_TrackBox *trak, Bool force_non_empty, u64 movieTime, u64 *MediaTime, s64 *SegmentStartTime, s64 *MediaOffset, u8 *useEdit, u64 *next_edit_start_plus_one)
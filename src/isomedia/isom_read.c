@@ -56,6 +56,25 @@ u8 gf_isom_get_mode(GF_ISOFile *the_file)
 	return the_file->openMode;
 }
 
+GF_EXPORT
+GF_Err gf_isom_load_sample_tables(GF_ISOFile *movie, u32 trackNumber)
+{
+	u32 i, count;
+	GF_Err e;
+	if (!movie || !movie->moov) return GF_BAD_PARAM;
+	if (trackNumber) {
+		GF_TrackBox *trak = gf_isom_get_track_header_from_file(movie, trackNumber);
+		if (!trak) return GF_BAD_PARAM;
+		return gf_isom_track_load_sample_tables(trak);
+	}
+	count = gf_list_count(movie->moov->trackList);
+	for (i=0; i<count; i++) {
+		e = gf_isom_track_load_sample_tables((GF_TrackBox *)gf_list_get(movie->moov->trackList, i));
+		if (e) return e;
+	}
+	return GF_OK;
+}
+
 GF_EXPORT
 u64 gf_isom_get_file_size(GF_ISOFile *the_file)
 {
@@ -462,6 +481,14 @@ GF_Err gf_isom_write(GF_ISOFile *movie) {
 	//write our movie to the file
 	if (movie->openMode != GF_ISOM_OPEN_READ) {
 		gf_isom_get_duration(movie);
+#ifndef GPAC_DISABLE_LOG
+		if (gf_log_tool_level_on(GF_LOG_CONTAINER, GF_LOG_DEBUG)) {
+			u32 i;
+			for (i=0; i<gf_isom_get_track_count(movie); i++) {
+				GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[IsoMedia] Track %d: %d samples, sample tables use "LLU" bytes\n", i+1, gf_isom_get_sample_count(movie, i+1), gf_isom_get_sample_table_memory(movie, i+1) ));
+			}
+		}
+#endif
 #ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
 		//movie fragment mode, just store the fragment
 		if ( (movie->openMode == GF_ISOM_OPEN_WRITE) && (movie->FragmentsFlags & GF_ISOM_FRAG_WRITE_READY) ) {
@@ -642,7 +669,7 @@ u32 gf_isom_get_track_id(GF_ISOFile *movie, u32 trackNumber)
 {
 	GF_TrackBox *trak;
 	if (!movie) return 0;
-	trak = gf_isom_get_track_from_file(movie, trackNumber);
+	trak = gf_isom_get_track_header_from_file(movie, trackNumber);
 	if (!trak || !trak->Header) return 0;
 	return trak->Header->trackID;
 }
@@ -855,7 +882,7 @@ GF_EXPORT
 u8 gf_isom_is_track_enabled(GF_ISOFile *the_file, u32 trackNumber)
 {
 	GF_TrackBox *trak;
-	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	trak = gf_isom_get_track_header_from_file(the_file, trackNumber);
 
 	if (!trak || !trak->Header) return 2;
 	return (trak->Header->flags & 1) ? 1 : 0;
@@ -868,12 +895,12 @@ GF_EXPORT
 u64 gf_isom_get_track_duration(GF_ISOFile *movie, u32 trackNumber)
 {
 	GF_TrackBox *trak;
-	trak = gf_isom_get_track_from_file(movie, trackNumber);
+	trak = gf_isom_get_track_header_from_file(movie, trackNumber);
 	if (!trak) return 0;
 
 #ifndef GPAC_DISABLE_ISOM_WRITE
 	/*in all modes except dump recompute duration in case headers are wrong*/
-	if (movie->openMode != GF_ISOM_OPEN_READ_DUMP) {
+	if ((movie->openMode != GF_ISOM_OPEN_READ_DUMP) && !trak->lazy_stbl) {
 		SetTrackDuration(trak);
 	}
 #endif
@@ -890,7 +917,7 @@ GF_Err gf_isom_get_media_language(GF_ISOFile *the_file, u32 trackNumber, char **
 		return GF_BAD_PARAM;
 	}
 	*lang = NULL;
-	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	trak = gf_isom_get_track_header_from_file(the_file, trackNumber);
 	if (!trak || !trak->Media) return GF_BAD_PARAM;
 	count = gf_list_count(trak->Media->other_boxes);
 	if (count>0) {
@@ -1107,7 +1134,7 @@ GF_EXPORT
 u32 gf_isom_get_sample_description_count(GF_ISOFile *the_file, u32 trackNumber)
 {
 	GF_TrackBox *trak;
-	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	trak = gf_isom_get_track_header_from_file(the_file, trackNumber);
 	if (!trak) return 0;
 
 	return gf_list_count(trak->Media->information->sampleTable->SampleDescription->other_boxes);
@@ -1157,14 +1184,14 @@ GF_EXPORT
 u64 gf_isom_get_media_duration(GF_ISOFile *movie, u32 trackNumber)
 {
 	GF_TrackBox *trak;
-	trak = gf_isom_get_track_from_file(movie, trackNumber);
+	trak = gf_isom_get_track_header_from_file(movie, trackNumber);
 	if (!trak) return 0;
 
 
 #ifndef GPAC_DISABLE_ISOM_WRITE
 
-	/*except in dump mode always recompute the duration*/
-	if (movie->openMode != GF_ISOM_OPEN_READ_DUMP) {
+	/*except in dump mode always recompute the duration - trust headers until sample tables are loaded*/
+	if ((movie->openMode != GF_ISOM_OPEN_READ_DUMP) && !trak->lazy_stbl) {
 		if ( (movie->LastError = Media_SetDuration(trak)) ) return 0;
 	}
 
@@ -1190,7 +1217,7 @@ GF_EXPORT
 u32 gf_isom_get_media_timescale(GF_ISOFile *the_file, u32 trackNumber)
 {
 	GF_TrackBox *trak;
-	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	trak = gf_isom_get_track_header_from_file(the_file, trackNumber);
 	if (!trak || !trak->Media || !trak->Media->mediaHeader) return 0;
 	return trak->Media->mediaHeader->timeScale;
 }
@@ -1311,7 +1338,7 @@ GF_EXPORT
 u32 gf_isom_get_media_type(GF_ISOFile *movie, u32 trackNumber)
 {
 	GF_TrackBox *trak;
-	trak = gf_isom_get_track_from_file(movie, trackNumber);
+	trak = gf_isom_get_track_header_from_file(movie, trackNumber);
 	if (!trak) return GF_BAD_PARAM;
 	return (trak->Media && trak->Media->handler) ? trak->Media->handler->handlerType : 0;
 }
@@ -1366,7 +1393,7 @@ u32 gf_isom_get_media_subtype(GF_ISOFile *the_file, u32 trackNumber, u32 Descrip
 {
 	GF_TrackBox *trak;
 	GF_Box *entry;
-	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	trak = gf_isom_get_track_header_from_file(the_file, trackNumber);
 	if (!trak || !DescriptionIndex || !trak->Media || !trak->Media->information || !trak->Media->information->sampleTable) return 0;
 	entry = (GF_Box*)gf_list_get(trak->Media->information->sampleTable->SampleDescription->other_boxes, DescriptionIndex-1);
 	if (!entry) return 0;
@@ -1409,7 +1436,7 @@ GF_EXPORT
 GF_Err gf_isom_get_handler_name(GF_ISOFile *the_file, u32 trackNumber, const char **outName)
 {
 	GF_TrackBox *trak;
-	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	trak = gf_isom_get_track_header_from_file(the_file, trackNumber);
 	if (!trak || !outName) return GF_BAD_PARAM;
 	*outName = trak->Media->handler->nameUTF8;
 	return GF_OK;
@@ -1478,8 +1505,11 @@ GF_EXPORT
 u32 gf_isom_get_sample_count(GF_ISOFile *the_file, u32 trackNumber)
 {
 	GF_TrackBox *trak;
-	trak = gf_isom_get_track_from_file(the_file, trackNumber);
-	if (!trak || !trak->Media || !trak->Media->information || !trak->Media->information->sampleTable || !trak->Media->information->sampleTable->SampleSize) return 0;
+	trak = gf_isom_get_track_header_from_file(the_file, trackNumber);
+	if (!trak || !trak->Media || !trak->Media->information || !trak->Media->information->sampleTable) return 0;
+	if (trak->lazy_stbl && !trak->Media->information->sampleTable->SampleSize)
+		return trak->Media->information->sampleTable->lazy_sample_count;
+	if (!trak->Media->information->sampleTable->SampleSize) return 0;
 	return trak->Media->information->sampleTable->SampleSize->sampleCount
 #ifndef GPAC_DISABLE_ISOM_FRAGMENTS
 	       + trak->sample_count_at_seg_start
@@ -2049,6 +2079,100 @@ GF_Err gf_isom_set_sample_padding(GF_ISOFile *the_file, u32 trackNumber, u32 pad
 
 }
 
+struct __isom_track_cursor
+{
+	/*ID of the track the cursor was saved for, 0 if never saved*/
+	u32 trackID;
+	/*stts*/
+	u32 stts_first_sample, stts_entry;
+	u64 stts_dts;
+	/*ctts*/
+	u32 ctts_first_sample, ctts_entry;
+	/*stsc*/
+	u32 stsc_entry, stsc_first_sample, stsc_chunk, stsc_ghost;
+	/*stss*/
+	u32 stss_last_sync, stss_index;
+};
+
+GF_EXPORT
+GF_ISOTrackCursor *gf_isom_track_cursor_new()
+{
+	GF_ISOTrackCursor *cursor;
+	GF_SAFEALLOC(cursor, GF_ISOTrackCursor);
+	return cursor;
+}
+
+GF_EXPORT
+void gf_isom_track_cursor_del(GF_ISOTrackCursor *cursor)
+{
+	if (cursor) gf_free(cursor);
+}
+
+GF_EXPORT
+GF_Err gf_isom_track_cursor_load(GF_ISOFile *the_file, u32 trackNumber, GF_ISOTrackCursor *cursor)
+{
+	GF_SampleTableBox *stbl;
+	GF_TrackBox *trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	if (!trak || !cursor) return GF_BAD_PARAM;
+	stbl = trak->Media->information->sampleTable;
+	/*all-zero caches restart lookups from the first sample*/
+	if (cursor->trackID != trak->Header->trackID) {
+		memset(cursor, 0, sizeof(GF_ISOTrackCursor));
+	}
+	/*the tables are not modified while reading, a position saved earlier is still consistent*/
+	if (stbl->TimeToSample) {
+		stbl->TimeToSample->r_FirstSampleInEntry = cursor->stts_first_sample;
+		stbl->TimeToSample->r_currentEntryIndex = cursor->stts_entry;
+		stbl->TimeToSample->r_CurrentDTS = cursor->stts_dts;
+	}
+	if (stbl->CompositionOffset) {
+		stbl->CompositionOffset->r_FirstSampleInEntry = cursor->ctts_first_sample;
+		stbl->CompositionOffset->r_currentEntryIndex = cursor->ctts_entry;
+	}
+	if (stbl->SampleToChunk) {
+		stbl->SampleToChunk->currentIndex = cursor->stsc_entry;
+		stbl->SampleToChunk->firstSampleInCurrentChunk = cursor->stsc_first_sample;
+		stbl->SampleToChunk->currentChunk = cursor->stsc_chunk;
+		stbl->SampleToChunk->ghostNumber = cursor->stsc_ghost;
+	}
+	if (stbl->SyncSample) {
+		stbl->SyncSample->r_LastSyncSample = cursor->stss_last_sync;
+		stbl->SyncSample->r_LastSampleIndex = cursor->stss_index;
+	}
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_isom_track_cursor_save(GF_ISOFile *the_file, u32 trackNumber, GF_ISOTrackCursor *cursor)
+{
+	GF_SampleTableBox *stbl;
+	GF_TrackBox *trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	if (!trak || !cursor) return GF_BAD_PARAM;
+	stbl = trak->Media->information->sampleTable;
+	memset(cursor, 0, sizeof(GF_ISOTrackCursor));
+	cursor->trackID = trak->Header->trackID;
+	if (stbl->TimeToSample) {
+		cursor->stts_first_sample = stbl->TimeToSample->r_FirstSampleInEntry;
+		cursor->stts_entry = stbl->TimeToSample->r_currentEntryIndex;
+		cursor->stts_dts = stbl->TimeToSample->r_CurrentDTS;
+	}
+	if (stbl->CompositionOffset) {
+		cursor->ctts_first_sample = stbl->CompositionOffset->r_FirstSampleInEntry;
+		cursor->ctts_entry = stbl->CompositionOffset->r_currentEntryIndex;
+	}
+	if (stbl->SampleToChunk) {
+		cursor->stsc_entry = stbl->SampleToChunk->currentIndex;
+		cursor->stsc_first_sample = stbl->SampleToChunk->firstSampleInCurrentChunk;
+		cursor->stsc_chunk = stbl->SampleToChunk->currentChunk;
+		cursor->stsc_ghost = stbl->SampleToChunk->ghostNumber;
+	}
+	if (stbl->SyncSample) {
+		cursor->stss_last_sync = stbl->SyncSample->r_LastSyncSample;
+		cursor->stss_index = stbl->SyncSample->r_LastSampleIndex;
+	}
+	return GF_OK;
+}
+
 //get the number of edited segment
 GF_EXPORT
 Bool gf_isom_get_edit_list_type(GF_ISOFile *the_file, u32 trackNumber, s64 *mediaOffset)
@@ -3099,7 +3223,7 @@ GF_Err gf_isom_get_visual_info(GF_ISOFile *movie, u32 trackNumber, u32 StreamDes
 	GF_SampleEntryBox *entry;
 	GF_SampleDescriptionBox *stsd;
 
-	trak = gf_isom_get_track_from_file(movie, trackNumber);
+	trak = gf_isom_get_track_header_from_file(movie, trackNumber);
 	if (!trak) return GF_BAD_PARAM;
 
 	stsd = trak->Media->information->sampleTable->SampleDescription;
@@ -3157,7 +3281,7 @@ GF_Err gf_isom_get_audio_info(GF_ISOFile *movie, u32 trackNumber, u32 StreamDesc
 	GF_SampleEntryBox *entry;
 	GF_SampleDescriptionBox *stsd = NULL;
 
-	trak = gf_isom_get_track_from_file(movie, trackNumber);
+	trak = gf_isom_get_track_header_from_file(movie, trackNumber);
 	if (!trak) return GF_BAD_PARAM;
 
 	if (trak->Media && trak->Media->information && trak->Media->information->sampleTable && trak->Media->information->sampleTable->SampleDescription)
@@ -3293,7 +3417,7 @@ GF_Err gf_isom_get_track_matrix(GF_ISOFile *the_file, u32 trackNumber, u32 matri
 GF_EXPORT
 GF_Err gf_isom_get_track_layout_info(GF_ISOFile *movie, u32 trackNumber, u32 *width, u32 *height, s32 *translation_x, s32 *translation_y, s16 *layer)
 {
-	GF_TrackBox *tk = gf_isom_get_track_from_file(movie, trackNumber);
+	GF_TrackBox *tk = gf_isom_get_track_header_from_file(movie, trackNumber);
 	if (!tk) return GF_BAD_PARAM;
 	if (width) *width = tk->Header->width>>16;
 	if (height) *height = tk->Header->height>>16;
@@ -3317,7 +3441,38 @@ u64 gf_isom_get_media_data_size(GF_ISOFile *movie, u32 trackNumber)
 	if (!stsz) return 0;
 	if (stsz->sampleSize) return stsz->sampleSize*stsz->sampleCount;
 	size = 0;
-	for (i=0; i<stsz->sampleCount; i++) size += stsz->sizes[i];
+	for (i=0; i<stsz->sampleCount; i++) size += stsz_get_size(stsz, i);
+	return size;
+}
+
+GF_EXPORT
+u64 gf_isom_get_sample_table_memory(GF_ISOFile *movie, u32 trackNumber)
+{
+	u64 size;
+	GF_SampleTableBox *stbl;
+	GF_TrackBox *tk = gf_isom_get_track_header_from_file(movie, trackNumber);
+	if (!tk || !tk->Media || !tk->Media->information || !tk->Media->information->sampleTable) return 0;
+	stbl = tk->Media->information->sampleTable;
+
+	size = 0;
+	if (stbl->TimeToSample) size += sizeof(GF_SttsEntry) * MAX(stbl->TimeToSample->alloc_size, stbl->TimeToSample->nb_entries);
+	if (stbl->CompositionOffset) size += sizeof(GF_DttsEntry) * MAX(stbl->CompositionOffset->alloc_size, stbl->CompositionOffset->nb_entries);
+	if (stbl->SyncSample) size += sizeof(u32) * MAX(stbl->SyncSample->alloc_size, stbl->SyncSample->nb_entries);
+	if (stbl->SampleToChunk) size += sizeof(GF_StscEntry) * MAX(stbl->SampleToChunk->alloc_size, stbl->SampleToChunk->nb_entries);
+	if (stbl->SampleSize) {
+		GF_SampleSizeBox *stsz = stbl->SampleSize;
+		if (stsz->sizes) size += sizeof(u32) * MAX(stsz->alloc_size, stsz->sampleCount - stsz->nb_blocks*GF_ISOM_STSZ_BLOCK_SIZE);
+		size += sizeof(GF_StszBlock) * stsz->alloc_blocks + stsz->packed_alloc;
+	}
+	if (stbl->ChunkOffset) {
+		if (stbl->ChunkOffset->type == GF_ISOM_BOX_TYPE_STCO) {
+			GF_ChunkOffsetBox *stco = (GF_ChunkOffsetBox *)stbl->ChunkOffset;
+			size += sizeof(u32) * MAX(stco->alloc_size, stco->nb_entries);
+		} else {
+			GF_ChunkLargeOffsetBox *co64 = (GF_ChunkLargeOffsetBox *)stbl->ChunkOffset;
+			size += sizeof(u64) * MAX(co64->alloc_size, co64->nb_entries);
+		}
+	}
 	return size;
 }
 
@@ -3726,7 +3881,8 @@ void gf_isom_reset_fragment_info(GF_ISOFile *movie, Bool keep_sample_count)
 	if (!movie) return;
 	for (i=0; i<gf_list_count(movie->moov->trackList); i++) {
 		GF_TrackBox *trak = (GF_TrackBox*)gf_list_get(movie->moov->trackList, i);
-		trak->Media->information->sampleTable->SampleSize->sampleCount = 0;
+		//sizes of the discarded samples, packed or not, shall not be reused by the next appended ones
+		stsz_reset(trak->Media->information->sampleTable->SampleSize);
 #ifdef GPAC_DISABLE_ISOM_FRAGMENTS
 	}
 #else
@@ -3754,7 +3910,7 @@ void gf_isom_reset_sample_count(GF_ISOFile *movie)
 	if (!movie) return;
 	for (i=0; i<gf_list_count(movie->moov->trackList); i++) {
 		GF_TrackBox *trak = (GF_TrackBox*)gf_list_get(movie->moov->trackList, i);
-		trak->Media->information->sampleTable->SampleSize->sampleCount = 0;
+		stsz_reset(trak->Media->information->sampleTable->SampleSize);
 		trak->sample_count_at_seg_start = 0;
 	}
 	movie->NextMoofNumber = 0;
@@ -2569,6 +2569,8 @@ GF_Err gf_isom_use_compact_size(GF_ISOFile *movie, u32 trackNumber, u8 Compactio
 		return GF_ISOM_INVALID_FILE;
 
 	stsz = trak->Media->information->sampleTable->SampleSize;
+	e = stsz_unpack(stsz);
+	if (e) return e;
 
 	//switch to regular table
 	if (!CompactionOn) {
@@ -3169,7 +3171,7 @@ GF_Err gf_isom_clone_track(GF_ISOFile *orig_file, u32 orig_track, GF_ISOFile *de
 	gf_bs_del(bs);
 	bs = gf_bs_new(data, data_size, GF_BITSTREAM_READ);
 	if (flags & GF_ISOM_CLONE_TRACK_NO_QT)
-		gf_bs_set_cookie(bs, 1);
+		gf_bs_set_cookie(bs, GF_ISOM_BS_COOKIE_NO_LOGS);
 	e = gf_isom_box_parse((GF_Box **) &new_tk, bs);
 	gf_bs_del(bs);
 	gf_free(data);
@@ -6112,7 +6114,10 @@ GF_Err gf_isom_update_duration(GF_ISOFile *movie)
 	maxDur = 0;
 	i=0;
 	while ((trak = (GF_TrackBox *)gf_list_enum(movie->moov->trackList, &i))) {
-		if( (movie->LastError = SetTrackDuration(trak))	) return movie->LastError;
+		//sample tables not loaded yet were not modified since opening, the track duration is up to date
+		if (!trak->lazy_stbl) {
+			if( (movie->LastError = SetTrackDuration(trak))	) return movie->LastError;
+		}
 		if (trak->Header->duration > maxDur)
 			maxDur = trak->Header->duration;
 	}
@@ -132,7 +132,159 @@ GF_Err stbl_GetSampleSize(GF_SampleSizeBox *stsz, u32 SampleNumber, u32 *Size)
 	if (stsz->sampleSize && (stsz->type != GF_ISOM_BOX_TYPE_STZ2)) {
 		(*Size) = stsz->sampleSize;
 	} else if (stsz->sizes) {
-		(*Size) = stsz->sizes[SampleNumber - 1];
+		(*Size) = stsz_get_size(stsz, SampleNumber - 1);
+	}
+	return GF_OK;
+}
+
+u32 stsz_get_size(GF_SampleSizeBox *stsz, u32 sampleIdx)
+{
+	u32 bit_pos;
+	u64 val;
+	u8 *data;
+	GF_StszBlock *blk;
+	u32 nb_packed = stsz->nb_blocks * GF_ISOM_STSZ_BLOCK_SIZE;
+
+	if (sampleIdx >= nb_packed) return stsz->sizes[sampleIdx - nb_packed];
+
+	blk = &stsz->blocks[sampleIdx / GF_ISOM_STSZ_BLOCK_SIZE];
+	if (!blk->nb_bits) return blk->min_size;
+
+	bit_pos = (sampleIdx % GF_ISOM_STSZ_BLOCK_SIZE) * blk->nb_bits;
+	data = stsz->packed + blk->offset + bit_pos/8;
+	//at most 32+7 bits to read, the packed buffer is padded for this
+	val = (u64) data[0] | ((u64) data[1] << 8) | ((u64) data[2] << 16) | ((u64) data[3] << 24) | ((u64) data[4] << 32);
+	val >>= bit_pos % 8;
+	val &= (((u64)1) << blk->nb_bits) - 1;
+	return blk->min_size + (u32) val;
+}
+
+void stsz_reset_packed(GF_SampleSizeBox *stsz)
+{
+	if (stsz->blocks) gf_free(stsz->blocks);
+	if (stsz->packed) gf_free(stsz->packed);
+	stsz->blocks = NULL;
+	stsz->packed = NULL;
+	stsz->nb_blocks = stsz->alloc_blocks = 0;
+	stsz->packed_size = stsz->packed_alloc = 0;
+}
+
+void stsz_reset(GF_SampleSizeBox *stsz)
+{
+	if (stsz->sizes) gf_free(stsz->sizes);
+	stsz->sizes = NULL;
+	stsz->alloc_size = 0;
+	stsz->sampleSize = 0;
+	stsz->sampleCount = 0;
+	stsz_reset_packed(stsz);
+}
+
+GF_Err stsz_unpack(GF_SampleSizeBox *stsz)
+{
+	u32 i, nb_packed;
+	u32 *sizes;
+	if (!stsz->nb_blocks) return GF_OK;
+
+	nb_packed = stsz->nb_blocks * GF_ISOM_STSZ_BLOCK_SIZE;
+	sizes = (u32 *) gf_malloc(sizeof(u32) * stsz->sampleCount);
+	if (!sizes) return GF_OUT_OF_MEM;
+	for (i=0; i<nb_packed; i++) {
+		sizes[i] = stsz_get_size(stsz, i);
+	}
+	memcpy(sizes + nb_packed, stsz->sizes, sizeof(u32) * (stsz->sampleCount - nb_packed));
+	gf_free(stsz->sizes);
+	stsz->sizes = sizes;
+	stsz->alloc_size = stsz->sampleCount;
+	stsz_reset_packed(stsz);
+	return GF_OK;
+}
+
+static GF_Err stsz_pack_block(GF_SampleSizeBox *stsz, u32 *sizes)
+{
+	u32 i, min_size, max_size, nb_bits, nb_bytes, nb_acc;
+	u64 acc;
+	u8 *data;
+	GF_StszBlock *blk;
+
+	min_size = max_size = sizes[0];
+	for (i=1; i<GF_ISOM_STSZ_BLOCK_SIZE; i++) {
+		if (sizes[i] < min_size) min_size = sizes[i];
+		else if (sizes[i] > max_size) max_size = sizes[i];
+	}
+	nb_bits = 0;
+	while ((nb_bits<32) && ((max_size - min_size) >> nb_bits)) nb_bits++;
+	nb_bytes = (GF_ISOM_STSZ_BLOCK_SIZE * nb_bits + 7) / 8;
+
+	if (stsz->nb_blocks == stsz->alloc_blocks) {
+		stsz->alloc_blocks = stsz->alloc_blocks ? (stsz->alloc_blocks*3)/2 : 16;
+		stsz->blocks = (GF_StszBlock *) gf_realloc(stsz->blocks, sizeof(GF_StszBlock) * stsz->alloc_blocks);
+		if (!stsz->blocks) return GF_OUT_OF_MEM;
+	}
+	//keep 4 bytes of padding at the end so that any size can be read on 5 bytes
+	if (stsz->packed_size + nb_bytes + 4 > stsz->packed_alloc) {
+		u32 size = stsz->packed_alloc ? (stsz->packed_alloc*3)/2 : 1024;
+		if (size < stsz->packed_size + nb_bytes + 4) size = stsz->packed_size + nb_bytes + 4;
+		stsz->packed = (u8 *) gf_realloc(stsz->packed, size);
+		if (!stsz->packed) return GF_OUT_OF_MEM;
+		memset(stsz->packed + stsz->packed_alloc, 0, size - stsz->packed_alloc);
+		stsz->packed_alloc = size;
+	}
+
+	blk = &stsz->blocks[stsz->nb_blocks];
+	blk->offset = stsz->packed_size;
+	blk->min_size = min_size;
+	blk->nb_bits = nb_bits;
+
+	if (nb_bits) {
+		data = stsz->packed + stsz->packed_size;
+		acc = 0;
+		nb_acc = 0;
+		for (i=0; i<GF_ISOM_STSZ_BLOCK_SIZE; i++) {
+			acc |= ((u64) (sizes[i] - min_size)) << nb_acc;
+			nb_acc += nb_bits;
+			while (nb_acc >= 8) {
+				*data++ = (u8) acc;
+				acc >>= 8;
+				nb_acc -= 8;
+			}
+		}
+		if (nb_acc) *data = (u8) acc;
+	}
+	stsz->packed_size += nb_bytes;
+	stsz->nb_blocks++;
+	return GF_OK;
+}
+
+GF_Err stsz_append_size(GF_SampleSizeBox *stsz, u32 size)
+{
+	GF_Err e;
+	u32 i, nb_tail = stsz->sampleCount - stsz->nb_blocks * GF_ISOM_STSZ_BLOCK_SIZE;
+
+	if (nb_tail >= stsz->alloc_size) {
+		stsz->alloc_size = stsz->alloc_size ? 2*stsz->alloc_size : 16;
+		if (stsz->alloc_size > GF_ISOM_STSZ_BLOCK_SIZE+1) stsz->alloc_size = GF_ISOM_STSZ_BLOCK_SIZE+1;
+		if (stsz->alloc_size <= nb_tail) stsz->alloc_size = nb_tail+1;
+		stsz->sizes = (u32 *) gf_realloc(stsz->sizes, sizeof(u32) * stsz->alloc_size);
+		if (!stsz->sizes) return GF_OUT_OF_MEM;
+	}
+	stsz->sizes[nb_tail] = size;
+	stsz->sampleCount++;
+	nb_tail++;
+
+	//pack all full blocks, always keeping the last size unpacked so that it can be modified
+	if (nb_tail <= GF_ISOM_STSZ_BLOCK_SIZE) return GF_OK;
+	i = 0;
+	while (nb_tail - i > GF_ISOM_STSZ_BLOCK_SIZE) {
+		e = stsz_pack_block(stsz, stsz->sizes + i);
+		if (e) return e;
+		i += GF_ISOM_STSZ_BLOCK_SIZE;
+	}
+	memmove(stsz->sizes, stsz->sizes + i, sizeof(u32) * (nb_tail - i));
+	//plain table being packed for the first time
+	if (stsz->alloc_size > GF_ISOM_STSZ_BLOCK_SIZE+1) {
+		stsz->alloc_size = GF_ISOM_STSZ_BLOCK_SIZE+1;
+		stsz->sizes = (u32 *) gf_realloc(stsz->sizes, sizeof(u32) * stsz->alloc_size);
+		if (!stsz->sizes) return GF_OUT_OF_MEM;
 	}
 	return GF_OK;
 }
@@ -406,15 +406,11 @@ GF_Err stbl_AddSize(GF_SampleSizeBox *stsz, u32 sampleNumber, u32 size, u32 nb_p
 
 	/*append*/
 	if (stsz->sampleCount + 1 == sampleNumber) {
-		if (!stsz->alloc_size) stsz->alloc_size = stsz->sampleCount;
-		if (stsz->sampleCount == stsz->alloc_size) {
-			ALLOC_INC(stsz->alloc_size);
-			stsz->sizes = gf_realloc(stsz->sizes, sizeof(u32)*(stsz->alloc_size) );
-			if (!stsz->sizes) return GF_OUT_OF_MEM;
-			memset(&stsz->sizes[stsz->sampleCount], 0, sizeof(u32)*(stsz->alloc_size - stsz->sampleCount) );
-		}
-		stsz->sizes[stsz->sampleCount] = size;
+		if (!stsz->alloc_size && !stsz->nb_blocks) stsz->alloc_size = stsz->sampleCount;
+		return stsz_append_size(stsz, size);
 	} else {
+		GF_Err e = stsz_unpack(stsz);
+		if (e) return e;
 		newSizes = (u32*)gf_malloc(sizeof(u32)*(1 + stsz->sampleCount) );
 		if (!newSizes) return GF_OUT_OF_MEM;
 		k = 0;
@@ -892,6 +888,9 @@ GF_Err stbl_SetSampleSize(GF_SampleSizeBox *stsz, u32 SampleNumber, u32 size)
 		if (!stsz->sizes) return GF_OUT_OF_MEM;
 		for (i=0; i<stsz->sampleCount; i++) stsz->sizes[i] = stsz->sampleSize;
 		stsz->sampleSize = 0;
+	} else {
+		GF_Err e = stsz_unpack(stsz);
+		if (e) return e;
 	}
 	stsz->sizes[SampleNumber - 1] = size;
 	return GF_OK;
@@ -1095,6 +1094,7 @@ GF_Err stbl_RemoveSize(GF_SampleSizeBox *stsz, u32 sampleNumber)
 		if (stsz->sizes) gf_free(stsz->sizes);
 		stsz->sizes = NULL;
 		stsz->sampleCount = 0;
+		stsz_reset_packed(stsz);
 		return GF_OK;
 	}
 	//one single size
@@ -1102,6 +1102,7 @@ GF_Err stbl_RemoveSize(GF_SampleSizeBox *stsz, u32 sampleNumber)
 		stsz->sampleCount -= 1;
 		return GF_OK;
 	}
+	if (stsz_unpack(stsz)) return GF_OUT_OF_MEM;
 	if (sampleNumber < stsz->sampleCount) {
 		memmove(stsz->sizes + sampleNumber - 1, stsz->sizes + sampleNumber, sizeof(u32) * (stsz->sampleCount - sampleNumber));
 	}
@@ -1420,11 +1421,12 @@ GF_Err stbl_SampleSizeAppend(GF_SampleSizeBox *stsz, u32 data_size)
 	if (!stsz->sizes) {
 		stsz->sampleSize = data_size;
 	} else {
-		stsz->sizes[stsz->sampleCount-1] += data_size;
+		//the last size is never packed
+		stsz->sizes[stsz->sampleCount - 1 - stsz->nb_blocks*GF_ISOM_STSZ_BLOCK_SIZE] += data_size;
 
-		single_size = stsz->sizes[0];
+		single_size = stsz_get_size(stsz, 0);
 		for (i=1; i<stsz->sampleCount; i++) {
-			if (stsz->sizes[i] != single_size) {
+			if (stsz_get_size(stsz, i) != single_size) {
 				single_size = 0;
 				break;
 			}
@@ -1433,6 +1435,7 @@ GF_Err stbl_SampleSizeAppend(GF_SampleSizeBox *stsz, u32 data_size)
 			stsz->sampleSize = single_size;
 			gf_free(stsz->sizes);
 			stsz->sizes = NULL;
+			stsz_reset_packed(stsz);
 		}
 	}
 	return GF_OK;
@@ -1478,24 +1481,18 @@ void stbl_AppendSize(GF_SampleTableBox *stbl, u32 size, u32 nb_pack)
 		stbl->SampleSize->sampleCount += nb_pack;
 		return;
 	}
-	if (!stbl->SampleSize->sizes || (stbl->SampleSize->sampleCount==stbl->SampleSize->alloc_size)) {
-		Bool init_table = (stbl->SampleSize->sizes==NULL) ? 1 : 0;
-		ALLOC_INC(stbl->SampleSize->alloc_size);
-		if (stbl->SampleSize->sampleCount >= stbl->SampleSize->alloc_size)
-			stbl->SampleSize->alloc_size = stbl->SampleSize->sampleCount+1;
-
-		stbl->SampleSize->sizes = (u32 *)gf_realloc(stbl->SampleSize->sizes, sizeof(u32)*stbl->SampleSize->alloc_size);
+	if (!stbl->SampleSize->sizes) {
+		stbl->SampleSize->alloc_size = stbl->SampleSize->sampleCount+1;
+		stbl->SampleSize->sizes = (u32 *)gf_malloc(sizeof(u32)*stbl->SampleSize->alloc_size);
 		if (!stbl->SampleSize->sizes) return;
-		memset(&stbl->SampleSize->sizes[stbl->SampleSize->sampleCount], 0, sizeof(u32) * (stbl->SampleSize->alloc_size - stbl->SampleSize->sampleCount) );
-
-		if (init_table) {
-			for (i=0; i<stbl->SampleSize->sampleCount; i++)
-				stbl->SampleSize->sizes[i] = stbl->SampleSize->sampleSize;
-		}
+		for (i=0; i<stbl->SampleSize->sampleCount; i++)
+			stbl->SampleSize->sizes[i] = stbl->SampleSize->sampleSize;
 	}
 	stbl->SampleSize->sampleSize = 0;
-	stbl->SampleSize->sizes[stbl->SampleSize->sampleCount] = size;
-	stbl->SampleSize->sampleCount += nb_pack;
+	stsz_append_size(stbl->SampleSize, size);
+	//packed samples of different sizes are not supported, remaining samples have a 0 size
+	for (i=1; i<nb_pack; i++)
+		stsz_append_size(stbl->SampleSize, 0);
 }
 
 
@@ -1954,9 +1951,9 @@ GF_Err gf_isom_refresh_size_info(GF_ISOFile *file, u32 trackNumber)
 	stsz = trak->Media->information->sampleTable->SampleSize;
 	if (stsz->sampleSize || !stsz->sampleCount) return GF_OK;
 
-	size = stsz->sizes[0];
+	size = stsz_get_size(stsz, 0);
 	for (i=1; i<stsz->sampleCount; i++) {
-		if (stsz->sizes[i] != size) {
+		if (stsz_get_size(stsz, i) != size) {
 			size = 0;
 			break;
 		}
@@ -1965,6 +1962,7 @@ GF_Err gf_isom_refresh_size_info(GF_ISOFile *file, u32 trackNumber)
 		gf_free(stsz->sizes);
 		stsz->sizes = NULL;
 		stsz->sampleSize = size;
+		stsz_reset_packed(stsz);
 	}
 	return GF_OK;
 }
@@ -35,7 +35,10 @@ GF_TrackBox *GetTrackbyID(GF_MovieBox *moov, u32 TrackID)
 	if (!moov) return NULL;
 	i=0;
 	while ((trak = (GF_TrackBox *)gf_list_enum(moov->trackList, &i))) {
-		if (trak->Header->trackID == TrackID) return trak;
+		if (trak->Header->trackID == TrackID) {
+			if (trak->lazy_stbl) gf_isom_track_load_sample_tables(trak);
+			return trak;
+		}
 	}
 	return NULL;
 }
@@ -45,6 +48,7 @@ GF_TrackBox *gf_isom_get_track(GF_MovieBox *moov, u32 trackNumber)
 	GF_TrackBox *trak;
 	if (!moov || !trackNumber || (trackNumber > gf_list_count(moov->trackList))) return NULL;
 	trak = (GF_TrackBox*)gf_list_get(moov->trackList, trackNumber - 1);
+	if (trak && trak->lazy_stbl) gf_isom_track_load_sample_tables(trak);
 	return trak;
 
 }
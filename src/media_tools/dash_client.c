@@ -490,6 +490,18 @@ Bool gf_dash_check_mpd_root_type(const char *local_url)
 }
 
 
+/*availabilityTimeOffset of the BaseURLs used to resolve segment URLs, cumulative across levels*/
+static Double gf_dash_get_base_url_ato(GF_MPD *mpd, GF_MPD_Period *period, GF_MPD_AdaptationSet *set, GF_MPD_Representation *rep)
+{
+	Double ato = 0;
+	GF_MPD_BaseURL *url;
+	if ((url = gf_list_get(mpd->base_URLs, 0))) ato += url->availability_time_offset;
+	if ((url = gf_list_get(period->base_URLs, 0))) ato += url->availability_time_offset;
+	if ((url = gf_list_get(set->base_URLs, 0))) ato += url->availability_time_offset;
+	if ((url = gf_list_get(rep->base_URLs, 0))) ato += url->availability_time_offset;
+	return ato;
+}
+
 static void gf_dash_group_timeline_setup(GF_MPD *mpd, GF_DASH_Group *group, u64 fetch_time)
 {
 	GF_MPD_SegmentTimeline *timeline = NULL;
@@ -818,6 +830,7 @@ static void gf_dash_group_timeline_setup(GF_MPD *mpd, GF_DASH_Group *group, u64
 		if (rep->segment_template->start_number) start_number = rep->segment_template->start_number;
 		if (rep->segment_template->availability_time_offset) ast_offset = rep->segment_template->availability_time_offset;
 	}
+	ast_offset += gf_dash_get_base_url_ato(group->dash->mpd, group->period, group->adaptation_set, rep);
 
 	if (timeline) {
 		u64 start_segtime = 0;
@@ -843,44 +856,41 @@ static void gf_dash_group_timeline_setup(GF_MPD *mpd, GF_DASH_Group *group, u64
 			if (i+1 == count) timeline_duration -= ent->duration;
 		}
 
-		for (i=0; i<count; i++) {
-			u32 repeat;
-			GF_MPD_SegmentTimelineEntry *ent = gf_list_get(timeline->entries, i);
-			if (!segtime) {
-				start_segtime = segtime = ent->start_time;
-
-				//if current time is before the start of the previous segement, consider our timing is broken
-				if (current_time_rescale + ent->duration < segtime) {
-					GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] current time "LLU" is before start time "LLU" of first segment in timeline (timescale %d) by %g sec - using first segment as starting point\n", current_time_rescale, segtime, timescale, (segtime-current_time_rescale)*1.0/timescale));
-					group->download_segment_index = seg_idx;
-					group->nb_segments_in_rep = count;
-					group->start_playback_range = (segtime)*1.0/timescale;
-					group->ast_at_init = availabilityStartTime - (u32) (ast_offset*1000);
-					group->broken_timing = GF_TRUE;
-					return;
-				}
+		if (count) {
+			u32 ent_idx;
+			GF_MPD_SegmentTimelineEntry *ent = gf_list_get(timeline->entries, 0);
+			start_segtime = segtime = ent->start_time;
+
+			//if current time is before the start of the previous segement, consider our timing is broken
+			if (current_time_rescale + ent->duration < segtime) {
+				GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] current time "LLU" is before start time "LLU" of first segment in timeline (timescale %d) by %g sec - using first segment as starting point\n", current_time_rescale, segtime, timescale, (segtime-current_time_rescale)*1.0/timescale));
+				group->download_segment_index = seg_idx;
+				group->nb_segments_in_rep = count;
+				group->start_playback_range = (segtime)*1.0/timescale;
+				group->ast_at_init = availabilityStartTime - (u32) (ast_offset*1000);
+				group->broken_timing = GF_TRUE;
+				return;
 			}
 
-			repeat = 1+ent->repeat_count;
-			while (repeat) {
-				if ((current_time_rescale >= segtime) && (current_time_rescale < segtime + ent->duration)) {
-					GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Found segment %d for current time "LLU" is in SegmentTimeline ["LLU"-"LLU"] (timecale %d - current index %d - startNumber %d)\n", seg_idx, current_time_rescale, start_segtime, segtime + ent->duration, timescale, group->download_segment_index, start_number));
+			//get the segment containing the current time
+			seg_idx = gf_mpd_segment_timeline_find_time(timeline, current_time_rescale, &segtime);
+			if ((segtime > current_time_rescale) && seg_idx) seg_idx--;
+			ent = gf_mpd_segment_timeline_get_segment(timeline, seg_idx, &segtime, &ent_idx);
+			if (ent && (current_time_rescale >= segtime) && (current_time_rescale < segtime + ent->duration)) {
+				GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Found segment %d for current time "LLU" is in SegmentTimeline ["LLU"-"LLU"] (timecale %d - current index %d - startNumber %d)\n", seg_idx, current_time_rescale, start_segtime, segtime + ent->duration, timescale, group->download_segment_index, start_number));
 
-					group->download_segment_index = seg_idx;
-					group->nb_segments_in_rep = seg_idx + count - i;
-					group->start_playback_range = (current_time)/1000.0;
-					group->ast_at_init = availabilityStartTime - (u32) (ast_offset*1000);
+				group->download_segment_index = seg_idx;
+				group->nb_segments_in_rep = seg_idx + count - ent_idx;
+				group->start_playback_range = (current_time)/1000.0;
+				group->ast_at_init = availabilityStartTime - (u32) (ast_offset*1000);
 
-					//to remove - this is a hack to speedup starting for some strange MPDs which announce the live point as the first segment but have already produced the complete timeline
-					if (group->dash->utc_drift_estimate<0) {
-						group->ast_at_init -= (timeline_duration - (segtime-start_segtime)) *1000/timescale;
-					}
-					return;
+				//to remove - this is a hack to speedup starting for some strange MPDs which announce the live point as the first segment but have already produced the complete timeline
+				if (group->dash->utc_drift_estimate<0) {
+					group->ast_at_init -= (timeline_duration - (segtime-start_segtime)) *1000/timescale;
 				}
-				segtime += ent->duration;
-				repeat--;
-				seg_idx++;
+				return;
 			}
+			seg_idx = gf_mpd_segment_timeline_get_count(timeline, &segtime);
 		}
 		//check if we're ahead of time but "reasonnably" ahead (max 1 min) - otherwise consider the timing is broken
 		if ((current_time_rescale >= segtime) && (current_time_rescale <= segtime + 60*timescale)) {
@@ -1434,40 +1444,22 @@ static u64 gf_dash_get_segment_availability_start_time(GF_MPD *mpd, GF_DASH_Grou
 
 static u32 gf_dash_get_index_in_timeline(GF_MPD_SegmentTimeline *timeline, u64 segment_start, u64 start_timescale, u64 timescale)
 {
-	u64 start_time = 0;
-	u32 idx = 0;
-	u32 i, count, repeat;
-	count = gf_list_count(timeline->entries);
-	for (i=0; i<count; i++) {
-		GF_MPD_SegmentTimelineEntry *ent = gf_list_get(timeline->entries, i);
-
-		if (!i || ent->start_time) start_time = ent->start_time;
+	u64 start_time, target;
+	u32 idx, count;
 
-		repeat = ent->repeat_count+1;
-		while (repeat) {
-			if (start_timescale==timescale) {
-				if (start_time == segment_start ) return idx;
-				if (start_time > segment_start) {
-					GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Warning: segment timeline entry start "LLU" greater than segment start "LLU", using current entry\n", start_time, segment_start));
-					return idx;
-				}
-			} else {
-				if (start_time*start_timescale == segment_start * timescale) return idx;
-				if (start_time*start_timescale > segment_start * timescale) {
-					GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Warning: segment timeline entry start "LLU" greater than segment start "LLU", using current entry\n", start_time, segment_start));
-					return idx;
-				}
-			}
-			start_time+=ent->duration;
-			repeat--;
-			idx++;
-		}
-	}
-	//end of list in regular case: segment was the last one of the previous list and no changes happend
+	//segment_start is in start_timescale, timeline in timescale: look for the first segment starting at or after segment_start
 	if (start_timescale==timescale) {
-		if (start_time == segment_start ) return idx;
+		target = segment_start;
 	} else {
-		if (start_time*start_timescale == segment_start * timescale) return idx;
+		target = (segment_start * timescale + start_timescale - 1) / start_timescale;
+	}
+	count = gf_mpd_segment_timeline_get_count(timeline, NULL);
+	idx = gf_mpd_segment_timeline_find_time(timeline, target, &start_time);
+
+	if (start_time*start_timescale == segment_start * timescale) return idx;
+	if (idx < count) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Warning: segment timeline entry start "LLU" greater than segment start "LLU", using current entry\n", start_time, segment_start));
+		return idx;
 	}
 
 	GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error: could not find previous segment start in current timeline ! seeking to end of timeline\n"));
@@ -1479,7 +1471,6 @@ static GF_Err gf_dash_merge_segment_timeline(GF_DASH_Group *group, GF_DashClient
 {
 	GF_MPD_SegmentTimeline *old_timeline, *new_timeline;
 	u32 i, idx, timescale, nb_new_segs;
-	GF_MPD_SegmentTimelineEntry *ent;
 
 	old_timeline = new_timeline = NULL;
 	if (old_list && old_list->segment_timeline) {
@@ -1510,11 +1501,7 @@ static GF_Err gf_dash_merge_segment_timeline(GF_DASH_Group *group, GF_DashClient
 		}
 	}
 
-	nb_new_segs = 0;
-	idx=0;
-	while ((ent = gf_list_enum(new_timeline->entries, &idx))) {
-		nb_new_segs += 1 + ent->repeat_count;
-	}
+	nb_new_segs = gf_mpd_segment_timeline_get_count(new_timeline, NULL);
 
 	if (group) {
 		u32 prev_idx = group->download_segment_index;
@@ -1567,11 +1554,14 @@ static u32 gf_dash_purge_segment_timeline(GF_DASH_Group *group, Double min_start
 		if (!ent) break;
 		if (ent->start_time) start_time = ent->start_time;
 
-		while (start_time + ent->duration < min_start) {
-			if (! ent->repeat_count) break;
-			ent->repeat_count--;
-			nb_removed++;
-			start_time += ent->duration;
+		/*remove all segments of the entry ending before min_start, except the last one*/
+		if (ent->repeat_count && ent->duration && (start_time + ent->duration < min_start)) {
+			u64 nb_segs = (min_start - start_time - 1) / ent->duration;
+			if (nb_segs > ent->repeat_count) nb_segs = ent->repeat_count;
+			ent->repeat_count -= (u32) nb_segs;
+			nb_removed += (u32) nb_segs;
+			start_time += nb_segs * ent->duration;
+			gf_mpd_segment_timeline_reset_index(timeline);
 		}
 		/*this entry is in our range, keep it and make sure it has a start time*/
 		if (start_time + ent->duration >= min_start) {
@@ -1581,6 +1571,7 @@ static u32 gf_dash_purge_segment_timeline(GF_DASH_Group *group, Double min_start
 		start_time += ent->duration;
 		gf_list_rem(timeline->entries, 0);
 		gf_free(ent);
+		gf_mpd_segment_timeline_reset_index(timeline);
 		nb_removed++;
 	}
 	if (nb_removed) {
@@ -7853,6 +7844,30 @@ GF_Err gf_dash_group_get_next_segment_location(GF_DashClient *dash, u32 idx, u32
 	return GF_OK;
 }
 
+GF_EXPORT
+GF_Err gf_dash_group_get_next_segment_info(GF_DashClient *dash, u32 idx, u32 *duration_ms, u32 *representation_index)
+{
+	GF_DASH_Group *group;
+
+	gf_mx_p(dash->dash_mutex);
+	group = gf_list_get(dash->groups, idx);
+	if (!group) {
+		gf_mx_v(dash->dash_mutex);
+		return GF_BAD_PARAM;
+	}
+	gf_mx_p(group->cache_mutex);
+	if (!group->nb_cached_segments) {
+		gf_mx_v(group->cache_mutex);
+		gf_mx_v(dash->dash_mutex);
+		return GF_BUFFER_TOO_SMALL;
+	}
+	if (duration_ms) *duration_ms = group->cached[0].duration;
+	if (representation_index) *representation_index = group->cached[0].representation_index;
+	gf_mx_v(group->cache_mutex);
+	gf_mx_v(dash->dash_mutex);
+	return GF_OK;
+}
+
 GF_EXPORT
 GF_Err gf_dash_group_probe_current_download_segment_location(GF_DashClient *dash, u32 idx, const char **url, s32 *switching_index, const char **switching_url, const char **original_url, Bool *switched)
 {
@@ -122,6 +122,11 @@ struct __gf_dash_segmenter
 	const char *dash_profile_extension;
 
 	GF_Config *dash_ctx;
+	/*segment log of the context, see gf_dasher_seglog*/
+	FILE *seg_log;
+	/*name of the log next to the context file, or of the temporary log if any*/
+	char *seg_log_name;
+	Bool seg_log_is_temp;
 
 
 	Double subduration;
@@ -156,6 +161,12 @@ struct __gf_dash_segmenter
 
 	Bool mvex_after_traks;
 	u32 sdtp_in_traf;
+
+	/*name of the HLS master playlist to generate along with the MPD, NULL if none*/
+	char *hls_master_name;
+
+	/*MPEG-2 TS indexes shared by all representations and periods using the same file*/
+	GF_List *ts_indexes;
 };
 
 struct _dash_segment_input
@@ -241,8 +252,25 @@ struct _dash_segment_input
 	Bool no_cache;
 
 	Double clamp_duration;
+
+	/*HLS info gathered while segmenting, used to write the media playlist of the representation*/
+	GF_List *hls_segments;
+	char *hls_media_url;
+	char *hls_init_url;
+	u64 hls_init_size;
+	char hls_codecs[200];
+	u32 hls_bandwidth, hls_width, hls_height;
+	Bool hls_is_audio, hls_is_video;
 };
 
+typedef struct
+{
+	/*segment URL, NULL if the segment is a byte range in the media file of the representation*/
+	char *url;
+	u64 start_range, size;
+	Double duration;
+} GF_DashHLSSegment;
+
 
 
 #define EXTRACT_FORMAT(_nb_chars)	\
@@ -435,13 +463,274 @@ const char *gf_dasher_strip_output_dir(const char *mpd_url, const char *path)
 	return res;
 }
 
+/*the segments of a live context are stored in an append-only log next to the context file ("<context>.segs"), one line per
+segment "start-duration-timescale@representationID<TAB>fileName" in storage order. The context only keeps the offset of the
+first segment still in the time shift buffer (DASH:SegmentLogStart), so that each cycle appends its new segments to the
+log instead of rewriting all of them with the context. Contexts without file use a temporary log, copied back in their
+SegmentsStartTimes section when the dasher is destroyed so that the context can still be saved; such a section is moved
+to the log when the context is loaded*/
+typedef struct
+{
+	u64 start, dur, scale;
+	char rep_id[100];
+	const char *file_name;
+	/*offset of the next segment in the log*/
+	u64 next;
+	char line[GF_MAX_PATH+200];
+} GF_DashSegLogEntry;
+
+static FILE *gf_dasher_seglog_create(GF_DASHSegmenter *dasher, Bool reset)
+{
+	char *ctx_name = gf_cfg_get_filename(dasher->dash_ctx);
+	if (ctx_name) {
+		if (!dasher->seg_log_name) {
+			dasher->seg_log_name = (char *) gf_malloc(sizeof(char) * (strlen(ctx_name) + 6));
+			strcpy(dasher->seg_log_name, ctx_name);
+			strcat(dasher->seg_log_name, ".segs");
+		}
+		gf_free(ctx_name);
+		return gf_fopen(dasher->seg_log_name, reset ? "w+b" : "a+b");
+	}
+	dasher->seg_log_is_temp = GF_TRUE;
+	if (dasher->seg_log_name) {
+		gf_delete_file(dasher->seg_log_name);
+		gf_free(dasher->seg_log_name);
+		dasher->seg_log_name = NULL;
+	}
+	return gf_temp_file_new(&dasher->seg_log_name);
+}
+
+static void gf_dasher_seglog_close(GF_DASHSegmenter *dasher)
+{
+	if (dasher->seg_log) gf_fclose(dasher->seg_log);
+	dasher->seg_log = NULL;
+	if (dasher->seg_log_name) {
+		if (dasher->seg_log_is_temp) gf_delete_file(dasher->seg_log_name);
+		gf_free(dasher->seg_log_name);
+		dasher->seg_log_name = NULL;
+	}
+}
+
+static FILE *gf_dasher_seglog(GF_DASHSegmenter *dasher)
+{
+	u32 i, count;
+	if (dasher->seg_log || !dasher->dash_ctx) return dasher->seg_log;
+
+	/*no log start in the context, this is a new context: discard any previous log*/
+	dasher->seg_log = gf_dasher_seglog_create(dasher, gf_cfg_get_key(dasher->dash_ctx, "DASH", "SegmentLogStart") ? GF_FALSE : GF_TRUE);
+	if (!dasher->seg_log) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Cannot open segment log %s\n", dasher->seg_log_name ? dasher->seg_log_name : "(temporary file)"));
+		return NULL;
+	}
+	if (!gf_cfg_get_key(dasher->dash_ctx, "DASH", "SegmentLogStart"))
+		gf_cfg_set_key(dasher->dash_ctx, "DASH", "SegmentLogStart", "0");
+
+	count = gf_cfg_get_key_count(dasher->dash_ctx, "SegmentsStartTimes");
+	if (!count) return dasher->seg_log;
+	gf_fseek(dasher->seg_log, 0, SEEK_END);
+	for (i=0; i<count; i++) {
+		const char *fileName = gf_cfg_get_key_name(dasher->dash_ctx, "SegmentsStartTimes", i);
+		const char *MPDTime = gf_cfg_get_key(dasher->dash_ctx, "SegmentsStartTimes", fileName);
+		if (fileName && MPDTime) fprintf(dasher->seg_log, "%s\t%s\n", MPDTime, fileName);
+	}
+	gf_cfg_del_section(dasher->dash_ctx, "SegmentsStartTimes");
+	return dasher->seg_log;
+}
+
+static u64 gf_dasher_seglog_start(GF_DASHSegmenter *dasher)
+{
+	u64 start = 0;
+	const char *opt = gf_cfg_get_key(dasher->dash_ctx, "DASH", "SegmentLogStart");
+	if (opt) sscanf(opt, LLU, &start);
+	return start;
+}
+
+static void gf_dasher_seglog_set_start(GF_DASHSegmenter *dasher, u64 start)
+{
+	char szVal[50];
+	sprintf(szVal, LLU, start);
+	gf_cfg_set_key(dasher->dash_ctx, "DASH", "SegmentLogStart", szVal);
+}
+
+static Bool gf_dasher_seglog_seek(GF_DASHSegmenter *dasher, GF_DashSegLogEntry *entry, u64 offset)
+{
+	FILE *log = gf_dasher_seglog(dasher);
+	if (!log) return GF_FALSE;
+	entry->next = offset;
+	return gf_fseek(log, offset, SEEK_SET) ? GF_FALSE : GF_TRUE;
+}
+
+/*reads the segment following the previous one, or at the offset given to gf_dasher_seglog_seek. Returns GF_FALSE at the end of the log*/
+static Bool gf_dasher_seglog_next(GF_DASHSegmenter *dasher, GF_DashSegLogEntry *entry)
+{
+	char *sep;
+	u32 len;
+	if (!fgets(entry->line, sizeof(entry->line), dasher->seg_log)) return GF_FALSE;
+	len = (u32) strlen(entry->line);
+	//truncated line
+	if (!len || (entry->line[len-1] != '\n')) return GF_FALSE;
+	entry->line[len-1] = 0;
+	sep = strchr(entry->line, '\t');
+	if (!sep) return GF_FALSE;
+	sep[0] = 0;
+	if (sscanf(entry->line, ""LLU"-"LLU"-"LLU"@%99s", &entry->start, &entry->dur, &entry->scale, entry->rep_id) != 4) return GF_FALSE;
+	entry->file_name = sep+1;
+	entry->next += len;
+	return GF_TRUE;
+}
+
+/*drops the segments removed from the start of the log once they take more than half of it*/
+static void gf_dasher_seglog_compact(GF_DASHSegmenter *dasher)
+{
+	u64 start, size;
+	u32 live_size;
+	char *live = NULL;
+	FILE *log = gf_dasher_seglog(dasher);
+	if (!log) return;
+	start = gf_dasher_seglog_start(dasher);
+	gf_fseek(log, 0, SEEK_END);
+	size = gf_ftell(log);
+	if ((start < size - start) || (start < 4096)) return;
+
+	live_size = (u32) (size - start);
+	if (live_size) {
+		live = (char *) gf_malloc(sizeof(char) * live_size);
+		gf_fseek(log, start, SEEK_SET);
+		if (!live || (fread(live, 1, live_size, log) != live_size)) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[DASH] Failed to read segment log, not compacting it\n"));
+			if (live) gf_free(live);
+			return;
+		}
+	}
+	if (dasher->seg_log_is_temp) {
+		gf_dasher_seglog_close(dasher);
+	} else {
+		gf_fclose(dasher->seg_log);
+	}
+	dasher->seg_log = gf_dasher_seglog_create(dasher, GF_TRUE);
+	if (dasher->seg_log && live_size) gf_fwrite(live, 1, live_size, dasher->seg_log);
+	if (live) gf_free(live);
+	gf_dasher_seglog_set_start(dasher, 0);
+}
+
+/*removes all segments, for a new period*/
+static void gf_dasher_seglog_reset(GF_DASHSegmenter *dasher)
+{
+	if (!dasher->seg_log) {
+		/*not opened yet, the log will be discarded when opening it*/
+		gf_cfg_set_key(dasher->dash_ctx, "DASH", "SegmentLogStart", NULL);
+		return;
+	}
+	if (dasher->seg_log_is_temp) {
+		gf_dasher_seglog_close(dasher);
+	} else {
+		gf_fclose(dasher->seg_log);
+	}
+	dasher->seg_log = gf_dasher_seglog_create(dasher, GF_TRUE);
+	gf_dasher_seglog_set_start(dasher, 0);
+}
+
+/*resets the SegmentTimelines cached by gf_dash_load_segment_timeline*/
+static void gf_dasher_reset_timelines(GF_DASHSegmenter *dasher)
+{
+	u32 i;
+	for (i=0; i<gf_cfg_get_section_count(dasher->dash_ctx); i++) {
+		const char *secName = gf_cfg_get_section_name(dasher->dash_ctx, i);
+		if (strncmp(secName, "Representation_", 15)) continue;
+		gf_cfg_set_key(dasher->dash_ctx, secName, "TimelineOffset", NULL);
+	}
+}
+
+/*copies the segments of a temporary log in the context before closing it*/
+static void gf_dasher_seglog_del(GF_DASHSegmenter *dasher)
+{
+	if (dasher->seg_log && dasher->seg_log_is_temp) {
+		GF_DashSegLogEntry entry;
+		if (gf_dasher_seglog_seek(dasher, &entry, gf_dasher_seglog_start(dasher))) {
+			while (gf_dasher_seglog_next(dasher, &entry)) {
+				gf_cfg_set_key(dasher->dash_ctx, "SegmentsStartTimes", entry.file_name, entry.line);
+			}
+		}
+		gf_cfg_set_key(dasher->dash_ctx, "DASH", "SegmentLogStart", NULL);
+		/*timelines refer to the log*/
+		gf_dasher_reset_timelines(dasher);
+	}
+	gf_dasher_seglog_close(dasher);
+}
+
 GF_Err gf_dasher_store_segment_info(GF_DASHSegmenter *dasher, const char *representationID, const char *SegmentName, u64 segStartTime, u64 segEndTime, u64 scale)
 {
-	char szKey[512];
+	FILE *log;
 	if (!dasher->dash_ctx) return GF_OK;
 
-	sprintf(szKey, ""LLU"-"LLU"-"LLU"@%s", segStartTime, segEndTime-segStartTime, scale, representationID);
-	return gf_cfg_set_key(dasher->dash_ctx, "SegmentsStartTimes", SegmentName, szKey);
+	log = gf_dasher_seglog(dasher);
+	if (!log) return GF_IO_ERR;
+	gf_fseek(log, 0, SEEK_END);
+	if (fprintf(log, ""LLU"-"LLU"-"LLU"@%s\t%s\n", segStartTime, segEndTime-segStartTime, scale, representationID, SegmentName) < 0)
+		return GF_IO_ERR;
+	return GF_OK;
+}
+
+static void gf_dasher_hls_reset(GF_DashSegInput *dash_input)
+{
+	if (dash_input->hls_segments) {
+		while (gf_list_count(dash_input->hls_segments)) {
+			GF_DashHLSSegment *seg = (GF_DashHLSSegment *)gf_list_pop_back(dash_input->hls_segments);
+			if (seg->url) gf_free(seg->url);
+			gf_free(seg);
+		}
+		gf_list_del(dash_input->hls_segments);
+		dash_input->hls_segments = NULL;
+	}
+	if (dash_input->hls_media_url) gf_free(dash_input->hls_media_url);
+	dash_input->hls_media_url = NULL;
+	if (dash_input->hls_init_url) gf_free(dash_input->hls_init_url);
+	dash_input->hls_init_url = NULL;
+	dash_input->hls_init_size = 0;
+}
+
+/*sets the file holding the init segment of the representation. If init_size is 0, the whole file is the init segment*/
+static void gf_dasher_hls_set_init(GF_DASHSegmenter *dasher, GF_DashSegInput *dash_input, const char *init_file, u64 init_size)
+{
+	if (!dasher->hls_master_name) return;
+	if (dash_input->hls_init_url) gf_free(dash_input->hls_init_url);
+	dash_input->hls_init_url = gf_strdup(gf_dasher_strip_output_dir(dasher->mpd_name, init_file));
+	dash_input->hls_init_size = init_size;
+}
+
+/*adds a segment to the representation playlist. If size is not 0, the segment is the given byte range of the file*/
+static void gf_dasher_hls_add_segment(GF_DASHSegmenter *dasher, GF_DashSegInput *dash_input, const char *file, u64 start_range, u64 size, Double duration)
+{
+	GF_DashHLSSegment *seg;
+	const char *url;
+	if (!dasher->hls_master_name) return;
+
+	if (!dash_input->hls_segments) dash_input->hls_segments = gf_list_new();
+	GF_SAFEALLOC(seg, GF_DashHLSSegment);
+	if (!seg) return;
+	url = gf_dasher_strip_output_dir(dasher->mpd_name, file);
+	if (size) {
+		if (!dash_input->hls_media_url) dash_input->hls_media_url = gf_strdup(url);
+		if (strcmp(dash_input->hls_media_url, url)) seg->url = gf_strdup(url);
+		seg->start_range = start_range;
+		seg->size = size;
+	} else {
+		seg->url = gf_strdup(url);
+	}
+	seg->duration = duration;
+	gf_list_add(dash_input->hls_segments, seg);
+}
+
+static void gf_dasher_hls_set_info(GF_DASHSegmenter *dasher, GF_DashSegInput *dash_input, const char *codecs, u32 bandwidth, u32 width, u32 height, Bool is_video, Bool is_audio)
+{
+	if (!dasher->hls_master_name) return;
+	dash_input->hls_bandwidth = bandwidth;
+	strncpy(dash_input->hls_codecs, codecs, sizeof(dash_input->hls_codecs)-1);
+	dash_input->hls_codecs[sizeof(dash_input->hls_codecs)-1] = 0;
+	dash_input->hls_width = width;
+	dash_input->hls_height = height;
+	dash_input->hls_is_video = is_video;
+	dash_input->hls_is_audio = is_audio;
 }
 
 
@@ -929,29 +1218,128 @@ static void gf_dash_append_segment_timeline(GF_BitStream *mpd_timeline_bs, u64 s
 	*segment_timeline_repeat_count = 0;
 }
 
+typedef struct
+{
+	u64 dur;
+	u32 count;
+} GF_DashTimelineRun;
+
+/*the SegmentTimeline of each representation is cached in the context as a list of runs of segments with the same duration ("d:count,d:count..."),
+together with the start time of the first segment and the offset in the segment log up to which segments are processed. Only segments added since
+the last call are read, the cache is reset whenever old segments are removed from the log*/
 static void gf_dash_load_segment_timeline(GF_DASHSegmenter *dasher, GF_BitStream *mpd_timeline_bs, const char *representationID, u64 *previous_segment_duration , Bool *first_segment_in_timeline,u32 *segment_timeline_repeat_count)
 {
-	u32 i, count;
-	u64 scale;
-	char szRepID[100];
+	u32 i, nb_runs, alloc_runs;
+	u64 first_offset, timeline_start;
+	GF_DashSegLogEntry entry;
+	const char *opt;
+	char *timeline;
+	u32 timeline_len, timeline_alloc;
+	GF_DashTimelineRun *runs;
+	char szRepSecName[200], szLine[100];
 
 	*first_segment_in_timeline = GF_TRUE;
 	*segment_timeline_repeat_count = 0;
 	*previous_segment_duration = 0;
 
-	count = gf_cfg_get_key_count(dasher->dash_ctx, "SegmentsStartTimes");
-	for (i=0; i<count; i++) {
-		u64 start, dur;
-		const char *fileName = gf_cfg_get_key_name(dasher->dash_ctx, "SegmentsStartTimes", i);
-		const char *MPDTime = gf_cfg_get_key(dasher->dash_ctx, "SegmentsStartTimes", fileName);
-		if (!fileName)
+	sprintf(szRepSecName, "Representation_%s", representationID);
+
+	runs = NULL;
+	nb_runs = alloc_runs = 0;
+	first_offset = 0;
+	timeline_start = 0;
+
+	opt = gf_cfg_get_key(dasher->dash_ctx, szRepSecName, "TimelineOffset");
+	if (opt) sscanf(opt, LLU, &first_offset);
+	opt = NULL;
+	if (first_offset && (first_offset >= gf_dasher_seglog_start(dasher))) {
+		opt = gf_cfg_get_key(dasher->dash_ctx, szRepSecName, "TimelineStart");
+		if (opt) sscanf(opt, LLU, &timeline_start);
+		opt = gf_cfg_get_key(dasher->dash_ctx, szRepSecName, "Timeline");
+	}
+	if (!opt) first_offset = gf_dasher_seglog_start(dasher);
+
+	while (opt && opt[0]) {
+		u64 dur;
+		u32 nb_segs;
+		if (sscanf(opt, LLU":%u", &dur, &nb_segs) != 2) {
+			first_offset = gf_dasher_seglog_start(dasher);
+			nb_runs = 0;
 			break;
+		}
+		if (nb_runs == alloc_runs) {
+			alloc_runs = alloc_runs ? 2*alloc_runs : 10;
+			runs = (GF_DashTimelineRun *) gf_realloc(runs, sizeof(GF_DashTimelineRun) * alloc_runs);
+		}
+		runs[nb_runs].dur = dur;
+		runs[nb_runs].count = nb_segs;
+		nb_runs++;
+		opt = strchr(opt, ',');
+		if (opt) opt++;
+	}
+
+	if (gf_dasher_seglog_seek(dasher, &entry, first_offset)) {
+		while (gf_dasher_seglog_next(dasher, &entry)) {
+			if (strcmp(representationID, entry.rep_id)) continue;
+
+			if (nb_runs && (runs[nb_runs-1].dur == entry.dur)) {
+				runs[nb_runs-1].count++;
+				continue;
+			}
+			//segments with no duration before the first segment are ignored
+			if (!entry.dur && !nb_runs) continue;
+			if (!nb_runs) timeline_start = entry.start;
+			if (nb_runs == alloc_runs) {
+				alloc_runs = alloc_runs ? 2*alloc_runs : 10;
+				runs = (GF_DashTimelineRun *) gf_realloc(runs, sizeof(GF_DashTimelineRun) * alloc_runs);
+			}
+			runs[nb_runs].dur = entry.dur;
+			runs[nb_runs].count = 1;
+			nb_runs++;
+		}
+		first_offset = entry.next;
+	}
 
-		sscanf(MPDTime, ""LLU"-"LLU"-"LLU"@%s", &start, &dur, &scale, szRepID);
-		if (strcmp(representationID, szRepID)) continue;
+	timeline = NULL;
+	timeline_len = timeline_alloc = 0;
+	for (i=0; i<nb_runs; i++) {
+		u32 len;
+		if (i) {
+			if (runs[i-1].count>1) {
+				sprintf(szLine, " r=\"%d\"/>\n", runs[i-1].count - 1);
+			} else {
+				sprintf(szLine, "/>\n");
+			}
+			gf_bs_write_data(mpd_timeline_bs, szLine, (u32) strlen(szLine));
+			sprintf(szLine, "     <S d=\""LLU"\"", runs[i].dur);
+		} else {
+			sprintf(szLine, "     <S t=\""LLU"\" d=\""LLU"\"", timeline_start, runs[i].dur);
+		}
+		gf_bs_write_data(mpd_timeline_bs, szLine, (u32) strlen(szLine));
 
-		gf_dash_append_segment_timeline(mpd_timeline_bs, start, start+dur, previous_segment_duration, first_segment_in_timeline, segment_timeline_repeat_count);
+		sprintf(szLine, "%s"LLU":%u", i ? "," : "", runs[i].dur, runs[i].count);
+		len = (u32) strlen(szLine);
+		if (timeline_len + len + 1 > timeline_alloc) {
+			timeline_alloc = 2*timeline_alloc + len + 1;
+			timeline = (char *) gf_realloc(timeline, sizeof(char) * timeline_alloc);
+		}
+		strcpy(timeline + timeline_len, szLine);
+		timeline_len += len;
+	}
+	if (nb_runs) {
+		*first_segment_in_timeline = GF_FALSE;
+		*previous_segment_duration = runs[nb_runs-1].dur;
+		*segment_timeline_repeat_count = runs[nb_runs-1].count - 1;
 	}
+
+	sprintf(szLine, LLU, first_offset);
+	gf_cfg_set_key(dasher->dash_ctx, szRepSecName, "TimelineOffset", szLine);
+	sprintf(szLine, LLU, timeline_start);
+	gf_cfg_set_key(dasher->dash_ctx, szRepSecName, "TimelineStart", szLine);
+	gf_cfg_set_key(dasher->dash_ctx, szRepSecName, "Timeline", timeline ? timeline : "");
+
+	if (timeline) gf_free(timeline);
+	if (runs) gf_free(runs);
 }
 
 static u64 get_presentation_time(u64 media_time, s32 ts_shift)
@@ -1735,6 +2123,9 @@ static GF_Err isom_segment_file(GF_ISOFile *input, const char *output_file, GF_D
 		}
 	}
 
+	gf_dasher_hls_reset(dash_input);
+	gf_dasher_hls_set_init(dasher, dash_input, gf_isom_get_filename(bs_switch_segment ? bs_switch_segment : output), (seg_rad_name || bs_switch_segment) ? 0 : init_seg_size);
+
 	max_sap_type = 0;
 	if (dasher->force_session_end) {
 		if (dasher->dash_ctx) {
@@ -2670,7 +3061,9 @@ restart_fragmentation_pass:
 				}
 
 				GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] Closing segment %s at "LLU" us, at UTC "LLU" - segment AST "LLU" (MPD AST "LLU")\n", SegmentName, gf_sys_clock_high_res(), gf_net_get_utc(), generation_start_utc + period_duration + (u64)segment_start_time, generation_start_utc ));
+				GF_TRACE(GF_TRACE_BEGIN, GF_LOG_DASH, "segment_write", 0);
 				gf_isom_close_segment(output, dasher->enable_sidx ? dasher->subsegs_per_sidx : 0, dasher->enable_sidx ? ref_track_id : 0, ref_track_first_dts, tfref ? tfref->media_time_to_pres_time_shift : tf->media_time_to_pres_time_shift, ref_track_next_cts, dasher->daisy_chain_sidx, dasher->use_ssix, last_segment, GF_FALSE, dasher->segment_marker_4cc, &idx_start_range, &idx_end_range, NULL);
+				GF_TRACE(GF_TRACE_END, GF_LOG_DASH, "segment_write", 0);
 				nbFragmentInSegment = 0;
 
 				//take care of scalable reps
@@ -2684,6 +3077,7 @@ restart_fragmentation_pass:
 				if (!seg_rad_name) {
 					file_size = gf_isom_get_file_size(output);
 					end_range = file_size - 1;
+					gf_dasher_hls_add_segment(dasher, dash_input, gf_isom_get_filename(output), start_range, end_range + 1 - start_range, last_seg_dur / dasher->dash_scale);
 					if (dasher->single_file_mode!=1) {
 						sprintf(szMPDTempLine, "     <SegmentURL mediaRange=\""LLD"-"LLD"\"", start_range, end_range);
 						gf_bs_write_data(mpd_bs, szMPDTempLine, (u32) strlen(szMPDTempLine));
@@ -2702,6 +3096,7 @@ restart_fragmentation_pass:
 					}
 				} else {
 					file_size += gf_isom_get_file_size(output);
+					gf_dasher_hls_add_segment(dasher, dash_input, SegmentName, 0, 0, last_seg_dur / dasher->dash_scale);
 				}
 			}
 
@@ -2746,12 +3141,15 @@ restart_fragmentation_pass:
 		last_seg_dur = SegmentDuration;
 
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] Closing segment %s at "LLU" us, at UTC "LLU"\n", SegmentName, gf_sys_clock_high_res(), gf_net_get_utc()));
+		GF_TRACE(GF_TRACE_BEGIN, GF_LOG_DASH, "segment_write", 0);
 		gf_isom_close_segment(output, dasher->enable_sidx ? dasher->subsegs_per_sidx : 0, dasher->enable_sidx ? ref_track_id : 0, ref_track_first_dts, tfref ? tfref->media_time_to_pres_time_shift : tf->media_time_to_pres_time_shift, ref_track_next_cts, dasher->daisy_chain_sidx, dasher->use_ssix, GF_TRUE, GF_FALSE, dasher->segment_marker_4cc, &idx_start_range, &idx_end_range, NULL);
+		GF_TRACE(GF_TRACE_END, GF_LOG_DASH, "segment_write", 0);
 		nb_segments++;
 
 		if (!seg_rad_name) {
 			file_size = gf_isom_get_file_size(output);
 			end_range = file_size - 1;
+			gf_dasher_hls_add_segment(dasher, dash_input, gf_isom_get_filename(output), start_range, end_range + 1 - start_range, last_seg_dur / dasher->dash_scale);
 			if (dasher->single_file_mode!=1) {
 				sprintf(szMPDTempLine, "     <SegmentURL mediaRange=\""LLD"-"LLD"\"", start_range, end_range);
 				gf_bs_write_data(mpd_bs, szMPDTempLine, (u32) strlen(szMPDTempLine));
@@ -2770,6 +3168,7 @@ restart_fragmentation_pass:
 			}
 		} else {
 			file_size += gf_isom_get_file_size(output);
+			gf_dasher_hls_add_segment(dasher, dash_input, SegmentName, 0, 0, last_seg_dur / dasher->dash_scale);
 		}
 	}
 	//close timeline
@@ -2841,6 +3240,7 @@ write_rep_only:
 
     bandwidth += dash_input->dependency_bandwidth;
     dash_input->bandwidth = bandwidth;
+	gf_dasher_hls_set_info(dasher, dash_input, szCodecs, bandwidth, width, height, (nb_video || nb_auxv) ? GF_TRUE : GF_FALSE, nb_audio ? GF_TRUE : GF_FALSE);
 
 
 	/* max segment duration */
@@ -4161,6 +4561,17 @@ typedef struct
 
 } GF_TSSegmenter;
 
+/*result of the indexing of a TS file, kept until the segmenter is destroyed*/
+typedef struct
+{
+	char *file_name;
+	u64 mtime;
+	Double segment_duration;
+	Bool segment_at_rap;
+	/*indexer state after the pass, without demuxer and file*/
+	GF_TSSegmenter ts_seg;
+} GF_DashTSIndex;
+
 static void m2ts_sidx_add_entry(GF_SegmentIndexBox *sidx, Bool ref_type,
                                 u32 size, u32 duration, Bool first_is_SAP, u32 sap_type, u32 RAP_delta_time)
 {
@@ -4520,7 +4931,8 @@ static void dash_m2ts_event(GF_M2TS_Demuxer *ts, u32 evt_type, void *par)
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("Program number %d found - %d streams:\n", prog->number, count));
 		for (i=0; i<count; i++) {
 			GF_M2TS_ES *es = (GF_M2TS_ES*)gf_list_get(prog->streams, i);
-			gf_m2ts_set_pes_framing((GF_M2TS_PES *)es, GF_M2TS_PES_FRAMING_DEFAULT);
+			/*only the reference stream needs AU framing for RAP detection, other streams only need PES headers*/
+			gf_m2ts_set_pes_framing((GF_M2TS_PES *)es, (es->pid == prog->pcr_pid) ? GF_M2TS_PES_FRAMING_DEFAULT : GF_M2TS_PES_FRAMING_RAW);
 		}
 		break;
 	case GF_M2TS_EVT_PMT_UPDATE:
@@ -4666,6 +5078,99 @@ static void dasher_del_ts_demux(GF_TSSegmenter *ts_seg)
 	memset(ts_seg, 0, sizeof(GF_TSSegmenter));
 }
 
+#define NB_TSPCK_IO_BYTES 18800
+
+/*runs the indexer from the current position in the file until the end or until indexing is suspended*/
+static GF_Err dasher_mp2t_index(GF_TSSegmenter *ts_seg)
+{
+	while (!feof(ts_seg->src) && !ts_seg->suspend_indexing) {
+		char data[NB_TSPCK_IO_BYTES];
+		s32 size = (s32) fread(data, 1, NB_TSPCK_IO_BYTES, ts_seg->src);
+		if (size<0) return GF_IO_ERR;
+
+		gf_m2ts_process_data(ts_seg->ts, data, size);
+		if (size<NB_TSPCK_IO_BYTES) break;
+	}
+	if (feof(ts_seg->src)) ts_seg->suspend_indexing = 0;
+	return GF_OK;
+}
+
+static void dasher_del_ts_indexes(GF_List *ts_indexes)
+{
+	while (gf_list_count(ts_indexes)) {
+		GF_DashTSIndex *idx = (GF_DashTSIndex *)gf_list_pop_back(ts_indexes);
+		if (idx->ts_seg.sidx) gf_isom_box_del((GF_Box *)idx->ts_seg.sidx);
+		if (idx->ts_seg.pcrb) gf_isom_box_del((GF_Box *)idx->ts_seg.pcrb);
+		gf_free(idx->file_name);
+		gf_free(idx);
+	}
+	gf_list_del(ts_indexes);
+}
+
+/*gets the index of the input for the given segmentation parameters, indexing the file only if not already done.
+This is not used with DASH contexts or subdurations, where indexing resumes at the position reached by the previous call*/
+static GF_Err dasher_mp2t_get_index(GF_DASHSegmenter *dasher, GF_DashSegInput *dash_input, Double segment_duration, GF_DashTSIndex **out_index)
+{
+	u32 i, count;
+	u64 mtime;
+	GF_Err e;
+	GF_DashTSIndex *idx;
+
+	*out_index = NULL;
+	mtime = gf_file_modification_time(dash_input->file_name);
+	if (!dasher->ts_indexes) dasher->ts_indexes = gf_list_new();
+
+	count = gf_list_count(dasher->ts_indexes);
+	for (i=0; i<count; i++) {
+		idx = (GF_DashTSIndex *)gf_list_get(dasher->ts_indexes, i);
+		if ((idx->mtime == mtime) && (idx->segment_duration == segment_duration)
+		        && (idx->segment_at_rap == dasher->segments_start_with_rap) && !strcmp(idx->file_name, dash_input->file_name)) {
+			*out_index = idx;
+			return GF_OK;
+		}
+	}
+
+	GF_SAFEALLOC(idx, GF_DashTSIndex);
+	if (!idx) return GF_OUT_OF_MEM;
+
+	e = dasher_get_ts_demux(&idx->ts_seg, dash_input->file_name, 0);
+	if (e) {
+		gf_free(idx);
+		return e;
+	}
+	idx->ts_seg.segment_duration = segment_duration;
+	idx->ts_seg.segment_at_rap = dasher->segments_start_with_rap;
+	idx->ts_seg.PCR_DTS_initial_diff = (u64) -1;
+
+	e = dasher_mp2t_index(&idx->ts_seg);
+	if (!e) {
+		/* flush SIDX entry for the last packets */
+		m2ts_sidx_flush_entry(&idx->ts_seg);
+		m2ts_sidx_finalize_size(&idx->ts_seg, idx->ts_seg.file_size);
+		GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Indexing of %s done (1 sidx, %d entries).\n", dash_input->file_name, idx->ts_seg.sidx->nb_refs));
+	}
+	/*release demuxer and file, only keep the indexing results*/
+	gf_m2ts_demux_del(idx->ts_seg.ts);
+	gf_fclose(idx->ts_seg.src);
+	idx->ts_seg.ts = NULL;
+	idx->ts_seg.src = NULL;
+	idx->ts_seg.reference_stream = NULL;
+	if (e) {
+		if (idx->ts_seg.sidx) gf_isom_box_del((GF_Box *)idx->ts_seg.sidx);
+		if (idx->ts_seg.pcrb) gf_isom_box_del((GF_Box *)idx->ts_seg.pcrb);
+		gf_free(idx);
+		return e;
+	}
+
+	idx->file_name = gf_strdup(dash_input->file_name);
+	idx->mtime = mtime;
+	idx->segment_duration = segment_duration;
+	idx->segment_at_rap = dasher->segments_start_with_rap;
+	gf_list_add(dasher->ts_indexes, idx);
+	*out_index = idx;
+	return GF_OK;
+}
+
 static GF_Err dasher_mp2t_get_components_info(GF_DashSegInput *dash_input, GF_DASHSegmenter *dash_opts)
 {
 	char sOpt[40];
@@ -4674,6 +5179,14 @@ static GF_Err dasher_mp2t_get_components_info(GF_DashSegInput *dash_input, GF_DA
 	if (e) return e;
 
 	dash_input->duration = 0;
+	/*the duration is given by the index shared with the segmentation pass*/
+	if (!dash_opts->dash_ctx && !dash_opts->subduration) {
+		GF_DashTSIndex *idx;
+		e = dasher_mp2t_get_index(dash_opts, dash_input, dash_input->segment_duration ? dash_input->segment_duration : dash_opts->segment_duration, &idx);
+		if (e) return e;
+		dash_input->duration = (idx->ts_seg.last_PTS + idx->ts_seg.last_frame_duration - idx->ts_seg.first_PTS)/90000.0;
+		return GF_OK;
+	}
 	if (dash_opts->dash_ctx) {
 		const char *opt = gf_cfg_get_key(dash_opts->dash_ctx, "DASH", "LastFileName");
 		if (opt && !strcmp(opt, dash_input->file_name)) {
@@ -4697,11 +5210,10 @@ static GF_Err dasher_mp2t_get_components_info(GF_DashSegInput *dash_input, GF_DA
 	return GF_OK;
 }
 
-#define NB_TSPCK_IO_BYTES 18800
-
 static GF_Err dasher_mp2t_segment_file(GF_DashSegInput *dash_input, const char *szOutName, GF_DASHSegmenter *dasher, Bool first_in_set)
 {
 	GF_TSSegmenter ts_seg;
+	GF_DashTSIndex *ts_index;
 	Bool rewrite_input = GF_FALSE;
 	u8 is_pes[GF_M2TS_MAX_STREAMS];
 	char szOpt[100];
@@ -4722,9 +5234,17 @@ static GF_Err dasher_mp2t_segment_file(GF_DashSegInput *dash_input, const char *
 		GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[DASH] media duration cannot be forced with MPEG2-TS segmenter. Ignoring.\n"));
 	}
 
-	/*perform indexation of the file, this info will be destroyed at the end of the segment file routine*/
-	e = dasher_get_ts_demux(&ts_seg, dash_input->file_name, 0);
-	if (e) return e;
+	ts_index = NULL;
+	if (!dasher->dash_ctx && !dasher->subduration) {
+		/*use the index shared by all representations and periods using this file*/
+		e = dasher_mp2t_get_index(dasher, dash_input, dasher->segment_duration, &ts_index);
+		if (e) return e;
+		memcpy(&ts_seg, &ts_index->ts_seg, sizeof(GF_TSSegmenter));
+	} else {
+		/*perform indexation of the file, this info will be destroyed at the end of the segment file routine*/
+		e = dasher_get_ts_demux(&ts_seg, dash_input->file_name, 0);
+		if (e) return e;
+	}
 
 	ts_seg.segment_duration = dasher->segment_duration;
 	ts_seg.segment_at_rap = dasher->segments_start_with_rap;
@@ -4765,8 +5285,10 @@ static GF_Err dasher_mp2t_segment_file(GF_DashSegInput *dash_input, const char *
 
 	gf_media_mpd_format_segment_name(GF_DASH_TEMPLATE_REPINDEX, GF_TRUE, IdxName, basename, dash_input->representationID, dash_input->baseURL ? dash_input->baseURL[0] : NULL, dasher->seg_rad_name, "six", 0, 0, 0, dasher->use_segment_timeline);
 
-	ts_seg.PCR_DTS_initial_diff = (u64) -1;
-	ts_seg.subduration = (u32) (dasher->subduration * 90000);
+	if (!ts_index) {
+		ts_seg.PCR_DTS_initial_diff = (u64) -1;
+		ts_seg.subduration = (u32) (dasher->subduration * 90000);
+	}
 
 	szSectionName[0] = 0;
 	if (dasher->dash_ctx) {
@@ -4811,17 +5333,10 @@ static GF_Err dasher_mp2t_segment_file(GF_DashSegInput *dash_input, const char *
 	}
 
 	/*index the file*/
-	while (!feof(ts_seg.src) && !ts_seg.suspend_indexing) {
-		char data[NB_TSPCK_IO_BYTES];
-		s32 size = (s32) fread(data, 1, NB_TSPCK_IO_BYTES, ts_seg.src);
-		if (size<0) {
-			e = GF_IO_ERR;
-			goto exit;
-		}
-		gf_m2ts_process_data(ts_seg.ts, data, size);
-		if (size<NB_TSPCK_IO_BYTES) break;
+	if (!ts_index) {
+		e = dasher_mp2t_index(&ts_seg);
+		if (e) goto exit;
 	}
-	if (feof(ts_seg.src)) ts_seg.suspend_indexing = 0;
 
 	if (!presentationTimeOffset) {
 		presentationTimeOffset = 1 + ts_seg.first_PTS;
@@ -4836,10 +5351,12 @@ static GF_Err dasher_mp2t_segment_file(GF_DashSegInput *dash_input, const char *
 		next_pcr_shift = ts_seg.last_DTS + ts_seg.last_frame_duration - ts_seg.PCR_DTS_initial_diff;
 	}
 
-	/* flush SIDX entry for the last packets */
-	m2ts_sidx_flush_entry(&ts_seg);
-	m2ts_sidx_finalize_size(&ts_seg, ts_seg.file_size);
-	GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Indexing done (1 sidx, %d entries).\n", ts_seg.sidx->nb_refs));
+	if (!ts_index) {
+		/* flush SIDX entry for the last packets */
+		m2ts_sidx_flush_entry(&ts_seg);
+		m2ts_sidx_finalize_size(&ts_seg, ts_seg.file_size);
+		GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Indexing done (1 sidx, %d entries).\n", ts_seg.sidx->nb_refs));
+	}
 
 	gf_media_mpd_format_segment_name(GF_DASH_TEMPLATE_REPINDEX, GF_TRUE, IdxName, basename, dash_input->representationID, dash_input->baseURL ? dash_input->baseURL[0] : NULL, dasher->seg_rad_name ? dasher->seg_rad_name : szOutName, "six", 0, 0, 0, dasher->use_segment_timeline);
 
@@ -4916,6 +5433,23 @@ static GF_Err dasher_mp2t_segment_file(GF_DashSegInput *dash_input, const char *
 	if (strlen(szCodecs))
 		fprintf(dasher->mpd, " codecs=\"%s\"", szCodecs);
 
+	if (dasher->hls_master_name) {
+		u32 w=0, h=0;
+		Bool has_video=GF_FALSE, has_audio=GF_FALSE;
+		for (i=0; i<dash_input->nb_components; i++) {
+			if (dash_input->components[i].media_type == GF_ISOM_MEDIA_VISUAL) {
+				has_video = GF_TRUE;
+				if (!w) {
+					w = dash_input->components[i].width;
+					h = dash_input->components[i].height;
+				}
+			}
+			else if (dash_input->components[i].media_type == GF_ISOM_MEDIA_AUDIO) has_audio = GF_TRUE;
+		}
+		gf_dasher_hls_reset(dash_input);
+		gf_dasher_hls_set_info(dasher, dash_input, szCodecs, bandwidth, w, h, has_video, has_audio);
+	}
+
 	fprintf(dasher->mpd, " startWithSAP=\"%d\"", dasher->segments_start_with_rap ? 1 : 0);
 	fprintf(dasher->mpd, " bandwidth=\"%d\"", bandwidth);
 	fprintf(dasher->mpd, ">\n");
@@ -5043,6 +5577,7 @@ static GF_Err dasher_mp2t_segment_file(GF_DashSegInput *dash_input, const char *
 					dur /= 90000;
 
 					gf_dasher_store_segment_info(dasher, dash_input->representationID, SegName, (u64) (current_time*dasher->dash_scale), (u64) ((current_time+dur)*dasher->dash_scale), dasher->dash_scale);
+					gf_dasher_hls_add_segment(dasher, dash_input, SegName, 0, 0, dur);
 
 					current_time += dur;
 
@@ -5122,6 +5657,13 @@ static GF_Err dasher_mp2t_segment_file(GF_DashSegInput *dash_input, const char *
 		}
 		gf_fclose(in);
 		gf_fclose(out);
+
+		start = ts_seg.sidx->first_offset;
+		for (i=0; i<ts_seg.sidx->nb_refs; i++) {
+			GF_SIDXReference *ref = &ts_seg.sidx->refs[i];
+			gf_dasher_hls_add_segment(dasher, dash_input, SegName, start, ref->reference_size, (Double) ref->subsegment_duration / 90000);
+			start += ref->reference_size;
+		}
 	}
 
 	fprintf(dasher->mpd, "   </Representation>\n");
@@ -5159,6 +5701,11 @@ static GF_Err dasher_mp2t_segment_file(GF_DashSegInput *dash_input, const char *
 	}
 
 exit:
+	/*shared index boxes are destroyed with the segmenter*/
+	if (ts_index) {
+		ts_seg.sidx = NULL;
+		ts_seg.pcrb = NULL;
+	}
 	if (ts_seg.sidx) gf_isom_box_del((GF_Box *)ts_seg.sidx);
 	if (ts_seg.pcrb) gf_isom_box_del((GF_Box *)ts_seg.pcrb);
 	if (ts_seg.index_bs) gf_bs_del(ts_seg.index_bs);
@@ -6052,7 +6599,7 @@ static Bool gf_dasher_cleanup(GF_DASHSegmenter *dasher)
 	Double elapsed = 0;
 	Double dash_duration = 1000*dasher->segment_duration / dasher->dash_scale;
 	Double safety_dur = MAX(dasher->mpd_update_time, dash_duration);
-	u32 i, ntp_sec, frac, prev_sec, prev_frac;
+	u32 i, ntp_sec, frac, prev_sec, prev_frac, nb_removed=0;
 	const char *opt, *section;
 	GF_Err e;
 
@@ -6102,64 +6649,68 @@ static Bool gf_dasher_cleanup(GF_DASHSegmenter *dasher)
 		}
 	}
 
-	/*cleanup old segments*/
+	/*cleanup old segments, in storage order: a segment stored after one still in the time shift buffer is removed
+	with it, at most one cycle later*/
 	if (dasher->time_shift_depth >= 0) {
-		for (i=0; i<gf_cfg_get_key_count(dasher->dash_ctx, "SegmentsStartTimes"); i++) {
-			Double seg_time;
-			u64 start, dur, scale;
-			char szRepID[100];
-			char szSecName[200];
-			u32 j;
-			const char *fileName = gf_cfg_get_key_name(dasher->dash_ctx, "SegmentsStartTimes", i);
-			const char *opt = gf_cfg_get_key(dasher->dash_ctx, "SegmentsStartTimes", fileName);
-			if (!fileName)
-				break;
+		GF_DashSegLogEntry entry;
+		u64 log_start = gf_dasher_seglog_start(dasher);
+		if (gf_dasher_seglog_seek(dasher, &entry, log_start)) {
+			while (gf_dasher_seglog_next(dasher, &entry)) {
+				Double seg_time;
+				char szSecName[200], szVal[20];
+				u32 j;
 
-			sscanf(opt, ""LLU"-"LLU"-"LLU"@%s", &start, &dur, &scale, szRepID);
-			seg_time = (Double) start;
-			seg_time /= scale;
+				seg_time = (Double) entry.start;
+				seg_time /= entry.scale;
 
-			if (dasher->ast_offset_ms > 0)
-				seg_time += ((Double) dasher->ast_offset_ms) / 1000;
+				if (dasher->ast_offset_ms > 0)
+					seg_time += ((Double) dasher->ast_offset_ms) / 1000;
 
 
-			seg_time += 2 * dash_duration + dasher->time_shift_depth;
-			seg_time -= elapsed;
-			if (seg_time >= 0)
-				continue;
+				seg_time += 2 * dash_duration + dasher->time_shift_depth;
+				seg_time -= elapsed;
+				if (seg_time >= 0)
+					break;
 
-			if (! (dasher->dash_mode == GF_DASH_DYNAMIC_DEBUG) ) {
-				GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Removing segment %s - %g sec too late\n", fileName, -seg_time - dash_duration));
-			}
+				if (! (dasher->dash_mode == GF_DASH_DYNAMIC_DEBUG) ) {
+					GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Removing segment %s - %g sec too late\n", entry.file_name, -seg_time - dash_duration));
+				}
 
-			e = gf_delete_file(fileName);
-			if (e) {
-				GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[DASH] Could not remove file %s: %s\n", fileName, gf_error_to_string(e) ));
-				break;
-			}
+				e = gf_delete_file(entry.file_name);
+				if (e) {
+					GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[DASH] Could not remove file %s: %s\n", entry.file_name, gf_error_to_string(e) ));
+					break;
+				}
 
-			sprintf(szSecName, "URLs_%s", szRepID);
+				sprintf(szSecName, "URLs_%s", entry.rep_id);
 
-			/*remove URLs*/
-			for (j=0; j<gf_cfg_get_key_count(dasher->dash_ctx, szSecName); j++) {
-				const char *entry = gf_cfg_get_key_name(dasher->dash_ctx, szSecName, j);
-				const char *name = gf_cfg_get_key(dasher->dash_ctx, szSecName, entry);
-				if (strstr(name, fileName)) {
-					gf_cfg_set_key(dasher->dash_ctx, szSecName, entry, NULL);
-					break;
+				/*remove URLs*/
+				for (j=0; j<gf_cfg_get_key_count(dasher->dash_ctx, szSecName); j++) {
+					const char *url_entry = gf_cfg_get_key_name(dasher->dash_ctx, szSecName, j);
+					const char *name = gf_cfg_get_key(dasher->dash_ctx, szSecName, url_entry);
+					if (strstr(name, entry.file_name)) {
+						gf_cfg_set_key(dasher->dash_ctx, szSecName, url_entry, NULL);
+						break;
+					}
 				}
-			}
 
-			/*adjust seg removed count - this is needed to adjust startNumber for SegmentTimeline case*/
-			sprintf(szSecName, "Representation_%s", szRepID);
-			j = 1;
-			opt = gf_cfg_get_key(dasher->dash_ctx, szSecName, "NbSegmentsRemoved");
-			if (opt) j += atoi(opt);
-			sprintf(szRepID, "%d", j);
-			gf_cfg_set_key(dasher->dash_ctx, szSecName, "NbSegmentsRemoved", szRepID);
+				/*adjust seg removed count - this is needed to adjust startNumber for SegmentTimeline case*/
+				sprintf(szSecName, "Representation_%s", entry.rep_id);
+				j = 1;
+				opt = gf_cfg_get_key(dasher->dash_ctx, szSecName, "NbSegmentsRemoved");
+				if (opt) j += atoi(opt);
+				sprintf(szVal, "%d", j);
+				gf_cfg_set_key(dasher->dash_ctx, szSecName, "NbSegmentsRemoved", szVal);
 
-			gf_cfg_set_key(dasher->dash_ctx, "SegmentsStartTimes", fileName, NULL);
-			i--;
+				log_start = entry.next;
+				nb_removed++;
+			}
+		}
+		/*segments have been removed, reset the timelines cached by gf_dash_load_segment_timeline*/
+		if (nb_removed) {
+			gf_dasher_seglog_set_start(dasher, log_start);
+			gf_dasher_reset_timelines(dasher);
+			gf_dasher_seglog_compact(dasher);
 		}
 	}
 	return GF_TRUE;
@@ -6210,9 +6761,10 @@ static GF_Err dash_insert_period_xml(FILE *mpd, char *szPeriodXML)
 	return GF_OK;
 }
 
-static void purge_dash_context(GF_Config *dash_ctx)
+static void purge_dash_context(GF_DASHSegmenter *dasher)
 {
 	u32 i, count;
+	GF_Config *dash_ctx = dasher->dash_ctx;
 	//purge dash context
 	count = gf_cfg_get_section_count(dash_ctx);
 	for (i=0; i<count; i++) {
@@ -6228,6 +6780,7 @@ static void purge_dash_context(GF_Config *dash_ctx)
 			i--;
 		}
 	}
+	gf_dasher_seglog_reset(dasher);
 }
 
 typedef struct
@@ -6288,6 +6841,7 @@ void gf_dasher_clean_inputs(GF_DASHSegmenter *dasher)
 		}
 		if (dasher->inputs[i].dependencyID) gf_free(dasher->inputs[i].dependencyID);
 		if (dasher->inputs[i].init_seg_url) gf_free(dasher->inputs[i].init_seg_url);
+		gf_dasher_hls_reset(&dasher->inputs[i]);
 		if (dasher->inputs[i].period_id_not_specified && dasher->inputs[i].periodID) gf_free(dasher->inputs[i].periodID);
 
 		if (dasher->inputs[i].isobmf_input) {
@@ -6313,6 +6867,11 @@ void gf_dasher_del(GF_DASHSegmenter *dasher)
 	gf_free(dasher->moreInfoURL);
 	gf_free(dasher->source);
 	gf_free(dasher->location);
+	if (dasher->hls_master_name) gf_free(dasher->hls_master_name);
+#ifndef GPAC_DISABLE_MPEG2TS
+	if (dasher->ts_indexes) dasher_del_ts_indexes(dasher->ts_indexes);
+#endif
+	gf_dasher_seglog_del(dasher);
 	gf_free(dasher);
 }
 
@@ -6584,6 +7143,203 @@ GF_Err gf_dasher_set_isobmff_options(GF_DASHSegmenter *dasher, Bool mvex_after_t
 	return GF_OK;
 }
 
+GF_EXPORT
+GF_Err gf_dasher_set_hls_output(GF_DASHSegmenter *dasher, const char *master_playlist)
+{
+	if (!dasher) return GF_BAD_PARAM;
+	if (dasher->hls_master_name) gf_free(dasher->hls_master_name);
+	dasher->hls_master_name = master_playlist ? gf_strdup(gf_url_get_resource_name(master_playlist)) : NULL;
+	return GF_OK;
+}
+
+static Bool gf_dasher_hls_use_input(GF_DashSegInput *dash_input, u32 period)
+{
+	if (!dash_input->hls_segments || !gf_list_count(dash_input->hls_segments)) return GF_FALSE;
+	if (dash_input->period != period) return GF_FALSE;
+	/*scalable layers are not signaled in HLS*/
+	if (dash_input->dependencyID || dash_input->idx_representations) return GF_FALSE;
+	return (dash_input->hls_is_video || dash_input->hls_is_audio) ? GF_TRUE : GF_FALSE;
+}
+
+static void gf_dasher_hls_playlist_name(GF_DASHSegmenter *dasher, GF_DashSegInput *dash_input, u32 idx, char *szName)
+{
+	char *sep;
+	strcpy(szName, dasher->hls_master_name);
+	sep = strrchr(szName, '.');
+	if (sep) sep[0] = 0;
+	if (strlen(dash_input->representationID)) {
+		strcat(szName, "_");
+		strcat(szName, dash_input->representationID);
+	} else {
+		sprintf(szName + strlen(szName), "_rep%d", idx+1);
+	}
+	strcat(szName, ".m3u8");
+}
+
+/*fMP4 segments need EXT-X-MAP (version 7 for fMP4), byte ranges need version 4*/
+static u32 gf_dasher_hls_get_version(GF_DashSegInput *dash_input)
+{
+	u32 i, count;
+	if (dash_input->hls_init_url) return 7;
+	count = gf_list_count(dash_input->hls_segments);
+	for (i=0; i<count; i++) {
+		GF_DashHLSSegment *seg = (GF_DashHLSSegment *)gf_list_get(dash_input->hls_segments, i);
+		if (seg->size) return 4;
+	}
+	return 3;
+}
+
+/*writes the media playlist of a representation from the segment info gathered during segmentation*/
+static GF_Err gf_dasher_hls_write_media_playlist(GF_DASHSegmenter *dasher, GF_DashSegInput *dash_input, const char *szPath)
+{
+	u32 i, count, target_dur;
+	FILE *pl;
+
+	pl = gf_fopen(szPath, "wt");
+	if (!pl) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Cannot create HLS playlist %s\n", szPath));
+		return GF_IO_ERR;
+	}
+	target_dur = 0;
+	count = gf_list_count(dash_input->hls_segments);
+	for (i=0; i<count; i++) {
+		GF_DashHLSSegment *seg = (GF_DashHLSSegment *)gf_list_get(dash_input->hls_segments, i);
+		u32 dur = (u32) (seg->duration + 0.5);
+		if (dur > target_dur) target_dur = dur;
+	}
+	if (!target_dur) target_dur = 1;
+
+	fprintf(pl, "#EXTM3U\n");
+	fprintf(pl, "#EXT-X-VERSION:%d\n", gf_dasher_hls_get_version(dash_input));
+	fprintf(pl, "#EXT-X-TARGETDURATION:%d\n", target_dur);
+	fprintf(pl, "#EXT-X-MEDIA-SEQUENCE:0\n");
+	fprintf(pl, "#EXT-X-PLAYLIST-TYPE:VOD\n");
+	if (dash_input->hls_init_url) {
+		fprintf(pl, "#EXT-X-MAP:URI=\"%s\"", dash_input->hls_init_url);
+		if (dash_input->hls_init_size)
+			fprintf(pl, ",BYTERANGE=\""LLU"@0\"", dash_input->hls_init_size);
+		fprintf(pl, "\n");
+	}
+	for (i=0; i<count; i++) {
+		GF_DashHLSSegment *seg = (GF_DashHLSSegment *)gf_list_get(dash_input->hls_segments, i);
+		fprintf(pl, "#EXTINF:%.03f,\n", seg->duration);
+		if (seg->size)
+			fprintf(pl, "#EXT-X-BYTERANGE:"LLU"@"LLU"\n", seg->size, seg->start_range);
+		fprintf(pl, "%s\n", seg->url ? seg->url : dash_input->hls_media_url);
+	}
+	fprintf(pl, "#EXT-X-ENDLIST\n");
+	gf_fclose(pl);
+	return GF_OK;
+}
+
+static GF_Err gf_dasher_write_hls_playlists(GF_DASHSegmenter *dasher)
+{
+	u32 i, period, version, nb_video, max_audio_bw;
+	char szDir[GF_MAX_PATH], szName[GF_MAX_PATH], szPath[GF_MAX_PATH];
+	const char *audio_codecs = NULL;
+	Bool first_audio = GF_TRUE;
+	FILE *master;
+
+	if ((dasher->dash_mode != GF_DASH_STATIC) || dasher->dash_ctx) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[DASH] HLS playlists are only generated for static sessions, ignoring\n"));
+		gf_free(dasher->hls_master_name);
+		dasher->hls_master_name = NULL;
+		return GF_OK;
+	}
+
+	szDir[0] = 0;
+	gf_url_get_resource_path(dasher->mpd_name, szDir);
+
+	/*HLS has no periods, only the first one is exported*/
+	period = 0;
+	for (i=0; i<dasher->nb_inputs; i++) {
+		if (dasher->inputs[i].hls_segments && dasher->inputs[i].period) {
+			if (!period) period = dasher->inputs[i].period;
+			else if (dasher->inputs[i].period != period) {
+				GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[DASH] Multiple periods not supported in HLS output, only first period is described\n"));
+				break;
+			}
+		}
+	}
+
+	/*audio-only representations are used as an alternate audio group if the content has video-only representations*/
+	nb_video = 0;
+	max_audio_bw = 0;
+	version = 3;
+	for (i=0; i<dasher->nb_inputs; i++) {
+		u32 v;
+		GF_DashSegInput *dash_input = &dasher->inputs[i];
+		if (!gf_dasher_hls_use_input(dash_input, period)) continue;
+		v = gf_dasher_hls_get_version(dash_input);
+		if (v > version) version = v;
+		if (dash_input->hls_is_video && !dash_input->hls_is_audio) nb_video++;
+		else if (!dash_input->hls_is_video) {
+			if (!audio_codecs) audio_codecs = dash_input->hls_codecs;
+			if (max_audio_bw < dash_input->hls_bandwidth) max_audio_bw = dash_input->hls_bandwidth;
+		}
+	}
+	if (!nb_video) audio_codecs = NULL;
+
+	sprintf(szPath, "%s%s", szDir, dasher->hls_master_name);
+	master = gf_fopen(szPath, "wt");
+	if (!master) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Cannot create HLS master playlist %s\n", szPath));
+		return GF_IO_ERR;
+	}
+
+	fprintf(master, "#EXTM3U\n");
+	fprintf(master, "#EXT-X-VERSION:%d\n", version);
+	if (dasher->segments_start_with_rap)
+		fprintf(master, "#EXT-X-INDEPENDENT-SEGMENTS\n");
+
+	for (i=0; i<dasher->nb_inputs; i++) {
+		GF_Err e;
+		GF_DashSegInput *dash_input = &dasher->inputs[i];
+		if (!gf_dasher_hls_use_input(dash_input, period)) continue;
+
+		gf_dasher_hls_playlist_name(dasher, dash_input, i, szName);
+		sprintf(szPath, "%s%s", szDir, szName);
+		e = gf_dasher_hls_write_media_playlist(dasher, dash_input, szPath);
+		if (e) {
+			gf_fclose(master);
+			return e;
+		}
+
+		if (audio_codecs && !dash_input->hls_is_video) {
+			const char *lang = dash_input->nb_components ? dash_input->components[0].lang : NULL;
+			fprintf(master, "#EXT-X-MEDIA:TYPE=AUDIO,GROUP-ID=\"audio\",NAME=\"%s\"", strlen(dash_input->representationID) ? dash_input->representationID : szName);
+			if (lang && strcmp(lang, "und"))
+				fprintf(master, ",LANGUAGE=\"%s\"", lang);
+			fprintf(master, ",AUTOSELECT=YES,DEFAULT=%s,URI=\"%s\"\n", first_audio ? "YES" : "NO", szName);
+			first_audio = GF_FALSE;
+		}
+	}
+
+	/*variant streams, after the renditions they refer to*/
+	for (i=0; i<dasher->nb_inputs; i++) {
+		GF_DashSegInput *dash_input = &dasher->inputs[i];
+		if (!gf_dasher_hls_use_input(dash_input, period)) continue;
+		if (audio_codecs && !dash_input->hls_is_video) continue;
+
+		gf_dasher_hls_playlist_name(dasher, dash_input, i, szName);
+		fprintf(master, "#EXT-X-STREAM-INF:BANDWIDTH=%d", dash_input->hls_bandwidth + ((audio_codecs && !dash_input->hls_is_audio) ? max_audio_bw : 0));
+		if (strlen(dash_input->hls_codecs)) {
+			fprintf(master, ",CODECS=\"%s", dash_input->hls_codecs);
+			if (audio_codecs && !dash_input->hls_is_audio && strlen(audio_codecs))
+				fprintf(master, ",%s", audio_codecs);
+			fprintf(master, "\"");
+		}
+		if (dash_input->hls_width && dash_input->hls_height)
+			fprintf(master, ",RESOLUTION=%dx%d", dash_input->hls_width, dash_input->hls_height);
+		if (audio_codecs && !dash_input->hls_is_audio)
+			fprintf(master, ",AUDIO=\"audio\"");
+		fprintf(master, "\n%s\n", szName);
+	}
+	gf_fclose(master);
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] HLS playlists done\n"));
+	return GF_OK;
+}
+
 static void dash_input_check_period_id(GF_DASHSegmenter *dasher, GF_DashSegInput *dash_input)
 {
 	if (dash_input->period_id_not_specified) {
@@ -7231,7 +7987,7 @@ GF_Err gf_dasher_process(GF_DASHSegmenter *dasher, Double sub_duration)
 				sprintf(szOpt, "%g", active_period_start);
 				gf_cfg_set_key(dasher->dash_ctx, "DASH", "LastActivePeriodStart", szOpt);
 
-				purge_dash_context(dasher->dash_ctx);
+				purge_dash_context(dasher);
 			}
 
 			//and finally switch active period
@@ -7718,7 +8474,7 @@ GF_Err gf_dasher_process(GF_DASHSegmenter *dasher, Double sub_duration)
 			sprintf(szOpt, "%g", period_duration);
 			gf_cfg_set_key(dasher->dash_ctx, "DASH", "LastPeriodDuration", szOpt);
 
-			if (dasher->dash_ctx) purge_dash_context(dasher->dash_ctx);
+			if (dasher->dash_ctx) purge_dash_context(dasher);
 		}
 	}
 
@@ -7770,6 +8526,11 @@ GF_Err gf_dasher_process(GF_DASHSegmenter *dasher, Double sub_duration)
 
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] DASH MPD done\n"));
 
+	if (dasher->hls_master_name) {
+		e = gf_dasher_write_hls_playlists(dasher);
+		if (e) goto exit;
+	}
+
 
 	if (dasher->dash_ctx && dasher->dash_mode) {
 		const char *opt = gf_cfg_get_key(dasher->dash_ctx, "DASH", "LastPeriodDuration");
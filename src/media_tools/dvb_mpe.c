@@ -134,6 +134,8 @@ void gf_dvb_mpe_section_del(GF_M2TS_ES *es)
 		if (ses->mff->mpe_holes)
 			gf_list_del(ses->mff->mpe_holes);
 		ses->mff->mpe_holes = NULL;
+		if (ses->mff->rs)
+			gf_rs_del(ses->mff->rs);
 		gf_free(ses->mff);
 		ses->mff=NULL;
 	}
@@ -750,85 +752,52 @@ void gf_m2ts_target_ip(GF_M2TS_IP_Stream* ip_str, u8 * data)
 /*generate RS code and fullfill the RS table of MPE_FEC_FRAME*/
 void encode_fec(MPE_FEC_FRAME * mff)
 {
-#if 0
 	u8 adt_rs_en_buffer [ MPE_ADT_COLS + MPE_RS_COLS ];
-	u32 rows = mff->rows;
-	u32 i = 0;
-	u32 cols = 0;
+	u32 i;
+
+	if (!mff->rs) mff->rs = gf_rs_new(MPE_RS_COLS);
+	if (!mff->rs) return;
 
-	cols = mff->col_adt;
-	for ( i = 0; i < rows; i ++ ) {
+	for ( i = 0; i < mff->rows; i ++ ) {
 		/* read a row from ADT into buffer */
 		getRowFromADT(mff, i, adt_rs_en_buffer);
-		/* ************** */
-		/* Encode data into codeword, adding NPAR parity bytes */
-		encode_data(adt_rs_en_buffer, cols, adt_rs_en_buffer);
-		fprintf(stderr, "Encoded data is   : \"%s\"\n", adt_rs_en_buffer);
-		fprintf(stderr, "data with error is: \"%s\"\n", adt_rs_en_buffer);
+		/* compute the NPAR parity bytes of the row */
+		gf_rs_encode(mff->rs, adt_rs_en_buffer, mff->col_adt, adt_rs_en_buffer + mff->col_adt);
 		/*set a row of RS into RS table*/
-		setRowRS ( mff, i , (unsigned char *)(adt_rs_en_buffer + cols) );
+		setRowRS ( mff, i , adt_rs_en_buffer + mff->col_adt );
 	}
-#endif
 }
 
 /*decode the MPE_FEC_FRAME*/
 void decode_fec(MPE_FEC_FRAME * mff)
 {
-	u32 i,ML,offset;
-	u8 *data;
-	u8 linebuffer[255];
-
-	//fprintf(stderr, "Starting FEC decoding ...\n");
-
-	data = gf_malloc((mff->rows*191)*sizeof(char));
-	memset(data,0,sizeof(data));
-
-	initialize_ecc ();
-	ML = 255;
-	memset(linebuffer, 0, 255);
-	offset = 0;
-
-	/*fprintf(stderr, "ADT data\n");
-	print_bytes(mff->p_adt, 32, 1, 0);
-	print_bytes(mff->p_adt+512, 32, 1, 0);
-	print_bytes(mff->p_adt+512+512, 32, 1, 0);
-	print_bytes(mff->p_adt+512+512+512, 32, 1, 1);
-	fprintf(stderr, "RS data\n");
-	print_bytes(mff->p_rs, 32, 1, 0);
-	print_bytes(mff->p_rs+512, 32, 1, 0);
-	print_bytes(mff->p_rs+512+512, 32, 1, 0);
-	print_bytes(mff->p_rs+512+512+512, 32, 1, 1);*/
+	u32 i, j, nb_erasures, nb_fixed;
+	u32 erasures[MPE_ADT_COLS + MPE_RS_COLS];
+	u8 linebuffer[MPE_ADT_COLS + MPE_RS_COLS];
 
-	for ( i = 0; i < mff->rows; i ++ )	{
-		u8 tmp[255];
+	if (!mff->rs) mff->rs = gf_rs_new(MPE_RS_COLS);
+	if (!mff->rs) return;
 
+	for ( i = 0; i < mff->rows; i ++ )	{
 		getRowFromADT(mff, i, linebuffer);
 		getRowFromRS(mff, i, linebuffer + mff->col_adt);
 
-		encode_data(linebuffer, 191, tmp);
-
-		decode_data(linebuffer, ML);
-		if (check_syndrome () != 0) {
-			u32 nerasures = 0;
-			u32 *erasures = NULL;
-
-			/* TODO: set the erasures and errors based on the MFF */
-			if(correct_errors_erasures (linebuffer, ML, nerasures,  erasures) == 0)
-			{
-				//fprintf(stderr, "Correction Error line %d \n", i);
-			}
-
-			/* TODO: replace the current line in MFF */
+		/*bytes flagged as lost when filling the frame are erasures*/
+		nb_erasures = 0;
+		for (j = 0; j < mff->col_adt; j++) {
+			if (mff->p_error_adt[j*mff->rows + i]) erasures[nb_erasures++] = j;
+		}
+		for (j = 0; j < mff->col_rs; j++) {
+			if (mff->p_error_rs[j*mff->rows + i]) erasures[nb_erasures++] = mff->col_adt + j;
 		}
 
-		memcpy(data+offset,linebuffer,sizeof(data));
-		offset += 191;
+		if (gf_rs_decode(mff->rs, linebuffer, mff->col_adt + mff->col_rs, erasures, nb_erasures, &nb_fixed) != GF_OK) {
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[MPE-FEC] PID %d: cannot correct row %d (%d erasures)\n", mff->PID, i, nb_erasures));
+			continue;
+		}
+		/* replace the current line in MFF */
+		if (nb_fixed) setRowADT(mff, i, linebuffer);
 	}
-	//fprintf(stderr, "FEC decoding done.\n");
-	memcpy(mff->p_adt,data,sizeof(data));
-	//gf_m2ts_ipdatagram_reader(mff->p_adt,ip_datagram);
-
-
 }
 
 
@@ -1192,6 +1161,16 @@ void getRowFromRS (MPE_FEC_FRAME * mff, u32 index, u8* rs_row)
 	}
 }
 
+void setRowADT(MPE_FEC_FRAME *mff, u32 index, u8 *adt_row)
+{
+	u32 i = 0;
+	u32 base = 0;
+	for ( i = 0; i < mff->col_adt; i ++ ) {
+		mff->p_adt [ base + index ] = adt_row [ i ];
+		base += mff->rows;
+	}
+}
+
 void setRowRS(MPE_FEC_FRAME *mff, u32 index, u8 *p_rs)
 {
 	u32 i = 0;
@@ -53,6 +53,8 @@ typedef struct __tag_rtp_track
 	u32 track_num;
 	u32 timescale;
 	u32 nb_aus;
+	/*average bitrate in kbps*/
+	u32 bandwidth;
 
 	/*loaded AU info*/
 	GF_ISOSample  *au;
@@ -88,6 +90,9 @@ struct __isom_rtp_streamer
 
 	Bool first_RTCP_sent;
     u64 last_min_dts;
+
+	/*set if packets are queued and paced by the RTP streamers*/
+	Bool batch_send;
 };
 
 
@@ -339,6 +344,14 @@ GF_Err gf_isom_streamer_send_next_packet(GF_ISOMRTPStreamer *streamer, s32 send_
 		diff = ((u32) min_ts) - gf_sys_clock();
 
 		if (diff > send_ahead_delay) {
+			/*send paced packets while waiting*/
+			if (streamer->batch_send) {
+				track = streamer->stream;
+				while (track) {
+					gf_rtp_streamer_flush(track->rtp, GF_FALSE);
+					track = track->next;
+				}
+			}
 			gf_sleep(1);
 		} else {
 			if (diff<10) {
@@ -390,9 +403,31 @@ GF_Err gf_isom_streamer_send_next_packet(GF_ISOMRTPStreamer *streamer, s32 send_
 	/*delete sample*/
 	gf_isom_sample_del(&to_send->au);
 
+	/*send queued packets of this AU, or what pacing allows*/
+	if (streamer->batch_send)
+		gf_rtp_streamer_flush(to_send->rtp, GF_FALSE);
+
 	return e;
 }
 
+GF_EXPORT
+GF_Err gf_isom_streamer_set_send_batch(GF_ISOMRTPStreamer *streamer, u32 nb_packets, u32 pacing_us)
+{
+	GF_Err e;
+	GF_RTPTrack *track;
+	if (!streamer) return GF_BAD_PARAM;
+
+	track = streamer->stream;
+	while (track) {
+		/*pace at twice the average bitrate to absorb VBR peaks*/
+		e = gf_rtp_streamer_set_send_batch(track->rtp, nb_packets, 2*track->bandwidth, track->bandwidth ? pacing_us : 0);
+		if (e) return e;
+		track = track->next;
+	}
+	streamer->batch_send = nb_packets ? GF_TRUE : GF_FALSE;
+	return GF_OK;
+}
+
 GF_EXPORT
 Double gf_isom_streamer_get_current_time(GF_ISOMRTPStreamer *streamer)
 {
@@ -615,6 +650,7 @@ GF_ISOMRTPStreamer *gf_isom_streamer_new(const char *file_name, const char *ip_d
 
 		/*get sample info*/
 		gf_media_get_sample_average_infos(streamer->isom, track->track_num, &MinSize, &MaxSize, &avgTS, &maxDTSDelta, &const_dur, &bandwidth);
+		track->bandwidth = bandwidth;
 
 		if (is_crypted) {
 			Bool use_sel_enc;
@@ -196,13 +196,16 @@ GF_Err gf_media_remove_non_rap(GF_ISOFile *file, u32 track, Bool non_ref_only)
 
 #endif /*GPAC_DISABLE_ISOM_WRITE*/
 
+/*read size when hashing files*/
+#define HASH_BLOCK_SIZE	65536
+
 GF_EXPORT
 GF_Err gf_media_get_file_hash(const char *file, u8 hash[20])
 {
 #ifdef GPAC_DISABLE_CORE_TOOLS
 	return GF_NOT_SUPPORTED;
 #else
-	u8 block[1024];
+	u8 *block;
 	u32 read;
 	u64 size, tot;
 	FILE *in;
@@ -219,6 +222,11 @@ GF_Err gf_media_get_file_hash(const char *file, u8 hash[20])
 	size = gf_ftell(in);
 	gf_fseek(in, 0, SEEK_SET);
 
+	block = (u8 *)gf_malloc(sizeof(u8)*HASH_BLOCK_SIZE);
+	if (!block) {
+		gf_fclose(in);
+		return GF_OUT_OF_MEM;
+	}
 	ctx = gf_sha1_starts();
 	tot = 0;
 #ifndef GPAC_DISABLE_ISOM
@@ -243,7 +251,7 @@ GF_Err gf_media_get_file_hash(const char *file, u8 hash[20])
 			} else {
 				u32 bsize = 0;
 				while (bsize<box_size) {
-					u32 to_read = (u32) ((box_size-bsize<1024) ? (box_size-bsize) : 1024);
+					u32 to_read = (u32) ((box_size-bsize<HASH_BLOCK_SIZE) ? (box_size-bsize) : HASH_BLOCK_SIZE);
 					gf_bs_read_data(bs, (char *) block, to_read);
 					gf_sha1_update(ctx, block, to_read);
 					bsize += to_read;
@@ -253,7 +261,7 @@ GF_Err gf_media_get_file_hash(const char *file, u8 hash[20])
 		} else
 #endif
 		{
-			read = (u32) fread(block, 1, 1024, in);
+			read = (u32) fread(block, 1, HASH_BLOCK_SIZE, in);
 			if ((s32) read < 0) {
 				e = GF_IO_ERR;
 				break;
@@ -266,6 +274,7 @@ GF_Err gf_media_get_file_hash(const char *file, u8 hash[20])
 #ifndef GPAC_DISABLE_ISOM
 	if (bs) gf_bs_del(bs);
 #endif
+	gf_free(block);
 	gf_fclose(in);
 	return e;
 #endif
@@ -214,6 +214,7 @@ GF_Err gf_mpd_parse_base_url(GF_List *container, GF_XMLNode *node)
 	while ( (att = gf_list_enum(node->attributes, &i))) {
 		if (!strcmp(att->name, "serviceLocation")) url->service_location = gf_mpd_parse_string(att->value);
 		else if (!strcmp(att->name, "byteRange")) url->byte_range = gf_mpd_parse_byte_range(att->value);
+		else if (!strcmp(att->name, "availabilityTimeOffset")) url->availability_time_offset = gf_mpd_parse_double(att->value);
 	}
 	url->URL = gf_mpd_parse_text_content(node);
 	return GF_OK;
@@ -850,6 +851,7 @@ void gf_mpd_segment_timeline_free(void *_item)
 {
 	GF_MPD_SegmentTimeline *ptr = (GF_MPD_SegmentTimeline *)_item;
 	gf_mpd_del_list(ptr->entries, gf_mpd_segment_entry_free, 0);
+	if (ptr->index) gf_free(ptr->index);
 	gf_free(ptr);
 }
 
@@ -2005,6 +2007,8 @@ static void gf_mpd_print_base_url(FILE *out, GF_List *base_URLs, char *indent)
 			fprintf(out, " serviceLocation=\"%s\"", url->service_location);
 		if (url->byte_range)
 			fprintf(out, " byteRange=\""LLD"-"LLD"\"", url->byte_range->start_range, url->byte_range->end_range);
+		if (url->availability_time_offset)
+			fprintf(out, " availabilityTimeOffset=\"%g\"", url->availability_time_offset);
 		fprintf(out, ">%s</BaseURL>\n", url->URL);
 	}
 }
@@ -2847,38 +2851,24 @@ GF_Err gf_mpd_resolve_url(GF_MPD *mpd, GF_MPD_Representation *rep, GF_MPD_Adapta
 				strcat(solved_template, "$Time$");
 			} else if (timeline) {
 				/*uses segment timeline*/
-				u32 k, nb_seg, cur_idx, nb_repeat;
-				u64 time, start_time;
-				nb_seg = gf_list_count(timeline->entries);
-				cur_idx = 0;
-				start_time=0;
-				for (k=0; k<nb_seg; k++) {
-					GF_MPD_SegmentTimelineEntry *ent = gf_list_get(timeline->entries, k);
-					if (item_index>cur_idx+ent->repeat_count) {
-						cur_idx += 1 + ent->repeat_count;
-						if (ent->start_time) start_time = ent->start_time;
-						if (k<nb_seg-1) {
-							start_time += ent->duration * (1 + ent->repeat_count);
-							continue;
-						} else {
-							gf_free(url);
-							gf_free(solved_template);
-							second_sep[0] = '$';
-							return GF_EOS;
-						}
+				u64 time;
+				GF_MPD_SegmentTimelineEntry *ent = gf_mpd_segment_timeline_get_segment(timeline, item_index, &time, NULL);
+				if (!ent) {
+					if (gf_list_count(timeline->entries)) {
+						gf_free(url);
+						gf_free(solved_template);
+						second_sep[0] = '$';
+						return GF_EOS;
 					}
+				} else {
 					*segment_duration_in_ms = ent->duration;
 					*segment_duration_in_ms = (u32) ((Double) (*segment_duration_in_ms) * 1000.0 / timescale);
-					nb_repeat = item_index - cur_idx;
-					time = ent->start_time ? ent->start_time : start_time;
-					time += nb_repeat * ent->duration;
 
 					/*replace final 'd' with LLD (%lld or I64d)*/
 					szPrintFormat[strlen(szPrintFormat)-1] = 0;
 					strcat(szPrintFormat, &LLD[1]);
 					sprintf(szFormat, szPrintFormat, time);
 					strcat(solved_template, szFormat);
-					break;
 				}
 			} else if (duration) {
 				u64 time = item_index * duration;
@@ -2998,24 +2988,130 @@ void gf_mpd_resolve_segment_duration(GF_MPD_Representation *rep, GF_MPD_Adaptati
 	}
 }
 
-static u64 gf_mpd_segment_timeline_start(GF_MPD_SegmentTimeline *timeline, u32 segment_index, u64 *segment_duration)
+GF_EXPORT
+void gf_mpd_segment_timeline_reset_index(GF_MPD_SegmentTimeline *timeline)
+{
+	if (timeline) timeline->index_valid = GF_FALSE;
+}
+
+static Bool gf_mpd_segment_timeline_build_index(GF_MPD_SegmentTimeline *timeline)
 {
-	u64 start_time = 0;
-	u32 i, idx, k;
-	idx = 0;
-	for (i = 0; i<gf_list_count(timeline->entries); i++) {
+	u32 i, count;
+	u64 start_time, first_segment;
+	if (!timeline) return GF_FALSE;
+	count = gf_list_count(timeline->entries);
+	if (timeline->index_valid && (timeline->nb_indexed == count)) return GF_TRUE;
+
+	if (count > timeline->index_alloc) {
+		timeline->index_alloc = count;
+		timeline->index = gf_realloc(timeline->index, sizeof(GF_MPD_SegmentTimelineIndex) * count);
+		if (!timeline->index) {
+			timeline->index_alloc = timeline->nb_indexed = 0;
+			timeline->index_valid = GF_FALSE;
+			return GF_FALSE;
+		}
+	}
+	start_time = first_segment = 0;
+	for (i=0; i<count; i++) {
+		u64 nb_segs;
 		GF_MPD_SegmentTimelineEntry *ent = gf_list_get(timeline->entries, i);
 		if (ent->start_time) start_time = ent->start_time;
-		for (k = 0; k<ent->repeat_count + 1; k++) {
-			if (idx == segment_index) {
-				if (segment_duration)
-					*segment_duration = ent->duration;
-				return start_time;
-			}
-			idx++;
-			start_time += ent->duration;
-		}
+		timeline->index[i].start_time = start_time;
+		timeline->index[i].first_segment = first_segment;
+		nb_segs = 1 + (u64) ent->repeat_count;
+		start_time += nb_segs * ent->duration;
+		first_segment += nb_segs;
+	}
+	timeline->nb_indexed = count;
+	timeline->index_end_time = start_time;
+	timeline->index_nb_segments = first_segment;
+	timeline->index_valid = GF_TRUE;
+	return GF_TRUE;
+}
+
+GF_EXPORT
+u32 gf_mpd_segment_timeline_get_count(GF_MPD_SegmentTimeline *timeline, u64 *out_end_time)
+{
+	if (out_end_time) *out_end_time = 0;
+	if (!gf_mpd_segment_timeline_build_index(timeline)) return 0;
+	if (out_end_time) *out_end_time = timeline->index_end_time;
+	if (timeline->index_nb_segments > 0xFFFFFFFF) return 0xFFFFFFFF;
+	return (u32) timeline->index_nb_segments;
+}
+
+GF_EXPORT
+GF_MPD_SegmentTimelineEntry *gf_mpd_segment_timeline_get_segment(GF_MPD_SegmentTimeline *timeline, u32 segment_index, u64 *out_start_time, u32 *out_entry_index)
+{
+	u32 low, high;
+	GF_MPD_SegmentTimelineIndex *idx;
+	GF_MPD_SegmentTimelineEntry *ent;
+
+	if (out_start_time) *out_start_time = 0;
+	if (!gf_mpd_segment_timeline_build_index(timeline)) return NULL;
+	if (segment_index >= timeline->index_nb_segments) {
+		if (out_start_time) *out_start_time = timeline->index_end_time;
+		return NULL;
+	}
+	//last entry with first_segment <= segment_index
+	low = 0;
+	high = timeline->nb_indexed - 1;
+	while (low < high) {
+		u32 mid = (low + high + 1) / 2;
+		if (timeline->index[mid].first_segment <= segment_index) low = mid;
+		else high = mid - 1;
+	}
+	idx = &timeline->index[low];
+	ent = gf_list_get(timeline->entries, low);
+	if (out_start_time) *out_start_time = idx->start_time + (segment_index - idx->first_segment) * ent->duration;
+	if (out_entry_index) *out_entry_index = low;
+	return ent;
+}
+
+GF_EXPORT
+u32 gf_mpd_segment_timeline_find_time(GF_MPD_SegmentTimeline *timeline, u64 time, u64 *out_start_time)
+{
+	u32 low, high;
+	u64 k;
+	GF_MPD_SegmentTimelineIndex *idx;
+	GF_MPD_SegmentTimelineEntry *ent;
+
+	if (out_start_time) *out_start_time = 0;
+	if (!gf_mpd_segment_timeline_build_index(timeline) || !timeline->nb_indexed) return 0;
+
+	if (time <= timeline->index[0].start_time) {
+		if (out_start_time) *out_start_time = timeline->index[0].start_time;
+		return 0;
+	}
+	//last entry starting before time
+	low = 0;
+	high = timeline->nb_indexed - 1;
+	while (low < high) {
+		u32 mid = (low + high + 1) / 2;
+		if (timeline->index[mid].start_time < time) low = mid;
+		else high = mid - 1;
 	}
+	idx = &timeline->index[low];
+	ent = gf_list_get(timeline->entries, low);
+	//first segment of the entry starting at or after time
+	k = ent->duration ? (time - idx->start_time + ent->duration - 1) / ent->duration : 0;
+	if (k <= ent->repeat_count) {
+		if (out_start_time) *out_start_time = idx->start_time + k * ent->duration;
+		return (u32) (idx->first_segment + k);
+	}
+	//in a gap between entries or after the end
+	if (low + 1 < timeline->nb_indexed) {
+		if (out_start_time) *out_start_time = timeline->index[low+1].start_time;
+		return (u32) timeline->index[low+1].first_segment;
+	}
+	if (out_start_time) *out_start_time = timeline->index_end_time;
+	return (u32) timeline->index_nb_segments;
+}
+
+static u64 gf_mpd_segment_timeline_start(GF_MPD_SegmentTimeline *timeline, u32 segment_index, u64 *segment_duration)
+{
+	u64 start_time;
+	GF_MPD_SegmentTimelineEntry *ent = gf_mpd_segment_timeline_get_segment(timeline, segment_index, &start_time, NULL);
+	if (ent && segment_duration) *segment_duration = ent->duration;
 	return start_time;
 }
 
@@ -3146,6 +3242,43 @@ static GF_Err mpd_seek_periods(Double seek_time, GF_MPD const * const in_mpd, GF
 	return GF_OK;
 }
 
+/*same resolution as gf_mpd_get_segment_start_time_with_timescale*/
+static GF_MPD_SegmentTimeline *mpd_get_segment_timeline(GF_MPD_Period const * const period, GF_MPD_AdaptationSet const * const set, GF_MPD_Representation const * const rep, u32 *out_timescale)
+{
+	u32 timescale = 0;
+	GF_MPD_SegmentTimeline *timeline = NULL;
+	if (rep->segment_base || set->segment_base || period->segment_base) return NULL;
+
+	if (rep->segment_list || set->segment_list || period->segment_list) {
+		if (period->segment_list) {
+			if (period->segment_list->timescale) timescale = period->segment_list->timescale;
+			if (period->segment_list->segment_timeline) timeline = period->segment_list->segment_timeline;
+		}
+		if (set->segment_list) {
+			if (set->segment_list->timescale) timescale = set->segment_list->timescale;
+			if (set->segment_list->segment_timeline) timeline = set->segment_list->segment_timeline;
+		}
+		if (rep->segment_list) {
+			if (rep->segment_list->timescale) timescale = rep->segment_list->timescale;
+		}
+	} else {
+		if (period->segment_template) {
+			if (period->segment_template->timescale) timescale = period->segment_template->timescale;
+			if (period->segment_template->segment_timeline) timeline = period->segment_template->segment_timeline;
+		}
+		if (set->segment_template) {
+			if (set->segment_template->timescale) timescale = set->segment_template->timescale;
+			if (set->segment_template->segment_timeline) timeline = set->segment_template->segment_timeline;
+		}
+		if (rep->segment_template) {
+			if (rep->segment_template->timescale) timescale = rep->segment_template->timescale;
+			if (rep->segment_template->segment_timeline) timeline = rep->segment_template->segment_timeline;
+		}
+	}
+	*out_timescale = timescale ? timescale : 1;
+	return timeline;
+}
+
 GF_EXPORT
 GF_Err gf_mpd_seek_in_period(Double seek_time, MPDSeekMode seek_mode,
 	GF_MPD_Period const * const in_period, GF_MPD_AdaptationSet const * const in_set, GF_MPD_Representation const * const in_rep,
@@ -3154,13 +3287,40 @@ GF_Err gf_mpd_seek_in_period(Double seek_time, MPDSeekMode seek_mode,
 	Double seg_start = 0.0, segment_duration = 0.0;
 	u64 segment_duration_in_scale = 0, seg_start_in_scale = 0;
 	u32 timescale = 0, segment_idx = 0;
+	GF_MPD_SegmentTimeline *timeline;
 
-	if (!out_segment_index) {
+	if (!out_segment_index || !in_period || !in_set || !in_rep) {
 		return GF_BAD_PARAM;
 	}
 
+	/*segment timeline: directly look for the segment containing the seek time*/
+	timeline = mpd_get_segment_timeline(in_period, in_set, in_rep, &timescale);
+	if (timeline && gf_mpd_segment_timeline_get_count(timeline, NULL) && (seek_time >= 0)) {
+		u64 first_start, start, target;
+		GF_MPD_SegmentTimelineEntry *ent;
+		gf_mpd_segment_timeline_get_segment(timeline, 0, &first_start, NULL);
+		target = first_start + (u64) (seek_time * timescale);
+		segment_idx = gf_mpd_segment_timeline_find_time(timeline, target, &start);
+		if ((start > target) && segment_idx) segment_idx--;
+		ent = gf_mpd_segment_timeline_get_segment(timeline, segment_idx, &start, NULL);
+		if (ent && (start <= target) && (target < start + ent->duration)) {
+			seg_start = ((Double) (start - first_start)) / timescale;
+			segment_duration = ((Double) ent->duration) / timescale;
+			if ((seek_mode == MPD_SEEK_NEAREST) && (seg_start + segment_duration - seek_time < seek_time - seg_start)) {
+				if (out_opt_seek_time) *out_opt_seek_time = seg_start + segment_duration;
+				segment_idx++;
+			} else if (out_opt_seek_time) {
+				*out_opt_seek_time = seg_start;
+			}
+			*out_segment_index = segment_idx;
+			return GF_OK;
+		}
+		/*gaps in the timeline, use the regular walk*/
+		segment_idx = 0;
+		seg_start = segment_duration = 0;
+	}
+
 	while (1) {
-		//TODO this could be further optimized by directly querying the index for this start time ...
 		GF_Err e = gf_mpd_get_segment_start_time_with_timescale(segment_idx, in_period, in_set, in_rep, &seg_start_in_scale, &segment_duration_in_scale, &timescale);
 		if (e<0)
 			return e;
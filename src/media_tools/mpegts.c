@@ -117,6 +117,9 @@ static void gf_m2ts_estimate_duration(GF_M2TS_Demuxer *ts, u64 PCR, u16 pcr_pid)
 	u64 file_size = 0;
 //	if (ts->duration>0) return;
 
+	/*duration is known from the seek index*/
+	if (ts->seek_index) return;
+
 	if (ts->file || ts->file_size) {
 		file_size = ts->file_size;
 	} else if (ts->dnload) {
@@ -3507,8 +3510,7 @@ static GF_Err gf_m2ts_process_packet(GF_M2TS_Demuxer *ts, unsigned char *data)
 	return GF_OK;
 }
 
-GF_EXPORT
-GF_Err gf_m2ts_process_data(GF_M2TS_Demuxer *ts, char *data, u32 data_size)
+static GF_Err gf_m2ts_demux_data(GF_M2TS_Demuxer *ts, char *data, u32 data_size)
 {
 	GF_Err e;
 	u32 pos, pck_size;
@@ -3570,6 +3572,16 @@ GF_Err gf_m2ts_process_data(GF_M2TS_Demuxer *ts, char *data, u32 data_size)
 	return e;
 }
 
+GF_EXPORT
+GF_Err gf_m2ts_process_data(GF_M2TS_Demuxer *ts, char *data, u32 data_size)
+{
+	GF_Err e;
+	GF_TRACE(GF_TRACE_BEGIN, GF_LOG_CONTAINER, "ts_demux", 0);
+	e = gf_m2ts_demux_data(ts, data, data_size);
+	GF_TRACE(GF_TRACE_END, GF_LOG_CONTAINER, "ts_demux", 0);
+	return e;
+}
+
 GF_EXPORT
 GF_ESD *gf_m2ts_get_esd(GF_M2TS_ES *es)
 {
@@ -4090,6 +4102,475 @@ GF_Err gf_m2ts_demux_file(GF_M2TS_Demuxer *ts, const char *fileName, u64 start_b
 }
 
 
+/*seek index entry: time (90kHz, PTS of RAP or PCR) and offset of the TS packet starting the PES or carrying the PCR*/
+typedef struct
+{
+	u64 time;
+	u64 offset;
+} GF_M2TS_SeekIndexEntry;
+
+typedef struct
+{
+	u32 pid;
+	/*GF_M2TS_SEEK_INDEX_RAP or GF_M2TS_SEEK_INDEX_PCR*/
+	u32 type;
+	u32 stream_type;
+	/*min and max time in the stream, after PTS/PCR wrap removal*/
+	u64 first_time, last_time;
+	u32 last_duration;
+
+	GF_M2TS_SeekIndexEntry *entries;
+	u32 nb_entries, nb_alloc;
+
+	/*indexing state*/
+	u64 last_ts, wrap_offset, last_DTS;
+	Bool is_video;
+	/*PCR PID of the program of a RAP stream*/
+	u32 pcr_pid;
+} GF_M2TS_SeekIndexStream;
+
+enum
+{
+	GF_M2TS_SEEK_INDEX_RAP = 0,
+	GF_M2TS_SEEK_INDEX_PCR,
+};
+
+struct __m2ts_seek_index
+{
+	u64 file_size;
+	/*PID used for seeking, and origin of the timeline (first PCR of its program, or first PTS if no PCR)*/
+	u32 ref_pid;
+	u64 origin;
+	GF_List *streams;
+
+	/*indexing state*/
+	u64 min_interval;
+};
+
+#define GF_M2TS_SEEK_INDEX_MAGIC	GF_4CC('G', 'T', 'S', 'I')
+#define GF_M2TS_SEEK_INDEX_VERSION	2
+
+static Bool gf_m2ts_seek_index_is_video(u32 stream_type)
+{
+	switch (stream_type) {
+	case GF_M2TS_VIDEO_MPEG1:
+	case GF_M2TS_VIDEO_MPEG2:
+	case GF_M2TS_VIDEO_MPEG4:
+	case GF_M2TS_VIDEO_H264:
+	case GF_M2TS_VIDEO_SVC:
+	case GF_M2TS_VIDEO_HEVC:
+	case GF_M2TS_VIDEO_HEVC_TEMPORAL:
+	case GF_M2TS_VIDEO_MVCD:
+	case GF_M2TS_VIDEO_SHVC:
+	case GF_M2TS_VIDEO_SHVC_TEMPORAL:
+	case GF_M2TS_VIDEO_MHVC:
+	case GF_M2TS_VIDEO_MHVC_TEMPORAL:
+	case GF_M2TS_VIDEO_HEVC_MCTS:
+	case GF_M2TS_VIDEO_DCII:
+	case GF_M2TS_VIDEO_VC1:
+		return GF_TRUE;
+	}
+	return GF_FALSE;
+}
+
+static Bool gf_m2ts_seek_index_is_audio(u32 stream_type)
+{
+	switch (stream_type) {
+	case GF_M2TS_AUDIO_MPEG1:
+	case GF_M2TS_AUDIO_MPEG2:
+	case GF_M2TS_AUDIO_AAC:
+	case GF_M2TS_AUDIO_LATM_AAC:
+	case GF_M2TS_AUDIO_AC3:
+	case GF_M2TS_AUDIO_DTS:
+	case GF_M2TS_AUDIO_EC3:
+		return GF_TRUE;
+	}
+	return GF_FALSE;
+}
+
+static GF_M2TS_SeekIndexStream *gf_m2ts_seek_index_get_stream(GF_M2TS_SeekIndex *index, u32 pid, u32 type)
+{
+	u32 i, count = gf_list_count(index->streams);
+	GF_M2TS_SeekIndexStream *st;
+	for (i=0; i<count; i++) {
+		st = (GF_M2TS_SeekIndexStream *)gf_list_get(index->streams, i);
+		if ((st->pid==pid) && (st->type==type)) return st;
+	}
+	GF_SAFEALLOC(st, GF_M2TS_SeekIndexStream);
+	if (!st) return NULL;
+	st->pid = pid;
+	st->type = type;
+	gf_list_add(index->streams, st);
+	return st;
+}
+
+/*removes PTS/PCR wrapping and updates the time range of the stream*/
+static u64 gf_m2ts_seek_index_unwrap(GF_M2TS_SeekIndexStream *st, u64 ts)
+{
+	if (st->last_ts && (ts < st->last_ts) && (st->last_ts - ts > 0x100000000ULL)) {
+		st->wrap_offset += 0x200000000ULL;
+	}
+	st->last_ts = ts;
+	ts += st->wrap_offset;
+	if (!st->first_time || (ts < st->first_time)) st->first_time = ts;
+	if (ts > st->last_time) st->last_time = ts;
+	return ts;
+}
+
+/*byte offset of a TS packet in the file, 188 or 192 (M2TS/BDAV, starting with the timestamp prefix) bytes long*/
+static u64 gf_m2ts_seek_index_packet_offset(GF_M2TS_Demuxer *ts, u32 pck_number)
+{
+	return (u64) (pck_number-1) * (ts->prefix_present ? 192 : 188);
+}
+
+static GF_Err gf_m2ts_seek_index_add(GF_M2TS_SeekIndex *index, GF_M2TS_SeekIndexStream *st, u64 time, u64 offset)
+{
+	if (st->nb_entries) {
+		GF_M2TS_SeekIndexEntry *last = &st->entries[st->nb_entries-1];
+		if ((time <= last->time) || (time - last->time < index->min_interval)) return GF_OK;
+	}
+	if (st->nb_entries == st->nb_alloc) {
+		st->nb_alloc = st->nb_alloc ? 2*st->nb_alloc : 256;
+		st->entries = (GF_M2TS_SeekIndexEntry *)gf_realloc(st->entries, sizeof(GF_M2TS_SeekIndexEntry)*st->nb_alloc);
+		if (!st->entries) return GF_OUT_OF_MEM;
+	}
+	st->entries[st->nb_entries].time = time;
+	st->entries[st->nb_entries].offset = offset;
+	st->nb_entries++;
+	return GF_OK;
+}
+
+static void gf_m2ts_seek_index_on_event(GF_M2TS_Demuxer *ts, u32 evt_type, void *par)
+{
+	u32 i, count;
+	u64 time;
+	GF_M2TS_Program *prog;
+	GF_M2TS_PES_PCK *pck;
+	GF_M2TS_SeekIndexStream *st;
+	GF_M2TS_SeekIndex *index = (GF_M2TS_SeekIndex *)ts->user;
+
+	switch (evt_type) {
+	case GF_M2TS_EVT_PMT_FOUND:
+		prog = (GF_M2TS_Program*)par;
+		count = gf_list_count(prog->streams);
+		for (i=0; i<count; i++) {
+			GF_M2TS_ES *es = (GF_M2TS_ES*)gf_list_get(prog->streams, i);
+			if (!(es->flags & GF_M2TS_ES_IS_PES)) continue;
+			/*RAPs are only signaled in the video bitstream, every audio PES is a RAP: no need for AU framing*/
+			if (gf_m2ts_seek_index_is_video(es->stream_type)) {
+				gf_m2ts_set_pes_framing((GF_M2TS_PES *)es, GF_M2TS_PES_FRAMING_DEFAULT);
+			} else if (gf_m2ts_seek_index_is_audio(es->stream_type)) {
+				gf_m2ts_set_pes_framing((GF_M2TS_PES *)es, GF_M2TS_PES_FRAMING_RAW);
+			} else {
+				gf_m2ts_set_pes_framing((GF_M2TS_PES *)es, GF_M2TS_PES_FRAMING_SKIP);
+				continue;
+			}
+			st = gf_m2ts_seek_index_get_stream(index, es->pid, GF_M2TS_SEEK_INDEX_RAP);
+			if (!st) continue;
+			st->stream_type = es->stream_type;
+			st->is_video = gf_m2ts_seek_index_is_video(es->stream_type);
+			st->pcr_pid = prog->pcr_pid;
+		}
+		break;
+	case GF_M2TS_EVT_PES_PCK:
+		pck = (GF_M2TS_PES_PCK*)par;
+		st = gf_m2ts_seek_index_get_stream(index, pck->stream->pid, GF_M2TS_SEEK_INDEX_RAP);
+		if (!st) break;
+		time = gf_m2ts_seek_index_unwrap(st, pck->PTS);
+		if (pck->DTS != st->last_DTS) {
+			if (st->last_DTS && (pck->DTS > st->last_DTS)) st->last_duration = (u32) (pck->DTS - st->last_DTS);
+			st->last_DTS = pck->DTS;
+		}
+		if (!st->is_video || (pck->flags & GF_M2TS_PES_PCK_RAP)) {
+			gf_m2ts_seek_index_add(index, st, time, gf_m2ts_seek_index_packet_offset(ts, pck->stream->pes_start_packet_number));
+		}
+		break;
+	case GF_M2TS_EVT_PES_PCR:
+		pck = (GF_M2TS_PES_PCK*)par;
+		st = gf_m2ts_seek_index_get_stream(index, pck->stream->pid, GF_M2TS_SEEK_INDEX_PCR);
+		if (!st) break;
+		time = gf_m2ts_seek_index_unwrap(st, pck->PTS / 300);
+		gf_m2ts_seek_index_add(index, st, time, gf_m2ts_seek_index_packet_offset(ts, ts->pck_number));
+		break;
+	}
+}
+
+static void gf_m2ts_seek_index_set_reference(GF_M2TS_SeekIndex *index)
+{
+	u32 i, count = gf_list_count(index->streams);
+	GF_M2TS_SeekIndexStream *ref = NULL;
+
+	/*seek on video if any, otherwise on the first indexed stream*/
+	for (i=0; i<count; i++) {
+		GF_M2TS_SeekIndexStream *st = (GF_M2TS_SeekIndexStream *)gf_list_get(index->streams, i);
+		if ((st->type != GF_M2TS_SEEK_INDEX_RAP) || !st->nb_entries) continue;
+		if (!ref || (st->is_video && !ref->is_video)) ref = st;
+	}
+	index->ref_pid = ref ? ref->pid : 0;
+	index->origin = ref ? ref->first_time : 0;
+	if (!ref) return;
+
+	/*the timeline starts at the first PCR of the program of the reference stream, as done when playing the file from the start*/
+	for (i=0; i<count; i++) {
+		GF_M2TS_SeekIndexStream *st = (GF_M2TS_SeekIndexStream *)gf_list_get(index->streams, i);
+		if ((st->type != GF_M2TS_SEEK_INDEX_PCR) || (st->pid != ref->pcr_pid) || !st->nb_entries) continue;
+		if (st->first_time < index->origin) index->origin = st->first_time;
+		break;
+	}
+}
+
+GF_EXPORT
+GF_Err gf_m2ts_seek_index_build(const char *fileName, u32 min_interval_ms, GF_M2TS_SeekIndex **out_index)
+{
+	FILE *src;
+	GF_Err e = GF_OK;
+	GF_M2TS_Demuxer *ts;
+	GF_M2TS_SeekIndex *index;
+
+	*out_index = NULL;
+	src = gf_fopen(fileName, "rb");
+	if (!src) return GF_URL_ERROR;
+
+	GF_SAFEALLOC(index, GF_M2TS_SeekIndex);
+	ts = gf_m2ts_demux_new();
+	if (!index || !ts) {
+		if (index) gf_free(index);
+		if (ts) gf_m2ts_demux_del(ts);
+		gf_fclose(src);
+		return GF_OUT_OF_MEM;
+	}
+	index->streams = gf_list_new();
+	index->min_interval = (u64) min_interval_ms * 90;
+	ts->on_event = gf_m2ts_seek_index_on_event;
+	ts->user = index;
+
+	while (!feof(src)) {
+		char data[18800];
+		s32 size = (s32) fread(data, 1, 18800, src);
+		if (size<0) {
+			e = GF_IO_ERR;
+			break;
+		}
+		gf_m2ts_process_data(ts, data, size);
+		index->file_size += size;
+		if (size<18800) break;
+	}
+	gf_m2ts_demux_del(ts);
+	gf_fclose(src);
+
+	if (e) {
+		gf_m2ts_seek_index_del(index);
+		return e;
+	}
+	gf_m2ts_seek_index_set_reference(index);
+	if (!index->ref_pid) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[MPEG-2 TS] No random access point found in %s, cannot build seek index\n", fileName));
+		gf_m2ts_seek_index_del(index);
+		return GF_NON_COMPLIANT_BITSTREAM;
+	}
+	*out_index = index;
+	return GF_OK;
+}
+
+GF_EXPORT
+void gf_m2ts_seek_index_del(GF_M2TS_SeekIndex *index)
+{
+	if (!index) return;
+	while (gf_list_count(index->streams)) {
+		GF_M2TS_SeekIndexStream *st = (GF_M2TS_SeekIndexStream *)gf_list_pop_back(index->streams);
+		if (st->entries) gf_free(st->entries);
+		gf_free(st);
+	}
+	gf_list_del(index->streams);
+	gf_free(index);
+}
+
+GF_EXPORT
+GF_Err gf_m2ts_seek_index_save(GF_M2TS_SeekIndex *index, const char *indexName)
+{
+	u32 i, j, count;
+	GF_BitStream *bs;
+	FILE *f = gf_fopen(indexName, "wb");
+	if (!f) return GF_IO_ERR;
+	bs = gf_bs_from_file(f, GF_BITSTREAM_WRITE);
+
+	count = gf_list_count(index->streams);
+	gf_bs_write_u32(bs, GF_M2TS_SEEK_INDEX_MAGIC);
+	gf_bs_write_u8(bs, GF_M2TS_SEEK_INDEX_VERSION);
+	gf_bs_write_u64(bs, index->file_size);
+	gf_bs_write_u16(bs, index->ref_pid);
+	gf_bs_write_u64(bs, index->origin);
+	gf_bs_write_u16(bs, count);
+	for (i=0; i<count; i++) {
+		GF_M2TS_SeekIndexStream *st = (GF_M2TS_SeekIndexStream *)gf_list_get(index->streams, i);
+		gf_bs_write_u16(bs, st->pid);
+		gf_bs_write_u8(bs, st->type);
+		gf_bs_write_u16(bs, st->stream_type);
+		gf_bs_write_u64(bs, st->first_time);
+		gf_bs_write_u64(bs, st->last_time);
+		gf_bs_write_u32(bs, st->last_duration);
+		gf_bs_write_u32(bs, st->nb_entries);
+		/*entries are stored as deltas from the previous one, both times and offsets are increasing*/
+		for (j=0; j<st->nb_entries; j++) {
+			u64 dt = st->entries[j].time - (j ? st->entries[j-1].time : st->first_time);
+			u64 doff = st->entries[j].offset - (j ? st->entries[j-1].offset : 0);
+			if ((dt>0xFFFFFFFFUL) || (doff>0xFFFFFFFFUL)) {
+				gf_bs_del(bs);
+				gf_fclose(f);
+				gf_delete_file(indexName);
+				return GF_NOT_SUPPORTED;
+			}
+			gf_bs_write_u32(bs, (u32) dt);
+			gf_bs_write_u32(bs, (u32) doff);
+		}
+	}
+	gf_bs_del(bs);
+	gf_fclose(f);
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_m2ts_seek_index_load(const char *indexName, const char *fileName, GF_M2TS_SeekIndex **out_index)
+{
+	u32 i, j, count;
+	u64 file_size;
+	GF_Err e = GF_OK;
+	GF_BitStream *bs;
+	GF_M2TS_SeekIndex *index;
+	FILE *f;
+
+	*out_index = NULL;
+	f = gf_fopen(fileName, "rb");
+	if (!f) return GF_URL_ERROR;
+	gf_fseek(f, 0, SEEK_END);
+	file_size = gf_ftell(f);
+	gf_fclose(f);
+
+	f = gf_fopen(indexName, "rb");
+	if (!f) return GF_URL_ERROR;
+	bs = gf_bs_from_file(f, GF_BITSTREAM_READ);
+
+	if ((gf_bs_read_u32(bs) != GF_M2TS_SEEK_INDEX_MAGIC) || (gf_bs_read_u8(bs) != GF_M2TS_SEEK_INDEX_VERSION)) {
+		e = GF_NON_COMPLIANT_BITSTREAM;
+	}
+	/*index of a different version of the file (still recording or rewritten)*/
+	else if (gf_bs_read_u64(bs) != file_size) {
+		e = GF_BAD_PARAM;
+	}
+	if (e) {
+		gf_bs_del(bs);
+		gf_fclose(f);
+		return e;
+	}
+
+	GF_SAFEALLOC(index, GF_M2TS_SeekIndex);
+	if (!index) {
+		gf_bs_del(bs);
+		gf_fclose(f);
+		return GF_OUT_OF_MEM;
+	}
+	index->streams = gf_list_new();
+	index->file_size = file_size;
+	index->ref_pid = gf_bs_read_u16(bs);
+	index->origin = gf_bs_read_u64(bs);
+	count = gf_bs_read_u16(bs);
+	for (i=0; i<count; i++) {
+		GF_M2TS_SeekIndexStream *st;
+		GF_SAFEALLOC(st, GF_M2TS_SeekIndexStream);
+		if (!st) {
+			e = GF_OUT_OF_MEM;
+			break;
+		}
+		gf_list_add(index->streams, st);
+		st->pid = gf_bs_read_u16(bs);
+		st->type = gf_bs_read_u8(bs);
+		st->stream_type = gf_bs_read_u16(bs);
+		st->is_video = gf_m2ts_seek_index_is_video(st->stream_type);
+		st->first_time = gf_bs_read_u64(bs);
+		st->last_time = gf_bs_read_u64(bs);
+		st->last_duration = gf_bs_read_u32(bs);
+		st->nb_entries = gf_bs_read_u32(bs);
+		if ((u64) st->nb_entries * 8 > gf_bs_available(bs)) {
+			st->nb_entries = 0;
+			e = GF_NON_COMPLIANT_BITSTREAM;
+			break;
+		}
+		st->nb_alloc = st->nb_entries;
+		st->entries = (GF_M2TS_SeekIndexEntry *)gf_malloc(sizeof(GF_M2TS_SeekIndexEntry) * (st->nb_entries ? st->nb_entries : 1));
+		if (!st->entries) {
+			st->nb_entries = 0;
+			e = GF_OUT_OF_MEM;
+			break;
+		}
+		for (j=0; j<st->nb_entries; j++) {
+			st->entries[j].time = (j ? st->entries[j-1].time : st->first_time) + gf_bs_read_u32(bs);
+			st->entries[j].offset = (j ? st->entries[j-1].offset : 0) + gf_bs_read_u32(bs);
+		}
+	}
+	gf_bs_del(bs);
+	gf_fclose(f);
+
+	if (e) {
+		gf_m2ts_seek_index_del(index);
+		return e;
+	}
+	*out_index = index;
+	return GF_OK;
+}
+
+GF_EXPORT
+Double gf_m2ts_seek_index_get_duration(GF_M2TS_SeekIndex *index)
+{
+	u32 i, count = gf_list_count(index->streams);
+	for (i=0; i<count; i++) {
+		GF_M2TS_SeekIndexStream *st = (GF_M2TS_SeekIndexStream *)gf_list_get(index->streams, i);
+		if ((st->pid==index->ref_pid) && (st->type==GF_M2TS_SEEK_INDEX_RAP)) {
+			return (Double) (s64) (st->last_time + st->last_duration - index->origin) / 90000.0;
+		}
+	}
+	return 0;
+}
+
+GF_EXPORT
+Double gf_m2ts_seek_index_get_time(GF_M2TS_SeekIndex *index, u64 timestamp)
+{
+	/*timestamps of the second 33-bit period*/
+	if ((timestamp < index->origin) && (index->origin - timestamp > 0x100000000ULL)) timestamp += 0x200000000ULL;
+	return (Double) ((s64) timestamp - (s64) index->origin) / 90000.0;
+}
+
+GF_EXPORT
+GF_Err gf_m2ts_seek_index_find(GF_M2TS_SeekIndex *index, u32 pid, Double time, u64 *byte_offset, Double *rap_time)
+{
+	u32 i, count, low, high;
+	u64 target;
+	GF_M2TS_SeekIndexStream *st = NULL;
+
+	if (!pid) pid = index->ref_pid;
+	count = gf_list_count(index->streams);
+	for (i=0; i<count; i++) {
+		st = (GF_M2TS_SeekIndexStream *)gf_list_get(index->streams, i);
+		if ((st->pid==pid) && (st->type==GF_M2TS_SEEK_INDEX_RAP)) break;
+		st = NULL;
+	}
+	if (!st || !st->nb_entries) return GF_STREAM_NOT_FOUND;
+
+	if (time<0) time = 0;
+	target = index->origin + (u64) (time * 90000);
+	/*last entry with a time lower or equal to the target*/
+	low = 0;
+	high = st->nb_entries;
+	while (high - low > 1) {
+		u32 mid = (low + high) / 2;
+		if (st->entries[mid].time <= target) low = mid;
+		else high = mid;
+	}
+	if (byte_offset) *byte_offset = st->entries[low].offset;
+	if (rap_time) *rap_time = (Double) ((s64) st->entries[low].time - (s64) index->origin) / 90000.0;
+	return GF_OK;
+}
+
+
 static u32 gf_m2ts_demuxer_run(void *_p)
 {
 	u32 i;
@@ -4163,16 +4644,15 @@ static u32 gf_m2ts_demuxer_run(void *_p)
 				/*process chunk*/
 				if (is_rtp) {
 #ifndef GPAC_DISABLE_STREAMING
-					char *pck;
 					seq_num = ((data[2] << 8) & 0xFF00) | (data[3] & 0xFF);
 					gf_rtp_reorderer_add(ch, (void *) data, size, seq_num);
 
-					pck = (char *) gf_rtp_reorderer_get(ch, &size);
-					if (pck) {
-						gf_m2ts_process_data(ts, pck+12, size-12);
+					/*reordered packet is copied back in our buffer*/
+					size = gf_rtp_reorderer_get_into(ch, data, ts->udp_buffer_size);
+					if (size > 12) {
+						gf_m2ts_process_data(ts, data+12, size-12);
 						if (record_to)
 							fwrite(data+12, size-12, 1, record_to);
-						gf_free(pck);
 					}
 #else
 					gf_m2ts_process_data(ts, data+12, size-12);
@@ -4202,7 +4682,7 @@ static u32 gf_m2ts_demuxer_run(void *_p)
 				gf_sleep(1);
 			}
 		} else {
-			u32 pos = 0;
+			u64 pos = 0;
 			GF_BitStream *ts_bs = NULL;
 
 			if (ts->file)
@@ -4219,9 +4699,20 @@ static u32 gf_m2ts_demuxer_run(void *_p)
 					continue;
 				}
 
-				if (ts->start_range && ts->duration) {
+				if (ts->start_range && ts->seek_index) {
+					/*start at the random access point before the requested time*/
+					if (gf_m2ts_seek_index_find(ts->seek_index, 0, ts->start_range / 1000.0, &pos, NULL) != GF_OK)
+						pos = 0;
+
+					if (pos>=ts->file_size) {
+						pos = 0;
+					}
+					ts->start_range = 0;
+					gf_bs_seek(ts_bs, pos);
+				}
+				else if (ts->start_range && ts->duration) {
 					Double perc = ts->start_range / (1000 * ts->duration);
-					pos = (u32) (s64) (perc * ts->file_size);
+					pos = (u64) (s64) (perc * ts->file_size);
 					/*align to TS packet size*/
 					pos/=188;
 					pos*=188;
@@ -4596,6 +5087,8 @@ static GF_Err gf_m2ts_demuxer_setup_file(GF_M2TS_Demuxer *ts, char *url)
 			gf_fseek(ts->file, 0, SEEK_END);
 			ts->file_size = gf_ftell(ts->file);
 			gf_fseek(ts->file, 0, SEEK_SET);
+
+			if (ts->seek_index) ts->duration = gf_m2ts_seek_index_get_duration(ts->seek_index);
 		}
 	}
 
@@ -11,8 +11,6 @@
  ******************************/
 
 
-#include <stdio.h>
-#include <ctype.h>
 #include <gpac/tools.h>
 #include <gpac/internal/reedsolomon.h>
 
@@ -25,75 +23,183 @@
 /* x^8 + x^4 + x^3 + x^2 + 1 */
 #define PPOLY 0x1D
 
+/*polynomials of the decoder hold up to twice the number of parity bytes coefficients*/
+#define RS_MAX_DEG	(2*GF_RS_MAX_CODEWORD)
 
-int gexp[512];
-int glog[256];
-
-
-static void init_exp_table (void);
+struct __gf_rs_codec
+{
+	u32 nb_parity;
+	/*powers of alpha, doubled so that the sum of two logs needs no modulo*/
+	u8 gexp[512];
+	u8 glog[256];
+
+	/*multiplication tables by a constant: gen_mul[j*256 + x] is genPoly[j]*x and syn_mul[j*256 + x] is alpha^(j+1)*x.
+	They turn the encoder LFSR and the syndrome computation into one lookup per byte and parity byte*/
+	u8 *gen_mul;
+	u8 *syn_mul;
+
+	/*decoder state*/
+	u8 synBytes[RS_MAX_DEG];
+	u8 Lambda[RS_MAX_DEG];
+	u8 Omega[RS_MAX_DEG];
+	u32 ErrorLocs[GF_RS_MAX_CODEWORD];
+	u32 NErrors;
+	u32 ErasureLocs[GF_RS_MAX_CODEWORD];
+	u32 NErasures;
+};
+
+static GFINLINE u8 gmult(GF_RSCodec *rs, u8 a, u8 b)
+{
+	if (!a || !b) return 0;
+	return rs->gexp[rs->glog[a] + rs->glog[b]];
+}
 
+static GFINLINE u8 ginv(GF_RSCodec *rs, u8 elt)
+{
+	return rs->gexp[255 - rs->glog[elt]];
+}
 
-void
-init_galois_tables (void)
+static void init_galois_tables(GF_RSCodec *rs)
 {
-	/* initialize the table of powers of alpha */
-	init_exp_table();
+	u32 i, x = 1;
+	for (i=0; i<255; i++) {
+		rs->gexp[i] = rs->gexp[i+255] = x;
+		rs->glog[x] = i;
+		x <<= 1;
+		if (x & 0x100) x ^= 0x100 | PPOLY;
+	}
+	/* shouldn't log[0] be an error? */
+	rs->glog[0] = 0;
 }
 
+static void build_mult_table(GF_RSCodec *rs, u8 *table, u8 k)
+{
+	u32 x;
+	for (x=0; x<256; x++) table[x] = gmult(rs, k, x);
+}
 
-static void
-init_exp_table (void)
+/* Create a generator polynomial for an n byte RS code, product of (x + a^i) for i = 1 to n */
+static void compute_genpoly(GF_RSCodec *rs, u8 genpoly[])
 {
-	int i, z;
-	int pinit,p1,p2,p3,p4,p5,p6,p7,p8;
-
-	pinit = p2 = p3 = p4 = p5 = p6 = p7 = p8 = 0;
-	p1 = 1;
-
-	gexp[0] = 1;
-	gexp[255] = gexp[0];
-	glog[0] = 0;			/* shouldn't log[0] be an error? */
-
-	for (i = 1; i < 256; i++) {
-		pinit = p8;
-		p8 = p7;
-		p7 = p6;
-		p6 = p5;
-		p5 = p4 ^ pinit;
-		p4 = p3 ^ pinit;
-		p3 = p2 ^ pinit;
-		p2 = p1;
-		p1 = pinit;
-		gexp[i] = p1 + p2*2 + p3*4 + p4*8 + p5*16 + p6*32 + p7*64 + p8*128;
-		gexp[i+255] = gexp[i];
+	u32 i, j;
+	memset(genpoly, 0, sizeof(u8)*(rs->nb_parity+1));
+	genpoly[0] = 1;
+	for (i=1; i<=rs->nb_parity; i++) {
+		u8 root = rs->gexp[i];
+		for (j=i; j>0; j--) {
+			genpoly[j] = genpoly[j-1] ^ gmult(rs, genpoly[j], root);
+		}
+		genpoly[0] = gmult(rs, genpoly[0], root);
 	}
+}
 
-	for (i = 1; i < 256; i++) {
-		for (z = 0; z < 256; z++) {
-			if (gexp[z] == i) {
-				glog[i] = z;
-				break;
-			}
-		}
+GF_EXPORT
+GF_RSCodec *gf_rs_new(u32 nb_parity)
+{
+	u32 j;
+	u8 genpoly[GF_RS_MAX_CODEWORD+1];
+	GF_RSCodec *rs;
+	if (!nb_parity || (nb_parity >= GF_RS_MAX_CODEWORD)) return NULL;
+
+	GF_SAFEALLOC(rs, GF_RSCodec);
+	if (!rs) return NULL;
+	rs->nb_parity = nb_parity;
+	rs->gen_mul = (u8 *)gf_malloc(sizeof(u8) * 256 * nb_parity);
+	rs->syn_mul = (u8 *)gf_malloc(sizeof(u8) * 256 * nb_parity);
+	if (!rs->gen_mul || !rs->syn_mul) {
+		gf_rs_del(rs);
+		return NULL;
 	}
+	init_galois_tables(rs);
+	compute_genpoly(rs, genpoly);
+	for (j=0; j<nb_parity; j++) {
+		build_mult_table(rs, rs->gen_mul + 256*j, genpoly[j]);
+		build_mult_table(rs, rs->syn_mul + 256*j, rs->gexp[j+1]);
+	}
+	return rs;
 }
 
-/* multiplication using logarithms */
-int gmult(int a, int b)
+GF_EXPORT
+void gf_rs_del(GF_RSCodec *rs)
 {
-	int i,j;
-	if (a==0 || b == 0) return (0);
-	i = glog[a];
-	j = glog[b];
-	return (gexp[i+j]);
+	if (!rs) return;
+	if (rs->gen_mul) gf_free(rs->gen_mul);
+	if (rs->syn_mul) gf_free(rs->syn_mul);
+	gf_free(rs);
 }
 
+GF_EXPORT
+u32 gf_rs_get_parity_size(GF_RSCodec *rs)
+{
+	return rs ? rs->nb_parity : 0;
+}
 
-int ginv (int elt)
+/* Simulate a LFSR with generator polynomial for n byte RS code.
+ * The parity bytes are stored highest degree first, as appended to the message in a codeword. */
+GF_EXPORT
+GF_Err gf_rs_encode(GF_RSCodec *rs, const u8 *msg, u32 msg_size, u8 *parity)
 {
-	return (gexp[255-glog[elt]]);
+	u32 i, j, npar;
+	u8 LFSR[GF_RS_MAX_CODEWORD];
+	if (!rs || !msg || !parity) return GF_BAD_PARAM;
+	npar = rs->nb_parity;
+	if (msg_size + npar > GF_RS_MAX_CODEWORD) return GF_BAD_PARAM;
+
+	memset(LFSR, 0, sizeof(u8)*npar);
+	for (i=0; i<msg_size; i++) {
+		const u8 *mul = rs->gen_mul + 256*(npar-1);
+		u8 dbyte = msg[i] ^ LFSR[npar-1];
+		for (j=npar-1; j>0; j--) {
+			LFSR[j] = LFSR[j-1] ^ mul[dbyte];
+			mul -= 256;
+		}
+		LFSR[0] = mul[dbyte];
+	}
+	for (i=0; i<npar; i++) parity[i] = LFSR[npar-1-i];
+	return GF_OK;
 }
 
+/* Computes the syndrome of a codeword and returns GF_TRUE if it is not null.
+ * Each syndrome is a Horner evaluation of the codeword, i.e. a chain of dependent table lookups: eight
+ * syndromes are computed at once so that their chains overlap */
+static Bool compute_syndromes(GF_RSCodec *rs, const u8 *data, u32 nbytes)
+{
+	u32 i, j, npar = rs->nb_parity;
+	u8 nz = 0;
+	u8 *S = rs->synBytes;
+
+	for (j=0; j+8<=npar; j+=8) {
+		const u8 *m = rs->syn_mul + 256*j;
+		u32 s0=0, s1=0, s2=0, s3=0, s4=0, s5=0, s6=0, s7=0;
+		for (i=0; i<nbytes; i++) {
+			u32 d = data[i];
+			s0 = d ^ m[s0];
+			s1 = d ^ m[256 + s1];
+			s2 = d ^ m[512 + s2];
+			s3 = d ^ m[768 + s3];
+			s4 = d ^ m[1024 + s4];
+			s5 = d ^ m[1280 + s5];
+			s6 = d ^ m[1536 + s6];
+			s7 = d ^ m[1792 + s7];
+		}
+		S[j] = s0;
+		S[j+1] = s1;
+		S[j+2] = s2;
+		S[j+3] = s3;
+		S[j+4] = s4;
+		S[j+5] = s5;
+		S[j+6] = s6;
+		S[j+7] = s7;
+	}
+	for (; j<npar; j++) {
+		const u8 *m = rs->syn_mul + 256*j;
+		u32 sum = 0;
+		for (i=0; i<nbytes; i++) sum = data[i] ^ m[sum];
+		S[j] = sum;
+	}
+	for (j=0; j<npar; j++) nz |= S[j];
+	return nz ? GF_TRUE : GF_FALSE;
+}
 
 
 /***********************************************************************
@@ -111,466 +217,213 @@ int ginv (int elt)
  * hqm@ai.mit.edu   Henry Minsky
  */
 
+/* multiply by z, i.e., shift right by 1 */
+static void mul_z_poly(u8 src[], u32 size)
+{
+	memmove(src+1, src, sizeof(u8)*(size-1));
+	src[0] = 0;
+}
 
-/* The Error Locator Polynomial, also known as Lambda or Sigma. Lambda[0] == 1 */
-static int Lambda[MAXDEG];
-
-/* The Error Evaluator Polynomial */
-static int Omega[MAXDEG];
-
-/* local ANSI declarations */
-static int compute_discrepancy(int lambda[], int S[], int L, int n);
-static void init_gamma(int gamma[]);
-static void compute_modified_omega (void);
-static void mul_z_poly (int src[]);
-
-/* error locations found using Chien's search*/
-static int ErrorLocs[256];
-static int NErrors;
+/* gamma = product (1-z*a^Ij) for erasure locs Ij */
+static void init_gamma(GF_RSCodec *rs, u8 gamma[], u32 size)
+{
+	u32 e, i;
+	memset(gamma, 0, sizeof(u8)*size);
+	gamma[0] = 1;
 
-/* erasure flags */
-static int ErasureLocs[256];
-static int NErasures;
+	for (e=0; e<rs->NErasures; e++) {
+		u8 x = rs->gexp[rs->ErasureLocs[e]];
+		for (i=size-1; i>0; i--) gamma[i] ^= gmult(rs, gamma[i-1], x);
+	}
+}
 
-/* From  Cain, Clark, "Error-Correction Coding For Digital Communications", pp. 216. */
-void
-Modified_Berlekamp_Massey (void)
+/* From  Cain, Clark, "Error-Correction Coding For Digital Communications", pp. 216.
+ * deg_psi and deg_D bound the degrees of psi and D so that only their significant coefficients are processed */
+static void Modified_Berlekamp_Massey(GF_RSCodec *rs)
 {
-	int n, L, L2, k, d, i;
-	int psi[MAXDEG], psi2[MAXDEG], D[MAXDEG];
-	int gamma[MAXDEG];
+	s32 n, L, L2, k;
+	u32 i, j, deg_psi, deg_D, size = 2*rs->nb_parity;
+	u8 d;
+	u8 psi[RS_MAX_DEG], D[RS_MAX_DEG];
+	u8 *S = rs->synBytes;
 
 	/* initialize Gamma, the erasure locator polynomial */
-	init_gamma(gamma);
+	init_gamma(rs, psi, size);
+	deg_psi = rs->NErasures;
 
 	/* initialize to z */
-	copy_poly(D, gamma);
-	mul_z_poly(D);
+	memcpy(D, psi, sizeof(u8)*size);
+	mul_z_poly(D, size);
+	deg_D = MIN(deg_psi+1, size-1);
 
-	copy_poly(psi, gamma);
 	k = -1;
-	L = NErasures;
-
-	for (n = NErasures; n < NPAR; n++) {
+	L = rs->NErasures;
 
-		d = compute_discrepancy(psi, synBytes, L, n);
+	for (n=rs->NErasures; n<(s32) rs->nb_parity; n++) {
+		/*discrepancy*/
+		d = 0;
+		for (i=0; i<=(u32) L; i++)
+			d ^= gmult(rs, psi[i], S[n-i]);
 
 		if (d != 0) {
-
-			/* psi2 = psi - d*D */
-			for (i = 0; i < MAXDEG; i++) psi2[i] = psi[i] ^ gmult(d, D[i]);
-
-
 			if (L < (n-k)) {
+				u32 deg = MAX(deg_psi, deg_D);
+				u8 inv_d = ginv(rs, d);
 				L2 = n-k;
 				k = n-L;
-				/* D = scale_poly(ginv(d), psi); */
-				for (i = 0; i < MAXDEG; i++) D[i] = gmult(psi[i], ginv(d));
+				/* psi = psi - d*D and D = psi / d */
+				for (i=0; i<=deg; i++) {
+					u8 p = psi[i];
+					psi[i] ^= gmult(rs, d, D[i]);
+					D[i] = gmult(rs, p, inv_d);
+				}
+				deg_D = deg_psi;
+				deg_psi = deg;
 				L = L2;
+			} else {
+				/* psi = psi - d*D */
+				for (i=0; i<=deg_D; i++) psi[i] ^= gmult(rs, d, D[i]);
+				deg_psi = MAX(deg_psi, deg_D);
 			}
-
-			/* psi = psi2 */
-			for (i = 0; i < MAXDEG; i++) psi[i] = psi2[i];
 		}
-
-		mul_z_poly(D);
+		mul_z_poly(D, size);
+		deg_D = MIN(deg_D+1, size-1);
 	}
 
-	for(i = 0; i < MAXDEG; i++) Lambda[i] = psi[i];
-	compute_modified_omega();
-
+	memcpy(rs->Lambda, psi, sizeof(u8)*size);
 
-}
-
-/* given Psi (called Lambda in Modified_Berlekamp_Massey) and synBytes,
-   compute the combined erasure/error evaluator polynomial as
-   Psi*S mod z^4
-  */
-void
-compute_modified_omega ()
-{
-	int i;
-	int product[MAXDEG*2];
-
-	mult_polys(product, Lambda, synBytes);
-	zero_poly(Omega);
-	for(i = 0; i < NPAR; i++) Omega[i] = product[i];
-
-}
-
-/* polynomial multiplication */
-void
-mult_polys (int dst[], int p1[], int p2[])
-{
-	int i, j;
-	int tmp1[MAXDEG*2];
-
-	for (i=0; i < (MAXDEG*2); i++) dst[i] = 0;
-
-	for (i = 0; i < MAXDEG; i++) {
-		for(j=MAXDEG; j<(MAXDEG*2); j++) tmp1[j]=0;
-
-		/* scale tmp1 by p1[i] */
-		for(j=0; j<MAXDEG; j++) tmp1[j]=gmult(p2[j], p1[i]);
-		/* and mult (shift) tmp1 right by i */
-		for (j = (MAXDEG*2)-1; j >= i; j--) tmp1[j] = tmp1[j-i];
-		for (j = 0; j < i; j++) tmp1[j] = 0;
-
-		/* add into partial product */
-		for(j=0; j < (MAXDEG*2); j++) dst[j] ^= tmp1[j];
+	/* compute the combined erasure/error evaluator polynomial as Psi*S mod z^NPAR */
+	memset(rs->Omega, 0, sizeof(u8)*size);
+	for (i=0; i<rs->nb_parity; i++) {
+		if (!psi[i]) continue;
+		for (j=0; i+j<rs->nb_parity; j++) {
+			rs->Omega[i+j] ^= gmult(rs, psi[i], S[j]);
+		}
 	}
 }
 
-
-
-/* gamma = product (1-z*a^Ij) for erasure locs Ij */
-void
-init_gamma (int gamma[])
+/* Finds all the roots of the error-locator polynomial within the codeword using Chien's search: Lambda
+ * is evaluated at successive values of alpha, each term being updated by one multiplication in the log domain.
+ * Returns the degree of Lambda */
+static u32 Find_Roots(GF_RSCodec *rs, u32 csize)
 {
-	int e, tmp[MAXDEG];
-
-	zero_poly(gamma);
-	zero_poly(tmp);
-	gamma[0] = 1;
+	u32 k, r, deg = 0;
+	u32 lg[RS_MAX_DEG];
+	u8 *Lambda = rs->Lambda;
 
-	for (e = 0; e < NErasures; e++) {
-		copy_poly(tmp, gamma);
-		scale_poly(gexp[ErasureLocs[e]], tmp);
-		mul_z_poly(tmp);
-		add_polys(gamma, tmp);
+	for (k=0; k<2*rs->nb_parity; k++) {
+		if (Lambda[k]) deg = k;
 	}
-}
-
-
+	rs->NErrors = 0;
+	if (!deg || (deg > rs->nb_parity)) return deg;
 
-void
-compute_next_omega (int d, int A[], int dst[], int src[])
-{
-	int i;
-	for ( i = 0; i < MAXDEG;  i++) {
-		dst[i] = src[i] ^ gmult(d, A[i]);
+	/*start at r = 256 - csize, i.e. location csize-1; lg[k] is the log of Lambda[k]*a^(k*r)*/
+	r = 256 - csize;
+	for (k=1; k<=deg; k++) {
+		if (Lambda[k]) lg[k] = (rs->glog[Lambda[k]] + k*r) % 255;
 	}
-}
-
-
-
-int
-compute_discrepancy (int lambda[], int S[], int L, int n)
-{
-	int i, sum=0;
-
-	for (i = 0; i <= L; i++)
-		sum ^= gmult(lambda[i], S[n-i]);
-	return (sum);
-}
-
-/********** polynomial arithmetic *******************/
-
-void add_polys (int dst[], int src[])
-{
-	int i;
-	for (i = 0; i < MAXDEG; i++) dst[i] ^= src[i];
-}
-
-void copy_poly (int dst[], int src[])
-{
-	int i;
-	for (i = 0; i < MAXDEG; i++) dst[i] = src[i];
-}
-
-void scale_poly (int k, int poly[])
-{
-	int i;
-	for (i = 0; i < MAXDEG; i++) poly[i] = gmult(k, poly[i]);
-}
-
-
-void zero_poly (int poly[])
-{
-	int i;
-	for (i = 0; i < MAXDEG; i++) poly[i] = 0;
-}
-
-
-/* multiply by z, i.e., shift right by 1 */
-static void mul_z_poly (int src[])
-{
-	int i;
-	for (i = MAXDEG-1; i > 0; i--) src[i] = src[i-1];
-	src[0] = 0;
-}
-
-
-/* Finds all the roots of an error-locator polynomial with coefficients
- * Lambda[j] by evaluating Lambda at successive values of alpha.
- *
- * This can be tested with the decoder's equations case.
- */
-
-
-void
-Find_Roots (void)
-{
-	int sum, r, k;
-	NErrors = 0;
-
-	for (r = 1; r < 256; r++) {
-		sum = 0;
-		/* evaluate lambda at r */
-		for (k = 0; k < NPAR+1; k++) {
-			sum ^= gmult(gexp[(k*r)%255], Lambda[k]);
+	for (; r<256; r++) {
+		u8 sum = Lambda[0];
+		for (k=1; k<=deg; k++) {
+			if (!Lambda[k]) continue;
+			sum ^= rs->gexp[lg[k]];
+			lg[k] += k;
+			if (lg[k] >= 255) lg[k] -= 255;
 		}
-		if (sum == 0)
-		{
-			ErrorLocs[NErrors] = (255-r);
-			NErrors++;
-			if (RS_DEBUG) fprintf(stderr, "Root found at r = %d, (255-r) = %d\n", r, (255-r));
+		if (!sum) {
+			rs->ErrorLocs[rs->NErrors] = 255-r;
+			rs->NErrors++;
+			if (rs->NErrors == deg) break;
 		}
 	}
+	return deg;
 }
 
 /* Combined Erasure And Error Magnitude Computation
- *
- * Pass in the codeword, its size in bytes, as well as
- * an array of any known erasure locations, along the number
- * of these erasures.
  *
  * Evaluate Omega(actually Psi)/Lambda' at the roots
  * alpha^(-i) for error locs i.
  *
- * Returns 1 if everything ok, or 0 if an out-of-bounds error is found
- *
+ * The codeword is only modified if all error locations are within the codeword
+ * and all magnitudes can be computed.
  */
-
-int
-correct_errors_erasures (unsigned char codeword[],
-                         int csize,
-                         int nerasures,
-                         int erasures[])
+GF_EXPORT
+GF_Err gf_rs_decode(GF_RSCodec *rs, u8 *codeword, u32 csize, const u32 *erasures, u32 nb_erasures, u32 *nb_corrected)
 {
-	int r, i, j, err;
-
-	/* If you want to take advantage of erasure correction, be sure to
-	   set NErasures and ErasureLocs[] with the locations of erasures.
-	   */
-	NErasures = nerasures;
-	for (i = 0; i < NErasures; i++) ErasureLocs[i] = erasures[i];
+	u32 r, i, j, deg, npar, nb_fixed;
+	u8 err[GF_RS_MAX_CODEWORD], check[GF_RS_MAX_CODEWORD];
 
-	Modified_Berlekamp_Massey();
-	Find_Roots();
+	if (nb_corrected) *nb_corrected = 0;
+	if (!rs || !codeword || (nb_erasures && !erasures)) return GF_BAD_PARAM;
+	npar = rs->nb_parity;
+	if ((csize <= npar) || (csize > GF_RS_MAX_CODEWORD)) return GF_BAD_PARAM;
 
+	if (!compute_syndromes(rs, codeword, csize)) return GF_OK;
 
-	if ((NErrors <= NPAR) && NErrors > 0) {
-
-		/* first check for illegal error locs */
-		for (r = 0; r < NErrors; r++) {
-			if (ErrorLocs[r] >= csize) {
-				if (RS_DEBUG) fprintf(stderr, "Error loc i=%d outside of codeword length %d\n", i, csize);
-				return(0);
-			}
-		}
-
-		for (r = 0; r < NErrors; r++) {
-			int num, denom;
-			i = ErrorLocs[r];
-			/* evaluate Omega at alpha^(-i) */
-
-			num = 0;
-			for (j = 0; j < MAXDEG; j++)
-				num ^= gmult(Omega[j], gexp[((255-i)*j)%255]);
-
-			/* evaluate Lambda' (derivative) at alpha^(-i) ; all odd powers disappear */
-			denom = 0;
-			for (j = 1; j < MAXDEG; j += 2) {
-				denom ^= gmult(Lambda[j], gexp[((255-i)*(j-1)) % 255]);
-			}
-
-			err = gmult(num, ginv(denom));
-			if (RS_DEBUG) fprintf(stderr, "Error magnitude %#x at loc %d\n", err, csize-i);
-
-			codeword[csize-i-1] ^= err;
-		}
-		return(1);
-	}
-	else {
-		if (RS_DEBUG && NErrors) fprintf(stderr, "Uncorrectable codeword\n");
-		return(0);
+	if (nb_erasures > npar) return GF_CORRUPTED_DATA;
+	rs->NErasures = nb_erasures;
+	for (i=0; i<nb_erasures; i++) {
+		if (erasures[i] >= csize) return GF_BAD_PARAM;
+		rs->ErasureLocs[i] = csize - 1 - erasures[i];
 	}
-}
-
-
-
-/*
- * Reed Solomon Encoder/Decoder
- *
- * (c) Henry Minsky (hqm@ua.com), Universal Access 1991-1995
- */
-
-/* Encoder parity bytes */
-int pBytes[MAXDEG];
-
-/* Decoder syndrome bytes */
-int synBytes[MAXDEG];
 
-/* generator polynomial */
-int genPoly[MAXDEG*2];
+	Modified_Berlekamp_Massey(rs);
+	deg = Find_Roots(rs, csize);
 
-int RS_DEBUG = FALSE;
-
-static void
-compute_genpoly (int nbytes, int genpoly[]);
-
-/* Initialize lookup tables, polynomials, etc. */
-void
-initialize_ecc ()
-{
-	/* Initialize the galois field arithmetic tables */
-	init_galois_tables();
-
-	/* Compute the encoder generator polynomial */
-	compute_genpoly(NPAR, genPoly);
-}
-
-void
-zero_fill_from (unsigned char buf[], int from, int to)
-{
-	int i;
-	for (i = from; i < to; i++) buf[i] = 0;
-}
-
-/* debugging routines */
-void
-print_parity (void)
-{
-	int i;
-	fprintf(stderr, "Parity Bytes: ");
-	for (i = 0; i < NPAR; i++)
-		fprintf(stderr, "[%d]:%x, ",i,pBytes[i]);
-	fprintf(stderr, "\n");
-}
-
-
-void
-print_syndrome (void)
-{
-	int i;
-	fprintf(stderr, "Syndrome Bytes: ");
-	for (i = 0; i < NPAR; i++)
-		fprintf(stderr, "[%d]:%x, ",i,synBytes[i]);
-	fprintf(stderr, "\n");
-}
-
-/* Append the parity bytes onto the end of the message */
-void
-build_codeword (unsigned char msg[], int nbytes, unsigned char dst[])
-{
-	int i;
-
-	for (i = 0; i < nbytes; i++) dst[i] = msg[i];
-
-	for (i = 0; i < NPAR; i++) {
-		dst[i+nbytes] = pBytes[NPAR-1-i];
-	}
-}
-
-/**********************************************************
- * Reed Solomon Decoder
- *
- * Computes the syndrome of a codeword. Puts the results
- * into the synBytes[] array.
- */
-
-void
-decode_data(unsigned char data[], int nbytes)
-{
-	int i, j, sum;
-	for (j = 0; j < NPAR;  j++) {
-		sum = 0;
-		for (i = 0; i < nbytes; i++) {
-			sum = data[i] ^ gmult(gexp[j+1], sum);
-		}
-		synBytes[j]  = sum;
+	/*no root, a root outside of the codeword or more errors than the code can correct with these erasures*/
+	if (!deg || (2*deg > npar + nb_erasures) || (rs->NErrors != deg)) {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_CODING, ("[RS] Uncorrectable codeword: %d roots found in codeword for error locator of degree %d\n", rs->NErrors, deg));
+		return GF_CORRUPTED_DATA;
 	}
-}
 
+	for (r=0; r<rs->NErrors; r++) {
+		u8 num, denom;
+		u32 inv_loc;
+		i = rs->ErrorLocs[r];
+		inv_loc = (255-i) % 255;
 
-/* Check if the syndrome is zero */
-int
-check_syndrome (void)
-{
-	int i, nz = 0;
-	for (i =0 ; i < NPAR; i++) {
-		if (synBytes[i] != 0) nz = 1;
-	}
-	return nz;
-}
+		/* evaluate Omega at alpha^(-i) */
+		num = 0;
+		for (j=0; j<npar; j++)
+			num ^= gmult(rs, rs->Omega[j], rs->gexp[(inv_loc*j) % 255]);
 
+		/* evaluate Lambda' (derivative) at alpha^(-i) ; all odd powers disappear */
+		denom = 0;
+		for (j=1; j<=deg; j+=2)
+			denom ^= gmult(rs, rs->Lambda[j], rs->gexp[(inv_loc*(j-1)) % 255]);
 
-void
-debug_check_syndrome (void)
-{
-	int i;
-
-	for (i = 0; i < 3; i++) {
-		fprintf(stderr, " inv log S[%d]/S[%d] = %d\n", i, i+1,
-		        glog[gmult(synBytes[i], ginv(synBytes[i+1]))]);
+		if (!denom) return GF_CORRUPTED_DATA;
+		err[r] = gmult(rs, num, ginv(rs, denom));
 	}
-}
-
-
-/* Create a generator polynomial for an n byte RS code.
- * The coefficients are returned in the genPoly arg.
- * Make sure that the genPoly array which is passed in is
- * at least n+1 bytes long.
- */
-
-static void
-compute_genpoly (int nbytes, int genpoly[])
-{
-	int i, tp[256], tp1[256];
 
-	/* multiply (x + a^n) for n = 1 to nbytes */
-
-	zero_poly(tp1);
-	tp1[0] = 1;
-
-	for (i = 1; i <= nbytes; i++) {
-		zero_poly(tp);
-		tp[0] = gexp[i];        /* set up x+a^n */
-		tp[1] = 1;
-
-		mult_polys(genpoly, tp, tp1);
-		copy_poly(tp1, genpoly);
+	/*beyond the code capacity the error pattern found may not lead to a codeword: check that removing it from
+	the syndromes clears them, an error of value e at location i contributing e*a^(i*(j+1)) to syndrome j*/
+	memcpy(check, rs->synBytes, sizeof(u8)*npar);
+	for (r=0; r<rs->NErrors; r++) {
+		u32 lg, loc = rs->ErrorLocs[r];
+		if (!err[r]) continue;
+		lg = (rs->glog[err[r]] + loc) % 255;
+		for (j=0; j<npar; j++) {
+			check[j] ^= rs->gexp[lg];
+			lg += loc;
+			if (lg >= 255) lg -= 255;
+		}
 	}
-}
-
-/* Simulate a LFSR with generator polynomial for n byte RS code.
- * Pass in a pointer to the data array, and amount of data.
- *
- * The parity bytes are deposited into pBytes[], and the whole message
- * and parity are copied to dest to make a codeword.
- *
- */
-
-void
-encode_data (unsigned char msg[], int nbytes, unsigned char dst[])
-{
-	int i, LFSR[NPAR+1],dbyte, j;
-
-	for(i=0; i < NPAR+1; i++) LFSR[i]=0;
-
-	for (i = 0; i < nbytes; i++) {
-		dbyte = msg[i] ^ LFSR[NPAR-1];
-		for (j = NPAR-1; j > 0; j--) {
-			LFSR[j] = LFSR[j-1] ^ gmult(genPoly[j], dbyte);
+	for (j=0; j<npar; j++) {
+		if (check[j]) {
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_CODING, ("[RS] Uncorrectable codeword: error pattern found does not lead to a codeword\n"));
+			return GF_CORRUPTED_DATA;
 		}
-		LFSR[0] = gmult(genPoly[0], dbyte);
 	}
 
-	for (i = 0; i < NPAR; i++)
-		pBytes[i] = LFSR[i];
-
-	build_codeword(msg, nbytes, dst);
+	nb_fixed = 0;
+	for (r=0; r<rs->NErrors; r++) {
+		if (!err[r]) continue;
+		codeword[csize - rs->ErrorLocs[r] - 1] ^= err[r];
+		nb_fixed++;
+	}
+	if (nb_corrected) *nb_corrected = nb_fixed;
+	return GF_OK;
 }
 
 #endif //GPAC_ENABLE_MPE
@@ -29,24 +29,48 @@
 		Object GF_Descriptor Codec Functions
 ************************************************************/
 
+/*commands retrieved by gf_odf_codec_get_com are not removed one at a time from the head of the command list, since
+each removal moves the whole list: they are skipped and only removed once all commands are retrieved or the codec is
+used again*/
+typedef struct
+{
+	GF_ODCodec codec;
+	u32 com_read;
+} GF_ODCodecPriv;
+
+static void gf_odf_codec_purge_read(GF_ODCodec *codec)
+{
+	GF_ODCodecPriv *priv = (GF_ODCodecPriv *)codec;
+	if (!priv->com_read) return;
+	if (priv->com_read >= gf_list_count(codec->CommandList)) {
+		gf_list_reset(codec->CommandList);
+	} else {
+		while (priv->com_read) {
+			gf_list_rem(codec->CommandList, 0);
+			priv->com_read--;
+		}
+	}
+	priv->com_read = 0;
+}
+
 GF_EXPORT
 GF_ODCodec *gf_odf_codec_new()
 {
-	GF_ODCodec *codec;
+	GF_ODCodecPriv *codec;
 	GF_List *comList;
 
 	comList = gf_list_new();
 	if (!comList) return NULL;
 
-	codec = (GF_ODCodec *) gf_malloc(sizeof(GF_ODCodec));
+	GF_SAFEALLOC(codec, GF_ODCodecPriv);
 	if (!codec) {
 		gf_list_del(comList);
 		return NULL;
 	}
 	//the bitstream is always NULL. It is created on the fly for access unit processing only
-	codec->bs = NULL;
-	codec->CommandList = comList;
-	return codec;
+	codec->codec.bs = NULL;
+	codec->codec.CommandList = comList;
+	return (GF_ODCodec *)codec;
 }
 
 GF_EXPORT
@@ -54,10 +78,11 @@ void gf_odf_codec_del(GF_ODCodec *codec)
 {
 	if (!codec) return;
 
+	//retrieved commands belong to the caller
+	gf_odf_codec_purge_read(codec);
 	while (gf_list_count(codec->CommandList)) {
-		GF_ODCom *com = (GF_ODCom *)gf_list_get(codec->CommandList, 0);
+		GF_ODCom *com = (GF_ODCom *)gf_list_pop_back(codec->CommandList);
 		gf_odf_delete_command(com);
-		gf_list_rem(codec->CommandList, 0);
 	}
 	gf_list_del(codec->CommandList);
 	if (codec->bs) gf_bs_del(codec->bs);
@@ -73,6 +98,7 @@ GF_EXPORT
 GF_Err gf_odf_codec_add_com(GF_ODCodec *codec, GF_ODCom *command)
 {
 	if (!codec || !command) return GF_BAD_PARAM;
+	gf_odf_codec_purge_read(codec);
 	return gf_list_add(codec->CommandList, command);
 }
 
@@ -88,6 +114,7 @@ GF_Err gf_odf_codec_encode(GF_ODCodec *codec, u32 cleanup_type)
 	//check our bitstream: if existing, this means the previous encoded AU was not retrieved
 	//we DON'T allow that
 	if (codec->bs) return GF_BAD_PARAM;
+	gf_odf_codec_purge_read(codec);
 	codec->bs = gf_bs_new(NULL, 0, GF_BITSTREAM_WRITE);
 	if (!codec->bs) return GF_OUT_OF_MEM;
 
@@ -108,9 +135,8 @@ err_exit:
 	}
 	if (cleanup_type==1) {
 		while (gf_list_count(codec->CommandList)) {
-			com = (GF_ODCom *)gf_list_get(codec->CommandList, 0);
+			com = (GF_ODCom *)gf_list_pop_back(codec->CommandList);
 			gf_odf_delete_command(com);
-			gf_list_rem(codec->CommandList, 0);
 		}
 	}
 	if (cleanup_type==0) {
@@ -141,6 +167,7 @@ GF_Err gf_odf_codec_set_au(GF_ODCodec *codec, const char *au, u32 au_length)
 	if (!codec ) return GF_BAD_PARAM;
 	if (!au || !au_length) return GF_OK;
 
+	gf_odf_codec_purge_read(codec);
 	//if the command list is not empty, this is an error
 	if (gf_list_count(codec->CommandList)) return GF_BAD_PARAM;
 
@@ -161,6 +188,7 @@ GF_Err gf_odf_codec_decode(GF_ODCodec *codec)
 	GF_ODCom *com;
 
 	if (!codec || !codec->bs) return GF_BAD_PARAM;
+	gf_odf_codec_purge_read(codec);
 
 	bufSize = (u32) gf_bs_available(codec->bs);
 	while (size < bufSize) {
@@ -186,9 +214,8 @@ err_exit:
 		codec->bs = NULL;
 	}
 	while (gf_list_count(codec->CommandList)) {
-		com = (GF_ODCom*)gf_list_get(codec->CommandList, 0);
+		com = (GF_ODCom*)gf_list_pop_back(codec->CommandList);
 		gf_odf_delete_command(com);
-		gf_list_rem(codec->CommandList, 0);
 	}
 	return e;
 }
@@ -198,9 +225,15 @@ GF_EXPORT
 GF_ODCom *gf_odf_codec_get_com(GF_ODCodec *codec)
 {
 	GF_ODCom *com;
+	GF_ODCodecPriv *priv = (GF_ODCodecPriv *)codec;
 	if (!codec || codec->bs) return NULL;
-	com = (GF_ODCom*)gf_list_get(codec->CommandList, 0);
-	if (com) gf_list_rem(codec->CommandList, 0);
+	com = (GF_ODCom*)gf_list_get(codec->CommandList, priv->com_read);
+	if (!com) {
+		gf_odf_codec_purge_read(codec);
+		return NULL;
+	}
+	priv->com_read++;
+	if (priv->com_read == gf_list_count(codec->CommandList)) gf_odf_codec_purge_read(codec);
 	return com;
 }
 
@@ -535,6 +568,7 @@ GF_Err gf_odf_codec_apply_com(GF_ODCodec *codec, GF_ODCom *command)
 	GF_ODCom *com;
 	GF_ODUpdate *odU, *odU_o;
 	u32 i, count;
+	gf_odf_codec_purge_read(codec);
 	count = gf_list_count(codec->CommandList);
 
 	switch (command->tag) {
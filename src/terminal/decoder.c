@@ -994,7 +994,9 @@ check_unit:
 	if (codec->odm->term->bench_mode==2) {
 		e = GF_OK;
 	} else {
+		GF_TRACE(GF_TRACE_BEGIN, GF_LOG_CODEC, "decode_scene", 0);
 		e = sdec->ProcessData(sdec, AU->data, AU->dataLength, ch->esd->ESID, au_time, mm_level);
+		GF_TRACE(GF_TRACE_END, GF_LOG_CODEC, "decode_scene", 0);
 	}
 	now = gf_sys_clock_high_res() - now;
 
@@ -1521,7 +1523,9 @@ scalable_retry:
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_CODEC, ("[%s] ODM%d: force drop requested in fast playback for AU CTS %u\n", codec->decio->module_name, codec->odm->OD->objectDescriptorID, AU->CTS));
 		} else {
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_CODEC, ("[%s] At %u ODM%d ES%d (%s) decoding frame DTS %u CTS %u size %d (%d in channels)\n", codec->decio->module_name, gf_clock_real_time(ch->clock), codec->odm->OD->objectDescriptorID, ch->esd->ESID, ch->odm->net_service->url, AU->DTS, AU->CTS, AU->dataLength, ch->AU_Count));
+			GF_TRACE(GF_TRACE_BEGIN, GF_LOG_CODEC, "decode", 0);
 			e = mdec->ProcessData(mdec, AU->data, AU->dataLength, ch->esd->ESID, &CU->TS, CU->data, &unit_size, AU->PaddingBits, mmlevel);
+			GF_TRACE(GF_TRACE_END, GF_LOG_CODEC, "decode", 0);
 		}
 		now = gf_sys_clock_high_res() - now;
 		if (codec->Status == GF_ESM_CODEC_STOP) {
@@ -26,6 +26,8 @@
 #if defined(__GNUC__) && __GNUC__ >= 4
 #define _GNU_SOURCE
 #endif
+/*the allocator defines gf_malloc and co. and gets the tags of its callers*/
+#undef GF_MEM_TAG
 #include <stdio.h>
 #include <stdarg.h>
 #include <string.h>
@@ -141,36 +143,7 @@ This is only needed when building libgpac and modules when libgpac is not instal
 #endif
 
 /*GPAC memory tracking*/
-#ifndef GPAC_MEMORY_TRACKING
-
-#include <gpac/setup.h>
-GF_EXPORT
-void *gf_malloc(size_t size)
-{
-	return MALLOC(size);
-}
-GF_EXPORT
-void *gf_calloc(size_t num, size_t size_of)
-{
-	return CALLOC(num, size_of);
-}
-GF_EXPORT
-void *gf_realloc(void *ptr, size_t size)
-{
-	return REALLOC(ptr, size);
-}
-GF_EXPORT
-void gf_free(void *ptr)
-{
-	FREE(ptr);
-}
-GF_EXPORT
-char *gf_strdup(const char *str)
-{
-	STRDUP(str);
-}
-
-#else /*GPAC_MEMORY_TRACKING**/
+#ifdef GPAC_MEMORY_TRACKING
 
 
 static void gf_memory_log(unsigned int level, const char *fmt, ...);
@@ -883,8 +856,467 @@ void gf_memory_print()
 	}
 }
 
+
+#endif /*GPAC_MEMORY_TRACKING*/
+
+/*per-subsystem accounting, available in all builds: each allocation is tagged with the GF_MEM_TAG of the compilation
+unit doing the allocation, passed by the gf_malloc and co. macros. The blocks owned by the accounting allocator are kept
+in a table, so that blocks allocated before accounting was enabled or by another allocator are released untouched.
+Counters are updated with atomic operations*/
+
+#include <gpac/thread.h>
+
+#if defined(WIN32)
+#include <windows.h>
+#define MEM_ATOMIC_ADD(_ptr, _val)	InterlockedExchangeAdd64((volatile LONGLONG *) (_ptr), (_val))
+#define MEM_ATOMIC_CAS(_ptr, _old, _new)	(InterlockedCompareExchange64((volatile LONGLONG *) (_ptr), (_new), (_old)) == (_old))
+#define MEM_ATOMIC_RELEASE(_ptr)	InterlockedExchange64((volatile LONGLONG *) (_ptr), 0)
+#define MEM_YIELD()	SwitchToThread()
+#else
+#include <sched.h>
+#define MEM_ATOMIC_ADD(_ptr, _val)	__sync_fetch_and_add((_ptr), (_val))
+#define MEM_ATOMIC_CAS(_ptr, _old, _new)	__sync_bool_compare_and_swap((_ptr), (_old), (_new))
+#define MEM_ATOMIC_RELEASE(_ptr)	__sync_lock_release(_ptr)
+#define MEM_YIELD()	sched_yield()
+#endif
+
+/*one cache line per tag, the number of allocations and deallocations are counted in the shards of the block table*/
+typedef struct
+{
+	volatile s64 current, peak;
+	char padding[48];
+} GF_MemAccCounters;
+
+static GF_MemAccCounters mem_acc_counters[GF_MEM_TAG_MAX];
+static Bool mem_acc_enabled = GF_FALSE;
+
+static const char *mem_acc_tag_names[GF_MEM_TAG_MAX] =
+{
+	"other", "core", "isomedia", "media_tools", "dash", "mpeg2ts", "downloader", "terminal", "compositor", "modules"
+};
+
+/*owned blocks, hashed on their address in shards protected by a spin lock, with linear probing*/
+#define MEM_ACC_SHARDS_BITS	6
+#define MEM_ACC_MIN_SLOTS	256
+
+typedef struct
+{
+	void *ptr;
+	/*size << 4 | tag*/
+	u64 size_tag;
+} GF_MemAccBlock;
+
+/*cache line aligned shards, counters are only modified with the shard locked*/
+typedef struct
+{
+	volatile s64 lock;
+	u32 nb_blocks, mask;
+	GF_MemAccBlock *blocks;
+	u64 nb_alloc[GF_MEM_TAG_MAX], nb_free[GF_MEM_TAG_MAX];
+	char padding[8];
+} GF_MemAccShard;
+
+static GF_MemAccShard mem_acc_shards[1<<MEM_ACC_SHARDS_BITS];
+
+static GFINLINE u64 gf_mem_acc_hash(const void *ptr)
+{
+	return ((u64) (size_t) ptr >> 4) * 0x9E3779B97F4A7C15ULL;
+}
+
+static GFINLINE GF_MemAccShard *gf_mem_acc_shard(u64 hash)
+{
+	return &mem_acc_shards[hash >> (64 - MEM_ACC_SHARDS_BITS)];
+}
+
+static void gf_mem_acc_lock(GF_MemAccShard *shard)
+{
+	u32 nb_spins = 0;
+	while (!MEM_ATOMIC_CAS(&shard->lock, 0, 1)) {
+		/*the owner may not be running*/
+		if (++nb_spins == 100) {
+			MEM_YIELD();
+			nb_spins = 0;
+		}
+	}
+}
+
+static GFINLINE void gf_mem_acc_unlock(GF_MemAccShard *shard)
+{
+	MEM_ATOMIC_RELEASE(&shard->lock);
+}
+
+static Bool gf_mem_acc_grow(GF_MemAccShard *shard)
+{
+	u32 i, nb_slots = shard->blocks ? 2*(shard->mask+1) : MEM_ACC_MIN_SLOTS;
+	GF_MemAccBlock *blocks = (GF_MemAccBlock *) CALLOC(nb_slots, sizeof(GF_MemAccBlock));
+	if (!blocks) return GF_FALSE;
+	if (shard->blocks) {
+		for (i=0; i<=shard->mask; i++) {
+			u32 slot;
+			if (!shard->blocks[i].ptr) continue;
+			slot = (u32) (gf_mem_acc_hash(shard->blocks[i].ptr) >> 20) & (nb_slots-1);
+			while (blocks[slot].ptr) slot = (slot+1) & (nb_slots-1);
+			blocks[slot] = shard->blocks[i];
+		}
+		FREE(shard->blocks);
+	}
+	shard->blocks = blocks;
+	shard->mask = nb_slots-1;
+	return GF_TRUE;
+}
+
+/*is_new is set for allocations, not for reallocations*/
+static Bool gf_mem_acc_insert(void *ptr, u64 size_tag, Bool is_new)
+{
+	u64 hash = gf_mem_acc_hash(ptr);
+	GF_MemAccShard *shard = gf_mem_acc_shard(hash);
+	u32 slot;
+
+	gf_mem_acc_lock(shard);
+	/*keeps the table at most half full*/
+	if (!shard->blocks || (2*(shard->nb_blocks+1) > shard->mask+1)) {
+		if (!gf_mem_acc_grow(shard)) {
+			gf_mem_acc_unlock(shard);
+			return GF_FALSE;
+		}
+	}
+	slot = (u32) (hash >> 20) & shard->mask;
+	while (shard->blocks[slot].ptr) slot = (slot+1) & shard->mask;
+	shard->blocks[slot].ptr = ptr;
+	shard->blocks[slot].size_tag = size_tag;
+	shard->nb_blocks++;
+	if (is_new) shard->nb_alloc[size_tag & 0xF]++;
+	gf_mem_acc_unlock(shard);
+	return GF_TRUE;
+}
+
+/*returns GF_FALSE if the block is not owned by the accounting allocator, is_free is set for deallocations*/
+static Bool gf_mem_acc_remove(void *ptr, u64 *size_tag, Bool is_free)
+{
+	u64 hash = gf_mem_acc_hash(ptr);
+	GF_MemAccShard *shard = gf_mem_acc_shard(hash);
+	GF_MemAccBlock *blocks;
+	u32 slot, next;
+
+	gf_mem_acc_lock(shard);
+	blocks = shard->blocks;
+	if (!blocks) {
+		gf_mem_acc_unlock(shard);
+		return GF_FALSE;
+	}
+	slot = (u32) (hash >> 20) & shard->mask;
+	while (blocks[slot].ptr != ptr) {
+		if (!blocks[slot].ptr) {
+			gf_mem_acc_unlock(shard);
+			return GF_FALSE;
+		}
+		slot = (slot+1) & shard->mask;
+	}
+	*size_tag = blocks[slot].size_tag;
+
+	/*moves back the following blocks which cannot be found anymore once the slot is emptied*/
+	next = slot;
+	while (1) {
+		u32 home;
+		next = (next+1) & shard->mask;
+		if (!blocks[next].ptr) break;
+		home = (u32) (gf_mem_acc_hash(blocks[next].ptr) >> 20) & shard->mask;
+		if ((slot <= next) ? ((slot < home) && (home <= next)) : ((slot < home) || (home <= next)))
+			continue;
+		blocks[slot] = blocks[next];
+		slot = next;
+	}
+	blocks[slot].ptr = NULL;
+	shard->nb_blocks--;
+	if (is_free) shard->nb_free[*size_tag & 0xF]++;
+	gf_mem_acc_unlock(shard);
+	return GF_TRUE;
+}
+
+static void gf_mem_acc_add(u32 tag, s64 size)
+{
+	GF_MemAccCounters *c = &mem_acc_counters[tag];
+	s64 peak, cur = MEM_ATOMIC_ADD(&c->current, size) + size;
+	peak = c->peak;
+	while ((cur > peak) && !MEM_ATOMIC_CAS(&c->peak, peak, cur)) {
+		peak = c->peak;
+	}
+}
+
+static void *gf_mem_acc_register(void *ptr, size_t size, u32 tag)
+{
+	if (!ptr) return NULL;
+	if (!gf_mem_acc_insert(ptr, ((u64) size << 4) | tag, GF_TRUE)) {
+		FREE(ptr);
+		return NULL;
+	}
+	gf_mem_acc_add(tag, (s64) size);
+	return ptr;
+}
+
+static void gf_mem_acc_free(void *ptr)
+{
+	u64 size_tag;
+	if (!ptr) return;
+	if (gf_mem_acc_remove(ptr, &size_tag, GF_TRUE))
+		MEM_ATOMIC_ADD(&mem_acc_counters[size_tag & 0xF].current, - (s64) (size_tag >> 4));
+	FREE(ptr);
+}
+
+/*the block keeps the tag of its first allocation*/
+static void *gf_mem_acc_realloc(void *ptr, size_t size, u32 tag)
+{
+	u64 size_tag, prev_size;
+	void *new_ptr;
+	if (!ptr) return gf_mem_acc_register(MALLOC(size), size, tag);
+	if (!size) {
+		gf_mem_acc_free(ptr);
+		return NULL;
+	}
+	if (!gf_mem_acc_remove(ptr, &size_tag, GF_FALSE)) return REALLOC(ptr, size);
+
+	tag = (u32) (size_tag & 0xF);
+	prev_size = size_tag >> 4;
+	new_ptr = REALLOC(ptr, size);
+	/*the slot just released is available, this cannot fail*/
+	if (!new_ptr) {
+		gf_mem_acc_insert(ptr, size_tag, GF_FALSE);
+		return NULL;
+	}
+	if (!gf_mem_acc_insert(new_ptr, ((u64) size << 4) | tag, GF_FALSE)) {
+		/*the block is not accounted anymore*/
+		GF_MemAccShard *shard = gf_mem_acc_shard(gf_mem_acc_hash(new_ptr));
+		MEM_ATOMIC_ADD(&mem_acc_counters[tag].current, - (s64) prev_size);
+		gf_mem_acc_lock(shard);
+		shard->nb_free[tag]++;
+		gf_mem_acc_unlock(shard);
+		return new_ptr;
+	}
+	if (size > prev_size) gf_mem_acc_add(tag, (s64) (size - prev_size));
+	else MEM_ATOMIC_ADD(&mem_acc_counters[tag].current, - (s64) (prev_size - size));
+	return new_ptr;
+}
+
+static char *gf_mem_acc_strdup(const char *str, u32 tag)
+{
+	char *ptr;
+	size_t len;
+	if (!str) return NULL;
+	len = strlen(str) + 1;
+	ptr = (char *) gf_mem_acc_register(MALLOC(len), len, tag);
+	if (ptr) memcpy(ptr, str, len);
+	return ptr;
+}
+
+#ifdef GPAC_MEMORY_TRACKING
+
+/*allocations from units built without GF_MEM_TAG*/
+static void *gf_mem_malloc_acc(size_t size, const char *filename, int line)
+{
+	return gf_mem_acc_register(MALLOC(size), size, GF_MEM_TAG_OTHER);
+}
+
+static void *gf_mem_calloc_acc(size_t num, size_t size_of, const char *filename, int line)
+{
+	return gf_mem_acc_register(CALLOC(num, size_of), num*size_of, GF_MEM_TAG_OTHER);
+}
+
+static void gf_mem_free_acc(void *ptr, const char *filename, int line)
+{
+	gf_mem_acc_free(ptr);
+}
+
+static void *gf_mem_realloc_acc(void *ptr, size_t size, const char *filename, int line)
+{
+	return gf_mem_acc_realloc(ptr, size, GF_MEM_TAG_OTHER);
+}
+
+static char *gf_mem_strdup_acc(const char *str, const char *filename, int line)
+{
+	return gf_mem_acc_strdup(str, GF_MEM_TAG_OTHER);
+}
+
+MY_GF_EXPORT
+void *gf_mem_malloc_tag(size_t size, u32 tag, const char *filename, int line)
+{
+	if (mem_acc_enabled) return gf_mem_acc_register(MALLOC(size), size, tag);
+	return gf_mem_malloc_proto(size, filename, line);
+}
+
+MY_GF_EXPORT
+void *gf_mem_calloc_tag(size_t num, size_t size_of, u32 tag, const char *filename, int line)
+{
+	if (mem_acc_enabled) return gf_mem_acc_register(CALLOC(num, size_of), num*size_of, tag);
+	return gf_mem_calloc_proto(num, size_of, filename, line);
+}
+
+MY_GF_EXPORT
+void *gf_mem_realloc_tag(void *ptr, size_t size, u32 tag, const char *filename, int line)
+{
+	if (mem_acc_enabled) return gf_mem_acc_realloc(ptr, size, tag);
+	return gf_mem_realloc_proto(ptr, size, filename, line);
+}
+
+MY_GF_EXPORT
+char *gf_mem_strdup_tag(const char *str, u32 tag, const char *filename, int line)
+{
+	if (mem_acc_enabled) return gf_mem_acc_strdup(str, tag);
+	return gf_mem_strdup_proto(str, filename, line);
+}
+
+#else
+
+GF_EXPORT
+void *gf_malloc_tag(size_t size, u32 tag)
+{
+	if (mem_acc_enabled) return gf_mem_acc_register(MALLOC(size), size, tag);
+	return MALLOC(size);
+}
+GF_EXPORT
+void *gf_calloc_tag(size_t num, size_t size_of, u32 tag)
+{
+	if (mem_acc_enabled) return gf_mem_acc_register(CALLOC(num, size_of), num*size_of, tag);
+	return CALLOC(num, size_of);
+}
+GF_EXPORT
+void *gf_realloc_tag(void *ptr, size_t size, u32 tag)
+{
+	if (mem_acc_enabled) return gf_mem_acc_realloc(ptr, size, tag);
+	return REALLOC(ptr, size);
+}
+GF_EXPORT
+char *gf_strdup_tag(const char *str, u32 tag)
+{
+	if (mem_acc_enabled) return gf_mem_acc_strdup(str, tag);
+	STRDUP(str);
+}
+
+/*allocations from units built without GF_MEM_TAG*/
+GF_EXPORT
+void *gf_malloc(size_t size)
+{
+	return gf_malloc_tag(size, GF_MEM_TAG_OTHER);
+}
+GF_EXPORT
+void *gf_calloc(size_t num, size_t size_of)
+{
+	return gf_calloc_tag(num, size_of, GF_MEM_TAG_OTHER);
+}
+GF_EXPORT
+void *gf_realloc(void *ptr, size_t size)
+{
+	return gf_realloc_tag(ptr, size, GF_MEM_TAG_OTHER);
+}
+GF_EXPORT
+void gf_free(void *ptr)
+{
+	if (mem_acc_enabled) gf_mem_acc_free(ptr);
+	else FREE(ptr);
+}
+GF_EXPORT
+char *gf_strdup(const char *str)
+{
+	return gf_strdup_tag(str, GF_MEM_TAG_OTHER);
+}
+
 #endif /*GPAC_MEMORY_TRACKING*/
 
+GF_EXPORT
+void gf_mem_enable_accounting()
+{
+#ifdef GPAC_MEMORY_TRACKING
+	gf_mem_malloc_proto = gf_mem_malloc_acc;
+	gf_mem_calloc_proto = gf_mem_calloc_acc;
+	gf_mem_realloc_proto = gf_mem_realloc_acc;
+	gf_mem_free_proto = gf_mem_free_acc;
+	gf_mem_strdup_proto = gf_mem_strdup_acc;
+#endif
+	mem_acc_enabled = GF_TRUE;
+}
+
+GF_EXPORT
+Bool gf_memory_tag_stats(GF_MemTag tag, GF_MemTagStats *stats)
+{
+	u32 i;
+	GF_MemAccCounters *c;
+	if (((u32) tag >= GF_MEM_TAG_MAX) || !stats) return GF_FALSE;
+	if (!mem_acc_enabled) return GF_FALSE;
+	c = &mem_acc_counters[tag];
+	stats->current = (u64) c->current;
+	stats->peak = (u64) c->peak;
+	stats->nb_alloc = stats->nb_free = 0;
+	for (i=0; i<(1<<MEM_ACC_SHARDS_BITS); i++) {
+		GF_MemAccShard *shard = &mem_acc_shards[i];
+		gf_mem_acc_lock(shard);
+		stats->nb_alloc += shard->nb_alloc[tag];
+		stats->nb_free += shard->nb_free[tag];
+		gf_mem_acc_unlock(shard);
+	}
+	return GF_TRUE;
+}
+
+GF_EXPORT
+const char *gf_memory_tag_name(GF_MemTag tag)
+{
+	if ((u32) tag >= GF_MEM_TAG_MAX) return NULL;
+	return mem_acc_tag_names[tag];
+}
+
+GF_EXPORT
+void gf_memory_print_tags()
+{
+	u32 i;
+	if (!mem_acc_enabled) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_MEMORY, ("[MemAcc] gf_memory_print_tags(): memory accounting is not enabled.\n"));
+		return;
+	}
+	for (i=0; i<GF_MEM_TAG_MAX; i++) {
+		GF_MemTagStats stats;
+		gf_memory_tag_stats((GF_MemTag) i, &stats);
+		GF_LOG(GF_LOG_INFO, GF_LOG_MEMORY, ("[MemAcc] %-12s current "LLU" bytes - peak "LLU" bytes - "LLU" allocs - "LLU" frees\n", mem_acc_tag_names[i], stats.current, stats.peak, stats.nb_alloc, stats.nb_free));
+	}
+}
+
+static GF_Thread *mem_acc_dump_th = NULL;
+static GF_Semaphore *mem_acc_dump_stop = NULL;
+static u32 mem_acc_dump_period = 0;
+
+static u32 gf_mem_acc_dump_proc(void *par)
+{
+	while (!gf_sema_wait_for(mem_acc_dump_stop, mem_acc_dump_period)) {
+		gf_memory_print_tags();
+	}
+	return 0;
+}
+
+GF_EXPORT
+GF_Err gf_memory_set_tags_dump_period(u32 period_ms)
+{
+	if (mem_acc_dump_th) {
+		gf_sema_notify(mem_acc_dump_stop, 1);
+		gf_th_stop(mem_acc_dump_th);
+		gf_th_del(mem_acc_dump_th);
+		gf_sema_del(mem_acc_dump_stop);
+		mem_acc_dump_th = NULL;
+		mem_acc_dump_stop = NULL;
+	}
+	if (!period_ms) return GF_OK;
+	if (!mem_acc_enabled) return GF_BAD_PARAM;
+
+	mem_acc_dump_period = period_ms;
+	mem_acc_dump_stop = gf_sema_new(1, 0);
+	mem_acc_dump_th = gf_th_new("MemAccDump");
+	if (!mem_acc_dump_stop || !mem_acc_dump_th || gf_th_run(mem_acc_dump_th, gf_mem_acc_dump_proc, NULL)) {
+		if (mem_acc_dump_th) gf_th_del(mem_acc_dump_th);
+		if (mem_acc_dump_stop) gf_sema_del(mem_acc_dump_stop);
+		mem_acc_dump_th = NULL;
+		mem_acc_dump_stop = NULL;
+		return GF_IO_ERR;
+	}
+	return GF_OK;
+}
+
+
 
 /*gf_asprintf(): as_printf portable implementation*/
 #if defined(WIN32) || defined(_WIN32_WCE) || (defined (__SVR4) && defined (__sun))
@@ -27,17 +27,24 @@
 #include <gpac/list.h>
 
 #define MAX_INI_LINE			2046
+/*sections with more keys than this are indexed by key name*/
+#define INI_HASH_MIN_KEYS		32
 
-typedef struct
+typedef struct __ini_key
 {
 	char *name;
 	char *value;
+	/*next key in hash bucket*/
+	struct __ini_key *next_hash;
 } IniKey;
 
 typedef struct
 {
 	char *section_name;
 	GF_List *keys;
+	/*key name index, NULL for small sections*/
+	IniKey **hash;
+	u32 hash_size;
 } IniSection;
 
 struct __tag_config
@@ -48,20 +55,103 @@ struct __tag_config
 };
 
 
+static u32 ini_hash(const char *name)
+{
+	u32 h = 5381;
+	while (*name) {
+		h = (h<<5) + h + (u8) *name;
+		name++;
+	}
+	return h;
+}
+
+static void ini_hash_key(IniSection *sec, IniKey *key)
+{
+	IniKey **bucket = &sec->hash[ini_hash(key->name) % sec->hash_size];
+	key->next_hash = NULL;
+	//keep the first declared key in case of duplicates
+	while (*bucket) {
+		if (!strcmp((*bucket)->name, key->name)) return;
+		bucket = &(*bucket)->next_hash;
+	}
+	*bucket = key;
+}
+
+static void ini_unhash_key(IniSection *sec, IniKey *key)
+{
+	IniKey **bucket;
+	if (!sec->hash) return;
+	bucket = &sec->hash[ini_hash(key->name) % sec->hash_size];
+	while (*bucket) {
+		if (*bucket == key) {
+			*bucket = key->next_hash;
+			return;
+		}
+		bucket = &(*bucket)->next_hash;
+	}
+}
+
+static void ini_rehash(IniSection *sec)
+{
+	u32 i, count = gf_list_count(sec->keys);
+	if (sec->hash) gf_free(sec->hash);
+	sec->hash_size = 2*count + 1;
+	sec->hash = (IniKey **) gf_malloc(sizeof(IniKey *) * sec->hash_size);
+	if (!sec->hash) {
+		sec->hash_size = 0;
+		return;
+	}
+	memset(sec->hash, 0, sizeof(IniKey *) * sec->hash_size);
+	for (i=0; i<count; i++) {
+		ini_hash_key(sec, (IniKey *) gf_list_get(sec->keys, i));
+	}
+}
+
+/*must be called after the key has been added to the section list*/
+static void ini_index_key(IniSection *sec, IniKey *key)
+{
+	u32 count = gf_list_count(sec->keys);
+	if (count <= INI_HASH_MIN_KEYS) return;
+	if (!sec->hash || (count > sec->hash_size)) {
+		ini_rehash(sec);
+	} else {
+		ini_hash_key(sec, key);
+	}
+}
+
+static IniKey *ini_find_key(IniSection *sec, const char *name)
+{
+	u32 i;
+	IniKey *key;
+	if (sec->hash) {
+		key = sec->hash[ini_hash(name) % sec->hash_size];
+		while (key) {
+			if (!strcmp(key->name, name)) return key;
+			key = key->next_hash;
+		}
+		return NULL;
+	}
+	i=0;
+	while ( (key = (IniKey *) gf_list_enum(sec->keys, &i)) ) {
+		if (!strcmp(key->name, name)) return key;
+	}
+	return NULL;
+}
+
 static void DelSection(IniSection *ptr)
 {
 	IniKey *k;
 	if (!ptr) return;
 	if (ptr->keys) {
 		while (gf_list_count(ptr->keys)) {
-			k = (IniKey *) gf_list_get(ptr->keys, 0);
+			k = (IniKey *) gf_list_pop_back(ptr->keys);
 			if (k->value) gf_free(k->value);
 			if (k->name) gf_free(k->name);
 			gf_free(k);
-			gf_list_rem(ptr->keys, 0);
 		}
 		gf_list_del(ptr->keys);
 	}
+	if (ptr->hash) gf_free(ptr->hash);
 	if (ptr->section_name) gf_free(ptr->section_name);
 	gf_free(ptr);
 }
@@ -147,7 +237,7 @@ GF_Err gf_cfg_parse_config_file(GF_Config * tmp, const char * filePath, const ch
 
 		/* new section */
 		if (line[0] == '[') {
-			p = (IniSection *) gf_malloc(sizeof(IniSection));
+			GF_SAFEALLOC(p, IniSection);
 			p->keys = gf_list_new();
 			p->section_name = gf_strdup(line + 1);
 			p->section_name[strlen(line) - 2] = 0;
@@ -181,7 +271,12 @@ GF_Err gf_cfg_parse_config_file(GF_Config * tmp, const char * filePath, const ch
 					k->value = gf_strdup("");
 				}
 			}
-			gf_list_add(p->keys, k);
+			if (k->name) {
+				gf_list_add(p->keys, k);
+				ini_index_key(p, k);
+			} else {
+				gf_free(k);
+			}
 		}
 	}
 	gf_free(line);
@@ -297,11 +392,8 @@ const char *gf_cfg_get_key(GF_Config *iniFile, const char *secName, const char *
 	return NULL;
 
 get_key:
-	i=0;
-	while ( (key = (IniKey *) gf_list_enum(sec->keys, &i)) ) {
-		if (!strcmp(key->name, keyName)) return key->value;
-	}
-	return NULL;
+	key = ini_find_key(sec, keyName);
+	return key ? key->value : NULL;
 }
 
 GF_EXPORT
@@ -343,27 +435,29 @@ GF_Err gf_cfg_set_key(GF_Config *iniFile, const char *secName, const char *keyNa
 		if (!strcmp(secName, sec->section_name)) goto get_key;
 	}
 	/* need a new key */
-	sec = (IniSection *) gf_malloc(sizeof(IniSection));
+	GF_SAFEALLOC(sec, IniSection);
+	if (!sec) return GF_OUT_OF_MEM;
 	sec->section_name = gf_strdup(secName);
 	sec->keys = gf_list_new();
 	if (has_changed) iniFile->hasChanged = GF_TRUE;
 	gf_list_add(iniFile->sections, sec);
 
 get_key:
-	i=0;
-	while ( (key = (IniKey *) gf_list_enum(sec->keys, &i) ) ) {
-		if (!strcmp(key->name, keyName)) goto set_value;
-	}
+	key = ini_find_key(sec, keyName);
+	if (key) goto set_value;
 	if (!keyValue) return GF_OK;
 	/* need a new key */
-	key = (IniKey *) gf_malloc(sizeof(IniKey));
+	GF_SAFEALLOC(key, IniKey);
+	if (!key) return GF_OUT_OF_MEM;
 	key->name = gf_strdup(keyName);
 	key->value = gf_strdup("");
 	if (has_changed) iniFile->hasChanged = GF_TRUE;
 	gf_list_add(sec->keys, key);
+	ini_index_key(sec, key);
 
 set_value:
 	if (!keyValue) {
+		ini_unhash_key(sec, key);
 		gf_list_del_item(sec->keys, key);
 		if (key->name) gf_free(key->name);
 		if (key->value) gf_free(key->value);
@@ -452,15 +546,14 @@ GF_Err gf_cfg_insert_key(GF_Config *iniFile, const char *secName, const char *ke
 	}
 	if (!sec) return GF_BAD_PARAM;
 
-	i=0;
-	while ( (key = (IniKey *) gf_list_enum(sec->keys, &i) ) ) {
-		if (!strcmp(key->name, keyName)) return GF_BAD_PARAM;
-	}
+	if (ini_find_key(sec, keyName)) return GF_BAD_PARAM;
 
-	key = (IniKey *) gf_malloc(sizeof(IniKey));
+	GF_SAFEALLOC(key, IniKey);
+	if (!key) return GF_OUT_OF_MEM;
 	key->name = gf_strdup(keyName);
 	key->value = gf_strdup(keyValue);
 	gf_list_insert(sec->keys, key, index);
+	ini_index_key(sec, key);
 	iniFile->hasChanged = GF_TRUE;
 	return GF_OK;
 }
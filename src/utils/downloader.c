@@ -58,12 +58,16 @@
 
 
 static void gf_dm_connect(GF_DownloadSession *sess);
+static void gf_dm_par_fetch_del(GF_DownloadSession *sess);
+static void gf_dm_par_fetch_first_range_done(GF_DownloadSession *sess);
 
 /*internal flags*/
 enum
 {
 	GF_DOWNLOAD_SESSION_USE_SSL     = 1<<10,
-	GF_DOWNLOAD_SESSION_THREAD_DEAD = 1<<11
+	GF_DOWNLOAD_SESSION_THREAD_DEAD = 1<<11,
+	/*data is pulled by the user through gf_dm_sess_fetch_data*/
+	GF_DOWNLOAD_SESSION_USER_FETCH  = 1<<12
 };
 
 typedef struct __gf_user_credentials
@@ -99,6 +103,38 @@ typedef struct __partialDownloadStruct {
 	char * filename;
 } GF_PartialDownload ;
 
+/*byte range of a resource fetched by a helper connection*/
+typedef struct
+{
+	u64 start, end;
+	/*allocated when the range is requested, released once delivered*/
+	char *data;
+	u32 size, received;
+	Bool done;
+	GF_Err error;
+} GF_DMRange;
+
+/*parallel fetch of a large resource: the session connection only serves the first range, the following ranges
+are fetched by helper connections and delivered to the session in order*/
+typedef struct
+{
+	struct __gf_download_session *sess;
+	char *url;
+	GF_Mutex *mx;
+	GF_List *workers;
+	GF_DMRange *ranges;
+	u32 nb_ranges, range_size;
+	/*next range to request*/
+	u32 next_range;
+	/*range being delivered and bytes of this range already delivered*/
+	u32 cur_range, cur_offset;
+	/*max number of ranges allocated ahead of the delivered one*/
+	u32 window;
+	/*the session connection is done with the first range*/
+	Bool first_range_done;
+	volatile Bool abort;
+} GF_DMParallelFetch;
+
 struct __gf_download_session
 {
 	/*this is always 0 and helps differenciating downloads from other interfaces (interfaceType != 0)*/
@@ -184,6 +220,8 @@ struct __gf_download_session
 	u32 remaining_data_size;
 
 	Bool local_cache_only;
+
+	GF_DMParallelFetch *par_fetch;
 };
 
 struct __gf_download_manager
@@ -199,6 +237,8 @@ struct __gf_download_manager
 	GF_List *sessions;
 	Bool disable_cache, simulate_no_connection, allow_offline_cache, clean_cache;
 	u32 limit_data_rate, read_buf_size;
+	/*parallel fetch of large resources: max number of helper connections per session and size of each byte range*/
+	u32 par_connections, par_range_size;
 	u64 max_cache_size;
 	Bool allow_broken_certificate;
 
@@ -589,7 +629,8 @@ static void gf_dm_configure_cache(GF_DownloadSession *sess)
 	gf_dm_remove_cache_entry_from_session(sess);
 	if (sess->flags & GF_NETIO_SESSION_NOT_CACHED) {
 		sess->reused_cache_entry = GF_FALSE;
-		gf_cache_close_write_cache(sess->cache_entry, sess, GF_FALSE);
+		if (sess->cache_entry)
+			gf_cache_close_write_cache(sess->cache_entry, sess, GF_FALSE);
 	} else {
 		Bool found = GF_FALSE;
 		u32 i, count;
@@ -704,6 +745,7 @@ static void gf_dm_clear_headers(GF_DownloadSession *sess)
 static void gf_dm_disconnect(GF_DownloadSession *sess, Bool force_close)
 {
 	assert( sess );
+	if (sess->par_fetch) gf_dm_par_fetch_del(sess);
 	if (sess->connection_close) force_close = GF_TRUE;
 	sess->connection_close = GF_FALSE;
 	if (sess->remaining_data && sess->remaining_data_size) {
@@ -1196,6 +1238,7 @@ static u32 gf_dm_session_thread(void *par)
 
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_CORE, ("[Downloader] Entering thread ID %d\n", gf_th_id() ));
 	sess->flags &= ~GF_DOWNLOAD_SESSION_THREAD_DEAD;
+	GF_TRACE(GF_TRACE_BEGIN, GF_LOG_NETWORK, "download", 0);
 	while (!sess->destroy) {
 		gf_mx_p(sess->mx);
 		if (sess->status >= GF_NETIO_DISCONNECTED) {
@@ -1210,6 +1253,7 @@ static u32 gf_dm_session_thread(void *par)
 		gf_mx_v(sess->mx);
 		gf_sleep(0);
 	}
+	GF_TRACE(GF_TRACE_END, GF_LOG_NETWORK, "download", 0);
 	/*destroy all sessions*/
 	gf_dm_disconnect(sess, GF_FALSE);
 	sess->status = GF_NETIO_STATE_ERROR;
@@ -1716,6 +1760,7 @@ GF_Err gf_dm_sess_process(GF_DownloadSession *sess)
 		return GF_OK;
 	}
 	/*otherwise do a synchronous download*/
+	GF_TRACE(GF_TRACE_BEGIN, GF_LOG_NETWORK, "download", 0);
 	go = GF_TRUE;
 	while (go) {
 		switch (sess->status) {
@@ -1747,6 +1792,7 @@ GF_Err gf_dm_sess_process(GF_DownloadSession *sess)
 			break;
 		}
 	}
+	GF_TRACE(GF_TRACE_END, GF_LOG_NETWORK, "download", 0);
 	return sess->last_error;
 }
 
@@ -1937,6 +1983,15 @@ retry_cache:
 	}
 
 
+	dm->par_connections = 0;
+	dm->par_range_size = 1024*1024;
+	if (cfg) {
+		opt = gf_cfg_get_key(cfg, "Downloader", "ParallelConnections");
+		if (opt) dm->par_connections = atoi(opt);
+		opt = gf_cfg_get_key(cfg, "Downloader", "ParallelRangeSize");
+		if (opt && atoi(opt)) dm->par_range_size = 1024 * atoi(opt);
+	}
+
 	dm->head_timeout = 5000;
 	if (cfg) {
 		opt = gf_cfg_get_key(cfg, "Downloader", "HTTPHeadTimeout");
@@ -2148,7 +2203,7 @@ static char *gf_dm_get_chunk_data(GF_DownloadSession *sess, Bool first_chunk_in_
 			body_start += 2;
 			*header_size = 2;
 			//chunk exactly ends our packet, reset session start time
-			if (*payload_size == 2) {
+			if ((*payload_size == 2) && sess->start_time) {
 				sess->chunk_run_time += gf_sys_clock_high_res() - sess->start_time;
 				sess->start_time = 0;
 			}
@@ -2270,6 +2325,11 @@ static GFINLINE void gf_dm_data_received(GF_DownloadSession *sess, u8 *payload,
 	} else {
 		data = payload;
 		remaining = payload_size = 0;
+		/*parallel fetch: the session connection only serves the first range*/
+		if (sess->par_fetch && !sess->par_fetch->first_range_done && (sess->bytes_done + nbBytes >= sess->par_fetch->range_size)) {
+			nbBytes = sess->par_fetch->range_size - sess->bytes_done;
+			gf_dm_par_fetch_first_range_done(sess);
+		}
 	}
 
 	if (data && nbBytes && store_in_init) {
@@ -2282,6 +2342,7 @@ static GFINLINE void gf_dm_data_received(GF_DownloadSession *sess, u8 *payload,
 	if (nbBytes && !sess->remaining_data_size) {
 		sess->bytes_done += nbBytes;
 		dm_sess_update_download_rate(sess, GF_TRUE);
+		GF_TRACE(GF_TRACE_COUNTER, GF_LOG_NETWORK, "download_kbps", 8*sess->bytes_per_sec/1000);
 
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[HTTP] url %s received %d new bytes (%d kbps)\n", gf_cache_get_url(sess->cache_entry), nbBytes, 8*sess->bytes_per_sec/1000));
 		if (sess->total_size && (sess->bytes_done > sess->total_size)) {
@@ -2304,6 +2365,11 @@ static GFINLINE void gf_dm_data_received(GF_DownloadSession *sess, u8 *payload,
 		}
 
 	}
+	/*end of chunk: the server may be idle until the next one (low latency live), only account for the chunk transfer time*/
+	if (flush_chunk && sess->start_time) {
+		sess->chunk_run_time += gf_sys_clock_high_res() - sess->start_time;
+		sess->start_time = 0;
+	}
 	//and we're done
 	if (sess->total_size && (sess->bytes_done == sess->total_size)) {
 		gf_dm_disconnect(sess, GF_FALSE);
@@ -2319,7 +2385,7 @@ static GFINLINE void gf_dm_data_received(GF_DownloadSession *sess, u8 *payload,
 		sess->total_time_since_req = (u32) (gf_sys_clock_high_res() - sess->request_start_time);
 
 		GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[HTTP] url %s (%d bytes) downloaded in "LLU" us (%d kbps) (%d us since request - got response in %d us)\n", gf_cache_get_url(sess->cache_entry), sess->bytes_done,
-		                                     gf_sys_clock_high_res() - sess->start_time, 8*sess->bytes_per_sec/1000, sess->total_time_since_req, sess->reply_time ));
+		                                     sess->start_time ? gf_sys_clock_high_res() - sess->start_time : sess->chunk_run_time, 8*sess->bytes_per_sec/1000, sess->total_time_since_req, sess->reply_time ));
 
 		if (sess->chunked && (payload_size==2))
 			payload_size=0;
@@ -2339,6 +2405,235 @@ static GFINLINE void gf_dm_data_received(GF_DownloadSession *sess, u8 *payload,
 }
 
 
+typedef struct
+{
+	GF_DMParallelFetch *pf;
+	GF_Thread *th;
+	/*range being fetched*/
+	GF_DMRange *range;
+} GF_DMRangeWorker;
+
+static void gf_dm_par_fetch_io(void *usr_cbk, GF_NETIO_Parameter *par)
+{
+	u32 nb_bytes;
+	GF_DMRangeWorker *w = (GF_DMRangeWorker *)usr_cbk;
+	GF_DMRange *r = w->range;
+	if (!r) return;
+
+	switch (par->msg_type) {
+	case GF_NETIO_PARSE_REPLY:
+		/*range ignored by the server*/
+		if (par->reply != 206) r->error = GF_NOT_SUPPORTED;
+		break;
+	case GF_NETIO_DATA_EXCHANGE:
+		if (r->error) break;
+		gf_mx_p(w->pf->mx);
+		nb_bytes = MIN(par->size, r->size - r->received);
+		memcpy(r->data + r->received, par->data, nb_bytes);
+		r->received += nb_bytes;
+		gf_mx_v(w->pf->mx);
+		break;
+	default:
+		break;
+	}
+}
+
+static u32 gf_dm_par_fetch_worker(void *par)
+{
+	GF_Err e = GF_OK;
+	GF_DMRangeWorker *w = (GF_DMRangeWorker *)par;
+	GF_DMParallelFetch *pf = w->pf;
+	GF_DownloadSession *hs = NULL;
+
+	while (!pf->abort) {
+		GF_DMRange *r;
+		gf_mx_p(pf->mx);
+		if (pf->next_range == pf->nb_ranges) {
+			gf_mx_v(pf->mx);
+			break;
+		}
+		/*do not fetch too far ahead of the delivered data*/
+		if (pf->next_range >= pf->cur_range + pf->window) {
+			gf_mx_v(pf->mx);
+			gf_sleep(1);
+			continue;
+		}
+		r = &pf->ranges[pf->next_range];
+		pf->next_range++;
+		r->data = (char *) gf_malloc(sizeof(char) * r->size);
+		if (!r->data) r->error = GF_OUT_OF_MEM;
+		w->range = r;
+		gf_mx_v(pf->mx);
+
+		if (!r->error) {
+			/*helper connections are persistent and reused for the next ranges*/
+			if (!hs) {
+				hs = gf_dm_sess_new_simple(pf->sess->dm, pf->url, GF_NETIO_SESSION_NOT_THREADED | GF_NETIO_SESSION_NOT_CACHED | GF_NETIO_SESSION_PERSISTENT, gf_dm_par_fetch_io, w, &e);
+			} else {
+				e = gf_dm_sess_setup_from_url(hs, pf->url);
+			}
+		}
+		if (hs && !e && !r->error) {
+			hs->range_start = r->start;
+			hs->range_end = r->end;
+			hs->needs_range = GF_TRUE;
+			while (!pf->abort && !r->error) {
+				if (hs->status == GF_NETIO_SETUP) {
+					gf_dm_connect(hs);
+				} else if (hs->status < GF_NETIO_DATA_TRANSFERED) {
+					hs->do_requests(hs);
+				} else {
+					break;
+				}
+			}
+			if (hs->status == GF_NETIO_STATE_ERROR)
+				e = hs->last_error ? hs->last_error : GF_REMOTE_SERVICE_ERROR;
+		}
+
+		gf_mx_p(pf->mx);
+		if (!e && (r->received != r->size)) e = GF_IP_NETWORK_FAILURE;
+		if (!r->error) r->error = e;
+		r->done = GF_TRUE;
+		w->range = NULL;
+		gf_mx_v(pf->mx);
+		if (r->error) break;
+	}
+	if (hs) gf_dm_sess_del(hs);
+	return 0;
+}
+
+/*splits the resource being downloaded by the session into byte ranges and starts the helper connections*/
+static void gf_dm_par_fetch_new(GF_DownloadSession *sess)
+{
+	u32 i, nb_workers;
+	GF_DMParallelFetch *pf;
+
+	GF_SAFEALLOC(pf, GF_DMParallelFetch);
+	if (!pf) return;
+	pf->sess = sess;
+	pf->range_size = sess->dm->par_range_size;
+	pf->nb_ranges = (sess->total_size + pf->range_size - 1) / pf->range_size;
+	pf->ranges = (GF_DMRange *) gf_malloc(sizeof(GF_DMRange) * pf->nb_ranges);
+	if (!pf->ranges) {
+		gf_free(pf);
+		return;
+	}
+	memset(pf->ranges, 0, sizeof(GF_DMRange) * pf->nb_ranges);
+	for (i=0; i<pf->nb_ranges; i++) {
+		GF_DMRange *r = &pf->ranges[i];
+		r->start = (u64) i * pf->range_size;
+		r->end = MIN(r->start + pf->range_size, sess->total_size) - 1;
+		r->size = (u32) (r->end - r->start + 1);
+	}
+	/*first range is served by the session connection*/
+	pf->next_range = pf->cur_range = 1;
+	nb_workers = MIN(sess->dm->par_connections, pf->nb_ranges - 1);
+	pf->window = 2 * nb_workers;
+	pf->url = gf_strdup(sess->orig_url);
+	pf->mx = gf_mx_new("HTTPParallelFetch");
+	pf->workers = gf_list_new();
+	sess->par_fetch = pf;
+
+	GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[HTTP] Fetching %s (%d bytes) as %d ranges of %d bytes using %d connections\n", pf->url, sess->total_size, pf->nb_ranges, pf->range_size, nb_workers));
+	for (i=0; i<nb_workers; i++) {
+		GF_DMRangeWorker *w;
+		GF_SAFEALLOC(w, GF_DMRangeWorker);
+		if (!w) break;
+		w->pf = pf;
+		w->th = gf_th_new("HTTPRangeFetch");
+		gf_list_add(pf->workers, w);
+		gf_th_run(w->th, gf_dm_par_fetch_worker, w);
+	}
+}
+
+static void gf_dm_par_fetch_del(GF_DownloadSession *sess)
+{
+	u32 i;
+	GF_DMParallelFetch *pf = sess->par_fetch;
+	sess->par_fetch = NULL;
+
+	pf->abort = GF_TRUE;
+	while (gf_list_count(pf->workers)) {
+		GF_DMRangeWorker *w = (GF_DMRangeWorker *)gf_list_pop_back(pf->workers);
+		gf_th_del(w->th);
+		gf_free(w);
+	}
+	gf_list_del(pf->workers);
+	for (i=0; i<pf->nb_ranges; i++) {
+		if (pf->ranges[i].data) gf_free(pf->ranges[i].data);
+	}
+	gf_free(pf->ranges);
+	gf_mx_del(pf->mx);
+	gf_free(pf->url);
+	gf_free(pf);
+}
+
+static void gf_dm_par_fetch_first_range_done(GF_DownloadSession *sess)
+{
+	sess->par_fetch->first_range_done = GF_TRUE;
+	/*the rest of the response is fetched by the helpers, drop the connection*/
+	gf_mx_p(sess->mx);
+#ifdef GPAC_HAS_SSL
+	if (sess->ssl) {
+		SSL_shutdown(sess->ssl);
+		SSL_free(sess->ssl);
+		sess->ssl = NULL;
+	}
+#endif
+	if (sess->sock) {
+		GF_Socket * sx = sess->sock;
+		sess->sock = NULL;
+		gf_sk_del(sx);
+	}
+	gf_mx_v(sess->mx);
+}
+
+/*passes the data received by the helpers to the session, in order*/
+static GF_Err gf_dm_par_fetch_deliver(GF_DownloadSession *sess)
+{
+	GF_Err e;
+	char *data;
+	u32 nb_bytes;
+	GF_DMRange *r;
+	GF_DMParallelFetch *pf = sess->par_fetch;
+
+	gf_mx_p(pf->mx);
+	r = &pf->ranges[pf->cur_range];
+	e = r->error;
+	nb_bytes = r->received - pf->cur_offset;
+	data = r->data + pf->cur_offset;
+	gf_mx_v(pf->mx);
+
+	if (e) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[HTTP] Failed to fetch bytes "LLU"-"LLU" of %s: %s\n", r->start, r->end, pf->url, gf_error_to_string(e)));
+		gf_dm_disconnect(sess, GF_TRUE);
+		sess->status = GF_NETIO_STATE_ERROR;
+		sess->last_error = e;
+		gf_dm_sess_notify_state(sess, sess->status, e);
+		return e;
+	}
+	if (!nb_bytes) {
+		gf_sleep(1);
+		return GF_OK;
+	}
+	pf->cur_offset += nb_bytes;
+	/*helpers only append to the range buffer, no need to hold the lock*/
+	gf_dm_data_received(sess, (u8 *) data, nb_bytes, GF_FALSE, NULL);
+	/*transfer is done and helpers are gone*/
+	if (!sess->par_fetch) return GF_OK;
+
+	if (pf->cur_offset == r->size) {
+		gf_mx_p(pf->mx);
+		gf_free(r->data);
+		r->data = NULL;
+		pf->cur_range++;
+		pf->cur_offset = 0;
+		gf_mx_v(pf->mx);
+	}
+	return GF_OK;
+}
+
+
 GF_EXPORT
 GF_Err gf_dm_sess_fetch_data(GF_DownloadSession *sess, char *buffer, u32 buffer_size, u32 *read_size)
 {
@@ -2346,6 +2641,7 @@ GF_Err gf_dm_sess_fetch_data(GF_DownloadSession *sess, char *buffer, u32 buffer_
 	GF_Err e;
 	if (/*sess->cache || */ !buffer || !buffer_size) return GF_BAD_PARAM;
 	if (sess->th) return GF_BAD_PARAM;
+	sess->flags |= GF_DOWNLOAD_SESSION_USER_FETCH;
 	if (sess->status == GF_NETIO_DISCONNECTED) return GF_EOS;
 	if (sess->status > GF_NETIO_DATA_TRANSFERED) return GF_BAD_PARAM;
 
@@ -2768,6 +3064,9 @@ static GF_Err http_parse_remaining_body(GF_DownloadSession * sess, char * sHTTP)
 		if (sess->status>=GF_NETIO_DISCONNECTED)
 			return GF_REMOTE_SERVICE_ERROR;
 
+		if (sess->par_fetch && sess->par_fetch->first_range_done)
+			return gf_dm_par_fetch_deliver(sess);
+
 		if (sess->dm && sess->dm->limit_data_rate && sess->bytes_per_sec) {
 			if (dm_exceeds_cap_rate(sess->dm)) {
 				gf_sleep(1);
@@ -2878,6 +3177,7 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
 	u32 res, i, buf_size;
 	s32 LinePos, Pos;
 	u32 rsp_code, ContentLength, first_byte, last_byte, total_size, range, no_range;
+	Bool accept_ranges = GF_FALSE;
 	Bool connection_closed = GF_FALSE;
 	char buf[1025];
 	char comp[400];
@@ -3040,7 +3340,7 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
 		if (!stricmp(hdrp->name, "Content-Length") ) {
 			ContentLength = (u32) atoi(hdrp->value);
 
-			if (rsp_code<300)
+			if ((rsp_code<300) && sess->cache_entry)
 				gf_cache_set_content_length(sess->cache_entry, ContentLength);
 
 		}
@@ -3083,6 +3383,7 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
 		}
 		else if (!stricmp(hdrp->name, "Accept-Ranges")) {
 			if (strstr(hdrp->value, "none")) no_range = 1;
+			else if (strstr(hdrp->value, "bytes")) accept_ranges = GF_TRUE;
 		}
 		else if (!stricmp(hdrp->name, "Location"))
 			new_location = gf_strdup(hdrp->value);
@@ -3419,6 +3720,13 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
 		}
 		sess->status = GF_NETIO_DATA_EXCHANGE;
 		sess->bytes_done = 0;
+
+		/*large resource on a server supporting byte ranges, use several connections*/
+		if ((rsp_code==200) && accept_ranges && !sess->chunked && !sess->needs_range && (sess->http_read_type==GET)
+		        && sess->dm && (sess->dm->par_connections>1) && (ContentLength >= 2*sess->dm->par_range_size)
+		        && !(sess->flags & GF_DOWNLOAD_SESSION_USER_FETCH)) {
+			gf_dm_par_fetch_new(sess);
+		}
 	}
 
 
@@ -834,3 +834,113 @@ void* gf_list_pop_back(GF_List *ptr) {
 
 	return item;
 }
+
+
+struct _tag_fifo
+{
+	void **slots;
+	/*position of the first item, number of items and number of slots, always a power of 2*/
+	u32 head, entryCount, allocSize;
+};
+
+GF_EXPORT
+GF_Fifo *gf_fifo_new()
+{
+	GF_Fifo *nlist;
+	GF_SAFEALLOC(nlist, GF_Fifo);
+	return nlist;
+}
+
+GF_EXPORT
+void gf_fifo_del(GF_Fifo *fifo)
+{
+	if (!fifo) return;
+	if (fifo->slots) gf_free(fifo->slots);
+	gf_free(fifo);
+}
+
+GF_EXPORT
+void gf_fifo_reset(GF_Fifo *fifo)
+{
+	if (fifo) fifo->head = fifo->entryCount = 0;
+}
+
+GF_EXPORT
+u32 gf_fifo_count(const GF_Fifo *fifo)
+{
+	return fifo ? fifo->entryCount : 0;
+}
+
+GF_EXPORT
+GF_Err gf_fifo_add(GF_Fifo *fifo, void *item)
+{
+	if (!fifo) return GF_BAD_PARAM;
+	if (fifo->entryCount == fifo->allocSize) {
+		u32 i, new_size = fifo->allocSize ? 2*fifo->allocSize : 16;
+		void **slots = (void**)gf_malloc(sizeof(void*)*new_size);
+		if (!slots) return GF_OUT_OF_MEM;
+		/*unwrap the ring in the new slots*/
+		for (i=0; i<fifo->entryCount; i++) {
+			slots[i] = fifo->slots[(fifo->head + i) & (fifo->allocSize - 1)];
+		}
+		if (fifo->slots) gf_free(fifo->slots);
+		fifo->slots = slots;
+		fifo->allocSize = new_size;
+		fifo->head = 0;
+	}
+	fifo->slots[(fifo->head + fifo->entryCount) & (fifo->allocSize - 1)] = item;
+	fifo->entryCount++;
+	return GF_OK;
+}
+
+GF_EXPORT
+void *gf_fifo_pop(GF_Fifo *fifo)
+{
+	void *item;
+	if (!fifo || !fifo->entryCount) return NULL;
+	item = fifo->slots[fifo->head];
+	fifo->head = (fifo->head + 1) & (fifo->allocSize - 1);
+	fifo->entryCount--;
+	return item;
+}
+
+GF_EXPORT
+void *gf_fifo_head(GF_Fifo *fifo)
+{
+	if (!fifo || !fifo->entryCount) return NULL;
+	return fifo->slots[fifo->head];
+}
+
+GF_EXPORT
+void *gf_fifo_get(GF_Fifo *fifo, u32 itemNumber)
+{
+	if (!fifo || (itemNumber >= fifo->entryCount)) return NULL;
+	return fifo->slots[(fifo->head + itemNumber) & (fifo->allocSize - 1)];
+}
+
+GF_EXPORT
+GF_Err gf_fifo_rem(GF_Fifo *fifo, u32 itemNumber)
+{
+	u32 i;
+	if (!fifo || (itemNumber >= fifo->entryCount)) return GF_BAD_PARAM;
+	if (!itemNumber) {
+		gf_fifo_pop(fifo);
+		return GF_OK;
+	}
+	/*shift the following items*/
+	for (i=itemNumber; i+1<fifo->entryCount; i++) {
+		fifo->slots[(fifo->head + i) & (fifo->allocSize - 1)] = fifo->slots[(fifo->head + i + 1) & (fifo->allocSize - 1)];
+	}
+	fifo->entryCount--;
+	return GF_OK;
+}
+
+GF_EXPORT
+void *gf_fifo_enum(GF_Fifo *fifo, u32 *pos)
+{
+	void *res;
+	if (!fifo || !pos) return NULL;
+	res = gf_fifo_get(fifo, *pos);
+	(*pos)++;
+	return res;
+}
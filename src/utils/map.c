@@ -23,315 +23,451 @@
  *
  */
 #include <gpac/map.h>
-#include <gpac/list.h>
 
-struct _tag_map
-{
-	u32 hash_capacity;
-	GF_List** pairs;
-};
+/*the map uses open addressing with linear probing in a power of 2 table. Removed entries are marked as such and kept
+until the table is rebuilt, so that probing sequences are not broken and entries never move during an iteration*/
 
-GF_EXPORT
-GF_Err gf_map_iter_set(GF_Map* map, GF_It_Map* it) {
-	/* Iterator must be associated to a map */
-	if (!map || !it) return GF_BAD_PARAM;
-
-	/* Associate iterator to the beginning of the map */
-	it->map = map;
-	it->ilist = 0;
-	it->hash = 0;
-	return GF_OK;
-}
+#define MAP_MIN_CAPACITY	16
+#define MAP_KEY_CHUNK_SIZE	4096
 
-GF_EXPORT
-void* gf_map_iter_has_next(GF_It_Map* it) {
-	GF_Pair* next_pair = NULL;
+/*value of removed entries*/
+static char map_removed_entry;
+#define MAP_REMOVED	((void *) &map_removed_entry)
 
-	/* No iterator or iterator out of map */
-	if (!it || !(it->hash < it->map->hash_capacity)) return NULL;
+typedef struct
+{
+	u32 hash;
+	u32 key_len;
+	union {
+		char *str;
+		u64 num;
+	} key;
+	/*NULL for empty slots, MAP_REMOVED for removed entries*/
+	void *value;
+} GF_MapSlot;
+
+/*string keys are copied in chunks owned by the map rather than allocated one by one*/
+typedef struct __map_key_chunk
+{
+	struct __map_key_chunk *next;
+	u32 size, used;
+} GF_MapKeyChunk;
 
-	next_pair = (GF_Pair*)gf_list_get(it->map->pairs[it->hash], it->ilist);
+struct _tag_map
+{
+	GF_MapSlot *slots;
+	/*always a power of 2*/
+	u32 capacity;
+	u32 count, nb_removed;
+	Bool int_keys;
+	gf_map_hash_function hash_fct;
+
+	GF_MapKeyChunk *key_chunks;
+	/*bytes used by keys in the chunks, and bytes of removed keys*/
+	u32 key_bytes, removed_key_bytes;
+};
 
-	if (next_pair) {
-		/* Next element founds in the same hash */
-		it->ilist++;
-		return next_pair->value;
+/*MurmurHash64A by Austin Appleby (public domain), processes 8 bytes at a time*/
+static u32 map_hash_string(const u8 *data, u32 size)
+{
+	const u64 m = 0xc6a4a7935bd1e995ULL;
+	u64 h = 0x5bd1e995 ^ (size * m);
+	const u8 *end = data + (size & ~7);
+
+	while (data != end) {
+		u64 k;
+		memcpy(&k, data, 8);
+		data += 8;
+		k *= m;
+		k ^= k >> 47;
+		k *= m;
+		h ^= k;
+		h *= m;
 	}
-
-	/* Take the next hash */
-	it->hash++;
-	it->ilist = 0;
-	return gf_map_iter_has_next(it);
+	switch (size & 7) {
+	case 7:
+		h ^= (u64) data[6] << 48;
+	case 6:
+		h ^= (u64) data[5] << 40;
+	case 5:
+		h ^= (u64) data[4] << 32;
+	case 4:
+		h ^= (u64) data[3] << 24;
+	case 3:
+		h ^= (u64) data[2] << 16;
+	case 2:
+		h ^= (u64) data[1] << 8;
+	case 1:
+		h ^= (u64) data[0];
+		h *= m;
+	}
+	h ^= h >> 47;
+	h *= m;
+	h ^= h >> 47;
+	return (u32) (h ^ (h >> 32));
 }
 
-GF_EXPORT
-GF_Err gf_map_iter_reset(GF_It_Map* it) {
-	if (!it) return GF_BAD_PARAM;
-	it->hash = 0;
-	it->ilist = 0;
-	return GF_OK;
+/*64 bit finalizer of MurmurHash3, so that sequential integer keys are spread over the table*/
+static u32 map_hash_int(u64 k)
+{
+	k ^= k >> 33;
+	k *= 0xff51afd7ed558ccdULL;
+	k ^= k >> 33;
+	k *= 0xc4ceb9fe1a85ec53ULL;
+	k ^= k >> 33;
+	return (u32) k;
 }
 
-
-GF_Pair* gf_pair_new(const char* key, u32 key_len, void* item) {
-	GF_Pair* new_pair;
-
-	/* Allocate space for a new pair */
-	GF_SAFEALLOC(new_pair, GF_Pair);
-	if (!new_pair)	return NULL;
-
-	/* Allocate space for a new key */
-	GF_SAFE_ALLOC_N(new_pair->key, key_len + 1, char);
-	if (!new_pair->key) {
-		gf_free(new_pair);
-		return NULL;
+static GFINLINE u32 map_hash_key(GF_Map *map, const char *key, u32 key_len, u64 num)
+{
+	if (map->int_keys) {
+		if (map->hash_fct) return map->hash_fct((const u8 *) &num, sizeof(u64));
+		return map_hash_int(num);
 	}
+	if (map->hash_fct) return map->hash_fct((const u8 *) key, key_len);
+	return map_hash_string((const u8 *) key, key_len);
+}
 
-	/* Set pair value*/
-	strcpy(new_pair->key, key);
-	new_pair->value = item;
+static char *map_store_key(GF_Map *map, const char *key, u32 key_len)
+{
+	char *dst;
+	GF_MapKeyChunk *chunk = map->key_chunks;
+
+	if (!chunk || (chunk->used + key_len + 1 > chunk->size)) {
+		u32 size = MAX(MAP_KEY_CHUNK_SIZE, key_len + 1);
+		GF_MapKeyChunk *new_chunk = (GF_MapKeyChunk *) gf_malloc(sizeof(GF_MapKeyChunk) + size);
+		if (!new_chunk) return NULL;
+		new_chunk->size = size;
+		new_chunk->used = 0;
+		/*large keys get their own chunk, inserted after the current one which remains in use*/
+		if (chunk && (key_len + 1 > MAP_KEY_CHUNK_SIZE / 4)) {
+			new_chunk->next = chunk->next;
+			chunk->next = new_chunk;
+		} else {
+			new_chunk->next = chunk;
+			map->key_chunks = new_chunk;
+		}
+		chunk = new_chunk;
+	}
+	dst = (char *) (chunk + 1) + chunk->used;
+	memcpy(dst, key, key_len);
+	dst[key_len] = 0;
+	chunk->used += key_len + 1;
+	map->key_bytes += key_len + 1;
+	return dst;
+}
 
-	return new_pair;
+static void map_del_key_chunks(GF_MapKeyChunk *chunk)
+{
+	while (chunk) {
+		GF_MapKeyChunk *next = chunk->next;
+		gf_free(chunk);
+		chunk = next;
+	}
 }
 
-void gf_pair_del(GF_Pair* pair) {
-	gf_free(pair->key);
-	gf_free(pair);
+/*returns the slot of the key if present, otherwise NULL. If insert_slot is set, it receives the slot where the key shall
+be inserted*/
+static GF_MapSlot *map_lookup(GF_Map *map, const char *key, u32 key_len, u64 num, u32 hash, GF_MapSlot **insert_slot)
+{
+	u32 mask = map->capacity - 1;
+	u32 idx = hash & mask;
+	GF_MapSlot *first_removed = NULL;
+
+	while (1) {
+		GF_MapSlot *slot = &map->slots[idx];
+		if (!slot->value) {
+			if (insert_slot) *insert_slot = first_removed ? first_removed : slot;
+			return NULL;
+		}
+		if (slot->value == MAP_REMOVED) {
+			if (!first_removed) first_removed = slot;
+		} else if (slot->hash == hash) {
+			if (map->int_keys) {
+				if (slot->key.num == num) return slot;
+			} else if ((slot->key_len == key_len) && !memcmp(slot->key.str, key, key_len)) {
+				return slot;
+			}
+		}
+		idx = (idx + 1) & mask;
+	}
+	return NULL;
 }
 
-/* Match a key to a pair */
-static GF_Pair* gf_pair_get(GF_List* pairs, const char *key)
+/*rebuilds the table with the given capacity, dropping removed entries and compacting the keys if needed*/
+static GF_Err map_rehash(GF_Map *map, u32 capacity)
 {
-	GF_Pair *pair;
-	u32 index = 0;
+	u32 i, mask;
+	GF_MapSlot *slots;
+	GF_MapKeyChunk *old_chunks = NULL;
+
+	GF_SAFE_ALLOC_N(slots, capacity, GF_MapSlot);
+	if (!slots) return GF_OUT_OF_MEM;
+
+	/*more than half of the key storage is used by removed keys, copy the remaining ones in new chunks*/
+	if (!map->int_keys && (map->removed_key_bytes > map->key_bytes / 2)) {
+		old_chunks = map->key_chunks;
+		map->key_chunks = NULL;
+		map->key_bytes = map->removed_key_bytes = 0;
+	}
 
-	while ((pair = (GF_Pair*)gf_list_get(pairs, index))) {
-		if (pair->key && !strcmp(pair->key, key)) return pair;
-		index++;
+	mask = capacity - 1;
+	for (i=0; i<map->capacity; i++) {
+		u32 idx;
+		GF_MapSlot *slot = &map->slots[i];
+		if (!slot->value || (slot->value == MAP_REMOVED)) continue;
+
+		if (old_chunks) {
+			char *key = map_store_key(map, slot->key.str, slot->key_len);
+			if (!key) {
+				map_del_key_chunks(map->key_chunks);
+				map->key_chunks = old_chunks;
+				gf_free(slots);
+				return GF_OUT_OF_MEM;
+			}
+			slot->key.str = key;
+		}
+		idx = slot->hash & mask;
+		while (slots[idx].value) idx = (idx + 1) & mask;
+		slots[idx] = *slot;
 	}
+	map_del_key_chunks(old_chunks);
 
-	/* Key not found */
-	return NULL;
+	gf_free(map->slots);
+	map->slots = slots;
+	map->capacity = capacity;
+	map->nb_removed = 0;
+	return GF_OK;
 }
 
-/* Remove a key from pairs */
-static Bool gf_pair_rem(GF_List* pairs, const char *key)
+static GF_Err map_insert(GF_Map *map, const char *key, u64 num, void *item)
 {
-	GF_Pair* pair;
-	u32 index = 0;
-
-	while ((pair = (GF_Pair*)gf_list_get(pairs, index))) {
-		if (pair->key && !strcmp(pair->key, key)) {
-			gf_list_rem(pairs, index);
-			gf_pair_del(pair);
-			return GF_TRUE;
+	u32 key_len = 0, hash;
+	GF_MapSlot *slot, *insert_slot;
+
+	if (!map->int_keys) key_len = (u32) strlen(key);
+	hash = map_hash_key(map, key, key_len, num);
+
+	slot = map_lookup(map, key, key_len, num, hash, &insert_slot);
+	/*The map already contains the provided key*/
+	if (slot) return GF_NOT_SUPPORTED;
+
+	/*keep the table at most 3/4 full of entries and removed entries. The table doubles when more than half of it would be
+	used by entries, otherwise it is rebuilt at the same size to drop removed entries*/
+	if (!insert_slot->value && (4 * (u64) (map->count + map->nb_removed + 1) > 3 * (u64) map->capacity)) {
+		u32 capacity = map->capacity;
+		GF_Err e;
+		if (2 * (u64) (map->count + 1) > capacity) {
+			if (capacity >= 0x80000000) return GF_OUT_OF_MEM;
+			capacity *= 2;
 		}
-		index++;
+		e = map_rehash(map, capacity);
+		if (e) return e;
+		map_lookup(map, key, key_len, num, hash, &insert_slot);
 	}
 
-	/* Key not found */
-	return GF_FALSE;
+	if (insert_slot->value == MAP_REMOVED) map->nb_removed--;
+	insert_slot->hash = hash;
+	insert_slot->key_len = key_len;
+	if (map->int_keys) {
+		insert_slot->key.num = num;
+	} else {
+		insert_slot->key.str = map_store_key(map, key, key_len);
+		if (!insert_slot->key.str) {
+			/*don't break probing sequences going through this slot*/
+			insert_slot->value = MAP_REMOVED;
+			map->nb_removed++;
+			return GF_OUT_OF_MEM;
+		}
+	}
+	insert_slot->value = item;
+	map->count++;
+	return GF_OK;
 }
 
+static GF_MapSlot *map_find(GF_Map *map, const char *key, u64 num)
+{
+	u32 key_len = 0;
+	if (!map->count) return NULL;
+	if (!map->int_keys) key_len = (u32) strlen(key);
+	return map_lookup(map, key, key_len, num, map_hash_key(map, key, key_len, num), NULL);
+}
 
-/* Generate a hash code for the provided string */
-static unsigned long hash(const char *str)
+static Bool map_rem(GF_Map *map, const char *key, u64 num)
 {
-	u32 hash = 5381;
-	int c;
+	GF_MapSlot *slot = map_find(map, key, num);
+	if (!slot) return GF_FALSE;
+
+	slot->value = MAP_REMOVED;
+	map->count--;
+	map->nb_removed++;
+	if (!map->int_keys) map->removed_key_bytes += slot->key_len + 1;
+	return GF_TRUE;
+}
 
-	while ((c = *str++)) {
-		hash = ((hash << 5) + hash) + c;
+
+GF_EXPORT
+GF_Err gf_map_iter_set(GF_Map* map, GF_It_Map* it) {
+	/* Iterator must be associated to a map */
+	if (!map || !it) return GF_BAD_PARAM;
+
+	/* Associate iterator to the beginning of the map */
+	it->map = map;
+	it->pair = NULL;
+	it->ilist = 0;
+	it->hash = 0;
+	return GF_OK;
+}
+
+GF_EXPORT
+void* gf_map_iter_has_next(GF_It_Map* it) {
+	/* No iterator */
+	if (!it || !it->map) return NULL;
+
+	/* Go to the next slot holding an entry */
+	while (it->hash < it->map->capacity) {
+		GF_MapSlot *slot = &it->map->slots[it->hash];
+		it->hash++;
+		if (slot->value && (slot->value != MAP_REMOVED)) return slot->value;
 	}
-	return hash;
+	return NULL;
 }
 
+GF_EXPORT
+GF_Err gf_map_iter_reset(GF_It_Map* it) {
+	if (!it) return GF_BAD_PARAM;
+	it->hash = 0;
+	it->ilist = 0;
+	return GF_OK;
+}
 
 
 GF_EXPORT
-GF_Map * gf_map_new(u32 hash_capacity)
+GF_Map *gf_map_new_ex(u32 capacity, Bool int_keys, gf_map_hash_function hash_fct)
 {
 	GF_Map *p_map;
+	u32 size = MAP_MIN_CAPACITY;
+
+	/* Keep the expected number of entries below half of the table */
+	while ((size < 0x80000000) && (size < 2 * capacity)) size *= 2;
+
 	GF_SAFEALLOC(p_map, GF_Map);
 	if (! p_map) return NULL;
 
-	p_map->hash_capacity = hash_capacity;
-	GF_SAFE_ALLOC_N(p_map->pairs, p_map->hash_capacity, GF_List*);
-	if (!p_map->pairs) {
+	GF_SAFE_ALLOC_N(p_map->slots, size, GF_MapSlot);
+	if (!p_map->slots) {
 		gf_free(p_map);
 		return NULL;
 	}
-
+	p_map->capacity = size;
+	p_map->int_keys = int_keys;
+	p_map->hash_fct = hash_fct;
 	return p_map;
 }
 
 GF_EXPORT
-void gf_map_del(GF_Map *ptr)
+GF_Map * gf_map_new(u32 hash_capacity)
 {
-	u32 i, j;
-	GF_Pair *pair;
-	GF_List *bucket;
+	return gf_map_new_ex(hash_capacity, GF_FALSE, NULL);
+}
 
+GF_EXPORT
+void gf_map_del(GF_Map *ptr)
+{
 	if (!ptr) return;
 
-	/* Iterate through the map and delete content */
-	for (i = 0; i < ptr->hash_capacity; i++) {
-		bucket = ptr->pairs[i];
-
-		/* Bucket has not be allocated */
-		if (bucket == NULL) continue;
-
-		/* Iterate through the bucket and delete pairs */
-		j = 0;
-		while ((pair = (GF_Pair*)gf_list_get(bucket, j))) {
-			gf_pair_del(pair);
-			j++;
-		}
-
-		gf_list_del(bucket);
-	}
-
-	/* Free map */
-	gf_free(ptr->pairs);
+	/* Free map, keys are owned by the map */
+	map_del_key_chunks(ptr->key_chunks);
+	gf_free(ptr->slots);
 	gf_free(ptr);
 }
 
 GF_EXPORT
 void gf_map_reset(GF_Map *ptr) {
-	u32 i, j;
-	GF_Pair *pair;
-	GF_List *bucket;
-
-	/* Iterate through the map and delete content */
-	for (i = 0; i < ptr->hash_capacity; i++) {
-		bucket = ptr->pairs[i];
-
-		/* Bucket has not be allocated */
-		if (bucket == NULL)
-			continue;
-
-		/* Iterate through the bucket and delete pairs */
-		j = 0;
-		while ((pair = (GF_Pair*)gf_list_get(bucket, j))) {
-			gf_pair_del(pair);
-			j++;
-		}
+	if (!ptr) return;
 
-		/* reset bucket count */
-		gf_list_del(bucket);
-		ptr->pairs[i] = NULL;
-	}
+	/* Empty all slots, the table keeps its size */
+	memset(ptr->slots, 0, sizeof(GF_MapSlot) * ptr->capacity);
+	map_del_key_chunks(ptr->key_chunks);
+	ptr->key_chunks = NULL;
+	ptr->count = ptr->nb_removed = 0;
+	ptr->key_bytes = ptr->removed_key_bytes = 0;
 }
 
 GF_EXPORT
 void* gf_map_find(GF_Map *ptr, const char* key) {
-	u32 index;
-	GF_List *bucket;
-	GF_Pair *pair;
+	GF_MapSlot *slot;
 
 	/* Find requires a map and a key to work properly */
-	if (!ptr || !key) return NULL;
-
-	index = hash(key) % ptr->hash_capacity;
-	bucket = ptr->pairs[index];
-	pair = gf_pair_get(bucket, key);
+	if (!ptr || !key || ptr->int_keys) return NULL;
 
-	/* bucket is empty */
-	if (!pair) return NULL;
-
-	return pair->value;
+	slot = map_find(ptr, key, 0);
+	return slot ? slot->value : NULL;
 }
 
-
 GF_EXPORT
 GF_Err gf_map_insert(GF_Map *ptr, const char* key, void* item) {
-	u32 key_len, index;
-	GF_List *bucket;
-	GF_Pair *pair;
-	GF_Err err;
-
 	/* Insert requiered a map, a key and a value */
-	if (!ptr || !key || !item) return GF_BAD_PARAM;
-
-	key_len = (u32) strlen(key);
+	if (!ptr || !key || !item || ptr->int_keys) return GF_BAD_PARAM;
 
-	/* Get a pointer to the bucket the key string hashes to */
-	index = hash(key) % ptr->hash_capacity;
-	bucket = ptr->pairs[index];
-
-	if (bucket && (pair = gf_pair_get(bucket, key))) {
-		/* The bucket already contains the provided key */
-		return GF_NOT_SUPPORTED;
-	}
-
-	if (!bucket) {
-		/* No bucket has been assigned yet */
-		bucket = gf_list_new();
-		if (!bucket) return GF_OUT_OF_MEM;
-
-		ptr->pairs[index] = bucket;
-	}
-
-	pair = gf_pair_new(key, key_len, item);
-
-	if (!pair) {
-		return GF_OUT_OF_MEM;
-	}
-
-	/* Store the new pair in the bucket */
-	err = gf_list_add(bucket, pair);
-	if(err != GF_OK) {
-		gf_free(pair);
-		return GF_OUT_OF_MEM;
-	}
-
-	return GF_OK;
+	return map_insert(ptr, key, 0, item);
 }
 
 GF_EXPORT
 Bool gf_map_rem(GF_Map *ptr, const char* key)
 {
-	u32 index;
-	GF_List *bucket;
+	/* Remove requires a map and a key to work properly */
+	if (!ptr || !key || ptr->int_keys) return GF_FALSE;
 
-	/* Find requires a map and a key to work properly */
-	if (!ptr || !key) return GF_FALSE;
+	return map_rem(ptr, key, 0);
+}
 
-	index = hash(key) % ptr->hash_capacity;
-	bucket = ptr->pairs[index];
+GF_EXPORT
+u32 gf_map_count(const GF_Map *ptr) {
+	/* No map provided */
+	if (!ptr) return 0;
 
-	return gf_pair_rem(bucket, key);
+	return ptr->count;
 }
 
 GF_EXPORT
-u32 gf_map_count(const GF_Map *ptr) {
-	u32 i = 0;
-	u32 count = 0;
+Bool gf_map_has_key(GF_Map *ptr, const char* key) {
+	/* Need a map  and key */
+	if (!ptr || !key || ptr->int_keys) return GF_FALSE;
 
-	/* No map provided */
-	if (!ptr) return GF_BAD_PARAM;
+	return map_find(ptr, key, 0) ? GF_TRUE : GF_FALSE;
+}
 
-	/* Iterate through all bucket of the map and count pair */
-	for (; i < ptr->hash_capacity; i++ ) {
-		count += gf_list_count(ptr->pairs[i]);
-	}
+GF_EXPORT
+GF_Err gf_map_insert_int(GF_Map *ptr, u64 key, void* item)
+{
+	if (!ptr || !item || !ptr->int_keys) return GF_BAD_PARAM;
 
-	return count;
+	return map_insert(ptr, NULL, key, item);
 }
 
 GF_EXPORT
-Bool gf_map_has_key(GF_Map *ptr, const char* key) {
-	unsigned int index;
-	GF_List *bucket;
+void* gf_map_find_int(GF_Map *ptr, u64 key)
+{
+	GF_MapSlot *slot;
+	if (!ptr || !ptr->int_keys) return NULL;
 
-	/* Need a map  and key */
-	if (!ptr || !key) return GF_FALSE;
+	slot = map_find(ptr, NULL, key);
+	return slot ? slot->value : NULL;
+}
+
+GF_EXPORT
+Bool gf_map_rem_int(GF_Map *ptr, u64 key)
+{
+	if (!ptr || !ptr->int_keys) return GF_FALSE;
 
-	index = hash(key) % ptr->hash_capacity;
-	bucket = ptr->pairs[index];
+	return map_rem(ptr, NULL, key);
+}
 
-	/* Check if pair exists */
-	if (gf_pair_get(bucket, key)) return GF_TRUE;
+GF_EXPORT
+Bool gf_map_has_key_int(GF_Map *ptr, u64 key)
+{
+	if (!ptr || !ptr->int_keys) return GF_FALSE;
 
-	return GF_FALSE;
+	return map_find(ptr, NULL, key) ? GF_TRUE : GF_FALSE;
 }
@@ -678,6 +678,7 @@ sh4_change_fpscr(int off, int on)
 #ifdef GPAC_MEMORY_TRACKING
 void gf_mem_enable_tracker(Bool enable_backtrace);
 #endif
+void gf_mem_enable_accounting();
 
 static u64 memory_at_gpac_startup = 0;
 
@@ -723,9 +724,12 @@ void gf_sys_init(GF_MemTrackerType mem_tracker_type)
 #endif
 #endif
 
-		if (mem_tracker_type!=GF_MemTrackerNone) {
+		/*accounting is also available without memory tracking*/
+		if (mem_tracker_type==GF_MemTrackerAccounting) {
+			gf_mem_enable_accounting();
+		} else if (mem_tracker_type!=GF_MemTrackerNone) {
 #ifdef GPAC_MEMORY_TRACKING
-            gf_mem_enable_tracker( (mem_tracker_type==GF_MemTrackerBackTrace) ? GF_TRUE : GF_FALSE);
+			gf_mem_enable_tracker( (mem_tracker_type==GF_MemTrackerBackTrace) ? GF_TRUE : GF_FALSE);
 #endif
 		}
 #ifndef GPAC_DISABLE_LOG
@@ -825,6 +829,10 @@ void gf_sys_init(GF_MemTrackerType mem_tracker_type)
 	}
 }
 
+/*writes the pending trace file and destroys trace events, see error.c*/
+void gf_trace_close();
+void gf_sk_groups_close();
+
 GF_EXPORT
 void gf_sys_close()
 {
@@ -834,6 +842,10 @@ void gf_sys_close()
 		/*prevent any call*/
 		last_update_time = 0xFFFFFFFF;
 
+		gf_trace_close();
+		gf_sk_groups_close();
+		gf_memory_set_tags_dump_period(0);
+
 #if defined(WIN32) && !defined(_WIN32_WCE)
 		timeEndPeriod(1);
 
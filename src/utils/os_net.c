@@ -23,6 +23,11 @@
  *
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+/*needed for recvmmsg/sendmmsg*/
+#define _GNU_SOURCE
+#endif
+
 #ifndef GPAC_DISABLE_CORE_TOOLS
 
 #if defined(WIN32) || defined(_WIN32_WCE)
@@ -129,6 +134,16 @@ static int wsa_init = 0;
 typedef s32 SOCKET;
 #define closesocket(v) close(v)
 
+#if defined(__linux__) && defined(MSG_WAITFORONE)
+#define GPAC_HAS_MMSG
+#endif
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <poll.h>
+#define GPAC_HAS_EPOLL
+#endif
+
 #endif /*WIN32||_WIN32_WCE*/
 
 
@@ -186,8 +201,52 @@ struct __tag_socket
 	u32 dest_addr_len;
 
 	u32 usec_wait;
+	/*number of socket group registrations, the socket is detached from its groups when deleted*/
+	u32 nb_groups;
+#ifdef GPAC_HAS_EPOLL
+	/*ID and select round of the last group which reported the socket as ready*/
+	u32 ready_group_id, ready_id;
+#endif
 };
 
+#ifndef __SYMBIAN32__
+/*waits until the socket can be read or written - returns SOCKET_ERROR, 0 if the socket is not ready or 1 otherwise*/
+static s32 gf_sk_wait(GF_Socket *sock, Bool for_write, u32 sec, u32 usec)
+{
+	s32 ready;
+#ifdef GPAC_HAS_EPOLL
+	/*unlike select, no descriptor set to build and no FD_SETSIZE limit*/
+	struct pollfd pfd;
+	struct timespec timeout;
+
+	pfd.fd = sock->socket;
+	pfd.events = for_write ? POLLOUT : POLLIN;
+	pfd.revents = 0;
+	timeout.tv_sec = sec + usec / 1000000;
+	timeout.tv_nsec = (usec % 1000000) * 1000;
+	ready = ppoll(&pfd, 1, &timeout, NULL);
+	if ((ready > 0) && (pfd.revents & POLLNVAL)) {
+		errno = EBADF;
+		return SOCKET_ERROR;
+	}
+#else
+	struct timeval timeout;
+	fd_set Group;
+
+	FD_ZERO(&Group);
+	FD_SET(sock->socket, &Group);
+	timeout.tv_sec = sec;
+	timeout.tv_usec = usec;
+	if (for_write) ready = select((int) sock->socket+1, NULL, &Group, NULL, &timeout);
+	else ready = select((int) sock->socket+1, &Group, NULL, NULL, &timeout);
+	if ((ready > 0) && !FD_ISSET(sock->socket, &Group)) ready = 0;
+#endif
+	return ready;
+}
+#endif
+
+static void gf_sk_groups_detach(GF_Socket *sk, Bool is_deleted);
+
 
 
 /*
@@ -455,6 +514,9 @@ static void gf_sk_free(GF_Socket *sock)
 		setsockopt(sock->socket, IPPROTO_IP, IP_DROP_MEMBERSHIP, (char *) &mreq, sizeof(mreq));
 #endif
 	}
+#ifdef GPAC_HAS_EPOLL
+	if (sock->nb_groups && sock->socket) gf_sk_groups_detach(sock, GF_FALSE);
+#endif
 	if (sock->socket) closesocket(sock->socket);
 	sock->socket = (SOCKET) 0L;
 
@@ -470,6 +532,8 @@ GF_EXPORT
 void gf_sk_del(GF_Socket *sock)
 {
 	assert( sock );
+	/*groups shall never see a deleted socket*/
+	if (sock->nb_groups) gf_sk_groups_detach(sock, GF_TRUE);
 	gf_sk_free(sock);
 #ifdef WIN32
 	wsa_init --;
@@ -491,6 +555,7 @@ s32 gf_sk_get_handle(GF_Socket *sock)
 	return (s32) sock->socket;
 }
 
+GF_EXPORT
 void gf_sk_set_usec_wait(GF_Socket *sock, u32 usec_wait)
 {
 	if (!sock) return;
@@ -860,8 +925,6 @@ GF_Err gf_sk_send(GF_Socket *sock, const char *buffer, u32 length)
 	Bool not_ready = GF_FALSE;
 #ifndef __SYMBIAN32__
 	int ready;
-	struct timeval timeout;
-	fd_set Group;
 #endif
 
 	//the socket must be bound or connected
@@ -869,13 +932,7 @@ GF_Err gf_sk_send(GF_Socket *sock, const char *buffer, u32 length)
 
 #ifndef __SYMBIAN32__
 	//can we write?
-	FD_ZERO(&Group);
-	FD_SET(sock->socket, &Group);
-	timeout.tv_sec = 0;
-	timeout.tv_usec = sock->usec_wait;
-
-	//TODO CHECK IF THIS IS CORRECT
-	ready = select((int) sock->socket+1, NULL, &Group, NULL, &timeout);
+	ready = gf_sk_wait(sock, GF_TRUE, 0, sock->usec_wait);
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
@@ -886,7 +943,7 @@ GF_Err gf_sk_send(GF_Socket *sock, const char *buffer, u32 length)
 	}
 
 	//should never happen (to check: is writeability is guaranteed for not-connected sockets)
-	if (!ready || !FD_ISSET(sock->socket, &Group)) {
+	if (!ready) {
 		not_ready = GF_TRUE;
 	}
 #endif
@@ -920,6 +977,65 @@ GF_Err gf_sk_send(GF_Socket *sock, const char *buffer, u32 length)
 	return GF_OK;
 }
 
+/*max number of datagrams sent by a single sendmmsg call*/
+#define GF_SK_MAX_SEND_BATCH	64
+
+GF_EXPORT
+GF_Err gf_sk_send_batch(GF_Socket *sock, const char **buffers, const u32 *sizes, u32 nb_buffers, u32 *nb_sent)
+{
+	GF_Err e;
+	u32 i;
+#ifdef GPAC_HAS_MMSG
+	s32 res;
+	u32 nb;
+	struct mmsghdr msgs[GF_SK_MAX_SEND_BATCH];
+	struct iovec iovecs[GF_SK_MAX_SEND_BATCH];
+#endif
+
+	if (!nb_sent) return GF_BAD_PARAM;
+	*nb_sent = 0;
+	if (!sock || !sock->socket || !buffers || !sizes) return GF_BAD_PARAM;
+
+#ifdef GPAC_HAS_MMSG
+	if (!(sock->flags & GF_SOCK_IS_TCP)) {
+		while (*nb_sent < nb_buffers) {
+			nb = MIN(nb_buffers - *nb_sent, GF_SK_MAX_SEND_BATCH);
+			memset(msgs, 0, sizeof(struct mmsghdr) * nb);
+			for (i=0; i<nb; i++) {
+				iovecs[i].iov_base = (char *) buffers[*nb_sent + i];
+				iovecs[i].iov_len = sizes[*nb_sent + i];
+				msgs[i].msg_hdr.msg_iov = &iovecs[i];
+				msgs[i].msg_hdr.msg_iovlen = 1;
+				if (sock->flags & GF_SOCK_HAS_PEER) {
+					msgs[i].msg_hdr.msg_name = &sock->dest_addr;
+					msgs[i].msg_hdr.msg_namelen = sock->dest_addr_len;
+				}
+			}
+			res = sendmmsg(sock->socket, msgs, nb, 0);
+			if (res == SOCKET_ERROR) {
+				switch (LASTSOCKERROR) {
+				case EAGAIN:
+					return GF_IP_SOCK_WOULD_BLOCK;
+				default:
+					return GF_IP_NETWORK_FAILURE;
+				}
+			}
+			*nb_sent += res;
+			if ((u32) res < nb) return GF_IP_SOCK_WOULD_BLOCK;
+		}
+		return GF_OK;
+	}
+#endif
+
+	/*no batch send on this platform*/
+	for (i=0; i<nb_buffers; i++) {
+		e = gf_sk_send(sock, buffers[i], sizes[i]);
+		if (e) return e;
+		*nb_sent += 1;
+	}
+	return GF_OK;
+}
+
 
 GF_EXPORT
 u32 gf_sk_is_multicast_address(const char *multi_IPAdd)
@@ -1164,40 +1280,255 @@ GF_Err gf_sk_setup_multicast(GF_Socket *sock, const char *multi_IPAdd, u16 Multi
 }
 
 #include <gpac/list.h>
+#include <gpac/thread.h>
 struct __tag_sock_group
 {
 	GF_List *sockets;
 	fd_set group;
+#ifdef GPAC_HAS_EPOLL
+	/*epoll instance, select is used if negative*/
+	int epoll_fd;
+	struct epoll_event *events;
+	u32 nb_ready, alloc_events;
+	/*unique ID of the group and select round, sockets reported ready store them*/
+	u32 id, select_id;
+	/*registered sockets without descriptor, watched as soon as they get one*/
+	GF_List *pending;
+#endif
 };
 
+/*all socket groups, so that sockets find their groups without keeping pointers to them*/
+static GF_List *sk_groups = NULL;
+static GF_Mutex *sk_groups_mx = NULL;
+#ifdef GPAC_HAS_EPOLL
+static u32 sk_groups_next_id = 0;
+#endif
+
+static void gf_sk_groups_lock()
+{
+	if (!sk_groups_mx) {
+		GF_Mutex *mx = gf_mx_new("SocketGroups");
+#if defined(WIN32) || defined(_WIN32_WCE)
+		if (InterlockedCompareExchangePointer((PVOID volatile *) &sk_groups_mx, mx, NULL) != NULL)
+#else
+		if (!__sync_bool_compare_and_swap(&sk_groups_mx, NULL, mx))
+#endif
+			gf_mx_del(mx);
+	}
+	gf_mx_p(sk_groups_mx);
+}
+
+/*called by gf_sys_close*/
+void gf_sk_groups_close()
+{
+	/*groups still alive keep the registry*/
+	if (gf_list_count(sk_groups)) return;
+	if (sk_groups_mx) gf_mx_del(sk_groups_mx);
+	sk_groups_mx = NULL;
+	if (sk_groups) gf_list_del(sk_groups);
+	sk_groups = NULL;
+}
+
+#ifdef GPAC_HAS_EPOLL
+/*removes a socket no longer watched by the group from the result of its last or current epoll_wait. Once the descriptor
+is removed from the epoll set, the kernel no longer reports it, so all events written for it are already in the array.
+They may not be published in nb_ready yet, so the whole array is checked. Called with the groups lock held*/
+static void gf_sk_group_forget_ready(GF_SockGroup *sg, GF_Socket *sk)
+{
+	u32 i;
+	for (i=0; i<sg->alloc_events; i++) {
+		if (sg->events[i].data.ptr == sk) sg->events[i].data.ptr = NULL;
+	}
+}
+#endif
+
+/*the socket is deleted: remove it from all its groups
+or its descriptor is about to be closed: stop watching it until the socket gets a new one*/
+static void gf_sk_groups_detach(GF_Socket *sk, Bool is_deleted)
+{
+	u32 i;
+	GF_SockGroup *sg;
+
+	gf_sk_groups_lock();
+	i=0;
+	while ((sg = gf_list_enum(sk_groups, &i))) {
+		if (gf_list_find(sg->sockets, sk) < 0) continue;
+		if (is_deleted) {
+			while (gf_list_del_item(sg->sockets, sk) >= 0) {}
+		}
+#ifdef GPAC_HAS_EPOLL
+		if (sg->epoll_fd < 0) continue;
+		if (sk->socket) epoll_ctl(sg->epoll_fd, EPOLL_CTL_DEL, sk->socket, NULL);
+		if (is_deleted) {
+			gf_list_del_item(sg->pending, sk);
+			/*the result of the last select shall not point to the deleted socket*/
+			gf_sk_group_forget_ready(sg, sk);
+		} else if (gf_list_find(sg->pending, sk) < 0) {
+			gf_list_add(sg->pending, sk);
+		}
+#endif
+	}
+	if (is_deleted) sk->nb_groups = 0;
+	gf_mx_v(sk_groups_mx);
+}
+
+GF_EXPORT
 GF_SockGroup *gf_sk_group_new()
 {
 	GF_SockGroup *tmp;
 	GF_SAFEALLOC(tmp, GF_SockGroup);
+	if (!tmp) return NULL;
 	tmp->sockets = gf_list_new();
 	FD_ZERO(&tmp->group);
+#ifdef GPAC_HAS_EPOLL
+	tmp->pending = gf_list_new();
+	tmp->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (tmp->epoll_fd < 0) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] cannot create epoll instance (error %d), using select\n", LASTSOCKERROR));
+	}
+#endif
+	gf_sk_groups_lock();
+	if (!sk_groups) sk_groups = gf_list_new();
+	gf_list_add(sk_groups, tmp);
+#ifdef GPAC_HAS_EPOLL
+	/*0 is never used, it identifies sockets never reported ready*/
+	sk_groups_next_id++;
+	if (!sk_groups_next_id) sk_groups_next_id++;
+	tmp->id = sk_groups_next_id;
+#endif
+	gf_mx_v(sk_groups_mx);
 	return tmp;
 }
 
+GF_EXPORT
 void gf_sk_group_del(GF_SockGroup *sg)
 {
+	/*member sockets may already be deleted and are not accessed*/
+	gf_sk_groups_lock();
+	gf_list_del_item(sk_groups, sg);
+	gf_mx_v(sk_groups_mx);
+#ifdef GPAC_HAS_EPOLL
+	if (sg->epoll_fd >= 0) close(sg->epoll_fd);
+	if (sg->events) gf_free(sg->events);
+	gf_list_del(sg->pending);
+#endif
 	gf_list_del(sg->sockets);
 	gf_free(sg);
 }
 
+#ifdef GPAC_HAS_EPOLL
+static void gf_sk_group_watch(GF_SockGroup *sg, GF_Socket *sk)
+{
+	struct epoll_event ev;
+	if (!sk->socket) {
+		if (gf_list_find(sg->pending, sk) < 0) gf_list_add(sg->pending, sk);
+		return;
+	}
+	memset(&ev, 0, sizeof(struct epoll_event));
+	/*level-triggered, as select*/
+	ev.events = EPOLLIN;
+	ev.data.ptr = sk;
+	if (epoll_ctl(sg->epoll_fd, EPOLL_CTL_ADD, sk->socket, &ev) && (LASTSOCKERROR != EEXIST)) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] cannot add socket to epoll group (error %d)\n", LASTSOCKERROR));
+	}
+}
+#endif
+
+GF_EXPORT
 void gf_sk_group_register(GF_SockGroup *sg, GF_Socket *sk)
 {
 	if (sg && sk) {
+		gf_sk_groups_lock();
 		gf_list_add(sg->sockets, sk);
+		sk->nb_groups++;
+#ifdef GPAC_HAS_EPOLL
+		if (sg->epoll_fd >= 0) {
+			u32 count = gf_list_count(sg->sockets);
+			if (count > sg->alloc_events) {
+				sg->alloc_events = MAX(2*sg->alloc_events, count);
+				sg->events = gf_realloc(sg->events, sizeof(struct epoll_event) * sg->alloc_events);
+			}
+			gf_sk_group_watch(sg, sk);
+		}
+#endif
+		gf_mx_v(sk_groups_mx);
 	}
 }
+
+GF_EXPORT
 void gf_sk_group_unregister(GF_SockGroup *sg, GF_Socket *sk)
 {
 	if (sg && sk) {
-		gf_list_del_item(sg->sockets, sk);
+		gf_sk_groups_lock();
+		if (gf_list_del_item(sg->sockets, sk) >= 0) {
+			if (sk->nb_groups) sk->nb_groups--;
+		}
+#ifdef GPAC_HAS_EPOLL
+		/*socket may have been registered several times*/
+		if ((sg->epoll_fd >= 0) && (gf_list_find(sg->sockets, sk) < 0)) {
+			if (sk->socket) epoll_ctl(sg->epoll_fd, EPOLL_CTL_DEL, sk->socket, NULL);
+			gf_list_del_item(sg->pending, sk);
+			gf_sk_group_forget_ready(sg, sk);
+			if (sk->ready_group_id == sg->id) sk->ready_group_id = 0;
+		}
+#endif
+		gf_mx_v(sk_groups_mx);
 	}
 }
 
+#ifdef GPAC_HAS_EPOLL
+static s32 gf_sk_group_epoll(GF_SockGroup *sg, u32 usec_wait)
+{
+	s32 ready;
+	u32 i=0;
+	GF_Socket *sock;
+
+	/*sockets may be closed or deleted by other threads: the event array and the ready state are only modified
+	with the groups lock held. The lock is released during epoll_wait, see gf_sk_group_forget_ready*/
+	gf_sk_groups_lock();
+	while ((sock = gf_list_enum(sg->pending, &i))) {
+		if (!sock->socket) continue;
+		i--;
+		gf_list_rem(sg->pending, i);
+		gf_sk_group_watch(sg, sock);
+	}
+	sg->select_id++;
+	sg->nb_ready = 0;
+	if (!sg->alloc_events) {
+		sg->alloc_events = 1;
+		sg->events = gf_malloc(sizeof(struct epoll_event));
+	}
+	gf_mx_v(sk_groups_mx);
+	/*epoll timeouts are in milliseconds: for other wait values, check the group then wait on the epoll descriptor*/
+	ready = epoll_wait(sg->epoll_fd, sg->events, sg->alloc_events, (usec_wait % 1000) ? 0 : (int) (usec_wait / 1000));
+	if (!ready && (usec_wait % 1000)) {
+		struct pollfd pfd;
+		struct timespec timeout;
+		pfd.fd = sg->epoll_fd;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		timeout.tv_sec = usec_wait / 1000000;
+		timeout.tv_nsec = (usec_wait % 1000000) * 1000;
+		ready = ppoll(&pfd, 1, &timeout, NULL);
+		if (ready > 0) ready = epoll_wait(sg->epoll_fd, sg->events, sg->alloc_events, 0);
+	}
+	if (ready <= 0) return ready;
+
+	gf_sk_groups_lock();
+	sg->nb_ready = ready;
+	for (i=0; i<sg->nb_ready; i++) {
+		sock = (GF_Socket *) sg->events[i].data.ptr;
+		/*deleted or unregistered since epoll_wait returned*/
+		if (!sock) continue;
+		sock->ready_group_id = sg->id;
+		sock->ready_id = sg->select_id;
+	}
+	gf_mx_v(sk_groups_mx);
+	return ready;
+}
+#endif
+
+GF_EXPORT
 GF_Err gf_sk_group_select(GF_SockGroup *sg, u32 usec_wait)
 {
 	s32 ready;
@@ -1206,19 +1537,26 @@ GF_Err gf_sk_group_select(GF_SockGroup *sg, u32 usec_wait)
 	u32 max_fd=0;
 	GF_Socket *sock;
 
-	FD_ZERO(&sg->group);
-	while ((sock = gf_list_enum(sg->sockets, &i))) {
-		FD_SET(sock->socket, &sg->group);
-		if (max_fd < (u32) sock->socket) max_fd = (u32) sock->socket;
-	}
-	if (usec_wait>=1000000) {
-		timeout.tv_sec = usec_wait/1000000;
-		timeout.tv_usec = (u32) (usec_wait - (timeout.tv_sec*1000000));
-	} else {
-		timeout.tv_sec = 0;
-		timeout.tv_usec = usec_wait;
+#ifdef GPAC_HAS_EPOLL
+	if (sg->epoll_fd >= 0) {
+		ready = gf_sk_group_epoll(sg, usec_wait);
+	} else
+#endif
+	{
+		FD_ZERO(&sg->group);
+		while ((sock = gf_list_enum(sg->sockets, &i))) {
+			FD_SET(sock->socket, &sg->group);
+			if (max_fd < (u32) sock->socket) max_fd = (u32) sock->socket;
+		}
+		if (usec_wait>=1000000) {
+			timeout.tv_sec = usec_wait/1000000;
+			timeout.tv_usec = (u32) (usec_wait - (timeout.tv_sec*1000000));
+		} else {
+			timeout.tv_sec = 0;
+			timeout.tv_usec = usec_wait;
+		}
+		ready = select((int) max_fd+1, &sg->group, NULL, NULL, &timeout);
 	}
-	ready = select((int) max_fd+1, &sg->group, NULL, NULL, &timeout);
 
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
@@ -1243,9 +1581,22 @@ GF_Err gf_sk_group_select(GF_SockGroup *sg, u32 usec_wait)
 	return GF_OK;
 }
 
+GF_EXPORT
 Bool gf_sk_group_sock_is_set(GF_SockGroup *sg, GF_Socket *sk)
 {
-	if (sg && sk && FD_ISSET(sk->socket, &sg->group)) return GF_TRUE;
+	if (!sg || !sk) return GF_FALSE;
+#ifdef GPAC_HAS_EPOLL
+	if (sg->epoll_fd >= 0) {
+		u32 i;
+		if (sk->ready_group_id == sg->id) return (sk->ready_id == sg->select_id) ? GF_TRUE : GF_FALSE;
+		/*the socket was reported by another group since, look for it in the result of our last select*/
+		for (i=0; i<sg->nb_ready; i++) {
+			if (sg->events[i].data.ptr == sk) return GF_TRUE;
+		}
+		return GF_FALSE;
+	}
+#endif
+	if (FD_ISSET(sk->socket, &sg->group)) return GF_TRUE;
 	return GF_FALSE;
 }
 
@@ -1258,8 +1609,6 @@ GF_Err gf_sk_receive_internal(GF_Socket *sock, char *buffer, u32 length, u32 sta
 	s32 res;
 #ifndef __SYMBIAN32__
 	s32 ready;
-	struct timeval timeout;
-	fd_set Group;
 #endif
 
 	*BytesRead = 0;
@@ -1269,11 +1618,7 @@ GF_Err gf_sk_receive_internal(GF_Socket *sock, char *buffer, u32 length, u32 sta
 #ifndef __SYMBIAN32__
 	if (do_select) {
 		//can we read?
-		timeout.tv_sec = 0;
-		timeout.tv_usec = sock->usec_wait;
-		FD_ZERO(&Group);
-		FD_SET(sock->socket, &Group);
-		ready = select((int) sock->socket+1, &Group, NULL, NULL, &timeout);
+		ready = gf_sk_wait(sock, GF_FALSE, 0, sock->usec_wait);
 
 		if (ready == SOCKET_ERROR) {
 			switch (LASTSOCKERROR) {
@@ -1291,7 +1636,7 @@ GF_Err gf_sk_receive_internal(GF_Socket *sock, char *buffer, u32 length, u32 sta
 				return GF_IP_NETWORK_FAILURE;
 			}
 		}
-		if (!ready || !FD_ISSET(sock->socket, &Group)) {
+		if (!ready) {
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[socket] nothing to be read - ready %d\n", ready));
 			return GF_IP_NETWORK_EMPTY;
 		}
@@ -1346,6 +1691,73 @@ GF_Err gf_sk_receive_no_select(GF_Socket *sock, char *buffer, u32 length, u32 st
 	return gf_sk_receive_internal(sock, buffer, length, startFrom, BytesRead, GF_FALSE);
 }
 
+/*max number of datagrams fetched by a single recvmmsg call*/
+#define GF_SK_MAX_BATCH	64
+
+GF_EXPORT
+GF_Err gf_sk_receive_batch(GF_Socket *sock, char **buffers, u32 *sizes, u32 buffer_size, u32 nb_buffers, u32 *nb_read)
+{
+	GF_Err e;
+	u32 i;
+#ifdef GPAC_HAS_MMSG
+	s32 res;
+	struct mmsghdr msgs[GF_SK_MAX_BATCH];
+	struct iovec iovecs[GF_SK_MAX_BATCH];
+#else
+	u32 usec_wait;
+#endif
+
+	if (!nb_read) return GF_BAD_PARAM;
+	*nb_read = 0;
+	if (!sock || !sock->socket || !buffers || !sizes || !buffer_size || !nb_buffers) return GF_BAD_PARAM;
+	if (sock->flags & GF_SOCK_IS_TCP) return GF_NOT_SUPPORTED;
+
+	/*wait for the first datagram using the socket wait time*/
+	e = gf_sk_receive_internal(sock, buffers[0], buffer_size, 0, &sizes[0], GF_TRUE);
+	if (e) return e;
+	*nb_read = 1;
+	if (nb_buffers==1) return GF_OK;
+
+#ifdef GPAC_HAS_MMSG
+	if (nb_buffers > GF_SK_MAX_BATCH+1) nb_buffers = GF_SK_MAX_BATCH+1;
+	memset(msgs, 0, sizeof(struct mmsghdr) * (nb_buffers-1));
+	for (i=0; i<nb_buffers-1; i++) {
+		iovecs[i].iov_base = buffers[i+1];
+		iovecs[i].iov_len = buffer_size;
+		msgs[i].msg_hdr.msg_iov = &iovecs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		/*same behaviour as recvfrom: the last sender address is kept*/
+		if (sock->flags & GF_SOCK_HAS_PEER) {
+			msgs[i].msg_hdr.msg_name = &sock->dest_addr;
+			msgs[i].msg_hdr.msg_namelen = sizeof(sock->dest_addr);
+		}
+	}
+	/*drain whatever is already queued, never block*/
+	res = recvmmsg(sock->socket, msgs, nb_buffers-1, MSG_DONTWAIT, NULL);
+	if (res == SOCKET_ERROR) {
+		/*we got at least one datagram, errors will be reported at next call*/
+		return GF_OK;
+	}
+	for (i=0; i<(u32) res; i++) {
+		sizes[i+1] = msgs[i].msg_len;
+	}
+	if (res && (sock->flags & GF_SOCK_HAS_PEER))
+		sock->dest_addr_len = msgs[res-1].msg_hdr.msg_namelen;
+	*nb_read += res;
+#else
+	/*no batch receive on this platform, poll the socket until empty*/
+	usec_wait = sock->usec_wait;
+	sock->usec_wait = 0;
+	for (i=1; i<nb_buffers; i++) {
+		e = gf_sk_receive_internal(sock, buffers[i], buffer_size, 0, &sizes[i], GF_TRUE);
+		if (e) break;
+		*nb_read += 1;
+	}
+	sock->usec_wait = usec_wait;
+#endif
+	return GF_OK;
+}
+
 GF_EXPORT
 GF_Err gf_sk_listen(GF_Socket *sock, u32 MaxConnection)
 {
@@ -1365,21 +1777,13 @@ GF_Err gf_sk_accept(GF_Socket *sock, GF_Socket **newConnection)
 	SOCKET sk;
 #ifndef __SYMBIAN32__
 	s32 ready;
-	struct timeval timeout;
-	fd_set Group;
 #endif
 	*newConnection = NULL;
 	if (!sock || !(sock->flags & GF_SOCK_IS_LISTENING) ) return GF_BAD_PARAM;
 
 #ifndef __SYMBIAN32__
 	//can we read?
-	FD_ZERO(&Group);
-	FD_SET(sock->socket, &Group);
-	timeout.tv_sec = 0;
-	timeout.tv_usec = sock->usec_wait;
-
-	//TODO - check if this is correct
-	ready = select((int) sock->socket+1, &Group, NULL, NULL, &timeout);
+	ready = gf_sk_wait(sock, GF_FALSE, 0, sock->usec_wait);
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
@@ -1388,7 +1792,7 @@ GF_Err gf_sk_accept(GF_Socket *sock, GF_Socket **newConnection)
 			return GF_IP_NETWORK_FAILURE;
 		}
 	}
-	if (!ready || !FD_ISSET(sock->socket, &Group)) return GF_IP_NETWORK_EMPTY;
+	if (!ready) return GF_IP_NETWORK_EMPTY;
 #endif
 
 #ifdef GPAC_HAS_IPV6
@@ -1514,8 +1918,6 @@ GF_Err gf_sk_send_to(GF_Socket *sock, const char *buffer, u32 length, char *remo
 #endif
 #ifndef __SYMBIAN32__
 	s32 ready;
-	struct timeval timeout;
-	fd_set Group;
 #endif
 
 	//the socket must be bound or connected
@@ -1524,13 +1926,7 @@ GF_Err gf_sk_send_to(GF_Socket *sock, const char *buffer, u32 length, char *remo
 
 #ifndef __SYMBIAN32__
 	//can we write?
-	FD_ZERO(&Group);
-	FD_SET(sock->socket, &Group);
-	timeout.tv_sec = 0;
-	timeout.tv_usec = sock->usec_wait;
-
-	//TODO - check if this is correct
-	ready = select((int) sock->socket+1, NULL, &Group, NULL, &timeout);
+	ready = gf_sk_wait(sock, GF_TRUE, 0, sock->usec_wait);
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
@@ -1539,7 +1935,7 @@ GF_Err gf_sk_send_to(GF_Socket *sock, const char *buffer, u32 length, char *remo
 			return GF_IP_NETWORK_FAILURE;
 		}
 	}
-	if (!ready || !FD_ISSET(sock->socket, &Group)) return GF_IP_NETWORK_EMPTY;
+	if (!ready) return GF_IP_NETWORK_EMPTY;
 #endif
 
 
@@ -1599,8 +1995,6 @@ GF_Err gf_sk_receive_wait(GF_Socket *sock, char *buffer, u32 length, u32 startFr
 	s32 res;
 #ifndef __SYMBIAN32__
 	s32 ready;
-	struct timeval timeout;
-	fd_set Group;
 #endif
 
 	*BytesRead = 0;
@@ -1608,12 +2002,7 @@ GF_Err gf_sk_receive_wait(GF_Socket *sock, char *buffer, u32 length, u32 startFr
 
 #ifndef __SYMBIAN32__
 	//can we read?
-	FD_ZERO(&Group);
-	FD_SET(sock->socket, &Group);
-	timeout.tv_sec = Second;
-	timeout.tv_usec = sock->usec_wait;
-
-	ready = select((int) sock->socket+1, &Group, NULL, NULL, &timeout);
+	ready = gf_sk_wait(sock, GF_FALSE, Second, sock->usec_wait);
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
@@ -1622,7 +2011,7 @@ GF_Err gf_sk_receive_wait(GF_Socket *sock, char *buffer, u32 length, u32 startFr
 			return GF_IP_NETWORK_FAILURE;
 		}
 	}
-	if (!FD_ISSET(sock->socket, &Group)) {
+	if (!ready) {
 		return GF_IP_NETWORK_EMPTY;
 	}
 #endif
@@ -1650,8 +2039,6 @@ GF_Err gf_sk_send_wait(GF_Socket *sock, const char *buffer, u32 length, u32 Seco
 	s32 res;
 #ifndef __SYMBIAN32__
 	s32 ready;
-	struct timeval timeout;
-	fd_set Group;
 #endif
 
 	//the socket must be bound or connected
@@ -1659,13 +2046,7 @@ GF_Err gf_sk_send_wait(GF_Socket *sock, const char *buffer, u32 length, u32 Seco
 
 #ifndef __SYMBIAN32__
 	//can we write?
-	FD_ZERO(&Group);
-	FD_SET(sock->socket, &Group);
-	timeout.tv_sec = Second;
-	timeout.tv_usec = sock->usec_wait;
-
-	//TODO - check if this is correct
-	ready = select((int) sock->socket+1, NULL, &Group, NULL, &timeout);
+	ready = gf_sk_wait(sock, GF_TRUE, Second, sock->usec_wait);
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
@@ -1675,7 +2056,7 @@ GF_Err gf_sk_send_wait(GF_Socket *sock, const char *buffer, u32 length, u32 Seco
 		}
 	}
 	//should never happen (to check: is writeability is guaranteed for not-connected sockets)
-	if (!ready || !FD_ISSET(sock->socket, &Group)) {
+	if (!ready) {
 		return GF_IP_NETWORK_EMPTY;
 	}
 #endif
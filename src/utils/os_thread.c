@@ -103,6 +103,12 @@ static const char *log_th_name(u32 id)
 	return "Main Process";
 }
 
+/*used by the tracing tools*/
+const char *gf_th_log_name(u32 id)
+{
+	return log_th_name(id);
+}
+
 #endif
 
 
@@ -309,9 +315,18 @@ void Thread_Stop(GF_Thread *t, Bool Destroy)
 			/*gracefully wait for Run to finish*/
 			if (pthread_join(t->threadH, NULL))
 				GF_LOG(GF_LOG_ERROR, GF_LOG_MUTEX, ("[Thread %s] pthread_join() returned an error with thread ID 0x%08x\n", t->log_name, t->id));
+			/*joined threads shall not be detached when destroying the object*/
+			t->threadH = 0;
 		}
 #endif
 	}
+#ifndef WIN32
+	/*Run already returned: join the thread so that all its memory accesses are visible to the caller*/
+	else if (t->threadH && !Destroy) {
+		pthread_join(t->threadH, NULL);
+		t->threadH = 0;
+	}
+#endif
 	t->status = GF_THREAD_STATUS_DEAD;
 }
 
@@ -788,4 +803,358 @@ Bool gf_sema_wait_for(GF_Semaphore *sm, u32 TimeOut)
 #endif
 }
 
+/*********************************************************************
+						Thread Pool
+**********************************************************************/
+#include <gpac/list.h>
+
+typedef struct __tag_thread_task
+{
+	struct __tag_thread_task *next;
+	gf_th_task_run run;
+	void *udta;
+	gf_th_task_done on_done;
+	void *done_cbk;
+	/*futures only*/
+	GF_Semaphore *done_sema;
+	GF_Err result;
+	volatile Bool done;
+} GF_PoolTask;
+
+struct __tag_thread_pool
+{
+	GF_Thread **threads;
+	u32 nb_threads;
+	GF_Mutex *mx;
+	/*pending tasks and their count, a NULL task asks the worker to exit*/
+	GF_Fifo *tasks;
+	GF_Semaphore *tasks_sema;
+	/*recycled tasks*/
+	GF_PoolTask *task_reservoir;
+	Bool stopping;
+};
+
+static GF_PoolTask *gf_th_pool_task_new(GF_ThreadPool *pool)
+{
+	GF_PoolTask *task;
+	gf_mx_p(pool->mx);
+	task = pool->task_reservoir;
+	if (task) pool->task_reservoir = task->next;
+	gf_mx_v(pool->mx);
+	if (!task) {
+		task = (GF_PoolTask *) gf_malloc(sizeof(GF_PoolTask));
+		if (!task) return NULL;
+	}
+	memset(task, 0, sizeof(GF_PoolTask));
+	return task;
+}
+
+static void gf_th_pool_task_del(GF_ThreadPool *pool, GF_PoolTask *task)
+{
+	if (task->done_sema) gf_sema_del(task->done_sema);
+	gf_mx_p(pool->mx);
+	task->next = pool->task_reservoir;
+	pool->task_reservoir = task;
+	gf_mx_v(pool->mx);
+}
+
+static GF_Err gf_th_pool_push(GF_ThreadPool *pool, GF_PoolTask *task)
+{
+	GF_Err e;
+	gf_mx_p(pool->mx);
+	e = pool->stopping ? GF_BAD_PARAM : gf_fifo_add(pool->tasks, task);
+	gf_mx_v(pool->mx);
+	if (!e) gf_sema_notify(pool->tasks_sema, 1);
+	return e;
+}
+
+static void gf_th_pool_exec(GF_ThreadPool *pool, GF_PoolTask *task)
+{
+	GF_Err e = task->run(task->udta);
+	if (task->on_done) task->on_done(task->done_cbk, e);
+	if (task->done_sema) {
+		task->result = e;
+		task->done = GF_TRUE;
+		gf_sema_notify(task->done_sema, 1);
+	} else {
+		gf_th_pool_task_del(pool, task);
+	}
+}
+
+/*runs one pending task if any, returns GF_FALSE if no task was run*/
+static Bool gf_th_pool_help(GF_ThreadPool *pool)
+{
+	GF_PoolTask *task;
+	if (!gf_sema_wait_for(pool->tasks_sema, 0)) return GF_FALSE;
+	gf_mx_p(pool->mx);
+	task = (GF_PoolTask *) gf_fifo_pop(pool->tasks);
+	gf_mx_v(pool->mx);
+	if (!task) {
+		/*exit request for a worker, put it back*/
+		gf_sema_notify(pool->tasks_sema, 1);
+		return GF_FALSE;
+	}
+	gf_th_pool_exec(pool, task);
+	return GF_TRUE;
+}
+
+/*waits for the semaphore, running pending tasks meanwhile so that waiting from a task cannot block the pool*/
+static void gf_th_pool_wait_sema(GF_ThreadPool *pool, GF_Semaphore *sema)
+{
+	while (!gf_sema_wait_for(sema, 0)) {
+		if (!gf_th_pool_help(pool)) {
+			gf_sema_wait(sema);
+			return;
+		}
+	}
+}
+
+static u32 gf_th_pool_worker(void *par)
+{
+	GF_ThreadPool *pool = (GF_ThreadPool *) par;
+	while (1) {
+		GF_PoolTask *task;
+		gf_sema_wait(pool->tasks_sema);
+		gf_mx_p(pool->mx);
+		task = (GF_PoolTask *) gf_fifo_pop(pool->tasks);
+		gf_mx_v(pool->mx);
+		if (!task) break;
+		gf_th_pool_exec(pool, task);
+	}
+	return 0;
+}
+
+GF_EXPORT
+GF_ThreadPool *gf_th_pool_new(const char *name, u32 nb_threads)
+{
+	u32 i;
+	GF_ThreadPool *pool;
+
+	if (!nb_threads) {
+		GF_SystemRTInfo rti;
+		memset(&rti, 0, sizeof(GF_SystemRTInfo));
+		gf_sys_get_rti(1000, &rti, 0);
+		nb_threads = MAX(1, rti.nb_cores);
+	}
+	GF_SAFEALLOC(pool, GF_ThreadPool);
+	if (!pool) return NULL;
+	pool->mx = gf_mx_new(name ? name : "ThreadPool");
+	pool->tasks = gf_fifo_new();
+	pool->tasks_sema = gf_sema_new(0x7FFFFFFF, 0);
+	pool->threads = (GF_Thread **) gf_malloc(sizeof(GF_Thread *) * nb_threads);
+	if (!pool->mx || !pool->tasks || !pool->tasks_sema || !pool->threads) {
+		gf_th_pool_del(pool);
+		return NULL;
+	}
+	for (i=0; i<nb_threads; i++) {
+		char szName[100];
+		snprintf(szName, 100, "%s#%d", name ? name : "ThreadPool", i+1);
+		szName[99] = 0;
+		pool->threads[i] = gf_th_new(szName);
+		if (!pool->threads[i] || gf_th_run(pool->threads[i], gf_th_pool_worker, pool)) {
+			if (pool->threads[i]) gf_th_del(pool->threads[i]);
+			GF_LOG(GF_LOG_ERROR, GF_LOG_MUTEX, ("[ThreadPool] Failed to start thread %d\n", i+1));
+			break;
+		}
+		pool->nb_threads++;
+	}
+	if (!pool->nb_threads) {
+		gf_th_pool_del(pool);
+		return NULL;
+	}
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_MUTEX, ("[ThreadPool] %s started with %d threads\n", name ? name : "ThreadPool", pool->nb_threads));
+	return pool;
+}
+
+GF_EXPORT
+void gf_th_pool_del(GF_ThreadPool *pool)
+{
+	u32 i;
+	if (!pool) return;
+
+	/*pending tasks are run, then each worker gets an exit request*/
+	if (pool->mx) {
+		gf_mx_p(pool->mx);
+		pool->stopping = GF_TRUE;
+		for (i=0; i<pool->nb_threads; i++) gf_fifo_add(pool->tasks, NULL);
+		gf_mx_v(pool->mx);
+	}
+	if (pool->nb_threads) gf_sema_notify(pool->tasks_sema, pool->nb_threads);
+	for (i=0; i<pool->nb_threads; i++) {
+		gf_th_stop(pool->threads[i]);
+		gf_th_del(pool->threads[i]);
+	}
+	while (pool->task_reservoir) {
+		GF_PoolTask *task = pool->task_reservoir;
+		pool->task_reservoir = task->next;
+		gf_free(task);
+	}
+	if (pool->threads) gf_free(pool->threads);
+	if (pool->tasks) gf_fifo_del(pool->tasks);
+	if (pool->tasks_sema) gf_sema_del(pool->tasks_sema);
+	if (pool->mx) gf_mx_del(pool->mx);
+	gf_free(pool);
+}
+
+GF_EXPORT
+u32 gf_th_pool_get_thread_count(GF_ThreadPool *pool)
+{
+	return pool ? pool->nb_threads : 0;
+}
+
+GF_EXPORT
+GF_Err gf_th_pool_post(GF_ThreadPool *pool, gf_th_task_run run, void *udta, gf_th_task_done on_done, void *done_cbk)
+{
+	GF_Err e;
+	GF_PoolTask *task;
+	if (!pool || !run) return GF_BAD_PARAM;
+
+	task = gf_th_pool_task_new(pool);
+	if (!task) return GF_OUT_OF_MEM;
+	task->run = run;
+	task->udta = udta;
+	task->on_done = on_done;
+	task->done_cbk = done_cbk;
+	e = gf_th_pool_push(pool, task);
+	if (e) gf_th_pool_task_del(pool, task);
+	return e;
+}
+
+GF_EXPORT
+GF_ThreadTask *gf_th_pool_submit(GF_ThreadPool *pool, gf_th_task_run run, void *udta)
+{
+	GF_PoolTask *task;
+	if (!pool || !run) return NULL;
+
+	task = gf_th_pool_task_new(pool);
+	if (!task) return NULL;
+	task->run = run;
+	task->udta = udta;
+	task->done_sema = gf_sema_new(1, 0);
+	if (!task->done_sema || gf_th_pool_push(pool, task)) {
+		gf_th_pool_task_del(pool, task);
+		return NULL;
+	}
+	return (GF_ThreadTask *) task;
+}
+
+GF_EXPORT
+Bool gf_th_pool_task_done(GF_ThreadTask *_task)
+{
+	GF_PoolTask *task = (GF_PoolTask *) _task;
+	return (task && task->done) ? GF_TRUE : GF_FALSE;
+}
+
+GF_EXPORT
+GF_Err gf_th_pool_wait(GF_ThreadPool *pool, GF_ThreadTask *_task)
+{
+	GF_Err e;
+	GF_PoolTask *task = (GF_PoolTask *) _task;
+	if (!pool || !task) return GF_BAD_PARAM;
+
+	gf_th_pool_wait_sema(pool, task->done_sema);
+	e = task->result;
+	gf_th_pool_task_del(pool, task);
+	return e;
+}
+
+typedef struct
+{
+	GF_ThreadPool *pool;
+	gf_th_range_run run;
+	void *udta;
+	u32 next, end, grain;
+	/*caller and helpers not done yet*/
+	u32 nb_users;
+	GF_Err e;
+	GF_Semaphore *done_sema;
+} GF_ParallelFor;
+
+static void gf_th_pool_run_ranges(GF_ParallelFor *pf)
+{
+	while (1) {
+		u32 start, end;
+		GF_Err e;
+		gf_mx_p(pf->pool->mx);
+		if ((pf->next >= pf->end) || pf->e) {
+			gf_mx_v(pf->pool->mx);
+			return;
+		}
+		start = pf->next;
+		end = (pf->end - start > pf->grain) ? start + pf->grain : pf->end;
+		pf->next = end;
+		gf_mx_v(pf->pool->mx);
+
+		e = pf->run(pf->udta, start, end);
+		if (e) {
+			gf_mx_p(pf->pool->mx);
+			if (!pf->e) pf->e = e;
+			gf_mx_v(pf->pool->mx);
+		}
+	}
+}
+
+/*returns GF_TRUE for the last user of the range set*/
+static Bool gf_th_pool_range_release(GF_ParallelFor *pf)
+{
+	Bool last;
+	gf_mx_p(pf->pool->mx);
+	pf->nb_users--;
+	last = pf->nb_users ? GF_FALSE : GF_TRUE;
+	gf_mx_v(pf->pool->mx);
+	return last;
+}
+
+static GF_Err gf_th_pool_range_helper(void *udta)
+{
+	GF_ParallelFor *pf = (GF_ParallelFor *) udta;
+	gf_th_pool_run_ranges(pf);
+	if (gf_th_pool_range_release(pf)) gf_sema_notify(pf->done_sema, 1);
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_th_pool_parallel_for(GF_ThreadPool *pool, u32 start, u32 end, u32 grain, gf_th_range_run run, void *udta)
+{
+	u32 i, nb_ranges, nb_helpers;
+	GF_ParallelFor pf;
+	if (!pool || !run || (start > end)) return GF_BAD_PARAM;
+	if (start == end) return GF_OK;
+
+	/*by default, 4 ranges per thread (caller included) to balance uneven ranges*/
+	if (!grain) grain = MAX(1, (end - start) / (4 * (pool->nb_threads + 1)));
+	nb_ranges = (end - start) / grain + (((end - start) % grain) ? 1 : 0);
+
+	memset(&pf, 0, sizeof(GF_ParallelFor));
+	pf.pool = pool;
+	pf.run = run;
+	pf.udta = udta;
+	pf.next = start;
+	pf.end = end;
+	pf.grain = grain;
+	/*the caller is a user of the range set and processes ranges too*/
+	pf.nb_users = 1;
+
+	nb_helpers = MIN(pool->nb_threads, nb_ranges - 1);
+	if (nb_helpers) {
+		pf.done_sema = gf_sema_new(1, 0);
+		if (!pf.done_sema) nb_helpers = 0;
+	}
+	for (i=0; i<nb_helpers; i++) {
+		gf_mx_p(pool->mx);
+		pf.nb_users++;
+		gf_mx_v(pool->mx);
+		if (gf_th_pool_post(pool, gf_th_pool_range_helper, &pf, NULL, NULL) != GF_OK) {
+			gf_th_pool_range_release(&pf);
+			break;
+		}
+	}
+	gf_th_pool_run_ranges(&pf);
+
+	/*wait for the helpers still running*/
+	if (!gf_th_pool_range_release(&pf)) gf_th_pool_wait_sema(pool, pf.done_sema);
+	if (pf.done_sema) gf_sema_del(pf.done_sema);
+	return pf.e;
+}
+
 #endif
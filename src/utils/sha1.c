@@ -6,17 +6,6 @@
 
 #include <gpac/tools.h>
 
-#ifndef PUT_UINT32_BE
-#define PUT_UINT32_BE(n,b,i)                            \
-{                                                       \
-    (b)[(i)    ] = (u8) ( (n) >> 24 );       \
-    (b)[(i) + 1] = (u8) ( (n) >> 16 );       \
-    (b)[(i) + 2] = (u8) ( (n) >>  8 );       \
-    (b)[(i) + 3] = (u8) ( (n)       );       \
-}
-#endif
-
-#if 0
 /*
  *  FIPS-180-1 compliant SHA-1 implementation
  *
@@ -42,14 +31,56 @@
  *  http://www.itl.nist.gov/fipspubs/fip180-1.htm
  */
 
+/*
+ * Blocks are processed by one of the following functions, selected at first use depending on the CPU:
+ * - portable C
+ * - x86 SHA extensions (SHA-NI), one stream
+ * - x86 AVX2, eight independent streams at once, only used for multi-buffer hashing
+ */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# include <immintrin.h>
+# include <cpuid.h>
+# define GPAC_SHA1_X86
+# define SHA1_TARGET(_x)	__attribute__((target(_x)))
+#elif defined(_MSC_VER) && (_MSC_VER >= 1900) && (defined(_M_X64) || defined(_M_IX86))
+# include <intrin.h>
+# include <immintrin.h>
+# define GPAC_SHA1_X86
+# define SHA1_TARGET(_x)
+#endif
+
+/*read size of gf_sha1_file*/
+#define SHA1_FILE_BLOCK_SIZE	65536
+/*streams handled per pass in multi-buffer updates*/
+#define SHA1_MULTI_STREAMS	64
 
 struct __sha1_context
 {
-	u32 total[2];
+	u64 total;
 	u32 state[5];
 	u8 buffer[64];
 };
 
+struct __sha1_multi_context
+{
+	u32 nb_streams;
+	GF_SHA1Context *streams;
+};
+
+/*processes nb_blocks consecutive 64-byte blocks of one stream*/
+typedef void (*sha1_process_fn)(u32 state[5], const u8 *data, u32 nb_blocks);
+
+static GF_SHA1Impl sha1_impl = GF_SHA1_IMPL_AUTO;
+static sha1_process_fn sha1_process = NULL;
+
+/*the multi-buffer kernel is selected separately from the single stream one: the 8-lane AVX2 kernel only beats hashing
+streams one by one when enough streams have blocks in common, 4 with the C code and 6 with SHA-NI*/
+#define SHA1_AVX2_MIN_LANES_C		4
+#define SHA1_AVX2_MIN_LANES_SHA_NI	6
+/*0 if the AVX2 multi-buffer kernel is not used*/
+static u32 sha1_multi_min_lanes = 0;
+
 /*
  * 32-bit integer manipulation macros (big endian)
  */
@@ -63,28 +94,22 @@ struct __sha1_context
 }
 #endif
 
-/*
- * SHA-1 context setup
- */
-GF_SHA1Context *gf_sha1_starts()
-{
-	GF_SHA1Context *ctx;
-	GF_SAFEALLOC(ctx, GF_SHA1Context);
-	ctx->total[0] = 0;
-	ctx->total[1] = 0;
-
-	ctx->state[0] = 0x67452301;
-	ctx->state[1] = 0xEFCDAB89;
-	ctx->state[2] = 0x98BADCFE;
-	ctx->state[3] = 0x10325476;
-	ctx->state[4] = 0xC3D2E1F0;
-	return ctx;
+#ifndef PUT_UINT32_BE
+#define PUT_UINT32_BE(n,b,i)                            \
+{                                                       \
+    (b)[(i)    ] = (u8) ( (n) >> 24 );       \
+    (b)[(i) + 1] = (u8) ( (n) >> 16 );       \
+    (b)[(i) + 2] = (u8) ( (n) >>  8 );       \
+    (b)[(i) + 3] = (u8) ( (n)       );       \
 }
+#endif
 
-static void sha1_process(GF_SHA1Context *ctx, u8 data[64] )
+static void sha1_process_c(u32 state[5], const u8 *data, u32 nb_blocks)
 {
 	u32 temp, W[16], A, B, C, D, E;
 
+	while (nb_blocks--) {
+
 	GET_UINT32_BE( W[0],  data,  0 );
 	GET_UINT32_BE( W[1],  data,  4 );
 	GET_UINT32_BE( W[2],  data,  8 );
@@ -116,11 +141,11 @@ static void sha1_process(GF_SHA1Context *ctx, u8 data[64] )
     e += S(a,5) + F(b,c,d) + K + x; b = S(b,30);        \
 }
 
-	A = ctx->state[0];
-	B = ctx->state[1];
-	C = ctx->state[2];
-	D = ctx->state[3];
-	E = ctx->state[4];
+	A = state[0];
+	B = state[1];
+	C = state[2];
+	D = state[3];
+	E = state[4];
 
 #define F(x,y,z) (z ^ (x & (y ^ z)))
 #define K 0x5A827999
@@ -229,49 +254,350 @@ static void sha1_process(GF_SHA1Context *ctx, u8 data[64] )
 
 #undef K
 #undef F
+#undef P
+#undef R
+#undef S
+
+	state[0] += A;
+	state[1] += B;
+	state[2] += C;
+	state[3] += D;
+	state[4] += E;
+
+	data += 64;
+	}
+}
+
+#ifdef GPAC_SHA1_X86
+
+/*SHA-NI: each sha1rnds4 performs four rounds, sha1msg1/sha1msg2 compute the message schedule four words at a time
+and sha1nexte derives E for the next four rounds. Message words are kept in M0-M3, rotating every four rounds*/
+#define SHA1_NI_STEP(Ec, En, Mi, Mn, Mp, Mq, f) \
+	Ec = _mm_sha1nexte_epu32(Ec, Mi); \
+	En = ABCD; \
+	Mn = _mm_sha1msg2_epu32(Mn, Mi); \
+	ABCD = _mm_sha1rnds4_epu32(ABCD, Ec, f); \
+	Mp = _mm_sha1msg1_epu32(Mp, Mi); \
+	Mq = _mm_xor_si128(Mq, Mi);
+
+SHA1_TARGET("sha,sse4.1")
+static void sha1_process_shani(u32 state[5], const u8 *data, u32 nb_blocks)
+{
+	__m128i ABCD, ABCD_SAVE, E0, E0_SAVE, E1, M0, M1, M2, M3;
+	const __m128i MASK = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+	ABCD = _mm_loadu_si128((const __m128i *) state);
+	ABCD = _mm_shuffle_epi32(ABCD, 0x1B);
+	E0 = _mm_set_epi32(state[4], 0, 0, 0);
+
+	while (nb_blocks--) {
+		ABCD_SAVE = ABCD;
+		E0_SAVE = E0;
+
+		M0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) data), MASK);
+		M1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data+16)), MASK);
+		M2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data+32)), MASK);
+		M3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data+48)), MASK);
+
+		/*rounds 0-3*/
+		E0 = _mm_add_epi32(E0, M0);
+		E1 = ABCD;
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 0);
+		/*rounds 4-7*/
+		E1 = _mm_sha1nexte_epu32(E1, M1);
+		E0 = ABCD;
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E1, 0);
+		M0 = _mm_sha1msg1_epu32(M0, M1);
+		/*rounds 8-11*/
+		E0 = _mm_sha1nexte_epu32(E0, M2);
+		E1 = ABCD;
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 0);
+		M1 = _mm_sha1msg1_epu32(M1, M2);
+		M0 = _mm_xor_si128(M0, M2);
+		/*rounds 12-67*/
+		SHA1_NI_STEP(E1, E0, M3, M0, M2, M1, 0)
+		SHA1_NI_STEP(E0, E1, M0, M1, M3, M2, 0)
+		SHA1_NI_STEP(E1, E0, M1, M2, M0, M3, 1)
+		SHA1_NI_STEP(E0, E1, M2, M3, M1, M0, 1)
+		SHA1_NI_STEP(E1, E0, M3, M0, M2, M1, 1)
+		SHA1_NI_STEP(E0, E1, M0, M1, M3, M2, 1)
+		SHA1_NI_STEP(E1, E0, M1, M2, M0, M3, 1)
+		SHA1_NI_STEP(E0, E1, M2, M3, M1, M0, 2)
+		SHA1_NI_STEP(E1, E0, M3, M0, M2, M1, 2)
+		SHA1_NI_STEP(E0, E1, M0, M1, M3, M2, 2)
+		SHA1_NI_STEP(E1, E0, M1, M2, M0, M3, 2)
+		SHA1_NI_STEP(E0, E1, M2, M3, M1, M0, 2)
+		SHA1_NI_STEP(E1, E0, M3, M0, M2, M1, 3)
+		SHA1_NI_STEP(E0, E1, M0, M1, M3, M2, 3)
+		/*rounds 68-71*/
+		E1 = _mm_sha1nexte_epu32(E1, M1);
+		E0 = ABCD;
+		M2 = _mm_sha1msg2_epu32(M2, M1);
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E1, 3);
+		M3 = _mm_xor_si128(M3, M1);
+		/*rounds 72-75*/
+		E0 = _mm_sha1nexte_epu32(E0, M2);
+		E1 = ABCD;
+		M3 = _mm_sha1msg2_epu32(M3, M2);
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 3);
+		/*rounds 76-79*/
+		E1 = _mm_sha1nexte_epu32(E1, M3);
+		E0 = ABCD;
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E1, 3);
+
+		E0 = _mm_sha1nexte_epu32(E0, E0_SAVE);
+		ABCD = _mm_add_epi32(ABCD, ABCD_SAVE);
+		data += 64;
+	}
+
+	ABCD = _mm_shuffle_epi32(ABCD, 0x1B);
+	_mm_storeu_si128((__m128i *) state, ABCD);
+	state[4] = _mm_extract_epi32(E0, 3);
+}
+
+/*AVX2: one stream per 32-bit lane. Each 32-byte half of the eight current blocks is transposed so that W[t] holds
+word t of all streams. state is stored per word: state[i][lane]*/
+#define SHA1_AVX2_ROL(x,n) _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32-n))
+#define SHA1_AVX2_W(t) ((t<16) ? W[t] : (W[t&15] = SHA1_AVX2_ROL(_mm256_xor_si256(_mm256_xor_si256(W[(t-3)&15], W[(t-8)&15]), _mm256_xor_si256(W[(t-14)&15], W[t&15])), 1)))
+#define SHA1_AVX2_ROUND(t, F, K) { \
+	__m256i tmp = _mm256_add_epi32(_mm256_add_epi32(SHA1_AVX2_ROL(A, 5), F), _mm256_add_epi32(_mm256_add_epi32(E, _mm256_set1_epi32(K)), SHA1_AVX2_W(t))); \
+	E = D; D = C; C = SHA1_AVX2_ROL(B, 30); B = A; A = tmp; }
+#define SHA1_AVX2_F1 _mm256_xor_si256(D, _mm256_and_si256(B, _mm256_xor_si256(C, D)))
+#define SHA1_AVX2_F2 _mm256_xor_si256(_mm256_xor_si256(B, C), D)
+#define SHA1_AVX2_F3 _mm256_or_si256(_mm256_and_si256(B, C), _mm256_and_si256(D, _mm256_or_si256(B, C)))
+
+SHA1_TARGET("avx2")
+static void sha1_process_avx2_x8(u32 state[5][8], const u8 *data[8], u32 nb_blocks)
+{
+	u32 i, t, offset = 0;
+	__m256i A, B, C, D, E, sA, sB, sC, sD, sE, W[16];
+	const __m256i BSWAP = _mm256_set_epi8(12,13,14,15, 8,9,10,11, 4,5,6,7, 0,1,2,3, 12,13,14,15, 8,9,10,11, 4,5,6,7, 0,1,2,3);
+
+	A = _mm256_loadu_si256((const __m256i *) state[0]);
+	B = _mm256_loadu_si256((const __m256i *) state[1]);
+	C = _mm256_loadu_si256((const __m256i *) state[2]);
+	D = _mm256_loadu_si256((const __m256i *) state[3]);
+	E = _mm256_loadu_si256((const __m256i *) state[4]);
+
+	while (nb_blocks--) {
+		for (i=0; i<2; i++) {
+			__m256i r0, r1, r2, r3, r4, r5, r6, r7, t0, t1, t2, t3, t4, t5, t6, t7;
+			r0 = _mm256_loadu_si256((const __m256i *) (data[0] + offset + 32*i));
+			r1 = _mm256_loadu_si256((const __m256i *) (data[1] + offset + 32*i));
+			r2 = _mm256_loadu_si256((const __m256i *) (data[2] + offset + 32*i));
+			r3 = _mm256_loadu_si256((const __m256i *) (data[3] + offset + 32*i));
+			r4 = _mm256_loadu_si256((const __m256i *) (data[4] + offset + 32*i));
+			r5 = _mm256_loadu_si256((const __m256i *) (data[5] + offset + 32*i));
+			r6 = _mm256_loadu_si256((const __m256i *) (data[6] + offset + 32*i));
+			r7 = _mm256_loadu_si256((const __m256i *) (data[7] + offset + 32*i));
+			t0 = _mm256_unpacklo_epi32(r0, r1);
+			t1 = _mm256_unpackhi_epi32(r0, r1);
+			t2 = _mm256_unpacklo_epi32(r2, r3);
+			t3 = _mm256_unpackhi_epi32(r2, r3);
+			t4 = _mm256_unpacklo_epi32(r4, r5);
+			t5 = _mm256_unpackhi_epi32(r4, r5);
+			t6 = _mm256_unpacklo_epi32(r6, r7);
+			t7 = _mm256_unpackhi_epi32(r6, r7);
+			r0 = _mm256_unpacklo_epi64(t0, t2);
+			r1 = _mm256_unpackhi_epi64(t0, t2);
+			r2 = _mm256_unpacklo_epi64(t1, t3);
+			r3 = _mm256_unpackhi_epi64(t1, t3);
+			r4 = _mm256_unpacklo_epi64(t4, t6);
+			r5 = _mm256_unpackhi_epi64(t4, t6);
+			r6 = _mm256_unpacklo_epi64(t5, t7);
+			r7 = _mm256_unpackhi_epi64(t5, t7);
+			W[8*i]   = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r0, r4, 0x20), BSWAP);
+			W[8*i+1] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r1, r5, 0x20), BSWAP);
+			W[8*i+2] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r2, r6, 0x20), BSWAP);
+			W[8*i+3] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r3, r7, 0x20), BSWAP);
+			W[8*i+4] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r0, r4, 0x31), BSWAP);
+			W[8*i+5] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r1, r5, 0x31), BSWAP);
+			W[8*i+6] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r2, r6, 0x31), BSWAP);
+			W[8*i+7] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r3, r7, 0x31), BSWAP);
+		}
+		sA = A;
+		sB = B;
+		sC = C;
+		sD = D;
+		sE = E;
+
+		for (t=0; t<20; t++) SHA1_AVX2_ROUND(t, SHA1_AVX2_F1, 0x5A827999)
+		for (; t<40; t++) SHA1_AVX2_ROUND(t, SHA1_AVX2_F2, 0x6ED9EBA1)
+		for (; t<60; t++) SHA1_AVX2_ROUND(t, SHA1_AVX2_F3, 0x8F1BBCDC)
+		for (; t<80; t++) SHA1_AVX2_ROUND(t, SHA1_AVX2_F2, 0xCA62C1D6)
+
+		A = _mm256_add_epi32(A, sA);
+		B = _mm256_add_epi32(B, sB);
+		C = _mm256_add_epi32(C, sC);
+		D = _mm256_add_epi32(D, sD);
+		E = _mm256_add_epi32(E, sE);
+		offset += 64;
+	}
+
+	_mm256_storeu_si256((__m256i *) state[0], A);
+	_mm256_storeu_si256((__m256i *) state[1], B);
+	_mm256_storeu_si256((__m256i *) state[2], C);
+	_mm256_storeu_si256((__m256i *) state[3], D);
+	_mm256_storeu_si256((__m256i *) state[4], E);
+}
+
+static void sha1_cpuid(u32 leaf, u32 regs[4])
+{
+#if defined(_MSC_VER)
+	__cpuidex((int *) regs, leaf, 0);
+#else
+	if (!__get_cpuid_count(leaf, 0, &regs[0], &regs[1], &regs[2], &regs[3]))
+		regs[0] = regs[1] = regs[2] = regs[3] = 0;
+#endif
+}
+
+static Bool sha1_cpu_supports(GF_SHA1Impl impl)
+{
+	u32 regs1[4], regs7[4];
+	/*portable code runs everywhere, whatever cpuid reports*/
+	if (impl==GF_SHA1_IMPL_C) return GF_TRUE;
+	sha1_cpuid(0, regs1);
+	if (regs1[0] < 7) return GF_FALSE;
+	sha1_cpuid(1, regs1);
+	sha1_cpuid(7, regs7);
+
+	switch (impl) {
+	case GF_SHA1_IMPL_SHA_NI:
+		/*SSSE3, SSE4.1 and SHA*/
+		return ((regs1[2] & (1<<9)) && (regs1[2] & (1<<19)) && (regs7[1] & (1<<29))) ? GF_TRUE : GF_FALSE;
+	case GF_SHA1_IMPL_AVX2:
+	{
+		u32 xcr0;
+		/*OS saves the YMM registers, AVX and AVX2*/
+		if (!(regs1[2] & (1<<27)) || !(regs1[2] & (1<<28)) || !(regs7[1] & (1<<5))) return GF_FALSE;
+#if defined(_MSC_VER)
+		xcr0 = (u32) _xgetbv(0);
+#else
+		{
+			u32 edx;
+			__asm__ volatile ("xgetbv" : "=a" (xcr0), "=d" (edx) : "c" (0));
+		}
+#endif
+		return ((xcr0 & 6) == 6) ? GF_TRUE : GF_FALSE;
+	}
+	default:
+		return GF_TRUE;
+	}
+}
+
+#else
+
+static Bool sha1_cpu_supports(GF_SHA1Impl impl)
+{
+	return (impl==GF_SHA1_IMPL_C) ? GF_TRUE : GF_FALSE;
+}
+
+#endif /*GPAC_SHA1_X86*/
+
+static void sha1_select_impl()
+{
+	if (sha1_cpu_supports(GF_SHA1_IMPL_SHA_NI)) gf_sha1_set_implementation(GF_SHA1_IMPL_SHA_NI);
+	else if (sha1_cpu_supports(GF_SHA1_IMPL_AVX2)) gf_sha1_set_implementation(GF_SHA1_IMPL_AVX2);
+	/*not checked against cpuid, sha1_process is called unchecked once selected*/
+	else {
+		sha1_process = sha1_process_c;
+		sha1_impl = GF_SHA1_IMPL_C;
+		sha1_multi_min_lanes = 0;
+	}
+	/*multi-buffer hashing of many streams is faster with AVX2 even when SHA-NI is available*/
+	if ((sha1_impl==GF_SHA1_IMPL_SHA_NI) && sha1_cpu_supports(GF_SHA1_IMPL_AVX2))
+		sha1_multi_min_lanes = SHA1_AVX2_MIN_LANES_SHA_NI;
+}
+
+GF_EXPORT
+GF_Err gf_sha1_set_implementation(GF_SHA1Impl impl)
+{
+	if (impl==GF_SHA1_IMPL_AUTO) {
+		sha1_select_impl();
+		return GF_OK;
+	}
+	if (!sha1_cpu_supports(impl)) return GF_NOT_SUPPORTED;
+
+	switch (impl) {
+#ifdef GPAC_SHA1_X86
+	case GF_SHA1_IMPL_SHA_NI:
+		sha1_process = sha1_process_shani;
+		break;
+#endif
+	case GF_SHA1_IMPL_C:
+	case GF_SHA1_IMPL_AVX2:
+		sha1_process = sha1_process_c;
+		break;
+	default:
+		return GF_BAD_PARAM;
+	}
+	sha1_impl = impl;
+	sha1_multi_min_lanes = (impl==GF_SHA1_IMPL_AVX2) ? SHA1_AVX2_MIN_LANES_C : 0;
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_SHA1Impl gf_sha1_get_implementation()
+{
+	if (!sha1_process) sha1_select_impl();
+	return sha1_impl;
+}
+
+static void sha1_init(GF_SHA1Context *ctx)
+{
+	ctx->total = 0;
 
-	ctx->state[0] += A;
-	ctx->state[1] += B;
-	ctx->state[2] += C;
-	ctx->state[3] += D;
-	ctx->state[4] += E;
+	ctx->state[0] = 0x67452301;
+	ctx->state[1] = 0xEFCDAB89;
+	ctx->state[2] = 0x98BADCFE;
+	ctx->state[3] = 0x10325476;
+	ctx->state[4] = 0xC3D2E1F0;
+}
+
+/*
+ * SHA-1 context setup
+ */
+GF_EXPORT
+GF_SHA1Context *gf_sha1_starts()
+{
+	GF_SHA1Context *ctx;
+	if (!sha1_process) sha1_select_impl();
+	GF_SAFEALLOC(ctx, GF_SHA1Context);
+	if (!ctx) return NULL;
+	sha1_init(ctx);
+	return ctx;
 }
 
 /*
  * SHA-1 process buffer
  */
+GF_EXPORT
 void gf_sha1_update(GF_SHA1Context *ctx, u8 *input, u32 ilen )
 {
-	s32 fill;
-	u32 left;
+	u32 fill, left;
 
-	if( ilen <= 0 )
+	if( !ilen )
 		return;
 
-	left = ctx->total[0] & 0x3F;
+	left = (u32) (ctx->total & 0x3F);
 	fill = 64 - left;
+	ctx->total += ilen;
 
-	ctx->total[0] += ilen;
-	ctx->total[0] &= 0xFFFFFFFF;
-
-	if( ctx->total[0] < (u32) ilen )
-		ctx->total[1]++;
-
-	if( left && (s32) ilen >= fill )
+	if( left && ilen >= fill )
 	{
 		memcpy( (void *) (ctx->buffer + left),
 		        (void *) input, fill );
-		sha1_process( ctx, ctx->buffer );
+		sha1_process( ctx->state, ctx->buffer, 1 );
 		input += fill;
 		ilen  -= fill;
 		left = 0;
 	}
 
-	while( ilen >= 64 )
+	if( ilen >= 64 )
 	{
-		sha1_process( ctx, input );
-		input += 64;
-		ilen  -= 64;
+		sha1_process( ctx->state, input, ilen / 64 );
+		input += ilen & ~0x3F;
+		ilen  &= 0x3F;
 	}
 
 	if( ilen > 0 )
@@ -289,23 +615,19 @@ static const u8 sha1_padding[64] =
 	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
 };
 
-/*
- * SHA-1 final digest
- */
-void gf_sha1_finish(GF_SHA1Context *ctx, u8 output[GF_SHA1_DIGEST_SIZE] )
+static void sha1_final(GF_SHA1Context *ctx, u8 output[GF_SHA1_DIGEST_SIZE])
 {
 	u32 last, padn;
 	u32 high, low;
 	u8 msglen[8];
 
-	high = ( ctx->total[0] >> 29 )
-	       | ( ctx->total[1] <<  3 );
-	low  = ( ctx->total[0] <<  3 );
+	high = (u32) ( ctx->total >> 29 );
+	low  = (u32) ( ctx->total <<  3 );
 
 	PUT_UINT32_BE( high, msglen, 0 );
 	PUT_UINT32_BE( low,  msglen, 4 );
 
-	last = ctx->total[0] & 0x3F;
+	last = (u32) (ctx->total & 0x3F);
 	padn = ( last < 56 ) ? ( 56 - last ) : ( 120 - last );
 
 	gf_sha1_update( ctx, (u8 *) sha1_padding, padn );
@@ -316,375 +638,153 @@ void gf_sha1_finish(GF_SHA1Context *ctx, u8 output[GF_SHA1_DIGEST_SIZE] )
 	PUT_UINT32_BE( ctx->state[2], output,  8 );
 	PUT_UINT32_BE( ctx->state[3], output, 12 );
 	PUT_UINT32_BE( ctx->state[4], output, 16 );
-
-	gf_free(ctx);
 }
-#else
-
-/*
- *  sha1.c
- *
- *  Copyright (C) 1998, 2009
- *  Paul E. Jones <paulej@packetizer.com>
- *  All Rights Reserved
- *
- *  Freeware Public License (FPL)
- *
- *  This software is licensed as "freeware."  Permission to distribute
- *  this software in source and binary forms, including incorporation
- *  into other products, is hereby granted without a fee.  THIS SOFTWARE
- *  IS PROVIDED 'AS IS' AND WITHOUT ANY EXPRESSED OR IMPLIED WARRANTIES,
- *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
- *  AND FITNESS FOR A PARTICULAR PURPOSE.  THE AUTHOR SHALL NOT BE HELD
- *  LIABLE FOR ANY DAMAGES RESULTING FROM THE USE OF THIS SOFTWARE, EITHER
- *  DIRECTLY OR INDIRECTLY, INCLUDING, BUT NOT LIMITED TO, LOSS OF DATA
- *  OR DATA BEING RENDERED INACCURATE.
- *
- *****************************************************************************
- *  $Id: sha1.c 12 2009-06-22 19:34:25Z paulej $
- *****************************************************************************
- *
- *  Description:
- *      This file implements the Secure Hashing Standard as defined
- *      in FIPS PUB 180-1 published April 17, 1995.
- *
- *      The Secure Hashing Standard, which uses the Secure Hashing
- *      Algorithm (SHA), produces a 160-bit message digest for a
- *      given data stream.  In theory, it is highly improbable that
- *      two messages will produce the same message digest.  Therefore,
- *      this algorithm can serve as a means of providing a "fingerprint"
- *      for a message.
- *
- *  Portability Issues:
- *      SHA-1 is defined in terms of 32-bit "words".  This code was
- *      written with the expectation that the processor has at least
- *      a 32-bit machine word size.  If the machine word size is larger,
- *      the code should still function properly.  One caveat to that
- *      is that the input functions taking characters and character
- *      arrays assume that only 8 bits of information are stored in each
- *      character.
- *
- *  Caveats:
- *      SHA-1 is designed to work with messages less than 2^64 bits
- *      long. Although SHA-1 allows a message digest to be generated for
- *      messages of any number of bits less than 2^64, this
- *      implementation only works with messages with a length that is a
- *      multiple of the size of an 8-bit character.
- *
- */
 
 /*
- *  This structure will hold context information for the hashing
- *  operation
+ * SHA-1 final digest
  */
-struct __sha1_context
+GF_EXPORT
+void gf_sha1_finish(GF_SHA1Context *ctx, u8 output[GF_SHA1_DIGEST_SIZE] )
 {
-	unsigned Message_Digest[5]; /* Message Digest (output)          */
-
-	unsigned Length_Low;        /* Message length in bits           */
-	unsigned Length_High;       /* Message length in bits           */
-
-	unsigned char Message_Block[64]; /* 512-bit message blocks      */
-	int Message_Block_Index;    /* Index into message block array   */
-
-	int Computed;               /* Is the digest computed?          */
-	int Corrupted;              /* Is the message digest corruped?  */
-};
-
-/*
- *  Define the circular shift macro
- */
-#define SHA1CircularShift(bits,word) \
-                ((((word) << (bits)) & 0xFFFFFFFF) | \
-                ((word) >> (32-(bits))))
-
+	sha1_final(ctx, output);
+	gf_free(ctx);
+}
 
 /*
- *  SHA1ProcessMessageBlock
- *
- *  Description:
- *      This function will process the next 512 bits of the message
- *      stored in the Message_Block array.
- *
- *  Parameters:
- *      None.
- *
- *  Returns:
- *      Nothing.
- *
- *  Comments:
- *      Many of the variable names in the SHAContext, especially the
- *      single character names, were used because those were the names
- *      used in the publication.
- *
- *
+ * Multi-buffer SHA-1 context setup
  */
-void SHA1ProcessMessageBlock(GF_SHA1Context *context)
+GF_EXPORT
+GF_SHA1MultiContext *gf_sha1_multi_starts(u32 nb_streams)
 {
-	const unsigned K[] =            /* Constants defined in SHA-1   */
-	{
-		0x5A827999,
-		0x6ED9EBA1,
-		0x8F1BBCDC,
-		0xCA62C1D6
-	};
-	int         t;                  /* Loop counter                 */
-	unsigned    temp;               /* Temporary word value         */
-	unsigned    W[80];              /* Word sequence                */
-	unsigned    A, B, C, D, E;      /* Word buffers                 */
-
-	/*
-	 *  Initialize the first 16 words in the array W
-	 */
-	for(t = 0; t < 16; t++)
-	{
-		W[t] = ((unsigned) context->Message_Block[t * 4]) << 24;
-		W[t] |= ((unsigned) context->Message_Block[t * 4 + 1]) << 16;
-		W[t] |= ((unsigned) context->Message_Block[t * 4 + 2]) << 8;
-		W[t] |= ((unsigned) context->Message_Block[t * 4 + 3]);
-	}
-
-	for(t = 16; t < 80; t++)
-	{
-		W[t] = SHA1CircularShift(1,W[t-3] ^ W[t-8] ^ W[t-14] ^ W[t-16]);
-	}
-
-	A = context->Message_Digest[0];
-	B = context->Message_Digest[1];
-	C = context->Message_Digest[2];
-	D = context->Message_Digest[3];
-	E = context->Message_Digest[4];
-
-	for(t = 0; t < 20; t++)
-	{
-		temp =  SHA1CircularShift(5,A) +
-		        ((B & C) | ((~B) & D)) + E + W[t] + K[0];
-		temp &= 0xFFFFFFFF;
-		E = D;
-		D = C;
-		C = SHA1CircularShift(30,B);
-		B = A;
-		A = temp;
-	}
-
-	for(t = 20; t < 40; t++)
-	{
-		temp = SHA1CircularShift(5,A) + (B ^ C ^ D) + E + W[t] + K[1];
-		temp &= 0xFFFFFFFF;
-		E = D;
-		D = C;
-		C = SHA1CircularShift(30,B);
-		B = A;
-		A = temp;
+	u32 i;
+	GF_SHA1MultiContext *ctx;
+	if (!nb_streams) return NULL;
+	if (!sha1_process) sha1_select_impl();
+
+	GF_SAFEALLOC(ctx, GF_SHA1MultiContext);
+	if (!ctx) return NULL;
+	ctx->streams = (GF_SHA1Context *) gf_malloc(sizeof(GF_SHA1Context) * nb_streams);
+	if (!ctx->streams) {
+		gf_free(ctx);
+		return NULL;
 	}
-
-	for(t = 40; t < 60; t++)
-	{
-		temp = SHA1CircularShift(5,A) +
-		       ((B & C) | (B & D) | (C & D)) + E + W[t] + K[2];
-		temp &= 0xFFFFFFFF;
-		E = D;
-		D = C;
-		C = SHA1CircularShift(30,B);
-		B = A;
-		A = temp;
-	}
-
-	for(t = 60; t < 80; t++)
-	{
-		temp = SHA1CircularShift(5,A) + (B ^ C ^ D) + E + W[t] + K[3];
-		temp &= 0xFFFFFFFF;
-		E = D;
-		D = C;
-		C = SHA1CircularShift(30,B);
-		B = A;
-		A = temp;
-	}
-
-	context->Message_Digest[0] =
-	    (context->Message_Digest[0] + A) & 0xFFFFFFFF;
-	context->Message_Digest[1] =
-	    (context->Message_Digest[1] + B) & 0xFFFFFFFF;
-	context->Message_Digest[2] =
-	    (context->Message_Digest[2] + C) & 0xFFFFFFFF;
-	context->Message_Digest[3] =
-	    (context->Message_Digest[3] + D) & 0xFFFFFFFF;
-	context->Message_Digest[4] =
-	    (context->Message_Digest[4] + E) & 0xFFFFFFFF;
-
-	context->Message_Block_Index = 0;
+	ctx->nb_streams = nb_streams;
+	for (i=0; i<nb_streams; i++) sha1_init(&ctx->streams[i]);
+	return ctx;
 }
 
-/*
- *  SHA1PadMessage
- *
- *  Description:
- *      According to the standard, the message must be padded to an even
- *      512 bits.  The first padding bit must be a '1'.  The last 64
- *      bits represent the length of the original message.  All bits in
- *      between should be 0.  This function will pad the message
- *      according to those rules by filling the Message_Block array
- *      accordingly.  It will also call SHA1ProcessMessageBlock()
- *      appropriately.  When it returns, it can be assumed that the
- *      message digest has been computed.
- *
- *  Parameters:
- *      context: [in/out]
- *          The context to pad
- *
- *  Returns:
- *      Nothing.
- *
- *  Comments:
- *
- */
-static void SHA1PadMessage(GF_SHA1Context *context)
+#ifdef GPAC_SHA1_X86
+/*processes with AVX2 the blocks common to the (at most 8) streams having the most full blocks left, until less than
+min_lanes streams have full blocks. Input pointers and sizes are updated*/
+static void sha1_multi_process_avx2(GF_SHA1MultiContext *ctx, const u8 **inputs, u32 *lengths, u32 min_lanes)
 {
-	/*
-	 *  Check to see if the current message block is too small to hold
-	 *  the initial padding bits and length.  If so, we will pad the
-	 *  block, process it, and then continue padding into a second
-	 *  block.
-	 */
-	if (context->Message_Block_Index > 55)
-	{
-		context->Message_Block[context->Message_Block_Index++] = 0x80;
-		while(context->Message_Block_Index < 64)
-		{
-			context->Message_Block[context->Message_Block_Index++] = 0;
+	u32 i, j, nb_lanes;
+	u32 lanes[8];
+	u32 state[5][8];
+	const u8 *data[8];
+
+	while (1) {
+		u32 nb_blocks = 0;
+		nb_lanes = 0;
+		for (i=0; i<ctx->nb_streams; i++) {
+			u32 nb = lengths[i] / 64;
+			if (!nb) continue;
+			if (nb_lanes<8) {
+				lanes[nb_lanes++] = i;
+				continue;
+			}
+			/*replace the lane with the fewest blocks*/
+			for (j=1; j<8; j++) {
+				if (lengths[lanes[j]] < lengths[lanes[0]]) {
+					u32 tmp = lanes[0];
+					lanes[0] = lanes[j];
+					lanes[j] = tmp;
+				}
+			}
+			if (lengths[i] > lengths[lanes[0]]) lanes[0] = i;
 		}
+		if (nb_lanes<min_lanes) return;
 
-		SHA1ProcessMessageBlock(context);
-
-		while(context->Message_Block_Index < 56)
-		{
-			context->Message_Block[context->Message_Block_Index++] = 0;
+		for (j=0; j<nb_lanes; j++) {
+			u32 nb = lengths[lanes[j]] / 64;
+			if (!nb_blocks || (nb < nb_blocks)) nb_blocks = nb;
 		}
-	}
-	else
-	{
-		context->Message_Block[context->Message_Block_Index++] = 0x80;
-		while(context->Message_Block_Index < 56)
-		{
-			context->Message_Block[context->Message_Block_Index++] = 0;
+		for (j=0; j<8; j++) {
+			/*unused lanes hash the data of the first lane and are discarded*/
+			GF_SHA1Context *st = &ctx->streams[lanes[(j<nb_lanes) ? j : 0]];
+			for (i=0; i<5; i++) state[i][j] = st->state[i];
+			data[j] = inputs[lanes[(j<nb_lanes) ? j : 0]];
+		}
+		sha1_process_avx2_x8(state, data, nb_blocks);
+
+		for (j=0; j<nb_lanes; j++) {
+			GF_SHA1Context *st = &ctx->streams[lanes[j]];
+			for (i=0; i<5; i++) st->state[i] = state[i][j];
+			st->total += 64 * nb_blocks;
+			inputs[lanes[j]] += 64 * nb_blocks;
+			lengths[lanes[j]] -= 64 * nb_blocks;
 		}
 	}
-
-	/*
-	 *  Store the message length as the last 8 octets
-	 */
-	context->Message_Block[56] = (context->Length_High >> 24) & 0xFF;
-	context->Message_Block[57] = (context->Length_High >> 16) & 0xFF;
-	context->Message_Block[58] = (context->Length_High >> 8) & 0xFF;
-	context->Message_Block[59] = (context->Length_High) & 0xFF;
-	context->Message_Block[60] = (context->Length_Low >> 24) & 0xFF;
-	context->Message_Block[61] = (context->Length_Low >> 16) & 0xFF;
-	context->Message_Block[62] = (context->Length_Low >> 8) & 0xFF;
-	context->Message_Block[63] = (context->Length_Low) & 0xFF;
-
-	SHA1ProcessMessageBlock(context);
 }
+#endif
+
 /*
- *  SHA1Reset
- *
- *  Description:
- *      This function will initialize the SHA1Context in preparation
- *      for computing a new message digest.
- *
- *  Parameters:
- *      context: [in/out]
- *          The context to reset.
- *
- *  Returns:
- *      Nothing.
- *
- *  Comments:
- *
+ * Multi-buffer SHA-1 process buffers
  */
-GF_SHA1Context *gf_sha1_starts()
-{
-	GF_SHA1Context *context;
-	GF_SAFEALLOC(context, GF_SHA1Context);
-	if (!context) return NULL;
-	context->Length_Low             = 0;
-	context->Length_High            = 0;
-	context->Message_Block_Index    = 0;
-
-	context->Message_Digest[0]      = 0x67452301;
-	context->Message_Digest[1]      = 0xEFCDAB89;
-	context->Message_Digest[2]      = 0x98BADCFE;
-	context->Message_Digest[3]      = 0x10325476;
-	context->Message_Digest[4]      = 0xC3D2E1F0;
-
-	context->Computed   = 0;
-	context->Corrupted  = 0;
-	return context;
-}
-
-void gf_sha1_update(GF_SHA1Context *context, u8 *message_array, u32 length )
+GF_EXPORT
+void gf_sha1_multi_update(GF_SHA1MultiContext *ctx, u8 **inputs, u32 *lengths)
 {
-	if (!length)
-	{
-		return;
-	}
-
-	if (context->Computed || context->Corrupted)
-	{
-		context->Corrupted = 1;
-		return;
-	}
-
-	while(length-- && !context->Corrupted)
-	{
-		context->Message_Block[context->Message_Block_Index++] =
-		    (*message_array & 0xFF);
-
-		context->Length_Low += 8;
-		/* Force it to 32 bits */
-		context->Length_Low &= 0xFFFFFFFF;
-		if (context->Length_Low == 0)
-		{
-			context->Length_High++;
-			/* Force it to 32 bits */
-			context->Length_High &= 0xFFFFFFFF;
-			if (context->Length_High == 0)
-			{
-				/* Message is too long */
-				context->Corrupted = 1;
+	u32 i;
+	const u8 *in[SHA1_MULTI_STREAMS];
+	u32 len[SHA1_MULTI_STREAMS];
+	u32 nb_done = 0;
+
+	if (!ctx || !inputs || !lengths) return;
+
+	while (nb_done < ctx->nb_streams) {
+		u32 nb = MIN(ctx->nb_streams - nb_done, SHA1_MULTI_STREAMS);
+		GF_SHA1MultiContext sub;
+		sub.nb_streams = nb;
+		sub.streams = ctx->streams + nb_done;
+
+		/*complete pending blocks first so that all streams are block-aligned*/
+		for (i=0; i<nb; i++) {
+			GF_SHA1Context *st = &sub.streams[i];
+			u32 left = (u32) (st->total & 0x3F);
+			in[i] = inputs[nb_done+i];
+			len[i] = in[i] ? lengths[nb_done+i] : 0;
+			if (left && len[i]) {
+				u32 fill = MIN(64 - left, len[i]);
+				gf_sha1_update(st, (u8 *) in[i], fill);
+				in[i] += fill;
+				len[i] -= fill;
 			}
 		}
-
-		if (context->Message_Block_Index == 64)
-		{
-			SHA1ProcessMessageBlock(context);
+#ifdef GPAC_SHA1_X86
+		if (sha1_multi_min_lanes) sha1_multi_process_avx2(&sub, in, len, sha1_multi_min_lanes);
+#endif
+		for (i=0; i<nb; i++) {
+			if (len[i]) gf_sha1_update(&sub.streams[i], (u8 *) in[i], len[i]);
 		}
-
-		message_array++;
+		nb_done += nb;
 	}
 }
-void gf_sha1_finish(GF_SHA1Context *context, u8 output[GF_SHA1_DIGEST_SIZE] )
-{
-	if (context->Corrupted)
-	{
-		return;
-	}
 
-	if (!context->Computed)
-	{
-		SHA1PadMessage(context);
-		context->Computed = 1;
+/*
+ * Multi-buffer SHA-1 final digests
+ */
+GF_EXPORT
+void gf_sha1_multi_finish(GF_SHA1MultiContext *ctx, u8 (*digests)[GF_SHA1_DIGEST_SIZE])
+{
+	u32 i;
+	if (!ctx) return;
+	for (i=0; i<ctx->nb_streams; i++) {
+		sha1_final(&ctx->streams[i], digests[i]);
 	}
-	PUT_UINT32_BE( context->Message_Digest[0], output,  0 );
-	PUT_UINT32_BE( context->Message_Digest[1], output,  4 );
-	PUT_UINT32_BE( context->Message_Digest[2], output,  8 );
-	PUT_UINT32_BE( context->Message_Digest[3], output, 12 );
-	PUT_UINT32_BE( context->Message_Digest[4], output, 16 );
-
-	gf_free(context);
+	gf_free(ctx->streams);
+	gf_free(ctx);
 }
 
-#endif
-
 /*
  * Output = SHA-1( file contents )
  */
@@ -694,7 +794,7 @@ s32 gf_sha1_file( const char *path, u8 output[GF_SHA1_DIGEST_SIZE] )
 	FILE *f;
 	size_t n;
 	GF_SHA1Context *ctx;
-	u8 buf[1024];
+	u8 *buf;
 
 	if (!strncmp(path, "gmem://", 7)) {
 		u32 size;
@@ -709,13 +809,21 @@ s32 gf_sha1_file( const char *path, u8 output[GF_SHA1_DIGEST_SIZE] )
 	if( ( f = gf_fopen( path, "rb" ) ) == NULL )
 		return( 1 );
 
+	buf = (u8 *) gf_malloc(SHA1_FILE_BLOCK_SIZE);
 	ctx  = gf_sha1_starts();
+	if (!buf || !ctx) {
+		if (buf) gf_free(buf);
+		if (ctx) gf_free(ctx);
+		gf_fclose( f );
+		return( 1 );
+	}
 
-	while( ( n = fread( buf, 1, sizeof( buf ), f ) ) > 0 )
+	while( ( n = fread( buf, 1, SHA1_FILE_BLOCK_SIZE, f ) ) > 0 )
 		gf_sha1_update(ctx, buf, (s32) n );
 
 	gf_sha1_finish(ctx, output );
 
+	gf_free(buf);
 	gf_fclose( f );
 	return( 0 );
 }
@@ -726,14 +834,24 @@ s32 gf_sha1_file( const char *path, u8 output[GF_SHA1_DIGEST_SIZE] )
 GF_EXPORT
 void gf_sha1_csum( u8 *input, u32 ilen, u8 output[GF_SHA1_DIGEST_SIZE] )
 {
-	GF_SHA1Context *ctx;
+	GF_SHA1Context ctx;
 
-	memset(output, 0, sizeof(u8)*GF_SHA1_DIGEST_SIZE);
-	ctx = gf_sha1_starts();
-	if (ctx) {
-		gf_sha1_update(ctx, input, ilen );
-		gf_sha1_finish(ctx, output );
-	}
+	if (!sha1_process) sha1_select_impl();
+	sha1_init(&ctx);
+	gf_sha1_update(&ctx, input, ilen );
+	sha1_final(&ctx, output );
+}
+
+/*
+ * Output[i] = SHA-1( input buffer i )
+ */
+GF_EXPORT
+void gf_sha1_csum_multi(u8 **buffers, u32 *lengths, u32 nb_buffers, u8 (*digests)[GF_SHA1_DIGEST_SIZE])
+{
+	GF_SHA1MultiContext *ctx = gf_sha1_multi_starts(nb_buffers);
+	if (!ctx) return;
+	gf_sha1_multi_update(ctx, buffers, lengths);
+	gf_sha1_multi_finish(ctx, digests);
 }
 
 GF_EXPORT
@@ -753,4 +871,4 @@ void gf_sha1_csum_hexa(u8 *buf, u32 buflen, u8 digest[GF_SHA1_DIGEST_SIZE_HEXA])
 	}
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -157,7 +157,7 @@ OBJS+=../modules/mp3_in/mad_dec.o
 CFLAGS+=-DGPAC_HAS_MAD
 EXTRALIBS+= -lmad
 endif
-OBJS+=../modules/isom_in/load.o ../modules/isom_in/read.o ../modules/isom_in/read_ch.o ../modules/isom_in/isom_cache.o
+OBJS+=../modules/isom_in/load.o ../modules/isom_in/read.o ../modules/isom_in/read_ch.o ../modules/isom_in/isom_cache.o ../modules/isom_in/isom_share.o
 OBJS+=../modules/odf_dec/odf_dec.o
 OBJS+=../modules/rtp_in/rtp_in.o ../modules/rtp_in/rtp_session.o ../modules/rtp_in/rtp_signaling.o ../modules/rtp_in/rtp_stream.o ../modules/rtp_in/sdp_fetch.o ../modules/rtp_in/sdp_load.o
 OBJS+=../modules/saf_in/saf_in.o
@@ -0,0 +1,26 @@
+#!/bin/sh
+
+test_begin "dash-hls"
+
+do_test "$MP4BOX -add $EXTERNAL_MEDIA_DIR/counter/counter_30s_I25_baseline_1280x720_512kbps.264 -new $TEMP_DIR/video.mp4" "dash-input-preparation-video"
+
+do_test "$MP4BOX -add $EXTERNAL_MEDIA_DIR/counter/counter_30s_audio.aac -new $TEMP_DIR/audio.mp4" "dash-input-preparation-audio"
+
+do_test "$MP4BOX -dash 1000 -rap -profile live -hls live.m3u8 $TEMP_DIR/video.mp4 $TEMP_DIR/audio.mp4 -out $TEMP_DIR/live.mpd" "dash-hls-live"
+
+do_hash_test $TEMP_DIR/live.m3u8 "live-master"
+do_hash_test $TEMP_DIR/live_1.m3u8 "live-video"
+
+do_test "$MP4BOX -dash 1000 -rap -profile onDemand -hls ondemand.m3u8 $TEMP_DIR/video.mp4 $TEMP_DIR/audio.mp4 -out $TEMP_DIR/ondemand.mpd" "dash-hls-ondemand"
+
+do_hash_test $TEMP_DIR/ondemand_1.m3u8 "ondemand-video"
+
+do_test "$MP4BOX -add $TEMP_DIR/video.mp4 -add $TEMP_DIR/audio.mp4 -new $TEMP_DIR/file.mp4" "ts-for-dash-input-preparation"
+
+do_test "$MP42TS -prog $TEMP_DIR/file.mp4 -dst-file $TEMP_DIR/file.ts" "ts-for-dash-input-preparation-2"
+
+do_test "$MP4BOX -dash 1000 -rap -hls ts.m3u8 $TEMP_DIR/file.ts -out $TEMP_DIR/ts.mpd" "dash-hls-ts"
+
+do_hash_test $TEMP_DIR/ts_1.m3u8 "ts-media"
+
+test_end
@@ -0,0 +1,42 @@
+#!/bin/sh
+
+#checks the Chrome trace file written by MP4Box -trace: file structure, one JSON event per line, and balanced begin/end
+#events of the given span name
+check_trace ()
+{
+if [ ! -f $1 ] ; then
+ result="$result $1 not written"
+ return
+fi
+if [ "$(head -n 1 $1)" != '{"traceEvents":[' ] || [ "$(tail -n 1 $1)" != '],"displayTimeUnit":"ns"}' ] ; then
+ result="$result $1 is not a Chrome trace file"
+ return
+fi
+nb_bad=`sed '1d;$d' $1 | grep -E -v -c -e '^\{"name":"thread_name","ph":"M","pid":[0-9]+,"tid":[0-9]+,"args":\{"name":"[^"]*"\}\},?$' -e '^\{"name":"[^"]*","cat":"[a-z]+","ph":"[BEiC]","ts":-?[0-9]+\.[0-9]+,"pid":[0-9]+,"tid":[0-9]+(,"args":\{"value":-?[0-9]+\}|,"s":"t")?\},?$'`
+if [ "$nb_bad" != 0 ] ; then
+ result="$result $1 has $nb_bad malformed events"
+fi
+nb_begin=`grep -c "^{\"name\":\"$2\",\"cat\":\"[a-z]*\",\"ph\":\"B\"" $1`
+nb_end=`grep -c "^{\"name\":\"$2\",\"cat\":\"[a-z]*\",\"ph\":\"E\"" $1`
+if [ "$nb_begin" = 0 ] || [ "$nb_begin" != "$nb_end" ] ; then
+ result="$result $1 has $nb_begin $2 begin events and $nb_end end events"
+fi
+}
+
+test_begin "trace"
+if [ $test_skip = 1 ] ; then
+ return
+fi
+
+mp4file="$TEMP_DIR/file.mp4"
+do_test "$MP4BOX -add $MEDIA_DIR/auxiliary_files/enst_video.h264 -add $MEDIA_DIR/auxiliary_files/enst_audio.aac -new $mp4file" "create-mp4"
+
+do_test "$MP42TS -src $mp4file -dst-file=$TEMP_DIR/file.ts" "create-ts"
+
+do_test "$MP4BOX -trace $TEMP_DIR/ts.json -add $TEMP_DIR/file.ts -new $TEMP_DIR/ts.mp4" "trace-ts-import"
+check_trace $TEMP_DIR/ts.json "ts_demux"
+
+do_test "$MP4BOX -trace $TEMP_DIR/dash.json -dash 1000 -profile live $mp4file -out $TEMP_DIR/file.mpd" "trace-dash"
+check_trace $TEMP_DIR/dash.json "segment_write"
+
+test_end